@@ -0,0 +1,1055 @@
+/*!
+    \file       aes.c
+    \brief      streaming AES engine based on CAU with DMA and context switching
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Incremental AES-ECB/CBC/CTR processing (init/update/final) of arbitrary length data
+    - DMA feeding of the CAU IN FIFO and draining of the OUT FIFO for large blocks
+    - CPU feeding of the FIFOs for short messages where DMA setup costs more than it saves
+    - Saving and restoring CAU context so several sessions can interleave on one CAU
+    - IV chaining across update calls through the CAU IV registers
+    - Asynchronous completion notification from the DMA interrupt
+    - AES-GCM packet queue: AAD, payload (DMA) and tag phases chained from the DMA interrupt
+    - Throughput and CPU load benchmark against the polled firmware functions
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./AES/aes.h"
+#include "./LOCK/lock.h"
+#include "./SYSTEM/system.h"
+#include "./USART/usart.h"
+#include <string.h>
+
+#define AES_FIFO_TIMEOUT            ((uint32_t)0x00010000U)                 /* CPU FIFO polling timeout */
+
+static aes_context_struct *s_aes_owner = NULL;                              /* session whose context is loaded in CAU */
+static aes_context_struct *volatile s_aes_active = NULL;                    /* session with DMA transfer in progress, holds LOCK_SEM_CAU */
+static aes_gcm_packet_struct *volatile s_gcm_head = NULL;                   /* GCM packet being processed */
+static aes_gcm_packet_struct *s_gcm_tail = NULL;                            /* last queued GCM packet */
+static aes_gcm_packet_struct *s_gcm_dma = NULL;                             /* GCM packet with payload DMA in progress, holds LOCK_SEM_CAU */
+static const aes_gcm_key_struct *s_gcm_key = NULL;                          /* GCM key currently in CAU key registers */
+static uint8_t *s_aes_dma_output = NULL;                                    /* output of the DMA transfer in progress */
+static uint32_t s_aes_dma_bytes = 0;                                        /* its length */
+
+static void aes_gcm_kick(void);
+
+/*!
+    \brief      read a big-endian 32-bit word from byte buffer
+    \param[in]  p: pointer to 4 bytes
+    \param[out] none
+    \retval     word value
+*/
+static uint32_t aes_word_get(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/*!
+    \brief      load key bytes into CAU key register layout
+    \param[in]  key: key bytes
+    \param[in]  key_size: key size in bits, 128, 192 or 256
+    \param[out] key_reg: key register values
+    \param[out] keysize_cfg: CAU_KEYSIZE_xxx value for CAU_CTL
+    \retval     ErrStatus: SUCCESS or ERROR if key_size is invalid
+*/
+static ErrStatus aes_key_setup(const uint8_t *key, uint32_t key_size, \
+                               cau_key_parameter_struct *key_reg, uint32_t *keysize_cfg)
+{
+    uint32_t *reg;
+    uint32_t i;
+
+    /* key is right-aligned in KEY0H..KEY3L, same layout as cau_aes_key_config */
+    cau_key_struct_para_init(key_reg);
+    switch(key_size)
+    {
+        case 128: *keysize_cfg = CAU_KEYSIZE_128BIT; reg = &key_reg->key_2_high; break;
+        case 192: *keysize_cfg = CAU_KEYSIZE_192BIT; reg = &key_reg->key_1_high; break;
+        case 256: *keysize_cfg = CAU_KEYSIZE_256BIT; reg = &key_reg->key_0_high; break;
+        default:  return ERROR;
+    }
+    for(i = 0; i < key_size / 32U; i++)
+    {
+        reg[i] = aes_word_get(key + i * 4U);
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      configure DMA channels for CAU IN/OUT FIFO
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void aes_dma_config(void)
+{
+    dma_single_data_parameter_struct dma_init_struct;
+
+    rcu_periph_clock_enable(AES_DMA_CLOCK);
+    rcu_periph_clock_enable(RCU_DMAMUX);
+
+    /* memory to CAU IN FIFO */
+    dma_deinit(AES_DMA, AES_DMA_IN_CHANNEL);
+    dma_init_struct.request             = DMA_REQUEST_CAU_IN;
+    dma_init_struct.periph_addr         = AES_DI_ADDRESS;
+    dma_init_struct.memory0_addr        = 0;
+    dma_init_struct.number              = 0;
+    dma_init_struct.periph_inc          = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc          = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.periph_memory_width = DMA_PERIPH_WIDTH_32BIT;
+    dma_init_struct.direction           = DMA_MEMORY_TO_PERIPH;
+    dma_init_struct.priority            = DMA_PRIORITY_HIGH;
+    dma_init_struct.circular_mode       = DMA_CIRCULAR_MODE_DISABLE;
+    dma_single_data_mode_init(AES_DMA, AES_DMA_IN_CHANNEL, &dma_init_struct);
+
+    /* CAU OUT FIFO to memory, higher priority so the OUT FIFO never stalls the core */
+    dma_deinit(AES_DMA, AES_DMA_OUT_CHANNEL);
+    dma_init_struct.request             = DMA_REQUEST_CAU_OUT;
+    dma_init_struct.periph_addr         = AES_DO_ADDRESS;
+    dma_init_struct.direction           = DMA_PERIPH_TO_MEMORY;
+    dma_init_struct.priority            = DMA_PRIORITY_ULTRA_HIGH;
+    dma_single_data_mode_init(AES_DMA, AES_DMA_OUT_CHANNEL, &dma_init_struct);
+
+    dma_interrupt_enable(AES_DMA, AES_DMA_OUT_CHANNEL, DMA_INT_FTF | DMA_INT_TAE);
+    nvic_irq_enable(AES_DMA_OUT_IRQ, 3, 0);
+}
+
+/*!
+    \brief      initialize CAU and DMA for streaming AES
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       CAU is arbitrated through LOCK_SEM_CAU, lock_init must have run.
+*/
+void aes_engine_init(void)
+{
+    rcu_periph_clock_enable(RCU_CAU);
+    cau_deinit();
+    aes_dma_config();
+    s_aes_owner = NULL;
+    s_aes_active = NULL;
+    s_gcm_head = NULL;
+    s_gcm_tail = NULL;
+    s_gcm_dma = NULL;
+    s_gcm_key = NULL;
+}
+
+/*!
+    \brief      load the session context into CAU, saving the previous owner
+    \param[in]  ctx: session to activate
+    \param[out] none
+    \retval     none
+*/
+static void aes_hw_acquire(aes_context_struct *ctx)
+{
+    if(s_aes_owner == ctx)
+    {
+        return;
+    }
+
+    /* save chaining state (IV registers) of the session being swapped out */
+    if(s_aes_owner != NULL)
+    {
+        cau_context_save(&s_aes_owner->hw_context, &s_aes_owner->key);
+    }
+
+    cau_fifo_flush();
+    cau_context_restore(&ctx->hw_context);                                  /* includes decryption key preparation */
+    s_aes_owner = ctx;
+    s_gcm_key = NULL;
+}
+
+/*!
+    \brief      process whole blocks by CPU feeding of the CAU FIFOs
+    \param[in]  input: input data
+    \param[in]  blocks: number of 16-byte blocks
+    \param[out] output: output data
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+static ErrStatus aes_cpu_process(const uint8_t *input, uint32_t blocks, uint8_t *output)
+{
+    uint32_t block[4];
+    uint32_t counter;
+
+    while(blocks--)
+    {
+        memcpy(block, input, AES_BLOCK_SIZE);                               /* input may be unaligned */
+        cau_data_write(block[0]);
+        cau_data_write(block[1]);
+        cau_data_write(block[2]);
+        cau_data_write(block[3]);
+
+        counter = 0;
+        while(RESET == cau_flag_get(CAU_FLAG_OUTFIFO_NO_EMPTY))
+        {
+            if(++counter == AES_FIFO_TIMEOUT)
+            {
+                return ERROR;
+            }
+        }
+
+        block[0] = cau_data_read();
+        block[1] = cau_data_read();
+        block[2] = cau_data_read();
+        block[3] = cau_data_read();
+        memcpy(output, block, AES_BLOCK_SIZE);
+
+        input += AES_BLOCK_SIZE;
+        output += AES_BLOCK_SIZE;
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      check whether a bulk of whole blocks may go through DMA
+    \param[in]  input: input data
+    \param[in]  bytes: bulk length in bytes
+    \param[in]  output: output data
+    \param[out] none
+    \retval     1 for DMA, 0 for CPU feeding
+    \note       The output is invalidated once the DMA is done, so it must cover
+                whole cache lines; a partial line would lose data the core
+                stored next to it in the meantime.
+*/
+static uint8_t aes_dma_eligible(const uint8_t *input, uint32_t bytes, const uint8_t *output)
+{
+    return ((bytes >= AES_DMA_THRESHOLD) && ((bytes & (AES_DMA_ALIGN - 1U)) == 0U) && \
+            (((uint32_t)input & 0x03U) == 0U) && (((uint32_t)output & (AES_DMA_ALIGN - 1U)) == 0U)) ? 1U : 0U;
+}
+
+/*!
+    \brief      start DMA processing of whole blocks
+    \param[in]  input: input data, 4-byte aligned
+    \param[in]  blocks: number of 16-byte blocks, AES_DMA_ALIGN bytes in total at a time
+    \param[out] output: output data, AES_DMA_ALIGN aligned
+    \retval     none
+*/
+static void aes_dma_start(const uint8_t *input, uint32_t blocks, uint8_t *output)
+{
+    uint32_t bytes = blocks * AES_BLOCK_SIZE;
+
+    /* D-cache maintenance: DMA reads input from RAM and writes output behind the cache */
+    SCB_CleanDCache_by_Addr((void *)input, (int32_t)bytes);
+    SCB_CleanInvalidateDCache_by_Addr(output, (int32_t)bytes);
+    s_aes_dma_output = output;
+    s_aes_dma_bytes = bytes;
+
+    dma_channel_disable(AES_DMA, AES_DMA_IN_CHANNEL);
+    dma_channel_disable(AES_DMA, AES_DMA_OUT_CHANNEL);
+    DMA_INTC0(AES_DMA) |= DMA_FLAG_ADD(DMA_CHINTF_RESET_VALUE, AES_DMA_IN_CHANNEL);
+    DMA_INTC0(AES_DMA) |= DMA_FLAG_ADD(DMA_CHINTF_RESET_VALUE, AES_DMA_OUT_CHANNEL);
+
+    dma_memory_address_config(AES_DMA, AES_DMA_IN_CHANNEL, DMA_MEMORY_0, (uint32_t)input);
+    dma_transfer_number_config(AES_DMA, AES_DMA_IN_CHANNEL, bytes / 4U);
+    dma_memory_address_config(AES_DMA, AES_DMA_OUT_CHANNEL, DMA_MEMORY_0, (uint32_t)output);
+    dma_transfer_number_config(AES_DMA, AES_DMA_OUT_CHANNEL, bytes / 4U);
+
+    dma_channel_enable(AES_DMA, AES_DMA_OUT_CHANNEL);
+    dma_channel_enable(AES_DMA, AES_DMA_IN_CHANNEL);
+    cau_dma_enable(CAU_DMA_INFIFO | CAU_DMA_OUTFIFO);
+}
+
+/*!
+    \brief      initialize a streaming AES session
+    \param[in]  ctx: session context
+    \param[in]  algo_mode: CAU_MODE_AES_ECB, CAU_MODE_AES_CBC or CAU_MODE_AES_CTR
+    \param[in]  alg_dir: CAU_ENCRYPT or CAU_DECRYPT
+    \param[in]  key: key bytes
+    \param[in]  key_size: key size in bits, 128, 192 or 256
+    \param[in]  iv: 16-byte initialization vector (ignored for ECB)
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note       No hardware access is done here; the context is loaded into
+                CAU on the first update, so sessions can be created freely.
+*/
+ErrStatus aes_init(aes_context_struct *ctx, uint32_t algo_mode, uint32_t alg_dir, \
+                   const uint8_t *key, uint32_t key_size, const uint8_t *iv)
+{
+    uint32_t keysize_cfg;
+
+    if((algo_mode != CAU_MODE_AES_ECB) && (algo_mode != CAU_MODE_AES_CBC) && (algo_mode != CAU_MODE_AES_CTR))
+    {
+        return ERROR;
+    }
+    if((algo_mode != CAU_MODE_AES_ECB) && (iv == NULL))
+    {
+        return ERROR;
+    }
+
+    memset(ctx, 0, sizeof(aes_context_struct));
+    if(ERROR == aes_key_setup(key, key_size, &ctx->key, &keysize_cfg))
+    {
+        return ERROR;
+    }
+
+    ctx->hw_context.ctl_config = algo_mode | alg_dir | CAU_SWAPPING_8BIT | keysize_cfg;
+    ctx->hw_context.key_0_high = ctx->key.key_0_high;
+    ctx->hw_context.key_0_low  = ctx->key.key_0_low;
+    ctx->hw_context.key_1_high = ctx->key.key_1_high;
+    ctx->hw_context.key_1_low  = ctx->key.key_1_low;
+    ctx->hw_context.key_2_high = ctx->key.key_2_high;
+    ctx->hw_context.key_2_low  = ctx->key.key_2_low;
+    ctx->hw_context.key_3_high = ctx->key.key_3_high;
+    ctx->hw_context.key_3_low  = ctx->key.key_3_low;
+
+    if(algo_mode != CAU_MODE_AES_ECB)
+    {
+        ctx->hw_context.iv_0_high = aes_word_get(iv);
+        ctx->hw_context.iv_0_low  = aes_word_get(iv + 4);
+        ctx->hw_context.iv_1_high = aes_word_get(iv + 8);
+        ctx->hw_context.iv_1_low  = aes_word_get(iv + 12);
+    }
+
+    ctx->state = AES_STATE_READY;
+    return SUCCESS;
+}
+
+/*!
+    \brief      process data in a streaming AES session
+    \param[in]  ctx: session context
+    \param[in]  input: input data
+    \param[in]  length: input length in bytes, any value
+    \param[out] output: output buffer, at least length + 15 bytes
+    \param[in]  callback: completion callback, NULL for none
+    \param[in]  arg: user argument passed to callback
+    \retval     ErrStatus: SUCCESS if accepted, ERROR if CAU busy or session invalid
+    \note       CAU is held through LOCK_SEM_CAU until the blocks are out, so an ISR
+                finds it busy instead of switching sessions under a thread.
+                Only whole blocks are produced; an incomplete tail is buffered in
+                the context and emitted by the next update or aes_final.
+                The bulk goes through DMA only when it is at least AES_DMA_THRESHOLD
+                bytes and a multiple of AES_DMA_ALIGN, the input is word aligned and
+                the output (after a completed buffered block) is AES_DMA_ALIGN
+                aligned; this function then returns immediately and completion is
+                signalled by callback or aes_wait. Anything else is fed by CPU.
+*/
+ErrStatus aes_update(aes_context_struct *ctx, const uint8_t *input, uint32_t length, \
+                     uint8_t *output, aes_callback_fn callback, void *arg)
+{
+    uint32_t out_length = 0;
+    uint32_t take, blocks, tail;
+
+    if((ctx->state != AES_STATE_READY) || (s_gcm_head != NULL))
+    {
+        return ERROR;                                                       /* queued GCM packets go first */
+    }
+    if(SUCCESS != lock_try(LOCK_SEM_CAU))
+    {
+        return ERROR;
+    }
+
+    aes_hw_acquire(ctx);
+    ctx->callback = callback;
+    ctx->callback_arg = arg;
+
+    /* complete a previously buffered block first */
+    if(ctx->partial_length > 0)
+    {
+        take = AES_BLOCK_SIZE - ctx->partial_length;
+        take = (take > length) ? length : take;
+        memcpy(&ctx->partial[ctx->partial_length], input, take);
+        ctx->partial_length += (uint8_t)take;
+        input += take;
+        length -= take;
+
+        if(ctx->partial_length == AES_BLOCK_SIZE)
+        {
+            if(ERROR == aes_cpu_process(ctx->partial, 1, output))
+            {
+                ctx->state = AES_STATE_ERROR;
+                lock_release(LOCK_SEM_CAU);
+                aes_gcm_kick();
+                return ERROR;
+            }
+            ctx->partial_length = 0;
+            out_length = AES_BLOCK_SIZE;
+        }
+    }
+
+    blocks = length / AES_BLOCK_SIZE;
+    tail = length % AES_BLOCK_SIZE;
+    if(tail > 0)
+    {
+        memcpy(ctx->partial, input + blocks * AES_BLOCK_SIZE, tail);        /* copy before DMA returns control */
+        ctx->partial_length = (uint8_t)tail;
+    }
+
+    if(aes_dma_eligible(input, blocks * AES_BLOCK_SIZE, output + out_length))
+    {
+        ctx->output_length = out_length + blocks * AES_BLOCK_SIZE;
+        ctx->state = AES_STATE_BUSY;
+        s_aes_active = ctx;
+        aes_dma_start(input, blocks, output + out_length);                 /* the DMA interrupt releases CAU */
+        return SUCCESS;
+    }
+
+    if(ERROR == aes_cpu_process(input, blocks, output + out_length))
+    {
+        ctx->state = AES_STATE_ERROR;
+        lock_release(LOCK_SEM_CAU);
+        aes_gcm_kick();
+        return ERROR;
+    }
+    out_length += blocks * AES_BLOCK_SIZE;
+    ctx->output_length = out_length;
+    ctx->total_length += out_length;
+    lock_release(LOCK_SEM_CAU);
+    aes_gcm_kick();                                                         /* packets an ISR queued meanwhile */
+
+    if(callback != NULL)
+    {
+        callback(ctx, out_length, arg);
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      wait for a pending update to complete
+    \param[in]  ctx: session context
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if the transfer failed
+*/
+ErrStatus aes_wait(aes_context_struct *ctx)
+{
+    while(ctx->state == AES_STATE_BUSY)
+    {
+    }
+    return (ctx->state == AES_STATE_ERROR) ? ERROR : SUCCESS;
+}
+
+/*!
+    \brief      finish a streaming AES session
+    \param[in]  ctx: session context
+    \param[out] output: output buffer for the trailing partial block (CTR only)
+    \param[out] output_length: number of bytes written to output
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note       ECB and CBC need the total length to be a multiple of 16 bytes.
+                CTR emits the buffered tail as a truncated keystream block; in
+                thread mode it waits on LOCK_SEM_CAU for another session's
+                transfer or a GCM packet, from an ISR a held CAU gives ERROR.
+                Every return ends the session and wipes the key material, ERROR
+                included, except when an ISR finds CAU held by the code it
+                interrupted while this session is loaded: ERROR, ctx kept, call
+                again from the lower priority.
+*/
+ErrStatus aes_final(aes_context_struct *ctx, uint8_t *output, uint32_t *output_length)
+{
+    uint8_t block[AES_BLOCK_SIZE];
+    uint8_t tail = 0;
+    ErrStatus locked = ERROR;
+    ErrStatus ret = SUCCESS;
+
+    *output_length = 0;
+    if(ERROR == aes_wait(ctx))
+    {
+        ret = ERROR;
+    }
+    else if(ctx->partial_length > 0)
+    {
+        if((ctx->hw_context.ctl_config & CAU_CTL_ALGM) != CAU_MODE_AES_CTR)
+        {
+            ret = ERROR;
+        }
+        else
+        {
+            tail = 1;
+        }
+    }
+
+    if(tail || (s_aes_owner == ctx))
+    {
+        locked = lock_wait(LOCK_SEM_CAU, LOCK_FOREVER);
+        if((locked != SUCCESS) && (s_aes_owner == ctx))
+        {
+            return ERROR;                                                   /* the holder may still save this session into ctx */
+        }
+    }
+
+    if(tail && (locked != SUCCESS))
+    {
+        ret = ERROR;
+    }
+    else if(tail)
+    {
+        aes_hw_acquire(ctx);
+        memset(&ctx->partial[ctx->partial_length], 0, AES_BLOCK_SIZE - ctx->partial_length);
+        ret = aes_cpu_process(ctx->partial, 1, block);
+        if(ret == SUCCESS)
+        {
+            memcpy(output, block, ctx->partial_length);
+            *output_length = ctx->partial_length;
+            ctx->total_length += ctx->partial_length;
+        }
+    }
+
+    /* release CAU and wipe key material */
+    if(locked == SUCCESS)
+    {
+        if(s_aes_owner == ctx)
+        {
+            cau_disable();
+            s_aes_owner = NULL;
+        }
+        lock_release(LOCK_SEM_CAU);
+        aes_gcm_kick();                                                     /* packets queued while CAU was held here */
+    }
+    memset(ctx, 0, sizeof(aes_context_struct));
+    ctx->state = AES_STATE_IDLE;
+    return ret;
+}
+
+/*!
+    \brief      wait for a CAU status flag with timeout
+    \param[in]  flag: CAU_FLAG_xxx status flag
+    \param[in]  status: flag value to wait for
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR on timeout
+*/
+static ErrStatus aes_flag_wait(uint32_t flag, FlagStatus status)
+{
+    uint32_t counter = 0;
+
+    while(cau_flag_get(flag) != status)
+    {
+        if(++counter == AES_FIFO_TIMEOUT)
+        {
+            return ERROR;
+        }
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      prepare an AES-GCM key for packet processing
+    \param[in]  gcm_key: key structure, shared by all packets using this key
+    \param[in]  key: key bytes
+    \param[in]  key_size: key size in bits, 128, 192 or 256
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note       Packets with the same gcm_key back to back skip the key register
+                reload; call this again (not a plain overwrite) to change the key.
+*/
+ErrStatus aes_gcm_key_init(aes_gcm_key_struct *gcm_key, const uint8_t *key, uint32_t key_size)
+{
+    if(s_gcm_key == gcm_key)
+    {
+        s_gcm_key = NULL;                                                   /* force reload of the new key */
+    }
+    return aes_key_setup(key, key_size, &gcm_key->key, &gcm_key->keysize_cfg);
+}
+
+/*!
+    \brief      feed AAD into CAU in the AAD phase
+    \param[in]  aad: additional authenticated data
+    \param[in]  length: AAD length in bytes, last block is zero padded
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+static ErrStatus aes_gcm_aad_feed(const uint8_t *aad, uint32_t length)
+{
+    uint32_t block[4];
+    uint32_t take;
+
+    while(length > 0)
+    {
+        take = (length > AES_BLOCK_SIZE) ? AES_BLOCK_SIZE : length;
+        memset(block, 0, AES_BLOCK_SIZE);
+        memcpy(block, aad, take);
+
+        if(ERROR == aes_flag_wait(CAU_FLAG_INFIFO_EMPTY, SET))
+        {
+            return ERROR;
+        }
+        cau_data_write(block[0]);
+        cau_data_write(block[1]);
+        cau_data_write(block[2]);
+        cau_data_write(block[3]);
+
+        aad += take;
+        length -= take;
+    }
+    return aes_flag_wait(CAU_FLAG_BUSY, RESET);
+}
+
+/*!
+    \brief      run prepare, AAD and payload phases of a GCM packet
+    \param[in]  pkt: packet descriptor
+    \param[out] async: 1 if the payload was handed to DMA and completes in the interrupt
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+static ErrStatus aes_gcm_run(aes_gcm_packet_struct *pkt, uint8_t *async)
+{
+    cau_iv_parameter_struct iv;
+    uint32_t blocks = pkt->length / AES_BLOCK_SIZE;
+    uint32_t counter = 0;
+    ErrStatus ret = SUCCESS;
+
+    *async = 0;
+
+    /* suspend a streaming session loaded in CAU, it is restored on its next update */
+    if(s_aes_owner != NULL)
+    {
+        cau_context_save(&s_aes_owner->hw_context, &s_aes_owner->key);
+        s_aes_owner = NULL;
+    }
+
+    cau_disable();
+    CAU_CTL = CAU_MODE_AES_GCM | pkt->alg_dir | CAU_SWAPPING_8BIT | pkt->key->keysize_cfg; /* clears phase and NBPILB */
+    if(s_gcm_key != pkt->key)
+    {
+        cau_key_init((cau_key_parameter_struct *)&pkt->key->key);
+        s_gcm_key = pkt->key;
+    }
+
+    /* 96-bit IV followed by the 32-bit block counter of the first payload block */
+    iv.iv_0_high = aes_word_get(pkt->iv);
+    iv.iv_0_low  = aes_word_get(pkt->iv + 4);
+    iv.iv_1_high = aes_word_get(pkt->iv + 8);
+    iv.iv_1_low  = 0x00000002U;
+    cau_iv_init(&iv);
+
+    /* prepare phase: CAU computes the hash subkey and clears CAUEN when done */
+    cau_phase_config(CAU_PREPARE_PHASE);
+    cau_enable();
+    while(ENABLE == cau_enable_state_get())
+    {
+        if(++counter == AES_FIFO_TIMEOUT)
+        {
+            ret = ERROR;
+            break;
+        }
+    }
+
+    if((ret == SUCCESS) && (pkt->aad_length > 0))
+    {
+        cau_phase_config(CAU_AAD_PHASE);
+        cau_fifo_flush();
+        cau_enable();
+        ret = aes_gcm_aad_feed(pkt->aad, pkt->aad_length);
+    }
+
+    if((ret == SUCCESS) && (pkt->length > 0))
+    {
+        cau_phase_config(CAU_ENCRYPT_DECRYPT_PHASE);
+        cau_fifo_flush();
+        cau_enable();
+
+        if(aes_dma_eligible(pkt->input, blocks * AES_BLOCK_SIZE, pkt->output))
+        {
+            *async = 1;
+            s_gcm_dma = pkt;
+            aes_dma_start(pkt->input, blocks, pkt->output);
+            return SUCCESS;
+        }
+        ret = aes_cpu_process(pkt->input, blocks, pkt->output);
+    }
+    return ret;
+}
+
+/*!
+    \brief      process the last partial payload block and the tag phase of a GCM packet
+    \param[in]  pkt: packet descriptor
+    \param[in]  ret: result of the previous phases
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+static ErrStatus aes_gcm_finish(aes_gcm_packet_struct *pkt, ErrStatus ret)
+{
+    uint64_t aad_bits = (uint64_t)pkt->aad_length * 8U;
+    uint64_t payload_bits = (uint64_t)pkt->length * 8U;
+    uint32_t tail = pkt->length % AES_BLOCK_SIZE;
+    uint32_t done = pkt->length - tail;
+    uint8_t block[AES_BLOCK_SIZE];
+    uint32_t tag[4];
+
+    /* on encryption NBPILB keeps the zero padding of the last block out of GHASH */
+    if((ret == SUCCESS) && (tail > 0))
+    {
+        memset(block, 0, AES_BLOCK_SIZE);
+        memcpy(block, pkt->input + done, tail);
+        if(pkt->alg_dir == CAU_ENCRYPT)
+        {
+            CAU_CTL |= CAU_PADDING_BYTES(AES_BLOCK_SIZE - tail);
+        }
+        ret = aes_cpu_process(block, 1, block);
+        memcpy(pkt->output + done, block, tail);
+    }
+
+    if(ret == SUCCESS)
+    {
+        cau_phase_config(CAU_TAG_PHASE);
+        cau_fifo_flush();
+        cau_enable();
+        cau_data_write(__REV((uint32_t)(aad_bits >> 32U)));
+        cau_data_write(__REV((uint32_t)aad_bits));
+        cau_data_write(__REV((uint32_t)(payload_bits >> 32U)));
+        cau_data_write(__REV((uint32_t)payload_bits));
+
+        ret = aes_flag_wait(CAU_FLAG_OUTFIFO_NO_EMPTY, SET);
+        if(ret == SUCCESS)
+        {
+            tag[0] = cau_data_read();
+            tag[1] = cau_data_read();
+            tag[2] = cau_data_read();
+            tag[3] = cau_data_read();
+            memcpy(pkt->tag, tag, AES_GCM_TAG_SIZE);
+        }
+    }
+
+    cau_disable();
+    return ret;
+}
+
+/*!
+    \brief      remove the head packet from the queue and notify its owner
+    \param[in]  pkt: completed packet (queue head)
+    \param[in]  ret: packet result
+    \param[out] none
+    \retval     none
+*/
+static void aes_gcm_complete(aes_gcm_packet_struct *pkt, ErrStatus ret)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    s_gcm_head = pkt->next;
+    if(s_gcm_head == NULL)
+    {
+        s_gcm_tail = NULL;
+    }
+    __set_PRIMASK(primask);
+
+    pkt->state = (ret == SUCCESS) ? AES_STATE_READY : AES_STATE_ERROR;
+    if(pkt->callback != NULL)
+    {
+        pkt->callback(pkt, pkt->callback_arg);
+    }
+}
+
+/*!
+    \brief      process queued GCM packets until one is handed to DMA
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Every context that releases LOCK_SEM_CAU calls this afterwards, so
+                packets queued while CAU was held are not left waiting.
+*/
+static void aes_gcm_kick(void)
+{
+    aes_gcm_packet_struct *pkt;
+    ErrStatus ret;
+    uint8_t async;
+
+    while((s_gcm_head != NULL) && (s_gcm_dma == NULL))
+    {
+        if(SUCCESS != lock_try(LOCK_SEM_CAU))
+        {
+            return;                                                         /* the holder kicks the queue on release */
+        }
+        pkt = s_gcm_head;
+        ret = aes_gcm_run(pkt, &async);
+        if(async)
+        {
+            return;                                                         /* continued in AES_DMA_OUT_IRQHandler */
+        }
+        ret = aes_gcm_finish(pkt, ret);
+        lock_release(LOCK_SEM_CAU);
+        aes_gcm_complete(pkt, ret);
+    }
+}
+
+/*!
+    \brief      queue a packet for AES-GCM encryption or decryption
+    \param[in]  pkt: packet descriptor with key, alg_dir, iv, aad, input, length,
+                output, callback and callback_arg filled in
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if queued, ERROR if the descriptor is invalid
+    \note       Packets are processed in order. AAD and the last partial block go
+                through the CPU; a payload bulk that aes_update would give to DMA
+                (see its alignment rules) goes through DMA and the tag phase follows in the DMA interrupt,
+                which then starts the next packet. With an idle queue, small packets
+                complete before this function returns. Buffers and the descriptor must
+                stay valid until the packet state leaves AES_STATE_BUSY.
+*/
+ErrStatus aes_gcm_submit(aes_gcm_packet_struct *pkt)
+{
+    uint32_t primask;
+    uint8_t idle;
+
+    if((pkt->key == NULL) || (pkt->iv == NULL) || \
+       ((pkt->alg_dir != CAU_ENCRYPT) && (pkt->alg_dir != CAU_DECRYPT)) || \
+       ((pkt->aad_length > 0) && (pkt->aad == NULL)) || \
+       ((pkt->length > 0) && ((pkt->input == NULL) || (pkt->output == NULL))))
+    {
+        return ERROR;
+    }
+
+    pkt->state = AES_STATE_BUSY;
+    pkt->next = NULL;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    idle = (s_gcm_head == NULL) ? 1 : 0;
+    if(idle)
+    {
+        s_gcm_head = pkt;
+    }
+    else
+    {
+        s_gcm_tail->next = pkt;
+    }
+    s_gcm_tail = pkt;
+    __set_PRIMASK(primask);
+
+    /* a busy queue, or whoever holds CAU, restarts the queue when releasing it */
+    if(idle)
+    {
+        aes_gcm_kick();
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      wait for a queued GCM packet to complete
+    \param[in]  pkt: packet descriptor
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if processing failed
+*/
+ErrStatus aes_gcm_wait(aes_gcm_packet_struct *pkt)
+{
+    while(pkt->state == AES_STATE_BUSY)
+    {
+    }
+    return (pkt->state == AES_STATE_ERROR) ? ERROR : SUCCESS;
+}
+
+/*!
+    \brief      compare the computed tag of a decrypted packet with the received tag
+    \param[in]  pkt: completed packet
+    \param[in]  tag: received 16-byte tag
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if the packet completed and the tags match
+    \note       Runs in constant time. Discard the plaintext on ERROR.
+*/
+ErrStatus aes_gcm_tag_check(const aes_gcm_packet_struct *pkt, const uint8_t *tag)
+{
+    uint8_t diff = 0;
+    uint32_t i;
+
+    for(i = 0; i < AES_GCM_TAG_SIZE; i++)
+    {
+        diff |= pkt->tag[i] ^ tag[i];
+    }
+    return ((diff == 0) && (pkt->state == AES_STATE_READY)) ? SUCCESS : ERROR;
+}
+
+/*!
+    \brief      DMA OUT channel interrupt handler, completes a stream update or GCM payload
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void AES_DMA_OUT_IRQHandler(void)
+{
+    aes_context_struct *ctx = s_aes_active;
+    aes_gcm_packet_struct *pkt;
+    uint8_t state = AES_STATE_READY;
+    ErrStatus ret;
+
+    if(dma_interrupt_flag_get(AES_DMA, AES_DMA_OUT_CHANNEL, DMA_INT_FLAG_TAE) == SET)
+    {
+        dma_interrupt_flag_clear(AES_DMA, AES_DMA_OUT_CHANNEL, DMA_INT_FLAG_TAE);
+        state = AES_STATE_ERROR;
+    }
+    else if(dma_interrupt_flag_get(AES_DMA, AES_DMA_OUT_CHANNEL, DMA_INT_FLAG_FTF) == SET)
+    {
+        dma_interrupt_flag_clear(AES_DMA, AES_DMA_OUT_CHANNEL, DMA_INT_FLAG_FTF);
+    }
+    else
+    {
+        return;
+    }
+
+    cau_dma_disable(CAU_DMA_INFIFO | CAU_DMA_OUTFIFO);
+    /* drop lines the core fetched speculatively while DMA was writing */
+    SCB_InvalidateDCache_by_Addr(s_aes_dma_output, (int32_t)s_aes_dma_bytes);
+
+    /* GCM packet payload done: run tag phase and start the next packet */
+    if(s_gcm_dma != NULL)
+    {
+        pkt = s_gcm_dma;
+        s_gcm_dma = NULL;
+        ret = aes_gcm_finish(pkt, (state == AES_STATE_READY) ? SUCCESS : ERROR);
+        lock_release(LOCK_SEM_CAU);
+        aes_gcm_complete(pkt, ret);
+        aes_gcm_kick();
+        return;
+    }
+
+    s_aes_active = NULL;
+    lock_release(LOCK_SEM_CAU);
+    if(ctx != NULL)
+    {
+        ctx->total_length += ctx->output_length;
+        ctx->state = state;
+        if(ctx->callback != NULL)
+        {
+            ctx->callback(ctx, ctx->output_length, ctx->callback_arg);
+        }
+    }
+    aes_gcm_kick();                                                         /* packets queued behind the stream */
+}
+
+#if AES_BENCHMARK_ENABLE
+__ALIGNED(32) static uint8_t s_aes_bench_buff[65536];                       /* shared in-place test buffer */
+
+/*!
+    \brief      compare streaming AES throughput with polled cau_aes_cbc
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Requires system_dwt_init. CPU load is the share of cycles spent
+                inside aes_update (setup, partial blocks) over the total time.
+*/
+void aes_benchmark(void)
+{
+    static const uint8_t key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    static const uint8_t iv[16]  = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+    aes_context_struct ctx;
+    cau_parameter_struct cau_parameter;
+    uint32_t size, t0, polled, stream, cpu, out_length;
+
+    aes_engine_init();
+    memset(s_aes_bench_buff, 0x5A, sizeof(s_aes_bench_buff));
+
+    PRINT_INFO("AES-128-CBC encrypt benchmark (sys_ck %u Hz)>>\r\n", SystemCoreClock);
+    PRINT_INFO("size\t\tpolled MB/s\tstream MB/s\tstream CPU %%\r\n");
+    for(size = 16; size <= sizeof(s_aes_bench_buff); size <<= 2)
+    {
+        cau_parameter.alg_dir   = CAU_ENCRYPT;
+        cau_parameter.key       = (uint8_t *)key;
+        cau_parameter.key_size  = 128;
+        cau_parameter.iv        = (uint8_t *)iv;
+        cau_parameter.iv_size   = 16;
+        cau_parameter.input     = s_aes_bench_buff;
+        cau_parameter.in_length = size;
+        t0 = DWT_CYCCNT;
+        cau_aes_cbc(&cau_parameter, s_aes_bench_buff);
+        polled = DWT_CYCCNT - t0;
+        s_aes_owner = NULL;                                                 /* polled API clobbered CAU state */
+
+        t0 = DWT_CYCCNT;
+        aes_init(&ctx, CAU_MODE_AES_CBC, CAU_ENCRYPT, key, 128, iv);
+        aes_update(&ctx, s_aes_bench_buff, size, s_aes_bench_buff, NULL, NULL);
+        cpu = DWT_CYCCNT - t0;
+        aes_wait(&ctx);
+        aes_final(&ctx, s_aes_bench_buff, &out_length);
+        stream = DWT_CYCCNT - t0;
+
+        PRINT_INFO("%u\t\t%u.%02u\t\t%u.%02u\t\t%u\r\n", size,
+                   (uint32_t)((uint64_t)size * SystemCoreClock / polled / 1000000U),
+                   (uint32_t)((uint64_t)size * SystemCoreClock / polled / 10000U % 100U),
+                   (uint32_t)((uint64_t)size * SystemCoreClock / stream / 1000000U),
+                   (uint32_t)((uint64_t)size * SystemCoreClock / stream / 10000U % 100U),
+                   (uint32_t)((uint64_t)cpu * 100U / stream));
+    }
+}
+
+/*!
+    \brief      check AES-GCM against a NIST vector and measure queued packet rate
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Vector is test case 4 of the GCM specification (AES-128, 20-byte
+                AAD, 60-byte payload). Packet rate uses 32 back-to-back packets
+                with a 16-byte AAD header each.
+*/
+void aes_gcm_benchmark(void)
+{
+    static const uint8_t key[16] = {0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+                                    0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08};
+    static const uint8_t iv[AES_GCM_IV_SIZE] = {0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce,
+                                                0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88};
+    static const uint8_t aad[20] = {0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed,
+                                    0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xab, 0xad, 0xda, 0xd2};
+    static const uint8_t plain[60] =
+    {
+        0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+        0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+        0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+        0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39
+    };
+    static const uint8_t cipher[60] =
+    {
+        0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24, 0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+        0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0, 0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+        0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c, 0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+        0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97, 0x3d, 0x58, 0xe0, 0x91
+    };
+    static const uint8_t tag[AES_GCM_TAG_SIZE] = {0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb,
+                                                  0x94, 0xfa, 0xe9, 0x5a, 0xe7, 0x12, 0x1a, 0x47};
+    static const uint32_t sizes[4] = {64, 256, 1024, 1472};
+    static aes_gcm_packet_struct pkts[32];
+    aes_gcm_key_struct gcm_key;
+    uint8_t out[64];
+    uint32_t i, n, size, t0, cycles, rate;
+
+    aes_engine_init();
+    aes_gcm_key_init(&gcm_key, key, 128);
+
+    memset(&pkts[0], 0, sizeof(aes_gcm_packet_struct));
+    pkts[0].key        = &gcm_key;
+    pkts[0].alg_dir    = CAU_ENCRYPT;
+    pkts[0].iv         = iv;
+    pkts[0].aad        = aad;
+    pkts[0].aad_length = sizeof(aad);
+    pkts[0].input      = plain;
+    pkts[0].length     = sizeof(plain);
+    pkts[0].output     = out;
+    aes_gcm_submit(&pkts[0]);
+    aes_gcm_wait(&pkts[0]);
+    PRINT_INFO("AES-GCM NIST test case 4 encrypt: %s\r\n",
+               ((memcmp(out, cipher, sizeof(cipher)) == 0) && (aes_gcm_tag_check(&pkts[0], tag) == SUCCESS)) ? "pass" : "FAIL");
+
+    pkts[0].alg_dir    = CAU_DECRYPT;
+    pkts[0].input      = cipher;
+    aes_gcm_submit(&pkts[0]);
+    aes_gcm_wait(&pkts[0]);
+    PRINT_INFO("AES-GCM NIST test case 4 decrypt: %s\r\n",
+               ((memcmp(out, plain, sizeof(plain)) == 0) && (aes_gcm_tag_check(&pkts[0], tag) == SUCCESS)) ? "pass" : "FAIL");
+
+    PRINT_INFO("AES-128-GCM packet encrypt, 32 packets queued (sys_ck %u Hz)>>\r\n", SystemCoreClock);
+    PRINT_INFO("payload\t\tMB/s\t\tMbit/s\r\n");
+    for(i = 0; i < 4; i++)
+    {
+        size = sizes[i];
+        for(n = 0; n < 32; n++)
+        {
+            memset(&pkts[n], 0, sizeof(aes_gcm_packet_struct));
+            pkts[n].key        = &gcm_key;
+            pkts[n].alg_dir    = CAU_ENCRYPT;
+            pkts[n].iv         = iv;
+            pkts[n].aad        = aad;
+            pkts[n].aad_length = 16;
+            pkts[n].input      = &s_aes_bench_buff[n * size];
+            pkts[n].length     = size;
+            pkts[n].output     = &s_aes_bench_buff[n * size];
+        }
+
+        t0 = DWT_CYCCNT;
+        for(n = 0; n < 32; n++)
+        {
+            aes_gcm_submit(&pkts[n]);
+        }
+        aes_gcm_wait(&pkts[31]);
+        cycles = DWT_CYCCNT - t0;
+
+        rate = (uint32_t)((uint64_t)size * 32U * SystemCoreClock / cycles / 10000U);
+        PRINT_INFO("%u\t\t%u.%02u\t\t%u\r\n", size, rate / 100U, rate % 100U, rate * 8U / 100U);
+    }
+}
+#endif /* AES_BENCHMARK_ENABLE */
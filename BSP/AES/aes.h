@@ -0,0 +1,124 @@
+/*!
+    \file       aes.h
+    \brief      header file for streaming AES engine based on CAU with DMA
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - AES session context structure with saved CAU hardware context
+    - DMA channel allocation for CAU IN/OUT FIFOs
+    - Incremental init/update/final function declarations
+    - Completion callback type for asynchronous DMA operation
+    - AES-GCM packet descriptor and key structure for the AEAD packet queue
+    - Benchmark function declaration (DMA stream vs polled firmware API)
+*/
+
+#ifndef __AES_H
+#define __AES_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief CAU DMA configuration macros
+*/
+#define AES_DMA                     DMA1                                    /*!< DMA controller for CAU */
+#define AES_DMA_CLOCK               RCU_DMA1                                /*!< DMA clock for CAU */
+#define AES_DMA_IN_CHANNEL          DMA_CH0                                 /*!< DMA channel feeding CAU IN FIFO */
+#define AES_DMA_OUT_CHANNEL         DMA_CH1                                 /*!< DMA channel draining CAU OUT FIFO */
+#define AES_DMA_OUT_IRQ             DMA1_Channel1_IRQn                      /*!< DMA OUT channel interrupt */
+#define AES_DMA_OUT_IRQHandler      DMA1_Channel1_IRQHandler                /*!< DMA OUT channel interrupt handler */
+#define AES_DI_ADDRESS              (CAU + 0x08U)                           /*!< CAU data input register address */
+#define AES_DO_ADDRESS              (CAU + 0x0CU)                           /*!< CAU data output register address */
+
+#define AES_BENCHMARK_ENABLE        0                                       /*!< 1: build aes_benchmark with 64KB test buffer */
+
+#define AES_BLOCK_SIZE              16U                                     /*!< AES block size in bytes */
+#define AES_DMA_THRESHOLD           64U                                     /*!< below this length the FIFO is fed by CPU */
+#define AES_DMA_ALIGN               32U                                     /*!< DMA output alignment and length granule, one D-cache line */
+#define AES_GCM_IV_SIZE             12U                                     /*!< GCM packet IV size in bytes (96-bit) */
+#define AES_GCM_TAG_SIZE            16U                                     /*!< GCM authentication tag size in bytes */
+
+/*!
+    \brief AES session state
+*/
+typedef enum
+{
+    AES_STATE_IDLE = 0,                                                     /*!< context not initialized or finalized */
+    AES_STATE_READY,                                                        /*!< context initialized, ready for update */
+    AES_STATE_BUSY,                                                         /*!< DMA transfer in progress */
+    AES_STATE_ERROR                                                         /*!< last operation failed */
+} aes_state_enum;
+
+struct aes_context;
+
+/*! asynchronous completion callback, output_length is the number of bytes written to output */
+typedef void (*aes_callback_fn)(struct aes_context *ctx, uint32_t output_length, void *arg);
+
+/*!
+    \brief AES streaming session context
+*/
+typedef struct aes_context
+{
+    cau_context_parameter_struct hw_context;                                /*!< CAU context saved when swapped out */
+    cau_key_parameter_struct key;                                           /*!< expanded key registers */
+    uint8_t partial[AES_BLOCK_SIZE];                                        /*!< buffered bytes of an incomplete block */
+    uint8_t partial_length;                                                 /*!< number of valid bytes in partial */
+    volatile uint8_t state;                                                 /*!< session state (aes_state_enum) */
+    uint32_t output_length;                                                 /*!< bytes produced by the last update */
+    uint32_t total_length;                                                  /*!< total bytes processed by the session */
+    aes_callback_fn callback;                                               /*!< completion callback, may be NULL */
+    void *callback_arg;                                                     /*!< user argument passed to callback */
+} aes_context_struct;
+
+/*!
+    \brief AES-GCM key, prepared once and shared by many packets
+*/
+typedef struct
+{
+    cau_key_parameter_struct key;                                           /*!< key registers */
+    uint32_t keysize_cfg;                                                   /*!< CAU_KEYSIZE_128BIT/192BIT/256BIT */
+} aes_gcm_key_struct;
+
+struct aes_gcm_packet;
+
+/*! GCM packet completion callback, called from the DMA interrupt for DMA packets */
+typedef void (*aes_gcm_callback_fn)(struct aes_gcm_packet *pkt, void *arg);
+
+/*!
+    \brief AES-GCM packet descriptor, filled by the caller before aes_gcm_submit
+*/
+typedef struct aes_gcm_packet
+{
+    const aes_gcm_key_struct *key;                                          /*!< prepared key */
+    uint32_t alg_dir;                                                       /*!< CAU_ENCRYPT or CAU_DECRYPT */
+    const uint8_t *iv;                                                      /*!< 12-byte IV (nonce) */
+    const uint8_t *aad;                                                     /*!< additional authenticated data (header) */
+    uint32_t aad_length;                                                    /*!< AAD length in bytes */
+    const uint8_t *input;                                                   /*!< payload in */
+    uint32_t length;                                                        /*!< payload length in bytes */
+    uint8_t *output;                                                        /*!< payload out, may equal input */
+    uint8_t tag[AES_GCM_TAG_SIZE];                                          /*!< computed tag, valid after completion */
+    volatile uint8_t state;                                                 /*!< AES_STATE_BUSY until done, then READY or ERROR */
+    aes_gcm_callback_fn callback;                                           /*!< completion callback, may be NULL */
+    void *callback_arg;                                                     /*!< user argument passed to callback */
+    struct aes_gcm_packet *next;                                            /*!< queue link, managed by the driver */
+} aes_gcm_packet_struct;
+
+/* function declarations */
+void aes_engine_init(void);                                                             /*!< initialize CAU and DMA for streaming */
+ErrStatus aes_init(aes_context_struct *ctx, uint32_t algo_mode, uint32_t alg_dir, \
+                   const uint8_t *key, uint32_t key_size, const uint8_t *iv);           /*!< initialize a streaming session */
+ErrStatus aes_update(aes_context_struct *ctx, const uint8_t *input, uint32_t length, \
+                     uint8_t *output, aes_callback_fn callback, void *arg);             /*!< process data, asynchronous for large blocks */
+ErrStatus aes_final(aes_context_struct *ctx, uint8_t *output, uint32_t *output_length); /*!< flush the trailing block and release CAU */
+ErrStatus aes_wait(aes_context_struct *ctx);                                            /*!< wait for a pending update to complete */
+ErrStatus aes_gcm_key_init(aes_gcm_key_struct *gcm_key, const uint8_t *key, uint32_t key_size); /*!< prepare a GCM key */
+ErrStatus aes_gcm_submit(aes_gcm_packet_struct *pkt);                                   /*!< queue a packet for AEAD processing */
+ErrStatus aes_gcm_wait(aes_gcm_packet_struct *pkt);                                     /*!< wait for a queued packet to complete */
+ErrStatus aes_gcm_tag_check(const aes_gcm_packet_struct *pkt, const uint8_t *tag);     /*!< constant-time compare of received tag */
+#if AES_BENCHMARK_ENABLE
+void aes_benchmark(void);                                                               /*!< compare streaming throughput with polled API */
+void aes_gcm_benchmark(void);                                                           /*!< check NIST vector and measure packet rate */
+#endif
+#endif /* __AES_H */
@@ -0,0 +1,270 @@
+/*!
+    \file       bench.c
+    \brief      microbenchmark harness
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Walking the cases registered with BENCH in the bench_cases section
+    - Timing each case with DWT_CYCCNT, warm and with cold caches, minus the
+      measured overhead of an empty case
+    - Median, median absolute deviation and outlier rejection per variant
+    - One "@bench" line per result on the terminal USART, read by
+      TOOLS/bench_diff.py
+    - BENCH_HOST: clock_gettime nanoseconds as the counter, output on stdout
+*/
+
+#include "./BENCH/bench.h"
+
+#if BENCH_ENABLE
+#include <string.h>
+#if BENCH_HOST
+#include <stdio.h>
+#include <time.h>
+#define BENCH_PRINT                 printf
+#else
+#include "gd32h7xx_libopt.h"
+#include "./SYSTEM/system.h"
+#include "./USART/usart.h"
+#define BENCH_PRINT                 usart_terminal_print_fmt
+#endif /* BENCH_HOST */
+
+/* linker-generated bounds of the bench_cases section */
+#if defined(__ARMCC_VERSION)
+extern const bench_case_struct s_bench_first[] __asm("bench_cases$$Base");
+extern const bench_case_struct s_bench_limit[] __asm("bench_cases$$Limit");
+#else
+extern const bench_case_struct s_bench_first[] __asm("__start_bench_cases");
+extern const bench_case_struct s_bench_limit[] __asm("__stop_bench_cases");
+#endif
+
+volatile uint32_t g_bench_sink = 0;
+
+static uint32_t s_bench_overhead = 0;                                       /* counter ticks of timing an empty case */
+static uint32_t s_bench_samples[BENCH_SAMPLES];
+#if BENCH_HOST
+static uint8_t s_bench_sweep[BENCH_COLD_SWEEP];
+#endif /* BENCH_HOST */
+
+/*!
+    \brief      read the cycle counter
+    \param[in]  none
+    \param[out] none
+    \retval     counter ticks, wraps at 2^32
+*/
+static inline uint32_t bench_counter(void)
+{
+#if BENCH_HOST
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#else
+    return DWT_CYCCNT;
+#endif /* BENCH_HOST */
+}
+
+/*!
+    \brief      counter rate
+    \param[in]  none
+    \param[out] none
+    \retval     ticks per second: the core clock, or 1 GHz on the host
+*/
+uint32_t bench_counter_hz(void)
+{
+#if BENCH_HOST
+    return 1000000000U;
+#else
+    return SystemCoreClock;
+#endif /* BENCH_HOST */
+}
+
+/*!
+    \brief      evict the caches before a cold run
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_cache_flush(void)
+{
+#if BENCH_HOST
+    uint32_t i;
+
+    /* no cache maintenance from user space: overwrite more than the last level */
+    for(i = 0U; i < BENCH_COLD_SWEEP; i += 64U)
+    {
+        s_bench_sweep[i] = (uint8_t)i;
+    }
+    __asm volatile("" : : "r"(s_bench_sweep) : "memory");
+#else
+    if(SCB->CCR & SCB_CCR_DC_Msk)
+    {
+        SCB_CleanInvalidateDCache();
+    }
+    if(SCB->CCR & SCB_CCR_IC_Msk)
+    {
+        SCB_InvalidateICache();
+    }
+#endif /* BENCH_HOST */
+}
+
+/*!
+    \brief      empty case body, times the measurement itself
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_empty(void)
+{
+}
+
+/*!
+    \brief      sort samples in place
+    \param[in]  samples: values
+    \param[in]  count: number of values
+    \param[out] samples: ascending
+    \retval     none
+*/
+static void bench_sort(uint32_t *samples, uint32_t count)
+{
+    uint32_t i, j, v;
+
+    for(i = 1U; i < count; i++)
+    {
+        v = samples[i];
+        for(j = i; (j > 0U) && (samples[j - 1U] > v); j--)
+        {
+            samples[j] = samples[j - 1U];
+        }
+        samples[j] = v;
+    }
+}
+
+/*!
+    \brief      time BENCH_SAMPLES runs of a body
+    \param[in]  body: timed function
+    \param[in]  cache: BENCH_WARM or BENCH_COLD
+    \param[out] none
+    \retval     none, samples in s_bench_samples, overhead not subtracted
+    \note       Interrupts stay enabled so cases may wait for DMA; a sample
+                hit by an interrupt is removed by the outlier rejection.
+*/
+static void bench_sample(void (*body)(void), bench_cache_enum cache)
+{
+    uint32_t start, i;
+
+    if(cache == BENCH_WARM)
+    {
+        body();                                                             /* load the caches and branch predictor */
+    }
+    for(i = 0U; i < BENCH_SAMPLES; i++)
+    {
+        if(cache == BENCH_COLD)
+        {
+            bench_cache_flush();
+        }
+        start = bench_counter();
+        body();
+        s_bench_samples[i] = bench_counter() - start;
+    }
+}
+
+/*!
+    \brief      time one case
+    \param[in]  bench: registered case
+    \param[in]  cache: BENCH_WARM or BENCH_COLD
+    \param[out] result: statistics in counter ticks, overhead subtracted
+    \retval     none
+    \note       Samples further than BENCH_OUTLIER_MAD median absolute deviations
+                from the median are dropped from min, mean and max.
+*/
+void bench_measure(const bench_case_struct *bench, bench_cache_enum cache, bench_result_struct *result)
+{
+    uint32_t deviation[BENCH_SAMPLES];
+    uint64_t sum = 0;
+    uint32_t limit, i;
+
+    bench_sample(bench->body, cache);
+    for(i = 0U; i < BENCH_SAMPLES; i++)
+    {
+        s_bench_samples[i] = (s_bench_samples[i] > s_bench_overhead) ? (s_bench_samples[i] - s_bench_overhead) : 0U;
+    }
+    bench_sort(s_bench_samples, BENCH_SAMPLES);
+    result->median = s_bench_samples[BENCH_SAMPLES / 2U];
+    for(i = 0U; i < BENCH_SAMPLES; i++)
+    {
+        deviation[i] = (s_bench_samples[i] > result->median) ? (s_bench_samples[i] - result->median)
+                                                             : (result->median - s_bench_samples[i]);
+    }
+    bench_sort(deviation, BENCH_SAMPLES);
+    result->mad = deviation[BENCH_SAMPLES / 2U];
+    limit = (result->mad == 0U) ? 1U : result->mad * BENCH_OUTLIER_MAD;     /* counter jitter of one tick is no outlier */
+
+    result->kept = 0;
+    result->min = UINT32_MAX;
+    result->max = 0;
+    for(i = 0U; i < BENCH_SAMPLES; i++)
+    {
+        if(((s_bench_samples[i] > result->median) ? (s_bench_samples[i] - result->median)
+                                                   : (result->median - s_bench_samples[i])) <= limit)
+        {
+            result->kept++;
+            sum += s_bench_samples[i];
+            result->min = (s_bench_samples[i] < result->min) ? s_bench_samples[i] : result->min;
+            result->max = (s_bench_samples[i] > result->max) ? s_bench_samples[i] : result->max;
+        }
+    }
+    result->mean = (uint32_t)((sum + result->kept / 2U) / result->kept);   /* the median itself is always kept */
+}
+
+/*!
+    \brief      run every registered case, warm then cold, and print the results
+    \param[in]  filter: run only cases whose name contains this text, NULL for all
+    \param[out] none
+    \retval     number of cases run
+    \note       Output, one line each, fields separated by spaces:
+                @bench begin hz=<counter rate> samples=<n> overhead=<ticks>
+                @bench case=<name> cache=<warm|cold> median= mean= min= max= mad= kept=
+                @bench end cases=<n>
+                The target needs system_dwt_init and usart_terminal_init first.
+*/
+uint32_t bench_run_all(const char *filter)
+{
+    static const char *const cache_name[2] = {"warm", "cold"};
+    const bench_case_struct empty = {"empty", NULL, bench_empty};
+    const bench_case_struct *bench;
+    bench_result_struct result;
+    uint32_t cases = 0;
+    uint32_t cache;
+
+    s_bench_overhead = 0;
+    bench_measure(&empty, BENCH_WARM, &result);
+    s_bench_overhead = result.median;
+    BENCH_PRINT("@bench begin hz=%lu samples=%u overhead=%lu\r\n", (unsigned long)bench_counter_hz(),
+                (unsigned)BENCH_SAMPLES, (unsigned long)s_bench_overhead);
+
+    for(bench = s_bench_first; bench < s_bench_limit; bench++)
+    {
+        if((filter != NULL) && (strstr(bench->name, filter) == NULL))
+        {
+            continue;
+        }
+        if(bench->setup != NULL)
+        {
+            bench->setup();
+        }
+        for(cache = BENCH_WARM; cache <= BENCH_COLD; cache++)
+        {
+            bench_measure(bench, (bench_cache_enum)cache, &result);
+            BENCH_PRINT("@bench case=%s cache=%s median=%lu mean=%lu min=%lu max=%lu mad=%lu kept=%u\r\n",
+                        bench->name, cache_name[cache], (unsigned long)result.median, (unsigned long)result.mean,
+                        (unsigned long)result.min, (unsigned long)result.max, (unsigned long)result.mad,
+                        (unsigned)result.kept);
+        }
+        cases++;
+    }
+    BENCH_PRINT("@bench end cases=%lu\r\n", (unsigned long)cases);
+    return cases;
+}
+#endif /* BENCH_ENABLE */
@@ -0,0 +1,100 @@
+/*!
+    \file       bench.h
+    \brief      header file for the microbenchmark harness
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - BENCH(name, setup, body) registration into the bench_cases section
+    - Warm and cold cache variants, sample count and outlier rejection settings
+    - Result structure and the run functions of the Bench build type
+    - BENCH_HOST: the same harness on Linux with a clock_gettime cycle counter
+*/
+
+#ifndef __BENCH_H
+#define __BENCH_H
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+    \brief      harness configuration
+                BENCH_ENABLE is set by the Bench build type and by the host
+                build; without it the cases and the harness compile to nothing
+*/
+#ifndef BENCH_ENABLE
+#define BENCH_ENABLE                0
+#endif /* BENCH_ENABLE */
+#ifndef BENCH_HOST
+#define BENCH_HOST                  0                                       /*!< 1: Linux build, see HOST/Makefile */
+#endif /* BENCH_HOST */
+
+#define BENCH_SAMPLES               31U                                     /*!< timed runs per case and variant */
+#define BENCH_OUTLIER_MAD           4U                                      /*!< reject samples further than this many MADs from the median */
+#define BENCH_COLD_SWEEP            (4U * 1024U * 1024U)                    /*!< host: bytes written to push the case out of the caches */
+
+/*!
+    \brief cache state before each timed run
+*/
+typedef enum
+{
+    BENCH_WARM = 0,                                                         /*!< caches hold the previous run */
+    BENCH_COLD                                                              /*!< D-cache cleaned and invalidated, I-cache invalidated */
+} bench_cache_enum;
+
+/*!
+    \brief registered benchmark
+*/
+typedef struct
+{
+    const char *name;                                                       /*!< case name, no spaces */
+    void (*setup)(void);                                                    /*!< untimed, once before the samples, may be NULL */
+    void (*body)(void);                                                     /*!< timed code */
+} bench_case_struct;
+
+/*!
+    \brief statistics of one case and variant, in counter ticks
+*/
+typedef struct
+{
+    uint32_t min;                                                           /*!< fastest kept sample */
+    uint32_t median;                                                        /*!< median of all samples */
+    uint32_t mean;                                                          /*!< mean of the kept samples */
+    uint32_t max;                                                           /*!< slowest kept sample */
+    uint32_t mad;                                                           /*!< median absolute deviation */
+    uint16_t kept;                                                          /*!< samples after outlier rejection */
+} bench_result_struct;
+
+#if BENCH_ENABLE
+#define BENCH_ENTRY                 __attribute__((used, section("bench_cases"), aligned(4)))  /*!< collected by the linker */
+
+/*!
+    \brief      register a benchmark
+    \param[in]  name: identifier, printed in the results
+    \param[in]  setup: void function run once before the samples, or NULL
+    \param[in]  body: void function timed BENCH_SAMPLES times per variant
+*/
+#define BENCH(name, setup, body)                                                        \
+    BENCH_ENTRY const bench_case_struct bench_case_##name = {#name, (setup), (body)}
+
+/*!
+    \brief      keep a result alive so the compiler cannot drop the timed code
+    \param[in]  value: computed value
+*/
+#define BENCH_KEEP(value)           (g_bench_sink = (uint32_t)(value))
+
+extern volatile uint32_t g_bench_sink;                                      /*!< written by BENCH_KEEP */
+
+/* function declarations */
+uint32_t bench_counter_hz(void);                                                        /*!< counter ticks per second */
+void bench_measure(const bench_case_struct *bench, bench_cache_enum cache, bench_result_struct *result); /*!< time one case */
+uint32_t bench_run_all(const char *filter);                                             /*!< run and print every case */
+#endif /* BENCH_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __BENCH_H */
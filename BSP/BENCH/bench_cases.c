@@ -0,0 +1,203 @@
+/*!
+    \file       bench_cases.c
+    \brief      benchmark cases of the Bench build type
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - memcpy, slice-by-8 CRC-32 and software SHA-256 over fixed buffers, also
+      built on the host
+    - Sensor hub batch selection over a full sensor table, also on the host
+    - CRC-32 on the CRC unit, CPU fed and DMA fed, on the target only
+*/
+
+#include "./BENCH/bench.h"
+
+#if BENCH_ENABLE
+#include <string.h>
+#include "./CRC/crc_sw.h"
+#include "./HASH/sha256.h"
+#include "./SENSORHUB/sensorhub_sched.h"
+#if !BENCH_HOST
+#include "gd32h7xx_libopt.h"
+#include "./CRC/crc.h"
+#endif /* !BENCH_HOST */
+
+#define BENCH_CASES_DATA_SIZE       4096U                                   /* input of every case */
+
+__attribute__((aligned(32))) static uint8_t s_bench_cases_src[BENCH_CASES_DATA_SIZE];
+__attribute__((aligned(32))) static uint8_t s_bench_cases_dst[BENCH_CASES_DATA_SIZE];
+static crc_sw_table_struct s_bench_cases_crc_table;
+static sensorhub_read_struct s_bench_cases_reads[SENSORHUB_MAX_SENSORS];
+static sensorhub_sched_struct s_bench_cases_sched;
+static uint32_t s_bench_cases_now;
+
+/*!
+    \brief      fill the input buffer with a fixed pattern
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_cases_data_setup(void)
+{
+    uint32_t i;
+
+    for(i = 0U; i < BENCH_CASES_DATA_SIZE; i++)
+    {
+        s_bench_cases_src[i] = (uint8_t)(i * 31U + 7U);
+    }
+}
+
+/*!
+    \brief      copy 4 KB
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_cases_memcpy_4k(void)
+{
+    memcpy(s_bench_cases_dst, s_bench_cases_src, BENCH_CASES_DATA_SIZE);
+    BENCH_KEEP(s_bench_cases_dst[BENCH_CASES_DATA_SIZE - 1U]);
+}
+BENCH(memcpy_4k, bench_cases_data_setup, bench_cases_memcpy_4k);
+
+/*!
+    \brief      build the CRC-32 tables
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_cases_crc_sw_setup(void)
+{
+    bench_cases_data_setup();
+    crc_sw_table_init(&s_bench_cases_crc_table, &g_crc_preset_crc32);
+}
+
+/*!
+    \brief      slice-by-8 CRC-32 of 1 KB
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_cases_crc32_sw_1k(void)
+{
+    uint32_t reg = crc_sw_start(&s_bench_cases_crc_table);
+
+    reg = crc_sw_update(&s_bench_cases_crc_table, reg, s_bench_cases_src, 1024U);
+    BENCH_KEEP(crc_sw_final(&s_bench_cases_crc_table, reg));
+}
+BENCH(crc32_sw_1k, bench_cases_crc_sw_setup, bench_cases_crc32_sw_1k);
+
+/*!
+    \brief      software SHA-256 of 1 KB
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_cases_sha256_1k(void)
+{
+    sha256_context_struct ctx;
+    uint8_t digest[SHA256_DIGEST_SIZE];
+
+    sha256_init(&ctx);
+    sha256_update(&ctx, s_bench_cases_src, 1024U);
+    sha256_final(&ctx, digest);
+    BENCH_KEEP(digest[0]);
+}
+BENCH(sha256_1k, bench_cases_data_setup, bench_cases_sha256_1k);
+
+/*!
+    \brief      declare a full sensor table on two buses
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_cases_sensorhub_setup(void)
+{
+    uint8_t i;
+
+    for(i = 0U; i < SENSORHUB_MAX_SENSORS; i++)
+    {
+        s_bench_cases_reads[i].bus = i & 1U;
+        s_bench_cases_reads[i].address = 0x20U + i;
+        s_bench_cases_reads[i].reg = 0U;
+        s_bench_cases_reads[i].length = 6U;
+        s_bench_cases_reads[i].period_us = 1000U * (1U + (i & 3U));
+        s_bench_cases_reads[i].slack_us = 250U;
+    }
+    s_bench_cases_now = 0U;
+    sensorhub_sched_init(&s_bench_cases_sched, SENSORHUB_MAX_SENSORS, 0U);
+}
+
+/*!
+    \brief      one scheduler pass of sensorhub_process: a batch per bus, then the next wakeup
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_cases_sensorhub_batch(void)
+{
+    uint8_t ids[SENSORHUB_MAX_SENSORS];
+    uint8_t n;
+
+    n = sensorhub_sched_batch(&s_bench_cases_sched, s_bench_cases_reads, SENSORHUB_MAX_SENSORS, 0U,
+                              s_bench_cases_now, ids, SENSORHUB_MAX_SENSORS);
+    n += sensorhub_sched_batch(&s_bench_cases_sched, s_bench_cases_reads, SENSORHUB_MAX_SENSORS, 1U,
+                               s_bench_cases_now, ids, SENSORHUB_MAX_SENSORS);
+    s_bench_cases_now += sensorhub_sched_due(&s_bench_cases_sched, s_bench_cases_reads, SENSORHUB_MAX_SENSORS,
+                                             SENSORHUB_BUS_ANY, s_bench_cases_now);
+    BENCH_KEEP(n);
+}
+BENCH(sensorhub_batch_16, bench_cases_sensorhub_setup, bench_cases_sensorhub_batch);
+
+#if !BENCH_HOST
+/*!
+    \brief      start the CRC unit
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_cases_crc_hw_setup(void)
+{
+    bench_cases_data_setup();
+    crc_engine_init();
+}
+
+/*!
+    \brief      CRC-32 of 128 bytes on the CRC unit, fed by the CPU
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_cases_crc32_hw_128(void)
+{
+    crc_context_struct ctx;
+    uint32_t crc;
+
+    crc_start(&ctx, &g_crc_preset_crc32, CRC_BACKEND_HW);
+    crc_update(&ctx, s_bench_cases_src, 128U, NULL, NULL);
+    crc_final(&ctx, &crc);
+    BENCH_KEEP(crc);
+}
+BENCH(crc32_hw_128, bench_cases_crc_hw_setup, bench_cases_crc32_hw_128);
+
+/*!
+    \brief      CRC-32 of 4 KB on the CRC unit, fed by DMA
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_cases_crc32_hw_4k(void)
+{
+    crc_context_struct ctx;
+    uint32_t crc;
+
+    crc_start(&ctx, &g_crc_preset_crc32, CRC_BACKEND_HW);
+    crc_update(&ctx, s_bench_cases_src, BENCH_CASES_DATA_SIZE, NULL, NULL);
+    crc_final(&ctx, &crc);
+    BENCH_KEEP(crc);
+}
+BENCH(crc32_hw_4k, bench_cases_crc_hw_setup, bench_cases_crc32_hw_4k);
+#endif /* !BENCH_HOST */
+#endif /* BENCH_ENABLE */
@@ -0,0 +1,244 @@
+/*!
+    \file       bench_reg_cases.cpp
+    \brief      typed register layer against the firmware library macros
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Pairs of functions doing the same register work, <name>_c with the REG32
+      macros of the firmware library and <name>_cpp with BSP/REG, compared
+      instruction by instruction by TOOLS/disasm_compare.py
+    - BENCH cases timing both, which also keep the pairs in the Bench image
+    - BENCH_REG_INVALID: field values the layer must reject, for the
+      compile-fail check of HOST/Makefile
+    Cases use the spare pin BENCH_REG_PIN, UART6 without pins and DMA1
+    channel 7 without a request, so running them disturbs nothing.
+*/
+
+#include "./BENCH/bench.h"
+#include "./REG/reg_gpio.hpp"
+#include "./REG/reg_usart.hpp"
+#include "./REG/reg_dma.hpp"
+
+#define BENCH_REG_PORT              GPIOH                                   /* spare pin toggled by the GPIO cases */
+#define BENCH_REG_PIN               13U
+#define BENCH_REG_UCLK              150000000U                              /* a USART kernel clock for the constant divider */
+
+typedef reg::gpioh bench_reg_port;
+typedef bench_reg_port::pin<BENCH_REG_PIN> bench_reg_pin;
+typedef reg::uart6 bench_reg_uart;
+typedef reg::dma1::channel<7U> bench_reg_dma;
+
+extern "C" {
+/*!
+    \brief      drive the pin high, firmware macros
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((noinline)) void bench_reg_gpio_set_c(void)
+{
+    GPIO_BOP(BENCH_REG_PORT) = BIT(BENCH_REG_PIN);
+}
+
+/*!
+    \brief      drive the pin high, BSP/REG
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((noinline)) void bench_reg_gpio_set_cpp(void)
+{
+    bench_reg_pin::high();
+}
+
+/*!
+    \brief      pin as push-pull output, 85 MHz, pull-up, firmware macros
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((noinline)) void bench_reg_gpio_config_c(void)
+{
+    GPIO_CTL(BENCH_REG_PORT) = (GPIO_CTL(BENCH_REG_PORT) & ~GPIO_MODE_MASK(BENCH_REG_PIN)) |
+                               GPIO_MODE_SET(BENCH_REG_PIN, GPIO_MODE_OUTPUT);
+    GPIO_OMODE(BENCH_REG_PORT) &= ~BIT(BENCH_REG_PIN);
+    GPIO_OSPD(BENCH_REG_PORT) = (GPIO_OSPD(BENCH_REG_PORT) & ~GPIO_OSPEED_MASK(BENCH_REG_PIN)) |
+                                GPIO_OSPEED_SET(BENCH_REG_PIN, GPIO_OSPEED_85MHZ);
+    GPIO_PUD(BENCH_REG_PORT) = (GPIO_PUD(BENCH_REG_PORT) & ~GPIO_PUPD_MASK(BENCH_REG_PIN)) |
+                               GPIO_PUPD_SET(BENCH_REG_PIN, GPIO_PUPD_PULLUP);
+}
+
+/*!
+    \brief      pin as push-pull output, 85 MHz, pull-up, BSP/REG
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((noinline)) void bench_reg_gpio_config_cpp(void)
+{
+    bench_reg_port::ctl::modify<bench_reg_pin::mode::value<reg::gpio_mode::output>>();
+    bench_reg_port::omode::modify<bench_reg_pin::otype::value<reg::gpio_otype::push_pull>>();
+    bench_reg_port::ospd::modify<bench_reg_pin::speed::value<reg::gpio_speed::mhz85>>();
+    bench_reg_port::pud::modify<bench_reg_pin::pull::value<reg::gpio_pull::up>>();
+}
+
+/*!
+    \brief      8N1 at 115200 baud, transmitter and receiver on, firmware macros
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((noinline)) void bench_reg_usart_config_c(void)
+{
+    USART_CTL0(UART6) &= ~(USART_CTL0_UEN | USART_CTL0_WL0 | USART_CTL0_WL1 | USART_CTL0_PCEN | USART_CTL0_OVSMOD);
+    USART_CTL1(UART6) = (USART_CTL1(UART6) & ~USART_CTL1_STB) | USART_STB_1BIT;
+    USART_BAUD(UART6) = (BENCH_REG_UCLK + 115200U / 2U) / 115200U;
+    USART_CTL0(UART6) |= USART_CTL0_UEN | USART_CTL0_TEN | USART_CTL0_REN;
+}
+
+/*!
+    \brief      8N1 at 115200 baud, transmitter and receiver on, BSP/REG
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((noinline)) void bench_reg_usart_config_cpp(void)
+{
+    typedef bench_reg_uart u;
+
+    u::ctl0::modify<u::uen::off, u::wl0::off, u::wl1::off, u::pcen::off, u::ovsmod::off>();
+    u::ctl1::modify<u::stb::value<reg::usart_stop::bits1>>();
+    u::baud_reg::write<u::baud<BENCH_REG_UCLK, 115200U>>();
+    u::ctl0::modify<u::uen::on, u::ten::on, u::ren::on>();
+}
+
+/*!
+    \brief      send a byte once the data register is empty, firmware macros
+    \param[in]  data: byte
+    \param[out] none
+    \retval     none
+*/
+__attribute__((noinline)) void bench_reg_usart_put_c(uint8_t data)
+{
+    while(!(USART_STAT(UART6) & USART_STAT_TBE))
+    {
+    }
+    USART_TDATA(UART6) = data;
+}
+
+/*!
+    \brief      send a byte once the data register is empty, BSP/REG
+    \param[in]  data: byte
+    \param[out] none
+    \retval     none
+*/
+__attribute__((noinline)) void bench_reg_usart_put_cpp(uint8_t data)
+{
+    bench_reg_uart::put(data);
+}
+
+/*!
+    \brief      memory to peripheral, 8-bit, memory increment, high priority, firmware macros
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((noinline)) void bench_reg_dma_config_c(void)
+{
+    DMA_INTC1(DMA1) = DMA_FLAG_ADD(DMA_CHINTF_RESET_VALUE, 3U);
+    DMA_CHCTL(DMA1, 7U) = (DMA_CHCTL(DMA1, 7U) & ~(DMA_CHXCTL_TM | DMA_CHXCTL_MNAGA | DMA_CHXCTL_PNAGA |
+                                                   DMA_CHXCTL_PWIDTH | DMA_CHXCTL_MWIDTH | DMA_CHXCTL_PRIO)) |
+                          DMA_MEMORY_TO_PERIPH | DMA_CHXCTL_MNAGA | DMA_PERIPH_WIDTH_8BIT |
+                          DMA_MEMORY_WIDTH_8BIT | DMA_PRIORITY_HIGH;
+}
+
+/*!
+    \brief      memory to peripheral, 8-bit, memory increment, high priority, BSP/REG
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((noinline)) void bench_reg_dma_config_cpp(void)
+{
+    typedef bench_reg_dma d;
+
+    d::intc::write<d::clear_all>();
+    d::ctl::modify<d::tm::value<reg::dma_dir::memory_to_periph>, d::mnaga::on, d::pnaga::off,
+                   d::pwidth::value<reg::dma_width::bits8>, d::mwidth::value<reg::dma_width::bits8>,
+                   d::prio::value<reg::dma_priority::high>>();
+}
+} /* extern "C" */
+
+#if BENCH_REG_INVALID
+/* each case must fail to compile, sizeof instantiates the class templates */
+#if BENCH_REG_INVALID == 1
+typedef bench_reg_port::pin<16U> bench_reg_invalid;                         /* no pin 16 */
+#elif BENCH_REG_INVALID == 2
+typedef bench_reg_pin::af::value<16U> bench_reg_invalid;                    /* AF 0-15 */
+#elif BENCH_REG_INVALID == 3
+typedef bench_reg_pin::mode::value<reg::gpio_pull::up> bench_reg_invalid; /* pull value for the mode field */
+#elif BENCH_REG_INVALID == 4
+typedef bench_reg_uart::baud<BENCH_REG_UCLK, 12000000U> bench_reg_invalid;  /* divider below 16 */
+#elif BENCH_REG_INVALID == 5
+typedef bench_reg_uart::baud<1000000U, 57600U> bench_reg_invalid;           /* 2.1 % rate error */
+#elif BENCH_REG_INVALID == 6
+static void bench_reg_invalid(void)
+{
+    bench_reg_port::ctl::modify<bench_reg_pin::mode::value<reg::gpio_mode::af>,
+                                bench_reg_pin::mode::value<reg::gpio_mode::output>>();  /* one field twice */
+}
+#elif BENCH_REG_INVALID == 7
+static void bench_reg_invalid(void)
+{
+    bench_reg_port::ctl::modify<bench_reg_pin::pull::value<reg::gpio_pull::up>>();      /* field of PUD written to CTL */
+}
+#endif
+#if BENCH_REG_INVALID <= 5
+static const unsigned bench_reg_invalid_size = sizeof(bench_reg_invalid);
+#endif
+#endif /* BENCH_REG_INVALID */
+
+#if BENCH_ENABLE && !BENCH_HOST
+/*!
+    \brief      clock the port, UART and DMA of the cases
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_reg_setup(void)
+{
+    bench_reg_port::clock::enable();
+    bench_reg_uart::clock::enable();
+    reg::dma1::clock::enable();
+    bench_reg_usart_config_c();
+}
+
+/*!
+    \brief      send a zero byte on the pinless UART, firmware macros and BSP/REG
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_reg_usart_put_c0(void)
+{
+    bench_reg_usart_put_c(0U);
+}
+
+static void bench_reg_usart_put_cpp0(void)
+{
+    bench_reg_usart_put_cpp(0U);
+}
+
+BENCH(reg_gpio_set_c, bench_reg_setup, bench_reg_gpio_set_c);
+BENCH(reg_gpio_set_cpp, bench_reg_setup, bench_reg_gpio_set_cpp);
+BENCH(reg_gpio_config_c, bench_reg_setup, bench_reg_gpio_config_c);
+BENCH(reg_gpio_config_cpp, bench_reg_setup, bench_reg_gpio_config_cpp);
+BENCH(reg_usart_config_c, bench_reg_setup, bench_reg_usart_config_c);
+BENCH(reg_usart_config_cpp, bench_reg_setup, bench_reg_usart_config_cpp);
+BENCH(reg_usart_put_c, bench_reg_setup, bench_reg_usart_put_c0);
+BENCH(reg_usart_put_cpp, bench_reg_setup, bench_reg_usart_put_cpp0);
+BENCH(reg_dma_config_c, bench_reg_setup, bench_reg_dma_config_c);
+BENCH(reg_dma_config_cpp, bench_reg_setup, bench_reg_dma_config_cpp);
+#endif /* BENCH_ENABLE && !BENCH_HOST */
@@ -0,0 +1,90 @@
+/*!
+    \file       clock.c
+    \brief      cached clock tree service on the RCU registers
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - RCU register snapshot for the pure clock tree computation
+    - Clock tree cache, recomputed on first use after invalidation
+    - O(1) frequency lookup replacing repeated rcu_clock_freq_get decoding
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./CLOCK/clock.h"
+
+static clock_tree_struct s_clock_tree;                                      /* cached clock tree */
+static volatile uint8_t s_clock_valid = 0;                                  /* 1: s_clock_tree matches the RCU registers */
+
+/*!
+    \brief      read the RCU registers the clock tree depends on
+    \param[in]  none
+    \param[out] regs: register snapshot with oscillator frequencies
+    \retval     none
+*/
+void clock_tree_snapshot(clock_regs_struct *regs)
+{
+    regs->cfg0 = RCU_CFG0;
+    regs->cfg1 = RCU_CFG1;
+    regs->addctl1 = RCU_ADDCTL1;
+    regs->pllall = RCU_PLLALL;
+    regs->pll[0] = RCU_PLL0;
+    regs->pll[1] = RCU_PLL1;
+    regs->pll[2] = RCU_PLL2;
+    regs->pllfra[0] = RCU_PLL0FRA;
+    regs->pllfra[1] = RCU_PLL1FRA;
+    regs->pllfra[2] = RCU_PLL2FRA;
+    regs->plladdctl = RCU_PLLADDCTL;
+    regs->hxtal = HXTAL_VALUE;
+    regs->irc64m = IRC64M_VALUE;
+    regs->lpirc4m = LPIRC4M_VALUE;
+    regs->lxtal = LXTAL_VALUE;
+}
+
+/*!
+    \brief      get the cached clock tree
+    \param[in]  none
+    \param[out] none
+    \retval     clock tree, recomputed from the registers if invalidated
+*/
+const clock_tree_struct *clock_tree_get(void)
+{
+    clock_regs_struct regs;
+
+    if(!s_clock_valid)
+    {
+        clock_tree_snapshot(&regs);
+        clock_tree_compute(&regs, &s_clock_tree);
+        s_clock_valid = 1;
+    }
+    return &s_clock_tree;
+}
+
+/*!
+    \brief      get the frequency of one clock
+    \param[in]  id: clock identifier (clock_id_enum)
+    \param[out] none
+    \retval     frequency in Hz, 0 for an unknown identifier
+*/
+uint32_t clock_freq_get(clock_id_enum id)
+{
+    if((uint32_t)id >= CLOCK_NUM)
+    {
+        return 0;
+    }
+    return clock_tree_get()->freq[id];
+}
+
+/*!
+    \brief      mark the clock tree stale
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Call after changing RCU_CFG0, RCU_CFG1, the PLL registers or the
+                IRC64M divider; the next lookup recomputes the tree.
+*/
+void clock_tree_invalidate(void)
+{
+    s_clock_valid = 0;
+}
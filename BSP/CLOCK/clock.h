@@ -0,0 +1,24 @@
+/*!
+    \file       clock.h
+    \brief      header file for cached clock tree service
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Cached clock tree computed once from the RCU registers
+    - O(1) frequency lookup for bus, PLL and peripheral kernel clocks
+    - Invalidation after clock reconfiguration
+*/
+
+#ifndef __CLOCK_H
+#define __CLOCK_H
+#include <stdint.h>
+#include "./CLOCK/clock_tree.h"
+
+/* function declarations */
+void clock_tree_snapshot(clock_regs_struct *regs);                                      /*!< read the RCU registers */
+const clock_tree_struct *clock_tree_get(void);                                          /*!< cached tree, recomputed if invalid */
+uint32_t clock_freq_get(clock_id_enum id);                                              /*!< frequency of one clock */
+void clock_tree_invalidate(void);                                                       /*!< mark the tree stale after reconfiguration */
+#endif /* __CLOCK_H */
@@ -0,0 +1,83 @@
+/*!
+    \file       clock_config.h
+    \brief      PLL divider constants generated by TOOLS/clock_gen.py
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    Generated by: clock_gen.py --hxtal 25M --pll1 p=130M,q=260M,r=260M --pll2 q=120M,r=48M
+    Do not edit by hand, run the generator again. The range checks at the
+    end of this file stop the build if a value is changed by hand.
+*/
+
+#ifndef __CLOCK_CONFIG_H
+#define __CLOCK_CONFIG_H
+
+#define CLOCK_CONFIG_HXTAL          25000000U
+
+/* PLL1: 25 MHz / 5 * 52 = VCO 260 MHz; P 130 MHz, Q 260 MHz, R 260 MHz */
+#define CLOCK_PLL1_PSC              5U
+#define CLOCK_PLL1_N                52U
+#define CLOCK_PLL1_P                2U
+#define CLOCK_PLL1_Q                1U
+#define CLOCK_PLL1_R                1U
+#define CLOCK_PLL1_RNG              RCU_PLL1RNG_4M_8M
+#define CLOCK_PLL1_VCO              RCU_PLL1VCO_192M_836M
+#define CLOCK_PLL1_VCO_MIN          192000000U
+#define CLOCK_PLL1_VCO_MAX          836000000U
+#define CLOCK_PLL1P_HZ              130000000U
+#define CLOCK_PLL1Q_HZ              260000000U
+#define CLOCK_PLL1R_HZ              260000000U
+
+/* PLL2: 25 MHz / 5 * 48 = VCO 240 MHz; Q 120 MHz, R 48 MHz */
+#define CLOCK_PLL2_PSC              5U
+#define CLOCK_PLL2_N                48U
+#define CLOCK_PLL2_P                2U
+#define CLOCK_PLL2_Q                2U
+#define CLOCK_PLL2_R                5U
+#define CLOCK_PLL2_RNG              RCU_PLL2RNG_4M_8M
+#define CLOCK_PLL2_VCO              RCU_PLL2VCO_192M_836M
+#define CLOCK_PLL2_VCO_MIN          192000000U
+#define CLOCK_PLL2_VCO_MAX          836000000U
+#define CLOCK_PLL2Q_HZ              120000000U
+#define CLOCK_PLL2R_HZ              48000000U
+
+/* range checks */
+#if (CLOCK_PLL1_PSC < 1U) || (CLOCK_PLL1_PSC > 63U) || (CLOCK_PLL1_N < 9U) || (CLOCK_PLL1_N > 512U)
+#error "PLL1 PSC or N out of range"
+#endif
+#if ((CLOCK_CONFIG_HXTAL / CLOCK_PLL1_PSC) < 1000000U) || ((CLOCK_CONFIG_HXTAL / CLOCK_PLL1_PSC) > 16000000U)
+#error "PLL1 input out of range"
+#endif
+#if ((CLOCK_CONFIG_HXTAL / CLOCK_PLL1_PSC * CLOCK_PLL1_N) < CLOCK_PLL1_VCO_MIN) || ((CLOCK_CONFIG_HXTAL / CLOCK_PLL1_PSC * CLOCK_PLL1_N) > CLOCK_PLL1_VCO_MAX)
+#error "PLL1 VCO out of range"
+#endif
+#if (CLOCK_PLL1_P < 1U) || (CLOCK_PLL1_P > 128U)
+#error "PLL1 P divider out of range"
+#endif
+#if (CLOCK_PLL1_Q < 1U) || (CLOCK_PLL1_Q > 128U)
+#error "PLL1 Q divider out of range"
+#endif
+#if (CLOCK_PLL1_R < 1U) || (CLOCK_PLL1_R > 128U)
+#error "PLL1 R divider out of range"
+#endif
+#if (CLOCK_PLL2_PSC < 1U) || (CLOCK_PLL2_PSC > 63U) || (CLOCK_PLL2_N < 9U) || (CLOCK_PLL2_N > 512U)
+#error "PLL2 PSC or N out of range"
+#endif
+#if ((CLOCK_CONFIG_HXTAL / CLOCK_PLL2_PSC) < 1000000U) || ((CLOCK_CONFIG_HXTAL / CLOCK_PLL2_PSC) > 16000000U)
+#error "PLL2 input out of range"
+#endif
+#if ((CLOCK_CONFIG_HXTAL / CLOCK_PLL2_PSC * CLOCK_PLL2_N) < CLOCK_PLL2_VCO_MIN) || ((CLOCK_CONFIG_HXTAL / CLOCK_PLL2_PSC * CLOCK_PLL2_N) > CLOCK_PLL2_VCO_MAX)
+#error "PLL2 VCO out of range"
+#endif
+#if (CLOCK_PLL2_P < 1U) || (CLOCK_PLL2_P > 128U)
+#error "PLL2 P divider out of range"
+#endif
+#if (CLOCK_PLL2_Q < 1U) || (CLOCK_PLL2_Q > 128U)
+#error "PLL2 Q divider out of range"
+#endif
+#if (CLOCK_PLL2_R < 1U) || (CLOCK_PLL2_R > 128U)
+#error "PLL2 R divider out of range"
+#endif
+
+#endif /* __CLOCK_CONFIG_H */
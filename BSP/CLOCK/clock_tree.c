@@ -0,0 +1,208 @@
+/*!
+    \file       clock_tree.c
+    \brief      clock tree computation from an RCU register snapshot
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Decoding CK_SYS, AHB/APB prescalers, PLL0..2 P/Q/R and kernel clock selectors
+    - Integer PLL frequency calculation including the fractional multiplier
+    - Timer kernel clocks following the TIMERSEL multiplier rule
+*/
+
+#include "./CLOCK/clock_tree.h"
+
+/* register fields, see gd32h7xx_rcu.h */
+#define CLOCK_FIELD(reg, pos, width)    (((reg) >> (pos)) & ((1UL << (width)) - 1U))
+
+#define CLOCK_SCSS_IRC64MDIV        0U                                      /* RCU_CFG0 SCSS values */
+#define CLOCK_SCSS_HXTAL            1U
+#define CLOCK_SCSS_LPIRC4M          2U
+#define CLOCK_SCSS_PLL0P            3U
+
+#define CLOCK_PLLSEL_IRC64MDIV      0U                                      /* RCU_PLLALL PLLSEL values */
+#define CLOCK_PLLSEL_HXTAL          2U
+
+#define CLOCK_PERSEL_IRC64MDIV      0U                                      /* RCU_CFG1 PERSEL values */
+#define CLOCK_PERSEL_HXTAL          2U
+
+#define CLOCK_USARTSEL_APB          0U                                      /* RCU_CFG1 USARTxSEL values */
+#define CLOCK_USARTSEL_AHB          1U
+#define CLOCK_USARTSEL_LXTAL        2U
+
+#define CLOCK_PLLFRA_EN             (1UL << 15)                             /* RCU_PLLxFRA PLLxFRAEN */
+#define CLOCK_CFG1_TIMERSEL         (1UL << 24)                             /* RCU_CFG1 TIMERSEL */
+
+static const uint8_t s_clock_ahb_exp[16] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 6, 7, 8, 9};
+static const uint8_t s_clock_apb_exp[8] = {0, 0, 0, 0, 1, 2, 3, 4};
+
+/*!
+    \brief      calculate a PLL output frequency
+    \param[in]  input: PLL source frequency in Hz
+    \param[in]  psc: input divider PLLxPSC, 0 means PLL not configured
+    \param[in]  n: multiplier (register value + 1)
+    \param[in]  fracn: fractional multiplier in 1/8192 steps
+    \param[in]  div: output divider P, Q or R (register value + 1)
+    \param[out] none
+    \retval     frequency in Hz, truncated
+*/
+uint32_t clock_tree_pll_freq(uint32_t input, uint32_t psc, uint32_t n, uint32_t fracn, uint32_t div)
+{
+    uint64_t vco;
+
+    if((psc == 0U) || (div == 0U))
+    {
+        return 0;
+    }
+    vco = (uint64_t)input * (((uint64_t)n << 13) + fracn);
+    return (uint32_t)(vco / ((uint64_t)psc * div << 13));
+}
+
+/*!
+    \brief      calculate the kernel clock of timers on one APB bus
+    \param[in]  ahb: CK_AHB in Hz
+    \param[in]  apb: CK_APBx in Hz
+    \param[in]  apb_psc: APBxPSC field value
+    \param[in]  mul4: 1 if TIMERSEL selects the x4 rule
+    \param[out] none
+    \retval     frequency in Hz
+*/
+static uint32_t clock_tree_timer_freq(uint32_t ahb, uint32_t apb, uint32_t apb_psc, uint8_t mul4)
+{
+    if(mul4)
+    {
+        return (apb_psc <= 5U) ? ahb : (apb * 4U);
+    }
+    return (apb_psc <= 4U) ? ahb : (apb * 2U);
+}
+
+/*!
+    \brief      calculate a USART kernel clock from its selector
+    \param[in]  sel: USARTxSEL field value
+    \param[in]  apb: CK_APBx of the USART bus in Hz
+    \param[in]  ahb: CK_AHB in Hz
+    \param[in]  regs: register snapshot
+    \param[in]  irc64mdiv: CK_IRC64MDIV in Hz
+    \param[out] none
+    \retval     frequency in Hz
+*/
+static uint32_t clock_tree_usart_freq(uint32_t sel, uint32_t apb, uint32_t ahb, const clock_regs_struct *regs, uint32_t irc64mdiv)
+{
+    switch(sel)
+    {
+        case CLOCK_USARTSEL_APB:
+            return apb;
+        case CLOCK_USARTSEL_AHB:
+            return ahb;
+        case CLOCK_USARTSEL_LXTAL:
+            return regs->lxtal;
+        default:
+            return irc64mdiv;
+    }
+}
+
+/*!
+    \brief      compute every clock of the tree from a register snapshot
+    \param[in]  regs: RCU register snapshot and oscillator frequencies
+    \param[out] tree: computed frequencies, 0 for disabled PLL outputs
+    \retval     none
+    \note       Same decoding as rcu_clock_freq_get, done once for all clocks.
+*/
+void clock_tree_compute(const clock_regs_struct *regs, clock_tree_struct *tree)
+{
+    uint32_t *f = tree->freq;
+    uint32_t irc64mdiv, pll_src, fracn, psc, n, apb1_psc, apb2_psc;
+    uint32_t sel, i;
+    uint8_t mul4;
+    /* P, Q and R divider fields and output enables of PLL0..2 */
+    static const uint8_t q_pos[3] = {0, 8, 16};
+    static const uint8_t p_en[3] = {25, 28, 31};
+    static const uint8_t q_en[3] = {23, 26, 29};
+    static const uint8_t r_en[3] = {24, 27, 30};
+
+    irc64mdiv = regs->irc64m >> CLOCK_FIELD(regs->addctl1, 16, 2);
+    f[CLOCK_IRC64MDIV] = irc64mdiv;
+    f[CLOCK_HXTAL] = regs->hxtal;
+    f[CLOCK_LPIRC4M] = regs->lpirc4m;
+    f[CLOCK_LXTAL] = regs->lxtal;
+
+    sel = CLOCK_FIELD(regs->pllall, 16, 2);
+    if(sel == CLOCK_PLLSEL_HXTAL)
+    {
+        pll_src = regs->hxtal;
+    }
+    else if(sel == CLOCK_PLLSEL_IRC64MDIV)
+    {
+        pll_src = irc64mdiv;
+    }
+    else
+    {
+        pll_src = regs->lpirc4m;
+    }
+
+    for(i = 0; i < 3; i++)
+    {
+        psc = CLOCK_FIELD(regs->pll[i], 0, 6);
+        n = CLOCK_FIELD(regs->pll[i], 6, 9) + 1U;
+        fracn = (regs->pllfra[i] & CLOCK_PLLFRA_EN) ? CLOCK_FIELD(regs->pllfra[i], 0, 13) : 0U;
+
+        f[CLOCK_PLL0P + 3U * i] = ((regs->plladdctl >> p_en[i]) & 1U) ? \
+            clock_tree_pll_freq(pll_src, psc, n, fracn, CLOCK_FIELD(regs->pll[i], 16, 7) + 1U) : 0U;
+        f[CLOCK_PLL0Q + 3U * i] = ((regs->plladdctl >> q_en[i]) & 1U) ? \
+            clock_tree_pll_freq(pll_src, psc, n, fracn, CLOCK_FIELD(regs->plladdctl, q_pos[i], 7) + 1U) : 0U;
+        f[CLOCK_PLL0R + 3U * i] = ((regs->plladdctl >> r_en[i]) & 1U) ? \
+            clock_tree_pll_freq(pll_src, psc, n, fracn, CLOCK_FIELD(regs->pll[i], 24, 7) + 1U) : 0U;
+    }
+
+    switch(CLOCK_FIELD(regs->cfg0, 2, 2))
+    {
+        case CLOCK_SCSS_HXTAL:
+            f[CLOCK_SYS] = regs->hxtal;
+            break;
+        case CLOCK_SCSS_LPIRC4M:
+            f[CLOCK_SYS] = regs->lpirc4m;
+            break;
+        case CLOCK_SCSS_PLL0P:
+            /* CK_SYS does not depend on the PLL0P output enable */
+            psc = CLOCK_FIELD(regs->pll[0], 0, 6);
+            n = CLOCK_FIELD(regs->pll[0], 6, 9) + 1U;
+            fracn = (regs->pllfra[0] & CLOCK_PLLFRA_EN) ? CLOCK_FIELD(regs->pllfra[0], 0, 13) : 0U;
+            f[CLOCK_SYS] = clock_tree_pll_freq(pll_src, psc, n, fracn, CLOCK_FIELD(regs->pll[0], 16, 7) + 1U);
+            break;
+        default:
+            f[CLOCK_SYS] = irc64mdiv;
+            break;
+    }
+
+    apb1_psc = CLOCK_FIELD(regs->cfg0, 10, 3);
+    apb2_psc = CLOCK_FIELD(regs->cfg0, 13, 3);
+    f[CLOCK_AHB] = f[CLOCK_SYS] >> s_clock_ahb_exp[CLOCK_FIELD(regs->cfg0, 4, 4)];
+    f[CLOCK_APB1] = f[CLOCK_AHB] >> s_clock_apb_exp[apb1_psc];
+    f[CLOCK_APB2] = f[CLOCK_AHB] >> s_clock_apb_exp[apb2_psc];
+    f[CLOCK_APB3] = f[CLOCK_AHB] >> s_clock_apb_exp[CLOCK_FIELD(regs->cfg0, 27, 3)];
+    f[CLOCK_APB4] = f[CLOCK_AHB] >> s_clock_apb_exp[CLOCK_FIELD(regs->cfg0, 24, 3)];
+
+    mul4 = (regs->cfg1 & CLOCK_CFG1_TIMERSEL) ? 1 : 0;
+    f[CLOCK_TIMER_APB1] = clock_tree_timer_freq(f[CLOCK_AHB], f[CLOCK_APB1], apb1_psc, mul4);
+    f[CLOCK_TIMER_APB2] = clock_tree_timer_freq(f[CLOCK_AHB], f[CLOCK_APB2], apb2_psc, mul4);
+
+    sel = CLOCK_FIELD(regs->cfg1, 14, 2);
+    if(sel == CLOCK_PERSEL_HXTAL)
+    {
+        f[CLOCK_PER] = regs->hxtal;
+    }
+    else if(sel == CLOCK_PERSEL_IRC64MDIV)
+    {
+        f[CLOCK_PER] = irc64mdiv;
+    }
+    else
+    {
+        f[CLOCK_PER] = regs->lpirc4m;
+    }
+
+    f[CLOCK_USART0] = clock_tree_usart_freq(CLOCK_FIELD(regs->cfg1, 0, 2), f[CLOCK_APB2], f[CLOCK_AHB], regs, irc64mdiv);
+    f[CLOCK_USART1] = clock_tree_usart_freq(CLOCK_FIELD(regs->cfg1, 18, 2), f[CLOCK_APB1], f[CLOCK_AHB], regs, irc64mdiv);
+    f[CLOCK_USART2] = clock_tree_usart_freq(CLOCK_FIELD(regs->cfg1, 20, 2), f[CLOCK_APB1], f[CLOCK_AHB], regs, irc64mdiv);
+    f[CLOCK_USART5] = clock_tree_usart_freq(CLOCK_FIELD(regs->cfg1, 22, 2), f[CLOCK_APB2], f[CLOCK_AHB], regs, irc64mdiv);
+}
@@ -0,0 +1,83 @@
+/*!
+    \file       clock_tree.h
+    \brief      header file for clock tree computation from an RCU register snapshot
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Clock identifiers for system, bus, PLL and peripheral kernel clocks
+    - RCU register snapshot structure with oscillator frequencies
+    - Clock tree structure with one frequency per identifier
+    - No device headers; the host selftest compares the tree with
+      rcu_clock_freq_get on the RCU model
+*/
+
+#ifndef __CLOCK_TREE_H
+#define __CLOCK_TREE_H
+#include <stdint.h>
+
+/*!
+    \brief clock identifiers, CLOCK_SYS..CLOCK_LPIRC4M in rcu_clock_freq_enum order
+*/
+typedef enum
+{
+    CLOCK_SYS = 0,                                                          /*!< CK_SYS */
+    CLOCK_AHB,                                                              /*!< CK_AHB */
+    CLOCK_APB1,                                                             /*!< CK_APB1 */
+    CLOCK_APB2,                                                             /*!< CK_APB2 */
+    CLOCK_APB3,                                                             /*!< CK_APB3 */
+    CLOCK_APB4,                                                             /*!< CK_APB4 */
+    CLOCK_PLL0P,                                                            /*!< PLL0P output, 0 if disabled */
+    CLOCK_PLL0Q,                                                            /*!< PLL0Q output, 0 if disabled */
+    CLOCK_PLL0R,                                                            /*!< PLL0R output, 0 if disabled */
+    CLOCK_PLL1P,                                                            /*!< PLL1P output, 0 if disabled */
+    CLOCK_PLL1Q,                                                            /*!< PLL1Q output, 0 if disabled */
+    CLOCK_PLL1R,                                                            /*!< PLL1R output, 0 if disabled */
+    CLOCK_PLL2P,                                                            /*!< PLL2P output, 0 if disabled */
+    CLOCK_PLL2Q,                                                            /*!< PLL2Q output, 0 if disabled */
+    CLOCK_PLL2R,                                                            /*!< PLL2R output, 0 if disabled */
+    CLOCK_PER,                                                              /*!< CK_PER */
+    CLOCK_USART0,                                                           /*!< USART0 kernel clock */
+    CLOCK_USART1,                                                           /*!< USART1 kernel clock */
+    CLOCK_USART2,                                                           /*!< USART2 kernel clock */
+    CLOCK_USART5,                                                           /*!< USART5 kernel clock */
+    CLOCK_IRC64MDIV,                                                        /*!< CK_IRC64MDIV */
+    CLOCK_HXTAL,                                                            /*!< HXTAL */
+    CLOCK_LPIRC4M,                                                          /*!< LPIRC4M */
+    CLOCK_TIMER_APB1,                                                       /*!< kernel clock of timers on APB1 */
+    CLOCK_TIMER_APB2,                                                       /*!< kernel clock of timers on APB2 */
+    CLOCK_LXTAL,                                                            /*!< LXTAL */
+    CLOCK_NUM
+} clock_id_enum;
+
+/*!
+    \brief RCU registers and oscillator frequencies the clock tree depends on
+*/
+typedef struct
+{
+    uint32_t cfg0;                                                          /*!< RCU_CFG0 */
+    uint32_t cfg1;                                                          /*!< RCU_CFG1 */
+    uint32_t addctl1;                                                       /*!< RCU_ADDCTL1 */
+    uint32_t pllall;                                                        /*!< RCU_PLLALL */
+    uint32_t pll[3];                                                        /*!< RCU_PLL0, RCU_PLL1, RCU_PLL2 */
+    uint32_t pllfra[3];                                                     /*!< RCU_PLL0FRA, RCU_PLL1FRA, RCU_PLL2FRA */
+    uint32_t plladdctl;                                                     /*!< RCU_PLLADDCTL */
+    uint32_t hxtal;                                                         /*!< HXTAL frequency */
+    uint32_t irc64m;                                                        /*!< IRC64M frequency */
+    uint32_t lpirc4m;                                                       /*!< LPIRC4M frequency */
+    uint32_t lxtal;                                                         /*!< LXTAL frequency */
+} clock_regs_struct;
+
+/*!
+    \brief computed clock tree
+*/
+typedef struct
+{
+    uint32_t freq[CLOCK_NUM];                                               /*!< frequency in Hz per clock_id_enum */
+} clock_tree_struct;
+
+/* function declarations */
+void clock_tree_compute(const clock_regs_struct *regs, clock_tree_struct *tree);     /*!< compute every clock from a snapshot */
+uint32_t clock_tree_pll_freq(uint32_t input, uint32_t psc, uint32_t n, uint32_t fracn, uint32_t div); /*!< PLL output frequency */
+#endif /* __CLOCK_TREE_H */
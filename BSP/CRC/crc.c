@@ -0,0 +1,533 @@
+/*!
+    \file       crc.c
+    \brief      CRC service on the CRC unit with DMA feeding and session switching
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - CRC unit configuration from named presets (size, polynomial, reflection, init)
+    - Incremental CRC over many buffers with unit state save and restore
+    - DMA memory-to-CRC feeding of large buffers, CPU word writes for small ones
+    - Slice-by-8 software backend when the unit is not initialized or not wanted
+    - Throughput benchmark against crc_block_data_calculate and slice-by-8
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./CRC/crc.h"
+#include "./LOCK/lock.h"
+#include "./SYSTEM/system.h"
+#include "./USART/usart.h"
+#include <string.h>
+
+static uint8_t s_crc_ready = 0;                                             /* CRC engine initialized */
+static crc_context_struct *s_crc_owner = NULL;                              /* session whose state is in CRC_DATA */
+static crc_context_struct *s_crc_active = NULL;                             /* session with DMA transfer in progress, holds LOCK_SEM_CRC */
+static crc_sw_table_struct s_crc_sw_table;                                  /* slice-by-8 tables of the last software preset */
+
+/*!
+    \brief      initialize the CRC unit and DMA channel
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The unit is arbitrated through LOCK_SEM_CRC, lock_init must have run.
+*/
+void crc_engine_init(void)
+{
+    rcu_periph_clock_enable(RCU_CRC);
+    crc_deinit();
+
+    rcu_periph_clock_enable(CRC_DMA_CLOCK);
+    rcu_periph_clock_enable(RCU_DMAMUX);
+    dma_deinit(CRC_DMA, CRC_DMA_CHANNEL);
+    nvic_irq_enable(CRC_DMA_IRQ, 3, 0);
+
+    s_crc_owner = NULL;
+    s_crc_active = NULL;
+    s_crc_ready = 1;
+}
+
+/*!
+    \brief      get the CRC unit polynomial size setting for a preset
+    \param[in]  preset: CRC preset
+    \param[out] ps: CRC_CTL_PS_xx value
+    \retval     ErrStatus: SUCCESS or ERROR if the width is not supported by the unit
+*/
+static ErrStatus crc_hw_size_get(const crc_preset_struct *preset, uint32_t *ps)
+{
+    switch(preset->width)
+    {
+        case 32: *ps = CRC_CTL_PS_32; break;
+        case 16: *ps = CRC_CTL_PS_16; break;
+        case 8:  *ps = CRC_CTL_PS_8;  break;
+        case 7:  *ps = CRC_CTL_PS_7;  break;
+        default: return ERROR;
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      load the session state into the CRC unit, saving the previous owner
+    \param[in]  ctx: session to activate
+    \param[out] none
+    \retval     none
+    \note       Output reversal stays disabled so CRC_DATA always holds the raw
+                register, which can be restored through CRC_IDATA.
+*/
+static void crc_hw_acquire(crc_context_struct *ctx)
+{
+    uint32_t ps = CRC_CTL_PS_32;
+
+    if(s_crc_owner == ctx)
+    {
+        return;
+    }
+    if(s_crc_owner != NULL)
+    {
+        s_crc_owner->reg = crc_data_register_read();
+    }
+
+    crc_hw_size_get(ctx->preset, &ps);
+    crc_polynomial_size_set(ps);
+    crc_polynomial_set(ctx->preset->poly);
+    crc_input_data_reverse_config(ctx->preset->reflect ? CRC_INPUT_DATA_WORD : CRC_INPUT_DATA_NOT);
+    crc_reverse_output_data_disable();
+    crc_init_data_register_write(ctx->reg);
+    crc_data_register_reset();
+    s_crc_owner = ctx;
+}
+
+/*!
+    \brief      feed data to the CRC unit by CPU writes
+    \param[in]  preset: preset loaded in the unit
+    \param[in]  data: data bytes
+    \param[in]  length: data length in bytes
+    \param[out] none
+    \retval     none
+    \note       Words are written in stream order: reflected presets use word bit
+                reversal, normal presets byte-swap so the first byte goes first.
+*/
+static void crc_hw_write(const crc_preset_struct *preset, const uint8_t *data, uint32_t length)
+{
+    uint32_t word;
+
+    while(length >= 4)
+    {
+        memcpy(&word, data, 4);                                             /* data may be unaligned */
+        REG32(CRC) = preset->reflect ? word : __REV(word);
+        data += 4;
+        length -= 4;
+    }
+
+    if(length > 0)
+    {
+        if(preset->reflect)
+        {
+            crc_input_data_reverse_config(CRC_INPUT_DATA_BYTE);
+        }
+        while(length--)
+        {
+            REG8(CRC) = *data++;
+        }
+        if(preset->reflect)
+        {
+            crc_input_data_reverse_config(CRC_INPUT_DATA_WORD);
+        }
+    }
+}
+
+/*!
+    \brief      start DMA feeding of whole words into CRC_DATA
+    \param[in]  preset: preset loaded in the unit
+    \param[in]  data: data, 4-byte aligned
+    \param[in]  words: number of 32-bit words, at most CRC_DMA_MAX_WORDS
+    \param[out] none
+    \retval     none
+    \note       Memory-to-memory transfer through the channel FIFO. Normal presets
+                are written as bytes so the FIFO unpacks each word in stream order.
+*/
+static void crc_dma_start(const crc_preset_struct *preset, const uint8_t *data, uint32_t words)
+{
+    dma_multi_data_parameter_struct dma_init_struct;
+
+    SCB_CleanDCache_by_Addr((void *)data, (int32_t)(words * 4U));
+
+    dma_channel_disable(CRC_DMA, CRC_DMA_CHANNEL);
+    DMA_INTC0(CRC_DMA) |= DMA_FLAG_ADD(DMA_CHINTF_RESET_VALUE, CRC_DMA_CHANNEL);
+
+    dma_init_struct.request            = DMA_REQUEST_M2M;
+    dma_init_struct.periph_addr        = (uint32_t)data;                    /* source side in memory-to-memory mode */
+    dma_init_struct.periph_width       = DMA_PERIPH_WIDTH_32BIT;
+    dma_init_struct.periph_inc         = DMA_PERIPH_INCREASE_ENABLE;
+    dma_init_struct.memory0_addr       = (uint32_t)CRC;
+    dma_init_struct.memory_width       = preset->reflect ? DMA_MEMORY_WIDTH_32BIT : DMA_MEMORY_WIDTH_8BIT;
+    dma_init_struct.memory_inc         = DMA_MEMORY_INCREASE_DISABLE;
+    dma_init_struct.memory_burst_width = DMA_MEMORY_BURST_SINGLE;
+    dma_init_struct.periph_burst_width = DMA_PERIPH_BURST_SINGLE;
+    dma_init_struct.critical_value     = DMA_FIFO_4_WORD;
+    dma_init_struct.circular_mode      = DMA_CIRCULAR_MODE_DISABLE;
+    dma_init_struct.direction          = DMA_MEMORY_TO_MEMORY;
+    dma_init_struct.number             = words;
+    dma_init_struct.priority           = DMA_PRIORITY_MEDIUM;
+    dma_multi_data_mode_init(CRC_DMA, CRC_DMA_CHANNEL, &dma_init_struct);
+
+    dma_interrupt_enable(CRC_DMA, CRC_DMA_CHANNEL, DMA_INT_FTF | DMA_INT_TAE);
+    dma_channel_enable(CRC_DMA, CRC_DMA_CHANNEL);
+}
+
+/*!
+    \brief      start the next DMA run of a pending update, or finish it by CPU
+    \param[in]  ctx: session with pending data
+    \param[out] none
+    \retval     1 if a DMA run was started, 0 if the update is complete
+*/
+static uint8_t crc_dma_continue(crc_context_struct *ctx)
+{
+    uint32_t words = ctx->pending_length / 4U;
+    const uint8_t *data = ctx->pending;
+
+    if(ctx->pending_length < CRC_DMA_THRESHOLD)
+    {
+        crc_hw_write(ctx->preset, ctx->pending, ctx->pending_length);
+        ctx->pending = NULL;
+        ctx->pending_length = 0;
+        return 0;
+    }
+
+    words = (words > CRC_DMA_MAX_WORDS) ? CRC_DMA_MAX_WORDS : words;
+    ctx->pending += words * 4U;
+    ctx->pending_length -= words * 4U;
+    crc_dma_start(ctx->preset, data, words);
+    return 1;
+}
+
+/*!
+    \brief      start a CRC session
+    \param[in]  ctx: session context
+    \param[in]  preset: CRC algorithm, e.g. &g_crc_preset_crc32
+    \param[in]  backend: CRC_BACKEND_HW or CRC_BACKEND_SW
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note       CRC_BACKEND_HW falls back to software when crc_engine_init has not
+                run or the preset width is not 7, 8, 16 or 32 bits.
+*/
+ErrStatus crc_start(crc_context_struct *ctx, const crc_preset_struct *preset, uint8_t backend)
+{
+    uint32_t ps;
+
+    if((preset == NULL) || ((backend != CRC_BACKEND_HW) && (backend != CRC_BACKEND_SW)))
+    {
+        return ERROR;
+    }
+
+    if(s_crc_owner == ctx)
+    {
+        s_crc_owner = NULL;
+    }
+    memset(ctx, 0, sizeof(crc_context_struct));
+    ctx->preset = preset;
+    ctx->backend = CRC_BACKEND_SW;
+    if(s_crc_ready && (backend == CRC_BACKEND_HW) && (SUCCESS == crc_hw_size_get(preset, &ps)))
+    {
+        ctx->backend = CRC_BACKEND_HW;
+    }
+
+    if(ctx->backend == CRC_BACKEND_HW)
+    {
+        ctx->reg = preset->init;
+    }
+    else
+    {
+        if(s_crc_sw_table.preset != preset)
+        {
+            crc_sw_table_init(&s_crc_sw_table, preset);
+        }
+        ctx->reg = crc_sw_start(&s_crc_sw_table);
+    }
+    ctx->state = CRC_STATE_READY;
+    return SUCCESS;
+}
+
+/*!
+    \brief      add data to a CRC session
+    \param[in]  ctx: session context
+    \param[in]  data: data bytes
+    \param[in]  length: data length in bytes
+    \param[in]  callback: completion callback, NULL for none
+    \param[in]  arg: user argument passed to callback
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if accepted, ERROR if the unit is busy or session invalid
+    \note       The unit is held through LOCK_SEM_CRC until the data is in, so an
+                ISR finds it busy instead of corrupting a thread's session.
+                At least CRC_DMA_THRESHOLD bytes are fed by DMA after aligning the
+                start by CPU, and this function returns immediately; data must stay
+                valid until the callback runs or crc_wait returns.
+*/
+ErrStatus crc_update(crc_context_struct *ctx, const uint8_t *data, uint32_t length, \
+                     crc_callback_fn callback, void *arg)
+{
+    uint32_t head;
+
+    if(ctx->state != CRC_STATE_READY)
+    {
+        return ERROR;
+    }
+
+    if(ctx->backend == CRC_BACKEND_SW)
+    {
+        if(s_crc_sw_table.preset != ctx->preset)
+        {
+            crc_sw_table_init(&s_crc_sw_table, ctx->preset);                /* another software preset ran in between */
+        }
+        ctx->reg = crc_sw_update(&s_crc_sw_table, ctx->reg, data, length);
+        if(callback != NULL)
+        {
+            callback(ctx, arg);
+        }
+        return SUCCESS;
+    }
+
+    if(SUCCESS != lock_try(LOCK_SEM_CRC))
+    {
+        return ERROR;
+    }
+
+    crc_hw_acquire(ctx);
+    ctx->callback = callback;
+    ctx->callback_arg = arg;
+
+    head = (4U - ((uint32_t)data & 0x03U)) & 0x03U;
+    if((length >= head) && (length - head >= CRC_DMA_THRESHOLD))
+    {
+        crc_hw_write(ctx->preset, data, head);
+        ctx->pending = data + head;
+        ctx->pending_length = length - head;
+        ctx->state = CRC_STATE_BUSY;
+        s_crc_active = ctx;
+        crc_dma_continue(ctx);                                              /* the DMA interrupt releases the unit */
+        return SUCCESS;
+    }
+
+    crc_hw_write(ctx->preset, data, length);
+    lock_release(LOCK_SEM_CRC);
+    if(callback != NULL)
+    {
+        callback(ctx, arg);
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      wait for a pending update to complete
+    \param[in]  ctx: session context
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if the transfer failed
+*/
+ErrStatus crc_wait(crc_context_struct *ctx)
+{
+    while(ctx->state == CRC_STATE_BUSY)
+    {
+    }
+    return (ctx->state == CRC_STATE_ERROR) ? ERROR : SUCCESS;
+}
+
+/*!
+    \brief      finish a CRC session and output the CRC value
+    \param[in]  ctx: session context
+    \param[out] crc: CRC value, right-aligned
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note       ERROR with the session kept when the context holding the unit is
+                switching it away from this session: call again.
+*/
+ErrStatus crc_final(crc_context_struct *ctx, uint32_t *crc)
+{
+    const crc_preset_struct *preset = ctx->preset;
+    uint32_t mask;
+    uint32_t reg;
+    ErrStatus locked = ERROR;
+    ErrStatus ret = SUCCESS;
+
+    if((ERROR == crc_wait(ctx)) || (ctx->state != CRC_STATE_READY))
+    {
+        ret = ERROR;
+    }
+    else if(ctx->backend == CRC_BACKEND_SW)
+    {
+        if(s_crc_sw_table.preset != preset)
+        {
+            crc_sw_table_init(&s_crc_sw_table, preset);
+        }
+        *crc = crc_sw_final(&s_crc_sw_table, ctx->reg);
+    }
+    else
+    {
+        /* a holder that cannot run now owns the unit for another session, or is
+           saving this one: ctx->reg is only valid in the first case */
+        locked = lock_try(LOCK_SEM_CRC);
+        if((locked != SUCCESS) && (s_crc_owner == ctx))
+        {
+            return ERROR;
+        }
+        mask = (preset->width == 32U) ? 0xFFFFFFFFU : ((1UL << preset->width) - 1U);
+        reg = ((s_crc_owner == ctx) ? crc_data_register_read() : ctx->reg) & mask;
+        if(preset->reflect)
+        {
+            reg = crc_sw_reflect(reg, preset->width);
+        }
+        *crc = (reg ^ preset->xorout) & mask;
+    }
+
+    if(s_crc_owner == ctx)
+    {
+        s_crc_owner = NULL;
+    }
+    if(locked == SUCCESS)
+    {
+        lock_release(LOCK_SEM_CRC);
+    }
+    ctx->state = CRC_STATE_IDLE;
+    return ret;
+}
+
+/*!
+    \brief      CRC DMA channel interrupt handler, continues or completes an update
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void CRC_DMA_IRQHandler(void)
+{
+    crc_context_struct *ctx = s_crc_active;
+    uint8_t state = CRC_STATE_READY;
+
+    if(dma_interrupt_flag_get(CRC_DMA, CRC_DMA_CHANNEL, DMA_INT_FLAG_TAE) == SET)
+    {
+        dma_interrupt_flag_clear(CRC_DMA, CRC_DMA_CHANNEL, DMA_INT_FLAG_TAE);
+        state = CRC_STATE_ERROR;
+    }
+    else if(dma_interrupt_flag_get(CRC_DMA, CRC_DMA_CHANNEL, DMA_INT_FLAG_FTF) == SET)
+    {
+        dma_interrupt_flag_clear(CRC_DMA, CRC_DMA_CHANNEL, DMA_INT_FLAG_FTF);
+    }
+    else
+    {
+        return;
+    }
+
+    if(ctx == NULL)
+    {
+        return;
+    }
+    if((state == CRC_STATE_READY) && crc_dma_continue(ctx))
+    {
+        return;                                                             /* buffer longer than one DMA run */
+    }
+
+    s_crc_active = NULL;
+    lock_release(LOCK_SEM_CRC);
+    ctx->state = state;
+    if(ctx->callback != NULL)
+    {
+        ctx->callback(ctx, ctx->callback_arg);
+    }
+}
+
+#if CRC_BENCHMARK_ENABLE
+__ALIGNED(32) static uint8_t s_crc_bench_buff[65536];                       /* benchmark data buffer */
+
+/*!
+    \brief      compute a CRC in one call on the selected backend
+    \param[in]  preset: CRC preset
+    \param[in]  backend: CRC_BACKEND_HW or CRC_BACKEND_SW
+    \param[in]  data: data bytes
+    \param[in]  length: data length in bytes
+    \param[out] none
+    \retval     CRC value
+*/
+static uint32_t crc_benchmark_compute(const crc_preset_struct *preset, uint8_t backend, \
+                                      const uint8_t *data, uint32_t length)
+{
+    crc_context_struct ctx;
+    uint32_t crc = 0;
+
+    crc_start(&ctx, preset, backend);
+    crc_update(&ctx, data, length, NULL, NULL);
+    crc_final(&ctx, &crc);
+    return crc;
+}
+
+/*!
+    \brief      print throughput in MB/s with two decimals
+    \param[in]  size: bytes processed
+    \param[in]  cycles: CPU cycles taken
+    \param[out] none
+    \retval     none
+*/
+static void crc_benchmark_rate_print(uint32_t size, uint32_t cycles)
+{
+    uint32_t rate = (uint32_t)((uint64_t)size * SystemCoreClock / cycles / 10000U);
+
+    PRINT("%u.%02u\t\t", rate / 100U, rate % 100U);
+}
+
+/*!
+    \brief      check presets on both backends and compare CRC32 throughput
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Polled is crc_block_data_calculate with word input, stream is
+                crc_update (DMA above CRC_DMA_THRESHOLD), software is slice-by-8.
+*/
+void crc_benchmark(void)
+{
+    static const crc_preset_struct *const presets[4] = {&g_crc_preset_crc32, &g_crc_preset_crc32c,
+                                                        &g_crc_preset_crc16_ccitt, &g_crc_preset_crc8};
+    static const char *const names[4] = {"CRC32", "CRC32C", "CRC16-CCITT", "CRC8"};
+    crc_context_struct ctx;
+    uint32_t i, size, t0, polled, stream, soft;
+    uint32_t hw, sw;
+
+    crc_engine_init();
+    for(i = 0; i < sizeof(s_crc_bench_buff); i++)
+    {
+        s_crc_bench_buff[i] = (uint8_t)(i * 7U + (i >> 8));
+    }
+
+    for(i = 0; i < 4; i++)
+    {
+        hw = crc_benchmark_compute(presets[i], CRC_BACKEND_HW, (const uint8_t *)"123456789", 9);
+        sw = crc_benchmark_compute(presets[i], CRC_BACKEND_SW, (const uint8_t *)"123456789", 9);
+        PRINT_INFO("%s check 0x%08X hw 0x%08X sw 0x%08X ", names[i], presets[i]->check, hw, sw);
+        hw = crc_benchmark_compute(presets[i], CRC_BACKEND_HW, s_crc_bench_buff + 1, sizeof(s_crc_bench_buff) - 3);
+        sw = crc_benchmark_compute(presets[i], CRC_BACKEND_SW, s_crc_bench_buff + 1, sizeof(s_crc_bench_buff) - 3);
+        PRINT("dma %s\r\n", (hw == sw) ? "match" : "MISMATCH");
+    }
+
+    PRINT_INFO("CRC32 benchmark (sys_ck %u Hz)>>\r\n", SystemCoreClock);
+    PRINT_INFO("size\t\tpolled MB/s\tstream MB/s\tsoftware MB/s\r\n");
+    for(size = 64; size <= sizeof(s_crc_bench_buff); size <<= 2)
+    {
+        crc_start(&ctx, &g_crc_preset_crc32, CRC_BACKEND_HW);
+        crc_hw_acquire(&ctx);
+        t0 = DWT_CYCCNT;
+        crc_data_register_reset();
+        crc_block_data_calculate(s_crc_bench_buff, size / 4U, INPUT_FORMAT_WORD);
+        polled = DWT_CYCCNT - t0;
+        s_crc_owner = NULL;
+
+        t0 = DWT_CYCCNT;
+        crc_benchmark_compute(&g_crc_preset_crc32, CRC_BACKEND_HW, s_crc_bench_buff, size);
+        stream = DWT_CYCCNT - t0;
+
+        t0 = DWT_CYCCNT;
+        crc_benchmark_compute(&g_crc_preset_crc32, CRC_BACKEND_SW, s_crc_bench_buff, size);
+        soft = DWT_CYCCNT - t0;
+
+        PRINT_INFO("%u\t\t", size);
+        crc_benchmark_rate_print(size, polled);
+        crc_benchmark_rate_print(size, stream);
+        crc_benchmark_rate_print(size, soft);
+        PRINT("\r\n");
+    }
+}
+#endif /* CRC_BENCHMARK_ENABLE */
@@ -0,0 +1,81 @@
+/*!
+    \file       crc.h
+    \brief      header file for CRC service on the CRC unit with DMA feeding
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - CRC session context with saved unit state
+    - DMA channel allocation for memory-to-CRC feeding
+    - Incremental start/update/final declarations over named presets
+    - Backend selection (CRC unit or slice-by-8 software)
+*/
+
+#ifndef __CRC_H
+#define __CRC_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+#include "./CRC/crc_sw.h"
+
+/*!
+    \brief CRC DMA configuration macros
+*/
+#define CRC_DMA                     DMA1                                    /*!< DMA controller for CRC feeding */
+#define CRC_DMA_CLOCK               RCU_DMA1                                /*!< DMA clock for CRC feeding */
+#define CRC_DMA_CHANNEL             DMA_CH3                                 /*!< DMA channel, memory to CRC_DATA */
+#define CRC_DMA_IRQ                 DMA1_Channel3_IRQn                      /*!< DMA channel interrupt */
+#define CRC_DMA_IRQHandler          DMA1_Channel3_IRQHandler                /*!< DMA channel interrupt handler */
+#define CRC_DMA_MAX_WORDS           0xFFFCU                                 /*!< words per DMA run (16-bit counter) */
+
+#define CRC_BENCHMARK_ENABLE        0                                       /*!< 1: build crc_benchmark with 64KB test buffer */
+#define CRC_DMA_THRESHOLD           256U                                    /*!< below this length the unit is fed by CPU */
+
+/*!
+    \brief CRC backend selection
+*/
+#define CRC_BACKEND_HW              0U                                      /*!< CRC unit (software if engine not initialized) */
+#define CRC_BACKEND_SW              1U                                      /*!< slice-by-8 software */
+
+/*!
+    \brief CRC session state
+*/
+typedef enum
+{
+    CRC_STATE_IDLE = 0,                                                     /*!< context not started or finalized */
+    CRC_STATE_READY,                                                        /*!< ready for update */
+    CRC_STATE_BUSY,                                                         /*!< DMA transfer in progress */
+    CRC_STATE_ERROR                                                         /*!< last operation failed */
+} crc_state_enum;
+
+struct crc_context;
+
+/*! asynchronous update completion callback */
+typedef void (*crc_callback_fn)(struct crc_context *ctx, void *arg);
+
+/*!
+    \brief CRC session context
+*/
+typedef struct crc_context
+{
+    const crc_preset_struct *preset;                                        /*!< CRC algorithm */
+    uint32_t reg;                                                           /*!< CRC_DATA saved when swapped out, or software register */
+    const uint8_t *pending;                                                 /*!< data left for the DMA interrupt */
+    uint32_t pending_length;                                                /*!< bytes left for the DMA interrupt */
+    uint8_t backend;                                                        /*!< CRC_BACKEND_HW or CRC_BACKEND_SW */
+    volatile uint8_t state;                                                 /*!< session state (crc_state_enum) */
+    crc_callback_fn callback;                                               /*!< completion callback, may be NULL */
+    void *callback_arg;                                                     /*!< user argument passed to callback */
+} crc_context_struct;
+
+/* function declarations */
+void crc_engine_init(void);                                                             /*!< initialize CRC unit and DMA */
+ErrStatus crc_start(crc_context_struct *ctx, const crc_preset_struct *preset, uint8_t backend); /*!< start a CRC session */
+ErrStatus crc_update(crc_context_struct *ctx, const uint8_t *data, uint32_t length, \
+                     crc_callback_fn callback, void *arg);                              /*!< add data */
+ErrStatus crc_wait(crc_context_struct *ctx);                                            /*!< wait for a pending update */
+ErrStatus crc_final(crc_context_struct *ctx, uint32_t *crc);                            /*!< finish and output CRC value */
+#if CRC_BENCHMARK_ENABLE
+void crc_benchmark(void);                                                               /*!< compare CPU, DMA and slice-by-8 */
+#endif
+#endif /* __CRC_H */
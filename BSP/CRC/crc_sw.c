@@ -0,0 +1,184 @@
+/*!
+    \file       crc_sw.c
+    \brief      portable slice-by-8 software CRC
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Software fallback for the CRC service when the CRC unit is unavailable
+    - Reference results for checking the CRC unit configuration of each preset
+    - Slice-by-8 processing (8 bytes per step) for reflected and normal CRCs
+*/
+
+#include "./CRC/crc_sw.h"
+
+const crc_preset_struct g_crc_preset_crc32       = {0x04C11DB7U, 0xFFFFFFFFU, 0xFFFFFFFFU, 0xCBF43926U, 32, 1};
+const crc_preset_struct g_crc_preset_crc32c      = {0x1EDC6F41U, 0xFFFFFFFFU, 0xFFFFFFFFU, 0xE3069283U, 32, 1};
+const crc_preset_struct g_crc_preset_crc16_ccitt = {0x00001021U, 0x0000FFFFU, 0x00000000U, 0x000029B1U, 16, 0};
+const crc_preset_struct g_crc_preset_crc8        = {0x00000007U, 0x00000000U, 0x00000000U, 0x000000F4U, 8,  0};
+
+/*!
+    \brief      reverse the bit order of the low width bits
+    \param[in]  value: input value
+    \param[in]  width: number of bits, 1 to 32
+    \param[out] none
+    \retval     reflected value
+*/
+uint32_t crc_sw_reflect(uint32_t value, uint8_t width)
+{
+    uint32_t result = 0;
+    uint8_t i;
+
+    for(i = 0; i < width; i++)
+    {
+        result = (result << 1) | (value & 1U);
+        value >>= 1;
+    }
+    return result;
+}
+
+/*!
+    \brief      build slice-by-8 tables for a preset
+    \param[in]  table: table structure to fill (8 KB)
+    \param[in]  preset: CRC preset
+    \param[out] none
+    \retval     none
+    \note       Reflected CRCs keep the register right-aligned and shift right,
+                normal CRCs keep it left-aligned in 32 bits and shift left, so
+                any width up to 32 uses the same 32-bit tables.
+*/
+void crc_sw_table_init(crc_sw_table_struct *table, const crc_preset_struct *preset)
+{
+    uint32_t poly, c;
+    uint32_t i, k;
+
+    table->preset = preset;
+    if(preset->reflect)
+    {
+        poly = crc_sw_reflect(preset->poly, preset->width);
+        for(i = 0; i < 256; i++)
+        {
+            c = i;
+            for(k = 0; k < 8; k++)
+            {
+                c = (c & 1U) ? ((c >> 1) ^ poly) : (c >> 1);
+            }
+            table->table[0][i] = c;
+        }
+        for(k = 1; k < 8; k++)
+        {
+            for(i = 0; i < 256; i++)
+            {
+                c = table->table[k - 1][i];
+                table->table[k][i] = (c >> 8) ^ table->table[0][c & 0xFFU];
+            }
+        }
+    }
+    else
+    {
+        poly = preset->poly << (32U - preset->width);
+        for(i = 0; i < 256; i++)
+        {
+            c = i << 24;
+            for(k = 0; k < 8; k++)
+            {
+                c = (c & 0x80000000U) ? ((c << 1) ^ poly) : (c << 1);
+            }
+            table->table[0][i] = c;
+        }
+        for(k = 1; k < 8; k++)
+        {
+            for(i = 0; i < 256; i++)
+            {
+                c = table->table[k - 1][i];
+                table->table[k][i] = (c << 8) ^ table->table[0][c >> 24];
+            }
+        }
+    }
+}
+
+/*!
+    \brief      get the initial register value of a preset
+    \param[in]  table: tables built for the preset
+    \param[out] none
+    \retval     register value for crc_sw_update
+*/
+uint32_t crc_sw_start(const crc_sw_table_struct *table)
+{
+    const crc_preset_struct *preset = table->preset;
+
+    if(preset->reflect)
+    {
+        return crc_sw_reflect(preset->init, preset->width);
+    }
+    return preset->init << (32U - preset->width);
+}
+
+/*!
+    \brief      add data to a software CRC
+    \param[in]  table: tables built for the preset
+    \param[in]  reg: register value from crc_sw_start or a previous update
+    \param[in]  data: data bytes
+    \param[in]  length: data length in bytes
+    \param[out] none
+    \retval     new register value
+*/
+uint32_t crc_sw_update(const crc_sw_table_struct *table, uint32_t reg, const uint8_t *data, uint32_t length)
+{
+    const uint32_t (*t)[256] = table->table;
+    uint32_t one, two;
+
+    if(table->preset->reflect)
+    {
+        while(length >= 8)
+        {
+            one = reg ^ ((uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+            two = (uint32_t)data[4] | ((uint32_t)data[5] << 8) | ((uint32_t)data[6] << 16) | ((uint32_t)data[7] << 24);
+            reg = t[7][one & 0xFFU] ^ t[6][(one >> 8) & 0xFFU] ^ t[5][(one >> 16) & 0xFFU] ^ t[4][one >> 24] ^
+                  t[3][two & 0xFFU] ^ t[2][(two >> 8) & 0xFFU] ^ t[1][(two >> 16) & 0xFFU] ^ t[0][two >> 24];
+            data += 8;
+            length -= 8;
+        }
+        while(length--)
+        {
+            reg = (reg >> 8) ^ t[0][(reg ^ *data++) & 0xFFU];
+        }
+    }
+    else
+    {
+        while(length >= 8)
+        {
+            one = reg ^ (((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | (uint32_t)data[3]);
+            two = ((uint32_t)data[4] << 24) | ((uint32_t)data[5] << 16) | ((uint32_t)data[6] << 8) | (uint32_t)data[7];
+            reg = t[7][one >> 24] ^ t[6][(one >> 16) & 0xFFU] ^ t[5][(one >> 8) & 0xFFU] ^ t[4][one & 0xFFU] ^
+                  t[3][two >> 24] ^ t[2][(two >> 16) & 0xFFU] ^ t[1][(two >> 8) & 0xFFU] ^ t[0][two & 0xFFU];
+            data += 8;
+            length -= 8;
+        }
+        while(length--)
+        {
+            reg = (reg << 8) ^ t[0][(reg >> 24) ^ *data++];
+        }
+    }
+    return reg;
+}
+
+/*!
+    \brief      convert a register value to the final CRC
+    \param[in]  table: tables built for the preset
+    \param[in]  reg: register value after the last update
+    \param[out] none
+    \retval     CRC value, right-aligned
+*/
+uint32_t crc_sw_final(const crc_sw_table_struct *table, uint32_t reg)
+{
+    const crc_preset_struct *preset = table->preset;
+    uint32_t mask = (preset->width == 32U) ? 0xFFFFFFFFU : ((1UL << preset->width) - 1U);
+
+    if(preset->reflect == 0)
+    {
+        reg >>= (32U - preset->width);
+    }
+    return (reg ^ preset->xorout) & mask;
+}
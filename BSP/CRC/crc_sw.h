@@ -0,0 +1,53 @@
+/*!
+    \file       crc_sw.h
+    \brief      header file for portable slice-by-8 software CRC
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - CRC preset description (width, polynomial, init, reflection, final XOR)
+    - Named presets CRC32, CRC32C, CRC16-CCITT and CRC8
+    - Slice-by-8 table structure and incremental start/update/final declarations
+    - <stdint.h> only; the host selftest checks every preset against a
+      bit-at-a-time CRC
+*/
+
+#ifndef __CRC_SW_H
+#define __CRC_SW_H
+#include <stdint.h>
+
+/*!
+    \brief CRC algorithm description (Rocksoft model, refin == refout)
+*/
+typedef struct
+{
+    uint32_t poly;                                                          /*!< polynomial, normal form without the top bit */
+    uint32_t init;                                                          /*!< initial register value, normal form */
+    uint32_t xorout;                                                        /*!< value XORed into the final CRC */
+    uint32_t check;                                                         /*!< CRC of the ASCII string "123456789" */
+    uint8_t width;                                                          /*!< CRC width in bits, 7 to 32 */
+    uint8_t reflect;                                                        /*!< 1: input bytes and output are bit reflected */
+} crc_preset_struct;
+
+/*!
+    \brief slice-by-8 lookup tables for one preset
+*/
+typedef struct
+{
+    const crc_preset_struct *preset;                                        /*!< preset the tables were built for */
+    uint32_t table[8][256];                                                 /*!< table[k] advances a byte through k zero bytes */
+} crc_sw_table_struct;
+
+extern const crc_preset_struct g_crc_preset_crc32;                          /*!< CRC-32 (Ethernet, zlib) */
+extern const crc_preset_struct g_crc_preset_crc32c;                         /*!< CRC-32C (Castagnoli, iSCSI) */
+extern const crc_preset_struct g_crc_preset_crc16_ccitt;                    /*!< CRC-16/CCITT-FALSE */
+extern const crc_preset_struct g_crc_preset_crc8;                           /*!< CRC-8/SMBUS */
+
+/* function declarations */
+void crc_sw_table_init(crc_sw_table_struct *table, const crc_preset_struct *preset);               /*!< build slice-by-8 tables */
+uint32_t crc_sw_start(const crc_sw_table_struct *table);                                            /*!< initial register value */
+uint32_t crc_sw_update(const crc_sw_table_struct *table, uint32_t reg, const uint8_t *data, uint32_t length); /*!< add data */
+uint32_t crc_sw_final(const crc_sw_table_struct *table, uint32_t reg);                              /*!< register to CRC value */
+uint32_t crc_sw_reflect(uint32_t value, uint8_t width);                                             /*!< reverse the low width bits */
+#endif /* __CRC_SW_H */
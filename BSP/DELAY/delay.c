@@ -27,7 +27,9 @@
 #endif
 
 static uint16_t  fac_us=0;							/* microsecond delay multiplier */	   
+#if SYSTEM_SUPPORT_OS
 static uint16_t  fac_ms=0;							/* millisecond delay multiplier, represents ms per tick in RTOS */
+#endif
 
 /*!
     \brief      SysTick timer interrupt service routine
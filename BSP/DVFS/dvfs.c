@@ -0,0 +1,739 @@
+/*!
+    \file       dvfs.c
+    \brief      dynamic voltage and frequency scaling manager on RCU and PMU
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Runtime switching between operating points by PLL0 reconfiguration
+    - Core LDO voltage and TCM wait state sequencing around each switch
+    - Clock change notifiers for delay, USART baud dividers and timer prescalers,
+      which reject a frequency their peripheral cannot follow
+    - Transition latency measurement with the DWT cycle counter
+    - Idle-time meter and load-driven policy (jump up on load, step down when idle)
+    - Operating point restore after deep-sleep
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./DVFS/dvfs.h"
+#include "./SYSTEM/system.h"
+#include "./DELAY/delay.h"
+#include "./USART/usart.h"
+#include "./CLOCK/clock.h"
+#include "./TIMER/timer.h"
+
+#define DVFS_REG_PLL0PSC_OFFSET     0U                                      /* RCU_PLL0 PLL0PSC field */
+#define DVFS_REG_PLL0N_OFFSET       6U                                      /* RCU_PLL0 PLL0N field */
+#define DVFS_REG_PLL0P_OFFSET       16U                                     /* RCU_PLL0 PLL0P field */
+
+/* AHB = SYSCLK / 2 and APB1..4 stay as set by SystemInit, so every bus clock
+   scales with CK_SYS. Voltages follow the datasheet operating conditions and
+   may need adjusting for the power supply of a particular board. */
+const dvfs_opp_struct g_dvfs_opp_table[DVFS_OPP_NUM] =
+{
+    {600000000U, 5U, 120U, 1U, RCU_PLL0VCO_192M_836M, PMU_LDOVS_5, 1},      /* HXTAL / 5 * 120 / 1 */
+    {480000000U, 5U, 96U,  1U, RCU_PLL0VCO_192M_836M, PMU_LDOVS_3, 1},      /* HXTAL / 5 * 96 / 1 */
+    {200000000U, 5U, 40U,  1U, RCU_PLL0VCO_150M_420M, PMU_LDOVS_1, 0},      /* HXTAL / 5 * 40 / 1 */
+    {DVFS_HXTAL_VALUE, 0U, 0U, 0U, 0U,                PMU_LDOVS_0, 0}       /* HXTAL, PLL0 off */
+};
+
+static uint8_t s_dvfs_opp = DVFS_OPP_NUM;                                   /* current operating point, DVFS_OPP_NUM if unknown */
+static uint8_t s_dvfs_opp_limit = DVFS_OPP_600M;                            /* fastest operating point allowed */
+static dvfs_notifier_struct *s_dvfs_notifiers = NULL;                      /* notifier chain */
+static dvfs_stats_struct s_dvfs_stats;                                      /* transition statistics */
+
+static volatile uint32_t s_dvfs_idle_us = 0;                                /* idle time in the current window */
+static uint32_t s_dvfs_window_start = 0;                                    /* timer_monotonic_us at the start of the window */
+static uint8_t s_dvfs_down_windows = 0;                                     /* low-load windows in a row */
+
+/* driver notifiers registered by dvfs_init */
+static ErrStatus dvfs_delay_notify(uint8_t phase, uint32_t old_hz, uint32_t new_hz, void *arg);
+static ErrStatus dvfs_usart_notify(uint8_t phase, uint32_t old_hz, uint32_t new_hz, void *arg);
+static ErrStatus dvfs_timer_notify(uint8_t phase, uint32_t old_hz, uint32_t new_hz, void *arg);
+
+static dvfs_notifier_struct s_dvfs_delay_notifier = {dvfs_delay_notify, NULL, NULL};
+static dvfs_notifier_struct s_dvfs_usart_notifier = {dvfs_usart_notify, NULL, NULL};
+static dvfs_notifier_struct s_dvfs_timer_notifier = {dvfs_timer_notify, NULL, NULL};
+
+/* USARTs that follow the clock, with their kernel clock */
+static const uint32_t s_dvfs_usart_periph[] = {BSP_USART, USART1, UART4};
+static const clock_id_enum s_dvfs_usart_clock[] = {CLOCK_USART0, CLOCK_USART1, CLOCK_APB1};
+static const clock_id_enum s_dvfs_usart_bus[] = {CLOCK_APB2, CLOCK_APB1, CLOCK_APB1};
+static uint32_t s_dvfs_usart_old_hz[sizeof(s_dvfs_usart_periph) / sizeof(s_dvfs_usart_periph[0])];
+
+/* timers that follow the clock (timeouts, watchdog feeding, RTOS statistics) */
+static const uint32_t s_dvfs_timer_periph[] = {TIMER5, TIMER6, TIMER15, TIMER16, TIMER50};
+static uint32_t s_dvfs_timer_base_div[sizeof(s_dvfs_timer_periph) / sizeof(s_dvfs_timer_periph[0])];
+static uint32_t s_dvfs_timer_base_hz[sizeof(s_dvfs_timer_periph) / sizeof(s_dvfs_timer_periph[0])];
+static uint32_t s_dvfs_timer_set_div[sizeof(s_dvfs_timer_periph) / sizeof(s_dvfs_timer_periph[0])];
+
+/*!
+    \brief      re-derive delay multipliers and SysTick reload
+    \param[in]  phase: DVFS_PHASE_CHECK, DVFS_PHASE_PRE or DVFS_PHASE_POST
+    \param[in]  old_hz: CK_SYS before the change
+    \param[in]  new_hz: CK_SYS after the change
+    \param[in]  arg: unused
+    \param[out] none
+    \retval     SUCCESS, every frequency is accepted
+*/
+static ErrStatus dvfs_delay_notify(uint8_t phase, uint32_t old_hz, uint32_t new_hz, void *arg)
+{
+    (void)old_hz;
+    (void)new_hz;
+    (void)arg;
+
+    if(phase == DVFS_PHASE_POST)
+    {
+        delay_init();                                                       /* fac_us and SysTick from SystemCoreClock */
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      read the baud divider of a USART
+    \param[in]  periph: USARTx
+    \param[out] none
+    \retval     USARTDIV, in kernel clocks per bit times 16 / oversampling
+*/
+static uint32_t dvfs_usart_udiv_get(uint32_t periph)
+{
+    uint32_t udiv = USART_BAUD(periph);
+
+    if(USART_CTL0(periph) & USART_CTL0_OVSMOD)
+    {
+        /* oversampling by 8: BAUD[2:0] holds udiv[3:1] */
+        udiv = (udiv & 0x0000FFF0U) | ((udiv & 0x00000007U) << 1);
+    }
+    return udiv & 0x0000FFFFU;
+}
+
+/*!
+    \brief      rescale the baud dividers of enabled USARTs
+    \param[in]  phase: DVFS_PHASE_CHECK, DVFS_PHASE_PRE or DVFS_PHASE_POST
+    \param[in]  old_hz: CK_SYS before the change
+    \param[in]  new_hz: CK_SYS after the change
+    \param[in]  arg: unused
+    \param[out] none
+    \retval     ERROR in the check phase if a USART would lose its baud rate
+    \note       USART_BAUD can only be written with the USART disabled, so the
+                pre phase drains the transmitter and disables it, and the post
+                phase scales the divider by the kernel clock ratio and enables
+                it again. Kernel clocks not derived from CK_SYS keep their divider.
+                The check rejects a divider below the oversampling factor or
+                off by more than DVFS_USART_ERROR_PERMILLE.
+*/
+static ErrStatus dvfs_usart_notify(uint8_t phase, uint32_t old_hz, uint32_t new_hz, void *arg)
+{
+    uint32_t i, periph, udiv, clock, timeout;
+    uint64_t scaled, error;
+
+    (void)arg;
+
+    for(i = 0; i < sizeof(s_dvfs_usart_periph) / sizeof(s_dvfs_usart_periph[0]); i++)
+    {
+        periph = s_dvfs_usart_periph[i];
+        if(phase == DVFS_PHASE_CHECK)
+        {
+            clock = clock_freq_get(s_dvfs_usart_clock[i]);
+            if(((USART_CTL0(periph) & USART_CTL0_UEN) == 0U) ||
+               ((clock != clock_freq_get(s_dvfs_usart_bus[i])) && (clock != clock_freq_get(CLOCK_AHB))))
+            {
+                continue;                                                   /* off, or LXTAL/IRC64MDIV kernel clock */
+            }
+            udiv = dvfs_usart_udiv_get(periph);
+            scaled = ((uint64_t)udiv * new_hz + old_hz / 2U) / old_hz;
+            error = (scaled * old_hz > (uint64_t)udiv * new_hz) ? (scaled * old_hz - (uint64_t)udiv * new_hz) :
+                                                                  ((uint64_t)udiv * new_hz - scaled * old_hz);
+            if((scaled < ((USART_CTL0(periph) & USART_CTL0_OVSMOD) ? 8U : 16U)) || (scaled > 0xFFFFU) ||
+               (error * 1000U > scaled * old_hz * DVFS_USART_ERROR_PERMILLE))
+            {
+                return ERROR;
+            }
+        }
+        else if(phase == DVFS_PHASE_PRE)
+        {
+            s_dvfs_usart_old_hz[i] = 0;
+            if((USART_CTL0(periph) & USART_CTL0_UEN) == 0U)
+            {
+                continue;
+            }
+            timeout = 0;
+            while((RESET == usart_flag_get(periph, USART_FLAG_TC)) && (timeout++ < DVFS_USART_TIMEOUT))
+            {
+            }
+            s_dvfs_usart_old_hz[i] = clock_freq_get(s_dvfs_usart_clock[i]);
+            usart_disable(periph);
+        }
+        else if(s_dvfs_usart_old_hz[i] != 0U)
+        {
+            clock = clock_freq_get(s_dvfs_usart_clock[i]);
+            if(clock != s_dvfs_usart_old_hz[i])
+            {
+                udiv = dvfs_usart_udiv_get(periph);
+                udiv = (uint32_t)(((uint64_t)udiv * clock + s_dvfs_usart_old_hz[i] / 2U) / s_dvfs_usart_old_hz[i]);
+                if(USART_CTL0(periph) & USART_CTL0_OVSMOD)
+                {
+                    USART_BAUD(periph) = (udiv & 0x0000FFF0U) | ((udiv >> 1) & 0x00000007U);
+                }
+                else
+                {
+                    USART_BAUD(periph) = udiv & 0x0000FFFFU;
+                }
+            }
+            usart_enable(periph);
+        }
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      rescale the prescalers of running timers
+    \param[in]  phase: DVFS_PHASE_CHECK, DVFS_PHASE_PRE or DVFS_PHASE_POST
+    \param[in]  old_hz: CK_SYS before the change
+    \param[in]  new_hz: CK_SYS after the change
+    \param[in]  arg: unused
+    \param[out] none
+    \retval     ERROR in the check phase if the monotonic timer would lose its
+                exact TIMER_MONOTONIC_HZ; the other timers only round
+    \note       Each timer keeps the divider it was configured with and the clock
+                it was configured at, so repeated changes do not accumulate rounding.
+                A divider changed by its driver since the last change becomes the
+                new base. The new prescaler loads at the next update event.
+*/
+static ErrStatus dvfs_timer_notify(uint8_t phase, uint32_t old_hz, uint32_t new_hz, void *arg)
+{
+    uint32_t i, periph, div;
+
+    (void)arg;
+
+    if(phase == DVFS_PHASE_CHECK)
+    {
+        /* the APB1 timer clock scales with CK_SYS and must stay a whole multiple of TIMER_MONOTONIC_HZ */
+        if((TIMER_CTL0(TIMER_MONOTONIC) & TIMER_CTL0_CEN) &&
+           (((uint64_t)clock_freq_get(CLOCK_TIMER_APB1) * new_hz) % ((uint64_t)old_hz * TIMER_MONOTONIC_HZ) != 0U))
+        {
+            return ERROR;
+        }
+        return SUCCESS;
+    }
+
+    for(i = 0; i < sizeof(s_dvfs_timer_periph) / sizeof(s_dvfs_timer_periph[0]); i++)
+    {
+        periph = s_dvfs_timer_periph[i];
+        if(((TIMER_CTL0(periph) & TIMER_CTL0_CEN) == 0U) || ((phase == DVFS_PHASE_POST) && (s_dvfs_timer_base_hz[i] == 0U)))
+        {
+            continue;
+        }
+        div = (TIMER_PSC(periph) & TIMER_PSC_PSC) + 1U;
+        if(phase == DVFS_PHASE_PRE)
+        {
+            if(div != s_dvfs_timer_set_div[i])
+            {
+                s_dvfs_timer_base_div[i] = div;
+                s_dvfs_timer_base_hz[i] = old_hz;
+            }
+        }
+        else
+        {
+            div = (uint32_t)(((uint64_t)s_dvfs_timer_base_div[i] * new_hz + s_dvfs_timer_base_hz[i] / 2U) / s_dvfs_timer_base_hz[i]);
+            if(div == 0U)
+            {
+                div = 1U;
+            }
+            else if(div > 0x10000U)
+            {
+                div = 0x10000U;
+            }
+            timer_prescaler_config(periph, (uint16_t)(div - 1U), TIMER_PSC_RELOAD_UPDATE);
+            s_dvfs_timer_set_div[i] = div;
+        }
+    }
+    if(phase == DVFS_PHASE_POST)
+    {
+        timer_monotonic_clock_update();
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      call every notifier in the chain
+    \param[in]  phase: DVFS_PHASE_CHECK, DVFS_PHASE_PRE or DVFS_PHASE_POST
+    \param[in]  old_hz: CK_SYS before the change
+    \param[in]  new_hz: CK_SYS after the change
+    \param[out] none
+    \retval     ERROR if a notifier rejected the change in the check phase
+*/
+static ErrStatus dvfs_notify(uint8_t phase, uint32_t old_hz, uint32_t new_hz)
+{
+    dvfs_notifier_struct *notifier;
+    ErrStatus status = SUCCESS;
+
+    for(notifier = s_dvfs_notifiers; notifier != NULL; notifier = notifier->next)
+    {
+        if((notifier->callback(phase, old_hz, new_hz, notifier->arg) != SUCCESS) && (phase == DVFS_PHASE_CHECK))
+        {
+            status = ERROR;
+        }
+    }
+    return status;
+}
+
+/*!
+    \brief      set the core LDO voltage and wait until it is ready
+    \param[in]  ldo: PMU_LDOVS_x
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR on timeout
+*/
+static ErrStatus dvfs_voltage_set(uint32_t ldo)
+{
+    uint32_t timeout = 0;
+
+    if((PMU_CTL3 & PMU_CTL3_LDOVS) == ldo)
+    {
+        return SUCCESS;
+    }
+    pmu_ldo_output_select(ldo);
+    while(0U == (PMU_CTL3 & PMU_CTL3_VOVRF))
+    {
+        if(++timeout >= DVFS_LDO_TIMEOUT)
+        {
+            return ERROR;
+        }
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      convert cycles at a clock to microseconds
+    \param[in]  cycles: CPU cycles
+    \param[in]  hz: CPU clock the cycles were counted at
+    \param[out] none
+    \retval     microseconds
+*/
+static uint32_t dvfs_cycles_to_us(uint32_t cycles, uint32_t hz)
+{
+    return (uint32_t)(((uint64_t)cycles * 1000000U) / hz);
+}
+
+/*!
+    \brief      move CK_SYS to an operating point through HXTAL
+    \param[in]  target: operating point
+    \param[out] none
+    \retval     DWT_CYCCNT when CK_SYS reached HXTAL
+    \note       Call with interrupts disabled and the voltage and wait state
+                already suitable for both the current and the target clock.
+*/
+static uint32_t dvfs_clock_switch(const dvfs_opp_struct *target)
+{
+    uint32_t t;
+
+    /* run from HXTAL while PLL0 is reprogrammed */
+    RCU_CTL |= RCU_CTL_HXTALEN;
+    while(0U == (RCU_CTL & RCU_CTL_HXTALSTB))
+    {
+    }
+    RCU_CFG0 = (RCU_CFG0 & ~RCU_CFG0_SCS) | RCU_CKSYSSRC_HXTAL;
+    while(RCU_SCSS_HXTAL != (RCU_CFG0 & RCU_CFG0_SCSS))
+    {
+    }
+    t = DWT_CYCCNT;
+
+    RCU_CTL &= ~RCU_CTL_PLL0EN;
+    while(0U != (RCU_CTL & RCU_CTL_PLL0STB))
+    {
+    }
+
+    if(target->pll0psc != 0U)
+    {
+        RCU_PLLALL &= ~(RCU_PLLALL_PLLSEL | RCU_PLLALL_PLL0VCOSEL | RCU_PLLALL_PLL0RNG);
+        RCU_PLLALL |= (RCU_PLLSRC_HXTAL | target->vco | RCU_PLL0RNG_4M_8M);
+        RCU_PLL0 &= ~(RCU_PLL0_PLL0N | RCU_PLL0_PLL0PSC | RCU_PLL0_PLL0P);
+        RCU_PLL0 |= (((target->pll0n - 1U) << DVFS_REG_PLL0N_OFFSET) | (target->pll0psc << DVFS_REG_PLL0PSC_OFFSET) | \
+                     ((target->pll0p - 1U) << DVFS_REG_PLL0P_OFFSET));
+        RCU_CTL |= RCU_CTL_PLL0EN;
+        while(0U == (RCU_CTL & RCU_CTL_PLL0STB))
+        {
+        }
+        RCU_CFG0 = (RCU_CFG0 & ~RCU_CFG0_SCS) | RCU_CKSYSSRC_PLL0P;
+        while(RCU_SCSS_PLL0P != (RCU_CFG0 & RCU_CFG0_SCSS))
+        {
+        }
+    }
+    return t;
+}
+
+/*!
+    \brief      take over the boot clock and register the driver notifiers
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Call after SystemCoreClockUpdate, system_dwt_init, delay_init and
+                the USART and timer initialization, timer_monotonic_config included.
+*/
+void dvfs_init(void)
+{
+    uint8_t i;
+
+    rcu_periph_clock_enable(RCU_PMU);
+    rcu_periph_clock_enable(RCU_SYSCFG);
+
+    s_dvfs_opp = DVFS_OPP_NUM;
+    for(i = 0; i < DVFS_OPP_NUM; i++)
+    {
+        if(g_dvfs_opp_table[i].frequency == SystemCoreClock)
+        {
+            s_dvfs_opp = i;
+            break;
+        }
+    }
+
+    s_dvfs_opp_limit = DVFS_OPP_600M;
+    s_dvfs_notifiers = NULL;
+    dvfs_notifier_register(&s_dvfs_timer_notifier);
+    dvfs_notifier_register(&s_dvfs_usart_notifier);
+    dvfs_notifier_register(&s_dvfs_delay_notifier);
+
+    s_dvfs_stats.transitions = 0;
+    s_dvfs_stats.last_latency_us = 0;
+    s_dvfs_stats.max_latency_us = 0;
+    s_dvfs_stats.last_switch_us = 0;
+    s_dvfs_stats.rejected = 0;
+    s_dvfs_stats.load = 100;
+    s_dvfs_idle_us = 0;
+    s_dvfs_down_windows = 0;
+    s_dvfs_window_start = timer_monotonic_us();
+}
+
+/*!
+    \brief      change the operating point
+    \param[in]  opp: operating point (dvfs_opp_enum)
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note       Sequence: notifiers (check), notifiers (pre), raise voltage and TCM wait state when
+                speeding up, CK_SYS to HXTAL, reprogram and relock PLL0, CK_SYS to
+                PLL0P, lower wait state and voltage when slowing down, notifiers
+                (post). Interrupts are disabled only from the first clock switch to
+                the last. PLL0Q and PLL0R follow the new VCO and stop at
+                DVFS_OPP_HXTAL, so peripherals clocked from them must be idle.
+                A point faster than the limit set by dvfs_opp_limit_set is
+                replaced by the limit. A point a notifier cannot follow is
+                rejected in the check phase before any clock changes.
+*/
+ErrStatus dvfs_opp_set(uint8_t opp)
+{
+    const dvfs_opp_struct *target;
+    uint32_t old_hz, new_hz, primask;
+    uint32_t t0, t1, t2, t3, t4;
+    uint8_t faster;
+    ErrStatus status = SUCCESS;
+
+    if(opp >= DVFS_OPP_NUM)
+    {
+        return ERROR;
+    }
+    if(opp < s_dvfs_opp_limit)
+    {
+        opp = s_dvfs_opp_limit;
+    }
+    if(opp == s_dvfs_opp)
+    {
+        return SUCCESS;
+    }
+
+    target = &g_dvfs_opp_table[opp];
+    old_hz = SystemCoreClock;
+    new_hz = target->frequency;
+    faster = (new_hz > old_hz) ? 1 : 0;
+    if(dvfs_notify(DVFS_PHASE_CHECK, old_hz, new_hz) != SUCCESS)
+    {
+        s_dvfs_stats.rejected++;
+        return ERROR;
+    }
+
+    t0 = DWT_CYCCNT;
+    dvfs_notify(DVFS_PHASE_PRE, old_hz, new_hz);
+
+    if(faster)
+    {
+        if(dvfs_voltage_set(target->ldo) != SUCCESS)
+        {
+            dvfs_notify(DVFS_PHASE_POST, old_hz, old_hz);
+            return ERROR;
+        }
+        if(target->tcm_waitstate)
+        {
+            SYSCFG_SRAMCFG1 |= SYSCFG_SRAMCFG1_TCM_WAITSTATE;
+        }
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    t1 = DWT_CYCCNT;
+    t2 = dvfs_clock_switch(target);
+    t3 = DWT_CYCCNT;
+
+    SystemCoreClock = new_hz;
+    s_dvfs_opp = opp;
+    clock_tree_invalidate();
+    __set_PRIMASK(primask);
+
+    if(!faster)
+    {
+        if(!target->tcm_waitstate)
+        {
+            SYSCFG_SRAMCFG1 &= ~SYSCFG_SRAMCFG1_TCM_WAITSTATE;
+        }
+        status = dvfs_voltage_set(target->ldo);
+    }
+
+    dvfs_notify(DVFS_PHASE_POST, old_hz, new_hz);
+    t4 = DWT_CYCCNT;
+
+    /* the cycle counter runs at old_hz, then DVFS_HXTAL_VALUE, then new_hz */
+    s_dvfs_stats.last_switch_us = dvfs_cycles_to_us(t2 - t1, old_hz) + dvfs_cycles_to_us(t3 - t2, DVFS_HXTAL_VALUE);
+    s_dvfs_stats.last_latency_us = dvfs_cycles_to_us(t1 - t0, old_hz) + s_dvfs_stats.last_switch_us + \
+                                   dvfs_cycles_to_us(t4 - t3, new_hz);
+    if(s_dvfs_stats.last_latency_us > s_dvfs_stats.max_latency_us)
+    {
+        s_dvfs_stats.max_latency_us = s_dvfs_stats.last_latency_us;
+    }
+    s_dvfs_stats.transitions++;
+    return status;
+}
+
+/*!
+    \brief      restore the current operating point after deep-sleep
+    \param[in]  none
+    \param[out] latency_us: time spent restoring the clock, may be NULL
+    \retval     ErrStatus: SUCCESS, or ERROR if the operating point is unknown
+    \note       The core wakes from deep-sleep on CK_IRC64MDIV with HXTAL and the
+                PLLs stopped, while the bus prescalers, voltage and wait state are
+                kept. Reprogramming the same operating point brings every derived
+                clock back unchanged, so no notifier is called. PLL1 and PLL2 are
+                left to the caller.
+*/
+ErrStatus dvfs_resume(uint32_t *latency_us)
+{
+    const dvfs_opp_struct *target;
+    uint32_t wake_hz, primask, t0, t1, t2;
+
+    if(s_dvfs_opp >= DVFS_OPP_NUM)
+    {
+        return ERROR;
+    }
+    target = &g_dvfs_opp_table[s_dvfs_opp];
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    clock_tree_invalidate();
+    wake_hz = clock_freq_get(CLOCK_SYS);
+    t0 = DWT_CYCCNT;
+    t1 = dvfs_clock_switch(target);
+    t2 = DWT_CYCCNT;
+    clock_tree_invalidate();
+    __set_PRIMASK(primask);
+
+    if(latency_us != NULL)
+    {
+        *latency_us = dvfs_cycles_to_us(t1 - t0, wake_hz) + dvfs_cycles_to_us(t2 - t1, DVFS_HXTAL_VALUE);
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      get the current operating point
+    \param[in]  none
+    \param[out] none
+    \retval     operating point (dvfs_opp_enum), DVFS_OPP_NUM if the boot clock is not in the table
+*/
+uint8_t dvfs_opp_get(void)
+{
+    return s_dvfs_opp;
+}
+
+/*!
+    \brief      limit the fastest operating point
+    \param[in]  opp: fastest operating point allowed (dvfs_opp_enum)
+    \param[out] none
+    \retval     ErrStatus: SUCCESS, or ERROR if the switch down to the limit failed
+    \note       Used by the thermal governor. A faster current point is left at
+                once; the policy and dvfs_opp_set stay at or below the limit.
+*/
+ErrStatus dvfs_opp_limit_set(uint8_t opp)
+{
+    if(opp >= DVFS_OPP_NUM)
+    {
+        return ERROR;
+    }
+    s_dvfs_opp_limit = opp;
+    if(s_dvfs_opp < opp)
+    {
+        return dvfs_opp_set(opp);
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      get the operating point limit
+    \param[in]  none
+    \param[out] none
+    \retval     fastest operating point allowed (dvfs_opp_enum)
+*/
+uint8_t dvfs_opp_limit_get(void)
+{
+    return s_dvfs_opp_limit;
+}
+
+/*!
+    \brief      add a clock change notifier
+    \param[in]  notifier: notifier with callback set, must stay valid until unregistered
+    \param[out] none
+    \retval     none
+*/
+void dvfs_notifier_register(dvfs_notifier_struct *notifier)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    notifier->next = s_dvfs_notifiers;
+    s_dvfs_notifiers = notifier;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      remove a clock change notifier
+    \param[in]  notifier: registered notifier
+    \param[out] none
+    \retval     none
+*/
+void dvfs_notifier_unregister(dvfs_notifier_struct *notifier)
+{
+    dvfs_notifier_struct **link;
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for(link = &s_dvfs_notifiers; *link != NULL; link = &(*link)->next)
+    {
+        if(*link == notifier)
+        {
+            *link = notifier->next;
+            notifier->next = NULL;
+            break;
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      sleep until an interrupt and count the time as idle
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Call from the main loop or the RTOS idle hook instead of a bare
+                __WFI. Interrupts are masked around WFI so the handler that wakes
+                the core runs after the idle time has been added. The idle time
+                comes from the monotonic timer, as the DWT cycle counter stops
+                with the core clock.
+*/
+void dvfs_idle(void)
+{
+    uint32_t primask, start;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    start = timer_monotonic_us();
+    __DSB();
+    __WFI();
+    s_dvfs_idle_us += timer_monotonic_us() - start;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      count idle time spent outside dvfs_idle
+    \param[in]  idle_us: idle time in microseconds
+    \param[out] none
+    \retval     none
+*/
+void dvfs_idle_account(uint32_t idle_us)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    s_dvfs_idle_us += idle_us;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      close the current load window and apply the policy
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Load above DVFS_LOAD_UP jumps to the fastest allowed point, load below
+                DVFS_LOAD_DOWN for DVFS_DOWN_WINDOWS windows steps one point
+                slower, down to DVFS_OPP_SLOWEST. Call periodically, e.g. every 100 ms; windows are measured
+                on the monotonic timer and are not affected by clock changes.
+*/
+void dvfs_policy_update(void)
+{
+    uint32_t now, elapsed, idle, primask;
+    uint8_t load;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    now = timer_monotonic_us();
+    elapsed = now - s_dvfs_window_start;
+    idle = s_dvfs_idle_us;
+    s_dvfs_idle_us = 0;
+    s_dvfs_window_start = now;
+    __set_PRIMASK(primask);
+
+    if(elapsed == 0U)
+    {
+        return;
+    }
+    if(idle > elapsed)
+    {
+        idle = elapsed;
+    }
+    load = (uint8_t)(100U - (uint32_t)(((uint64_t)idle * 100U) / elapsed));
+    s_dvfs_stats.load = load;
+
+    if(load > DVFS_LOAD_UP)
+    {
+        s_dvfs_down_windows = 0;
+        if(s_dvfs_opp != s_dvfs_opp_limit)
+        {
+            dvfs_opp_set(s_dvfs_opp_limit);
+        }
+    }
+    else if(load < DVFS_LOAD_DOWN)
+    {
+        if(++s_dvfs_down_windows >= DVFS_DOWN_WINDOWS)
+        {
+            s_dvfs_down_windows = 0;
+            if(s_dvfs_opp < DVFS_OPP_SLOWEST)
+            {
+                dvfs_opp_set(s_dvfs_opp + 1);
+            }
+        }
+    }
+    else
+    {
+        s_dvfs_down_windows = 0;
+    }
+}
+
+/*!
+    \brief      copy DVFS statistics
+    \param[in]  none
+    \param[out] stats: statistics
+    \retval     none
+*/
+void dvfs_stats_get(dvfs_stats_struct *stats)
+{
+    *stats = s_dvfs_stats;
+}
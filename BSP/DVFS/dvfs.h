@@ -0,0 +1,114 @@
+/*!
+    \file       dvfs.h
+    \brief      header file for dynamic voltage and frequency scaling manager
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Operating point table (PLL0 settings, core LDO voltage, TCM wait state)
+    - Clock change notifier chain for drivers that derive settings from clocks
+    - Transition latency and idle-time statistics
+    - Load-driven policy thresholds and function declarations
+*/
+
+#ifndef __DVFS_H
+#define __DVFS_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief DVFS operating points, ordered from fastest to slowest
+*/
+typedef enum
+{
+    DVFS_OPP_600M = 0,                                                      /*!< PLL0P 600 MHz from HXTAL */
+    DVFS_OPP_480M,                                                          /*!< PLL0P 480 MHz from HXTAL */
+    DVFS_OPP_200M,                                                          /*!< PLL0P 200 MHz from HXTAL */
+    DVFS_OPP_HXTAL,                                                         /*!< HXTAL direct, PLL0 off */
+    DVFS_OPP_NUM
+} dvfs_opp_enum;
+
+/*!
+    \brief slowest point of the load policy and the thermal governor: at
+           DVFS_OPP_HXTAL the APB clocks leave no exact 1 MHz monotonic timer
+           and no USART divider for 921600 baud
+*/
+#define DVFS_OPP_SLOWEST            DVFS_OPP_200M
+
+/*!
+    \brief DVFS policy configuration macros
+*/
+#define DVFS_HXTAL_VALUE            25000000U                               /*!< HXTAL frequency on this board */
+#define DVFS_LOAD_UP                80U                                     /*!< load percent above which the fastest point is used */
+#define DVFS_LOAD_DOWN              30U                                     /*!< load percent below which one point slower is used */
+#define DVFS_DOWN_WINDOWS           4U                                      /*!< low-load windows in a row before stepping down */
+#define DVFS_LDO_TIMEOUT            100000U                                 /*!< polls of the core voltage ready flag */
+#define DVFS_USART_TIMEOUT          1000000U                                /*!< polls of USART TC before the clock change */
+#define DVFS_USART_ERROR_PERMILLE   20U                                     /*!< baud error a rescaled USART divider may add */
+
+/*!
+    \brief notifier phase
+*/
+#define DVFS_PHASE_PRE              0U                                      /*!< clocks still at the old frequency */
+#define DVFS_PHASE_POST             1U                                      /*!< clocks at the new frequency */
+#define DVFS_PHASE_CHECK            2U                                      /*!< before PRE: ERROR rejects the new frequency */
+
+/*!
+    \brief operating point description
+*/
+typedef struct
+{
+    uint32_t frequency;                                                     /*!< CK_SYS in Hz */
+    uint32_t pll0psc;                                                       /*!< PLL0 input divider, 0 when PLL0 is off */
+    uint32_t pll0n;                                                         /*!< PLL0 multiplier */
+    uint32_t pll0p;                                                         /*!< PLL0P output divider */
+    uint32_t vco;                                                           /*!< RCU_PLL0VCO_192M_836M or RCU_PLL0VCO_150M_420M */
+    uint32_t ldo;                                                           /*!< PMU_LDOVS_x core voltage */
+    uint8_t tcm_waitstate;                                                  /*!< 1: TCM needs a wait state */
+} dvfs_opp_struct;
+
+struct dvfs_notifier;
+
+/*! clock change callback, called with interrupts enabled; the result counts in DVFS_PHASE_CHECK only */
+typedef ErrStatus (*dvfs_notifier_fn)(uint8_t phase, uint32_t old_hz, uint32_t new_hz, void *arg);
+
+/*!
+    \brief clock change notifier, linked into the notifier chain
+*/
+typedef struct dvfs_notifier
+{
+    dvfs_notifier_fn callback;                                              /*!< function called before and after a change */
+    void *arg;                                                              /*!< user argument passed to callback */
+    struct dvfs_notifier *next;                                             /*!< next notifier, managed by DVFS */
+} dvfs_notifier_struct;
+
+/*!
+    \brief DVFS statistics
+*/
+typedef struct
+{
+    uint32_t transitions;                                                   /*!< completed operating point changes */
+    uint32_t last_latency_us;                                               /*!< last change, notifiers included */
+    uint32_t max_latency_us;                                                /*!< longest change since dvfs_init */
+    uint32_t last_switch_us;                                                /*!< last change, clock switch only */
+    uint32_t rejected;                                                      /*!< changes refused in the notifier check phase */
+    uint8_t load;                                                           /*!< load percent of the last policy window */
+} dvfs_stats_struct;
+
+extern const dvfs_opp_struct g_dvfs_opp_table[DVFS_OPP_NUM];               /*!< operating point table */
+
+/* function declarations */
+void dvfs_init(void);                                                                   /*!< take over the boot clock and register driver notifiers */
+ErrStatus dvfs_opp_set(uint8_t opp);                                                    /*!< change operating point */
+uint8_t dvfs_opp_get(void);                                                             /*!< current operating point */
+ErrStatus dvfs_opp_limit_set(uint8_t opp);                                              /*!< limit the fastest operating point */
+uint8_t dvfs_opp_limit_get(void);                                                       /*!< fastest operating point allowed */
+void dvfs_notifier_register(dvfs_notifier_struct *notifier);                            /*!< add a clock change notifier */
+void dvfs_notifier_unregister(dvfs_notifier_struct *notifier);                          /*!< remove a clock change notifier */
+ErrStatus dvfs_resume(uint32_t *latency_us);                                            /*!< restore the operating point after deep-sleep */
+void dvfs_idle(void);                                                                   /*!< sleep until an interrupt, counting idle time */
+void dvfs_idle_account(uint32_t idle_us);                                               /*!< count idle time spent elsewhere */
+void dvfs_policy_update(void);                                                          /*!< close a load window and apply the policy */
+void dvfs_stats_get(dvfs_stats_struct *stats);                                          /*!< copy statistics */
+#endif /* __DVFS_H */
@@ -0,0 +1,528 @@
+/*!
+    \file       ecc.c
+    \brief      RAM ECC monitoring and scrubbing service
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Enabling every RAMECCMU monitor (AXI SRAM, ITCM, DTCM, SRAM0/1) with
+      error latching and interrupts
+    - Logging corrected single-bit errors per monitor and in a table of the
+      most frequent failing addresses, so a weak cell shows up as a hot entry
+    - A paced background scrubber that reads the initialised RAM chunk by
+      chunk and writes the failing word back when the read needed a
+      correction, before a second flip in the same word makes it
+      uncorrectable; DMA receive buffers live in RW_DMA and are skipped
+    - Escalation of uncorrectable errors to a hook or a reset, reported on
+      the next boot
+    - Measurement of the scrubber's CPU cost and interrupt masking time
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./ECC/ecc.h"
+#include "./FAULT/fault.h"
+#include "./SYSTEM/system.h"
+#include "./TIMER/timer.h"
+#include "./USART/usart.h"
+
+#define ECC_FLAG_UNCORRECTABLE      (RAMECCMU_FLAG_ECC_DOUBLE_ERROR | RAMECCMU_FLAG_ECC_DOUBLE_ERROR_BYTE_WRITE)
+#define ECC_FLAG_ALL                (RAMECCMU_FLAG_ECC_SINGLE_ERROR | ECC_FLAG_UNCORRECTABLE)
+#define ECC_CACHED_START            0x24000000U                             /* AXI SRAM and above go through the D-cache, TCMs do not */
+
+/* RW regions of the image, zeroed or loaded by the scatter loader before main */
+extern uint32_t Image$$RW_IRAM1$$Base[];
+extern uint32_t Image$$RW_IRAM1$$ZI$$Limit[];
+extern uint32_t Image$$RW_IRAM2$$Base[];
+extern uint32_t Image$$RW_IRAM2$$ZI$$Limit[];
+
+/*!
+    \brief scrub range
+*/
+typedef struct
+{
+    uint32_t start;                                                         /* first word */
+    uint32_t size;                                                          /* bytes, multiple of 4 */
+} ecc_region_struct;
+
+/*!
+    \brief RAM behind a monitor
+*/
+typedef struct
+{
+    uint32_t start;                                                         /* first byte, 0 with end 0 for RAM that is never scrubbed */
+    uint32_t end;                                                           /* byte after the last */
+    uint8_t shift;                                                          /* log2 of the bytes between two ECC words of the monitor */
+    uint8_t width;                                                          /* bytes per ECC word */
+    uint8_t lane;                                                           /* offset of the monitor's words in interleaved banks */
+} ecc_ram_struct;
+
+/*!
+    \brief record of an uncorrectable error, kept over the reset it caused
+*/
+typedef struct
+{
+    uint32_t magic;                                                         /* ECC_RESET_MAGIC when valid */
+    uint32_t monitor;                                                       /* monitor index */
+    uint32_t address;                                                       /* failing address */
+    uint32_t check;                                                         /* ~address, detects power-on garbage */
+} ecc_reset_struct;
+
+static const rameccmu_monitor_enum s_ecc_monitor[ECC_MONITORS] =
+{
+    RAMECCMU0_MONITOR0, RAMECCMU0_MONITOR1, RAMECCMU0_MONITOR2, RAMECCMU0_MONITOR3,
+    RAMECCMU0_MONITOR4, RAMECCMU1_MONITOR0, RAMECCMU1_MONITOR1, RAMECCMU1_MONITOR2
+};
+
+/* the monitors report the failing ECC word as its index from the start of their RAM */
+static const ecc_ram_struct s_ecc_ram[ECC_MONITORS] =
+{
+    {0x24000000U, 0x240D0000U, 3U, 8U, 0U},                                 /* RAMECCMU0 monitor 0: AXI SRAM */
+    {0x00000000U, 0x00010000U, 3U, 8U, 0U},                                 /* RAMECCMU0 monitor 1: ITCM */
+    {0x20000000U, 0x20020000U, 3U, 4U, 0U},                                 /* RAMECCMU0 monitor 2: DTCM0, even words */
+    {0x20000000U, 0x20020000U, 3U, 4U, 4U},                                 /* RAMECCMU0 monitor 3: DTCM1, odd words */
+    {0x00000000U, 0x00000000U, 0U, 0U, 0U},                                 /* RAMECCMU0 monitor 4: ETM RAM */
+    {0x30000000U, 0x30004000U, 2U, 4U, 0U},                                 /* RAMECCMU1 monitor 0: SRAM0 */
+    {0x30004000U, 0x30008000U, 2U, 4U, 0U},                                 /* RAMECCMU1 monitor 1: SRAM1 */
+    {0x00000000U, 0x00000000U, 0U, 0U, 0U}                                  /* RAMECCMU1 monitor 2: backup SRAM */
+};
+
+static ecc_hot_struct s_ecc_hot[ECC_HOT_ENTRIES];                          /* failing addresses, filled by the interrupt */
+static uint8_t s_ecc_hot_count = 0;                                        /* valid hot entries */
+static ecc_stats_struct s_ecc_stats;                                       /* counters */
+static ecc_uncorrectable_fn s_ecc_callback = NULL;                         /* uncorrectable error hook */
+static void *s_ecc_callback_arg = NULL;                                    /* hook argument */
+FAULT_NOINIT static ecc_reset_struct s_ecc_reset;                          /* uncorrectable error that reset the last boot */
+
+static ecc_region_struct s_ecc_region[ECC_SCRUB_REGIONS];                 /* scrub ranges */
+static uint8_t s_ecc_region_count = 0;                                     /* valid scrub ranges */
+static uint8_t s_ecc_region_index = 0;                                     /* range being scrubbed */
+static uint32_t s_ecc_offset = 0;                                          /* next byte in the range */
+static uint32_t s_ecc_chunk = ECC_SCRUB_CHUNK;                             /* bytes per step, 0 stops the scrubber */
+static uint32_t s_ecc_period_us = ECC_SCRUB_PERIOD_US;                     /* minimum time between steps */
+static uint32_t s_ecc_last_us = 0;                                         /* time of the last step */
+static uint32_t s_ecc_pass_start_us = 0;                                   /* time the running pass started */
+static uint32_t s_ecc_pass_cycles = 0;                                     /* cycles spent in the running pass */
+
+/*!
+    \brief      count a correction at a failing address
+    \param[in]  monitor: monitor index
+    \param[in]  address: failing address
+    \param[out] none
+    \retval     none
+    \note       Called from the interrupt only. A full table replaces its least
+                frequent entry, so cells that keep failing stay listed.
+*/
+static void ecc_hot_log(uint8_t monitor, uint32_t address)
+{
+    uint8_t i, victim = 0;
+
+    for(i = 0; i < s_ecc_hot_count; i++)
+    {
+        if((s_ecc_hot[i].monitor == monitor) && (s_ecc_hot[i].address == address))
+        {
+            s_ecc_hot[i].count++;
+            return;
+        }
+        if(s_ecc_hot[i].count < s_ecc_hot[victim].count)
+        {
+            victim = i;
+        }
+    }
+    if(s_ecc_hot_count < ECC_HOT_ENTRIES)
+    {
+        victim = s_ecc_hot_count++;
+    }
+    else
+    {
+        s_ecc_stats.hot_evictions++;
+    }
+    s_ecc_hot[victim].monitor = monitor;
+    s_ecc_hot[victim].address = address;
+    s_ecc_hot[victim].count = 1;
+}
+
+/*!
+    \brief      handle an uncorrectable error
+    \param[in]  monitor: monitor index
+    \param[in]  address: failing address
+    \param[out] none
+    \retval     none
+    \note       The data at the address is lost. Unless the hook takes over,
+                the error is recorded in RW_NOINIT and the system resets.
+*/
+static void ecc_escalate(uint8_t monitor, uint32_t address)
+{
+    if((s_ecc_callback != NULL) && s_ecc_callback(monitor, address, s_ecc_callback_arg))
+    {
+        return;
+    }
+    s_ecc_reset.monitor = monitor;
+    s_ecc_reset.address = address;
+    s_ecc_reset.check = ~address;
+    s_ecc_reset.magic = ECC_RESET_MAGIC;
+    __DSB();
+    NVIC_SystemReset();
+}
+
+/*!
+    \brief      add a scrub range, trimmed to whole words
+    \param[in]  start: first byte
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if the table is full or the range empty
+*/
+static ErrStatus ecc_region_append(uint32_t start, uint32_t size)
+{
+    uint32_t end = start + size;
+
+    start = (start + 3U) & ~3U;
+    end &= ~3U;
+    if((end <= start) || (s_ecc_region_count >= ECC_SCRUB_REGIONS))
+    {
+        return ERROR;
+    }
+    s_ecc_region[s_ecc_region_count].start = start;
+    s_ecc_region[s_ecc_region_count].size = end - start;
+    s_ecc_region_count++;
+    return SUCCESS;
+}
+
+/*!
+    \brief      enable all monitors, report a previous uncorrectable error, start the scrubber
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Call after usart_init and timer_monotonic_config. The scrubber
+                covers RW_IRAM1 and RW_IRAM2 only: RAM nobody has written
+                holds no valid ECC code and would read as uncorrectable, so
+                other ranges are added with ecc_scrub_region_add once they are
+                initialised. Buffers a DMA writes to are declared with
+                ECC_DMA_BUFFER and land in RW_DMA instead.
+*/
+void ecc_init(void)
+{
+    uint8_t i;
+
+    if((s_ecc_reset.magic == ECC_RESET_MAGIC) && (s_ecc_reset.check == ~s_ecc_reset.address) && \
+       (s_ecc_reset.monitor < ECC_MONITORS))
+    {
+        PRINT_ERROR("previous boot reset on uncorrectable ECC error, monitor %u address 0x%08X\r\n",
+                    (unsigned)s_ecc_reset.monitor, (unsigned)s_ecc_reset.address);
+    }
+    s_ecc_reset.magic = 0;
+
+    rcu_periph_clock_enable(RCU_RAMECCMU0);
+    rcu_periph_clock_enable(RCU_RAMECCMU1);
+    for(i = 0; i < ECC_MONITORS; i++)
+    {
+        rameccmu_monitor_flag_clear(s_ecc_monitor[i], ECC_FLAG_ALL);
+        rameccmu_monitor_interrupt_enable(s_ecc_monitor[i], RAMECCMU_INT_ECC_SINGLE_ERROR | RAMECCMU_INT_ECC_DOUBLE_ERROR | \
+                                          RAMECCMU_INT_ECC_DOUBLE_ERROR_BYTE_WRITE | RAMECCMU_INT_ECC_ERROR_LATCHING);
+    }
+    rameccmu_global_interrupt_enable(RAMECCMU0, RAMECCMU_INT_ECC_GLOBAL_ERROR);
+    rameccmu_global_interrupt_enable(RAMECCMU1, RAMECCMU_INT_ECC_GLOBAL_ERROR);
+#if ECC_LOCKUP_ENABLE
+    rcu_periph_clock_enable(RCU_SYSCFG);
+    syscfg_lockup_enable(SYSCFG_AXIRAM_LOCKUP | SYSCFG_ITCM_LOCKUP | SYSCFG_DTCM_LOCKUP | SYSCFG_SRAM0_LOCKUP | SYSCFG_SRAM1_LOCKUP);
+#endif
+    nvic_irq_enable(RAMECCMU_IRQn, ECC_IRQ_PRIORITY, 0);
+
+    s_ecc_region_count = 0;
+    ecc_region_append((uint32_t)Image$$RW_IRAM1$$Base, (uint32_t)Image$$RW_IRAM1$$ZI$$Limit - (uint32_t)Image$$RW_IRAM1$$Base);
+    ecc_region_append((uint32_t)Image$$RW_IRAM2$$Base, (uint32_t)Image$$RW_IRAM2$$ZI$$Limit - (uint32_t)Image$$RW_IRAM2$$Base);
+    s_ecc_region_index = 0;
+    s_ecc_offset = 0;
+    s_ecc_last_us = timer_monotonic_us();
+    s_ecc_pass_start_us = s_ecc_last_us;
+}
+
+/*!
+    \brief      set the scrub step size and pacing
+    \param[in]  chunk_bytes: bytes per step, rounded down to 32; 0 stops the scrubber
+    \param[in]  period_us: minimum time between steps
+    \param[out] none
+    \retval     none
+    \note       The scrub rate is chunk_bytes / period_us. Interrupts are masked
+                for one step, see chunk_cycles_max in the statistics.
+*/
+void ecc_scrub_config(uint32_t chunk_bytes, uint32_t period_us)
+{
+    s_ecc_chunk = chunk_bytes & ~31U;
+    s_ecc_period_us = period_us;
+}
+
+/*!
+    \brief      add a RAM range to the scrubber
+    \param[in]  start: first byte
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if the table is full or the range empty
+    \note       Every word of the range must have been written. Do not add
+                buffers a DMA writes to: a word written back after a
+                correction could overwrite data the DMA stored meanwhile.
+*/
+ErrStatus ecc_scrub_region_add(uint32_t start, uint32_t size)
+{
+    return ecc_region_append(start, size);
+}
+
+/*!
+    \brief      find a corrected error latched inside a range
+    \param[in]  start: first byte
+    \param[in]  bytes: length
+    \param[out] fail: first byte of the failing ECC word
+    \param[out] width: bytes of the failing ECC word
+    \retval     1 if a monitor of the range latched a single error in it, 0 otherwise
+    \note       Flags of other monitors, or for addresses outside the range,
+                come from accesses elsewhere (a DMA among them) and are left
+                to the interrupt.
+*/
+static uint8_t ecc_single_find(uint32_t start, uint32_t bytes, uint32_t *fail, uint32_t *width)
+{
+    uint32_t address;
+    uint8_t i;
+
+    for(i = 0; i < ECC_MONITORS; i++)
+    {
+        if((start < s_ecc_ram[i].start) || (start >= s_ecc_ram[i].end) || \
+           !(RAMECCMU_MXSTAT(s_ecc_monitor[i]) & RAMECCMU_FLAG_ECC_SINGLE_ERROR))
+        {
+            continue;
+        }
+        address = s_ecc_ram[i].start + (rameccmu_monitor_failing_address_get(s_ecc_monitor[i]) << s_ecc_ram[i].shift) + \
+                  s_ecc_ram[i].lane;
+        if((address + s_ecc_ram[i].width > start) && (address < start + bytes))
+        {
+            *fail = address;
+            *width = s_ecc_ram[i].width;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*!
+    \brief      scrub the next chunk if the pacing allows it
+    \param[in]  none
+    \param[out] none
+    \retval     1 if a chunk was scrubbed, 0 if none was due
+    \note       Call from the main loop or an idle hook. Reads correct data on
+                the bus but not in the array, so when the monitor of the chunk
+                latched a single error inside it, the failing ECC word is
+                written back with interrupts still masked; the interrupt logs
+                the address afterwards.
+*/
+uint8_t ecc_scrub_step(void)
+{
+    const ecc_region_struct *region;
+    volatile uint32_t *word;
+    uint32_t now, bytes, i, value, primask, start, fail, width;
+    uint8_t cached;
+
+    now = timer_monotonic_us();
+    if((s_ecc_chunk == 0U) || (s_ecc_region_count == 0U) || ((now - s_ecc_last_us) < s_ecc_period_us))
+    {
+        return 0;
+    }
+    s_ecc_last_us = now;
+
+    region = &s_ecc_region[s_ecc_region_index];
+    word = (volatile uint32_t *)(region->start + s_ecc_offset);
+    bytes = region->size - s_ecc_offset;
+    bytes = (bytes < s_ecc_chunk) ? bytes : s_ecc_chunk;
+    cached = ((uint32_t)word >= ECC_CACHED_START) ? 1U : 0U;
+
+    start = DWT_CYCCNT;
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(cached)
+    {
+        /* fetch from the array, not from the cache */
+        SCB_CleanInvalidateDCache_by_Addr((uint32_t *)word, (int32_t)bytes);
+    }
+    for(i = 0; i < bytes / 4U; i++)
+    {
+        value = word[i];
+    }
+    if(ecc_single_find((uint32_t)word, bytes, &fail, &width))
+    {
+        /* a write recomputes the code of the whole ECC word, only the words of this chunk are touched */
+        for(i = 0; i < bytes / 4U; i++)
+        {
+            if(((uint32_t)&word[i] >= fail) && ((uint32_t)&word[i] < fail + width))
+            {
+                value = word[i];
+                word[i] = value;
+            }
+        }
+        if(cached)
+        {
+            SCB_CleanDCache_by_Addr((uint32_t *)word, (int32_t)bytes);
+        }
+        s_ecc_stats.scrub_repairs++;
+    }
+    __set_PRIMASK(primask);
+    (void)value;
+    start = DWT_CYCCNT - start;
+
+    s_ecc_pass_cycles += start;
+    if(start > s_ecc_stats.chunk_cycles_max)
+    {
+        s_ecc_stats.chunk_cycles_max = start;
+    }
+    s_ecc_stats.scrub_chunks++;
+
+    s_ecc_offset += bytes;
+    if(s_ecc_offset >= region->size)
+    {
+        s_ecc_offset = 0;
+        if(++s_ecc_region_index >= s_ecc_region_count)
+        {
+            s_ecc_region_index = 0;
+            s_ecc_stats.scrub_passes++;
+            s_ecc_stats.pass_us = now - s_ecc_pass_start_us;
+            s_ecc_stats.pass_cycles = s_ecc_pass_cycles;
+            s_ecc_pass_start_us = now;
+            s_ecc_pass_cycles = 0;
+        }
+    }
+    return 1;
+}
+
+/*!
+    \brief      set the uncorrectable error hook
+    \param[in]  callback: hook, NULL to reset on every uncorrectable error
+    \param[in]  arg: pointer passed to the hook
+    \param[out] none
+    \retval     none
+*/
+void ecc_uncorrectable_register(ecc_uncorrectable_fn callback, void *arg)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    s_ecc_callback = callback;
+    s_ecc_callback_arg = arg;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      copy one hot address entry
+    \param[in]  index: entry, 0 to ECC_HOT_ENTRIES-1
+    \param[out] entry: monitor, address and count
+    \retval     1 if the entry is valid, 0 otherwise
+*/
+uint8_t ecc_hot_get(uint8_t index, ecc_hot_struct *entry)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint8_t valid;
+
+    __disable_irq();
+    valid = (index < s_ecc_hot_count) ? 1U : 0U;
+    if(valid)
+    {
+        *entry = s_ecc_hot[index];
+    }
+    __set_PRIMASK(primask);
+    return valid;
+}
+
+/*!
+    \brief      copy statistics
+    \param[in]  none
+    \param[out] stats: counters and scrubber cost
+    \retval     none
+*/
+void ecc_stats_get(ecc_stats_struct *stats)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t bytes = 0;
+    uint8_t i;
+
+    for(i = 0; i < s_ecc_region_count; i++)
+    {
+        bytes += s_ecc_region[i].size;
+    }
+    __disable_irq();
+    *stats = s_ecc_stats;
+    __set_PRIMASK(primask);
+    stats->scrub_bytes = bytes;
+}
+
+/*!
+    \brief      print counters, hot addresses and the scrubber cost
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The cost is the share of CPU cycles the last complete pass
+                took over its duration.
+*/
+void ecc_stats_print(void)
+{
+    ecc_stats_struct stats;
+    ecc_hot_struct hot;
+    uint32_t cost = 0, rate = 0;
+    uint8_t i;
+
+    ecc_stats_get(&stats);
+    if(stats.pass_us != 0U)
+    {
+        cost = (uint32_t)(((uint64_t)stats.pass_cycles * 1000000000ULL) / ((uint64_t)stats.pass_us * SystemCoreClock));
+        rate = (uint32_t)(((uint64_t)stats.scrub_bytes * 1000000ULL) / ((uint64_t)stats.pass_us * 1024U));
+    }
+    PRINT("ecc: scrub %u bytes/pass, %u passes, last %u ms at %u KB/s, cpu %u.%03u%%, step max %u cycles, %u repairs\r\n",
+          (unsigned)stats.scrub_bytes, (unsigned)stats.scrub_passes, (unsigned)(stats.pass_us / 1000U), (unsigned)rate,
+          (unsigned)(cost / 1000U), (unsigned)(cost % 1000U), (unsigned)stats.chunk_cycles_max,
+          (unsigned)stats.scrub_repairs);
+    for(i = 0; i < ECC_MONITORS; i++)
+    {
+        if(stats.single[i] || stats.uncorrectable[i])
+        {
+            PRINT("  RAMECCMU%u monitor %u: %u corrected, %u uncorrectable\r\n", (unsigned)(s_ecc_monitor[i] >> 4),
+                  (unsigned)(s_ecc_monitor[i] & 0x0FU), (unsigned)stats.single[i], (unsigned)stats.uncorrectable[i]);
+        }
+    }
+    for(i = 0; ecc_hot_get(i, &hot); i++)
+    {
+        PRINT("  hot: RAMECCMU%u monitor %u address 0x%08X x%u\r\n", (unsigned)(s_ecc_monitor[hot.monitor] >> 4),
+              (unsigned)(s_ecc_monitor[hot.monitor] & 0x0FU), (unsigned)hot.address, (unsigned)hot.count);
+    }
+    if(stats.hot_evictions)
+    {
+        PRINT("  hot: %u addresses evicted\r\n", (unsigned)stats.hot_evictions);
+    }
+}
+
+/*!
+    \brief      RAMECCMU interrupt: log corrections, escalate uncorrectable errors
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void RAMECCMU_IRQHandler(void)
+{
+    uint32_t status, address;
+    uint8_t i;
+
+    for(i = 0; i < ECC_MONITORS; i++)
+    {
+        status = RAMECCMU_MXSTAT(s_ecc_monitor[i]) & ECC_FLAG_ALL;
+        if(status == 0U)
+        {
+            continue;
+        }
+        address = rameccmu_monitor_failing_address_get(s_ecc_monitor[i]);
+        rameccmu_monitor_flag_clear(s_ecc_monitor[i], status);
+        if(status & RAMECCMU_FLAG_ECC_SINGLE_ERROR)
+        {
+            s_ecc_stats.single[i]++;
+            ecc_hot_log(i, address);
+        }
+        if(status & ECC_FLAG_UNCORRECTABLE)
+        {
+            s_ecc_stats.uncorrectable[i]++;
+            ecc_escalate(i, address);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/*!
+    \file       ecc.h
+    \brief      header file for RAM ECC monitoring and scrubbing
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - RAMECCMU monitor and interrupt configuration
+    - Background scrubber configuration (chunk size, pacing)
+    - Uncorrectable error escalation hook
+    - Error counters, hot address table and scrubber cost statistics
+*/
+
+#ifndef __ECC_H
+#define __ECC_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief ECC service configuration macros
+*/
+#define ECC_MONITORS                8U                                      /*!< RAMECCMU0 monitors 0-4 and RAMECCMU1 monitors 0-2 */
+#define ECC_IRQ_PRIORITY            1U                                      /*!< RAMECCMU interrupt priority, uncorrectable errors escalate here */
+#define ECC_HOT_ENTRIES             16U                                     /*!< failing addresses kept with their hit counts */
+#define ECC_SCRUB_REGIONS           6U                                      /*!< scrub ranges, two taken by the image RW regions */
+#define ECC_SCRUB_CHUNK             256U                                    /*!< default bytes per scrub step, multiple of 32 */
+#define ECC_SCRUB_PERIOD_US         1000U                                   /*!< default minimum time between scrub steps */
+#define ECC_LOCKUP_ENABLE           0                                       /*!< 1: route TCM/AXI double errors to the TIMER break lockup input */
+#define ECC_RESET_MAGIC             0x45434332U                             /*!< "ECC2": reset record holds an uncorrectable error */
+#define ECC_DMA_BUFFER              __attribute__((section(".bss.dma")))    /*!< place a buffer a DMA writes to in RW_DMA, which is not scrubbed */
+
+/*!
+    \brief uncorrectable error hook
+    \param[in]  monitor: monitor index, 0-4 RAMECCMU0, 5-7 RAMECCMU1
+    \param[in]  address: failing address reported by the monitor
+    \param[in]  arg: pointer given at registration
+    \retval     1 to keep running, 0 to reset
+*/
+typedef uint8_t (*ecc_uncorrectable_fn)(uint8_t monitor, uint32_t address, void *arg);
+
+/*!
+    \brief hot address table entry
+*/
+typedef struct
+{
+    uint8_t monitor;                                                        /*!< monitor index */
+    uint32_t address;                                                       /*!< failing address reported by the monitor */
+    uint32_t count;                                                         /*!< corrections at this address */
+} ecc_hot_struct;
+
+/*!
+    \brief ECC service statistics
+*/
+typedef struct
+{
+    uint32_t single[ECC_MONITORS];                                          /*!< corrected single-bit errors per monitor */
+    uint32_t uncorrectable[ECC_MONITORS];                                   /*!< double errors and double errors on byte write per monitor */
+    uint32_t hot_evictions;                                                 /*!< addresses dropped from a full hot table */
+    uint32_t scrub_chunks;                                                  /*!< scrub steps done */
+    uint32_t scrub_repairs;                                                 /*!< failing ECC words written back by the scrubber */
+    uint32_t scrub_passes;                                                  /*!< complete passes over all ranges */
+    uint32_t scrub_bytes;                                                   /*!< bytes per pass */
+    uint32_t pass_us;                                                       /*!< duration of the last complete pass */
+    uint32_t pass_cycles;                                                   /*!< CPU cycles spent scrubbing in the last pass */
+    uint32_t chunk_cycles_max;                                              /*!< longest scrub step, interrupts are masked for it */
+} ecc_stats_struct;
+
+/* function declarations */
+void ecc_init(void);                                                                    /*!< enable all monitors and the scrubber */
+void ecc_scrub_config(uint32_t chunk_bytes, uint32_t period_us);                        /*!< set scrub step size and pacing, 0 bytes stops it */
+ErrStatus ecc_scrub_region_add(uint32_t start, uint32_t size);                          /*!< scrub an extra, initialised RAM range */
+uint8_t ecc_scrub_step(void);                                                           /*!< scrub one chunk if it is due, call from the main loop */
+void ecc_uncorrectable_register(ecc_uncorrectable_fn callback, void *arg);              /*!< set the uncorrectable error hook */
+uint8_t ecc_hot_get(uint8_t index, ecc_hot_struct *entry);                              /*!< copy one hot address entry */
+void ecc_stats_get(ecc_stats_struct *stats);                                            /*!< copy statistics */
+void ecc_stats_print(void);                                                             /*!< print counters, hot addresses and scrub cost */
+#endif /* __ECC_H */
@@ -0,0 +1,267 @@
+/*!
+    \file       fault.c
+    \brief      fault capture with crash dump to reset-surviving RAM
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - HardFault, MemManage, BusFault and UsageFault handlers that record the
+      stacked registers, fault status and address registers, a bounded stack
+      snapshot and the DWT cycle count, then reset at once
+    - A record in the uninitialised RW_NOINIT region of DTCM, which is not
+      cached and keeps its contents over a system reset
+    - A small stack next to the record, so a fault caused by an overflowed
+      main stack is still recorded
+    - Boot-time detection and printing of the record in the line format read
+      by TOOLS/fault_decode.py
+*/
+
+#include <stddef.h>
+#include "gd32h7xx_libopt.h"
+#include "./FAULT/fault.h"
+#include "./SYSTEM/system.h"
+#include "./USART/usart.h"
+
+/*!
+    \brief RAM ranges a stack pointer may point into
+*/
+typedef struct
+{
+    uint32_t start;                                                         /* first byte */
+    uint32_t end;                                                           /* one past the last byte */
+} fault_ram_struct;
+
+static const fault_ram_struct s_fault_ram[] =
+{
+    {0x00000000U, 0x00010000U},                                             /* ITCM */
+    {0x20000000U, 0x20020000U},                                             /* DTCM */
+    {0x24000000U, 0x240D0000U},                                             /* AXI SRAM */
+    {0x30000000U, 0x30008000U}                                              /* SRAM0-1 */
+};
+
+static const char *const s_fault_names[] = {"HardFault", "MemManage", "BusFault", "UsageFault"};
+
+FAULT_NOINIT static fault_record_struct s_fault_record;                     /* crash record, survives the reset */
+static uint8_t s_fault_pending = 0;                                         /* 1: a valid record waits for fault_report */
+
+/* stack of fault_capture, 8-byte aligned as AAPCS wants; the handlers load the top from s_fault_sp */
+FAULT_NOINIT static uint64_t s_fault_stack[FAULT_HANDLER_STACK_WORDS / 2U];
+__USED static uint64_t *const s_fault_sp = &s_fault_stack[FAULT_HANDLER_STACK_WORDS / 2U];
+typedef char fault_stack_check[((FAULT_HANDLER_STACK_WORDS % 2U) == 0U) && (FAULT_HANDLER_STACK_WORDS >= 32U) ? 1 : -1];
+
+/*!
+    \brief      check that a block lies inside one RAM range
+    \param[in]  addr: block start
+    \param[in]  bytes: block length
+    \param[out] none
+    \retval     1 if readable without a bus fault, 0 otherwise
+*/
+static uint8_t fault_ram_valid(uint32_t addr, uint32_t bytes)
+{
+    uint32_t i;
+
+    if(addr & 3U)
+    {
+        return 0;
+    }
+    for(i = 0; i < sizeof(s_fault_ram) / sizeof(s_fault_ram[0]); i++)
+    {
+        if((addr >= s_fault_ram[i].start) && (addr < s_fault_ram[i].end) && (bytes <= s_fault_ram[i].end - addr))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*!
+    \brief      sum the record words before the checksum
+    \param[in]  record: crash record
+    \param[out] none
+    \retval     32-bit word sum
+*/
+static uint32_t fault_record_sum(const fault_record_struct *record)
+{
+    const uint32_t *word = (const uint32_t *)record;
+    uint32_t i, sum = 0;
+
+    for(i = 0; i < offsetof(fault_record_struct, sum) / 4U; i++)
+    {
+        sum += word[i];
+    }
+    return sum;
+}
+
+/*!
+    \brief      record a fault and reset
+    \param[in]  frame: exception frame on the stack that was active at the fault
+    \param[in]  exc_return: EXC_RETURN value of the fault handler
+    \param[in]  type: FAULT_TYPE_x
+    \param[out] none
+    \retval     none
+    \note       Runs in the fault handler on s_fault_stack, never on the
+                stack that faulted, and only reads memory checked by
+                fault_ram_valid. With a broken frame (stack overflow) only the
+                fault registers are kept. An overflow that leaves MSP outside
+                RAM still locks up, as the core cannot push the frame.
+*/
+__NO_RETURN void fault_capture(uint32_t *frame, uint32_t exc_return, uint32_t type)
+{
+    fault_record_struct *r = &s_fault_record;
+    uint32_t sp, i;
+
+    __disable_irq();
+    r->magic = FAULT_MAGIC;
+    r->type = type;
+    r->exc_return = exc_return;
+    r->cfsr = SCB->CFSR;
+    r->hfsr = SCB->HFSR;
+    r->mmfar = SCB->MMFAR;
+    r->bfar = SCB->BFAR;
+    r->afsr = SCB->AFSR;
+    r->cyccnt = DWT_CYCCNT;
+    r->core_hz = SystemCoreClock;
+    r->stack_words = 0;
+
+    if(fault_ram_valid((uint32_t)frame, 32U))
+    {
+        r->r0 = frame[0];
+        r->r1 = frame[1];
+        r->r2 = frame[2];
+        r->r3 = frame[3];
+        r->r12 = frame[4];
+        r->lr = frame[5];
+        r->pc = frame[6];
+        r->xpsr = frame[7];
+
+        /* EXC_RETURN bit 4 clear: extended frame with S0-S15 and FPSCR; xPSR bit 9: 4-byte alignment pad */
+        sp = (uint32_t)frame + ((exc_return & 0x10U) ? 32U : 104U) + ((r->xpsr & (1U << 9)) ? 4U : 0U);
+        r->sp = sp;
+        for(i = 0; (i < FAULT_STACK_WORDS) && fault_ram_valid(sp + i * 4U, 4U); i++)
+        {
+            r->stack[i] = ((const uint32_t *)sp)[i];
+        }
+        r->stack_words = i;
+    }
+    else
+    {
+        r->r0 = r->r1 = r->r2 = r->r3 = r->r12 = 0;
+        r->lr = r->pc = r->xpsr = 0;
+        r->sp = 0;
+    }
+    r->sum = fault_record_sum(r);
+
+    __DSB();
+    NVIC_SystemReset();
+}
+
+/* handler entry: pick the stack the frame was pushed to, keep EXC_RETURN, move MSP to s_fault_stack */
+#define FAULT_HANDLER(name, type)                   \
+    __attribute__((naked)) void name(void)          \
+    {                                               \
+        __asm volatile(                             \
+            "tst lr, #4         \n"                 \
+            "ite eq             \n"                 \
+            "mrseq r0, msp      \n"                 \
+            "mrsne r0, psp      \n"                 \
+            "mov r1, lr         \n"                 \
+            "movs r2, #" #type "\n"                 \
+            "movw r3, #:lower16:s_fault_sp\n"       \
+            "movt r3, #:upper16:s_fault_sp\n"       \
+            "ldr r3, [r3]       \n"                 \
+            "msr msp, r3        \n"                 \
+            "b fault_capture    \n");               \
+    }
+
+FAULT_HANDLER(HardFault_Handler, 0)
+FAULT_HANDLER(MemManage_Handler, 1)
+FAULT_HANDLER(BusFault_Handler, 2)
+FAULT_HANDLER(UsageFault_Handler, 3)
+
+/*!
+    \brief      enable the fault exceptions and look for a previous crash
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Call first thing in main. MemManage, BusFault and UsageFault
+                get their own handlers instead of escalating to HardFault, and
+                with FAULT_TRAP_DIV0 division by zero traps. A record with a
+                wrong magic or sum is power-on garbage and ignored.
+*/
+void fault_init(void)
+{
+    s_fault_pending = ((s_fault_record.magic == FAULT_MAGIC) && \
+                       (s_fault_record.stack_words <= FAULT_STACK_WORDS) && \
+                       (s_fault_record.type < (sizeof(s_fault_names) / sizeof(s_fault_names[0]))) && \
+                       (s_fault_record.sum == fault_record_sum(&s_fault_record))) ? 1 : 0;
+
+    SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk;
+#if FAULT_TRAP_DIV0
+    SCB->CCR |= SCB_CCR_DIV_0_TRP_Msk;
+#endif
+    __DSB();
+    __ISB();
+}
+
+/*!
+    \brief      copy the previous crash record
+    \param[in]  none
+    \param[out] record: crash record
+    \retval     1 if a crash was recorded before this boot, 0 otherwise
+*/
+uint8_t fault_last_get(fault_record_struct *record)
+{
+    if(!s_fault_pending)
+    {
+        return 0;
+    }
+    *record = s_fault_record;
+    return 1;
+}
+
+/*!
+    \brief      print the previous crash and clear it
+    \param[in]  none
+    \param[out] none
+    \retval     1 if a crash was printed, 0 if there was none
+    \note       Call after usart_init. Every line starts with "FAULT " so
+                TOOLS/fault_decode.py can pick the dump out of a console log.
+*/
+uint8_t fault_report(void)
+{
+    const fault_record_struct *r = &s_fault_record;
+    uint32_t i;
+
+    if(!s_fault_pending)
+    {
+        return 0;
+    }
+
+    PRINT_ERROR("previous boot ended in %s at pc 0x%08X\r\n", s_fault_names[r->type], (unsigned)r->pc);
+    PRINT("FAULT type=%s exc_return=%08X\r\n", s_fault_names[r->type], (unsigned)r->exc_return);
+    PRINT("FAULT r0=%08X r1=%08X r2=%08X r3=%08X\r\n",
+          (unsigned)r->r0, (unsigned)r->r1, (unsigned)r->r2, (unsigned)r->r3);
+    PRINT("FAULT r12=%08X lr=%08X pc=%08X xpsr=%08X sp=%08X\r\n",
+          (unsigned)r->r12, (unsigned)r->lr, (unsigned)r->pc, (unsigned)r->xpsr, (unsigned)r->sp);
+    PRINT("FAULT cfsr=%08X hfsr=%08X mmfar=%08X bfar=%08X afsr=%08X\r\n",
+          (unsigned)r->cfsr, (unsigned)r->hfsr, (unsigned)r->mmfar, (unsigned)r->bfar, (unsigned)r->afsr);
+    PRINT("FAULT cyccnt=%08X core_hz=%u\r\n", (unsigned)r->cyccnt, (unsigned)r->core_hz);
+    for(i = 0; i < r->stack_words; i++)
+    {
+        if((i & 7U) == 0U)
+        {
+            PRINT("FAULT stack %08X:", (unsigned)(r->sp + i * 4U));
+        }
+        PRINT(" %08X", (unsigned)r->stack[i]);
+        if(((i & 7U) == 7U) || (i + 1U == r->stack_words))
+        {
+            PRINT("\r\n");
+        }
+    }
+    PRINT("FAULT end\r\n");
+
+    s_fault_record.magic = 0;
+    s_fault_pending = 0;
+    return 1;
+}
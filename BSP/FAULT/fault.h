@@ -0,0 +1,68 @@
+/*!
+    \file       fault.h
+    \brief      header file for fault capture and crash dump
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Crash record layout kept in reset-surviving DTCM
+    - Fault capture configuration (stack snapshot depth, RAM ranges)
+    - Boot-time detection and printing of the previous crash
+*/
+
+#ifndef __FAULT_H
+#define __FAULT_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief fault capture configuration macros
+*/
+#define FAULT_NOINIT                __attribute__((section(".bss.noinit"))) /*!< place a variable in RW_NOINIT, kept over resets */
+#define FAULT_MAGIC                 0x464C5431U                             /*!< "FLT1": record holds an unreported crash */
+#define FAULT_STACK_WORDS           64U                                     /*!< stack words copied above the exception frame */
+#define FAULT_HANDLER_STACK_WORDS   64U                                     /*!< own stack of fault_capture in RW_NOINIT, used instead of a possibly overflowed MSP */
+#define FAULT_TRAP_DIV0             1                                       /*!< 1: integer division by zero raises UsageFault instead of returning 0 */
+
+/* fault types */
+#define FAULT_TYPE_HARD             0U                                      /*!< HardFault */
+#define FAULT_TYPE_MEMMANAGE        1U                                      /*!< MemManage */
+#define FAULT_TYPE_BUS              2U                                      /*!< BusFault */
+#define FAULT_TYPE_USAGE            3U                                      /*!< UsageFault */
+
+/*!
+    \brief crash record, word layout parsed by TOOLS/fault_decode.py
+*/
+typedef struct
+{
+    uint32_t magic;                                                         /*!< FAULT_MAGIC while the record is unreported */
+    uint32_t type;                                                          /*!< FAULT_TYPE_x */
+    uint32_t exc_return;                                                    /*!< EXC_RETURN: mode, stack and frame type */
+    uint32_t r0;                                                            /*!< stacked R0 */
+    uint32_t r1;                                                            /*!< stacked R1 */
+    uint32_t r2;                                                            /*!< stacked R2 */
+    uint32_t r3;                                                            /*!< stacked R3 */
+    uint32_t r12;                                                           /*!< stacked R12 */
+    uint32_t lr;                                                            /*!< stacked LR, return address of the faulting function */
+    uint32_t pc;                                                            /*!< stacked PC, faulting instruction */
+    uint32_t xpsr;                                                          /*!< stacked xPSR */
+    uint32_t sp;                                                            /*!< stack pointer before the exception, 0 if the frame was unreadable */
+    uint32_t cfsr;                                                          /*!< configurable fault status */
+    uint32_t hfsr;                                                          /*!< HardFault status */
+    uint32_t mmfar;                                                         /*!< MemManage fault address */
+    uint32_t bfar;                                                          /*!< BusFault address */
+    uint32_t afsr;                                                          /*!< auxiliary fault status */
+    uint32_t cyccnt;                                                        /*!< DWT cycle counter at the fault */
+    uint32_t core_hz;                                                       /*!< SystemCoreClock, to turn cyccnt into time */
+    uint32_t stack_words;                                                   /*!< valid words in stack */
+    uint32_t stack[FAULT_STACK_WORDS];                                      /*!< words from sp upward */
+    uint32_t sum;                                                           /*!< sum of all words above, detects power-on garbage */
+} fault_record_struct;
+
+/* function declarations */
+void fault_init(void);                                                                  /*!< enable fault exceptions, detect a previous crash */
+uint8_t fault_report(void);                                                             /*!< print and clear the previous crash */
+uint8_t fault_last_get(fault_record_struct *record);                                    /*!< copy the previous crash before it is reported */
+void fault_capture(uint32_t *frame, uint32_t exc_return, uint32_t type);                /*!< record a fault and reset, called by the handlers */
+#endif /* __FAULT_H */
@@ -0,0 +1,565 @@
+/*!
+    \file       hash.c
+    \brief      streaming SHA-256/HMAC-SHA-256 on HAU with DMA and context switching
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Incremental SHA-256 hashing (init/update/final) of messages split over many buffers
+    - DMA feeding of the HAU IN FIFO in multiple-DMA mode for large buffers
+    - Suspending and resuming HAU contexts so concurrent sessions share the unit
+    - HMAC-SHA-256 built on the streaming hash (inner and outer hash)
+    - Software SHA-256 fallback when the HAU engine is not initialized or not wanted
+    - Throughput benchmark against hau_hash_sha_256 and the software backend
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./HASH/hash.h"
+#include "./LOCK/lock.h"
+#include "./SYSTEM/system.h"
+#include "./USART/usart.h"
+#include <string.h>
+
+#define HASH_HAU_TIMEOUT            ((uint32_t)0x00100000U)                 /* digest calculation timeout */
+
+static uint8_t s_hash_ready = 0;                                            /* HAU engine initialized */
+static hash_context_struct *s_hash_owner = NULL;                            /* session whose context is loaded in HAU */
+static hash_context_struct *s_hash_active = NULL;                           /* session with DMA transfer in progress, holds LOCK_SEM_HAU */
+
+/*!
+    \brief      initialize HAU and DMA for streaming hashing
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       HAU is arbitrated through LOCK_SEM_HAU, lock_init must have run.
+*/
+void hash_engine_init(void)
+{
+    dma_single_data_parameter_struct dma_init_struct;
+
+    rcu_periph_clock_enable(RCU_HAU);
+    hau_deinit();
+
+    rcu_periph_clock_enable(HASH_DMA_CLOCK);
+    rcu_periph_clock_enable(RCU_DMAMUX);
+
+    dma_deinit(HASH_DMA, HASH_DMA_CHANNEL);
+    dma_init_struct.request             = DMA_REQUEST_HAU_IN;
+    dma_init_struct.periph_addr         = HASH_DI_ADDRESS;
+    dma_init_struct.memory0_addr        = 0;
+    dma_init_struct.number              = 0;
+    dma_init_struct.periph_inc          = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc          = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.periph_memory_width = DMA_PERIPH_WIDTH_32BIT;
+    dma_init_struct.direction           = DMA_MEMORY_TO_PERIPH;
+    dma_init_struct.priority            = DMA_PRIORITY_HIGH;
+    dma_init_struct.circular_mode       = DMA_CIRCULAR_MODE_DISABLE;
+    dma_single_data_mode_init(HASH_DMA, HASH_DMA_CHANNEL, &dma_init_struct);
+
+    dma_interrupt_enable(HASH_DMA, HASH_DMA_CHANNEL, DMA_INT_FTF | DMA_INT_TAE);
+    nvic_irq_enable(HASH_DMA_IRQ, 3, 0);
+
+    s_hash_owner = NULL;
+    s_hash_active = NULL;
+    s_hash_ready = 1;
+}
+
+/*!
+    \brief      load the session context into HAU, suspending the previous owner
+    \param[in]  ctx: session to activate
+    \param[out] none
+    \retval     none
+*/
+static void hash_hw_acquire(hash_context_struct *ctx)
+{
+    hau_init_parameter_struct init_para;
+
+    if(s_hash_owner == ctx)
+    {
+        return;
+    }
+
+    /* context can only be saved when no block is being processed */
+    if(s_hash_owner != NULL)
+    {
+        while(hau_flag_get(HAU_FLAG_BUSY) == SET)
+        {
+        }
+        hau_context_save(&s_hash_owner->hw_context);
+    }
+
+    if(ctx->started)
+    {
+        hau_context_restore(&ctx->hw_context);
+    }
+    else
+    {
+        hau_init_struct_para_init(&init_para);
+        init_para.algo     = HAU_ALGO_SHA256;
+        init_para.mode     = HAU_MODE_HASH;
+        init_para.datatype = HAU_SWAPPING_8BIT;
+        hau_init(&init_para);
+        hau_multiple_single_dma_config(MULTIPLE_DMA_NO_DIGEST);            /* digest only on hash_final */
+        ctx->started = 1;
+    }
+    s_hash_owner = ctx;
+}
+
+/*!
+    \brief      reset a session for a new message, keeping backend and HMAC key
+    \param[in]  ctx: session context
+    \param[out] none
+    \retval     none
+*/
+static void hash_start(hash_context_struct *ctx)
+{
+    if(s_hash_owner == ctx)
+    {
+        s_hash_owner = NULL;                                                /* HAU state of old message is discarded */
+    }
+    ctx->started = 0;
+    ctx->tail_length = 0;
+    ctx->total_length = 0;
+    ctx->callback = NULL;
+    ctx->state = HASH_STATE_READY;
+    sha256_init(&ctx->sw_context);
+}
+
+/*!
+    \brief      start a SHA-256 session
+    \param[in]  ctx: session context
+    \param[in]  backend: HASH_BACKEND_HAU or HASH_BACKEND_SW
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note       HASH_BACKEND_HAU falls back to software when hash_engine_init has not run.
+*/
+ErrStatus hash_sha256_init(hash_context_struct *ctx, uint8_t backend)
+{
+    if((backend != HASH_BACKEND_HAU) && (backend != HASH_BACKEND_SW))
+    {
+        return ERROR;
+    }
+
+    memset(ctx, 0, sizeof(hash_context_struct));
+    ctx->backend = (s_hash_ready && (backend == HASH_BACKEND_HAU)) ? HASH_BACKEND_HAU : HASH_BACKEND_SW;
+    hash_start(ctx);
+    return SUCCESS;
+}
+
+/*!
+    \brief      feed data to the HAU by CPU writes
+    \param[in]  ctx: session context (must own the HAU)
+    \param[in]  data: message data
+    \param[in]  length: data length in bytes
+    \param[out] none
+    \retval     none
+*/
+static void hash_hw_write(hash_context_struct *ctx, const uint8_t *data, uint32_t length)
+{
+    uint32_t word;
+
+    while((ctx->tail_length > 0) && (length > 0))
+    {
+        ctx->tail[ctx->tail_length++] = *data++;
+        length--;
+        if(ctx->tail_length == 4)
+        {
+            memcpy(&word, ctx->tail, 4);
+            hau_data_write(word);
+            ctx->tail_length = 0;
+        }
+    }
+
+    while(length >= 4)
+    {
+        memcpy(&word, data, 4);                                             /* data may be unaligned */
+        hau_data_write(word);
+        data += 4;
+        length -= 4;
+    }
+
+    memcpy(&ctx->tail[ctx->tail_length], data, length);
+    ctx->tail_length += (uint8_t)length;
+}
+
+/*!
+    \brief      add data to a session by CPU on its backend
+    \param[in]  ctx: session context (must hold LOCK_SEM_HAU on the HAU backend)
+    \param[in]  data: message data
+    \param[in]  length: data length in bytes
+    \param[out] none
+    \retval     none
+*/
+static void hash_cpu_update(hash_context_struct *ctx, const uint8_t *data, uint32_t length)
+{
+    if(ctx->backend == HASH_BACKEND_SW)
+    {
+        sha256_update(&ctx->sw_context, data, length);
+    }
+    else
+    {
+        hash_hw_acquire(ctx);
+        hash_hw_write(ctx, data, length);
+    }
+    ctx->total_length += length;
+}
+
+/*!
+    \brief      start an HMAC-SHA-256 session
+    \param[in]  ctx: session context
+    \param[in]  backend: HASH_BACKEND_HAU or HASH_BACKEND_SW
+    \param[in]  key: HMAC key
+    \param[in]  key_length: key length in bytes, keys longer than 64 bytes are hashed first
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+ErrStatus hash_hmac_sha256_init(hash_context_struct *ctx, uint8_t backend, \
+                                const uint8_t *key, uint32_t key_length)
+{
+    uint8_t pad[SHA256_BLOCK_SIZE];
+    uint32_t i;
+
+    if(ERROR == hash_sha256_init(ctx, backend))
+    {
+        return ERROR;
+    }
+
+    ctx->hmac = 1;
+    if(key_length > SHA256_BLOCK_SIZE)
+    {
+        sha256_update(&ctx->sw_context, key, key_length);
+        sha256_final(&ctx->sw_context, ctx->hmac_key);
+        sha256_init(&ctx->sw_context);
+    }
+    else
+    {
+        memcpy(ctx->hmac_key, key, key_length);
+    }
+
+    /* inner hash starts with K ^ ipad */
+    for(i = 0; i < SHA256_BLOCK_SIZE; i++)
+    {
+        pad[i] = ctx->hmac_key[i] ^ 0x36U;
+    }
+    return hash_update(ctx, pad, SHA256_BLOCK_SIZE, NULL, NULL);
+}
+
+/*!
+    \brief      add message data to a hash session
+    \param[in]  ctx: session context
+    \param[in]  data: message data
+    \param[in]  length: data length in bytes
+    \param[in]  callback: completion callback, NULL for none
+    \param[in]  arg: user argument passed to callback
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if accepted, ERROR if HAU busy or session invalid
+    \note       HAU is held through LOCK_SEM_HAU until the data is in, so an ISR
+                finds it busy instead of switching contexts under a thread.
+                Word-aligned buffers of at least HASH_DMA_THRESHOLD bytes are sent
+                by DMA and the function returns immediately; data must stay valid
+                until the callback runs or hash_wait returns.
+*/
+ErrStatus hash_update(hash_context_struct *ctx, const uint8_t *data, uint32_t length, \
+                      hash_callback_fn callback, void *arg)
+{
+    uint32_t words;
+
+    if(ctx->state != HASH_STATE_READY)
+    {
+        return ERROR;
+    }
+
+    if(ctx->backend == HASH_BACKEND_SW)
+    {
+        sha256_update(&ctx->sw_context, data, length);
+        ctx->total_length += length;
+        if(callback != NULL)
+        {
+            callback(ctx, arg);
+        }
+        return SUCCESS;
+    }
+
+    if(SUCCESS != lock_try(LOCK_SEM_HAU))
+    {
+        return ERROR;
+    }
+
+    hash_hw_acquire(ctx);
+    ctx->callback = callback;
+    ctx->callback_arg = arg;
+    ctx->total_length += length;
+
+    /* complete a pending partial word by CPU so the DMA source is word aligned */
+    while((ctx->tail_length > 0) && (length > 0))
+    {
+        hash_hw_write(ctx, data, 1);
+        data++;
+        length--;
+    }
+
+    words = length / 4U;
+    if((words * 4U >= HASH_DMA_THRESHOLD) && (((uint32_t)data & 0x03U) == 0))
+    {
+        /* keep the trailing bytes for the next call */
+        memcpy(ctx->tail, data + words * 4U, length - words * 4U);
+        ctx->tail_length = (uint8_t)(length - words * 4U);
+
+        SCB_CleanDCache_by_Addr((void *)data, (int32_t)(words * 4U));
+        dma_channel_disable(HASH_DMA, HASH_DMA_CHANNEL);
+        DMA_INTC0(HASH_DMA) |= DMA_FLAG_ADD(DMA_CHINTF_RESET_VALUE, HASH_DMA_CHANNEL);
+        dma_memory_address_config(HASH_DMA, HASH_DMA_CHANNEL, DMA_MEMORY_0, (uint32_t)data);
+        dma_transfer_number_config(HASH_DMA, HASH_DMA_CHANNEL, words);
+
+        ctx->state = HASH_STATE_BUSY;
+        s_hash_active = ctx;
+        hau_dma_enable();
+        dma_channel_enable(HASH_DMA, HASH_DMA_CHANNEL);                     /* the DMA interrupt releases HAU */
+        return SUCCESS;
+    }
+
+    hash_hw_write(ctx, data, length);
+    lock_release(LOCK_SEM_HAU);
+    if(callback != NULL)
+    {
+        callback(ctx, arg);
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      wait for a pending update to complete
+    \param[in]  ctx: session context
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR if the transfer failed
+*/
+ErrStatus hash_wait(hash_context_struct *ctx)
+{
+    while(ctx->state == HASH_STATE_BUSY)
+    {
+    }
+    return (ctx->state == HASH_STATE_ERROR) ? ERROR : SUCCESS;
+}
+
+/*!
+    \brief      finish the current message on the selected backend
+    \param[in]  ctx: session context
+    \param[out] digest: 32-byte message digest
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+static ErrStatus hash_digest_get(hash_context_struct *ctx, uint8_t digest[SHA256_DIGEST_SIZE])
+{
+    hau_digest_parameter_struct digest_para;
+    uint32_t word = 0;
+    uint32_t counter = 0;
+    uint32_t i;
+
+    if(ctx->backend == HASH_BACKEND_SW)
+    {
+        sha256_final(&ctx->sw_context, digest);
+        return SUCCESS;
+    }
+
+    hash_hw_acquire(ctx);
+    if(ctx->tail_length > 0)
+    {
+        memcpy(&word, ctx->tail, ctx->tail_length);
+        hau_data_write(word);
+    }
+    hau_last_word_validbits_num_config(8U * ctx->tail_length);
+    hau_digest_calculation_enable();
+
+    while(hau_flag_get(HAU_FLAG_CALCULATION_COMPLETE) == RESET)
+    {
+        if(++counter == HASH_HAU_TIMEOUT)
+        {
+            s_hash_owner = NULL;
+            return ERROR;
+        }
+    }
+
+    hau_digest_read(&digest_para);
+    for(i = 0; i < 8; i++)
+    {
+        digest[i * 4]     = (uint8_t)(digest_para.out[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(digest_para.out[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(digest_para.out[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)(digest_para.out[i]);
+    }
+    s_hash_owner = NULL;
+    return SUCCESS;
+}
+
+/*!
+    \brief      finish a hash session and output the digest
+    \param[in]  ctx: session context
+    \param[out] digest: 32-byte SHA-256 or HMAC-SHA-256 value
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note       While another context or DMA transfer holds HAU, returns ERROR
+                and leaves the session intact, so the call can be repeated.
+*/
+ErrStatus hash_final(hash_context_struct *ctx, uint8_t digest[SHA256_DIGEST_SIZE])
+{
+    uint8_t pad[SHA256_BLOCK_SIZE];
+    uint8_t inner[SHA256_DIGEST_SIZE];
+    ErrStatus locked = ERROR;
+    ErrStatus ret;
+    uint32_t i;
+
+    if((ERROR == hash_wait(ctx)) || (ctx->state != HASH_STATE_READY))
+    {
+        ret = ERROR;
+    }
+    else
+    {
+        if(ctx->backend == HASH_BACKEND_HAU)
+        {
+            locked = lock_try(LOCK_SEM_HAU);
+            if(locked != SUCCESS)
+            {
+                return ERROR;                                               /* HAU held elsewhere, ctx kept: call again */
+            }
+        }
+
+        if(ctx->hmac == 0)
+        {
+            ret = hash_digest_get(ctx, digest);
+        }
+        else
+        {
+            /* outer hash: H((K ^ opad) || H((K ^ ipad) || message)) */
+            ret = hash_digest_get(ctx, inner);
+            if(ret == SUCCESS)
+            {
+                for(i = 0; i < SHA256_BLOCK_SIZE; i++)
+                {
+                    pad[i] = ctx->hmac_key[i] ^ 0x5CU;
+                }
+                hash_start(ctx);
+                hash_cpu_update(ctx, pad, SHA256_BLOCK_SIZE);
+                hash_cpu_update(ctx, inner, SHA256_DIGEST_SIZE);
+                ret = hash_digest_get(ctx, digest);
+            }
+        }
+    }
+
+    if(s_hash_owner == ctx)
+    {
+        s_hash_owner = NULL;
+    }
+    if(locked == SUCCESS)
+    {
+        lock_release(LOCK_SEM_HAU);
+    }
+    memset(ctx, 0, sizeof(hash_context_struct));                            /* wipe key material */
+    ctx->state = HASH_STATE_IDLE;
+    return ret;
+}
+
+/*!
+    \brief      HAU DMA channel interrupt handler, completes an asynchronous update
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void HASH_DMA_IRQHandler(void)
+{
+    hash_context_struct *ctx = s_hash_active;
+    uint8_t state = HASH_STATE_READY;
+
+    if(dma_interrupt_flag_get(HASH_DMA, HASH_DMA_CHANNEL, DMA_INT_FLAG_TAE) == SET)
+    {
+        dma_interrupt_flag_clear(HASH_DMA, HASH_DMA_CHANNEL, DMA_INT_FLAG_TAE);
+        state = HASH_STATE_ERROR;
+    }
+    else if(dma_interrupt_flag_get(HASH_DMA, HASH_DMA_CHANNEL, DMA_INT_FLAG_FTF) == SET)
+    {
+        dma_interrupt_flag_clear(HASH_DMA, HASH_DMA_CHANNEL, DMA_INT_FLAG_FTF);
+    }
+    else
+    {
+        return;
+    }
+
+    hau_dma_disable();
+    s_hash_active = NULL;
+    if(ctx == NULL)
+    {
+        return;
+    }
+    lock_release(LOCK_SEM_HAU);
+
+    ctx->state = state;
+    if(ctx->callback != NULL)
+    {
+        ctx->callback(ctx, ctx->callback_arg);
+    }
+}
+
+#if HASH_BENCHMARK_ENABLE
+__ALIGNED(32) static uint8_t s_hash_bench_buff[65536];                      /* benchmark message buffer */
+
+/*!
+    \brief      print throughput in MB/s with two decimals
+    \param[in]  size: bytes processed
+    \param[in]  cycles: CPU cycles taken
+    \param[out] none
+    \retval     none
+*/
+static void hash_benchmark_rate_print(uint32_t size, uint32_t cycles)
+{
+    uint32_t rate = (uint32_t)((uint64_t)size * SystemCoreClock / cycles / 10000U);
+
+    PRINT("%u.%02u\t\t", rate / 100U, rate % 100U);
+}
+
+/*!
+    \brief      compare streaming HAU, polled hau_hash_sha_256 and software SHA-256
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Also checks that the three backends agree on every digest.
+*/
+void hash_benchmark(void)
+{
+    hash_context_struct ctx;
+    uint8_t digest[3][SHA256_DIGEST_SIZE];
+    uint32_t size, t0, polled, stream, soft;
+
+    hash_engine_init();
+    for(size = 0; size < sizeof(s_hash_bench_buff); size++)
+    {
+        s_hash_bench_buff[size] = (uint8_t)size;
+    }
+
+    PRINT_INFO("SHA-256 benchmark (sys_ck %u Hz)>>\r\n", SystemCoreClock);
+    PRINT_INFO("size\t\tpolled MB/s\tstream MB/s\tsoftware MB/s\tmatch\r\n");
+    for(size = 64; size <= sizeof(s_hash_bench_buff); size <<= 2)
+    {
+        t0 = DWT_CYCCNT;
+        hau_hash_sha_256(s_hash_bench_buff, size, digest[0]);
+        polled = DWT_CYCCNT - t0;
+        s_hash_owner = NULL;                                                /* polled API clobbered HAU state */
+
+        t0 = DWT_CYCCNT;
+        hash_sha256_init(&ctx, HASH_BACKEND_HAU);
+        hash_update(&ctx, s_hash_bench_buff, size, NULL, NULL);
+        hash_final(&ctx, digest[1]);
+        stream = DWT_CYCCNT - t0;
+
+        t0 = DWT_CYCCNT;
+        hash_sha256_init(&ctx, HASH_BACKEND_SW);
+        hash_update(&ctx, s_hash_bench_buff, size, NULL, NULL);
+        hash_final(&ctx, digest[2]);
+        soft = DWT_CYCCNT - t0;
+
+        PRINT_INFO("%u\t\t", size);
+        hash_benchmark_rate_print(size, polled);
+        hash_benchmark_rate_print(size, stream);
+        hash_benchmark_rate_print(size, soft);
+        PRINT("%s\r\n", (memcmp(digest[0], digest[1], SHA256_DIGEST_SIZE) == 0 &&
+                         memcmp(digest[0], digest[2], SHA256_DIGEST_SIZE) == 0) ? "yes" : "NO");
+    }
+}
+#endif /* HASH_BENCHMARK_ENABLE */
@@ -0,0 +1,87 @@
+/*!
+    \file       hash.h
+    \brief      header file for streaming SHA-256/HMAC hashing on HAU with DMA
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Hash session context with saved HAU hardware context
+    - DMA channel allocation for HAU IN FIFO
+    - Incremental init/update/final declarations for SHA-256 and HMAC-SHA-256
+    - Backend selection (HAU or software fallback)
+*/
+
+#ifndef __HASH_H
+#define __HASH_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+#include "./HASH/sha256.h"
+
+/*!
+    \brief HAU DMA configuration macros
+*/
+#define HASH_DMA                    DMA1                                    /*!< DMA controller for HAU */
+#define HASH_DMA_CLOCK              RCU_DMA1                                /*!< DMA clock for HAU */
+#define HASH_DMA_CHANNEL            DMA_CH2                                 /*!< DMA channel feeding HAU IN FIFO */
+#define HASH_DMA_IRQ                DMA1_Channel2_IRQn                      /*!< DMA channel interrupt */
+#define HASH_DMA_IRQHandler         DMA1_Channel2_IRQHandler                /*!< DMA channel interrupt handler */
+#define HASH_DI_ADDRESS             (HAU + 0x04U)                           /*!< HAU data input register address */
+
+#define HASH_BENCHMARK_ENABLE       0                                       /*!< 1: build hash_benchmark with 64KB test buffer */
+#define HASH_DMA_THRESHOLD          256U                                    /*!< below this length the FIFO is fed by CPU */
+
+/*!
+    \brief hash backend selection
+*/
+#define HASH_BACKEND_HAU            0U                                      /*!< hardware HAU (software if engine not initialized) */
+#define HASH_BACKEND_SW             1U                                      /*!< portable software SHA-256 */
+
+/*!
+    \brief hash session state
+*/
+typedef enum
+{
+    HASH_STATE_IDLE = 0,                                                    /*!< context not initialized or finalized */
+    HASH_STATE_READY,                                                       /*!< ready for update */
+    HASH_STATE_BUSY,                                                        /*!< DMA transfer in progress */
+    HASH_STATE_ERROR                                                        /*!< last operation failed */
+} hash_state_enum;
+
+struct hash_context;
+
+/*! asynchronous update completion callback */
+typedef void (*hash_callback_fn)(struct hash_context *ctx, void *arg);
+
+/*!
+    \brief hash streaming session context
+*/
+typedef struct hash_context
+{
+    hau_context_parameter_struct hw_context;                                /*!< HAU context saved when swapped out */
+    sha256_context_struct sw_context;                                       /*!< software backend state */
+    uint8_t hmac_key[SHA256_BLOCK_SIZE];                                    /*!< HMAC key block, kept for the outer hash */
+    uint8_t tail[4];                                                        /*!< bytes not yet forming a full HAU word */
+    uint8_t tail_length;                                                    /*!< number of valid bytes in tail */
+    uint8_t backend;                                                        /*!< HASH_BACKEND_HAU or HASH_BACKEND_SW */
+    uint8_t hmac;                                                           /*!< 1: HMAC session */
+    uint8_t started;                                                        /*!< 1: HAU has been initialized for this message */
+    volatile uint8_t state;                                                 /*!< session state (hash_state_enum) */
+    uint32_t total_length;                                                  /*!< message bytes hashed so far */
+    hash_callback_fn callback;                                              /*!< completion callback, may be NULL */
+    void *callback_arg;                                                     /*!< user argument passed to callback */
+} hash_context_struct;
+
+/* function declarations */
+void hash_engine_init(void);                                                            /*!< initialize HAU and DMA for streaming */
+ErrStatus hash_sha256_init(hash_context_struct *ctx, uint8_t backend);                  /*!< start a SHA-256 session */
+ErrStatus hash_hmac_sha256_init(hash_context_struct *ctx, uint8_t backend, \
+                                const uint8_t *key, uint32_t key_length);               /*!< start an HMAC-SHA-256 session */
+ErrStatus hash_update(hash_context_struct *ctx, const uint8_t *data, uint32_t length, \
+                      hash_callback_fn callback, void *arg);                            /*!< add message data */
+ErrStatus hash_wait(hash_context_struct *ctx);                                          /*!< wait for a pending update */
+ErrStatus hash_final(hash_context_struct *ctx, uint8_t digest[SHA256_DIGEST_SIZE]);     /*!< finish and output digest */
+#if HASH_BENCHMARK_ENABLE
+void hash_benchmark(void);                                                              /*!< compare HAU stream, polled HAU and software */
+#endif
+#endif /* __HASH_H */
@@ -0,0 +1,162 @@
+/*!
+    \file       sha256.c
+    \brief      portable software SHA-256 (FIPS 180-4)
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Software fallback for the HAU streaming hash when the unit is unavailable
+    - Reference implementation for checking HAU results against test vectors
+*/
+
+#include "./HASH/sha256.h"
+#include <string.h>
+
+#define SHA256_ROTR(x, n)           (((x) >> (n)) | ((x) << (32U - (n))))
+
+static const uint32_t sha256_k[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/*!
+    \brief      compress one 64-byte block into the hash state
+    \param[in]  state: hash state
+    \param[in]  block: 64-byte message block
+    \param[out] none
+    \retval     none
+*/
+static void sha256_transform(uint32_t state[8], const uint8_t block[SHA256_BLOCK_SIZE])
+{
+    uint32_t w[64];
+    uint32_t a, b, c, d, e, f, g, h, t1, t2;
+    uint32_t i;
+
+    for(i = 0; i < 16; i++)
+    {
+        w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) |
+               ((uint32_t)block[i * 4 + 2] << 8) | (uint32_t)block[i * 4 + 3];
+    }
+    for(i = 16; i < 64; i++)
+    {
+        w[i] = (SHA256_ROTR(w[i - 2], 17) ^ SHA256_ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10)) + w[i - 7] +
+               (SHA256_ROTR(w[i - 15], 7) ^ SHA256_ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3)) + w[i - 16];
+    }
+
+    a = state[0]; b = state[1]; c = state[2]; d = state[3];
+    e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+    for(i = 0; i < 64; i++)
+    {
+        t1 = h + (SHA256_ROTR(e, 6) ^ SHA256_ROTR(e, 11) ^ SHA256_ROTR(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        t2 = (SHA256_ROTR(a, 2) ^ SHA256_ROTR(a, 13) ^ SHA256_ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+/*!
+    \brief      initialize software SHA-256
+    \param[in]  ctx: SHA-256 context
+    \param[out] none
+    \retval     none
+*/
+void sha256_init(sha256_context_struct *ctx)
+{
+    ctx->state[0] = 0x6a09e667;
+    ctx->state[1] = 0xbb67ae85;
+    ctx->state[2] = 0x3c6ef372;
+    ctx->state[3] = 0xa54ff53a;
+    ctx->state[4] = 0x510e527f;
+    ctx->state[5] = 0x9b05688c;
+    ctx->state[6] = 0x1f83d9ab;
+    ctx->state[7] = 0x5be0cd19;
+    ctx->length = 0;
+    ctx->block_length = 0;
+}
+
+/*!
+    \brief      add message data to software SHA-256
+    \param[in]  ctx: SHA-256 context
+    \param[in]  data: message data
+    \param[in]  length: data length in bytes
+    \param[out] none
+    \retval     none
+*/
+void sha256_update(sha256_context_struct *ctx, const uint8_t *data, uint32_t length)
+{
+    uint32_t take;
+
+    ctx->length += length;
+
+    if(ctx->block_length > 0)
+    {
+        take = SHA256_BLOCK_SIZE - ctx->block_length;
+        take = (take > length) ? length : take;
+        memcpy(&ctx->block[ctx->block_length], data, take);
+        ctx->block_length += take;
+        data += take;
+        length -= take;
+        if(ctx->block_length < SHA256_BLOCK_SIZE)
+        {
+            return;
+        }
+        sha256_transform(ctx->state, ctx->block);
+        ctx->block_length = 0;
+    }
+
+    while(length >= SHA256_BLOCK_SIZE)
+    {
+        sha256_transform(ctx->state, data);
+        data += SHA256_BLOCK_SIZE;
+        length -= SHA256_BLOCK_SIZE;
+    }
+
+    memcpy(ctx->block, data, length);
+    ctx->block_length = length;
+}
+
+/*!
+    \brief      pad the message and output the digest
+    \param[in]  ctx: SHA-256 context
+    \param[out] digest: 32-byte message digest
+    \retval     none
+*/
+void sha256_final(sha256_context_struct *ctx, uint8_t digest[SHA256_DIGEST_SIZE])
+{
+    uint64_t bits = ctx->length * 8U;
+    uint32_t i;
+
+    ctx->block[ctx->block_length++] = 0x80;
+    if(ctx->block_length > SHA256_BLOCK_SIZE - 8U)
+    {
+        memset(&ctx->block[ctx->block_length], 0, SHA256_BLOCK_SIZE - ctx->block_length);
+        sha256_transform(ctx->state, ctx->block);
+        ctx->block_length = 0;
+    }
+    memset(&ctx->block[ctx->block_length], 0, SHA256_BLOCK_SIZE - 8U - ctx->block_length);
+    for(i = 0; i < 8; i++)
+    {
+        ctx->block[SHA256_BLOCK_SIZE - 1U - i] = (uint8_t)(bits >> (i * 8U));
+    }
+    sha256_transform(ctx->state, ctx->block);
+
+    for(i = 0; i < 8; i++)
+    {
+        digest[i * 4]     = (uint8_t)(ctx->state[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(ctx->state[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(ctx->state[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)(ctx->state[i]);
+    }
+}
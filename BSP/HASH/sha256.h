@@ -0,0 +1,37 @@
+/*!
+    \file       sha256.h
+    \brief      header file for portable software SHA-256
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Software SHA-256 context structure
+    - Incremental init/update/final function declarations
+    - Standard headers only; the host selftest (make -C HOST check) runs it
+      against the FIPS 180-4 vectors
+*/
+
+#ifndef __SHA256_H
+#define __SHA256_H
+#include <stdint.h>
+
+#define SHA256_BLOCK_SIZE           64U                                     /*!< SHA-256 block size in bytes */
+#define SHA256_DIGEST_SIZE          32U                                     /*!< SHA-256 digest size in bytes */
+
+/*!
+    \brief software SHA-256 context
+*/
+typedef struct
+{
+    uint32_t state[8];                                                      /*!< intermediate hash value */
+    uint64_t length;                                                        /*!< total message length in bytes */
+    uint8_t block[SHA256_BLOCK_SIZE];                                       /*!< buffered incomplete block */
+    uint32_t block_length;                                                  /*!< number of valid bytes in block */
+} sha256_context_struct;
+
+/* function declarations */
+void sha256_init(sha256_context_struct *ctx);                                           /*!< initialize software SHA-256 */
+void sha256_update(sha256_context_struct *ctx, const uint8_t *data, uint32_t length);   /*!< add message data */
+void sha256_final(sha256_context_struct *ctx, uint8_t digest[SHA256_DIGEST_SIZE]);      /*!< pad and output digest */
+#endif /* __SHA256_H */
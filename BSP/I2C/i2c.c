@@ -0,0 +1,675 @@
+/*!
+    \file       i2c.c
+    \brief      interrupt and DMA driven I2C master engine
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - I2C0 master at 100 kHz, 400 kHz or 1 MHz Fast-mode Plus
+    - Queued multi-segment transactions run from interrupts and DMA
+    - Transfers longer than 255 bytes through byte counter reload
+    - Bus and clock stretch timeouts from the I2C timeout unit
+    - Bus recovery of a slave holding SDA low
+    - Transaction statistics and bus utilisation
+*/
+
+#include <string.h>
+#include "gd32h7xx_libopt.h"
+#include "./I2C/i2c.h"
+#include "./PINCFG/pincfg.h"
+#include "./CLOCK/clock.h"
+#include "./TIMER/timer.h"
+#include "./IDLE/idle.h"
+
+#define I2C_MASTER_CHUNK            255U                                    /* BYTENUM limit per reload */
+#define I2C_MASTER_TIMING_CLOCK     64000000U                               /* kernel clock the timing table is made for */
+
+/*!
+    \brief I2C timing register fields for one bus speed
+*/
+typedef struct
+{
+    uint32_t speed_hz;                                                      /* SCL frequency */
+    uint8_t psc;                                                            /* timing prescaler */
+    uint8_t scl_dely;                                                       /* data setup time */
+    uint8_t sda_dely;                                                       /* data hold time */
+    uint8_t sclh;                                                           /* SCL high period */
+    uint8_t scll;                                                           /* SCL low period */
+} i2c_master_timing_struct;
+
+/* 64 MHz kernel clock: tSCLL/tSCLH above the I2C minimums with 100 ns rise time */
+static const i2c_master_timing_struct s_i2c_timing[] =
+{
+    {100000U,  15U, 4U, 2U, 15U, 19U},                                      /* 250 ns tick, 5.0 us low, 4.0 us high */
+    {400000U,  7U,  3U, 2U, 4U,  10U},                                      /* 125 ns tick, 1.375 us low, 0.625 us high */
+    {1000000U, 3U,  1U, 0U, 4U,  8U}                                        /* 62.5 ns tick, 0.5625 us low, 0.3125 us high */
+};
+
+typedef char i2c_pins_check[PINCFG_VALID(I2C_MASTER_PINS) ? 1 : -1];
+#if PINCFG_OWN(PINCFG_BOARD_I2C_MASTER)
+static const pincfg_port_struct s_i2c_pins = PINCFG_PORT(I2C_MASTER_PINS, I2C_MASTER_GPIO_PORT, I2C_MASTER_GPIO_RCU);
+#endif /* PINCFG_OWN(PINCFG_BOARD_I2C_MASTER) */
+
+static i2c_xfer_struct *s_i2c_head = NULL;                                  /* transaction on the bus or next to start */
+static i2c_xfer_struct *s_i2c_tail = NULL;                                  /* last queued transaction */
+static volatile uint8_t s_i2c_active = 0;                                   /* 1: the head transaction is on the bus */
+static uint8_t s_i2c_seg = 0;                                               /* current segment of the head transaction */
+static uint32_t s_i2c_left = 0;                                             /* bytes of the segment not yet given to BYTENUM */
+static uint8_t s_i2c_result = I2C_XFER_OK;                                  /* result reported at the STOP */
+static uint32_t s_i2c_start_us = 0;                                         /* monotonic time the head transaction started */
+static uint32_t s_i2c_load_mark_us = 0;                                     /* monotonic time of the last load reading */
+static uint64_t s_i2c_load_mark_busy = 0;                                   /* busy time at the last load reading */
+static i2c_master_stats_struct s_i2c_stats;                                 /* statistics */
+static idle_constraint_struct s_i2c_idle_constraint = {0, NULL};            /* sleep only while a transaction runs */
+
+/*!
+    \brief      busy-wait on the monotonic timebase
+    \param[in]  us: microseconds
+    \param[out] none
+    \retval     none
+*/
+static void i2c_master_delay_us(uint32_t us)
+{
+    uint32_t start = timer_monotonic_us();
+
+    while((timer_monotonic_us() - start) < us)
+    {
+    }
+}
+
+/*!
+    \brief      point the DMA at the current segment
+    \param[in]  seg: segment about to be transferred
+    \param[out] none
+    \retval     none
+    \note       One channel per direction stays routed to the I2C, only the
+                buffer, length and the I2C DMA request change per segment.
+*/
+static void i2c_master_seg_arm(const i2c_seg_struct *seg)
+{
+    dma_channel_enum channel;
+
+    I2C_CTL0(I2C_MASTER) &= ~(I2C_CTL0_DENT | I2C_CTL0_DENR);
+    if(seg->length == 0U)
+    {
+        return;
+    }
+
+    if(seg->flags & I2C_SEG_READ)
+    {
+        channel = I2C_MASTER_DMA_RX_CHANNEL;
+        SCB_CleanInvalidateDCache_by_Addr(seg->buf, (int32_t)seg->length);
+    }
+    else
+    {
+        channel = I2C_MASTER_DMA_TX_CHANNEL;
+        SCB_CleanDCache_by_Addr(seg->buf, (int32_t)seg->length);
+    }
+
+    dma_channel_disable(I2C_MASTER_DMA, channel);
+    dma_flag_clear(I2C_MASTER_DMA, channel, DMA_FLAG_FEE | DMA_FLAG_SDE | DMA_FLAG_TAE | DMA_FLAG_HTF | DMA_FLAG_FTF);
+    dma_memory_address_config(I2C_MASTER_DMA, channel, DMA_MEMORY_0, (uint32_t)seg->buf);
+    dma_transfer_number_config(I2C_MASTER_DMA, channel, seg->length);
+    dma_channel_enable(I2C_MASTER_DMA, channel);
+    I2C_CTL0(I2C_MASTER) |= (seg->flags & I2C_SEG_READ) ? I2C_CTL0_DENR : I2C_CTL0_DENT;
+}
+
+/*!
+    \brief      hand the next chunk of the current segment to the byte counter
+    \param[in]  start: 1 to generate a (repeated) START, 0 after a reload
+    \param[out] none
+    \retval     none
+    \note       RELOAD stays set while bytes of this segment or a following
+                I2C_SEG_NOSTART segment remain, so those continue on TCR
+                without a START; otherwise TC ends the segment.
+*/
+static void i2c_master_chunk(uint8_t start)
+{
+    const i2c_xfer_struct *xfer = s_i2c_head;
+    const i2c_seg_struct *seg = &xfer->segs[s_i2c_seg];
+    uint32_t count, ctl1;
+
+    count = (s_i2c_left > I2C_MASTER_CHUNK) ? I2C_MASTER_CHUNK : s_i2c_left;
+    s_i2c_left -= count;
+
+    ctl1 = I2C_CTL1(I2C_MASTER) & ~(I2C_CTL1_SADDRESS | I2C_CTL1_TRDIR | I2C_CTL1_ADD10EN | I2C_CTL1_BYTENUM | \
+                                    I2C_CTL1_RELOAD | I2C_CTL1_AUTOEND | I2C_CTL1_START | I2C_CTL1_STOP);
+    ctl1 |= ((uint32_t)xfer->address << 1) | (count << 16);
+    if(seg->flags & I2C_SEG_READ)
+    {
+        ctl1 |= I2C_CTL1_TRDIR;
+    }
+    if((s_i2c_left > 0U) || \
+       (((s_i2c_seg + 1U) < xfer->seg_count) && (xfer->segs[s_i2c_seg + 1U].flags & I2C_SEG_NOSTART)))
+    {
+        ctl1 |= I2C_CTL1_RELOAD;
+    }
+    if(start)
+    {
+        ctl1 |= I2C_CTL1_START;
+    }
+    I2C_CTL1(I2C_MASTER) = ctl1;
+}
+
+/*!
+    \brief      move on to the next segment of the head transaction
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void i2c_master_seg_next(void)
+{
+    const i2c_seg_struct *seg;
+
+    s_i2c_seg++;
+    seg = &s_i2c_head->segs[s_i2c_seg];
+    s_i2c_left = seg->length;
+    i2c_master_seg_arm(seg);
+}
+
+/*!
+    \brief      check the bus is idle and put the head transaction on it
+    \param[in]  none
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if started, ERROR if the bus could not be recovered
+*/
+static ErrStatus i2c_master_start(void)
+{
+    const i2c_seg_struct *seg = &s_i2c_head->segs[0];
+
+    if((RESET != i2c_flag_get(I2C_MASTER, I2C_FLAG_I2CBSY)) || \
+       (RESET == gpio_input_bit_get(I2C_MASTER_GPIO_PORT, I2C_MASTER_SDA_PIN)))
+    {
+        if(ERROR == i2c_master_bus_recover())
+        {
+            return ERROR;
+        }
+    }
+
+    s_i2c_active = 1;
+    s_i2c_start_us = timer_monotonic_us();
+    s_i2c_result = I2C_XFER_OK;
+    s_i2c_seg = 0;
+    s_i2c_left = seg->length;
+    idle_constraint_register(&s_i2c_idle_constraint);
+    i2c_master_seg_arm(seg);
+    i2c_master_chunk(1);
+    return SUCCESS;
+}
+
+/*!
+    \brief      remove the head transaction from the queue and notify its owner
+    \param[in]  result: transaction result (i2c_xfer_status_enum)
+    \param[out] none
+    \retval     none
+*/
+static void i2c_master_complete(uint8_t result)
+{
+    i2c_xfer_struct *xfer = s_i2c_head;
+    uint32_t primask;
+    uint8_t i;
+
+    I2C_CTL0(I2C_MASTER) &= ~(I2C_CTL0_DENT | I2C_CTL0_DENR);
+    dma_channel_disable(I2C_MASTER_DMA, I2C_MASTER_DMA_TX_CHANNEL);
+    dma_channel_disable(I2C_MASTER_DMA, I2C_MASTER_DMA_RX_CHANNEL);
+    I2C_STAT(I2C_MASTER) |= I2C_STAT_TBE;                                   /* flush a byte left by a NACK */
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(s_i2c_active)
+    {
+        s_i2c_active = 0;
+        s_i2c_stats.busy_us += timer_monotonic_us() - s_i2c_start_us;
+        idle_constraint_unregister(&s_i2c_idle_constraint);
+    }
+    s_i2c_head = xfer->next;
+    if(s_i2c_head == NULL)
+    {
+        s_i2c_tail = NULL;
+    }
+    __set_PRIMASK(primask);
+
+    /* drop lines prefetched while the DMA was writing, before the owner reads them */
+    for(i = 0; i < xfer->seg_count; i++)
+    {
+        if((xfer->segs[i].flags & I2C_SEG_READ) && (xfer->segs[i].length > 0U))
+        {
+            SCB_InvalidateDCache_by_Addr(xfer->segs[i].buf, (int32_t)xfer->segs[i].length);
+        }
+    }
+
+    s_i2c_stats.transfers++;
+    switch(result)
+    {
+        case I2C_XFER_OK:
+            for(i = 0; i < xfer->seg_count; i++)
+            {
+                s_i2c_stats.bytes += xfer->segs[i].length;
+            }
+            break;
+        case I2C_XFER_NACK:
+            s_i2c_stats.nacks++;
+            break;
+        case I2C_XFER_ARBLOST:
+            s_i2c_stats.arb_lost++;
+            break;
+        case I2C_XFER_TIMEOUT:
+            s_i2c_stats.timeouts++;
+            break;
+        default:
+            s_i2c_stats.bus_errors++;
+            break;
+    }
+
+    xfer->status = result;
+    if(xfer->callback != NULL)
+    {
+        xfer->callback(xfer, xfer->callback_arg);
+    }
+}
+
+/*!
+    \brief      start queued transactions until one is on the bus
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void i2c_master_kick(void)
+{
+    while((s_i2c_head != NULL) && !s_i2c_active)
+    {
+        if(SUCCESS == i2c_master_start())
+        {
+            return;                                                         /* continued in I2C_MASTER_EV_IRQHandler */
+        }
+        i2c_master_complete(I2C_XFER_BUSERR);
+    }
+}
+
+/*!
+    \brief      configure I2C0 as master
+    \param[in]  speed_hz: 100000, 400000 or 1000000 (Fast-mode Plus)
+    \param[out] none
+    \retval     ErrStatus: SUCCESS, or ERROR for an unsupported speed
+    \note       The kernel clock is CK_IRC64MDIV, so bus timing does not follow
+                DVFS changes of APB1. Call after timer_monotonic_config.
+*/
+ErrStatus i2c_master_init(uint32_t speed_hz)
+{
+    const i2c_master_timing_struct *timing = NULL;
+    dma_single_data_parameter_struct dma_init_struct;
+    uint32_t ck_i2c, psc, i;
+
+    for(i = 0; i < sizeof(s_i2c_timing) / sizeof(s_i2c_timing[0]); i++)
+    {
+        if(s_i2c_timing[i].speed_hz == speed_hz)
+        {
+            timing = &s_i2c_timing[i];
+        }
+    }
+    if(timing == NULL)
+    {
+        return ERROR;
+    }
+
+    /* rescale the prescaler if IRC64M runs divided */
+    rcu_i2c_clock_config(I2C_MASTER_IDX, RCU_I2CSRC_IRC64MDIV);
+    ck_i2c = clock_freq_get(CLOCK_IRC64MDIV);
+    psc = (((uint32_t)timing->psc + 1U) * (ck_i2c / 1000000U) + (I2C_MASTER_TIMING_CLOCK / 2000000U)) / (I2C_MASTER_TIMING_CLOCK / 1000000U);
+    if((psc == 0U) || (psc > 16U))
+    {
+        return ERROR;
+    }
+
+    rcu_periph_clock_enable(I2C_MASTER_RCU);
+    rcu_periph_clock_enable(RCU_SYSCFG);
+    rcu_periph_clock_enable(I2C_MASTER_DMA_CLOCK);
+    rcu_periph_clock_enable(RCU_DMAMUX);
+
+    /* open-drain alternate function, recovery switches the same pins to GPIO and drives them high when released */
+#if PINCFG_OWN(PINCFG_BOARD_I2C_MASTER)
+    pincfg_apply(&s_i2c_pins, 1U);
+#endif /* PINCFG_OWN(PINCFG_BOARD_I2C_MASTER) */
+    gpio_bit_set(I2C_MASTER_GPIO_PORT, I2C_MASTER_SCL_PIN | I2C_MASTER_SDA_PIN);
+
+    i2c_deinit(I2C_MASTER);
+    i2c_timing_config(I2C_MASTER, psc - 1U, timing->scl_dely, timing->sda_dely);
+    i2c_master_clock_config(I2C_MASTER, timing->sclh, timing->scll);
+    if(speed_hz > 400000U)
+    {
+        syscfg_i2c_fast_mode_plus_enable(I2C_MASTER_FMP);
+    }
+    else
+    {
+        syscfg_i2c_fast_mode_plus_disable(I2C_MASTER_FMP);
+    }
+
+    /* bus timeout A on SCL low, timeout B on cumulative master stretch, 2048 kernel clocks per step */
+    i2c_idle_clock_timeout_config(I2C_MASTER, BUSTOA_DETECT_SCL_LOW);
+    i2c_bus_timeout_a_config(I2C_MASTER, I2C_MASTER_TIMEOUT_US * (ck_i2c / 1000000U) / 2048U - 1U);
+    i2c_bus_timeout_b_config(I2C_MASTER, I2C_MASTER_STRETCH_US * (ck_i2c / 1000000U) / 2048U - 1U);
+    i2c_clock_timeout_enable(I2C_MASTER);
+    i2c_extented_clock_timeout_enable(I2C_MASTER);
+
+    dma_deinit(I2C_MASTER_DMA, I2C_MASTER_DMA_TX_CHANNEL);
+    dma_init_struct.request             = DMA_REQUEST_I2C0_TX;
+    dma_init_struct.periph_addr         = I2C_MASTER_TD_ADDRESS;
+    dma_init_struct.memory0_addr        = 0;
+    dma_init_struct.number              = 0;
+    dma_init_struct.periph_inc          = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc          = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.periph_memory_width = DMA_PERIPH_WIDTH_8BIT;
+    dma_init_struct.direction           = DMA_MEMORY_TO_PERIPH;
+    dma_init_struct.priority            = DMA_PRIORITY_MEDIUM;
+    dma_init_struct.circular_mode       = DMA_CIRCULAR_MODE_DISABLE;
+    dma_single_data_mode_init(I2C_MASTER_DMA, I2C_MASTER_DMA_TX_CHANNEL, &dma_init_struct);
+
+    dma_deinit(I2C_MASTER_DMA, I2C_MASTER_DMA_RX_CHANNEL);
+    dma_init_struct.request             = DMA_REQUEST_I2C0_RX;
+    dma_init_struct.periph_addr         = I2C_MASTER_RD_ADDRESS;
+    dma_init_struct.direction           = DMA_PERIPH_TO_MEMORY;
+    dma_single_data_mode_init(I2C_MASTER_DMA, I2C_MASTER_DMA_RX_CHANNEL, &dma_init_struct);
+
+    s_i2c_head = NULL;
+    s_i2c_tail = NULL;
+    s_i2c_active = 0;
+    memset(&s_i2c_stats, 0, sizeof(s_i2c_stats));
+    s_i2c_load_mark_us = timer_monotonic_us();
+    s_i2c_load_mark_busy = 0;
+
+    i2c_interrupt_enable(I2C_MASTER, I2C_INT_ERR | I2C_INT_TC | I2C_INT_STPDET | I2C_INT_NACK);
+    nvic_irq_enable(I2C_MASTER_EV_IRQ, I2C_MASTER_IRQ_PRIORITY, 0);
+    nvic_irq_enable(I2C_MASTER_ER_IRQ, I2C_MASTER_IRQ_PRIORITY, 0);
+    i2c_enable(I2C_MASTER);
+
+    if(RESET == gpio_input_bit_get(I2C_MASTER_GPIO_PORT, I2C_MASTER_SDA_PIN))
+    {
+        i2c_master_bus_recover();
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      queue an I2C transaction
+    \param[in]  xfer: descriptor with address, segs, seg_count, callback and
+                callback_arg filled in
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if queued, ERROR if the descriptor is invalid
+    \note       Transactions run in order. Each segment starts with a repeated
+                START unless flagged I2C_SEG_NOSTART, which continues the previous
+                segment in the same direction; a STOP ends the transaction. The
+                descriptor, segments and buffers must stay valid until the status
+                leaves I2C_XFER_BUSY. Read buffers start on a cache line
+                (I2C_MASTER_RX_ALIGN) and nothing else may share the lines they
+                span, which are invalidated when the transaction completes.
+                While a transaction runs, idle is limited to sleep so the DMA
+                and I2C clocks keep running.
+*/
+ErrStatus i2c_master_submit(i2c_xfer_struct *xfer)
+{
+    uint32_t primask;
+    uint8_t i, idle;
+
+    if((xfer->segs == NULL) || (xfer->seg_count == 0U) || (xfer->address > 0x7FU))
+    {
+        return ERROR;
+    }
+    for(i = 0; i < xfer->seg_count; i++)
+    {
+        if(xfer->segs[i].length == 0U)
+        {
+            /* only a lone write may be empty, for address probing */
+            if((xfer->seg_count != 1U) || (xfer->segs[i].flags & I2C_SEG_READ))
+            {
+                return ERROR;
+            }
+            continue;
+        }
+        if((xfer->segs[i].buf == NULL) || \
+           ((xfer->segs[i].flags & I2C_SEG_READ) && ((uint32_t)xfer->segs[i].buf & (I2C_MASTER_RX_ALIGN - 1U))))
+        {
+            return ERROR;
+        }
+        if((xfer->segs[i].flags & I2C_SEG_NOSTART) && \
+           ((i == 0U) || ((xfer->segs[i].flags ^ xfer->segs[i - 1U].flags) & I2C_SEG_READ)))
+        {
+            return ERROR;
+        }
+    }
+
+    xfer->status = I2C_XFER_BUSY;
+    xfer->next = NULL;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    idle = (s_i2c_head == NULL) ? 1 : 0;
+    if(idle)
+    {
+        s_i2c_head = xfer;
+    }
+    else
+    {
+        s_i2c_tail->next = xfer;
+    }
+    s_i2c_tail = xfer;
+    __set_PRIMASK(primask);
+
+    /* a busy queue is restarted from the interrupt that completes its head */
+    if(idle)
+    {
+        i2c_master_kick();
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      wait for a queued transaction to complete
+    \param[in]  xfer: descriptor
+    \param[out] none
+    \retval     transaction result (i2c_xfer_status_enum)
+*/
+uint8_t i2c_master_wait(i2c_xfer_struct *xfer)
+{
+    while(xfer->status == I2C_XFER_BUSY)
+    {
+    }
+    return xfer->status;
+}
+
+/*!
+    \brief      release a bus held by a slave
+    \param[in]  none
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if SDA is high afterwards
+    \note       A slave reset in the middle of a read keeps driving SDA low.
+                Up to nine SCL pulses let it shift out the byte and see a NACK,
+                then a STOP returns the bus to idle. The I2C is disabled
+                meanwhile, which also clears its internal busy state.
+*/
+ErrStatus i2c_master_bus_recover(void)
+{
+    uint32_t i;
+    FlagStatus sda;
+
+    i2c_disable(I2C_MASTER);
+    gpio_bit_set(I2C_MASTER_GPIO_PORT, I2C_MASTER_SCL_PIN | I2C_MASTER_SDA_PIN);
+    gpio_mode_set(I2C_MASTER_GPIO_PORT, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLUP, I2C_MASTER_SCL_PIN | I2C_MASTER_SDA_PIN);
+    i2c_master_delay_us(I2C_MASTER_RECOVER_HALF_US);
+
+    for(i = 0; (i < I2C_MASTER_RECOVER_CLOCKS) && \
+               (RESET == gpio_input_bit_get(I2C_MASTER_GPIO_PORT, I2C_MASTER_SDA_PIN)); i++)
+    {
+        gpio_bit_reset(I2C_MASTER_GPIO_PORT, I2C_MASTER_SCL_PIN);
+        i2c_master_delay_us(I2C_MASTER_RECOVER_HALF_US);
+        gpio_bit_set(I2C_MASTER_GPIO_PORT, I2C_MASTER_SCL_PIN);
+        i2c_master_delay_us(I2C_MASTER_RECOVER_HALF_US);
+    }
+
+    /* STOP: SDA rises while SCL is high */
+    gpio_bit_reset(I2C_MASTER_GPIO_PORT, I2C_MASTER_SCL_PIN);
+    i2c_master_delay_us(I2C_MASTER_RECOVER_HALF_US);
+    gpio_bit_reset(I2C_MASTER_GPIO_PORT, I2C_MASTER_SDA_PIN);
+    i2c_master_delay_us(I2C_MASTER_RECOVER_HALF_US);
+    gpio_bit_set(I2C_MASTER_GPIO_PORT, I2C_MASTER_SCL_PIN);
+    i2c_master_delay_us(I2C_MASTER_RECOVER_HALF_US);
+    gpio_bit_set(I2C_MASTER_GPIO_PORT, I2C_MASTER_SDA_PIN);
+    i2c_master_delay_us(I2C_MASTER_RECOVER_HALF_US);
+    sda = gpio_input_bit_get(I2C_MASTER_GPIO_PORT, I2C_MASTER_SDA_PIN);
+
+    gpio_mode_set(I2C_MASTER_GPIO_PORT, GPIO_MODE_AF, GPIO_PUPD_PULLUP, I2C_MASTER_SCL_PIN | I2C_MASTER_SDA_PIN);
+    i2c_enable(I2C_MASTER);
+    s_i2c_stats.recoveries++;
+    return (sda == SET) ? SUCCESS : ERROR;
+}
+
+/*!
+    \brief      copy I2C master statistics
+    \param[in]  none
+    \param[out] stats: statistics
+    \retval     none
+*/
+void i2c_master_stats_get(i2c_master_stats_struct *stats)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = s_i2c_stats;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      get the bus utilisation since the previous call
+    \param[in]  none
+    \param[out] none
+    \retval     share of time with a transaction on the bus, in permille
+    \note       Includes the elapsed part of a transaction still running.
+*/
+uint32_t i2c_master_load_get(void)
+{
+    uint32_t primask, now, elapsed;
+    uint64_t busy, delta;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    now = timer_monotonic_us();
+    busy = s_i2c_stats.busy_us;
+    if(s_i2c_active)
+    {
+        busy += now - s_i2c_start_us;
+    }
+    elapsed = now - s_i2c_load_mark_us;
+    delta = busy - s_i2c_load_mark_busy;
+    s_i2c_load_mark_us = now;
+    s_i2c_load_mark_busy = busy;
+    __set_PRIMASK(primask);
+
+    if(elapsed == 0U)
+    {
+        return 0;
+    }
+    return (delta >= elapsed) ? 1000U : (uint32_t)((delta * 1000U) / elapsed);
+}
+
+/*!
+    \brief      I2C event interrupt handler, advances the head transaction
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       TCR continues a segment past 255 bytes or into a NOSTART
+                segment, TC ends a segment with a repeated START or the final
+                STOP, and STPDET completes the transaction. A NACK makes the
+                hardware send the STOP by itself.
+*/
+void I2C_MASTER_EV_IRQHandler(void)
+{
+    uint32_t stat = I2C_STAT(I2C_MASTER);
+
+    if(stat & I2C_STAT_NACK)
+    {
+        I2C_STATC(I2C_MASTER) = I2C_STATC_NACKC;
+        if(s_i2c_result == I2C_XFER_OK)
+        {
+            s_i2c_result = I2C_XFER_NACK;
+        }
+    }
+
+    if(s_i2c_active && (stat & I2C_STAT_TCR))
+    {
+        if(s_i2c_left == 0U)
+        {
+            i2c_master_seg_next();
+        }
+        i2c_master_chunk(0);
+    }
+    else if(s_i2c_active && (stat & I2C_STAT_TC))
+    {
+        if((s_i2c_seg + 1U) < s_i2c_head->seg_count)
+        {
+            i2c_master_seg_next();
+            i2c_master_chunk(1);
+        }
+        else
+        {
+            I2C_CTL1(I2C_MASTER) |= I2C_CTL1_STOP;
+        }
+    }
+
+    if(stat & I2C_STAT_STPDET)
+    {
+        I2C_STATC(I2C_MASTER) = I2C_STATC_STPDETC;
+        if(s_i2c_active)
+        {
+            i2c_master_complete(s_i2c_result);
+            i2c_master_kick();
+        }
+    }
+}
+
+/*!
+    \brief      I2C error interrupt handler, aborts the head transaction
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       A bus timeout means SCL was held low beyond I2C_MASTER_TIMEOUT_US
+                or the byte stretch limit, by a slave or by a stalled DMA. After
+                a bus error or timeout the bus is recovered before the next
+                transaction starts.
+*/
+void I2C_MASTER_ER_IRQHandler(void)
+{
+    uint32_t stat = I2C_STAT(I2C_MASTER);
+    uint8_t result;
+
+    I2C_STATC(I2C_MASTER) = I2C_STATC_BERRC | I2C_STATC_LOSTARBC | I2C_STATC_TIMEOUTC | I2C_STATC_OUERRC | I2C_STATC_PECERRC;
+    if(stat & I2C_STAT_TIMEOUT)
+    {
+        result = I2C_XFER_TIMEOUT;
+    }
+    else if(stat & I2C_STAT_LOSTARB)
+    {
+        result = I2C_XFER_ARBLOST;
+    }
+    else
+    {
+        result = I2C_XFER_BUSERR;
+    }
+
+    /* disabling the I2C resets its state machine and releases SCL and SDA */
+    if(result == I2C_XFER_ARBLOST)
+    {
+        i2c_disable(I2C_MASTER);
+        i2c_master_delay_us(1);
+        i2c_enable(I2C_MASTER);
+    }
+    else
+    {
+        i2c_master_bus_recover();
+    }
+    if(s_i2c_active)
+    {
+        i2c_master_complete(result);
+        i2c_master_kick();
+    }
+}
@@ -0,0 +1,128 @@
+/*!
+    \file       i2c.h
+    \brief      header file for interrupt and DMA driven I2C master engine
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - I2C0 master pin, DMA and timeout configuration macros
+    - Multi-segment transaction descriptors (write register then read)
+    - Transaction queue executed from interrupts and DMA
+    - Bus recovery, statistics and bus utilisation
+    - Function declarations for the asynchronous I2C master
+*/
+
+#ifndef __I2C_H
+#define __I2C_H
+#include <stdint.h>
+#include <stddef.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief I2C0 master configuration macros
+*/
+#define I2C_MASTER                  I2C0                                    /*!< I2C peripheral */
+#define I2C_MASTER_RCU              RCU_I2C0                                /*!< I2C peripheral clock */
+#define I2C_MASTER_IDX              IDX_I2C0                                /*!< I2C kernel clock index */
+#define I2C_MASTER_EV_IRQ           I2C0_EV_IRQn                            /*!< I2C event interrupt */
+#define I2C_MASTER_ER_IRQ           I2C0_ER_IRQn                            /*!< I2C error interrupt */
+#define I2C_MASTER_EV_IRQHandler    I2C0_EV_IRQHandler                      /*!< I2C event interrupt handler */
+#define I2C_MASTER_ER_IRQHandler    I2C0_ER_IRQHandler                      /*!< I2C error interrupt handler */
+#define I2C_MASTER_IRQ_PRIORITY     2U                                      /*!< I2C interrupt priority */
+#define I2C_MASTER_FMP              (SYSCFG_I2C0_FMP | SYSCFG_I2C_FMP_PB6 | SYSCFG_I2C_FMP_PB7) /*!< Fast-mode Plus drive */
+
+#define I2C_MASTER_GPIO_RCU         RCU_GPIOB                               /*!< SCL/SDA port clock */
+#define I2C_MASTER_GPIO_PORT        GPIOB                                   /*!< SCL/SDA port */
+#define I2C_MASTER_GPIO_AF          GPIO_AF_4                               /*!< I2C0 alternate function */
+#define I2C_MASTER_SCL_PIN          GPIO_PIN_6                              /*!< SCL pin */
+#define I2C_MASTER_SDA_PIN          GPIO_PIN_7                              /*!< SDA pin */
+
+/* SCL and SDA as PINCFG table rows: open-drain alternate function, recovery switches them to GPIO */
+#define I2C_MASTER_PINS(PIN, x) \
+    PIN(x, I2C_MASTER_GPIO_PORT, PINCFG_PIN(I2C_MASTER_SCL_PIN), GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_OTYPE_OD, GPIO_OSPEED_12MHZ, I2C_MASTER_GPIO_AF) \
+    PIN(x, I2C_MASTER_GPIO_PORT, PINCFG_PIN(I2C_MASTER_SDA_PIN), GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_OTYPE_OD, GPIO_OSPEED_12MHZ, I2C_MASTER_GPIO_AF)
+
+#define I2C_MASTER_DMA              DMA1                                    /*!< DMA controller for I2C */
+#define I2C_MASTER_DMA_CLOCK        RCU_DMA1                                /*!< DMA clock for I2C */
+#define I2C_MASTER_DMA_TX_CHANNEL   DMA_CH4                                 /*!< DMA channel feeding I2C_TDATA */
+#define I2C_MASTER_DMA_RX_CHANNEL   DMA_CH5                                 /*!< DMA channel draining I2C_RDATA */
+#define I2C_MASTER_TD_ADDRESS       (I2C0 + 0x28U)                          /*!< I2C transmit data register address */
+#define I2C_MASTER_RD_ADDRESS       (I2C0 + 0x24U)                          /*!< I2C receive data register address */
+#define I2C_MASTER_RX_ALIGN         32U                                     /*!< read buffer alignment, one D-cache line */
+
+#define I2C_MASTER_TIMEOUT_US       25000U                                  /*!< SCL held low longer than this aborts (bus timeout A) */
+#define I2C_MASTER_STRETCH_US       10000U                                  /*!< cumulative master stretch per byte (bus timeout B) */
+#define I2C_MASTER_RECOVER_CLOCKS   9U                                      /*!< SCL pulses to release a stuck slave */
+#define I2C_MASTER_RECOVER_HALF_US  5U                                      /*!< half SCL period during recovery, 100 kHz */
+
+/* segment flags */
+#define I2C_SEG_WRITE               0x00U                                   /*!< master transmits buf */
+#define I2C_SEG_READ                0x01U                                   /*!< master receives into buf */
+#define I2C_SEG_NOSTART             0x02U                                   /*!< continue the previous segment without a repeated START */
+
+/*!
+    \brief transaction result
+*/
+typedef enum
+{
+    I2C_XFER_OK = 0,                                                        /*!< all segments transferred */
+    I2C_XFER_BUSY,                                                          /*!< queued or in progress */
+    I2C_XFER_NACK,                                                          /*!< address or data not acknowledged */
+    I2C_XFER_ARBLOST,                                                       /*!< arbitration lost */
+    I2C_XFER_BUSERR,                                                        /*!< misplaced START/STOP or stuck bus */
+    I2C_XFER_TIMEOUT                                                        /*!< SCL held low beyond the bus timeout */
+} i2c_xfer_status_enum;
+
+/*!
+    \brief transaction segment, one direction between two (repeated) STARTs
+*/
+typedef struct
+{
+    uint8_t *buf;                                                           /*!< data, I2C_MASTER_RX_ALIGN aligned for reads */
+    uint16_t length;                                                        /*!< bytes, 0 only for a single write (address probe) */
+    uint8_t flags;                                                          /*!< I2C_SEG_WRITE or I2C_SEG_READ, optionally I2C_SEG_NOSTART */
+} i2c_seg_struct;
+
+struct i2c_xfer;
+
+/*! transaction completion callback, called from the I2C interrupt */
+typedef void (*i2c_xfer_callback_fn)(struct i2c_xfer *xfer, void *arg);
+
+/*!
+    \brief transaction descriptor, filled by the caller before i2c_master_submit
+*/
+typedef struct i2c_xfer
+{
+    uint8_t address;                                                        /*!< 7-bit slave address */
+    uint8_t seg_count;                                                      /*!< number of segments */
+    const i2c_seg_struct *segs;                                             /*!< segments, executed in order */
+    volatile uint8_t status;                                                /*!< I2C_XFER_BUSY until done (i2c_xfer_status_enum) */
+    i2c_xfer_callback_fn callback;                                          /*!< completion callback, may be NULL */
+    void *callback_arg;                                                     /*!< user argument passed to callback */
+    struct i2c_xfer *next;                                                  /*!< queue link, managed by the driver */
+} i2c_xfer_struct;
+
+/*!
+    \brief I2C master statistics
+*/
+typedef struct
+{
+    uint32_t transfers;                                                     /*!< completed transactions */
+    uint32_t bytes;                                                         /*!< bytes of successful transactions */
+    uint32_t nacks;                                                         /*!< transactions ended by NACK */
+    uint32_t arb_lost;                                                      /*!< transactions ended by arbitration loss */
+    uint32_t bus_errors;                                                    /*!< transactions ended by bus error */
+    uint32_t timeouts;                                                      /*!< transactions ended by bus timeout */
+    uint32_t recoveries;                                                    /*!< bus recovery sequences */
+    uint64_t busy_us;                                                       /*!< total time with a transaction on the bus */
+} i2c_master_stats_struct;
+
+/* function declarations */
+ErrStatus i2c_master_init(uint32_t speed_hz);                                           /*!< configure I2C0 for 100 kHz, 400 kHz or 1 MHz */
+ErrStatus i2c_master_submit(i2c_xfer_struct *xfer);                                     /*!< queue a transaction */
+uint8_t i2c_master_wait(i2c_xfer_struct *xfer);                                         /*!< wait for a queued transaction */
+ErrStatus i2c_master_bus_recover(void);                                                 /*!< clock out a slave holding SDA low */
+void i2c_master_stats_get(i2c_master_stats_struct *stats);                              /*!< copy statistics */
+uint32_t i2c_master_load_get(void);                                                     /*!< bus utilisation in permille since the last call */
+#endif /* __I2C_H */
@@ -0,0 +1,508 @@
+/*!
+    \file       idle.c
+    \brief      low-power idle manager on PMU, RTC wakeup timer and DVFS
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Idle state selection from the next deadline and driver latency constraints
+    - WFI sleep, deep-sleep with clock restore and standby entry
+    - RTC wakeup timer programming and RTC based sleep time measurement
+    - Monotonic timebase and DVFS idle metering kept valid across deep-sleep
+    - Per-state residency and wakeup latency statistics, standby exit included
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./IDLE/idle.h"
+#include "./DVFS/dvfs.h"
+#include "./TIMER/timer.h"
+#include "./WALLCLOCK/wallclock.h"
+#include "./USART/usart.h"
+
+/* Deep-sleep exit restarts HXTAL and relocks PLL0..2, which takes about 2 ms
+   with a crystal; below 5 ms of idle the restart costs more than it saves.
+   Standby exit goes through reset and the C runtime start-up. The table holds
+   estimates; the selection uses the measured maximum once it is larger. */
+const idle_state_param_struct g_idle_state_table[IDLE_STATE_NUM] =
+{
+    {1U,     0U},                                                           /* sleep */
+    {2000U,  5000U},                                                        /* deep-sleep */
+    {10000U, 100000U}                                                       /* standby */
+};
+
+static idle_constraint_struct *s_idle_constraints = NULL;                   /* wakeup latency constraints */
+static uint8_t s_idle_standby_allowed = 0;                                  /* 1: standby may be selected */
+static idle_stats_struct s_idle_stats[IDLE_STATE_NUM];                      /* per-state statistics */
+static uint64_t s_idle_total_us = 0;                                        /* time covered by the statistics */
+static uint32_t s_idle_mark = 0;                                            /* timer_monotonic_us at the last accounting */
+
+/*!
+    \brief      arm the RTC wakeup timer
+    \param[in]  wake_us: time until the wakeup event, at most IDLE_LOWPOWER_MAX_US
+    \param[out] none
+    \retval     programmed time in microseconds
+*/
+static uint32_t idle_wakeup_start(uint32_t wake_us)
+{
+    uint32_t ticks;
+
+    ticks = (uint32_t)(((uint64_t)wake_us * (wallclock_rtc_hz() / 2U)) / 1000000U);
+    if(ticks == 0U)
+    {
+        ticks = 1U;
+    }
+    else if(ticks > 0x10000U)
+    {
+        ticks = 0x10000U;
+    }
+
+    rtc_wakeup_disable();
+    rtc_wakeup_timer_set((uint16_t)(ticks - 1U));
+    rtc_flag_clear(RTC_FLAG_WT);
+    exti_interrupt_flag_clear(IDLE_WAKEUP_EXTI);
+    rtc_interrupt_enable(RTC_INT_WAKEUP);
+    rtc_wakeup_enable();
+    return (uint32_t)(((uint64_t)ticks * 1000000U) / (wallclock_rtc_hz() / 2U));
+}
+
+/*!
+    \brief      disarm the RTC wakeup timer and drop its pending event
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void idle_wakeup_stop(void)
+{
+    rtc_wakeup_disable();
+    rtc_interrupt_disable(RTC_INT_WAKEUP);
+    rtc_flag_clear(RTC_FLAG_WT);
+    exti_interrupt_flag_clear(IDLE_WAKEUP_EXTI);
+    NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+}
+
+/*!
+    \brief      exit latency used for state selection
+    \param[in]  state: idle state (idle_state_enum)
+    \param[out] none
+    \retval     larger of the table estimate and the measured maximum
+*/
+static uint32_t idle_exit_latency(uint8_t state)
+{
+    uint32_t latency = g_idle_state_table[state].exit_latency_us;
+
+    return (s_idle_stats[state].max_latency_us > latency) ? s_idle_stats[state].max_latency_us : latency;
+}
+
+/*!
+    \brief      add one idle period to the statistics
+    \param[in]  state: idle state (idle_state_enum)
+    \param[in]  residency_us: time spent in the state
+    \param[in]  latency_us: measured wakeup latency, 0 if not measured
+    \param[out] none
+    \retval     none
+*/
+static void idle_stats_add(uint8_t state, uint32_t residency_us, uint32_t latency_us)
+{
+    idle_stats_struct *stats = &s_idle_stats[state];
+
+    stats->entries++;
+    stats->residency_us += residency_us;
+    if(latency_us != 0U)
+    {
+        stats->last_latency_us = latency_us;
+        if(latency_us > stats->max_latency_us)
+        {
+            stats->max_latency_us = latency_us;
+        }
+    }
+}
+
+/*!
+    \brief      deep-sleep until the deadline or an EXTI event
+    \param[in]  sleep_us: time until the next deadline
+    \param[out] latency_us: wakeup latency
+    \retval     time spent from entry to restored clocks in microseconds
+    \note       The wakeup timer fires one exit latency early so the clocks are
+                back at the deadline. When the timer woke the core, the latency is
+                measured on the RTC from the wakeup event, so oscillator start-up
+                is included; for other wakeup sources only the clock restore time
+                is known. The monotonic timer stops with the APB clocks and is
+                advanced by the RTC measured time.
+*/
+static uint32_t idle_deepsleep(uint32_t sleep_us, uint32_t *latency_us)
+{
+    uint32_t exit_us, wake_us, primask, pll, mono, rtc0, rtc1, elapsed, restore_us;
+    uint8_t woken_by_timer;
+
+    exit_us = idle_exit_latency(IDLE_STATE_DEEPSLEEP);
+    if(sleep_us > IDLE_LOWPOWER_MAX_US)
+    {
+        sleep_us = IDLE_LOWPOWER_MAX_US;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    pll = RCU_CTL & (RCU_CTL_PLL1EN | RCU_CTL_PLL2EN);
+    mono = timer_monotonic_us();
+    FWDGT_CTL = FWDGT_KEY_RELOAD;                                           /* TIMER16 stops feeding in deep-sleep */
+    wake_us = idle_wakeup_start((sleep_us > exit_us) ? (sleep_us - exit_us) : 0U);
+    rtc0 = wallclock_rtc_ticks();
+
+    pmu_to_deepsleepmode(WFI_CMD);
+
+    restore_us = 0;
+    dvfs_resume(&restore_us);
+    RCU_CTL |= pll;
+    while(((pll & RCU_CTL_PLL1EN) && (0U == (RCU_CTL & RCU_CTL_PLL1STB))) || \
+          ((pll & RCU_CTL_PLL2EN) && (0U == (RCU_CTL & RCU_CTL_PLL2STB))))
+    {
+    }
+    rtc1 = wallclock_rtc_ticks();
+    woken_by_timer = (RTC_STAT & RTC_STAT_WTF) ? 1 : 0;
+    idle_wakeup_stop();
+    FWDGT_CTL = FWDGT_KEY_RELOAD;
+
+    elapsed = wallclock_rtc_elapsed_us(rtc0, rtc1);
+    timer_monotonic_set(mono + elapsed);
+    __set_PRIMASK(primask);
+
+    if(woken_by_timer && (elapsed > wake_us))
+    {
+        *latency_us = elapsed - wake_us;
+    }
+    else
+    {
+        *latency_us = restore_us;
+    }
+    return elapsed;
+}
+
+/*!
+    \brief      enter standby until the deadline
+    \param[in]  sleep_us: time until the next deadline
+    \param[out] none
+    \retval     none, the core restarts through reset
+    \note       The entry time and the programmed sleep are kept in RTC_BKP0..2
+                so that idle_init can account the standby period after reset.
+*/
+static void idle_standby(uint32_t sleep_us)
+{
+    uint32_t exit_us;
+
+    exit_us = idle_exit_latency(IDLE_STATE_STANDBY);
+    if(sleep_us > IDLE_LOWPOWER_MAX_US)
+    {
+        sleep_us = IDLE_LOWPOWER_MAX_US;
+    }
+
+    __disable_irq();
+    FWDGT_CTL = FWDGT_KEY_RELOAD;
+    RTC_BKP2 = idle_wakeup_start((sleep_us > exit_us) ? (sleep_us - exit_us) : 0U);
+    RTC_BKP1 = wallclock_rtc_ticks();
+    RTC_BKP0 = IDLE_STANDBY_MAGIC;
+    pmu_flag_clear(PMU_FLAG_STANDBY);
+    pmu_to_standbymode();
+    while(1)
+    {
+    }
+}
+
+/*!
+    \brief      start the RTC and the wakeup timer path, account a standby exit
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The RTC is started by wallclock_rtc_init if needed. Call after
+                timer_monotonic_config and dvfs_init.
+*/
+void idle_init(void)
+{
+    uint32_t elapsed;
+    uint8_t i;
+
+    wallclock_rtc_init();
+    rtc_wakeup_disable();
+    rtc_wakeup_clock_set(WAKEUP_RTCCK_DIV2);
+    exti_init(IDLE_WAKEUP_EXTI, EXTI_INTERRUPT, EXTI_TRIG_RISING);
+    exti_interrupt_flag_clear(IDLE_WAKEUP_EXTI);
+    nvic_irq_enable(RTC_WKUP_IRQn, 3, 0);
+
+    for(i = 0; i < IDLE_STATE_NUM; i++)
+    {
+        s_idle_stats[i].entries = 0;
+        s_idle_stats[i].residency_us = 0;
+        s_idle_stats[i].last_latency_us = 0;
+        s_idle_stats[i].max_latency_us = 0;
+    }
+    s_idle_total_us = 0;
+    s_idle_mark = timer_monotonic_us();
+
+    /* standby exit: residency up to the wakeup event, latency up to here */
+    if((RTC_BKP0 == IDLE_STANDBY_MAGIC) && (SET == pmu_flag_get(PMU_FLAG_STANDBY)))
+    {
+        elapsed = wallclock_rtc_elapsed_us(RTC_BKP1, wallclock_rtc_ticks());
+        if(elapsed > RTC_BKP2)
+        {
+            idle_stats_add(IDLE_STATE_STANDBY, RTC_BKP2, elapsed - RTC_BKP2);
+        }
+        else
+        {
+            idle_stats_add(IDLE_STATE_STANDBY, elapsed, 0);
+        }
+        s_idle_total_us = s_idle_stats[IDLE_STATE_STANDBY].residency_us;
+    }
+    RTC_BKP0 = 0;
+    idle_wakeup_stop();
+    pmu_flag_clear(PMU_FLAG_STANDBY);
+    pmu_flag_clear(PMU_FLAG_WAKEUP);
+}
+
+/*!
+    \brief      add a wakeup latency constraint
+    \param[in]  constraint: constraint with max_latency_us set, must stay valid until unregistered
+    \param[out] none
+    \retval     none
+    \note       A driver with a transfer in progress registers 0 to keep the core
+                out of deep-sleep; max_latency_us may be changed while registered.
+*/
+void idle_constraint_register(idle_constraint_struct *constraint)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    constraint->next = s_idle_constraints;
+    s_idle_constraints = constraint;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      remove a wakeup latency constraint
+    \param[in]  constraint: registered constraint
+    \param[out] none
+    \retval     none
+*/
+void idle_constraint_unregister(idle_constraint_struct *constraint)
+{
+    idle_constraint_struct **link;
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for(link = &s_idle_constraints; *link != NULL; link = &(*link)->next)
+    {
+        if(*link == constraint)
+        {
+            *link = constraint->next;
+            constraint->next = NULL;
+            break;
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      get the tightest wakeup latency constraint
+    \param[in]  none
+    \param[out] none
+    \retval     smallest max_latency_us, IDLE_FOREVER if none is registered
+*/
+uint32_t idle_latency_limit(void)
+{
+    idle_constraint_struct *constraint;
+    uint32_t limit = IDLE_FOREVER;
+
+    for(constraint = s_idle_constraints; constraint != NULL; constraint = constraint->next)
+    {
+        if(constraint->max_latency_us < limit)
+        {
+            limit = constraint->max_latency_us;
+        }
+    }
+    return limit;
+}
+
+/*!
+    \brief      allow or forbid standby
+    \param[in]  allow: 1 to allow standby, 0 to forbid
+    \param[out] none
+    \retval     none
+    \note       Standby loses SRAM and register contents and restarts through
+                reset, so it is forbidden by default.
+*/
+void idle_standby_allow(uint8_t allow)
+{
+    s_idle_standby_allowed = allow ? 1 : 0;
+}
+
+/*!
+    \brief      select the deepest idle state for the next idle period
+    \param[in]  sleep_us: time until the next deadline, IDLE_FOREVER if none
+    \param[out] none
+    \retval     idle state (idle_state_enum)
+    \note       A state qualifies when its exit latency meets every constraint and
+                the idle period reaches its break-even residency. Deep-sleep also
+                needs a known DVFS operating point to restore.
+*/
+uint8_t idle_select(uint32_t sleep_us)
+{
+    uint32_t limit;
+    uint8_t state;
+
+    limit = idle_latency_limit();
+    for(state = IDLE_STATE_NUM - 1; state > IDLE_STATE_SLEEP; state--)
+    {
+        if((state == IDLE_STATE_STANDBY) && !s_idle_standby_allowed)
+        {
+            continue;
+        }
+        if((state == IDLE_STATE_DEEPSLEEP) && (dvfs_opp_get() >= DVFS_OPP_NUM))
+        {
+            continue;
+        }
+        if((idle_exit_latency(state) <= limit) && (sleep_us >= g_idle_state_table[state].min_residency_us))
+        {
+            break;
+        }
+    }
+    return state;
+}
+
+/*!
+    \brief      idle until the next deadline or an interrupt
+    \param[in]  sleep_us: time until the next deadline, IDLE_FOREVER if none
+    \param[out] none
+    \retval     idle state that was used (idle_state_enum)
+    \note       Call from the main loop or the RTOS idle hook with nothing left to
+                do. Sleep relies on the interrupt of the deadline itself; deep-sleep
+                arms the RTC wakeup timer and returns after at most
+                IDLE_LOWPOWER_MAX_US. Idle time is passed to the DVFS load meter.
+*/
+uint8_t idle_enter(uint32_t sleep_us)
+{
+    uint32_t primask, start, residency, latency = 0;
+    uint8_t state;
+
+    state = idle_select(sleep_us);
+    if(state == IDLE_STATE_STANDBY)
+    {
+        idle_standby(sleep_us);
+    }
+
+    if(state == IDLE_STATE_DEEPSLEEP)
+    {
+        residency = idle_deepsleep(sleep_us, &latency);
+    }
+    else
+    {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        start = timer_monotonic_us();
+        __DSB();
+        __WFI();
+        residency = timer_monotonic_us() - start;
+        __set_PRIMASK(primask);
+    }
+
+    idle_account(state, residency, latency);
+    return state;
+}
+
+/*!
+    \brief      account an idle period spent outside idle_enter
+    \param[in]  state: idle state (idle_state_enum)
+    \param[in]  residency_us: time spent in the state
+    \param[in]  latency_us: measured wakeup latency, 0 if not measured
+    \param[out] none
+    \retval     none
+    \note       For code that sleeps on its own, e.g. the RTOS tickless idle
+                with SysTick stretched over the idle period, so the statistics
+                and the DVFS load meter still see that time.
+*/
+void idle_account(uint8_t state, uint32_t residency_us, uint32_t latency_us)
+{
+    uint32_t primask, now;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    idle_stats_add(state, residency_us, latency_us);
+    now = timer_monotonic_us();
+    s_idle_total_us += now - s_idle_mark;
+    s_idle_mark = now;
+    __set_PRIMASK(primask);
+
+    dvfs_idle_account(residency_us);
+}
+
+/*!
+    \brief      copy the statistics of one idle state
+    \param[in]  state: idle state (idle_state_enum)
+    \param[out] stats: statistics
+    \retval     none
+*/
+void idle_stats_get(uint8_t state, idle_stats_struct *stats)
+{
+    uint32_t primask;
+
+    if(state >= IDLE_STATE_NUM)
+    {
+        return;
+    }
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = s_idle_stats[state];
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      print residency and wakeup latency of every idle state
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void idle_stats_print(void)
+{
+    static const char *names[IDLE_STATE_NUM] = {"sleep", "deepsleep", "standby"};
+    idle_stats_struct stats;
+    uint64_t total, idle = 0;
+    uint32_t primask, permille;
+    uint8_t i;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    total = s_idle_total_us + (timer_monotonic_us() - s_idle_mark);
+    __set_PRIMASK(primask);
+
+    PRINT_INFO("idle residency (%u ms observed)>>\r\n", (uint32_t)(total / 1000U));
+    PRINT_INFO("state\t\tentries\t\ttime ms\t\tshare %%\t\tlatency us (last/max)\r\n");
+    for(i = 0; i < IDLE_STATE_NUM; i++)
+    {
+        idle_stats_get(i, &stats);
+        idle += stats.residency_us;
+        permille = (total != 0U) ? (uint32_t)((stats.residency_us * 1000U) / total) : 0U;
+        PRINT_INFO("%s\t%s%u\t\t%u\t\t%u.%u\t\t%u/%u\r\n", names[i], (i == IDLE_STATE_DEEPSLEEP) ? "" : "\t", stats.entries,
+                   (uint32_t)(stats.residency_us / 1000U), permille / 10U, permille % 10U,
+                   stats.last_latency_us, stats.max_latency_us);
+    }
+    permille = ((total != 0U) && (idle < total)) ? (uint32_t)(((total - idle) * 1000U) / total) : 0U;
+    PRINT_INFO("active\t\t-\t\t%u\t\t%u.%u\r\n", (uint32_t)((total - ((idle < total) ? idle : total)) / 1000U),
+               permille / 10U, permille % 10U);
+}
+
+/*!
+    \brief      RTC wakeup interrupt handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       idle_deepsleep consumes the event itself; this only clears a
+                wakeup event that arrives after the core was woken otherwise.
+*/
+void RTC_WKUP_IRQHandler(void)
+{
+    if(RESET != rtc_flag_get(RTC_FLAG_WT))
+    {
+        rtc_flag_clear(RTC_FLAG_WT);
+    }
+    exti_interrupt_flag_clear(IDLE_WAKEUP_EXTI);
+}
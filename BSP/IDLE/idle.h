@@ -0,0 +1,81 @@
+/*!
+    \file       idle.h
+    \brief      header file for low-power idle manager
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Idle states (sleep, deep-sleep, standby) with exit latency and break-even residency
+    - Wakeup latency constraints declared by drivers
+    - RTC wakeup timer configuration for deep-sleep and standby
+    - Per-state residency and wakeup latency statistics
+*/
+
+#ifndef __IDLE_H
+#define __IDLE_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief idle states, ordered from shallowest to deepest
+*/
+typedef enum
+{
+    IDLE_STATE_SLEEP = 0,                                                   /*!< WFI, clocks running, wakes on any interrupt */
+    IDLE_STATE_DEEPSLEEP,                                                   /*!< pmu_to_deepsleepmode, PLLs and HXTAL stopped */
+    IDLE_STATE_STANDBY,                                                     /*!< pmu_to_standbymode, wakes through reset */
+    IDLE_STATE_NUM
+} idle_state_enum;
+
+/*!
+    \brief idle configuration macros
+*/
+#define IDLE_WAKEUP_EXTI            EXTI_19                                 /*!< EXTI line of the RTC wakeup event */
+#define IDLE_LOWPOWER_MAX_US        2000000U                                /*!< longest deep-sleep or standby, below the 5 s FWDGT timeout */
+#define IDLE_FOREVER                0xFFFFFFFFU                             /*!< no deadline / no latency constraint */
+#define IDLE_STANDBY_MAGIC          0x49444C45U                             /*!< RTC_BKP0 marker of a standby entry, RTC_BKP1..2 hold its times */
+
+/*!
+    \brief idle state parameters
+*/
+typedef struct
+{
+    uint32_t exit_latency_us;                                               /*!< worst-case wakeup latency estimate */
+    uint32_t min_residency_us;                                              /*!< shortest idle time that saves energy */
+} idle_state_param_struct;
+
+/*!
+    \brief wakeup latency constraint, linked into the constraint list
+*/
+typedef struct idle_constraint
+{
+    uint32_t max_latency_us;                                                /*!< longest acceptable wakeup latency */
+    struct idle_constraint *next;                                           /*!< next constraint, managed by idle */
+} idle_constraint_struct;
+
+/*!
+    \brief per-state statistics
+*/
+typedef struct
+{
+    uint32_t entries;                                                       /*!< times the state was entered */
+    uint64_t residency_us;                                                  /*!< total time spent in the state */
+    uint32_t last_latency_us;                                               /*!< last measured wakeup latency */
+    uint32_t max_latency_us;                                                /*!< longest measured wakeup latency */
+} idle_stats_struct;
+
+extern const idle_state_param_struct g_idle_state_table[IDLE_STATE_NUM];   /*!< idle state parameters */
+
+/* function declarations */
+void idle_init(void);                                                                   /*!< set up RTC wakeup and collect a standby exit */
+void idle_constraint_register(idle_constraint_struct *constraint);                      /*!< add a wakeup latency constraint */
+void idle_constraint_unregister(idle_constraint_struct *constraint);                    /*!< remove a wakeup latency constraint */
+uint32_t idle_latency_limit(void);                                                      /*!< tightest registered constraint */
+void idle_standby_allow(uint8_t allow);                                                 /*!< allow standby (RAM contents lost) */
+uint8_t idle_select(uint32_t sleep_us);                                                 /*!< deepest state fitting deadline and constraints */
+uint8_t idle_enter(uint32_t sleep_us);                                                  /*!< idle until the deadline or an interrupt */
+void idle_account(uint8_t state, uint32_t residency_us, uint32_t latency_us);          /*!< account an idle period spent outside idle_enter */
+void idle_stats_get(uint8_t state, idle_stats_struct *stats);                           /*!< copy statistics of one state */
+void idle_stats_print(void);                                                            /*!< print residency and wakeup latency */
+#endif /* __IDLE_H */
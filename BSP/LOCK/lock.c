@@ -0,0 +1,374 @@
+/*!
+    \file       lock.c
+    \brief      hardware semaphore and LDREX/STREX locks
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - HWSEM locks owned by the execution context (thread mode or one exception
+      number), so an ISR never takes a lock held by the code it interrupted
+    - Release from any context, so a lock taken to start a DMA or engine
+      operation can be released by its completion interrupt
+    - Waiting on the semaphore release interrupt instead of polling the bus
+    - LDREX/STREX software locks with the same semantics
+    - Contention statistics, updated with exclusive accesses instead of
+      masking interrupts
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./LOCK/lock.h"
+#include "./SYSTEM/system.h"
+#include "./TIMER/timer.h"
+#include "./USART/usart.h"
+
+static lock_stats_struct s_lock_stats[LOCK_SEMAPHORES];                    /* per semaphore statistics */
+static uint8_t s_lock_pid[LOCK_SEMAPHORES];                                /* process id used for each held semaphore */
+static uint8_t s_lock_waiters[LOCK_SEMAPHORES];                            /* lock_wait callers per semaphore */
+static volatile uint8_t s_lock_released[LOCK_SEMAPHORES];                  /* release seen by the interrupt, bytes so clearing one does not race with another */
+
+/*!
+    \brief      process id of the running context
+    \param[in]  none
+    \param[out] none
+    \retval     IPSR + 1: 1 in thread mode, exception number + 1 in a handler
+    \note       HWSEM treats a lock request with the owner's id as success, so
+                every context that may nest needs its own id. 0 is left to
+                hwsem_lock_by_reading.
+*/
+static uint8_t lock_pid(void)
+{
+    return (uint8_t)(__get_IPSR() + 1U);
+}
+
+/*!
+    \brief      increment a counter shared between contexts
+    \param[in]  counter: counter to increment
+    \param[out] none
+    \retval     none
+*/
+static void lock_count(volatile uint32_t *counter)
+{
+    uint32_t value;
+
+    do
+    {
+        value = __LDREXW(counter);
+    } while(__STREXW(value + 1U, counter) != 0U);
+}
+
+/*!
+    \brief      record a finished acquisition, called while holding the lock
+    \param[in]  stats: statistics of the lock
+    \param[in]  start: DWT_CYCCNT at the first attempt
+    \param[in]  waited: 1 if the first attempt failed
+    \param[out] none
+    \retval     none
+*/
+static void lock_account(lock_stats_struct *stats, uint32_t start, uint8_t waited)
+{
+    uint32_t cycles;
+
+    stats->acquired++;
+    if(waited)
+    {
+        stats->contended++;
+        cycles = DWT_CYCCNT - start;
+        if(cycles > stats->wait_cycles_max)
+        {
+            stats->wait_cycles_max = cycles;
+        }
+    }
+}
+
+/*!
+    \brief      one lock attempt without acquisition accounting
+    \param[in]  semaphore: SEM0 to SEM31
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if taken
+*/
+static ErrStatus lock_attempt(hwsem_semaphore_enum semaphore)
+{
+    uint8_t pid = lock_pid();
+    uint32_t ctl = HWSEM_CTL(semaphore);
+
+    if((ctl & HWSEM_LOCK) && (GET_CTL_MID(ctl) == HWSEM_MASTER_ID) && (GET_CTL_PID(ctl) == pid))
+    {
+        /* HWSEM would report success and the first release would free it for both */
+        lock_count(&s_lock_stats[semaphore].recursion);
+        return ERROR;
+    }
+    if(SUCCESS != hwsem_lock_set(semaphore, pid))
+    {
+        lock_count(&s_lock_stats[semaphore].failed);
+        return ERROR;
+    }
+    s_lock_pid[semaphore] = pid;
+    return SUCCESS;
+}
+
+/*!
+    \brief      enable HWSEM and its release interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void lock_init(void)
+{
+    rcu_periph_clock_enable(RCU_HWSEM);
+    HWSEM_INTEN = 0;
+    HWSEM_INTC = 0xFFFFFFFFU;
+    nvic_irq_enable(HWSEM_IRQn, LOCK_IRQ_PRIORITY, 0);
+}
+
+/*!
+    \brief      take a semaphore if it is free
+    \param[in]  semaphore: SEM0 to SEM31, see LOCK_SEM_x
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if taken, ERROR if held by another context or this one
+*/
+ErrStatus lock_try(hwsem_semaphore_enum semaphore)
+{
+    if(SUCCESS != lock_attempt(semaphore))
+    {
+        return ERROR;
+    }
+    lock_account(&s_lock_stats[semaphore], 0, 0);
+    return SUCCESS;
+}
+
+/*!
+    \brief      busy-wait for a semaphore
+    \param[in]  semaphore: SEM0 to SEM31, see LOCK_SEM_x
+    \param[out] none
+    \retval     none
+    \note       Only spin when the holder can run meanwhile: from an ISR, a lock
+                held by lower-priority code is never released, use lock_try.
+*/
+void lock_spin(hwsem_semaphore_enum semaphore)
+{
+    uint32_t start = DWT_CYCCNT;
+    uint8_t waited = 0;
+
+    while(SUCCESS != lock_attempt(semaphore))
+    {
+        waited = 1;
+    }
+    lock_account(&s_lock_stats[semaphore], start, waited);
+}
+
+/*!
+    \brief      wait for a semaphore on its release interrupt
+    \param[in]  semaphore: SEM0 to SEM31, see LOCK_SEM_x
+    \param[in]  timeout_us: longest wait, LOCK_FOREVER to sleep with WFE until released
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if taken, ERROR on timeout
+    \note       Thread mode only; in a handler this is lock_try. Between attempts
+                the caller watches a RAM flag set by the release interrupt, so
+                the HWSEM registers are not polled while the holder works.
+*/
+ErrStatus lock_wait(hwsem_semaphore_enum semaphore, uint32_t timeout_us)
+{
+    uint32_t start, start_us, primask;
+    uint8_t waited = 0;
+    ErrStatus status;
+
+    if(__get_IPSR() != 0U)
+    {
+        return lock_try(semaphore);
+    }
+
+    start = DWT_CYCCNT;
+    start_us = timer_monotonic_us();
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(s_lock_waiters[semaphore]++ == 0U)
+    {
+        hwsem_interrupt_flag_clear(semaphore);
+        hwsem_interrupt_enable(semaphore);
+    }
+    __set_PRIMASK(primask);
+
+    while(1)
+    {
+        /* clear before trying, so a release right after a failed attempt is not missed */
+        s_lock_released[semaphore] = 0;
+        status = lock_attempt(semaphore);
+        if(status == SUCCESS)
+        {
+            break;
+        }
+        waited = 1;
+        while(!s_lock_released[semaphore])
+        {
+            if(timeout_us == LOCK_FOREVER)
+            {
+                __WFE();
+            }
+            else if((timer_monotonic_us() - start_us) >= timeout_us)
+            {
+                break;
+            }
+        }
+        if(!s_lock_released[semaphore])
+        {
+            lock_count(&s_lock_stats[semaphore].timeouts);
+            break;
+        }
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(--s_lock_waiters[semaphore] == 0U)
+    {
+        hwsem_interrupt_disable(semaphore);
+    }
+    __set_PRIMASK(primask);
+
+    if(status == SUCCESS)
+    {
+        lock_account(&s_lock_stats[semaphore], start, waited);
+    }
+    return status;
+}
+
+/*!
+    \brief      release a semaphore
+    \param[in]  semaphore: SEM0 to SEM31, see LOCK_SEM_x
+    \param[out] none
+    \retval     none
+    \note       Any context may release, e.g. the DMA interrupt that ends the
+                operation the lock was taken for.
+*/
+void lock_release(hwsem_semaphore_enum semaphore)
+{
+    __DMB();
+    hwsem_lock_release(semaphore, s_lock_pid[semaphore]);
+}
+
+/*!
+    \brief      take a software lock if it is free
+    \param[in]  lock: lock, zero-initialised
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if taken, ERROR if held by another context or this one
+*/
+ErrStatus lock_soft_try(lock_soft_struct *lock)
+{
+    uint32_t pid = lock_pid();
+    uint32_t owner;
+
+    do
+    {
+        owner = __LDREXW(&lock->owner);
+        if(owner != 0U)
+        {
+            __CLREX();
+            lock_count((owner == pid) ? &lock->stats.recursion : &lock->stats.failed);
+            return ERROR;
+        }
+    } while(__STREXW(pid, &lock->owner) != 0U);
+    __DMB();
+    lock_account(&lock->stats, 0, 0);
+    return SUCCESS;
+}
+
+/*!
+    \brief      busy-wait for a software lock
+    \param[in]  lock: lock, zero-initialised
+    \param[out] none
+    \retval     none
+    \note       Same restriction as lock_spin; spinning on a lock the caller
+                already holds never returns.
+*/
+void lock_soft_spin(lock_soft_struct *lock)
+{
+    uint32_t start = DWT_CYCCNT;
+    uint32_t pid = lock_pid();
+    uint8_t waited = 0;
+
+    while(1)
+    {
+        if(__LDREXW(&lock->owner) == 0U)
+        {
+            if(__STREXW(pid, &lock->owner) == 0U)
+            {
+                break;
+            }
+        }
+        else
+        {
+            __CLREX();
+            waited = 1;
+        }
+    }
+    __DMB();
+    lock_account(&lock->stats, start, waited);
+}
+
+/*!
+    \brief      release a software lock
+    \param[in]  lock: lock
+    \param[out] none
+    \retval     none
+*/
+void lock_soft_release(lock_soft_struct *lock)
+{
+    __DMB();
+    lock->owner = 0;
+}
+
+/*!
+    \brief      copy statistics of a semaphore
+    \param[in]  semaphore: SEM0 to SEM31
+    \param[out] stats: contention statistics
+    \retval     none
+*/
+void lock_stats_get(hwsem_semaphore_enum semaphore, lock_stats_struct *stats)
+{
+    *stats = s_lock_stats[semaphore];
+}
+
+/*!
+    \brief      print statistics of every semaphore that was used
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void lock_stats_print(void)
+{
+    const lock_stats_struct *s;
+    uint8_t i;
+
+    for(i = 0; i < LOCK_SEMAPHORES; i++)
+    {
+        s = &s_lock_stats[i];
+        if(s->acquired || s->failed || s->recursion)
+        {
+            PRINT("lock SEM%u: %u acquired, %u contended, %u failed, %u recursive, %u timeouts, wait max %u cycles\r\n",
+                  (unsigned)i, (unsigned)s->acquired, (unsigned)s->contended, (unsigned)s->failed,
+                  (unsigned)s->recursion, (unsigned)s->timeouts, (unsigned)s->wait_cycles_max);
+        }
+    }
+}
+
+/*!
+    \brief      HWSEM interrupt: note releases and wake waiters
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void HWSEM_IRQHandler(void)
+{
+    uint32_t flags = HWSEM_INTF;
+    uint8_t i;
+
+    HWSEM_INTC = flags;
+    for(i = 0; flags != 0U; i++, flags >>= 1)
+    {
+        if(flags & 1U)
+        {
+            s_lock_released[i] = 1;
+        }
+    }
+    __SEV();
+}
@@ -0,0 +1,67 @@
+/*!
+    \file       lock.h
+    \brief      header file for hardware semaphore and LDREX/STREX locks
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Semaphore assignment for peripherals shared between thread and ISR context
+    - Spin, try-lock and release-interrupt wait on HWSEM semaphores
+    - LDREX/STREX software locks for data beyond the 32 semaphores
+    - Per-lock contention statistics
+*/
+
+#ifndef __LOCK_H
+#define __LOCK_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief lock configuration macros
+*/
+#define LOCK_SEMAPHORES             32U                                     /*!< HWSEM semaphores */
+#define LOCK_IRQ_PRIORITY           1U                                      /*!< HWSEM release interrupt priority */
+#define LOCK_FOREVER                0xFFFFFFFFU                             /*!< lock_wait timeout: sleep until released */
+
+/* semaphore assignment, taken by the engine drivers: lock_init before their init */
+#define LOCK_SEM_CAU                SEM0                                    /*!< CAU (AES) engine */
+#define LOCK_SEM_HAU                SEM1                                    /*!< HAU (hash) engine */
+#define LOCK_SEM_CRC                SEM2                                    /*!< CRC unit */
+#define LOCK_SEM_TRNG               SEM3                                    /*!< DRBG behind rng_random_get */
+#define LOCK_SEM_USER               SEM4                                    /*!< first semaphore free for the application */
+
+/*!
+    \brief lock contention statistics
+*/
+typedef struct
+{
+    uint32_t acquired;                                                      /*!< successful acquisitions */
+    uint32_t contended;                                                     /*!< acquisitions that had to wait */
+    uint32_t failed;                                                        /*!< attempts that found the lock taken */
+    uint32_t recursion;                                                     /*!< attempts by the context already holding it */
+    uint32_t timeouts;                                                      /*!< lock_wait calls that gave up */
+    uint32_t wait_cycles_max;                                               /*!< longest wait for an acquisition */
+} lock_stats_struct;
+
+/*!
+    \brief LDREX/STREX lock, zero-initialised
+*/
+typedef struct
+{
+    volatile uint32_t owner;                                                /*!< 0 when free, else the owner context id */
+    lock_stats_struct stats;                                                /*!< contention statistics */
+} lock_soft_struct;
+
+/* function declarations */
+void lock_init(void);                                                                   /*!< enable HWSEM and its release interrupt */
+ErrStatus lock_try(hwsem_semaphore_enum semaphore);                                     /*!< take a semaphore if free */
+void lock_spin(hwsem_semaphore_enum semaphore);                                         /*!< busy-wait for a semaphore */
+ErrStatus lock_wait(hwsem_semaphore_enum semaphore, uint32_t timeout_us);               /*!< wait for the release interrupt, thread mode */
+void lock_release(hwsem_semaphore_enum semaphore);                                      /*!< release a semaphore, from any context */
+ErrStatus lock_soft_try(lock_soft_struct *lock);                                        /*!< take a software lock if free */
+void lock_soft_spin(lock_soft_struct *lock);                                            /*!< busy-wait for a software lock */
+void lock_soft_release(lock_soft_struct *lock);                                         /*!< release a software lock, from any context */
+void lock_stats_get(hwsem_semaphore_enum semaphore, lock_stats_struct *stats);          /*!< copy statistics of a semaphore */
+void lock_stats_print(void);                                                            /*!< print statistics of used semaphores */
+#endif /* __LOCK_H */
@@ -0,0 +1,79 @@
+/*!
+    \file       pincfg.c
+    \brief      pin configuration tables applied in one pass
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Applying a merged table: each port clock once, then one read-modify-write
+      per register the table touches on that port, instead of the two to five
+      read-modify-writes per pin of gpio_af_set, gpio_mode_set and
+      gpio_output_options_set
+    - The board table, merged and checked by the compiler
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./PINCFG/pincfg.h"
+#include "./USART/usart.h"
+#include "./I2C/i2c.h"
+#include "./SPI/spi.h"
+#include "./SPI/spi_slave.h"
+
+/* register offsets in pincfg_reg_enum order */
+static const uint8_t s_pincfg_offset[PINCFG_REG_NUM] = {0x20U, 0x24U, 0x04U, 0x08U, 0x0CU, 0x00U};
+
+/* pincfg_init: the board table, a pin listed twice or a bad value fails the build here */
+typedef char pincfg_board_check[PINCFG_VALID(PINCFG_BOARD_TABLE) ? 1 : -1];
+#if PINCFG_BOOT
+static const pincfg_port_struct s_pincfg_board[PINCFG_PORT_NUM] = {PINCFG_PORTS(PINCFG_BOARD_TABLE)};
+#endif /* PINCFG_BOOT */
+
+/*!
+    \brief      configure the pins of a merged table
+    \param[in]  ports: pincfg_port_struct array built with PINCFG_PORTS
+    \param[in]  count: number of entries
+    \param[out] none
+    \retval     number of register writes
+    \note       Bits outside the masks keep their value, so tables may share a
+                port. Ports without pins are skipped, their clock stays off.
+*/
+uint32_t pincfg_apply(const pincfg_port_struct *ports, uint32_t count)
+{
+    uint32_t i, r, writes = 0U;
+
+    for(i = 0U; i < count; i++)
+    {
+        if(ports[i].pins == 0U)
+        {
+            continue;
+        }
+        rcu_periph_clock_enable(ports[i].clock);
+        for(r = 0U; r < PINCFG_REG_NUM; r++)
+        {
+            if(ports[i].reg[r].mask != 0U)
+            {
+                REG32(ports[i].port + s_pincfg_offset[r]) = (REG32(ports[i].port + s_pincfg_offset[r]) &
+                                                             ~ports[i].reg[r].mask) | ports[i].reg[r].value;
+                writes++;
+            }
+        }
+    }
+    return writes;
+}
+
+/*!
+    \brief      configure the pins of PINCFG_BOARD_TABLE
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Call once at boot before the driver init functions. With
+                PINCFG_BOOT 0 the drivers configure their own pins and this
+                does nothing.
+*/
+void pincfg_init(void)
+{
+#if PINCFG_BOOT
+    pincfg_apply(s_pincfg_board, PINCFG_PORT_NUM);
+#endif /* PINCFG_BOOT */
+}
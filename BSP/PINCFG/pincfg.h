@@ -0,0 +1,228 @@
+/*!
+    \file       pincfg.h
+    \brief      pin configuration tables merged per port at compile time
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - The pin table format: an X-macro listing one row per pin
+    - PINCFG_PORTS: the table merged into mask/value pairs per port and
+      register, every term a constant expression
+    - PINCFG_VALID: compile-time check for pins listed twice, out of range
+      values and unknown ports
+    - pincfg_apply: one masked write per register touched by the table
+    - The board table, built from the pin rows of the drivers that main
+      brings up at boot
+*/
+
+#ifndef __PINCFG_H
+#define __PINCFG_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief      pin configuration at boot
+                0: every driver configures its pins in its init function
+                1: pincfg_init applies PINCFG_BOARD_TABLE, the drivers only
+                   configure the peripheral
+*/
+#ifndef PINCFG_BOOT
+#define PINCFG_BOOT                 1
+#endif /* PINCFG_BOOT */
+
+/*!
+    \brief pin rows in PINCFG_BOARD_TABLE, 1 for the peripherals main brings
+           up; USART0 is always there. A driver whose rows are left out
+           applies them itself in its init function.
+*/
+#define PINCFG_BOARD_USART_TERMINAL 0                                       /*!< USART1 PD5/PD6, benchmark build only */
+#define PINCFG_BOARD_UART4          0                                       /*!< UART4 PB5/PC12, wireless module */
+#define PINCFG_BOARD_I2C_MASTER     1                                       /*!< I2C0 PB6/PB7, sensor hub */
+#define PINCFG_BOARD_SPI_MASTER     0                                       /*!< SPI3 PE11-PE14 */
+#define PINCFG_BOARD_SPI_SLAVE      0                                       /*!< SPI4 PF6-PF9 */
+
+/* 1 when a driver configures its own pins: boot table off or its rows not in it */
+#define PINCFG_OWN(board)           (!(PINCFG_BOOT && (board)))
+
+/*
+    A table is a function-like macro table(PIN, x) expanding to rows
+
+        PIN(x, port, pin, mode, pull, otype, speed, af)
+
+    x:     passed through untouched, the merge macros use it for the port
+    port:  GPIOx(x = A,B,C,D,E,F,G,H,J,K)
+    pin:   0-15, the pin number and not GPIO_PIN_x; PINCFG_PIN converts
+    mode:  GPIO_MODE_INPUT, GPIO_MODE_OUTPUT, GPIO_MODE_AF, GPIO_MODE_ANALOG
+    pull:  GPIO_PUPD_NONE, GPIO_PUPD_PULLUP, GPIO_PUPD_PULLDOWN
+    otype: GPIO_OTYPE_PP, GPIO_OTYPE_OD
+    speed: GPIO_OSPEED_12MHZ .. GPIO_OSPEED_100_220MHZ
+    af:    GPIO_AF_0 .. GPIO_AF_15, written only for GPIO_MODE_AF
+*/
+
+/*!
+    \brief registers written by pincfg_apply, in write order: CTL last, so a
+           pin enters its mode with the function, driver and pull already set
+*/
+typedef enum
+{
+    PINCFG_AFSEL0 = 0,                                                      /*!< alternate function of pins 0-7 */
+    PINCFG_AFSEL1,                                                          /*!< alternate function of pins 8-15 */
+    PINCFG_OMODE,                                                           /*!< output type */
+    PINCFG_OSPD,                                                            /*!< output speed */
+    PINCFG_PUD,                                                             /*!< pull-up/down */
+    PINCFG_CTL,                                                             /*!< mode */
+    PINCFG_REG_NUM
+} pincfg_reg_enum;
+
+/*!
+    \brief bits of one register owned by a table
+*/
+typedef struct
+{
+    uint32_t mask;                                                          /*!< bits set by the table */
+    uint32_t value;                                                         /*!< their value */
+} pincfg_field_struct;
+
+/*!
+    \brief one port of a merged table
+*/
+typedef struct
+{
+    uint32_t port;                                                          /*!< GPIOx */
+    rcu_periph_enum clock;                                                  /*!< RCU_GPIOx */
+    uint32_t pins;                                                          /*!< pins of the table on this port, 0: port skipped */
+    pincfg_field_struct reg[PINCFG_REG_NUM];                                /*!< indexed by pincfg_reg_enum */
+} pincfg_port_struct;
+
+/* pin number of a one-pin GPIO_PIN_x mask, 16 (rejected by PINCFG_VALID) for any other mask */
+#define PINCFG_PIN(mask) \
+    ((((uint32_t)(mask) == 0U) || ((uint32_t)(mask) > 0xFFFFU) || ((uint32_t)(mask) & ((uint32_t)(mask) - 1U))) ? 16U : \
+     ((((uint32_t)(mask) & 0xAAAAU) ? 1U : 0U) | (((uint32_t)(mask) & 0xCCCCU) ? 2U : 0U) | \
+      (((uint32_t)(mask) & 0xF0F0U) ? 4U : 0U) | (((uint32_t)(mask) & 0xFF00U) ? 8U : 0U)))
+
+/* row terms, each one "| constant" or "+ constant" for the merge */
+#define PINCFG_ON(x, port)          ((uint32_t)(port) == (uint32_t)(x))
+#define PINCFG_F1(x, port, pin, v)  (PINCFG_ON(x, port) ? ((uint32_t)(v) << (pin)) : 0U)
+#define PINCFG_F2(x, port, pin, v)  (PINCFG_ON(x, port) ? ((uint32_t)(v) << (2U * (pin))) : 0U)
+#define PINCFG_AF(x, port, pin, mode, v, high) \
+    ((PINCFG_ON(x, port) && ((mode) == GPIO_MODE_AF) && (((pin) >= 8U) == (high))) ? \
+     ((uint32_t)(v) << (4U * ((pin) % 8U))) : 0U)
+
+#define PINCFG_X_PINS(x, port, pin, mode, pull, otype, speed, af)           | PINCFG_F1(x, port, pin, 1U)
+#define PINCFG_X_PIN_SUM(x, port, pin, mode, pull, otype, speed, af)        + PINCFG_F1(x, port, pin, 1U)
+#define PINCFG_X_ROWS(x, port, pin, mode, pull, otype, speed, af)           + (PINCFG_ON(x, port) ? 1U : 0U)
+#define PINCFG_X_COUNT(x, port, pin, mode, pull, otype, speed, af)          + 1U
+#define PINCFG_X_RANGE(x, port, pin, mode, pull, otype, speed, af) \
+    | (((pin) > 15U) || ((mode) > 3U) || ((pull) > 2U) || ((otype) > 1U) || ((speed) > 3U) || ((af) > 15U))
+#define PINCFG_X_AFSEL0_MASK(x, port, pin, mode, pull, otype, speed, af)    | PINCFG_AF(x, port, pin, mode, 0xFU, 0)
+#define PINCFG_X_AFSEL0(x, port, pin, mode, pull, otype, speed, af)         | PINCFG_AF(x, port, pin, mode, af, 0)
+#define PINCFG_X_AFSEL1_MASK(x, port, pin, mode, pull, otype, speed, af)    | PINCFG_AF(x, port, pin, mode, 0xFU, 1)
+#define PINCFG_X_AFSEL1(x, port, pin, mode, pull, otype, speed, af)         | PINCFG_AF(x, port, pin, mode, af, 1)
+#define PINCFG_X_OMODE_MASK(x, port, pin, mode, pull, otype, speed, af)     | PINCFG_F1(x, port, pin, 1U)
+#define PINCFG_X_OMODE(x, port, pin, mode, pull, otype, speed, af)          | PINCFG_F1(x, port, pin, otype)
+#define PINCFG_X_F2_MASK(x, port, pin, mode, pull, otype, speed, af)        | PINCFG_F2(x, port, pin, 3U)
+#define PINCFG_X_OSPD(x, port, pin, mode, pull, otype, speed, af)           | PINCFG_F2(x, port, pin, speed)
+#define PINCFG_X_PUD(x, port, pin, mode, pull, otype, speed, af)            | PINCFG_F2(x, port, pin, pull)
+#define PINCFG_X_CTL(x, port, pin, mode, pull, otype, speed, af)            | PINCFG_F2(x, port, pin, mode)
+
+/*!
+    \brief      merge the rows of table on port with term
+    \param[in]  table: table macro
+    \param[in]  port: GPIOx
+    \param[in]  term: PINCFG_X_*
+    \retval     constant expression
+*/
+#define PINCFG_MERGE(table, port, term)     (0U table(term, port))
+
+/*!
+    \brief      initializer of the pincfg_port_struct of one port
+*/
+#define PINCFG_PORT(table, port, clock) \
+    { (port), (clock), PINCFG_MERGE(table, port, PINCFG_X_PINS), { \
+      { PINCFG_MERGE(table, port, PINCFG_X_AFSEL0_MASK), PINCFG_MERGE(table, port, PINCFG_X_AFSEL0) }, \
+      { PINCFG_MERGE(table, port, PINCFG_X_AFSEL1_MASK), PINCFG_MERGE(table, port, PINCFG_X_AFSEL1) }, \
+      { PINCFG_MERGE(table, port, PINCFG_X_OMODE_MASK), PINCFG_MERGE(table, port, PINCFG_X_OMODE) }, \
+      { PINCFG_MERGE(table, port, PINCFG_X_F2_MASK), PINCFG_MERGE(table, port, PINCFG_X_OSPD) }, \
+      { PINCFG_MERGE(table, port, PINCFG_X_F2_MASK), PINCFG_MERGE(table, port, PINCFG_X_PUD) }, \
+      { PINCFG_MERGE(table, port, PINCFG_X_F2_MASK), PINCFG_MERGE(table, port, PINCFG_X_CTL) } } }
+
+/*!
+    \brief      initializers of every port, for a pincfg_port_struct array of PINCFG_PORT_NUM entries
+*/
+#define PINCFG_PORT_NUM             10U
+#define PINCFG_PORTS(table) \
+    PINCFG_PORT(table, GPIOA, RCU_GPIOA), PINCFG_PORT(table, GPIOB, RCU_GPIOB), \
+    PINCFG_PORT(table, GPIOC, RCU_GPIOC), PINCFG_PORT(table, GPIOD, RCU_GPIOD), \
+    PINCFG_PORT(table, GPIOE, RCU_GPIOE), PINCFG_PORT(table, GPIOF, RCU_GPIOF), \
+    PINCFG_PORT(table, GPIOG, RCU_GPIOG), PINCFG_PORT(table, GPIOH, RCU_GPIOH), \
+    PINCFG_PORT(table, GPIOJ, RCU_GPIOJ), PINCFG_PORT(table, GPIOK, RCU_GPIOK)
+
+/* a pin listed twice on port: the sum of the pin bits differs from their OR */
+#define PINCFG_TWICE(table, port) \
+    (PINCFG_MERGE(table, port, PINCFG_X_PIN_SUM) != PINCFG_MERGE(table, port, PINCFG_X_PINS))
+/* rows on one of the ten ports */
+#define PINCFG_ROWS(table, port)    PINCFG_MERGE(table, port, PINCFG_X_ROWS)
+#define PINCFG_KNOWN(table) \
+    (PINCFG_ROWS(table, GPIOA) + PINCFG_ROWS(table, GPIOB) + PINCFG_ROWS(table, GPIOC) + \
+     PINCFG_ROWS(table, GPIOD) + PINCFG_ROWS(table, GPIOE) + PINCFG_ROWS(table, GPIOF) + \
+     PINCFG_ROWS(table, GPIOG) + PINCFG_ROWS(table, GPIOH) + PINCFG_ROWS(table, GPIOJ) + \
+     PINCFG_ROWS(table, GPIOK))
+
+/*!
+    \brief      1 when every row names a known port and in-range values and no pin is listed twice
+    \param[in]  table: table macro
+    \retval     constant expression
+*/
+#define PINCFG_VALID(table) \
+    ((PINCFG_KNOWN(table) == PINCFG_MERGE(table, 0U, PINCFG_X_COUNT)) && \
+     (PINCFG_MERGE(table, 0U, PINCFG_X_RANGE) == 0U) && \
+     !(PINCFG_TWICE(table, GPIOA) || PINCFG_TWICE(table, GPIOB) || PINCFG_TWICE(table, GPIOC) || \
+       PINCFG_TWICE(table, GPIOD) || PINCFG_TWICE(table, GPIOE) || PINCFG_TWICE(table, GPIOF) || \
+       PINCFG_TWICE(table, GPIOG) || PINCFG_TWICE(table, GPIOH) || PINCFG_TWICE(table, GPIOJ) || \
+       PINCFG_TWICE(table, GPIOK)))
+
+/* driver rows selected by the PINCFG_BOARD_x switches */
+#if PINCFG_BOARD_USART_TERMINAL
+#define PINCFG_BOARD_ROWS_USART_TERMINAL(PIN, x)    USART_TERMINAL_PINS(PIN, x)
+#else
+#define PINCFG_BOARD_ROWS_USART_TERMINAL(PIN, x)
+#endif /* PINCFG_BOARD_USART_TERMINAL */
+#if PINCFG_BOARD_UART4
+#define PINCFG_BOARD_ROWS_UART4(PIN, x)             UART4_PINS(PIN, x)
+#else
+#define PINCFG_BOARD_ROWS_UART4(PIN, x)
+#endif /* PINCFG_BOARD_UART4 */
+#if PINCFG_BOARD_I2C_MASTER
+#define PINCFG_BOARD_ROWS_I2C_MASTER(PIN, x)        I2C_MASTER_PINS(PIN, x)
+#else
+#define PINCFG_BOARD_ROWS_I2C_MASTER(PIN, x)
+#endif /* PINCFG_BOARD_I2C_MASTER */
+#if PINCFG_BOARD_SPI_MASTER
+#define PINCFG_BOARD_ROWS_SPI_MASTER(PIN, x)        SPI_MASTER_PINS(PIN, x)
+#else
+#define PINCFG_BOARD_ROWS_SPI_MASTER(PIN, x)
+#endif /* PINCFG_BOARD_SPI_MASTER */
+#if PINCFG_BOARD_SPI_SLAVE
+#define PINCFG_BOARD_ROWS_SPI_SLAVE(PIN, x)         SPI_SLAVE_PINS(PIN, x)
+#else
+#define PINCFG_BOARD_ROWS_SPI_SLAVE(PIN, x)
+#endif /* PINCFG_BOARD_SPI_SLAVE */
+
+/*!
+    \brief      pins of the board, configured by pincfg_init when PINCFG_BOOT is 1;
+                the rows live next to the pin macros of each driver header
+*/
+#define PINCFG_BOARD_TABLE(PIN, x) \
+    BSP_USART_PINS(PIN, x) \
+    PINCFG_BOARD_ROWS_USART_TERMINAL(PIN, x) \
+    PINCFG_BOARD_ROWS_UART4(PIN, x) \
+    PINCFG_BOARD_ROWS_I2C_MASTER(PIN, x) \
+    PINCFG_BOARD_ROWS_SPI_MASTER(PIN, x) \
+    PINCFG_BOARD_ROWS_SPI_SLAVE(PIN, x)
+
+/* function declarations */
+uint32_t pincfg_apply(const pincfg_port_struct *ports, uint32_t count);                 /*!< port clocks, then one masked write per register */
+void pincfg_init(void);                                                                 /*!< apply PINCFG_BOARD_TABLE */
+
+#endif /* __PINCFG_H */
@@ -0,0 +1,194 @@
+/*!
+    \file       reg.hpp
+    \brief      header-only typed register and field access, C++11
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - reg::reg_t<Address>: a register at an address known at compile time
+    - reg::field<Reg, Pos, Width, Type> and reg::bit<Reg, Pos>: typed fields
+      whose values are template arguments, checked against the field width
+      and the value type when the code is compiled
+    - write<Values...>() and modify<Values...>(): the masks and bits of any
+      number of field values folded into one store or one read-modify-write
+    Every access is a volatile load or store of a constant address, the same
+    code the REG32 macros of the firmware library produce, see
+    BSP/BENCH/bench_reg_cases.cpp and TOOLS/disasm_compare.py.
+*/
+
+#ifndef __REG_HPP
+#define __REG_HPP
+#include <stdint.h>
+#include <type_traits>
+
+namespace reg
+{
+/*!
+    \brief a constant mask and value of one register, the unit write and modify combine
+*/
+template<typename Reg, uint32_t Mask, uint32_t Bits>
+struct field_value
+{
+    static_assert((Bits & ~Mask) == 0U, "field value outside its mask");
+    typedef Reg reg_type;                                                   /*!< register the value belongs to */
+    static constexpr uint32_t mask = Mask;                                  /*!< bits written */
+    static constexpr uint32_t bits = Bits;                                  /*!< their new content */
+};
+
+/*!
+    \brief fold of the masks and bits of several field values of one register
+*/
+template<typename Reg, typename... Values>
+struct merge;
+
+template<typename Reg>
+struct merge<Reg>
+{
+    static constexpr uint32_t mask = 0U;
+    static constexpr uint32_t bits = 0U;
+};
+
+template<typename Reg, typename Value, typename... Rest>
+struct merge<Reg, Value, Rest...>
+{
+    static_assert(std::is_same<typename Value::reg_type, Reg>::value, "field value of another register");
+    static_assert((Value::mask & merge<Reg, Rest...>::mask) == 0U, "two values for the same field");
+    static constexpr uint32_t mask = Value::mask | merge<Reg, Rest...>::mask;
+    static constexpr uint32_t bits = Value::bits | merge<Reg, Rest...>::bits;
+};
+
+/*!
+    \brief a 32-bit register at a fixed address
+*/
+template<uint32_t Address>
+struct reg_t
+{
+    static constexpr uint32_t address = Address;                            /*!< bus address */
+
+    /*!
+        \brief      the register as a volatile object
+        \retval     reference to the register
+    */
+    static volatile uint32_t &ref(void)
+    {
+        return *reinterpret_cast<volatile uint32_t *>(static_cast<uintptr_t>(Address));
+    }
+
+    /*!
+        \brief      load the register
+        \retval     register content
+    */
+    static uint32_t read(void)
+    {
+        return ref();
+    }
+
+    /*!
+        \brief      store a run-time value
+        \param[in]  value: new register content
+    */
+    static void write(uint32_t value)
+    {
+        ref() = value;
+    }
+
+    /*!
+        \brief      store field values, every other bit written as 0
+        \note       The whole register is written once: use for write-only
+                    registers (BOP, BC, INTC) and for full configurations.
+    */
+    template<typename... Values>
+    static void write(void)
+    {
+        ref() = merge<reg_t, Values...>::bits;
+    }
+
+    /*!
+        \brief      change field values, every other bit kept
+        \note       One load and one store whatever the number of values.
+    */
+    template<typename... Values>
+    static void modify(void)
+    {
+        ref() = (ref() & ~merge<reg_t, Values...>::mask) | merge<reg_t, Values...>::bits;
+    }
+
+    /*!
+        \brief      check field values
+        \retval     true when every field holds its value
+    */
+    template<typename... Values>
+    static bool is(void)
+    {
+        return (ref() & merge<reg_t, Values...>::mask) == merge<reg_t, Values...>::bits;
+    }
+};
+
+/*!
+    \brief a field of Width bits at bit Pos of a register, holding values of type Type
+*/
+template<typename Reg, unsigned Pos, unsigned Width, typename Type = uint32_t>
+struct field
+{
+    static_assert((Width >= 1U) && (Pos + Width <= 32U), "field outside the register");
+    static_assert(std::is_integral<Type>::value || std::is_enum<Type>::value, "field type must be integral or enum");
+    typedef Reg reg_type;                                                   /*!< register holding the field */
+    typedef Type value_type;                                                /*!< type of its values */
+    static constexpr uint32_t mask = (0xFFFFFFFFU >> (32U - Width)) << Pos;/*!< field bits in the register */
+
+    /*!
+        \brief      a constant field value, rejected at compile time when it does not fit
+    */
+    template<Type Value>
+    struct value : field_value<Reg, mask, ((uint32_t)Value << Pos) & mask>
+    {
+        static_assert((uint64_t)(uint32_t)Value < (1ULL << Width), "value does not fit the field");
+    };
+
+    /*!
+        \brief      load the field
+        \retval     field content, shifted down
+    */
+    static Type read(void)
+    {
+        return (Type)((Reg::read() & mask) >> Pos);
+    }
+
+    /*!
+        \brief      store a run-time value into the field, other bits kept
+        \param[in]  v: new field content, bits above the width are dropped
+    */
+    static void write(Type v)
+    {
+        Reg::ref() = (Reg::ref() & ~mask) | (((uint32_t)v << Pos) & mask);
+    }
+};
+
+/*!
+    \brief a one-bit field with its two values
+*/
+template<typename Reg, unsigned Pos>
+struct bit : field<Reg, Pos, 1U>
+{
+    typedef field_value<Reg, 1UL << Pos, 1UL << Pos> on;                    /*!< bit set */
+    typedef field_value<Reg, 1UL << Pos, 0U> off;                           /*!< bit cleared */
+
+    /*!
+        \brief      test the bit
+        \retval     true when set
+    */
+    static bool is_set(void)
+    {
+        return (Reg::read() & (1UL << Pos)) != 0U;
+    }
+};
+
+/* out-of-class definitions of the static constants, for a use that needs their address */
+template<typename Reg, uint32_t Mask, uint32_t Bits> constexpr uint32_t field_value<Reg, Mask, Bits>::mask;
+template<typename Reg, uint32_t Mask, uint32_t Bits> constexpr uint32_t field_value<Reg, Mask, Bits>::bits;
+template<uint32_t Address> constexpr uint32_t reg_t<Address>::address;
+template<typename Reg, unsigned Pos, unsigned Width, typename Type> constexpr uint32_t field<Reg, Pos, Width, Type>::mask;
+} /* namespace reg */
+
+#endif /* __REG_HPP */
@@ -0,0 +1,48 @@
+/*!
+    \file       reg_device.hpp
+    \brief      device part of the typed register layer
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - The firmware library headers with C linkage, for their base addresses
+      and enums
+    - reg::rcu_clock<Periph>: the RCU enable bit of a peripheral, decoded at
+      compile time from its rcu_periph_enum value
+*/
+
+#ifndef __REG_DEVICE_HPP
+#define __REG_DEVICE_HPP
+extern "C" {
+#include "gd32h7xx_libopt.h"
+}
+#include "./REG/reg.hpp"
+
+namespace reg
+{
+/*!
+    \brief enable bit of a peripheral clock, Periph is an rcu_periph_enum value
+*/
+template<uint32_t Periph>
+struct rcu_clock : bit<reg_t<RCU + (Periph >> 6)>, (Periph & 0x1FU)>
+{
+    /*!
+        \brief      enable the clock, same store as rcu_periph_clock_enable without the call
+    */
+    static void enable(void)
+    {
+        rcu_clock::reg_type::template modify<typename rcu_clock::on>();
+    }
+
+    /*!
+        \brief      disable the clock
+    */
+    static void disable(void)
+    {
+        rcu_clock::reg_type::template modify<typename rcu_clock::off>();
+    }
+};
+} /* namespace reg */
+
+#endif /* __REG_DEVICE_HPP */
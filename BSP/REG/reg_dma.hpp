@@ -0,0 +1,120 @@
+/*!
+    \file       reg_dma.hpp
+    \brief      compile-time DMA channel descriptors
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - reg::dma_periph<Base, Clock>: interrupt flag and clear registers and its
+      channels
+    - dma_periph::channel<N>: CHxCTL fields (direction, widths, address
+      increments, priority, circular mode, interrupt enables), the counter
+      and address registers, and the channel's flags in INTF/INTC
+    - reg::dma0 and reg::dma1 descriptors
+*/
+
+#ifndef __REG_DMA_HPP
+#define __REG_DMA_HPP
+#include "./REG/reg_device.hpp"
+
+namespace reg
+{
+/*!
+    \brief transfer direction, DMA_CHxCTL TM
+*/
+enum class dma_dir : uint32_t
+{
+    periph_to_memory = 0U,                                                  /*!< DMA_PERIPH_TO_MEMORY */
+    memory_to_periph = 1U,                                                  /*!< DMA_MEMORY_TO_PERIPH */
+    memory_to_memory = 2U                                                   /*!< DMA_MEMORY_TO_MEMORY */
+};
+
+/*!
+    \brief transfer width, DMA_CHxCTL PWIDTH and MWIDTH
+*/
+enum class dma_width : uint32_t
+{
+    bits8 = 0U,                                                             /*!< 8-bit */
+    bits16 = 1U,                                                            /*!< 16-bit */
+    bits32 = 2U                                                             /*!< 32-bit */
+};
+
+/*!
+    \brief channel priority, DMA_CHxCTL PRIO
+*/
+enum class dma_priority : uint32_t
+{
+    low = 0U,                                                               /*!< DMA_PRIORITY_LOW */
+    medium = 1U,                                                            /*!< DMA_PRIORITY_MEDIUM */
+    high = 2U,                                                              /*!< DMA_PRIORITY_HIGH */
+    ultra_high = 3U                                                         /*!< DMA_PRIORITY_ULTRA_HIGH */
+};
+
+/*!
+    \brief a DMA controller at Base, clocked by the rcu_periph_enum value Clock
+*/
+template<uint32_t Base, uint32_t Clock>
+struct dma_periph
+{
+    static constexpr uint32_t base = Base;                                  /*!< controller base address */
+    typedef rcu_clock<Clock> clock;                                         /*!< RCU enable bit */
+
+    typedef reg_t<Base + 0x00U> intf0;                                      /*!< flags of channels 0-3 */
+    typedef reg_t<Base + 0x04U> intf1;                                      /*!< flags of channels 4-7 */
+    typedef reg_t<Base + 0x08U> intc0;                                      /*!< write 1: clear flags of channels 0-3 */
+    typedef reg_t<Base + 0x0CU> intc1;                                      /*!< write 1: clear flags of channels 4-7 */
+
+    /*!
+        \brief channel N of the controller
+    */
+    template<unsigned N>
+    struct channel
+    {
+        static_assert(N < 8U, "a DMA controller has 8 channels");
+        static constexpr uint32_t base = Base + 0x10U + 0x18U * N;          /*!< first channel register */
+        /* flag bits of the channel: 6 per channel, channels 2 and 3 (and 6, 7) 4 bits further, as DMA_FLAG_ADD */
+        static constexpr unsigned flag_pos = 6U * (N % 4U) + (((N % 4U) >> 1U) & 1U) * 4U;
+
+        typedef reg_t<base + 0x00U> ctl;                                    /*!< DMA_CHxCTL */
+        typedef reg_t<base + 0x04U> cnt;                                    /*!< DMA_CHxCNT, transfers left */
+        typedef reg_t<base + 0x08U> paddr;                                  /*!< DMA_CHxPADDR */
+        typedef reg_t<base + 0x0CU> m0addr;                                 /*!< DMA_CHxM0ADDR */
+        typedef reg_t<base + 0x10U> m1addr;                                 /*!< DMA_CHxM1ADDR */
+        typedef reg_t<base + 0x14U> fctl;                                   /*!< DMA_CHxFCTL */
+        typedef typename std::conditional<(N < 4U), intf0, intf1>::type intf;   /*!< flag register of the channel */
+        typedef typename std::conditional<(N < 4U), intc0, intc1>::type intc;   /*!< clear register of the channel */
+
+        typedef bit<ctl, 0U> chen;                                          /*!< DMA_CHXCTL_CHEN */
+        typedef bit<ctl, 2U> taeie;                                         /*!< DMA_CHXCTL_TAEIE */
+        typedef bit<ctl, 3U> htfie;                                         /*!< DMA_CHXCTL_HTFIE */
+        typedef bit<ctl, 4U> ftfie;                                         /*!< DMA_CHXCTL_FTFIE */
+        typedef field<ctl, 6U, 2U, dma_dir> tm;                             /*!< DMA_CHXCTL_TM */
+        typedef bit<ctl, 8U> cmen;                                          /*!< DMA_CHXCTL_CMEN */
+        typedef bit<ctl, 9U> pnaga;                                         /*!< DMA_CHXCTL_PNAGA, 1: peripheral address increments */
+        typedef bit<ctl, 10U> mnaga;                                        /*!< DMA_CHXCTL_MNAGA, 1: memory address increments */
+        typedef field<ctl, 11U, 2U, dma_width> pwidth;                      /*!< DMA_CHXCTL_PWIDTH */
+        typedef field<ctl, 13U, 2U, dma_width> mwidth;                      /*!< DMA_CHXCTL_MWIDTH */
+        typedef field<ctl, 16U, 2U, dma_priority> prio;                     /*!< DMA_CHXCTL_PRIO */
+        typedef field<cnt, 0U, 16U> count;                                  /*!< DMA_CHXCNT_CNT */
+        typedef bit<intf, flag_pos + 5U> ftf;                               /*!< full transfer finish flag */
+        typedef bit<intf, flag_pos + 4U> htf;                               /*!< half transfer finish flag */
+        typedef field_value<intc, 0x3DUL << flag_pos, 0x3DUL << flag_pos> clear_all;  /*!< INTC value clearing every flag */
+
+        /*!
+            \brief      load the counter and enable the channel
+            \param[in]  transfers: number of transfers
+        */
+        static void start(uint32_t transfers)
+        {
+            cnt::write(transfers);
+            ctl::template modify<typename chen::on>();
+        }
+    };
+};
+
+typedef dma_periph<DMA0, RCU_DMA0> dma0;                                    /*!< DMA0 */
+typedef dma_periph<DMA1, RCU_DMA1> dma1;                                    /*!< DMA1 */
+} /* namespace reg */
+
+#endif /* __REG_DMA_HPP */
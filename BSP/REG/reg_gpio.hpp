@@ -0,0 +1,148 @@
+/*!
+    \file       reg_gpio.hpp
+    \brief      compile-time GPIO port descriptors
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - reg::gpio_port<Base, Clock>: the registers of a port and its clock
+    - gpio_port::pin<N>: mode, output type, speed, pull and alternate function
+      fields of one pin, set/reset values and inline high/low/toggle/read
+    - reg::gpioa .. reg::gpiok descriptors
+*/
+
+#ifndef __REG_GPIO_HPP
+#define __REG_GPIO_HPP
+#include "./REG/reg_device.hpp"
+
+namespace reg
+{
+/*!
+    \brief pin mode, GPIO_CTL
+*/
+enum class gpio_mode : uint32_t
+{
+    input = 0U,                                                             /*!< input */
+    output = 1U,                                                            /*!< general purpose output */
+    af = 2U,                                                                /*!< alternate function */
+    analog = 3U                                                             /*!< analog */
+};
+
+/*!
+    \brief output driver, GPIO_OMODE
+*/
+enum class gpio_otype : uint32_t
+{
+    push_pull = 0U,                                                         /*!< push-pull */
+    open_drain = 1U                                                         /*!< open drain */
+};
+
+/*!
+    \brief output speed, GPIO_OSPD
+*/
+enum class gpio_speed : uint32_t
+{
+    mhz12 = 0U,                                                             /*!< GPIO_OSPEED_12MHZ */
+    mhz60 = 1U,                                                             /*!< GPIO_OSPEED_60MHZ */
+    mhz85 = 2U,                                                             /*!< GPIO_OSPEED_85MHZ */
+    mhz100_220 = 3U                                                         /*!< GPIO_OSPEED_100_220MHZ */
+};
+
+/*!
+    \brief pull resistor, GPIO_PUD
+*/
+enum class gpio_pull : uint32_t
+{
+    none = 0U,                                                              /*!< floating */
+    up = 1U,                                                                /*!< pull-up */
+    down = 2U                                                               /*!< pull-down */
+};
+
+/*!
+    \brief a GPIO port at Base, clocked by the rcu_periph_enum value Clock
+*/
+template<uint32_t Base, uint32_t Clock>
+struct gpio_port
+{
+    static constexpr uint32_t base = Base;                                  /*!< port base address */
+    typedef rcu_clock<Clock> clock;                                         /*!< RCU enable bit */
+
+    typedef reg_t<Base + 0x00U> ctl;                                        /*!< mode, 2 bits per pin */
+    typedef reg_t<Base + 0x04U> omode;                                      /*!< output type, 1 bit per pin */
+    typedef reg_t<Base + 0x08U> ospd;                                       /*!< output speed, 2 bits per pin */
+    typedef reg_t<Base + 0x0CU> pud;                                        /*!< pull-up/down, 2 bits per pin */
+    typedef reg_t<Base + 0x10U> istat;                                      /*!< input level */
+    typedef reg_t<Base + 0x14U> octl;                                       /*!< output level */
+    typedef reg_t<Base + 0x18U> bop;                                        /*!< write 1: set (bits 0-15), reset (bits 16-31) */
+    typedef reg_t<Base + 0x20U> afsel0;                                     /*!< alternate function of pins 0-7 */
+    typedef reg_t<Base + 0x24U> afsel1;                                     /*!< alternate function of pins 8-15 */
+    typedef reg_t<Base + 0x28U> bc;                                         /*!< write 1: reset */
+    typedef reg_t<Base + 0x2CU> tg;                                         /*!< write 1: toggle */
+
+    /*!
+        \brief pin N of the port
+    */
+    template<unsigned N>
+    struct pin
+    {
+        static_assert(N < 16U, "a GPIO port has 16 pins");
+        static constexpr uint32_t mask = 1UL << N;                          /*!< GPIO_PIN_N */
+
+        typedef field<ctl, 2U * N, 2U, gpio_mode> mode;                     /*!< pin mode */
+        typedef field<omode, N, 1U, gpio_otype> otype;                      /*!< output type */
+        typedef field<ospd, 2U * N, 2U, gpio_speed> speed;                  /*!< output speed */
+        typedef field<pud, 2U * N, 2U, gpio_pull> pull;                     /*!< pull resistor */
+        typedef field<typename std::conditional<(N < 8U), afsel0, afsel1>::type,
+                      4U * (N % 8U), 4U> af;                                /*!< alternate function 0-15 */
+        typedef field_value<bop, 1UL << N, 1UL << N> set;                   /*!< BOP value driving the pin high */
+        typedef field_value<bop, 1UL << (N + 16U), 1UL << (N + 16U)> reset; /*!< BOP value driving the pin low */
+
+        /*!
+            \brief      drive the pin high, one store
+        */
+        static void high(void)
+        {
+            bop::template write<set>();
+        }
+
+        /*!
+            \brief      drive the pin low, one store
+        */
+        static void low(void)
+        {
+            bop::template write<reset>();
+        }
+
+        /*!
+            \brief      invert the output, one store
+        */
+        static void toggle(void)
+        {
+            tg::write(mask);
+        }
+
+        /*!
+            \brief      input level
+            \retval     true when high
+        */
+        static bool read(void)
+        {
+            return (istat::read() & mask) != 0U;
+        }
+    };
+};
+
+typedef gpio_port<GPIOA, RCU_GPIOA> gpioa;                                  /*!< port A */
+typedef gpio_port<GPIOB, RCU_GPIOB> gpiob;                                  /*!< port B */
+typedef gpio_port<GPIOC, RCU_GPIOC> gpioc;                                  /*!< port C */
+typedef gpio_port<GPIOD, RCU_GPIOD> gpiod;                                  /*!< port D */
+typedef gpio_port<GPIOE, RCU_GPIOE> gpioe;                                  /*!< port E */
+typedef gpio_port<GPIOF, RCU_GPIOF> gpiof;                                  /*!< port F */
+typedef gpio_port<GPIOG, RCU_GPIOG> gpiog;                                  /*!< port G */
+typedef gpio_port<GPIOH, RCU_GPIOH> gpioh;                                  /*!< port H */
+typedef gpio_port<GPIOJ, RCU_GPIOJ> gpioj;                                  /*!< port J */
+typedef gpio_port<GPIOK, RCU_GPIOK> gpiok;                                  /*!< port K */
+} /* namespace reg */
+
+#endif /* __REG_GPIO_HPP */
@@ -0,0 +1,130 @@
+/*!
+    \file       reg_usart.hpp
+    \brief      compile-time USART descriptors
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - reg::usart_periph<Base, Clock, Irq>: registers, enable and interrupt
+      bits, word length, parity and stop bit fields, status flags
+    - usart_periph::baud<UclkHz, Baud>: the BAUD value of usart_baudrate_set
+      computed at compile time, with the divider range and a 2 % rate error
+      checked by the compiler
+    - reg::usart0 .. reg::uart7 descriptors
+*/
+
+#ifndef __REG_USART_HPP
+#define __REG_USART_HPP
+#include "./REG/reg_device.hpp"
+
+namespace reg
+{
+/*!
+    \brief stop bits, USART_CTL1 STB
+*/
+enum class usart_stop : uint32_t
+{
+    bits1 = 0U,                                                             /*!< 1 stop bit */
+    bits0_5 = 1U,                                                           /*!< 0.5 stop bit */
+    bits2 = 2U,                                                             /*!< 2 stop bits */
+    bits1_5 = 3U                                                            /*!< 1.5 stop bits */
+};
+
+/*!
+    \brief oversampling by 16 divider of usart_baudrate_set, rounded to nearest
+    \param[in]  uclk: USART kernel clock in Hz
+    \param[in]  baud: baud rate
+    \retval     USART_BAUD content
+*/
+constexpr uint32_t usart_div(uint32_t uclk, uint32_t baud)
+{
+    return (uint32_t)(((uint64_t)uclk + baud / 2U) / baud);
+}
+
+/*!
+    \brief actual rate of a divider within 2 % of the wanted one
+    \param[in]  uclk: USART kernel clock in Hz
+    \param[in]  baud: baud rate
+    \retval     true when the error is 2 % or less
+*/
+constexpr bool usart_rate_ok(uint32_t uclk, uint32_t baud)
+{
+    return ((uclk / usart_div(uclk, baud) > baud) ? (uclk / usart_div(uclk, baud) - baud)
+                                                  : (baud - uclk / usart_div(uclk, baud))) * 50ULL <= baud;
+}
+
+/*!
+    \brief a USART at Base, clocked by the rcu_periph_enum value Clock, interrupt Irq
+*/
+template<uint32_t Base, uint32_t Clock, IRQn_Type Irq>
+struct usart_periph
+{
+    static constexpr uint32_t base = Base;                                  /*!< peripheral base address */
+    static constexpr IRQn_Type irq = Irq;                                   /*!< NVIC interrupt */
+    typedef rcu_clock<Clock> clock;                                         /*!< RCU enable bit */
+
+    typedef reg_t<Base + 0x00U> ctl0;                                       /*!< control 0 */
+    typedef reg_t<Base + 0x04U> ctl1;                                       /*!< control 1 */
+    typedef reg_t<Base + 0x08U> ctl2;                                       /*!< control 2 */
+    typedef reg_t<Base + 0x0CU> baud_reg;                                   /*!< baud rate divider */
+    typedef reg_t<Base + 0x1CU> stat;                                       /*!< status */
+    typedef reg_t<Base + 0x20U> intc;                                       /*!< write 1: clear status */
+    typedef reg_t<Base + 0x24U> rdata;                                      /*!< received data */
+    typedef reg_t<Base + 0x28U> tdata;                                      /*!< data to transmit */
+
+    typedef bit<ctl0, 0U> uen;                                              /*!< USART_CTL0_UEN */
+    typedef bit<ctl0, 2U> ren;                                              /*!< USART_CTL0_REN */
+    typedef bit<ctl0, 3U> ten;                                              /*!< USART_CTL0_TEN */
+    typedef bit<ctl0, 4U> idleie;                                           /*!< USART_CTL0_IDLEIE */
+    typedef bit<ctl0, 5U> rbneie;                                           /*!< USART_CTL0_RBNEIE */
+    typedef bit<ctl0, 6U> tcie;                                             /*!< USART_CTL0_TCIE */
+    typedef bit<ctl0, 7U> tbeie;                                            /*!< USART_CTL0_TBEIE */
+    typedef bit<ctl0, 9U> pm;                                               /*!< USART_CTL0_PM, 1: odd parity */
+    typedef bit<ctl0, 10U> pcen;                                            /*!< USART_CTL0_PCEN */
+    typedef bit<ctl0, 12U> wl0;                                             /*!< USART_CTL0_WL0 */
+    typedef bit<ctl0, 15U> ovsmod;                                          /*!< USART_CTL0_OVSMOD, 1: oversampling by 8 */
+    typedef bit<ctl0, 28U> wl1;                                             /*!< USART_CTL0_WL1 */
+    typedef field<ctl1, 12U, 2U, usart_stop> stb;                           /*!< USART_CTL1_STB */
+    typedef bit<ctl2, 6U> denr;                                             /*!< USART_CTL2_DENR */
+    typedef bit<ctl2, 7U> dent;                                             /*!< USART_CTL2_DENT */
+    typedef bit<stat, 5U> rbne;                                             /*!< USART_STAT_RBNE */
+    typedef bit<stat, 6U> tc;                                               /*!< USART_STAT_TC */
+    typedef bit<stat, 7U> tbe;                                              /*!< USART_STAT_TBE */
+
+    /*!
+        \brief BAUD value for UclkHz and Baud with oversampling by 16
+    */
+    template<uint32_t UclkHz, uint32_t Baud>
+    struct baud : field_value<baud_reg, 0x0000FFFFU, usart_div(UclkHz, Baud) & 0x0000FFFFU>
+    {
+        static_assert(Baud != 0U, "baud rate 0");
+        static_assert((usart_div(UclkHz, Baud) >= 16U) && (usart_div(UclkHz, Baud) <= 0xFFFFU),
+                      "baud rate out of the divider range of this clock");
+        static_assert(usart_rate_ok(UclkHz, Baud), "baud rate error above 2 %");
+    };
+
+    /*!
+        \brief      send one byte, waiting for room in the data register
+        \param[in]  data: byte
+    */
+    static void put(uint8_t data)
+    {
+        while(!tbe::is_set())
+        {
+        }
+        tdata::write(data);
+    }
+};
+
+typedef usart_periph<USART0, RCU_USART0, USART0_IRQn> usart0;               /*!< USART0 */
+typedef usart_periph<USART1, RCU_USART1, USART1_IRQn> usart1;               /*!< USART1 */
+typedef usart_periph<USART2, RCU_USART2, USART2_IRQn> usart2;               /*!< USART2 */
+typedef usart_periph<UART3, RCU_UART3, UART3_IRQn> uart3;                   /*!< UART3 */
+typedef usart_periph<UART4, RCU_UART4, UART4_IRQn> uart4;                   /*!< UART4 */
+typedef usart_periph<USART5, RCU_USART5, USART5_IRQn> usart5;               /*!< USART5 */
+typedef usart_periph<UART6, RCU_UART6, UART6_IRQn> uart6;                   /*!< UART6 */
+typedef usart_periph<UART7, RCU_UART7, UART7_IRQn> uart7;                   /*!< UART7 */
+} /* namespace reg */
+
+#endif /* __REG_USART_HPP */
@@ -0,0 +1,482 @@
+/*!
+    \file       rng.c
+    \brief      TRNG entropy pool and CTR-DRBG (SP 800-90A) on CAU
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - TRNG in NIST mode with health test thresholds and clock error detection
+    - Interrupt-driven entropy pool with seed/clock error accounting
+    - AES-256 CTR-DRBG without derivation function, block cipher on CAU
+    - Known-answer self-test of the DRBG before it is seeded
+    - Random byte service with automatic reseed from the pool
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./RNG/rng.h"
+#include "./AES/aes.h"
+#include "./LOCK/lock.h"
+#include <string.h>
+
+static volatile uint32_t s_rng_pool[RNG_POOL_WORDS];                        /* entropy ring buffer */
+static volatile uint32_t s_rng_head = 0;                                    /* write index, free running */
+static volatile uint32_t s_rng_tail = 0;                                    /* read index, free running */
+static volatile uint32_t s_rng_seed_errors = 0;                             /* seed error count */
+static volatile uint32_t s_rng_clock_errors = 0;                            /* clock error count */
+static uint32_t s_rng_reseeds = 0;                                          /* DRBG reseed count */
+static rng_drbg_struct s_rng_drbg;                                          /* DRBG behind rng_random_get, under LOCK_SEM_TRNG */
+static uint8_t s_rng_ready = 0;                                             /* DRBG self-tested and seeded */
+
+/*!
+    \brief      move ready TRNG words into the pool
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Called from the TRNG interrupt and, with interrupts masked, from
+                rng_entropy_get. Disables the TRNG interrupt when the pool is full.
+*/
+static void rng_pool_fill(void)
+{
+    while((s_rng_head - s_rng_tail) < RNG_POOL_WORDS)
+    {
+        if(trng_flag_get(TRNG_FLAG_DRDY) == RESET)
+        {
+            return;
+        }
+        s_rng_pool[s_rng_head & (RNG_POOL_WORDS - 1U)] = trng_get_true_random_data();
+        s_rng_head++;
+    }
+    trng_interrupt_disable();
+}
+
+/*!
+    \brief      increment the 128-bit big-endian DRBG counter block
+    \param[in]  v: counter block
+    \param[out] none
+    \retval     none
+*/
+static void rng_drbg_v_increment(uint8_t v[16])
+{
+    int32_t i;
+
+    for(i = 15; i >= 0; i--)
+    {
+        if(++v[i] != 0)
+        {
+            break;
+        }
+    }
+}
+
+/*!
+    \brief      encrypt V+1, V+2, ... with the DRBG key on CAU
+    \param[in]  drbg: DRBG state, V is advanced by blocks + extra_blocks
+    \param[in]  blocks: number of blocks written to out
+    \param[in]  extra_blocks: number of blocks written to extra
+    \param[out] out: first part of the keystream
+    \param[out] extra: second part of the keystream
+    \retval     ErrStatus: SUCCESS or ERROR if CAU is busy
+    \note       Counter blocks are built in software and run through ECB, so the
+                full 128-bit increment of SP 800-90A is kept (CAU CTR mode only
+                increments the low word). Both parts share one CAU session.
+*/
+static ErrStatus rng_drbg_keystream(rng_drbg_struct *drbg, uint8_t *out, uint32_t blocks, \
+                                    uint8_t *extra, uint32_t extra_blocks)
+{
+    aes_context_struct ctx;
+    uint32_t out_length;
+    uint32_t i;
+    ErrStatus ret;
+
+    for(i = 0; i < blocks; i++)
+    {
+        rng_drbg_v_increment(drbg->v);
+        memcpy(out + i * AES_BLOCK_SIZE, drbg->v, AES_BLOCK_SIZE);
+    }
+    for(i = 0; i < extra_blocks; i++)
+    {
+        rng_drbg_v_increment(drbg->v);
+        memcpy(extra + i * AES_BLOCK_SIZE, drbg->v, AES_BLOCK_SIZE);
+    }
+
+    ret = aes_init(&ctx, CAU_MODE_AES_ECB, CAU_ENCRYPT, drbg->key, 256, NULL);
+    if((ret == SUCCESS) && (blocks > 0))
+    {
+        ret = aes_update(&ctx, out, blocks * AES_BLOCK_SIZE, out, NULL, NULL);
+        if(ret == SUCCESS)
+        {
+            ret = aes_wait(&ctx);
+        }
+    }
+    if((ret == SUCCESS) && (extra_blocks > 0))
+    {
+        ret = aes_update(&ctx, extra, extra_blocks * AES_BLOCK_SIZE, extra, NULL, NULL);
+        if(ret == SUCCESS)
+        {
+            ret = aes_wait(&ctx);
+        }
+    }
+    if(ERROR == aes_final(&ctx, NULL, &out_length))
+    {
+        ret = ERROR;
+    }
+    return ret;
+}
+
+/*!
+    \brief      CTR_DRBG_Update: derive a new key and V
+    \param[in]  drbg: DRBG state
+    \param[in]  provided: 48 bytes of provided data
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+static ErrStatus rng_drbg_update(rng_drbg_struct *drbg, const uint8_t provided[RNG_DRBG_SEED_SIZE])
+{
+    uint8_t temp[RNG_DRBG_SEED_SIZE];
+    uint32_t i;
+
+    if(ERROR == rng_drbg_keystream(drbg, temp, RNG_DRBG_SEED_SIZE / AES_BLOCK_SIZE, NULL, 0))
+    {
+        return ERROR;
+    }
+    for(i = 0; i < RNG_DRBG_SEED_SIZE; i++)
+    {
+        temp[i] ^= provided[i];
+    }
+    memcpy(drbg->key, temp, sizeof(drbg->key));
+    memcpy(drbg->v, temp + sizeof(drbg->key), sizeof(drbg->v));
+    memset(temp, 0, sizeof(temp));
+    return SUCCESS;
+}
+
+/*!
+    \brief      combine entropy with an optional string and run CTR_DRBG_Update
+    \param[in]  drbg: DRBG state
+    \param[in]  entropy: 48 bytes of full-entropy input
+    \param[in]  string: personalization or additional input, may be NULL
+    \param[in]  string_length: string length, at most 48 bytes
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+static ErrStatus rng_drbg_seed(rng_drbg_struct *drbg, const uint8_t *entropy, \
+                               const uint8_t *string, uint32_t string_length)
+{
+    uint8_t seed[RNG_DRBG_SEED_SIZE];
+    uint32_t i;
+    ErrStatus ret;
+
+    if(string_length > RNG_DRBG_SEED_SIZE)
+    {
+        return ERROR;
+    }
+
+    memcpy(seed, entropy, RNG_DRBG_SEED_SIZE);
+    for(i = 0; i < string_length; i++)
+    {
+        seed[i] ^= string[i];
+    }
+    ret = rng_drbg_update(drbg, seed);
+    memset(seed, 0, sizeof(seed));
+    if(ret == SUCCESS)
+    {
+        drbg->reseed_counter = 1;
+    }
+    return ret;
+}
+
+/*!
+    \brief      instantiate a CTR-DRBG
+    \param[in]  drbg: DRBG state
+    \param[in]  entropy: 48 bytes of full-entropy input
+    \param[in]  personal: personalization string, may be NULL
+    \param[in]  personal_length: personalization length, at most 48 bytes
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+ErrStatus rng_drbg_instantiate(rng_drbg_struct *drbg, const uint8_t *entropy, \
+                               const uint8_t *personal, uint32_t personal_length)
+{
+    memset(drbg, 0, sizeof(rng_drbg_struct));
+    return rng_drbg_seed(drbg, entropy, personal, personal_length);
+}
+
+/*!
+    \brief      reseed a CTR-DRBG
+    \param[in]  drbg: DRBG state
+    \param[in]  entropy: 48 bytes of full-entropy input
+    \param[in]  additional: additional input, may be NULL
+    \param[in]  additional_length: additional input length, at most 48 bytes
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+ErrStatus rng_drbg_reseed(rng_drbg_struct *drbg, const uint8_t *entropy, \
+                          const uint8_t *additional, uint32_t additional_length)
+{
+    return rng_drbg_seed(drbg, entropy, additional, additional_length);
+}
+
+/*!
+    \brief      generate CTR-DRBG output
+    \param[in]  drbg: DRBG state
+    \param[in]  length: number of bytes, at most RNG_DRBG_MAX_REQUEST
+    \param[out] output: random bytes
+    \retval     ErrStatus: SUCCESS, or ERROR if a reseed is required or CAU is busy
+    \note       Output blocks and the three blocks of the following update come
+                from one CAU pass over consecutive counter values, so a request
+                costs a single AES session whatever its size.
+*/
+ErrStatus rng_drbg_generate(rng_drbg_struct *drbg, uint8_t *output, uint32_t length)
+{
+    uint8_t temp[AES_BLOCK_SIZE + RNG_DRBG_SEED_SIZE];
+    uint32_t blocks = length / AES_BLOCK_SIZE;
+    uint32_t tail = length % AES_BLOCK_SIZE;
+    uint32_t offset = (tail > 0) ? AES_BLOCK_SIZE : 0;
+    ErrStatus ret;
+
+    if((length > RNG_DRBG_MAX_REQUEST) || (drbg->reseed_counter == 0) || \
+       (drbg->reseed_counter > RNG_DRBG_RESEED_LIMIT))
+    {
+        return ERROR;
+    }
+
+    ret = rng_drbg_keystream(drbg, output, blocks, temp, (offset + RNG_DRBG_SEED_SIZE) / AES_BLOCK_SIZE);
+    if(ret == SUCCESS)
+    {
+        memcpy(output + blocks * AES_BLOCK_SIZE, temp, tail);
+        memcpy(drbg->key, temp + offset, sizeof(drbg->key));
+        memcpy(drbg->v, temp + offset + sizeof(drbg->key), sizeof(drbg->v));
+        drbg->reseed_counter++;
+    }
+    memset(temp, 0, sizeof(temp));
+    return ret;
+}
+
+/*!
+    \brief      known-answer test of the CTR-DRBG on CAU
+    \param[in]  none
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note       Entropy input 00 01 .. 2f, no personalization, two 64-byte
+                requests; the second output is checked (CAVP style). Expected
+                values were produced by a host reference and cross-checked
+                with the OpenSSL CTR-DRBG (AES-256-CTR, no df).
+*/
+static ErrStatus rng_drbg_selftest(void)
+{
+    static const uint8_t expected[64] =
+    {
+        0x04, 0x56, 0x2a, 0xd3, 0x5e, 0x8e, 0xca, 0xfa, 0xaf, 0xda, 0x16, 0x98, 0x1c, 0xda, 0xa1, 0x47,
+        0x60, 0x6b, 0xee, 0xa6, 0x28, 0x01, 0x34, 0x2a, 0xf1, 0x3c, 0x8b, 0x55, 0x35, 0xf7, 0x2f, 0x94,
+        0x95, 0xb7, 0x43, 0x17, 0xc7, 0x62, 0xf0, 0xad, 0xab, 0x7a, 0xbe, 0x71, 0x07, 0x97, 0x61, 0x21,
+        0x76, 0xb6, 0x1b, 0x0e, 0x20, 0x83, 0x98, 0x11, 0x3c, 0xf9, 0xc1, 0x70, 0x15, 0x7b, 0xc7, 0x5f
+    };
+    rng_drbg_struct drbg;
+    uint8_t entropy[RNG_DRBG_SEED_SIZE];
+    __ALIGNED(4) uint8_t output[64];
+    ErrStatus ret;
+    uint32_t i;
+
+    for(i = 0; i < RNG_DRBG_SEED_SIZE; i++)
+    {
+        entropy[i] = (uint8_t)i;
+    }
+
+    ret = rng_drbg_instantiate(&drbg, entropy, NULL, 0);
+    if(ret == SUCCESS)
+    {
+        ret = rng_drbg_generate(&drbg, output, sizeof(output));
+    }
+    if(ret == SUCCESS)
+    {
+        ret = rng_drbg_generate(&drbg, output, sizeof(output));
+    }
+    if((ret == SUCCESS) && (memcmp(output, expected, sizeof(expected)) != 0))
+    {
+        ret = ERROR;
+    }
+    memset(&drbg, 0, sizeof(drbg));
+    return ret;
+}
+
+/*!
+    \brief      start the TRNG entropy pool, self-test and seed the DRBG
+    \param[in]  none
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note       Call after lock_init and aes_engine_init. The TRNG runs from IRC48M on CK48M.
+*/
+ErrStatus rng_init(void)
+{
+    uint8_t seed[RNG_DRBG_SEED_SIZE];
+    uint32_t counter = 0;
+    ErrStatus ret;
+
+    s_rng_ready = 0;
+
+    rcu_osci_on(RCU_IRC48M);
+    if(ERROR == rcu_osci_stab_wait(RCU_IRC48M))
+    {
+        return ERROR;
+    }
+    rcu_ck48m_clock_config(RCU_CK48MSRC_IRC48M);
+    rcu_periph_clock_enable(RCU_TRNG);
+    trng_deinit();
+
+    /* configuration is only taken while the conditioning logic is held in reset */
+    trng_conditioning_reset_enable();
+    trng_mode_config(TRNG_MODSEL_NIST);
+    trng_health_tests_config(RNG_HT_APT_THRESHOLD, RNG_HT_RCT_THRESHOLD);
+    trng_clockerror_detection_enable();
+    trng_conditioning_reset_disable();
+
+    s_rng_head = 0;
+    s_rng_tail = 0;
+    s_rng_seed_errors = 0;
+    s_rng_clock_errors = 0;
+    s_rng_reseeds = 0;
+
+    trng_interrupt_enable();
+    nvic_irq_enable(HAU_TRNG_IRQn, 4, 0);
+    trng_enable();
+
+    if(ERROR == rng_drbg_selftest())
+    {
+        return ERROR;
+    }
+
+    while(ERROR == rng_entropy_get(seed, sizeof(seed)))
+    {
+        if(++counter == RNG_SEED_TIMEOUT)
+        {
+            return ERROR;
+        }
+    }
+    ret = rng_drbg_instantiate(&s_rng_drbg, seed, NULL, 0);
+    memset(seed, 0, sizeof(seed));
+    s_rng_ready = (ret == SUCCESS) ? 1 : 0;
+    return ret;
+}
+
+/*!
+    \brief      take raw entropy from the pool
+    \param[in]  length: number of bytes
+    \param[out] buffer: entropy bytes
+    \retval     ErrStatus: SUCCESS, or ERROR if the pool does not hold enough words yet
+    \note       Whole words are consumed, so a 3-byte request still takes one word.
+*/
+ErrStatus rng_entropy_get(uint8_t *buffer, uint32_t length)
+{
+    uint32_t words = (length + 3U) / 4U;
+    uint32_t primask;
+    uint32_t word;
+
+    if(words > RNG_POOL_WORDS)
+    {
+        return ERROR;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    rng_pool_fill();
+    if((s_rng_head - s_rng_tail) < words)
+    {
+        __set_PRIMASK(primask);
+        return ERROR;
+    }
+    while(length > 0)
+    {
+        word = s_rng_pool[s_rng_tail & (RNG_POOL_WORDS - 1U)];
+        s_rng_pool[s_rng_tail & (RNG_POOL_WORDS - 1U)] = 0;
+        s_rng_tail++;
+        memcpy(buffer, &word, (length < 4U) ? length : 4U);
+        buffer += (length < 4U) ? length : 4U;
+        length -= (length < 4U) ? length : 4U;
+    }
+    trng_interrupt_enable();                                                /* refill what was taken */
+    __set_PRIMASK(primask);
+    return SUCCESS;
+}
+
+/*!
+    \brief      get random bytes from the seeded DRBG
+    \param[in]  length: number of bytes, any value
+    \param[out] buffer: random bytes
+    \retval     ErrStatus: SUCCESS or ERROR if not initialized, DRBG or CAU busy or reseed overdue
+    \note       The DRBG is held through LOCK_SEM_TRNG, so an ISR that interrupts
+                another request gets ERROR instead of a repeated output. Reseeds from the pool every RNG_DRBG_RESEED_INTERVAL requests when
+                entropy is available; generation continues from the current seed
+                until RNG_DRBG_RESEED_LIMIT if the TRNG keeps failing.
+*/
+ErrStatus rng_random_get(uint8_t *buffer, uint32_t length)
+{
+    uint8_t seed[RNG_DRBG_SEED_SIZE];
+    uint32_t take;
+    ErrStatus ret = SUCCESS;
+
+    if((s_rng_ready == 0) || (SUCCESS != lock_try(LOCK_SEM_TRNG)))
+    {
+        return ERROR;
+    }
+
+    while((length > 0) && (ret == SUCCESS))
+    {
+        if((s_rng_drbg.reseed_counter > RNG_DRBG_RESEED_INTERVAL) && \
+           (SUCCESS == rng_entropy_get(seed, sizeof(seed))))
+        {
+            if(SUCCESS == rng_drbg_reseed(&s_rng_drbg, seed, NULL, 0))
+            {
+                s_rng_reseeds++;
+            }
+            memset(seed, 0, sizeof(seed));
+        }
+
+        take = (length > RNG_DRBG_MAX_REQUEST) ? RNG_DRBG_MAX_REQUEST : length;
+        ret = rng_drbg_generate(&s_rng_drbg, buffer, take);
+        buffer += take;
+        length -= take;
+    }
+    lock_release(LOCK_SEM_TRNG);
+    return ret;
+}
+
+/*!
+    \brief      read pool level and health counters
+    \param[in]  none
+    \param[out] status: entropy service status
+    \retval     none
+*/
+void rng_status_get(rng_status_struct *status)
+{
+    status->pool_words   = s_rng_head - s_rng_tail;
+    status->seed_errors  = s_rng_seed_errors;
+    status->clock_errors = s_rng_clock_errors;
+    status->reseeds      = s_rng_reseeds;
+}
+
+/*!
+    \brief      HAU and TRNG interrupt handler, fills the pool and records health errors
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       On a seed error the pool content is discarded and the conditioning
+                logic restarted, since words already buffered may come from the
+                faulty period. HAU interrupts are not used by the HASH module.
+*/
+void HAU_TRNG_IRQHandler(void)
+{
+    if(trng_interrupt_flag_get(TRNG_INT_FLAG_SEIF) == SET)
+    {
+        trng_interrupt_flag_clear(TRNG_INT_FLAG_SEIF);
+        s_rng_seed_errors++;
+        s_rng_tail = s_rng_head;
+        trng_conditioning_reset_enable();
+        trng_conditioning_reset_disable();
+    }
+    if(trng_interrupt_flag_get(TRNG_INT_FLAG_CEIF) == SET)
+    {
+        trng_interrupt_flag_clear(TRNG_INT_FLAG_CEIF);
+        s_rng_clock_errors++;
+    }
+    rng_pool_fill();
+}
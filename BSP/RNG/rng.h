@@ -0,0 +1,66 @@
+/*!
+    \file       rng.h
+    \brief      header file for TRNG entropy pool and CTR-DRBG on CAU
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - TRNG entropy pool size and health test threshold configuration
+    - CTR-DRBG (AES-256, no derivation function) state structure
+    - Entropy, DRBG and random byte service function declarations
+*/
+
+#ifndef __RNG_H
+#define __RNG_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief TRNG entropy pool configuration macros
+*/
+#define RNG_POOL_WORDS              64U                                     /*!< entropy pool size in 32-bit words, power of 2 */
+#define RNG_HT_APT_THRESHOLD        589U                                    /*!< adaptive proportion test cutoff (1024-bit window) */
+#define RNG_HT_RCT_THRESHOLD        21U                                     /*!< repetition count test cutoff */
+#define RNG_SEED_TIMEOUT            ((uint32_t)0x00100000U)                 /*!< wait for first seed in rng_init */
+
+/*!
+    \brief CTR-DRBG configuration macros
+*/
+#define RNG_DRBG_SEED_SIZE          48U                                     /*!< seedlen: 256-bit key + 128-bit V */
+#define RNG_DRBG_MAX_REQUEST        65536U                                  /*!< max bytes per generate (2^19 bits) */
+#define RNG_DRBG_RESEED_INTERVAL    1024U                                   /*!< requests before reseed from the pool */
+#define RNG_DRBG_RESEED_LIMIT       ((uint32_t)0x00100000U)                 /*!< requests allowed when the pool stays empty */
+
+/*!
+    \brief CTR-DRBG working state
+*/
+typedef struct
+{
+    uint8_t key[32];                                                        /*!< AES-256 key */
+    uint8_t v[16];                                                          /*!< counter block */
+    uint32_t reseed_counter;                                                /*!< generate requests since last (re)seed */
+} rng_drbg_struct;
+
+/*!
+    \brief entropy service status
+*/
+typedef struct
+{
+    uint32_t pool_words;                                                    /*!< entropy words currently in pool */
+    uint32_t seed_errors;                                                   /*!< TRNG seed (health test) errors */
+    uint32_t clock_errors;                                                  /*!< TRNG clock errors */
+    uint32_t reseeds;                                                       /*!< DRBG reseeds from the pool */
+} rng_status_struct;
+
+/* function declarations */
+ErrStatus rng_init(void);                                                               /*!< start TRNG pool, self-test and seed DRBG */
+ErrStatus rng_entropy_get(uint8_t *buffer, uint32_t length);                            /*!< take raw entropy from the pool */
+ErrStatus rng_random_get(uint8_t *buffer, uint32_t length);                             /*!< random bytes from the seeded DRBG */
+void rng_status_get(rng_status_struct *status);                                         /*!< read pool level and health counters */
+ErrStatus rng_drbg_instantiate(rng_drbg_struct *drbg, const uint8_t *entropy, \
+                               const uint8_t *personal, uint32_t personal_length);      /*!< instantiate DRBG from 48-byte entropy */
+ErrStatus rng_drbg_reseed(rng_drbg_struct *drbg, const uint8_t *entropy, \
+                          const uint8_t *additional, uint32_t additional_length);       /*!< reseed DRBG from 48-byte entropy */
+ErrStatus rng_drbg_generate(rng_drbg_struct *drbg, uint8_t *output, uint32_t length);   /*!< generate DRBG output */
+#endif /* __RNG_H */
@@ -0,0 +1,432 @@
+/*!
+    \file       rtos.c
+    \brief      FreeRTOS integration: static allocation, tickless idle, deferred interrupt work
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Statically allocated main, idle and timer daemon tasks, no kernel heap
+    - Tickless idle: deep-sleep through BSP/IDLE when the idle period allows
+      it, otherwise the port's stretched-SysTick WFI, both counted in the
+      idle statistics and the DVFS load meter
+    - Deferred interrupt work on the timer daemon task, used by the USART
+      reception timeouts to run their handlers in task context
+    - Context switch and interrupt-to-task latency measured with DWT_CYCCNT
+    - Per-task run time from TIMER50 (BSP/TIMER)
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./RTOS/rtos.h"
+
+#if SYSTEM_SUPPORT_OS
+#include "timers.h"
+#include "./IDLE/idle.h"
+#include "./TIMER/timer.h"
+#include "./USART/usart.h"
+#include <string.h>
+
+#define RTOS_STATS_BUFF_SIZE        640U                                    /* vTaskGetRunTimeStats output, about 40 bytes per task */
+
+extern void vPortSuppressTicksAndSleep(TickType_t expected_ticks);         /* port tickless idle, declared by portmacro.h only without an override */
+
+static StaticTask_t s_rtos_main_tcb;                                        /* main task */
+static StackType_t s_rtos_main_stack[RTOS_MAIN_STACK_DEPTH];
+static StaticTask_t s_rtos_idle_tcb;                                        /* idle task */
+static StackType_t s_rtos_idle_stack[configMINIMAL_STACK_SIZE];
+static StaticTask_t s_rtos_timer_tcb;                                       /* timer daemon task, runs the deferred work */
+static StackType_t s_rtos_timer_stack[configTIMER_TASK_STACK_DEPTH];
+static StaticTask_t s_rtos_bench_tcb;                                       /* benchmark task */
+static StackType_t s_rtos_bench_stack[RTOS_BENCH_STACK_DEPTH];
+
+static volatile rtos_rx_handler_fn s_rtos_rx_handler[RTOS_RX_NUM];          /* reception-complete handlers */
+static volatile uint32_t s_rtos_defer_dropped = 0;                          /* deferred work lost on a full timer queue */
+static uint32_t s_rtos_sleep_start = 0;                                     /* timer_monotonic_us at the port's WFI */
+
+static TaskHandle_t s_rtos_bench_task = NULL;                               /* benchmark task, created on first use */
+static rtos_bench_struct *s_rtos_bench_result = NULL;                       /* results being collected */
+static rtos_latency_struct *volatile s_rtos_bench_target = NULL;            /* statistics the benchmark task adds to */
+static volatile uint32_t s_rtos_bench_stamp = 0;                            /* DWT_CYCCNT when the measured event was raised */
+
+/*!
+    \brief      create the main task and start the scheduler
+    \param[in]  main_fn: main task function, RTOS_MAIN_PRIORITY
+    \param[out] none
+    \retval     none, does not return
+    \note       Call at the end of the bare-metal initialisation in main, after
+                dvfs_init and idle_init, which tickless deep-sleep needs. The
+                port takes over SysTick; SysTick_Handler in BSP/DELAY forwards
+                the tick once the scheduler runs.
+*/
+void rtos_start(TaskFunction_t main_fn)
+{
+    xTaskCreateStatic(main_fn, "main", RTOS_MAIN_STACK_DEPTH, NULL, RTOS_MAIN_PRIORITY,
+                      s_rtos_main_stack, &s_rtos_main_tcb);
+    vTaskStartScheduler();
+    while(1)
+    {
+    }
+}
+
+/*!
+    \brief      provide the idle task memory, required by configSUPPORT_STATIC_ALLOCATION
+    \param[in]  none
+    \param[out] tcb: task control block
+    \param[out] stack: stack
+    \param[out] depth: stack depth in words
+    \retval     none
+*/
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *depth)
+{
+    *tcb = &s_rtos_idle_tcb;
+    *stack = s_rtos_idle_stack;
+    *depth = configMINIMAL_STACK_SIZE;
+}
+
+/*!
+    \brief      provide the timer daemon task memory, required by configUSE_TIMERS
+    \param[in]  none
+    \param[out] tcb: task control block
+    \param[out] stack: stack
+    \param[out] depth: stack depth in words
+    \retval     none
+*/
+void vApplicationGetTimerTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *depth)
+{
+    *tcb = &s_rtos_timer_tcb;
+    *stack = s_rtos_timer_stack;
+    *depth = configTIMER_TASK_STACK_DEPTH;
+}
+
+/*!
+    \brief      stack overflow detected at a context switch
+    \param[in]  task: offending task
+    \param[in]  name: its name
+    \param[out] none
+    \retval     none
+    \note       Masks interrupts and stops, so TIMER16 no longer feeds the
+                watchdog and the FWDGT resets the system.
+*/
+void vApplicationStackOverflowHook(TaskHandle_t task, char *name)
+{
+    (void)task;
+    PRINT_ERROR("stack overflow in task %s\r\n", name);
+    __disable_irq();
+    while(1)
+    {
+    }
+}
+
+/*!
+    \brief      tickless idle entry, portSUPPRESS_TICKS_AND_SLEEP
+    \param[in]  expected_ticks: ticks until the next task unblocks
+    \param[out] none
+    \retval     none
+    \note       Called by the idle task with the scheduler suspended. When BSP/IDLE
+                selects deep-sleep, SysTick is stopped, the RTC wakeup timer ends
+                the sleep and the ticks are stepped from the monotonic timer,
+                which idle advances by the RTC measured time; the fraction of the
+                tick in progress at entry is lost. Any other state goes to the
+                port's implementation, which stretches SysTick over the period.
+                The port caches the tick length at scheduler start, so DVFS
+                operating point changes are not supported in this build type;
+                dvfs_init and idle_init still run before rtos_start, so the boot
+                point is known and deep-sleep can restore it.
+*/
+void rtos_suppress_ticks(uint32_t expected_ticks)
+{
+    uint32_t sleep_us, start, ticks;
+
+    sleep_us = (expected_ticks >= IDLE_FOREVER / RTOS_TICK_US) ? IDLE_FOREVER : expected_ticks * RTOS_TICK_US;
+
+    __disable_irq();
+    __DSB();
+    __ISB();
+    if(idle_select(sleep_us) != IDLE_STATE_DEEPSLEEP)
+    {
+        __enable_irq();
+        vPortSuppressTicksAndSleep(expected_ticks);
+        return;
+    }
+    if(eTaskConfirmSleepModeStatus() == eAbortSleep)
+    {
+        __enable_irq();
+        return;
+    }
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    start = timer_monotonic_us();
+    idle_enter(sleep_us);                                                   /* selects deep-sleep again, nothing changed with interrupts masked */
+    ticks = (timer_monotonic_us() - start) / RTOS_TICK_US;
+    if(ticks >= expected_ticks)
+    {
+        ticks = expected_ticks - 1U;                                        /* the restarted SysTick delivers the last one */
+    }
+    vTaskStepTick(ticks);
+    SysTick->VAL = 0U;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    __enable_irq();
+}
+
+/*!
+    \brief      configPRE_SLEEP_PROCESSING: note the start of the port's WFI
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void rtos_sleep_pre(void)
+{
+    s_rtos_sleep_start = timer_monotonic_us();
+}
+
+/*!
+    \brief      configPOST_SLEEP_PROCESSING: account the port's WFI as sleep
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void rtos_sleep_post(void)
+{
+    idle_account(IDLE_STATE_SLEEP, timer_monotonic_us() - s_rtos_sleep_start, 0);
+}
+
+/*!
+    \brief      run a function in the timer daemon task
+    \param[in]  fn: function
+    \param[in]  arg: first argument of fn
+    \param[in]  value: second argument of fn
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if queued, ERROR if the timer queue is full
+    \note       For interrupts at priority configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+                or lower. The daemon task has the highest task priority, so fn
+                runs as soon as the interrupt returns.
+*/
+ErrStatus rtos_defer_from_isr(rtos_deferred_fn fn, void *arg, uint32_t value)
+{
+    BaseType_t woken = pdFALSE;
+
+    if(xTimerPendFunctionCallFromISR(fn, arg, value, &woken) != pdPASS)
+    {
+        s_rtos_defer_dropped++;
+        return ERROR;
+    }
+    portYIELD_FROM_ISR(woken);
+    return SUCCESS;
+}
+
+/*!
+    \brief      deferred part of a reception-complete signal
+    \param[in]  arg: unused
+    \param[in]  source: rtos_rx_enum
+    \param[out] none
+    \retval     none
+*/
+static void rtos_rx_deferred(void *arg, uint32_t source)
+{
+    rtos_rx_handler_fn handler = s_rtos_rx_handler[source];
+
+    (void)arg;
+    if(handler != NULL)
+    {
+        handler();
+    }
+}
+
+/*!
+    \brief      set the reception-complete handler of a USART
+    \param[in]  source: rtos_rx_enum
+    \param[in]  handler: handler run in the timer daemon task, NULL to remove
+    \param[out] none
+    \retval     none
+    \note       The reception flags and buffers of BSP/USART are unchanged; the
+                handler reads them instead of a task polling the flag.
+*/
+void rtos_rx_handler_set(uint8_t source, rtos_rx_handler_fn handler)
+{
+    if(source < RTOS_RX_NUM)
+    {
+        s_rtos_rx_handler[source] = handler;
+    }
+}
+
+/*!
+    \brief      signal reception complete, called by the TIMER timeout interrupts
+    \param[in]  source: rtos_rx_enum
+    \param[out] none
+    \retval     none
+*/
+void rtos_rx_complete_isr(uint8_t source)
+{
+    if((source < RTOS_RX_NUM) && (s_rtos_rx_handler[source] != NULL) &&
+       (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED))
+    {
+        rtos_defer_from_isr(rtos_rx_deferred, NULL, source);
+    }
+}
+
+/*!
+    \brief      add one sample to latency statistics
+    \param[in]  latency: statistics
+    \param[in]  cycles: measured latency
+    \param[out] none
+    \retval     none
+*/
+static void rtos_latency_add(rtos_latency_struct *latency, uint32_t cycles)
+{
+    latency->samples++;
+    latency->total_cycles += cycles;
+    if(cycles < latency->min_cycles)
+    {
+        latency->min_cycles = cycles;
+    }
+    if(cycles > latency->max_cycles)
+    {
+        latency->max_cycles = cycles;
+    }
+}
+
+/*!
+    \brief      benchmark task: time from the stamp to running after a notification
+    \param[in]  arg: unused
+    \param[out] none
+    \retval     none
+*/
+static void rtos_bench_task(void *arg)
+{
+    uint32_t now;
+
+    (void)arg;
+    while(1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        now = DWT_CYCCNT;
+        rtos_latency_add(s_rtos_bench_target, now - s_rtos_bench_stamp);
+    }
+}
+
+/*!
+    \brief      benchmark interrupt: time to the handler, then notify the benchmark task
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void RTOS_BENCH_IRQHandler(void)
+{
+    BaseType_t woken = pdFALSE;
+    uint32_t now = DWT_CYCCNT;
+
+    rtos_latency_add(&s_rtos_bench_result->irq_entry, now - s_rtos_bench_stamp);
+    vTaskNotifyGiveFromISR(s_rtos_bench_task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+/*!
+    \brief      measure context switch and interrupt-to-task latency
+    \param[in]  rounds: samples per measurement
+    \param[out] result: latency statistics in core cycles
+    \retval     none
+    \note       Task context, below priority configMAX_PRIORITIES - 2. The benchmark
+                task runs one priority above the caller, so every notification
+                preempts it:
+                - context switch: xTaskNotifyGive to the woken task running
+                - interrupt-to-task: RTOS_BENCH_IRQ pended to its handler running
+                  and to the task it notifies running, through PendSV
+                Needs system_dwt_init. The first sample includes cache misses.
+*/
+void rtos_bench_run(uint32_t rounds, rtos_bench_struct *result)
+{
+    UBaseType_t priority = uxTaskPriorityGet(NULL) + 1U;
+    uint32_t i;
+
+    memset(result, 0, sizeof(*result));
+    result->context_switch.min_cycles = 0xFFFFFFFFU;
+    result->irq_entry.min_cycles = 0xFFFFFFFFU;
+    result->irq_to_task.min_cycles = 0xFFFFFFFFU;
+    if(priority >= configTIMER_TASK_PRIORITY)
+    {
+        PRINT_WARN("rtos bench: caller priority too high\r\n");
+        return;
+    }
+
+    if(s_rtos_bench_task == NULL)
+    {
+        s_rtos_bench_task = xTaskCreateStatic(rtos_bench_task, "bench", RTOS_BENCH_STACK_DEPTH, NULL, priority,
+                                              s_rtos_bench_stack, &s_rtos_bench_tcb);
+    }
+    else
+    {
+        vTaskPrioritySet(s_rtos_bench_task, priority);
+    }
+    s_rtos_bench_result = result;
+
+    s_rtos_bench_target = &result->context_switch;
+    for(i = 0; i < rounds; i++)
+    {
+        s_rtos_bench_stamp = DWT_CYCCNT;
+        xTaskNotifyGive(s_rtos_bench_task);
+    }
+
+    s_rtos_bench_target = &result->irq_to_task;
+    NVIC_ClearPendingIRQ(RTOS_BENCH_IRQ);
+    nvic_irq_enable(RTOS_BENCH_IRQ, RTOS_BENCH_IRQ_PRIORITY, 0);
+    for(i = 0; i < rounds; i++)
+    {
+        s_rtos_bench_stamp = DWT_CYCCNT;
+        NVIC_SetPendingIRQ(RTOS_BENCH_IRQ);
+        __DSB();
+        __ISB();
+    }
+    nvic_irq_disable(RTOS_BENCH_IRQ);
+}
+
+/*!
+    \brief      print one latency line
+    \param[in]  name: measurement name
+    \param[in]  latency: statistics
+    \param[out] none
+    \retval     none
+*/
+static void rtos_latency_print(const char *name, const rtos_latency_struct *latency)
+{
+    uint32_t mhz = SystemCoreClock / 1000000U;
+    uint32_t avg;
+
+    if(latency->samples == 0U)
+    {
+        return;
+    }
+    avg = (uint32_t)(latency->total_cycles / latency->samples);
+    PRINT("%-12s min %5u avg %5u max %5u cycles, avg %u ns (%u samples)\r\n", name,
+          (unsigned)latency->min_cycles, (unsigned)avg, (unsigned)latency->max_cycles,
+          (unsigned)(avg * 1000U / mhz), (unsigned)latency->samples);
+}
+
+/*!
+    \brief      print benchmark results
+    \param[in]  result: results of rtos_bench_run
+    \param[out] none
+    \retval     none
+*/
+void rtos_bench_print(const rtos_bench_struct *result)
+{
+    rtos_latency_print("switch", &result->context_switch);
+    rtos_latency_print("irq entry", &result->irq_entry);
+    rtos_latency_print("irq to task", &result->irq_to_task);
+}
+
+/*!
+    \brief      print per-task run time and deferred work drops
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Run time in TIMER50 counts, see ConfigureTimeForRunTimeStats.
+*/
+void rtos_stats_print(void)
+{
+    static char buff[RTOS_STATS_BUFF_SIZE];
+
+    vTaskGetRunTimeStats(buff);
+    PRINT("task            run time        %%\r\n%s", buff);
+    PRINT("deferred work dropped: %u\r\n", (unsigned)s_rtos_defer_dropped);
+}
+#endif /* SYSTEM_SUPPORT_OS */
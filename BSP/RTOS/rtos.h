@@ -0,0 +1,82 @@
+/*!
+    \file       rtos.h
+    \brief      header file for the FreeRTOS integration
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Main task and scheduler start with statically allocated kernel objects
+    - Deferred interrupt work run by the timer daemon task
+    - Reception-complete handlers for the USART drivers, run as deferred work
+    - Context switch and interrupt-to-task latency benchmarks
+
+    Everything here exists only in the RTOS build type (SYSTEM_SUPPORT_OS=1).
+*/
+
+#ifndef __RTOS_H
+#define __RTOS_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+#include "./SYSTEM/system.h"
+
+#if SYSTEM_SUPPORT_OS
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*!
+    \brief rtos configuration macros
+*/
+#define RTOS_MAIN_STACK_DEPTH       1024U                                   /*!< main task stack in words */
+#define RTOS_MAIN_PRIORITY          2U                                      /*!< main task priority */
+#define RTOS_BENCH_STACK_DEPTH      256U                                    /*!< benchmark task stack in words */
+#define RTOS_BENCH_IRQ              SAI2_IRQn                               /*!< unused interrupt pended by the interrupt-to-task benchmark */
+#define RTOS_BENCH_IRQHandler       SAI2_IRQHandler                         /*!< its handler */
+#define RTOS_BENCH_IRQ_PRIORITY     configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY /*!< highest priority allowed to call the FreeRTOS API */
+#define RTOS_TICK_US                (1000000U / configTICK_RATE_HZ)         /*!< tick period in microseconds */
+
+/*!
+    \brief USART reception-complete sources, signalled by the TIMER timeout interrupts
+*/
+typedef enum
+{
+    RTOS_RX_BSP_USART = 0,                                                  /*!< BSP_USART, TIMER5 timeout */
+    RTOS_RX_TERMINAL,                                                       /*!< terminal USART, TIMER6 timeout */
+    RTOS_RX_UART4,                                                          /*!< UART4, TIMER15 timeout */
+    RTOS_RX_NUM
+} rtos_rx_enum;
+
+typedef void (*rtos_deferred_fn)(void *arg, uint32_t value);                /*!< deferred work, runs in the timer daemon task */
+typedef void (*rtos_rx_handler_fn)(void);                                   /*!< reception-complete handler, task context */
+
+/*!
+    \brief latency statistics in core cycles
+*/
+typedef struct
+{
+    uint32_t samples;                                                       /*!< measurements taken */
+    uint32_t min_cycles;                                                    /*!< shortest latency */
+    uint32_t max_cycles;                                                    /*!< longest latency */
+    uint64_t total_cycles;                                                  /*!< sum, for the average */
+} rtos_latency_struct;
+
+/*!
+    \brief benchmark results
+*/
+typedef struct
+{
+    rtos_latency_struct context_switch;                                     /*!< task notify to the woken task running */
+    rtos_latency_struct irq_entry;                                          /*!< interrupt pended to its handler running */
+    rtos_latency_struct irq_to_task;                                        /*!< interrupt pended to the notified task running */
+} rtos_bench_struct;
+
+/* function declarations */
+void rtos_start(TaskFunction_t main_fn);                                                /*!< create the main task and start the scheduler */
+ErrStatus rtos_defer_from_isr(rtos_deferred_fn fn, void *arg, uint32_t value);          /*!< run fn in the timer daemon task */
+void rtos_rx_handler_set(uint8_t source, rtos_rx_handler_fn handler);                   /*!< set the reception-complete handler of a source */
+void rtos_rx_complete_isr(uint8_t source);                                              /*!< signal reception complete, from the timeout interrupt */
+void rtos_bench_run(uint32_t rounds, rtos_bench_struct *result);                        /*!< measure switch and interrupt latency, task context */
+void rtos_bench_print(const rtos_bench_struct *result);                                 /*!< print benchmark results */
+void rtos_stats_print(void);                                                            /*!< print per-task run time and deferred work drops */
+#endif /* SYSTEM_SUPPORT_OS */
+#endif /* __RTOS_H */
@@ -0,0 +1,267 @@
+/*!
+    \file       sensorhub.c
+    \brief      sensor hub polling layer on the I2C master
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Sensor registration with register read, period and batching slack
+    - One batch per bus wakeup: due reads go to the bus driver as a chain of
+      transactions that runs from interrupts and DMA without the main loop
+    - Timestamped publishing into per-sensor sample rings
+    - Statistics with modelled and measured bus utilisation
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./SENSORHUB/sensorhub.h"
+#include "./I2C/i2c.h"
+#include "./TIMER/timer.h"
+#include "./USART/usart.h"
+#include "./ECC/ecc.h"
+
+#define SENSORHUB_LINE_SIZE         32U                                     /* DMA buffer per read, one D-cache line */
+
+static sensorhub_sensor_struct *s_hub_sensors[SENSORHUB_MAX_SENSORS];       /* registered sensors */
+static sensorhub_read_struct s_hub_reads[SENSORHUB_MAX_SENSORS];            /* read declarations for the scheduler */
+static uint8_t s_hub_count = 0;                                             /* registered sensors */
+static sensorhub_sched_struct s_hub_sched;                                  /* scheduler state */
+static uint32_t s_hub_i2c_hz = 400000U;                                     /* I2C clock for the load model */
+static uint32_t s_hub_batches = 0;                                          /* batches submitted */
+static uint32_t s_hub_reads_done = 0;                                       /* reads submitted */
+static uint32_t s_hub_errors = 0;                                           /* failed reads */
+
+/* I2C batch, reused once every transaction of the previous batch completed */
+static i2c_xfer_struct s_hub_i2c_xfer[SENSORHUB_MAX_SENSORS];               /* one transaction per read */
+static i2c_seg_struct s_hub_i2c_seg[SENSORHUB_MAX_SENSORS][2];              /* register write, data read */
+static uint8_t s_hub_i2c_reg[SENSORHUB_MAX_SENSORS];                        /* register addresses */
+ECC_DMA_BUFFER __ALIGNED(I2C_MASTER_RX_ALIGN) static uint8_t s_hub_i2c_data[SENSORHUB_MAX_SENSORS][SENSORHUB_LINE_SIZE]; /* DMA targets */
+static uint8_t s_hub_i2c_ids[SENSORHUB_MAX_SENSORS];                        /* sensor of each transaction */
+static volatile uint8_t s_hub_i2c_pending = 0;                              /* transactions of the batch still running */
+
+/* each read owns whole cache lines, invalidated by the I2C driver when it completes */
+typedef char sensorhub_line_check[(((SENSORHUB_LINE_SIZE % I2C_MASTER_RX_ALIGN) == 0U) && \
+                                   (SENSORHUB_SAMPLE_MAX <= SENSORHUB_LINE_SIZE)) ? 1 : -1];
+
+/*!
+    \brief      publish the result of one batched read
+    \param[in]  xfer: completed transaction
+    \param[in]  arg: slot in the batch
+    \param[out] none
+    \retval     none
+    \note       Called from the I2C interrupt. The timestamp is taken at the
+                STOP of this read, not at the batch start.
+*/
+static void sensorhub_i2c_done(i2c_xfer_struct *xfer, void *arg)
+{
+    uint32_t slot = (uint32_t)arg;
+    sensorhub_sensor_struct *sensor = s_hub_sensors[s_hub_i2c_ids[slot]];
+    sensorhub_sample_struct *sample;
+
+    if(xfer->status != I2C_XFER_OK)
+    {
+        sensor->errors++;
+        s_hub_errors++;
+    }
+    else if((sensor->head - sensor->tail) < sensor->depth)
+    {
+        sample = &sensor->ring[sensor->head & (sensor->depth - 1U)];
+        sample->time_us = timer_monotonic_us();
+        sample->length = sensor->read.length;
+        memcpy(sample->data, s_hub_i2c_data[slot], sensor->read.length);
+        sensor->head++;
+    }
+    else
+    {
+        sensor->overruns++;
+    }
+    s_hub_i2c_pending--;
+}
+
+/*!
+    \brief      reset the hub
+    \param[in]  i2c_hz: I2C bus clock given to i2c_master_init, used by the load model
+    \param[out] none
+    \retval     none
+*/
+void sensorhub_init(uint32_t i2c_hz)
+{
+    s_hub_count = 0;
+    s_hub_i2c_hz = i2c_hz;
+    s_hub_i2c_pending = 0;
+    s_hub_batches = 0;
+    s_hub_reads_done = 0;
+    s_hub_errors = 0;
+    sensorhub_sched_init(&s_hub_sched, 0, timer_monotonic_us());
+}
+
+/*!
+    \brief      add a sensor to the hub
+    \param[in]  sensor: descriptor with read, ring and depth filled in, must
+                stay valid while the hub runs
+    \param[out] none
+    \retval     ErrStatus: SUCCESS, or ERROR if the hub is full or the
+                descriptor is invalid
+    \note       The first read is due at once. Reads of one bus due within the
+                slack of each other share a batch.
+*/
+ErrStatus sensorhub_register(sensorhub_sensor_struct *sensor)
+{
+    const sensorhub_read_struct *read = &sensor->read;
+
+    if((s_hub_count >= SENSORHUB_MAX_SENSORS) || (read->bus >= SENSORHUB_BUS_NUM) || \
+       (read->length == 0U) || (read->length > SENSORHUB_SAMPLE_MAX) || (read->period_us == 0U) || \
+       (read->address > 0x7FU) || (sensor->ring == NULL) || (sensor->depth == 0U) || \
+       ((sensor->depth & (sensor->depth - 1U)) != 0U))
+    {
+        return ERROR;
+    }
+
+    sensor->head = 0;
+    sensor->tail = 0;
+    sensor->overruns = 0;
+    sensor->errors = 0;
+    s_hub_sensors[s_hub_count] = sensor;
+    s_hub_reads[s_hub_count] = *read;
+    s_hub_sched.next_us[s_hub_count] = timer_monotonic_us();
+    s_hub_count++;
+    return SUCCESS;
+}
+
+/*!
+    \brief      submit the due reads of every idle bus
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Call from the main loop. A bus still running its previous
+                batch is skipped; its reads become late and are picked up on
+                the next call.
+*/
+void sensorhub_process(void)
+{
+    const sensorhub_read_struct *read;
+    i2c_xfer_struct *xfer;
+    uint32_t primask;
+    uint8_t n, i, id;
+
+    if(s_hub_i2c_pending != 0U)
+    {
+        return;
+    }
+    n = sensorhub_sched_batch(&s_hub_sched, s_hub_reads, s_hub_count, SENSORHUB_BUS_I2C, \
+                              timer_monotonic_us(), s_hub_i2c_ids, SENSORHUB_MAX_SENSORS);
+    if(n == 0U)
+    {
+        return;
+    }
+
+    s_hub_i2c_pending = n;
+    s_hub_batches++;
+    s_hub_reads_done += n;
+    for(i = 0; i < n; i++)
+    {
+        id = s_hub_i2c_ids[i];
+        read = &s_hub_reads[id];
+        xfer = &s_hub_i2c_xfer[i];
+
+        s_hub_i2c_reg[i] = read->reg;
+        s_hub_i2c_seg[i][0].buf = &s_hub_i2c_reg[i];
+        s_hub_i2c_seg[i][0].length = 1;
+        s_hub_i2c_seg[i][0].flags = I2C_SEG_WRITE;
+        s_hub_i2c_seg[i][1].buf = s_hub_i2c_data[i];
+        s_hub_i2c_seg[i][1].length = read->length;
+        s_hub_i2c_seg[i][1].flags = I2C_SEG_READ;
+
+        xfer->address = read->address;
+        xfer->segs = s_hub_i2c_seg[i];
+        xfer->seg_count = 2;
+        xfer->callback = sensorhub_i2c_done;
+        xfer->callback_arg = (void *)(uint32_t)i;
+        if(ERROR == i2c_master_submit(xfer))
+        {
+            s_hub_sensors[id]->errors++;
+            s_hub_errors++;
+            primask = __get_PRIMASK();
+            __disable_irq();
+            s_hub_i2c_pending--;
+            __set_PRIMASK(primask);
+        }
+    }
+}
+
+/*!
+    \brief      get the time until the next read is due
+    \param[in]  none
+    \param[out] none
+    \retval     microseconds, 0 if a read is due, 0xFFFFFFFF without sensors
+*/
+uint32_t sensorhub_next_due_us(void)
+{
+    return sensorhub_sched_due(&s_hub_sched, s_hub_reads, s_hub_count, SENSORHUB_BUS_ANY, timer_monotonic_us());
+}
+
+/*!
+    \brief      pop the oldest sample of a sensor
+    \param[in]  sensor: registered sensor
+    \param[out] sample: timestamped sample
+    \retval     1 if a sample was returned, 0 if the ring is empty
+*/
+uint8_t sensorhub_sample_get(sensorhub_sensor_struct *sensor, sensorhub_sample_struct *sample)
+{
+    uint32_t tail = sensor->tail;
+
+    if(tail == sensor->head)
+    {
+        return 0;
+    }
+    *sample = sensor->ring[tail & (sensor->depth - 1U)];
+    sensor->tail = tail + 1U;
+    return 1;
+}
+
+/*!
+    \brief      copy hub statistics
+    \param[in]  none
+    \param[out] stats: statistics
+    \retval     none
+*/
+void sensorhub_stats_get(sensorhub_stats_struct *stats)
+{
+    stats->batches = s_hub_batches;
+    stats->reads = s_hub_reads_done;
+    stats->errors = s_hub_errors;
+    stats->late_max_us = s_hub_sched.late_max_us;
+    stats->missed = s_hub_sched.missed;
+}
+
+/*!
+    \brief      print hub statistics with modelled and measured bus load
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The model runs the scheduler over one second of the registered
+                reads; the measurement is i2c_master_load_get since its last
+                call, so other I2C users add to it.
+*/
+void sensorhub_stats_print(void)
+{
+    sensorhub_sim_struct sim;
+    uint32_t load;
+    uint8_t i;
+
+    sensorhub_sched_simulate(s_hub_reads, s_hub_count, s_hub_i2c_hz, SENSORHUB_I2C_GAP_US, 1000000U, &sim);
+    load = i2c_master_load_get();
+    PRINT("sensorhub: %u sensors, %u batches, %u reads, %u errors, late max %u us, %u missed\r\n",
+          (unsigned)s_hub_count, (unsigned)s_hub_batches, (unsigned)s_hub_reads_done, (unsigned)s_hub_errors,
+          (unsigned)s_hub_sched.late_max_us, (unsigned)s_hub_sched.missed);
+    PRINT("  i2c load: model %u.%u%% (%u batches/s), measured %u.%u%%\r\n",
+          (unsigned)(sim.load_permille / 10U), (unsigned)(sim.load_permille % 10U), (unsigned)sim.batches,
+          (unsigned)(load / 10U), (unsigned)(load % 10U));
+    for(i = 0; i < s_hub_count; i++)
+    {
+        PRINT("  [%u] addr 0x%02X reg 0x%02X len %u period %u us: %u overruns, %u errors\r\n",
+              (unsigned)i, (unsigned)s_hub_reads[i].address, (unsigned)s_hub_reads[i].reg,
+              (unsigned)s_hub_reads[i].length, (unsigned)s_hub_reads[i].period_us,
+              (unsigned)s_hub_sensors[i]->overruns, (unsigned)s_hub_sensors[i]->errors);
+    }
+}
@@ -0,0 +1,74 @@
+/*!
+    \file       sensorhub.h
+    \brief      header file for sensor hub polling layer
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Sensor descriptors with register read, rate and sample ring
+    - Timestamped samples published per sensor
+    - Batched polling of due reads through the bus drivers
+    - Hub statistics and modelled against measured bus load
+*/
+
+#ifndef __SENSORHUB_H
+#define __SENSORHUB_H
+#include <stdint.h>
+#include <stddef.h>
+#include "gd32h7xx_libopt.h"
+#include "./SENSORHUB/sensorhub_sched.h"
+
+/*!
+    \brief sensor hub configuration macros
+*/
+#define SENSORHUB_SAMPLE_MAX        16U                                     /*!< longest register read in bytes */
+#define SENSORHUB_BUS_I2C           0U                                      /*!< sensors on the I2C master */
+#define SENSORHUB_BUS_NUM           1U                                      /*!< number of buses */
+#define SENSORHUB_I2C_GAP_US        4U                                      /*!< modelled interrupt turnaround between reads */
+
+/*!
+    \brief timestamped sample
+*/
+typedef struct
+{
+    uint32_t time_us;                                                       /*!< monotonic time the read completed */
+    uint8_t length;                                                         /*!< valid bytes in data */
+    uint8_t data[SENSORHUB_SAMPLE_MAX];                                     /*!< register contents */
+} sensorhub_sample_struct;
+
+/*!
+    \brief sensor descriptor, filled by the caller before sensorhub_register
+*/
+typedef struct
+{
+    sensorhub_read_struct read;                                             /*!< register read and rate */
+    sensorhub_sample_struct *ring;                                          /*!< sample storage of depth entries */
+    uint8_t depth;                                                          /*!< ring entries, power of two */
+    volatile uint32_t head;                                                 /*!< next sample written by the hub */
+    volatile uint32_t tail;                                                 /*!< next sample read by sensorhub_sample_get */
+    uint32_t overruns;                                                      /*!< samples dropped from a full ring */
+    uint32_t errors;                                                        /*!< failed reads */
+} sensorhub_sensor_struct;
+
+/*!
+    \brief hub statistics
+*/
+typedef struct
+{
+    uint32_t batches;                                                       /*!< batches submitted */
+    uint32_t reads;                                                         /*!< reads submitted */
+    uint32_t errors;                                                        /*!< failed reads */
+    uint32_t late_max_us;                                                   /*!< longest delay from due time to batch */
+    uint32_t missed;                                                        /*!< periods skipped */
+} sensorhub_stats_struct;
+
+/* function declarations */
+void sensorhub_init(uint32_t i2c_hz);                                                   /*!< reset the hub for a bus speed */
+ErrStatus sensorhub_register(sensorhub_sensor_struct *sensor);                          /*!< add a sensor, first read due now */
+void sensorhub_process(void);                                                           /*!< submit a batch on every idle bus with a due read */
+uint32_t sensorhub_next_due_us(void);                                                   /*!< time until the next read, for idle deadlines */
+uint8_t sensorhub_sample_get(sensorhub_sensor_struct *sensor, sensorhub_sample_struct *sample); /*!< pop the oldest sample */
+void sensorhub_stats_get(sensorhub_stats_struct *stats);                                /*!< copy statistics */
+void sensorhub_stats_print(void);                                                       /*!< print statistics and bus load */
+#endif /* __SENSORHUB_H */
@@ -0,0 +1,213 @@
+/*!
+    \file       sensorhub_sched.c
+    \brief      sensor hub read scheduler
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Batch selection: once any read of a bus is due, every read of that bus
+      within its slack joins, so several sensors share one wakeup
+    - Period bookkeeping with late and missed period accounting
+    - Bus time model for a register read
+    - Discrete-event simulation of a sensor set for bus utilisation
+*/
+
+#include "./SENSORHUB/sensorhub_sched.h"
+
+/*!
+    \brief      make every read due
+    \param[in]  sched: scheduler state
+    \param[in]  count: number of reads
+    \param[in]  now_us: current time
+    \param[out] sched: next due times set to now_us
+    \retval     none
+*/
+void sensorhub_sched_init(sensorhub_sched_struct *sched, uint8_t count, uint32_t now_us)
+{
+    uint8_t i;
+
+    for(i = 0; (i < count) && (i < SENSORHUB_MAX_SENSORS); i++)
+    {
+        sched->next_us[i] = now_us;
+    }
+    sched->late_max_us = 0;
+    sched->missed = 0;
+}
+
+/*!
+    \brief      take the reads of a bus that go into the next batch
+    \param[in]  sched: scheduler state
+    \param[in]  reads: read declarations
+    \param[in]  count: number of reads
+    \param[in]  bus: bus index
+    \param[in]  now_us: current time
+    \param[in]  max: capacity of ids
+    \param[out] ids: indexes of the batched reads, in declaration order
+    \param[out] sched: next due times of the batched reads advanced
+    \retval     number of batched reads, 0 if no read of the bus is due
+    \note       Every read keeps its phase: the next due time advances in whole
+                periods from the old due time, so the average rate stays exact
+                whether the read was pulled in early by its slack or ran late.
+                A read more than a period late skips the lost periods instead
+                of bursting to catch up.
+*/
+uint8_t sensorhub_sched_batch(sensorhub_sched_struct *sched, const sensorhub_read_struct *reads, uint8_t count, \
+                              uint8_t bus, uint32_t now_us, uint8_t *ids, uint8_t max)
+{
+    uint32_t late, lost;
+    uint8_t i, n = 0;
+
+    if(sensorhub_sched_due(sched, reads, count, bus, now_us) != 0U)
+    {
+        return 0;
+    }
+
+    for(i = 0; (i < count) && (i < SENSORHUB_MAX_SENSORS) && (n < max); i++)
+    {
+        if((reads[i].bus != bus) || ((int32_t)(sched->next_us[i] - now_us) > (int32_t)reads[i].slack_us))
+        {
+            continue;
+        }
+        ids[n++] = i;
+
+        if((int32_t)(now_us - sched->next_us[i]) > 0)
+        {
+            late = now_us - sched->next_us[i];
+            if(late > sched->late_max_us)
+            {
+                sched->late_max_us = late;
+            }
+        }
+        sched->next_us[i] += reads[i].period_us;
+        if((int32_t)(sched->next_us[i] - now_us) <= 0)
+        {
+            lost = (now_us - sched->next_us[i]) / reads[i].period_us + 1U;
+            sched->missed += lost;
+            sched->next_us[i] += lost * reads[i].period_us;
+        }
+    }
+    return n;
+}
+
+/*!
+    \brief      get the time until the next read is due
+    \param[in]  sched: scheduler state
+    \param[in]  reads: read declarations
+    \param[in]  count: number of reads
+    \param[in]  bus: bus index, or SENSORHUB_BUS_ANY
+    \param[in]  now_us: current time
+    \param[out] none
+    \retval     microseconds until the earliest due read, 0 if one is due,
+                0xFFFFFFFF if the bus has no reads
+*/
+uint32_t sensorhub_sched_due(const sensorhub_sched_struct *sched, const sensorhub_read_struct *reads, \
+                             uint8_t count, uint8_t bus, uint32_t now_us)
+{
+    uint32_t earliest = 0xFFFFFFFFU;
+    int32_t wait;
+    uint8_t i;
+
+    for(i = 0; (i < count) && (i < SENSORHUB_MAX_SENSORS); i++)
+    {
+        if((bus != SENSORHUB_BUS_ANY) && (reads[i].bus != bus))
+        {
+            continue;
+        }
+        wait = (int32_t)(sched->next_us[i] - now_us);
+        if(wait <= 0)
+        {
+            return 0;
+        }
+        if((uint32_t)wait < earliest)
+        {
+            earliest = (uint32_t)wait;
+        }
+    }
+    return earliest;
+}
+
+/*!
+    \brief      estimate the bus time of one register read
+    \param[in]  read: read declaration
+    \param[in]  bus_hz: bus clock
+    \param[out] none
+    \retval     microseconds, rounded up
+    \note       I2C model: START, address + register, repeated START, address
+                + data, STOP; nine clocks per byte and about one clock for each
+                START or STOP.
+*/
+uint32_t sensorhub_sched_read_us(const sensorhub_read_struct *read, uint32_t bus_hz)
+{
+    uint32_t clocks;
+
+    clocks = 9U * (3U + read->length) + 3U;
+    return (uint32_t)(((uint64_t)clocks * 1000000U + bus_hz - 1U) / bus_hz);
+}
+
+/*!
+    \brief      simulate the scheduler on one bus
+    \param[in]  reads: read declarations, all on the same bus
+    \param[in]  count: number of reads
+    \param[in]  bus_hz: bus clock
+    \param[in]  gap_us: idle bus time between two reads of a batch (interrupt turnaround)
+    \param[in]  duration_us: simulated time
+    \param[out] sim: batches, reads, bus time, load and lateness
+    \retval     none
+    \note       A batch starts when its first read is due or when the previous
+                batch frees the bus, whichever is later. Compare runs with and
+                without slack to see wakeups traded against sampling jitter.
+*/
+void sensorhub_sched_simulate(const sensorhub_read_struct *reads, uint8_t count, uint32_t bus_hz, \
+                              uint32_t gap_us, uint32_t duration_us, sensorhub_sim_struct *sim)
+{
+    sensorhub_sched_struct sched;
+    uint8_t ids[SENSORHUB_MAX_SENSORS];
+    uint32_t now = 0, free_at = 0, wait, batch_us;
+    uint8_t n, i;
+
+    sim->batches = 0;
+    sim->reads = 0;
+    sim->bus_us = 0;
+    sim->load_permille = 0;
+    if((count == 0U) || (bus_hz == 0U) || (duration_us == 0U))
+    {
+        sim->late_max_us = 0;
+        sim->missed = 0;
+        return;
+    }
+
+    sensorhub_sched_init(&sched, count, 0);
+    for(;;)
+    {
+        wait = sensorhub_sched_due(&sched, reads, count, reads[0].bus, now);
+        if((wait == 0xFFFFFFFFU) || (wait >= duration_us - now))
+        {
+            break;
+        }
+        now += wait;
+        if((int32_t)(free_at - now) > 0)
+        {
+            now = free_at;
+        }
+        if(now >= duration_us)
+        {
+            break;
+        }
+
+        n = sensorhub_sched_batch(&sched, reads, count, reads[0].bus, now, ids, SENSORHUB_MAX_SENSORS);
+        batch_us = 0;
+        for(i = 0; i < n; i++)
+        {
+            batch_us += sensorhub_sched_read_us(&reads[ids[i]], bus_hz) + gap_us;
+        }
+        free_at = now + batch_us;
+        sim->batches++;
+        sim->reads += n;
+        sim->bus_us += batch_us;
+    }
+
+    sim->load_permille = (uint32_t)((sim->bus_us * 1000U) / duration_us);
+    sim->late_max_us = sched.late_max_us;
+    sim->missed = sched.missed;
+}
@@ -0,0 +1,68 @@
+/*!
+    \file       sensorhub_sched.h
+    \brief      header file for sensor hub read scheduler
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Register read declarations with sampling period and batching slack
+    - Per-bus batch selection of due reads
+    - Bus time model and utilisation simulation for a sensor set
+    - No device headers; the host selftest checks batching, phase and the
+      simulation, and bspbench times a batch
+*/
+
+#ifndef __SENSORHUB_SCHED_H
+#define __SENSORHUB_SCHED_H
+#include <stdint.h>
+
+#define SENSORHUB_MAX_SENSORS       16U                                     /*!< sensors per hub */
+#define SENSORHUB_BUS_ANY           0xFFU                                   /*!< sensorhub_sched_due over all buses */
+
+/*!
+    \brief one periodic register read
+*/
+typedef struct
+{
+    uint8_t bus;                                                            /*!< bus index */
+    uint8_t address;                                                        /*!< 7-bit device address */
+    uint8_t reg;                                                            /*!< first register */
+    uint8_t length;                                                         /*!< bytes read from reg on */
+    uint32_t period_us;                                                     /*!< sampling period */
+    uint32_t slack_us;                                                      /*!< how early the read may join a batch */
+} sensorhub_read_struct;
+
+/*!
+    \brief scheduler state
+*/
+typedef struct
+{
+    uint32_t next_us[SENSORHUB_MAX_SENSORS];                                /*!< next due time per read */
+    uint32_t late_max_us;                                                   /*!< longest delay from due time to batch */
+    uint32_t missed;                                                        /*!< periods skipped because a read was too late */
+} sensorhub_sched_struct;
+
+/*!
+    \brief simulation result
+*/
+typedef struct
+{
+    uint32_t batches;                                                       /*!< batches started, one scheduler wakeup each */
+    uint32_t reads;                                                         /*!< reads executed */
+    uint64_t bus_us;                                                        /*!< bus time used */
+    uint32_t load_permille;                                                 /*!< bus_us over the simulated time */
+    uint32_t late_max_us;                                                   /*!< longest delay from due time to batch */
+    uint32_t missed;                                                        /*!< periods skipped */
+} sensorhub_sim_struct;
+
+/* function declarations */
+void sensorhub_sched_init(sensorhub_sched_struct *sched, uint8_t count, uint32_t now_us);            /*!< every read due now */
+uint8_t sensorhub_sched_batch(sensorhub_sched_struct *sched, const sensorhub_read_struct *reads, uint8_t count, \
+                              uint8_t bus, uint32_t now_us, uint8_t *ids, uint8_t max);              /*!< take the due reads of a bus */
+uint32_t sensorhub_sched_due(const sensorhub_sched_struct *sched, const sensorhub_read_struct *reads, \
+                             uint8_t count, uint8_t bus, uint32_t now_us);                           /*!< time until a read is due */
+uint32_t sensorhub_sched_read_us(const sensorhub_read_struct *read, uint32_t bus_hz);               /*!< bus time of one read */
+void sensorhub_sched_simulate(const sensorhub_read_struct *reads, uint8_t count, uint32_t bus_hz, \
+                              uint32_t gap_us, uint32_t duration_us, sensorhub_sim_struct *sim);     /*!< run the scheduler on one modelled bus */
+#endif /* __SENSORHUB_SCHED_H */
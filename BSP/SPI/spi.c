@@ -0,0 +1,728 @@
+/*!
+    \file       spi.c
+    \brief      polled, interrupt and DMA driven SPI master engine
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - SPI3 master on the PLL2Q kernel clock, unaffected by DVFS
+    - Queued full-duplex transfers; the path follows the length: CPU polling
+      for a few frames, FIFO threshold interrupts for short transfers and DMA
+      for long ones
+    - Hardware NSS with chip select and inter-frame delays, or a GPIO chip
+      select per device
+    - Cached configuration images per device: switching devices rewrites only
+      the registers that differ
+    - Transfer statistics and achieved against theoretical throughput
+*/
+
+#include <string.h>
+#include "gd32h7xx_libopt.h"
+#include "./SPI/spi.h"
+#include "./PINCFG/pincfg.h"
+#include "./CLOCK/clock.h"
+#include "./TIMER/timer.h"
+#include "./IDLE/idle.h"
+#if SPI_MASTER_BENCHMARK_ENABLE
+#include "./SYSTEM/system.h"
+#include "./USART/usart.h"
+#endif
+
+#define SPI_MASTER_TDATA            REG8(SPI_MASTER_TD_ADDRESS)             /* byte access to the transmit FIFO */
+#define SPI_MASTER_RDATA            REG8(SPI_MASTER_RD_ADDRESS)             /* byte access to the receive FIFO */
+#define SPI_MASTER_DMA_SPIN         1000U                                   /* RX DMA drain polls after end of transfer */
+
+typedef char spi_pins_check[PINCFG_VALID(SPI_MASTER_PINS) ? 1 : -1];
+#if PINCFG_OWN(PINCFG_BOARD_SPI_MASTER)
+static const pincfg_port_struct s_spi_pins = PINCFG_PORT(SPI_MASTER_PINS, SPI_MASTER_GPIO_PORT, SPI_MASTER_GPIO_RCU);
+#endif /* PINCFG_OWN(PINCFG_BOARD_SPI_MASTER) */
+
+static spi_xfer_struct *s_spi_head = NULL;                                  /* transfer on the bus or next to start */
+static spi_xfer_struct *s_spi_tail = NULL;                                  /* last queued transfer */
+static volatile uint8_t s_spi_active = 0;                                   /* 1: the head transfer is on the bus */
+static const spi_device_struct *s_spi_device = NULL;                        /* device of the previous transfer */
+static uint32_t s_spi_cfg0 = 0;                                             /* SPI_CFG0 as last written */
+static uint32_t s_spi_cfg1 = 0;                                             /* SPI_CFG1 as last written */
+static uint32_t s_spi_kernel_hz = 0;                                        /* SPI kernel clock */
+static const uint8_t *s_spi_tx = NULL;                                      /* interrupt path: next byte to send */
+static uint8_t *s_spi_rx = NULL;                                            /* interrupt path: next byte to receive */
+static uint32_t s_spi_tx_left = 0;                                          /* frames not yet written to the FIFO */
+static uint32_t s_spi_rx_left = 0;                                          /* frames not yet read from the FIFO */
+static uint32_t s_spi_start_us = 0;                                         /* monotonic time the head transfer started */
+static spi_master_stats_struct s_spi_stats;                                 /* statistics */
+static idle_constraint_struct s_spi_idle_constraint = {0, NULL};            /* sleep only while a transfer runs */
+static const uint8_t s_spi_dummy_tx = 0xFFU;                                /* sent when a transfer has no tx buffer */
+static uint8_t s_spi_dummy_rx;                                              /* sink when a transfer has no rx buffer */
+
+/*!
+    \brief      write the configuration registers of a transfer
+    \param[in]  device: target device
+    \param[in]  cfg0: SPI_CFG0 image with FIFO threshold and DMA bits
+    \param[out] none
+    \retval     none
+    \note       The SPI is disabled between transfers, so both registers are
+                writable. Only a register whose image differs from the last
+                write is touched; back-to-back transfers on one path to one
+                device write neither.
+*/
+static void spi_master_configure(const spi_device_struct *device, uint32_t cfg0)
+{
+    if(device != s_spi_device)
+    {
+        s_spi_device = device;
+        s_spi_stats.switches++;
+    }
+    if(cfg0 != s_spi_cfg0)
+    {
+        SPI_CFG0(SPI_MASTER_PERIPH) = cfg0;
+        s_spi_cfg0 = cfg0;
+        s_spi_stats.cfg_writes++;
+    }
+    if(device->cfg1 != s_spi_cfg1)
+    {
+        SPI_CFG1(SPI_MASTER_PERIPH) = device->cfg1;
+        s_spi_cfg1 = device->cfg1;
+        s_spi_stats.cfg_writes++;
+    }
+}
+
+/*!
+    \brief      assert or release a GPIO chip select
+    \param[in]  device: target device
+    \param[in]  active: 1 to select the device, 0 to release it
+    \param[out] none
+    \retval     none
+*/
+static void spi_master_cs(const spi_device_struct *device, uint8_t active)
+{
+    if(device->cs_port == 0U)
+    {
+        return;
+    }
+    if((active != 0U) == ((device->flags & SPI_DEV_NSS_HIGH) != 0U))
+    {
+        gpio_bit_set(device->cs_port, device->cs_pin);
+    }
+    else
+    {
+        gpio_bit_reset(device->cs_port, device->cs_pin);
+    }
+}
+
+/*!
+    \brief      move frames between the buffers and the FIFO
+    \param[in]  packet: frames written per transmit space event
+    \param[out] none
+    \retval     none
+    \note       Writes stop once the frames in flight would fill the receive
+                FIFO, so the master cannot overrun itself while the CPU lags.
+*/
+static void spi_master_fifo_pump(uint32_t packet)
+{
+    uint32_t n;
+
+    while(s_spi_rx_left > s_spi_tx_left)
+    {
+        if(0U == (SPI_STAT(SPI_MASTER_PERIPH) & SPI_STAT_RP))
+        {
+            break;
+        }
+        n = (s_spi_rx_left - s_spi_tx_left < packet) ? (s_spi_rx_left - s_spi_tx_left) : packet;
+        s_spi_rx_left -= n;
+        while(n--)
+        {
+            *s_spi_rx = SPI_MASTER_RDATA;
+            if(s_spi_rx != &s_spi_dummy_rx)
+            {
+                s_spi_rx++;
+            }
+        }
+    }
+
+    while((s_spi_tx_left != 0U) && (SPI_STAT(SPI_MASTER_PERIPH) & SPI_STAT_TP) && \
+          ((s_spi_rx_left - s_spi_tx_left) + packet <= SPI_MASTER_FIFO_DEPTH))
+    {
+        n = (s_spi_tx_left < packet) ? s_spi_tx_left : packet;
+        s_spi_tx_left -= n;
+        while(n--)
+        {
+            SPI_MASTER_TDATA = *s_spi_tx;
+            if(s_spi_tx != &s_spi_dummy_tx)
+            {
+                s_spi_tx++;
+            }
+        }
+    }
+}
+
+/*!
+    \brief      stop the SPI after a transfer
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void spi_master_stop(void)
+{
+    SPI_INT(SPI_MASTER_PERIPH) = 0;
+    SPI_STATC(SPI_MASTER_PERIPH) = SPI_STATC_ETC | SPI_STATC_TXFC | SPI_STATC_TXURERRC | SPI_STATC_RXORERRC | \
+                                   SPI_STATC_CONFERRC | SPI_STATC_SPDC;
+    spi_disable(SPI_MASTER_PERIPH);
+    dma_channel_disable(SPI_MASTER_DMA, SPI_MASTER_DMA_TX_CHANNEL);
+    dma_channel_disable(SPI_MASTER_DMA, SPI_MASTER_DMA_RX_CHANNEL);
+}
+
+/*!
+    \brief      remove the head transfer from the queue and notify its owner
+    \param[in]  result: transfer result (spi_xfer_status_enum)
+    \param[out] none
+    \retval     none
+*/
+static void spi_master_complete(uint8_t result)
+{
+    spi_xfer_struct *xfer = s_spi_head;
+    uint32_t primask;
+
+    spi_master_stop();
+    spi_master_cs(xfer->device, 0);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(s_spi_active)
+    {
+        s_spi_active = 0;
+        s_spi_stats.busy_us += timer_monotonic_us() - s_spi_start_us;
+        idle_constraint_unregister(&s_spi_idle_constraint);
+    }
+    s_spi_head = xfer->next;
+    if(s_spi_head == NULL)
+    {
+        s_spi_tail = NULL;
+    }
+    __set_PRIMASK(primask);
+
+    if(result == SPI_XFER_OK)
+    {
+        s_spi_stats.transfers[xfer->path]++;
+        s_spi_stats.bytes += xfer->length;
+    }
+    else
+    {
+        s_spi_stats.errors++;
+    }
+
+    if((xfer->path == SPI_PATH_DMA) && (xfer->rx != NULL))
+    {
+        SCB_InvalidateDCache_by_Addr((uint32_t *)xfer->rx, xfer->length); /* drop lines prefetched during the DMA */
+    }
+    xfer->status = result;
+    if(xfer->callback != NULL)
+    {
+        xfer->callback(xfer, xfer->callback_arg);
+    }
+}
+
+/*!
+    \brief      run the head transfer with the CPU polling the FIFO
+    \param[in]  none
+    \param[out] none
+    \retval     transfer result (spi_xfer_status_enum)
+*/
+static uint8_t spi_master_poll(void)
+{
+    uint32_t t0 = timer_monotonic_us();
+
+    SPI_INT(SPI_MASTER_PERIPH) = 0;
+    spi_enable(SPI_MASTER_PERIPH);
+    spi_master_transfer_start(SPI_MASTER_PERIPH, SPI_TRANS_START);
+    while(s_spi_rx_left != 0U)
+    {
+        spi_master_fifo_pump(1U);
+        if((timer_monotonic_us() - t0) > SPI_MASTER_POLL_TIMEOUT_US)
+        {
+            return SPI_XFER_TIMEOUT;
+        }
+    }
+    while(0U == (SPI_STAT(SPI_MASTER_PERIPH) & SPI_STAT_ET))
+    {
+        if((timer_monotonic_us() - t0) > SPI_MASTER_POLL_TIMEOUT_US)
+        {
+            return SPI_XFER_TIMEOUT;
+        }
+    }
+    return (SPI_STAT(SPI_MASTER_PERIPH) & SPI_STAT_RXORERR) ? SPI_XFER_OVERRUN : SPI_XFER_OK;
+}
+
+/*!
+    \brief      start the head transfer on the interrupt or DMA path
+    \param[in]  xfer: head transfer
+    \param[out] none
+    \retval     none
+*/
+static void spi_master_start_async(spi_xfer_struct *xfer)
+{
+    if(xfer->path == SPI_PATH_DMA)
+    {
+        dma_memory_address_generation_config(SPI_MASTER_DMA, SPI_MASTER_DMA_TX_CHANNEL, \
+                                             (xfer->tx != NULL) ? DMA_MEMORY_INCREASE_ENABLE : DMA_MEMORY_INCREASE_DISABLE);
+        dma_memory_address_config(SPI_MASTER_DMA, SPI_MASTER_DMA_TX_CHANNEL, DMA_MEMORY_0, (uint32_t)s_spi_tx);
+        dma_transfer_number_config(SPI_MASTER_DMA, SPI_MASTER_DMA_TX_CHANNEL, xfer->length);
+        dma_flag_clear(SPI_MASTER_DMA, SPI_MASTER_DMA_TX_CHANNEL, DMA_FLAG_FEE | DMA_FLAG_SDE | DMA_FLAG_TAE | DMA_FLAG_HTF | DMA_FLAG_FTF);
+
+        dma_memory_address_generation_config(SPI_MASTER_DMA, SPI_MASTER_DMA_RX_CHANNEL, \
+                                             (xfer->rx != NULL) ? DMA_MEMORY_INCREASE_ENABLE : DMA_MEMORY_INCREASE_DISABLE);
+        dma_memory_address_config(SPI_MASTER_DMA, SPI_MASTER_DMA_RX_CHANNEL, DMA_MEMORY_0, (uint32_t)s_spi_rx);
+        dma_transfer_number_config(SPI_MASTER_DMA, SPI_MASTER_DMA_RX_CHANNEL, xfer->length);
+        dma_flag_clear(SPI_MASTER_DMA, SPI_MASTER_DMA_RX_CHANNEL, DMA_FLAG_FEE | DMA_FLAG_SDE | DMA_FLAG_TAE | DMA_FLAG_HTF | DMA_FLAG_FTF);
+
+        if(xfer->tx != NULL)
+        {
+            SCB_CleanDCache_by_Addr((uint32_t *)xfer->tx, xfer->length);
+        }
+        if(xfer->rx != NULL)
+        {
+            SCB_CleanInvalidateDCache_by_Addr((uint32_t *)xfer->rx, xfer->length);
+        }
+        dma_channel_enable(SPI_MASTER_DMA, SPI_MASTER_DMA_RX_CHANNEL);
+        dma_channel_enable(SPI_MASTER_DMA, SPI_MASTER_DMA_TX_CHANNEL);
+        s_spi_tx_left = 0;
+        s_spi_rx_left = 0;
+        SPI_INT(SPI_MASTER_PERIPH) = SPI_INT_ESTCIE | SPI_INT_RXOREIE;
+    }
+    else
+    {
+        SPI_INT(SPI_MASTER_PERIPH) = SPI_INT_RPIE | SPI_INT_TPIE | SPI_INT_ESTCIE | SPI_INT_RXOREIE;
+    }
+    spi_enable(SPI_MASTER_PERIPH);
+    spi_master_transfer_start(SPI_MASTER_PERIPH, SPI_TRANS_START);
+}
+
+/*!
+    \brief      start queued transfers until one runs in the background
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Polled transfers finish here, in the context of the caller,
+                and the next queued transfer follows at once.
+*/
+static void spi_master_kick(void)
+{
+    spi_xfer_struct *xfer;
+    uint32_t cfg0;
+    uint32_t primask;
+    uint8_t result;
+
+    while((s_spi_head != NULL) && (!s_spi_active))
+    {
+        xfer = s_spi_head;
+        if(xfer->length <= SPI_MASTER_POLL_MAX)
+        {
+            xfer->path = SPI_PATH_POLL;
+            cfg0 = xfer->device->cfg0 | SPI_FIFO_TH_01DATA;
+        }
+        else if(xfer->length < SPI_MASTER_DMA_MIN)
+        {
+            xfer->path = SPI_PATH_IRQ;
+            cfg0 = xfer->device->cfg0 | CFG0_FIFOLVL(SPI_MASTER_IRQ_PACKET - 1U);
+        }
+        else
+        {
+            /* single-beat DMA requests need a one frame threshold */
+            xfer->path = SPI_PATH_DMA;
+            cfg0 = xfer->device->cfg0 | SPI_FIFO_TH_01DATA | SPI_CFG0_DMAREN | SPI_CFG0_DMATEN;
+        }
+
+        primask = __get_PRIMASK();
+        __disable_irq();
+        s_spi_active = 1;
+        s_spi_start_us = timer_monotonic_us();
+        idle_constraint_register(&s_spi_idle_constraint);
+        __set_PRIMASK(primask);
+
+        s_spi_tx = (xfer->tx != NULL) ? xfer->tx : &s_spi_dummy_tx;
+        s_spi_rx = (xfer->rx != NULL) ? xfer->rx : &s_spi_dummy_rx;
+        s_spi_tx_left = xfer->length;
+        s_spi_rx_left = xfer->length;
+
+        spi_master_configure(xfer->device, cfg0);
+        spi_current_data_num_config(SPI_MASTER_PERIPH, xfer->length);
+        spi_master_cs(xfer->device, 1);
+
+        if(xfer->path != SPI_PATH_POLL)
+        {
+            spi_master_start_async(xfer);
+            return;
+        }
+        result = spi_master_poll();
+        spi_master_complete(result);
+    }
+}
+
+/*!
+    \brief      SPI master interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void SPI_MASTER_IRQHandler(void)
+{
+    spi_xfer_struct *xfer = s_spi_head;
+    uint32_t stat = SPI_STAT(SPI_MASTER_PERIPH);
+    uint32_t spin;
+
+    if((!s_spi_active) || (xfer == NULL))
+    {
+        SPI_INT(SPI_MASTER_PERIPH) = 0;
+        return;
+    }
+
+    if(stat & SPI_STAT_RXORERR)
+    {
+        spi_master_complete(SPI_XFER_OVERRUN);
+        spi_master_kick();
+        return;
+    }
+
+    if(xfer->path == SPI_PATH_IRQ)
+    {
+        spi_master_fifo_pump(SPI_MASTER_IRQ_PACKET);
+        if(s_spi_tx_left == 0U)
+        {
+            SPI_INT(SPI_MASTER_PERIPH) &= ~SPI_INT_TPIE;
+        }
+        else if((s_spi_rx_left - s_spi_tx_left) + SPI_MASTER_IRQ_PACKET > SPI_MASTER_FIFO_DEPTH)
+        {
+            SPI_INT(SPI_MASTER_PERIPH) &= ~SPI_INT_TPIE;                           /* FIFO full, resume on the next packet read */
+        }
+        else
+        {
+            SPI_INT(SPI_MASTER_PERIPH) |= SPI_INT_TPIE;
+        }
+    }
+
+    if(stat & SPI_STAT_ET)
+    {
+        if(xfer->path == SPI_PATH_IRQ)
+        {
+            /* all frames are in the FIFO; the last packet may be partial */
+            while(s_spi_rx_left != 0U)
+            {
+                *s_spi_rx = SPI_MASTER_RDATA;
+                if(s_spi_rx != &s_spi_dummy_rx)
+                {
+                    s_spi_rx++;
+                }
+                s_spi_rx_left--;
+            }
+        }
+        else
+        {
+            /* the RX DMA drains the last frames after the end of transfer */
+            for(spin = 0; (spin < SPI_MASTER_DMA_SPIN) && \
+                (dma_transfer_number_get(SPI_MASTER_DMA, SPI_MASTER_DMA_RX_CHANNEL) != 0U); spin++)
+            {
+            }
+        }
+        spi_master_complete(SPI_XFER_OK);
+        spi_master_kick();
+    }
+}
+
+/*!
+    \brief      configure SPI3 as bus master
+    \param[in]  none
+    \param[out] none
+    \retval     ErrStatus: SUCCESS, or ERROR if the kernel clock is not running
+    \note       The kernel clock is PLL2Q, enabled by system_clock_config. The
+                NSS, SCK, MISO and MOSI pins keep their levels while the SPI is
+                disabled between transfers (AFCTL). GPIO chip selects are
+                configured by the device owner.
+*/
+ErrStatus spi_master_init(void)
+{
+    dma_single_data_parameter_struct dma_init_struct;
+
+    rcu_spi_clock_config(SPI_MASTER_IDX, SPI_MASTER_CLOCK_SOURCE);
+    s_spi_kernel_hz = clock_freq_get(SPI_MASTER_CLOCK_ID);
+    if(s_spi_kernel_hz == 0U)
+    {
+        return ERROR;
+    }
+
+    rcu_periph_clock_enable(SPI_MASTER_RCU);
+    rcu_periph_clock_enable(SPI_MASTER_DMA_CLOCK);
+    rcu_periph_clock_enable(RCU_DMAMUX);
+
+#if PINCFG_OWN(PINCFG_BOARD_SPI_MASTER)
+    pincfg_apply(&s_spi_pins, 1U);
+#endif /* PINCFG_OWN(PINCFG_BOARD_SPI_MASTER) */
+
+    spi_i2s_deinit(SPI_MASTER_PERIPH);
+    SPI_CTL0(SPI_MASTER_PERIPH) = SPI_CTL0_NSSI;                                   /* internal NSS high for GPIO chip select devices */
+    s_spi_cfg0 = SPI_CFG0(SPI_MASTER_PERIPH);
+    s_spi_cfg1 = SPI_CFG1(SPI_MASTER_PERIPH);
+    s_spi_device = NULL;
+
+    dma_single_data_para_struct_init(&dma_init_struct);
+    dma_deinit(SPI_MASTER_DMA, SPI_MASTER_DMA_TX_CHANNEL);
+    dma_init_struct.request             = DMA_REQUEST_SPI3_TX;
+    dma_init_struct.periph_addr         = SPI_MASTER_TD_ADDRESS;
+    dma_init_struct.memory0_addr        = 0;
+    dma_init_struct.number              = 0;
+    dma_init_struct.periph_inc          = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc          = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.periph_memory_width = DMA_PERIPH_WIDTH_8BIT;
+    dma_init_struct.direction           = DMA_MEMORY_TO_PERIPH;
+    dma_init_struct.priority            = DMA_PRIORITY_HIGH;
+    dma_init_struct.circular_mode       = DMA_CIRCULAR_MODE_DISABLE;
+    dma_single_data_mode_init(SPI_MASTER_DMA, SPI_MASTER_DMA_TX_CHANNEL, &dma_init_struct);
+
+    dma_deinit(SPI_MASTER_DMA, SPI_MASTER_DMA_RX_CHANNEL);
+    dma_init_struct.request             = DMA_REQUEST_SPI3_RX;
+    dma_init_struct.periph_addr         = SPI_MASTER_RD_ADDRESS;
+    dma_init_struct.direction           = DMA_PERIPH_TO_MEMORY;
+    dma_init_struct.priority            = DMA_PRIORITY_ULTRA_HIGH;          /* receive ahead of transmit, no overrun */
+    dma_single_data_mode_init(SPI_MASTER_DMA, SPI_MASTER_DMA_RX_CHANNEL, &dma_init_struct);
+
+    s_spi_head = NULL;
+    s_spi_tail = NULL;
+    s_spi_active = 0;
+    memset(&s_spi_stats, 0, sizeof(s_spi_stats));
+    nvic_irq_enable(SPI_MASTER_IRQ, SPI_MASTER_IRQ_PRIORITY, 0);
+    return SUCCESS;
+}
+
+/*!
+    \brief      compute the cached register images of a device
+    \param[in]  device: descriptor with max_hz, mode, nss_delay, frame_delay,
+                flags, cs_port and cs_pin filled in
+    \param[out] device: sck_hz, cfg0 and cfg1 set
+    \retval     ErrStatus: SUCCESS, or ERROR if max_hz is below the slowest SCK
+                or a delay is out of range
+    \note       Call after spi_master_init and again after changing a field.
+                The prescaler is the smallest one that keeps SCK at or below
+                max_hz. Hardware NSS is used when cs_port is 0; it goes active
+                nss_delay cycles before the first SCK edge and is released at
+                the end of the transfer, or between frames with
+                SPI_DEV_NSS_PULSE.
+*/
+ErrStatus spi_master_device_init(spi_device_struct *device)
+{
+    uint32_t psc;
+
+    if((s_spi_kernel_hz == 0U) || (device->nss_delay > 15U) || (device->frame_delay > 15U))
+    {
+        return ERROR;
+    }
+    for(psc = 0; psc < 8U; psc++)
+    {
+        if((s_spi_kernel_hz >> (psc + 1U)) <= device->max_hz)
+        {
+            break;
+        }
+    }
+    if(psc == 8U)
+    {
+        return ERROR;
+    }
+
+    device->sck_hz = s_spi_kernel_hz >> (psc + 1U);
+    device->cfg0 = SPI_DATASIZE_8BIT | SPI_CFG0_BYTEN | CFG0_PSC(psc);
+    device->cfg1 = SPI_CFG1_MSTMOD | SPI_CFG1_AFCTL | (device->mode & (SPI_CFG1_CKPL | SPI_CFG1_CKPH)) | \
+                   CFG1_MSSD(device->nss_delay) | CFG1_MDFD(device->frame_delay);
+    if(device->flags & SPI_DEV_LSB_FIRST)
+    {
+        device->cfg1 |= SPI_CFG1_LF;
+    }
+    if(device->cs_port == 0U)
+    {
+        device->cfg1 |= SPI_NSS_HARD | SPI_CFG1_NSSDRV;
+        if(device->flags & SPI_DEV_NSS_HIGH)
+        {
+            device->cfg1 |= SPI_NSS_POLARITY_HIGH;
+        }
+        if(device->flags & SPI_DEV_NSS_PULSE)
+        {
+            device->cfg1 |= SPI_NSS_INVALID_PULSE;
+        }
+    }
+    else
+    {
+        device->cfg1 |= SPI_NSS_SOFT;
+        spi_master_cs(device, 0);
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      queue a full-duplex transfer
+    \param[in]  xfer: descriptor with device, tx, rx, length, callback and
+                callback_arg filled in
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if queued, ERROR if the descriptor is invalid
+    \note       Transfers run in order. Up to SPI_MASTER_POLL_MAX frames the
+                caller polls the FIFO and the transfer has completed when this
+                returns, if the bus was idle. Below SPI_MASTER_DMA_MIN frames the
+                FIFO threshold interrupt moves SPI_MASTER_IRQ_PACKET frames per
+                event; longer transfers use DMA in both directions. For DMA, rx
+                must be 32-byte aligned and a multiple of 32 bytes long, since
+                its cache lines are invalidated. The descriptor and buffers must
+                stay valid until the status leaves SPI_XFER_BUSY.
+*/
+ErrStatus spi_master_submit(spi_xfer_struct *xfer)
+{
+    uint32_t primask;
+    uint8_t idle;
+
+    if((xfer->device == NULL) || (xfer->device->cfg1 == 0U) || (xfer->length == 0U))
+    {
+        return ERROR;
+    }
+
+    xfer->status = SPI_XFER_BUSY;
+    xfer->next = NULL;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    idle = (s_spi_head == NULL) ? 1 : 0;
+    if(idle)
+    {
+        s_spi_head = xfer;
+    }
+    else
+    {
+        s_spi_tail->next = xfer;
+    }
+    s_spi_tail = xfer;
+    __set_PRIMASK(primask);
+
+    /* a busy queue is restarted from the interrupt that completes its head */
+    if(idle)
+    {
+        spi_master_kick();
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      wait for a queued transfer to complete
+    \param[in]  xfer: descriptor
+    \param[out] none
+    \retval     transfer result (spi_xfer_status_enum)
+*/
+uint8_t spi_master_wait(spi_xfer_struct *xfer)
+{
+    while(xfer->status == SPI_XFER_BUSY)
+    {
+    }
+    return xfer->status;
+}
+
+/*!
+    \brief      transfer and wait
+    \param[in]  device: target device
+    \param[in]  tx: bytes to send, NULL sends 0xFF
+    \param[in]  length: frames in both directions
+    \param[out] rx: received bytes, NULL discards
+    \retval     transfer result (spi_xfer_status_enum), SPI_XFER_TIMEOUT if the
+                arguments are invalid
+*/
+uint8_t spi_master_transfer(spi_device_struct *device, const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+    spi_xfer_struct xfer;
+
+    xfer.device = device;
+    xfer.tx = tx;
+    xfer.rx = rx;
+    xfer.length = length;
+    xfer.callback = NULL;
+    xfer.callback_arg = NULL;
+    if(ERROR == spi_master_submit(&xfer))
+    {
+        return SPI_XFER_TIMEOUT;
+    }
+    return spi_master_wait(&xfer);
+}
+
+/*!
+    \brief      copy SPI master statistics
+    \param[in]  none
+    \param[out] stats: statistics
+    \retval     none
+*/
+void spi_master_stats_get(spi_master_stats_struct *stats)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = s_spi_stats;
+    __set_PRIMASK(primask);
+}
+
+#if SPI_MASTER_BENCHMARK_ENABLE
+__ALIGNED(32) static uint8_t s_spi_bench_tx[16384];                         /* transmit pattern */
+__ALIGNED(32) static uint8_t s_spi_bench_rx[16384];                         /* receive buffer */
+
+/*!
+    \brief      measure SPI throughput per path against the SCK rate
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Requires system_dwt_init. Bridge MOSI to MISO to check the
+                data as well. Theoretical MB/s is SCK / 8; chip select delay,
+                start and interrupt latency show as lost efficiency, mostly on
+                short transfers. The device switch test alternates two devices
+                in different modes and counts the configuration writes.
+*/
+void spi_master_benchmark(void)
+{
+    spi_device_struct dev_a, dev_b;
+    spi_master_stats_struct before, after;
+    uint32_t size, t0, cycles, theory, rate, i;
+    uint8_t ok;
+
+    memset(&dev_a, 0, sizeof(dev_a));
+    dev_a.max_hz = 0xFFFFFFFFU;
+    dev_a.mode = SPI_CK_PL_LOW_PH_1EDGE;
+    if((ERROR == spi_master_init()) || (ERROR == spi_master_device_init(&dev_a)))
+    {
+        PRINT_ERROR("spi benchmark: kernel clock not running\r\n");
+        return;
+    }
+    dev_b = dev_a;
+    dev_b.mode = SPI_CK_PL_HIGH_PH_2EDGE;
+    spi_master_device_init(&dev_b);
+    for(i = 0; i < sizeof(s_spi_bench_tx); i++)
+    {
+        s_spi_bench_tx[i] = (uint8_t)(i * 7U + 1U);
+    }
+
+    theory = dev_a.sck_hz / 8U;
+    PRINT_INFO("SPI master benchmark (SCK %u Hz, theoretical %u.%02u MB/s)>>\r\n", dev_a.sck_hz,
+               theory / 1000000U, theory / 10000U % 100U);
+    PRINT_INFO("size\t\tpath\tMB/s\t\tefficiency %%\tloopback\r\n");
+    for(size = 4; size <= sizeof(s_spi_bench_tx); size <<= 2)
+    {
+        memset(s_spi_bench_rx, 0, size);
+        t0 = DWT_CYCCNT;
+        spi_master_transfer(&dev_a, s_spi_bench_tx, s_spi_bench_rx, (uint16_t)size);
+        cycles = DWT_CYCCNT - t0;
+        rate = (uint32_t)((uint64_t)size * SystemCoreClock / cycles);
+        ok = (memcmp(s_spi_bench_tx, s_spi_bench_rx, size) == 0) ? 1 : 0;
+        PRINT_INFO("%u\t\t%s\t%u.%02u\t\t%u\t\t%s\r\n", size,
+                   (size <= SPI_MASTER_POLL_MAX) ? "poll" : ((size < SPI_MASTER_DMA_MIN) ? "irq" : "dma"),
+                   rate / 1000000U, rate / 10000U % 100U, (uint32_t)((uint64_t)rate * 100U / theory),
+                   ok ? "ok" : "-");
+    }
+
+    spi_master_stats_get(&before);
+    for(i = 0; i < 64U; i++)
+    {
+        spi_master_transfer((i & 1U) ? &dev_b : &dev_a, s_spi_bench_tx, s_spi_bench_rx, 8);
+    }
+    spi_master_stats_get(&after);
+    PRINT_INFO("device switch: %u switches, %u config writes\r\n", after.switches - before.switches,
+               after.cfg_writes - before.cfg_writes);
+}
+#endif
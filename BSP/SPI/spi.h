@@ -0,0 +1,142 @@
+/*!
+    \file       spi.h
+    \brief      header file for SPI master engine
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - SPI3 master resource configuration (pins, DMA channels, kernel clock)
+    - Device descriptors with cached configuration register images
+    - Queued full-duplex transfers with polled, interrupt and DMA paths
+    - Transfer statistics and throughput benchmark
+*/
+
+#ifndef __SPI_H
+#define __SPI_H
+#include <stdint.h>
+#include <stddef.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief SPI master configuration macros
+*/
+#define SPI_MASTER_PERIPH           SPI3                                    /*!< SPI used as bus master */
+#define SPI_MASTER_RCU              RCU_SPI3                                /*!< SPI peripheral clock */
+#define SPI_MASTER_IDX              IDX_SPI3                                /*!< SPI kernel clock selector index */
+#define SPI_MASTER_CLOCK_SOURCE     RCU_SPISRC_PLL2Q                        /*!< kernel clock, independent of DVFS */
+#define SPI_MASTER_CLOCK_ID         CLOCK_PLL2Q                             /*!< clock tree entry of the kernel clock */
+#define SPI_MASTER_IRQ              SPI3_IRQn                               /*!< SPI interrupt */
+#define SPI_MASTER_IRQHandler       SPI3_IRQHandler                         /*!< SPI interrupt handler */
+#define SPI_MASTER_IRQ_PRIORITY     2U                                      /*!< SPI interrupt priority */
+
+#define SPI_MASTER_GPIO_RCU         RCU_GPIOE                               /*!< SPI pins port clock */
+#define SPI_MASTER_GPIO_PORT        GPIOE                                   /*!< SPI pins port */
+#define SPI_MASTER_GPIO_AF          GPIO_AF_5                               /*!< SPI3 alternate function */
+#define SPI_MASTER_NSS_PIN          GPIO_PIN_11                             /*!< hardware NSS pin */
+#define SPI_MASTER_SCK_PIN          GPIO_PIN_12                             /*!< SCK pin */
+#define SPI_MASTER_MISO_PIN         GPIO_PIN_13                             /*!< MISO pin */
+#define SPI_MASTER_MOSI_PIN         GPIO_PIN_14                             /*!< MOSI pin */
+
+/* SPI pins as PINCFG table rows: MISO is an input with a pull-up, its driver settings stay at reset */
+#define SPI_MASTER_PINS(PIN, x) \
+    PIN(x, SPI_MASTER_GPIO_PORT, PINCFG_PIN(SPI_MASTER_NSS_PIN), GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_OTYPE_PP, GPIO_OSPEED_100_220MHZ, SPI_MASTER_GPIO_AF) \
+    PIN(x, SPI_MASTER_GPIO_PORT, PINCFG_PIN(SPI_MASTER_SCK_PIN), GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_OTYPE_PP, GPIO_OSPEED_100_220MHZ, SPI_MASTER_GPIO_AF) \
+    PIN(x, SPI_MASTER_GPIO_PORT, PINCFG_PIN(SPI_MASTER_MISO_PIN), GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_OTYPE_PP, GPIO_OSPEED_12MHZ, SPI_MASTER_GPIO_AF) \
+    PIN(x, SPI_MASTER_GPIO_PORT, PINCFG_PIN(SPI_MASTER_MOSI_PIN), GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_OTYPE_PP, GPIO_OSPEED_100_220MHZ, SPI_MASTER_GPIO_AF)
+
+#define SPI_MASTER_DMA              DMA1                                    /*!< DMA controller for SPI */
+#define SPI_MASTER_DMA_CLOCK        RCU_DMA1                                /*!< DMA clock for SPI */
+#define SPI_MASTER_DMA_TX_CHANNEL   DMA_CH6                                 /*!< DMA channel feeding SPI_TDATA */
+#define SPI_MASTER_DMA_RX_CHANNEL   DMA_CH7                                 /*!< DMA channel draining SPI_RDATA */
+#define SPI_MASTER_TD_ADDRESS       (SPI3 + 0x20U)                          /*!< SPI transmit data register address */
+#define SPI_MASTER_RD_ADDRESS       (SPI3 + 0x30U)                          /*!< SPI receive data register address */
+
+#define SPI_MASTER_BENCHMARK_ENABLE 0                                       /*!< 1: build spi_master_benchmark with 16KB test buffer */
+
+#define SPI_MASTER_FIFO_DEPTH       16U                                     /*!< SPI3 FIFO depth in 8-bit frames */
+#define SPI_MASTER_POLL_MAX         16U                                     /*!< up to this length the CPU polls the FIFO */
+#define SPI_MASTER_DMA_MIN          128U                                    /*!< from this length on DMA moves the data */
+#define SPI_MASTER_IRQ_PACKET       8U                                      /*!< FIFO threshold of the interrupt path in frames */
+#define SPI_MASTER_POLL_TIMEOUT_US  1000U                                   /*!< polled transfer abort time */
+#define SPI_MASTER_MAX_LENGTH       65535U                                  /*!< TSIZE limit per transfer */
+
+/* device flags */
+#define SPI_DEV_LSB_FIRST           0x01U                                   /*!< shift out the least significant bit first */
+#define SPI_DEV_NSS_HIGH            0x02U                                   /*!< chip select is active high */
+#define SPI_DEV_NSS_PULSE           0x04U                                   /*!< release chip select between frames */
+
+/* transfer paths */
+#define SPI_PATH_POLL               0U                                      /*!< CPU polls the FIFO in the caller */
+#define SPI_PATH_IRQ                1U                                      /*!< FIFO threshold interrupts move the data */
+#define SPI_PATH_DMA                2U                                      /*!< DMA moves the data */
+#define SPI_PATH_NUM                3U                                      /*!< number of paths */
+
+/*!
+    \brief transfer result
+*/
+typedef enum
+{
+    SPI_XFER_OK = 0,                                                        /*!< all frames transferred */
+    SPI_XFER_BUSY,                                                          /*!< queued or in progress */
+    SPI_XFER_OVERRUN,                                                       /*!< receive FIFO overrun */
+    SPI_XFER_TIMEOUT                                                        /*!< polled transfer did not finish */
+} spi_xfer_status_enum;
+
+/*!
+    \brief device on the bus, set up once by spi_master_device_init
+*/
+typedef struct
+{
+    uint32_t max_hz;                                                        /*!< fastest SCK the device accepts */
+    uint32_t mode;                                                          /*!< SPI_CK_PL_x_PH_y clock polarity and phase */
+    uint8_t nss_delay;                                                      /*!< SCK cycles from chip select to first edge, 0..15 */
+    uint8_t frame_delay;                                                    /*!< idle SCK cycles between frames, 0..15 */
+    uint8_t flags;                                                          /*!< SPI_DEV_x */
+    uint32_t cs_port;                                                       /*!< GPIO chip select port, 0 for the hardware NSS pin */
+    uint32_t cs_pin;                                                        /*!< GPIO chip select pin */
+    uint32_t sck_hz;                                                        /*!< SCK after prescaling, set by spi_master_device_init */
+    uint32_t cfg0;                                                          /*!< cached SPI_CFG0 image without FIFO threshold and DMA bits */
+    uint32_t cfg1;                                                          /*!< cached SPI_CFG1 image */
+} spi_device_struct;
+
+/*!
+    \brief queued full-duplex transfer
+*/
+typedef struct spi_xfer
+{
+    spi_device_struct *device;                                              /*!< target device */
+    const uint8_t *tx;                                                      /*!< bytes to send, NULL sends 0xFF */
+    uint8_t *rx;                                                            /*!< received bytes, NULL discards, cache-line aligned for DMA */
+    uint16_t length;                                                        /*!< frames in both directions */
+    volatile uint8_t status;                                                /*!< spi_xfer_status_enum */
+    uint8_t path;                                                           /*!< SPI_PATH_x chosen at start */
+    void (*callback)(struct spi_xfer *xfer, void *arg);                     /*!< completion callback, interrupt context, may be NULL */
+    void *callback_arg;                                                     /*!< argument for callback */
+    struct spi_xfer *next;                                                  /*!< queue link, owned by the driver */
+} spi_xfer_struct;
+
+/*!
+    \brief SPI master statistics
+*/
+typedef struct
+{
+    uint32_t transfers[SPI_PATH_NUM];                                       /*!< completed transfers per path */
+    uint64_t bytes;                                                         /*!< frames transferred */
+    uint32_t errors;                                                        /*!< overruns and timeouts */
+    uint32_t switches;                                                      /*!< transfers to another device than the previous one */
+    uint32_t cfg_writes;                                                    /*!< SPI_CFG0/SPI_CFG1 writes */
+    uint64_t busy_us;                                                       /*!< time with a transfer on the bus */
+} spi_master_stats_struct;
+
+/* function declarations */
+ErrStatus spi_master_init(void);                                                        /*!< configure pins, DMA and interrupts */
+ErrStatus spi_master_device_init(spi_device_struct *device);                            /*!< compute the cached register images of a device */
+ErrStatus spi_master_submit(spi_xfer_struct *xfer);                                     /*!< queue a transfer */
+uint8_t spi_master_wait(spi_xfer_struct *xfer);                                         /*!< wait for a queued transfer */
+uint8_t spi_master_transfer(spi_device_struct *device, const uint8_t *tx, uint8_t *rx, uint16_t length); /*!< blocking transfer */
+void spi_master_stats_get(spi_master_stats_struct *stats);                              /*!< copy statistics */
+#if SPI_MASTER_BENCHMARK_ENABLE
+void spi_master_benchmark(void);                                                        /*!< measure MB/s per path against the SCK rate */
+#endif
+#endif /* __SPI_H */
@@ -0,0 +1,459 @@
+/*!
+    \file       spi_slave.c
+    \brief      SPI slave streaming link with double-buffered DMA
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - SPI4 slave for a co-processor link: one fixed-size frame per NSS
+      period, with a hardware CRC-16 appended and checked per frame
+    - Receive and transmit frame rings fed by double-buffered DMA; the CPU
+      only re-arms the SPI and swaps one buffer address per frame
+    - Resynchronisation on NSS when the master cuts a frame short
+    - Underrun pattern on an empty transmit FIFO and idle frames on an empty
+      transmit ring, so the master can clock continuously
+    - Link statistics and sustained throughput
+*/
+
+#include <string.h>
+#include "gd32h7xx_libopt.h"
+#include "./SPI/spi_slave.h"
+#include "./PINCFG/pincfg.h"
+#include "./CLOCK/clock.h"
+#include "./TIMER/timer.h"
+#include "./IDLE/idle.h"
+#include "./USART/usart.h"
+#include "./ECC/ecc.h"
+
+#define SPI_SLAVE_NO_SLOT           0xFFU                                   /* DMA buffer points at the drop or idle frame */
+
+ECC_DMA_BUFFER __ALIGNED(32) static uint8_t s_slave_rx[SPI_SLAVE_RX_SLOTS][SPI_SLAVE_FRAME_SIZE]; /* receive ring */
+__ALIGNED(32) static uint8_t s_slave_tx[SPI_SLAVE_TX_SLOTS][SPI_SLAVE_FRAME_SIZE]; /* transmit ring */
+ECC_DMA_BUFFER __ALIGNED(32) static uint8_t s_slave_drop[SPI_SLAVE_FRAME_SIZE];           /* receive target while the ring is full */
+__ALIGNED(32) static uint8_t s_slave_idle[SPI_SLAVE_FRAME_SIZE];           /* sent while the transmit ring is empty */
+
+typedef char spi_slave_pins_check[PINCFG_VALID(SPI_SLAVE_PINS) ? 1 : -1];
+#if PINCFG_OWN(PINCFG_BOARD_SPI_SLAVE)
+static const pincfg_port_struct s_slave_pins = PINCFG_PORT(SPI_SLAVE_PINS, SPI_SLAVE_GPIO_PORT, SPI_SLAVE_GPIO_RCU);
+#endif /* PINCFG_OWN(PINCFG_BOARD_SPI_SLAVE) */
+
+static uint8_t s_slave_rx_bad[SPI_SLAVE_RX_SLOTS];                          /* 1: slot holds a frame with a bad CRC */
+
+static volatile uint32_t s_slave_rx_head = 0;                               /* frames published by the interrupt */
+static volatile uint32_t s_slave_rx_tail = 0;                               /* frames released by the consumer */
+static uint32_t s_slave_rx_next = 0;                                        /* next ring slot given to the DMA */
+static uint8_t s_slave_rx_dma[2];                                           /* ring slot of DMA memory 0 and 1 */
+static volatile uint32_t s_slave_tx_head = 0;                               /* frames committed by the producer */
+static volatile uint32_t s_slave_tx_tail = 0;                               /* frames sent and freed by the interrupt */
+static uint32_t s_slave_tx_next = 0;                                        /* next ring slot given to the DMA */
+static uint8_t s_slave_tx_dma[2];                                           /* ring slot of DMA memory 0 and 1 */
+
+static spi_slave_stats_struct s_slave_stats;                                /* statistics */
+static uint32_t s_slave_mark_us = 0;                                        /* monotonic time of the last throughput reading */
+static uint64_t s_slave_mark_bytes = 0;                                     /* bytes at the last throughput reading */
+static idle_constraint_struct s_slave_idle_constraint = {0, NULL};          /* the master may clock at any time */
+
+/*!
+    \brief      choose the next receive buffer for a DMA memory
+    \param[in]  mem: DMA_MEMORY_0 or DMA_MEMORY_1
+    \param[out] none
+    \retval     buffer address
+*/
+static uint32_t spi_slave_rx_target(uint32_t mem)
+{
+    uint8_t slot;
+
+    if((s_slave_rx_next - s_slave_rx_tail) < SPI_SLAVE_RX_SLOTS)
+    {
+        slot = (uint8_t)(s_slave_rx_next & (SPI_SLAVE_RX_SLOTS - 1U));
+        s_slave_rx_next++;
+        s_slave_rx_dma[mem] = slot;
+        return (uint32_t)s_slave_rx[slot];
+    }
+    s_slave_rx_dma[mem] = SPI_SLAVE_NO_SLOT;
+    return (uint32_t)s_slave_drop;
+}
+
+/*!
+    \brief      choose the next transmit buffer for a DMA memory
+    \param[in]  mem: DMA_MEMORY_0 or DMA_MEMORY_1
+    \param[out] none
+    \retval     buffer address
+*/
+static uint32_t spi_slave_tx_target(uint32_t mem)
+{
+    uint8_t slot;
+
+    if(s_slave_tx_next != s_slave_tx_head)
+    {
+        slot = (uint8_t)(s_slave_tx_next & (SPI_SLAVE_TX_SLOTS - 1U));
+        s_slave_tx_next++;
+        s_slave_tx_dma[mem] = slot;
+        return (uint32_t)s_slave_tx[slot];
+    }
+    s_slave_tx_dma[mem] = SPI_SLAVE_NO_SLOT;
+    return (uint32_t)s_slave_idle;
+}
+
+/*!
+    \brief      restart both DMA channels at the start of their current buffers
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The SPI must be disabled. The buffers keep their ring slots,
+                so the cut frame is received again and the interrupted
+                transmit frame is sent again from its first byte.
+*/
+static void spi_slave_dma_restart(void)
+{
+    dma_channel_enum channel;
+    uint8_t i;
+
+    for(i = 0; i < 2U; i++)
+    {
+        channel = (i == 0U) ? SPI_SLAVE_DMA_RX_CHANNEL : SPI_SLAVE_DMA_TX_CHANNEL;
+        dma_channel_disable(SPI_SLAVE_DMA, channel);
+        while(DMA_CHCTL(SPI_SLAVE_DMA, channel) & DMA_CHXCTL_CHEN)
+        {
+        }
+        dma_flag_clear(SPI_SLAVE_DMA, channel, DMA_FLAG_FEE | DMA_FLAG_SDE | DMA_FLAG_TAE | DMA_FLAG_HTF | DMA_FLAG_FTF);
+        dma_transfer_number_config(SPI_SLAVE_DMA, channel, SPI_SLAVE_FRAME_SIZE);
+        dma_switch_buffer_mode_config(SPI_SLAVE_DMA, channel, DMA_CHM1ADDR(SPI_SLAVE_DMA, channel), \
+                                      dma_using_memory_get(SPI_SLAVE_DMA, channel));
+    }
+    dma_channel_enable(SPI_SLAVE_DMA, SPI_SLAVE_DMA_RX_CHANNEL);
+    dma_channel_enable(SPI_SLAVE_DMA, SPI_SLAVE_DMA_TX_CHANNEL);
+}
+
+/*!
+    \brief      SPI slave interrupt: end of frame and FIFO errors
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Re-arming comes first so the next frame may start as soon as
+                NSS has been high for the interrupt latency. The DMA has already
+                switched to its other buffer; only the finished one is
+                re-pointed.
+*/
+void SPI_SLAVE_IRQHandler(void)
+{
+    uint32_t stat = SPI_STAT(SPI_SLAVE_PERIPH);
+    uint32_t mem;
+    uint8_t slot;
+
+    if(stat & SPI_STAT_TXURERR)
+    {
+        SPI_STATC(SPI_SLAVE_PERIPH) = SPI_STATC_TXURERRC;
+        s_slave_stats.underruns++;
+    }
+    if(stat & SPI_STAT_RXORERR)
+    {
+        SPI_STATC(SPI_SLAVE_PERIPH) = SPI_STATC_RXORERRC;
+        s_slave_stats.overruns++;
+    }
+    if(0U == (stat & SPI_STAT_ET))
+    {
+        return;
+    }
+
+    /* a new enable restarts TSIZE and both CRC calculations */
+    spi_disable(SPI_SLAVE_PERIPH);
+    SPI_STATC(SPI_SLAVE_PERIPH) = SPI_STATC_ETC | SPI_STATC_TXFC | SPI_STATC_CRCERRC | SPI_STATC_SPDC;
+    spi_enable(SPI_SLAVE_PERIPH);
+
+    mem = (DMA_MEMORY_0 == dma_using_memory_get(SPI_SLAVE_DMA, SPI_SLAVE_DMA_RX_CHANNEL)) ? DMA_MEMORY_1 : DMA_MEMORY_0;
+    slot = s_slave_rx_dma[mem];
+    if(slot == SPI_SLAVE_NO_SLOT)
+    {
+        s_slave_stats.dropped++;
+    }
+    else
+    {
+        s_slave_rx_bad[slot] = (stat & SPI_STAT_CRCERR) ? 1U : 0U;
+        if(s_slave_rx_bad[slot])
+        {
+            s_slave_stats.crc_errors++;
+        }
+        else
+        {
+            SCB_InvalidateDCache_by_Addr((uint32_t *)s_slave_rx[slot], SPI_SLAVE_FRAME_SIZE);
+            s_slave_stats.rx_frames++;
+            s_slave_stats.bytes += SPI_SLAVE_FRAME_SIZE;
+        }
+        s_slave_rx_head++;
+    }
+    dma_memory_address_config(SPI_SLAVE_DMA, SPI_SLAVE_DMA_RX_CHANNEL, (uint8_t)mem, spi_slave_rx_target(mem));
+
+    mem = (DMA_MEMORY_0 == dma_using_memory_get(SPI_SLAVE_DMA, SPI_SLAVE_DMA_TX_CHANNEL)) ? DMA_MEMORY_1 : DMA_MEMORY_0;
+    if(s_slave_tx_dma[mem] == SPI_SLAVE_NO_SLOT)
+    {
+        s_slave_stats.idle_frames++;
+    }
+    else
+    {
+        s_slave_stats.tx_frames++;
+        s_slave_tx_tail++;
+    }
+    dma_memory_address_config(SPI_SLAVE_DMA, SPI_SLAVE_DMA_TX_CHANNEL, (uint8_t)mem, spi_slave_tx_target(mem));
+}
+
+/*!
+    \brief      NSS release interrupt: resynchronise after a cut frame
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       A complete frame has been re-armed by the end of frame
+                interrupt before this runs, leaving the receive DMA with a full
+                count. Anything else means NSS rose in the middle of a frame.
+*/
+void SPI_SLAVE_NSS_IRQHandler(void)
+{
+    if(RESET == exti_interrupt_flag_get(SPI_SLAVE_NSS_EXTI))
+    {
+        return;
+    }
+    exti_interrupt_flag_clear(SPI_SLAVE_NSS_EXTI);
+
+    if(dma_transfer_number_get(SPI_SLAVE_DMA, SPI_SLAVE_DMA_RX_CHANNEL) == SPI_SLAVE_FRAME_SIZE)
+    {
+        return;
+    }
+    spi_disable(SPI_SLAVE_PERIPH);
+    spi_slave_dma_restart();
+    SPI_STATC(SPI_SLAVE_PERIPH) = SPI_STATC_ETC | SPI_STATC_TXFC | SPI_STATC_TXURERRC | SPI_STATC_RXORERRC | \
+                                  SPI_STATC_CRCERRC | SPI_STATC_SPDC;
+    spi_enable(SPI_SLAVE_PERIPH);
+    s_slave_stats.framing_errors++;
+}
+
+/*!
+    \brief      configure SPI4 as link slave and arm the first frame
+    \param[in]  none
+    \param[out] none
+    \retval     ErrStatus: SUCCESS, or ERROR if the kernel clock is not running
+    \note       Every frame is SPI_SLAVE_FRAME_SIZE payload bytes followed by
+                a CRC-16 in both directions, framed by NSS. Between frames the
+                master must hold NSS high for the SPI interrupt latency (a few
+                microseconds). Idle is limited to sleep from here on, because
+                the master may start a frame at any time.
+*/
+ErrStatus spi_slave_init(void)
+{
+    spi_parameter_struct spi_init_struct;
+    dma_single_data_parameter_struct dma_init_struct;
+    uint32_t mem0;
+
+    rcu_spi_clock_config(SPI_SLAVE_IDX, SPI_SLAVE_CLOCK_SOURCE);
+    if(clock_freq_get(CLOCK_PLL2Q) == 0U)
+    {
+        return ERROR;
+    }
+
+    rcu_periph_clock_enable(SPI_SLAVE_RCU);
+    rcu_periph_clock_enable(SPI_SLAVE_DMA_CLOCK);
+    rcu_periph_clock_enable(RCU_DMAMUX);
+    rcu_periph_clock_enable(RCU_SYSCFG);
+
+#if PINCFG_OWN(PINCFG_BOARD_SPI_SLAVE)
+    pincfg_apply(&s_slave_pins, 1U);
+#endif /* PINCFG_OWN(PINCFG_BOARD_SPI_SLAVE) */
+
+    spi_i2s_deinit(SPI_SLAVE_PERIPH);
+    spi_struct_para_init(&spi_init_struct);
+    spi_init_struct.device_mode          = SPI_SLAVE;
+    spi_init_struct.trans_mode           = SPI_TRANSMODE_FULLDUPLEX;
+    spi_init_struct.data_size            = SPI_DATASIZE_8BIT;
+    spi_init_struct.nss                  = SPI_NSS_HARD;
+    spi_init_struct.endian               = SPI_ENDIAN_MSB;
+    spi_init_struct.clock_polarity_phase = SPI_SLAVE_MODE;
+    spi_init_struct.prescale             = SPI_PSC_2;
+    spi_init(SPI_SLAVE_PERIPH, &spi_init_struct);
+    spi_byte_access_enable(SPI_SLAVE_PERIPH);
+    spi_fifo_threshold_level_set(SPI_SLAVE_PERIPH, SPI_FIFO_TH_01DATA);
+    spi_current_data_num_config(SPI_SLAVE_PERIPH, SPI_SLAVE_FRAME_SIZE);
+    spi_crc_polynomial_set(SPI_SLAVE_PERIPH, SPI_SLAVE_CRC_POLY);
+    spi_crc_length_config(SPI_SLAVE_PERIPH, SPI_CRCSIZE_16BIT);
+    spi_crc_on(SPI_SLAVE_PERIPH);
+    spi_underrun_operation(SPI_SLAVE_PERIPH, SPI_CONFIG_REGISTER_PATTERN);
+    spi_underrun_data_config(SPI_SLAVE_PERIPH, SPI_SLAVE_UNDERRUN_DATA);
+    spi_underrun_config(SPI_SLAVE_PERIPH, SPI_DETECT_BEGIN_DATA_FRAME);
+    spi_suspend_mode_config(SPI_SLAVE_PERIPH, SPI_CONTINUOUS);              /* overruns are counted, never stall the link */
+
+    /* rings start empty: the DMA owns two receive slots and sends idle frames */
+    s_slave_rx_head = 0;
+    s_slave_rx_tail = 0;
+    s_slave_rx_next = 0;
+    s_slave_tx_head = 0;
+    s_slave_tx_tail = 0;
+    s_slave_tx_next = 0;
+    memset(&s_slave_stats, 0, sizeof(s_slave_stats));
+    memset(s_slave_idle, SPI_SLAVE_IDLE_DATA, sizeof(s_slave_idle));
+    SCB_CleanDCache_by_Addr((uint32_t *)s_slave_idle, sizeof(s_slave_idle));
+    SCB_CleanInvalidateDCache_by_Addr((uint32_t *)s_slave_rx, sizeof(s_slave_rx));
+    SCB_CleanInvalidateDCache_by_Addr((uint32_t *)s_slave_drop, sizeof(s_slave_drop));
+
+    dma_single_data_para_struct_init(&dma_init_struct);
+    dma_deinit(SPI_SLAVE_DMA, SPI_SLAVE_DMA_RX_CHANNEL);
+    mem0 = spi_slave_rx_target(DMA_MEMORY_0);
+    dma_init_struct.request             = DMA_REQUEST_SPI4_RX;
+    dma_init_struct.periph_addr         = SPI_SLAVE_RD_ADDRESS;
+    dma_init_struct.memory0_addr        = mem0;
+    dma_init_struct.number              = SPI_SLAVE_FRAME_SIZE;
+    dma_init_struct.periph_inc          = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc          = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.periph_memory_width = DMA_PERIPH_WIDTH_8BIT;
+    dma_init_struct.direction           = DMA_PERIPH_TO_MEMORY;
+    dma_init_struct.priority            = DMA_PRIORITY_ULTRA_HIGH;
+    dma_init_struct.circular_mode       = DMA_CIRCULAR_MODE_ENABLE;
+    dma_single_data_mode_init(SPI_SLAVE_DMA, SPI_SLAVE_DMA_RX_CHANNEL, &dma_init_struct);
+    dma_switch_buffer_mode_config(SPI_SLAVE_DMA, SPI_SLAVE_DMA_RX_CHANNEL, spi_slave_rx_target(DMA_MEMORY_1), DMA_MEMORY_0);
+    dma_switch_buffer_mode_enable(SPI_SLAVE_DMA, SPI_SLAVE_DMA_RX_CHANNEL);
+
+    dma_deinit(SPI_SLAVE_DMA, SPI_SLAVE_DMA_TX_CHANNEL);
+    mem0 = spi_slave_tx_target(DMA_MEMORY_0);
+    dma_init_struct.request             = DMA_REQUEST_SPI4_TX;
+    dma_init_struct.periph_addr         = SPI_SLAVE_TD_ADDRESS;
+    dma_init_struct.memory0_addr        = mem0;
+    dma_init_struct.direction           = DMA_MEMORY_TO_PERIPH;
+    dma_init_struct.priority            = DMA_PRIORITY_HIGH;
+    dma_single_data_mode_init(SPI_SLAVE_DMA, SPI_SLAVE_DMA_TX_CHANNEL, &dma_init_struct);
+    dma_switch_buffer_mode_config(SPI_SLAVE_DMA, SPI_SLAVE_DMA_TX_CHANNEL, spi_slave_tx_target(DMA_MEMORY_1), DMA_MEMORY_0);
+    dma_switch_buffer_mode_enable(SPI_SLAVE_DMA, SPI_SLAVE_DMA_TX_CHANNEL);
+
+    spi_dma_enable(SPI_SLAVE_PERIPH, SPI_DMA_RECEIVE);
+    dma_channel_enable(SPI_SLAVE_DMA, SPI_SLAVE_DMA_RX_CHANNEL);
+    dma_channel_enable(SPI_SLAVE_DMA, SPI_SLAVE_DMA_TX_CHANNEL);
+    spi_dma_enable(SPI_SLAVE_PERIPH, SPI_DMA_TRANSMIT);
+
+    SPI_INT(SPI_SLAVE_PERIPH) = SPI_INT_ESTCIE | SPI_INT_TXUREIE | SPI_INT_RXOREIE;
+    syscfg_exti_line_config(SPI_SLAVE_NSS_EXTI_PORT, SPI_SLAVE_NSS_EXTI_PIN);
+    exti_init(SPI_SLAVE_NSS_EXTI, EXTI_INTERRUPT, EXTI_TRIG_RISING);
+    exti_interrupt_flag_clear(SPI_SLAVE_NSS_EXTI);
+    nvic_irq_enable(SPI_SLAVE_IRQ, SPI_SLAVE_IRQ_PRIORITY, 0);
+    nvic_irq_enable(SPI_SLAVE_NSS_IRQ, SPI_SLAVE_NSS_IRQ_PRIORITY, 0);
+
+    idle_constraint_register(&s_slave_idle_constraint);
+    s_slave_mark_us = timer_monotonic_us();
+    s_slave_mark_bytes = 0;
+    spi_enable(SPI_SLAVE_PERIPH);
+    return SUCCESS;
+}
+
+/*!
+    \brief      get the oldest received frame
+    \param[in]  none
+    \param[out] none
+    \retval     SPI_SLAVE_FRAME_SIZE bytes of payload, NULL if no frame is waiting
+    \note       Frames with a bad CRC are skipped. The frame stays valid until
+                spi_slave_rx_release and must not be written to: a dirty cache
+                line would be evicted over the next DMA data.
+*/
+uint8_t *spi_slave_rx_peek(void)
+{
+    uint8_t slot;
+
+    while(s_slave_rx_tail != s_slave_rx_head)
+    {
+        slot = (uint8_t)(s_slave_rx_tail & (SPI_SLAVE_RX_SLOTS - 1U));
+        if(!s_slave_rx_bad[slot])
+        {
+            return s_slave_rx[slot];
+        }
+        s_slave_rx_tail++;
+    }
+    return NULL;
+}
+
+/*!
+    \brief      return the oldest received frame to the ring
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void spi_slave_rx_release(void)
+{
+    if(s_slave_rx_tail != s_slave_rx_head)
+    {
+        s_slave_rx_tail++;
+    }
+}
+
+/*!
+    \brief      get a free transmit frame
+    \param[in]  none
+    \param[out] none
+    \retval     SPI_SLAVE_FRAME_SIZE bytes to fill, NULL if the ring is full
+    \note       A committed frame goes out two frames later at the earliest,
+                since the DMA already holds the next frame's buffer.
+*/
+uint8_t *spi_slave_tx_alloc(void)
+{
+    if((s_slave_tx_head - s_slave_tx_tail) >= SPI_SLAVE_TX_SLOTS)
+    {
+        return NULL;
+    }
+    return s_slave_tx[s_slave_tx_head & (SPI_SLAVE_TX_SLOTS - 1U)];
+}
+
+/*!
+    \brief      queue the frame returned by spi_slave_tx_alloc
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void spi_slave_tx_commit(void)
+{
+    if((s_slave_tx_head - s_slave_tx_tail) >= SPI_SLAVE_TX_SLOTS)
+    {
+        return;
+    }
+    SCB_CleanDCache_by_Addr((uint32_t *)s_slave_tx[s_slave_tx_head & (SPI_SLAVE_TX_SLOTS - 1U)], SPI_SLAVE_FRAME_SIZE);
+    __DSB();
+    s_slave_tx_head++;
+}
+
+/*!
+    \brief      copy link statistics
+    \param[in]  none
+    \param[out] stats: statistics
+    \retval     none
+*/
+void spi_slave_stats_get(spi_slave_stats_struct *stats)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = s_slave_stats;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      print link statistics and sustained throughput
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Throughput counts the payload of good frames since the last
+                call, so CRC bytes, NSS gaps and bad frames show as lost rate.
+*/
+void spi_slave_stats_print(void)
+{
+    spi_slave_stats_struct stats;
+    uint32_t now = timer_monotonic_us();
+    uint32_t elapsed, rate;
+
+    spi_slave_stats_get(&stats);
+    elapsed = now - s_slave_mark_us;
+    rate = (elapsed != 0U) ? (uint32_t)((stats.bytes - s_slave_mark_bytes) * 1000000U / elapsed) : 0U;
+    s_slave_mark_us = now;
+    s_slave_mark_bytes = stats.bytes;
+
+    PRINT("spi slave: %u.%02u MB/s over %u ms\r\n", (unsigned)(rate / 1000000U), (unsigned)(rate / 10000U % 100U),
+          (unsigned)(elapsed / 1000U));
+    PRINT("  rx %u frames, %u crc errors, %u framing errors, %u dropped, %u overruns\r\n",
+          (unsigned)stats.rx_frames, (unsigned)stats.crc_errors, (unsigned)stats.framing_errors,
+          (unsigned)stats.dropped, (unsigned)stats.overruns);
+    PRINT("  tx %u frames, %u idle frames, %u underruns\r\n",
+          (unsigned)stats.tx_frames, (unsigned)stats.idle_frames, (unsigned)stats.underruns);
+}
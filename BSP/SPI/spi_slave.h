@@ -0,0 +1,91 @@
+/*!
+    \file       spi_slave.h
+    \brief      header file for SPI slave streaming link
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - SPI4 slave resource configuration (pins, DMA channels, frame format)
+    - Zero-copy receive and transmit frame rings fed by double-buffered DMA
+    - Link statistics with sustained throughput and underrun counts
+*/
+
+#ifndef __SPI_SLAVE_H
+#define __SPI_SLAVE_H
+#include <stdint.h>
+#include <stddef.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief SPI slave configuration macros
+*/
+#define SPI_SLAVE_PERIPH            SPI4                                    /*!< SPI used as link slave */
+#define SPI_SLAVE_RCU               RCU_SPI4                                /*!< SPI peripheral clock */
+#define SPI_SLAVE_IDX               IDX_SPI4                                /*!< SPI kernel clock selector index */
+#define SPI_SLAVE_CLOCK_SOURCE      RCU_SPISRC_PLL2Q                        /*!< kernel clock, independent of DVFS */
+#define SPI_SLAVE_IRQ               SPI4_IRQn                               /*!< SPI interrupt */
+#define SPI_SLAVE_IRQHandler        SPI4_IRQHandler                         /*!< SPI interrupt handler */
+#define SPI_SLAVE_IRQ_PRIORITY      1U                                      /*!< SPI interrupt priority, re-arms between frames */
+#define SPI_SLAVE_MODE              SPI_CK_PL_LOW_PH_1EDGE                  /*!< clock polarity and phase of the link */
+
+#define SPI_SLAVE_GPIO_RCU          RCU_GPIOF                               /*!< SPI pins port clock */
+#define SPI_SLAVE_GPIO_PORT         GPIOF                                   /*!< SPI pins port */
+#define SPI_SLAVE_GPIO_AF           GPIO_AF_5                               /*!< SPI4 alternate function */
+#define SPI_SLAVE_NSS_PIN           GPIO_PIN_6                              /*!< NSS pin, frames the link */
+#define SPI_SLAVE_SCK_PIN           GPIO_PIN_7                              /*!< SCK pin */
+#define SPI_SLAVE_MISO_PIN          GPIO_PIN_8                              /*!< MISO pin */
+#define SPI_SLAVE_MOSI_PIN          GPIO_PIN_9                              /*!< MOSI pin */
+
+/* SPI pins as PINCFG table rows: NSS pulled up, so an unconnected master leaves the slave deselected */
+#define SPI_SLAVE_PINS(PIN, x) \
+    PIN(x, SPI_SLAVE_GPIO_PORT, PINCFG_PIN(SPI_SLAVE_NSS_PIN), GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_OTYPE_PP, GPIO_OSPEED_12MHZ, SPI_SLAVE_GPIO_AF) \
+    PIN(x, SPI_SLAVE_GPIO_PORT, PINCFG_PIN(SPI_SLAVE_SCK_PIN), GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_OTYPE_PP, GPIO_OSPEED_12MHZ, SPI_SLAVE_GPIO_AF) \
+    PIN(x, SPI_SLAVE_GPIO_PORT, PINCFG_PIN(SPI_SLAVE_MISO_PIN), GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_OTYPE_PP, GPIO_OSPEED_100_220MHZ, SPI_SLAVE_GPIO_AF) \
+    PIN(x, SPI_SLAVE_GPIO_PORT, PINCFG_PIN(SPI_SLAVE_MOSI_PIN), GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_OTYPE_PP, GPIO_OSPEED_12MHZ, SPI_SLAVE_GPIO_AF)
+#define SPI_SLAVE_NSS_EXTI          EXTI_6                                  /*!< EXTI line of the NSS pin */
+#define SPI_SLAVE_NSS_EXTI_PORT     EXTI_SOURCE_GPIOF                       /*!< EXTI source port of the NSS pin */
+#define SPI_SLAVE_NSS_EXTI_PIN      EXTI_SOURCE_PIN6                        /*!< EXTI source pin of the NSS pin */
+#define SPI_SLAVE_NSS_IRQ           EXTI5_9_IRQn                            /*!< NSS release interrupt */
+#define SPI_SLAVE_NSS_IRQHandler    EXTI5_9_IRQHandler                      /*!< NSS release interrupt handler */
+#define SPI_SLAVE_NSS_IRQ_PRIORITY  2U                                      /*!< below the SPI interrupt, so end of frame is seen first */
+
+#define SPI_SLAVE_DMA               DMA0                                    /*!< DMA controller for the link */
+#define SPI_SLAVE_DMA_CLOCK         RCU_DMA0                                /*!< DMA clock for the link */
+#define SPI_SLAVE_DMA_RX_CHANNEL    DMA_CH6                                 /*!< DMA channel draining SPI_RDATA */
+#define SPI_SLAVE_DMA_TX_CHANNEL    DMA_CH7                                 /*!< DMA channel feeding SPI_TDATA */
+#define SPI_SLAVE_TD_ADDRESS        (SPI4 + 0x20U)                          /*!< SPI transmit data register address */
+#define SPI_SLAVE_RD_ADDRESS        (SPI4 + 0x30U)                          /*!< SPI receive data register address */
+
+#define SPI_SLAVE_FRAME_SIZE        512U                                    /*!< payload bytes per NSS frame, multiple of 32 */
+#define SPI_SLAVE_RX_SLOTS          8U                                      /*!< receive ring frames, power of two */
+#define SPI_SLAVE_TX_SLOTS          4U                                      /*!< transmit ring frames, power of two */
+#define SPI_SLAVE_CRC_POLY          0x1021U                                 /*!< CRC-16/CCITT appended to every frame */
+#define SPI_SLAVE_UNDERRUN_DATA     0xFFU                                   /*!< byte sent when the transmit FIFO runs dry */
+#define SPI_SLAVE_IDLE_DATA         0x00U                                   /*!< payload of frames sent with an empty transmit ring */
+
+/*!
+    \brief SPI slave link statistics
+*/
+typedef struct
+{
+    uint32_t rx_frames;                                                     /*!< frames received with a good CRC */
+    uint32_t tx_frames;                                                     /*!< queued frames sent */
+    uint32_t idle_frames;                                                   /*!< idle frames sent for an empty transmit ring */
+    uint32_t crc_errors;                                                    /*!< frames received with a bad CRC */
+    uint32_t framing_errors;                                                /*!< frames cut short by NSS */
+    uint32_t dropped;                                                       /*!< frames lost to a full receive ring */
+    uint32_t underruns;                                                     /*!< transmit FIFO underruns */
+    uint32_t overruns;                                                      /*!< receive FIFO overruns */
+    uint64_t bytes;                                                         /*!< payload bytes of complete frames */
+} spi_slave_stats_struct;
+
+/* function declarations */
+ErrStatus spi_slave_init(void);                                                         /*!< configure the slave and arm the first frame */
+uint8_t *spi_slave_rx_peek(void);                                                       /*!< oldest received frame, NULL if none */
+void spi_slave_rx_release(void);                                                        /*!< return the oldest received frame to the ring */
+uint8_t *spi_slave_tx_alloc(void);                                                      /*!< free transmit frame, NULL if the ring is full */
+void spi_slave_tx_commit(void);                                                         /*!< queue the frame from spi_slave_tx_alloc */
+void spi_slave_stats_get(spi_slave_stats_struct *stats);                                /*!< copy statistics */
+void spi_slave_stats_print(void);                                                       /*!< print statistics and sustained throughput */
+#endif /* __SPI_SLAVE_H */
@@ -19,6 +19,11 @@
 #include "gd32h7xx_libopt.h"
 #include "./SYSTEM/system.h"
 #include "./USART/usart.h"
+#include "./CLOCK/clock.h"
+#include "./CLOCK/clock_config.h"
+
+/* clock_config.h must be generated for the HXTAL this board is built with */
+typedef char system_clock_config_hxtal_check[(CLOCK_CONFIG_HXTAL == HXTAL_VALUE) ? 1 : -1];
 
 system_device_struct    system_device_info;
 
@@ -54,12 +59,14 @@ static void system_device_info_get(void)
 */
 static void system_rcu_clock_freq_get(void)
 {
-    system_device_info.rcu_clock_freq.sys_ck = rcu_clock_freq_get(CK_SYS);
-    system_device_info.rcu_clock_freq.ahb_ck = rcu_clock_freq_get(CK_AHB);
-    system_device_info.rcu_clock_freq.apb1_ck = rcu_clock_freq_get(CK_APB1);
-    system_device_info.rcu_clock_freq.apb2_ck = rcu_clock_freq_get(CK_APB2);
-    system_device_info.rcu_clock_freq.apb3_ck = rcu_clock_freq_get(CK_APB3);
-    system_device_info.rcu_clock_freq.apb4_ck = rcu_clock_freq_get(CK_APB4);
+    const clock_tree_struct *tree = clock_tree_get();
+
+    system_device_info.rcu_clock_freq.sys_ck = tree->freq[CLOCK_SYS];
+    system_device_info.rcu_clock_freq.ahb_ck = tree->freq[CLOCK_AHB];
+    system_device_info.rcu_clock_freq.apb1_ck = tree->freq[CLOCK_APB1];
+    system_device_info.rcu_clock_freq.apb2_ck = tree->freq[CLOCK_APB2];
+    system_device_info.rcu_clock_freq.apb3_ck = tree->freq[CLOCK_APB3];
+    system_device_info.rcu_clock_freq.apb4_ck = tree->freq[CLOCK_APB4];
 }
 
 /*!
@@ -156,10 +163,6 @@ void system_fwdgt_init(void)
     fwdgt_enable();
 }
 
-/* DWT (Data Watchpoint and Trace) register definitions */
-#define  DEM_CR_TRCENA               (1 << 24)    /* Enable trace and debug block DEMCR.TRCENA */
-#define  DWT_CR_CYCCNTENA            (1 <<  0)    /* Enable cycle counter DWT_CR.CYCCNTENA */
-
 /*!
     \brief      initialize DWT (Data Watchpoint and Trace) for cycle counting
     \param[in]  none
@@ -182,21 +185,19 @@ void system_dwt_init(void)
 void system_rcu_peripheral_clock_config(void)
 {
     /*
-        PLL1 Configuration:
-        - PLL1P: ADC clock source (130MHz)
-        - PLL1R: SDIO clock source (260MHz)
-        Formula: CK_PLL1 = HXTAL_VALUE / M * N / P
-        Where M=5, N=104, P=4 for PLL1P, P=2 for PLL1R
+        PLL1 Configuration (TOOLS/clock_gen.py, see clock_config.h):
+        - PLL1P: ADC clock source (CLOCK_PLL1P_HZ, 130MHz)
+        - PLL1R: SDIO clock source (CLOCK_PLL1R_HZ, 260MHz)
+        - PLL1Q: output disabled, divider kept at 260MHz (CLOCK_PLL1Q_HZ)
     */
     /* configure the pll1 input and output clock range */
-    rcu_pll_input_output_clock_range_config(IDX_PLL1, RCU_PLL1RNG_4M_8M, RCU_PLL1VCO_192M_836M);
-    /* configure the PLL1P clock: CK_PLL1P/CK_PLL1Q/CK_PLL1R = HXTAL_VALUE / 5 * 104 / 4, 130MHz */
-    /* configure the PLL1R clock: CK_PLL1P/CK_PLL1Q/CK_PLL1R = HXTAL_VALUE / 5 * 104 / 2, 260MHz */
-    rcu_pll1_config(5, 104, 4, 2, 2);
+    rcu_pll_input_output_clock_range_config(IDX_PLL1, CLOCK_PLL1_RNG, CLOCK_PLL1_VCO);
+    rcu_pll1_config(CLOCK_PLL1_PSC, CLOCK_PLL1_N, CLOCK_PLL1_P, CLOCK_PLL1_Q, CLOCK_PLL1_R);
     /* enable PLL1P clock output */
     rcu_pll_clock_output_enable(RCU_PLL1P);
     /* enable PLL1R clock output */
     rcu_pll_clock_output_enable(RCU_PLL1R);
+    clock_tree_invalidate();
     /* enable PLL1 clock */
     rcu_osci_on(RCU_PLL1_CK);
 
@@ -206,15 +207,15 @@ void system_rcu_peripheral_clock_config(void)
     }
     
     /*
-        PLL2 Configuration:
-        - PLL2R: TLI (LCD-TFT) clock source (48MHz)
-        Formula: CK_PLL2R = HXTAL_VALUE / M * N / R
-        Where M=25, N=288, R=6
-        PLL2R = 25MHz / 25 * 288 / 6 = 48MHz
+        PLL2 Configuration (TOOLS/clock_gen.py, see clock_config.h):
+        - PLL2Q: SPI3 kernel clock (CLOCK_PLL2Q_HZ, 120MHz)
+        - PLL2R: TLI (LCD-TFT) clock source (CLOCK_PLL2R_HZ, 48MHz)
     */
-    rcu_pll_input_output_clock_range_config(IDX_PLL2, RCU_PLL2RNG_1M_2M, RCU_PLL2VCO_192M_836M);
-    rcu_pll2_config(25, 288, 2, 2, 6);  /* PLL2R = 25 / 25 * 288 / 6 = 48MHz */
+    rcu_pll_input_output_clock_range_config(IDX_PLL2, CLOCK_PLL2_RNG, CLOCK_PLL2_VCO);
+    rcu_pll2_config(CLOCK_PLL2_PSC, CLOCK_PLL2_N, CLOCK_PLL2_P, CLOCK_PLL2_Q, CLOCK_PLL2_R);
+    rcu_pll_clock_output_enable(RCU_PLL2Q);
     rcu_pll_clock_output_enable(RCU_PLL2R);
+    clock_tree_invalidate();
     
     /* enable PLL2 clock */
     rcu_osci_on(RCU_PLL2_CK);
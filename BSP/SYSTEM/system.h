@@ -20,15 +20,19 @@
 /*!
     \brief      OS support configuration
                 0: bare-metal mode
-                1: FreeRTOS support mode
+                1: FreeRTOS support mode, set by the RTOS build type
 */
+#ifndef SYSTEM_SUPPORT_OS
 #define SYSTEM_SUPPORT_OS 0
+#endif /* SYSTEM_SUPPORT_OS */
 
 /* DWT (Data Watchpoint and Trace) register definitions for precise timing */
 #define  DWT_CYCCNT  *(volatile unsigned int *)0xE0001004    /*!< cycle counter register */
 #define  DWT_CR      *(volatile unsigned int *)0xE0001000    /*!< control register */
 #define  DEM_CR      *(volatile unsigned int *)0xE000EDFC    /*!< debug exception and monitor control register */
-#define  DBGMCU_CR   *(volatile unsigned int *)0xE0042004    /*!< debug MCU configuration register */
+#define  DBGMCU_CR   *(volatile unsigned int *)0xE00E1004    /*!< debug MCU configuration register (DBG_CTL0) */
+#define  DEM_CR_TRCENA               (1 << 24)    /*!< enable trace and debug block DEMCR.TRCENA */
+#define  DWT_CR_CYCCNTENA            (1 <<  0)    /*!< enable cycle counter DWT_CR.CYCCNTENA */
 	
 
 /* TCM RAM base address definitions */
@@ -0,0 +1,415 @@
+/*!
+    \file       thermal.c
+    \brief      thermal-aware performance governor on LPDTS threshold interrupts
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Continuous LPDTS measurement with a threshold window around the current level
+    - Level decision in the threshold interrupt, no polling of the sensor
+    - DVFS operating point limit and peripheral duty notifiers per level
+    - Threshold recomputation when DVFS changes the sensor reference clock
+    - Thermal event log with wall-clock timestamps
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./THERMAL/thermal.h"
+#include "./DVFS/dvfs.h"
+#include "./CLOCK/clock.h"
+#include "./WALLCLOCK/wallclock.h"
+#include "./USART/usart.h"
+
+const uint8_t g_thermal_opp_limit[THERMAL_LEVEL_NUM] = {DVFS_OPP_600M, DVFS_OPP_480M, DVFS_OPP_SLOWEST, DVFS_OPP_SLOWEST};
+const uint8_t g_thermal_duty[THERMAL_LEVEL_NUM] = {100, 75, 50, 25};
+
+static const thermal_law_struct s_thermal_law =
+{
+    {THERMAL_WARM_MC, THERMAL_HOT_MC, THERMAL_CRITICAL_MC},
+    THERMAL_HYSTERESIS_MC
+};
+static const char *s_thermal_level_name[THERMAL_LEVEL_NUM] = {"normal", "warm", "hot", "critical"};
+
+static thermal_calib_struct s_thermal_calib;                                /* sensor calibration, ref_hz follows DVFS */
+static volatile uint8_t s_thermal_target = THERMAL_LEVEL_NORMAL;            /* level decided by the interrupt */
+static uint8_t s_thermal_level = THERMAL_LEVEL_NORMAL;                      /* level applied by thermal_process */
+static thermal_notifier_struct *s_thermal_notifiers = NULL;                 /* throttle notifier chain */
+static thermal_stats_struct s_thermal_stats;                                /* statistics */
+
+static thermal_event_struct s_thermal_log[THERMAL_LOG_DEPTH];               /* event log */
+static volatile uint32_t s_thermal_log_head = 0;                            /* next entry written by the interrupt */
+static volatile uint32_t s_thermal_log_tail = 0;                            /* next entry popped by thermal_event_get */
+
+static ErrStatus thermal_dvfs_notify(uint8_t phase, uint32_t old_hz, uint32_t new_hz, void *arg);
+static dvfs_notifier_struct s_thermal_dvfs_notifier = {thermal_dvfs_notify, NULL, NULL};
+
+/*!
+    \brief      program the threshold window of a level
+    \param[in]  level: level whose window is armed (thermal_level_enum)
+    \param[out] none
+    \retval     none
+    \note       The count falls as the die heats up, so leaving upwards is a
+                count below the low threshold and leaving downwards a count
+                above the high threshold.
+*/
+static void thermal_window_set(uint8_t level)
+{
+    int32_t low_mc, high_mc;
+
+    thermal_law_window(&s_thermal_law, level, &low_mc, &high_mc);
+    lpdts_low_threshold_set((uint16_t)((high_mc == THERMAL_TEMP_NONE) ? 0U : thermal_calib_count(&s_thermal_calib, high_mc)));
+    lpdts_high_threshold_set((uint16_t)((low_mc == THERMAL_TEMP_NONE) ? 0xFFFFU : thermal_calib_count(&s_thermal_calib, low_mc)));
+}
+
+/*!
+    \brief      decide the level for a measurement and log a change
+    \param[in]  count: LPDTS_DATA counter value
+    \param[out] none
+    \retval     none
+    \note       Runs in the threshold interrupt, or with it disabled after a
+                clock change, so the log has one writer at a time.
+*/
+static void thermal_evaluate(uint32_t count)
+{
+    thermal_event_struct *event;
+    int32_t temp_mc;
+    uint8_t from, to;
+
+    temp_mc = thermal_calib_temp(&s_thermal_calib, count);
+    s_thermal_stats.temp_mc = temp_mc;
+    if(temp_mc > s_thermal_stats.max_temp_mc)
+    {
+        s_thermal_stats.max_temp_mc = temp_mc;
+    }
+
+    from = s_thermal_target;
+    to = thermal_law_level(&s_thermal_law, from, temp_mc);
+    if(to == from)
+    {
+        return;
+    }
+    s_thermal_target = to;
+    thermal_window_set(to);
+
+    if((s_thermal_log_head - s_thermal_log_tail) < THERMAL_LOG_DEPTH)
+    {
+        event = &s_thermal_log[s_thermal_log_head & (THERMAL_LOG_DEPTH - 1U)];
+        event->time_us = wallclock_now();
+        event->temp_mc = temp_mc;
+        event->from = from;
+        event->to = to;
+        s_thermal_log_head++;
+    }
+    else
+    {
+        s_thermal_stats.events_lost++;
+    }
+}
+
+/*!
+    \brief      wait for the next end of measurement
+    \param[in]  none
+    \param[out] count: LPDTS_DATA counter value
+    \retval     ErrStatus: SUCCESS, or ERROR after THERMAL_EM_TIMEOUT polls
+*/
+static ErrStatus thermal_measurement_wait(uint32_t *count)
+{
+    uint32_t timeout = 0U;
+
+    lpdts_interrupt_flag_clear(LPDTS_INT_FLAG_EM);
+    while(RESET == lpdts_flag_get(LPDTS_INT_FLAG_EM))
+    {
+        if(++timeout >= THERMAL_EM_TIMEOUT)
+        {
+            return ERROR;
+        }
+    }
+    *count = LPDTS_DATA & LPDTS_DATA_COVAL;
+    return SUCCESS;
+}
+
+/*!
+    \brief      hold off threshold interrupts across a clock change
+    \param[in]  phase: DVFS_PHASE_CHECK, DVFS_PHASE_PRE or DVFS_PHASE_POST
+    \param[in]  old_hz: CK_SYS before the change
+    \param[in]  new_hz: CK_SYS after the change
+    \param[in]  arg: unused
+    \param[out] none
+    \retval     SUCCESS, every frequency is accepted
+    \note       The LPDTS count is in PCLK cycles, so the thresholds are
+                recomputed for the new clock. The measurement running during the
+                switch counted in both clocks and is dropped; the next one
+                decides the level, so a real crossing is not lost.
+*/
+static ErrStatus thermal_dvfs_notify(uint8_t phase, uint32_t old_hz, uint32_t new_hz, void *arg)
+{
+    uint32_t count;
+
+    (void)old_hz;
+    (void)new_hz;
+    (void)arg;
+
+    if(phase == DVFS_PHASE_PRE)
+    {
+        lpdts_interrupt_disable(LPDTS_INT_LT | LPDTS_INT_HT);
+    }
+    else if(phase == DVFS_PHASE_POST)
+    {
+        s_thermal_calib.ref_hz = clock_freq_get(CLOCK_APB4);
+        if((SUCCESS == thermal_measurement_wait(&count)) && (SUCCESS == thermal_measurement_wait(&count)))
+        {
+            thermal_evaluate(count);
+        }
+        thermal_window_set(s_thermal_target);
+        lpdts_interrupt_flag_clear(LPDTS_INT_FLAG_LT | LPDTS_INT_FLAG_HT);
+        lpdts_interrupt_enable(LPDTS_INT_LT | LPDTS_INT_HT);
+    }
+    return SUCCESS;
+}
+
+/*!
+    \brief      start continuous measurement and the threshold interrupts
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The reference is PCLK of the APB4 bus the sensor sits on (the
+                library helper lpdts_temperature_get uses CK_APB1, which runs at
+                the same rate in this clock setup). Call after dvfs_init and
+                wallclock_init.
+*/
+void thermal_init(void)
+{
+    lpdts_parameter_struct lpdts_initpara;
+    uint32_t sdata;
+    int32_t temp_mc;
+
+    rcu_periph_clock_enable(RCU_LPDTS);
+    lpdts_deinit();
+
+    sdata = LPDTS_SDATA;
+    s_thermal_calib.t0_c = (int32_t)((sdata & LPDTS_SDATA_VAL) >> 16);
+    if(s_thermal_calib.t0_c == 0)
+    {
+        s_thermal_calib.t0_c = 25;
+    }
+    s_thermal_calib.t0_hz = (sdata & LPDTS_SDATA_FREQ) * 100U;
+    s_thermal_calib.ramp_hz = LPDTS_RDATA & LPDTS_RDATA_RCVAL;
+    s_thermal_calib.ref_hz = clock_freq_get(CLOCK_APB4);
+    s_thermal_calib.spt = THERMAL_SPT;
+
+    lpdts_struct_para_init(&lpdts_initpara);
+    lpdts_initpara.ref_clock = REF_PCLK;
+    lpdts_initpara.trigger_input = NO_HARDWARE_TRIGGER;
+    lpdts_initpara.sampling_time = SMP_TIME(THERMAL_SPT);
+    lpdts_init(&lpdts_initpara);
+    lpdts_enable();
+    while(RESET == lpdts_flag_get(LPDTS_FLAG_TSR))
+    {
+    }
+
+    /* first measurement sets the starting level */
+    lpdts_interrupt_flag_clear(LPDTS_INT_FLAG_EM);
+    lpdts_soft_trigger_enable();
+    while(RESET == lpdts_flag_get(LPDTS_INT_FLAG_EM))
+    {
+    }
+    temp_mc = thermal_calib_temp(&s_thermal_calib, LPDTS_DATA & LPDTS_DATA_COVAL);
+
+    s_thermal_stats.temp_mc = temp_mc;
+    s_thermal_stats.max_temp_mc = temp_mc;
+    s_thermal_stats.level = THERMAL_LEVEL_NORMAL;
+    s_thermal_stats.duty = g_thermal_duty[THERMAL_LEVEL_NORMAL];
+    s_thermal_stats.interrupts = 0;
+    s_thermal_stats.level_changes = 0;
+    s_thermal_stats.events_lost = 0;
+    s_thermal_level = THERMAL_LEVEL_NORMAL;
+    s_thermal_target = thermal_law_level(&s_thermal_law, THERMAL_LEVEL_NORMAL, temp_mc);
+
+    thermal_window_set(s_thermal_target);
+    lpdts_interrupt_flag_clear(LPDTS_INT_FLAG_LT | LPDTS_INT_FLAG_HT);
+    lpdts_interrupt_enable(LPDTS_INT_LT | LPDTS_INT_HT);
+    nvic_irq_enable(LPDTS_IRQn, THERMAL_IRQ_PRIORITY, 0);
+    dvfs_notifier_register(&s_thermal_dvfs_notifier);
+
+    thermal_process();
+}
+
+/*!
+    \brief      apply a level decided by the threshold interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Call from the main loop or a low-priority task. Changing the
+                operating point waits for USART drains and PLL lock, which does
+                not belong in an interrupt; the interrupt only decides.
+*/
+void thermal_process(void)
+{
+    thermal_notifier_struct *notifier;
+    uint8_t level;
+#if THERMAL_LOG_PRINT
+    thermal_event_struct event;
+    uint32_t abs_mc;
+
+    while(thermal_event_get(&event))
+    {
+        abs_mc = (event.temp_mc < 0) ? (0U - (uint32_t)event.temp_mc) : (uint32_t)event.temp_mc;
+        if(event.to > event.from)
+        {
+            PRINT_WARN("thermal %s%u.%01u C: %s -> %s\r\n", (event.temp_mc < 0) ? "-" : "", (unsigned)(abs_mc / 1000U),
+                       (unsigned)((abs_mc % 1000U) / 100U), s_thermal_level_name[event.from], s_thermal_level_name[event.to]);
+        }
+        else
+        {
+            PRINT_INFO("thermal %s%u.%01u C: %s -> %s\r\n", (event.temp_mc < 0) ? "-" : "", (unsigned)(abs_mc / 1000U),
+                       (unsigned)((abs_mc % 1000U) / 100U), s_thermal_level_name[event.from], s_thermal_level_name[event.to]);
+        }
+    }
+#endif /* THERMAL_LOG_PRINT */
+
+    level = s_thermal_target;
+    if(level == s_thermal_level)
+    {
+        return;
+    }
+    dvfs_opp_limit_set(g_thermal_opp_limit[level]);
+    s_thermal_level = level;
+    s_thermal_stats.level = level;
+    s_thermal_stats.duty = g_thermal_duty[level];
+    s_thermal_stats.level_changes++;
+    for(notifier = s_thermal_notifiers; notifier != NULL; notifier = notifier->next)
+    {
+        notifier->callback(level, g_thermal_duty[level], notifier->arg);
+    }
+}
+
+/*!
+    \brief      read the latest measurement
+    \param[in]  none
+    \param[out] none
+    \retval     die temperature in milli-degrees
+*/
+int32_t thermal_temperature_get(void)
+{
+    return thermal_calib_temp(&s_thermal_calib, LPDTS_DATA & LPDTS_DATA_COVAL);
+}
+
+/*!
+    \brief      get the applied level
+    \param[in]  none
+    \param[out] none
+    \retval     level (thermal_level_enum)
+*/
+uint8_t thermal_level_get(void)
+{
+    return s_thermal_level;
+}
+
+/*!
+    \brief      get the applied peripheral duty
+    \param[in]  none
+    \param[out] none
+    \retval     duty percent for duty-cycled peripherals
+*/
+uint8_t thermal_duty_get(void)
+{
+    return g_thermal_duty[s_thermal_level];
+}
+
+/*!
+    \brief      add a throttle notifier
+    \param[in]  notifier: notifier with callback set, must stay valid until unregistered
+    \param[out] none
+    \retval     none
+*/
+void thermal_notifier_register(thermal_notifier_struct *notifier)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    notifier->next = s_thermal_notifiers;
+    s_thermal_notifiers = notifier;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      remove a throttle notifier
+    \param[in]  notifier: registered notifier
+    \param[out] none
+    \retval     none
+*/
+void thermal_notifier_unregister(thermal_notifier_struct *notifier)
+{
+    thermal_notifier_struct **link;
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for(link = &s_thermal_notifiers; *link != NULL; link = &(*link)->next)
+    {
+        if(*link == notifier)
+        {
+            *link = notifier->next;
+            notifier->next = NULL;
+            break;
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      pop the oldest logged event
+    \param[in]  none
+    \param[out] event: thermal event
+    \retval     1 if an event was returned, 0 if the log is empty
+    \note       With THERMAL_LOG_PRINT 1 thermal_process pops and prints the
+                events itself. A full log drops new events, see events_lost.
+*/
+uint8_t thermal_event_get(thermal_event_struct *event)
+{
+    uint32_t tail = s_thermal_log_tail;
+
+    if(tail == s_thermal_log_head)
+    {
+        return 0;
+    }
+    *event = s_thermal_log[tail & (THERMAL_LOG_DEPTH - 1U)];
+    s_thermal_log_tail = tail + 1U;
+    return 1;
+}
+
+/*!
+    \brief      copy governor statistics
+    \param[in]  none
+    \param[out] stats: statistics
+    \retval     none
+*/
+void thermal_stats_get(thermal_stats_struct *stats)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = s_thermal_stats;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      LPDTS threshold interrupt handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Thresholds only fire when the temperature leaves the window of
+                the current level; the window of the new level is armed at once
+                so a steady temperature does not interrupt again.
+*/
+void LPDTS_IRQHandler(void)
+{
+    uint32_t count;
+
+    count = LPDTS_DATA & LPDTS_DATA_COVAL;
+    lpdts_interrupt_flag_clear(LPDTS_INT_FLAG_LT | LPDTS_INT_FLAG_HT);
+    s_thermal_stats.interrupts++;
+    thermal_evaluate(count);
+}
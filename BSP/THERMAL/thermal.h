@@ -0,0 +1,87 @@
+/*!
+    \file       thermal.h
+    \brief      header file for thermal-aware performance governor on LPDTS
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Governor thresholds, sensor setup and per-level throttle tables
+    - Throttle notifier chain for duty-cycled peripherals
+    - Thermal event log and statistics
+    - Function declarations for the interrupt-driven governor
+*/
+
+#ifndef __THERMAL_H
+#define __THERMAL_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+#include "./THERMAL/thermal_law.h"
+
+/*!
+    \brief thermal governor configuration macros
+*/
+#define THERMAL_WARM_MC             85000                                   /*!< enter WARM, milli-degrees */
+#define THERMAL_HOT_MC              95000                                   /*!< enter HOT, milli-degrees */
+#define THERMAL_CRITICAL_MC         105000                                  /*!< enter CRITICAL, milli-degrees */
+#define THERMAL_HYSTERESIS_MC       5000                                    /*!< cooling needed to leave a level */
+#define THERMAL_SPT                 15U                                     /*!< sampling time in sensor clocks */
+#define THERMAL_LOG_DEPTH           16U                                     /*!< logged events, power of two */
+#define THERMAL_LOG_PRINT           1                                       /*!< 1: thermal_process prints and pops the events, 0: left to thermal_event_get */
+#define THERMAL_EM_TIMEOUT          100000U                                 /*!< polls of the end of measurement flag after a clock change */
+#define THERMAL_IRQ_PRIORITY        3U                                      /*!< LPDTS interrupt priority */
+
+/*!
+    \brief thermal event
+*/
+typedef struct
+{
+    uint64_t time_us;                                                       /*!< wallclock_now at detection */
+    int32_t temp_mc;                                                        /*!< temperature that crossed the threshold */
+    uint8_t from;                                                           /*!< previous level */
+    uint8_t to;                                                             /*!< new level */
+} thermal_event_struct;
+
+struct thermal_notifier;
+
+/*! throttle callback, called from thermal_process */
+typedef void (*thermal_notifier_fn)(uint8_t level, uint8_t duty, void *arg);
+
+/*!
+    \brief throttle notifier, linked into the notifier chain
+*/
+typedef struct thermal_notifier
+{
+    thermal_notifier_fn callback;                                           /*!< function called on every level change */
+    void *arg;                                                              /*!< user argument passed to callback */
+    struct thermal_notifier *next;                                          /*!< next notifier, managed by thermal */
+} thermal_notifier_struct;
+
+/*!
+    \brief governor statistics
+*/
+typedef struct
+{
+    int32_t temp_mc;                                                        /*!< temperature at the last interrupt */
+    int32_t max_temp_mc;                                                    /*!< highest temperature seen */
+    uint8_t level;                                                          /*!< applied level */
+    uint8_t duty;                                                           /*!< applied peripheral duty percent */
+    uint32_t interrupts;                                                    /*!< threshold interrupts */
+    uint32_t level_changes;                                                 /*!< applied level changes */
+    uint32_t events_lost;                                                   /*!< events dropped from a full log */
+} thermal_stats_struct;
+
+extern const uint8_t g_thermal_opp_limit[THERMAL_LEVEL_NUM];               /*!< fastest DVFS point per level */
+extern const uint8_t g_thermal_duty[THERMAL_LEVEL_NUM];                    /*!< peripheral duty percent per level */
+
+/* function declarations */
+void thermal_init(void);                                                                /*!< start the sensor and threshold interrupts */
+void thermal_process(void);                                                             /*!< apply a pending level change */
+int32_t thermal_temperature_get(void);                                                  /*!< one measurement in milli-degrees */
+uint8_t thermal_level_get(void);                                                        /*!< applied level */
+uint8_t thermal_duty_get(void);                                                         /*!< applied peripheral duty percent */
+void thermal_notifier_register(thermal_notifier_struct *notifier);                      /*!< add a throttle notifier */
+void thermal_notifier_unregister(thermal_notifier_struct *notifier);                    /*!< remove a throttle notifier */
+uint8_t thermal_event_get(thermal_event_struct *event);                                 /*!< pop the oldest logged event */
+void thermal_stats_get(thermal_stats_struct *stats);                                    /*!< copy statistics */
+#endif /* __THERMAL_H */
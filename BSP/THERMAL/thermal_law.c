@@ -0,0 +1,121 @@
+/*!
+    \file       thermal_law.c
+    \brief      thermal governor control law and first-order thermal model
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Throttle level decision with hysteresis, one step per threshold crossing
+    - Threshold window so the sensor interrupts only when the level must change
+    - LPDTS count and temperature conversion in both directions
+    - Thermal RC model to run the law against a simulated die
+*/
+
+#include "./THERMAL/thermal_law.h"
+
+/*!
+    \brief      decide the throttle level for a temperature
+    \param[in]  law: control law configuration
+    \param[in]  level: current level (thermal_level_enum)
+    \param[in]  temp_mc: die temperature in milli-degrees
+    \param[out] none
+    \retval     new level (thermal_level_enum)
+    \note       Levels rise as soon as their entry temperature is reached and
+                fall only below entry minus hysteresis, so a temperature
+                hovering at a boundary does not toggle the clock.
+*/
+uint8_t thermal_law_level(const thermal_law_struct *law, uint8_t level, int32_t temp_mc)
+{
+    if(level >= THERMAL_LEVEL_NUM)
+    {
+        level = THERMAL_LEVEL_NUM - 1;
+    }
+    while((level < THERMAL_LEVEL_NUM - 1) && (temp_mc >= law->enter_mc[level]))
+    {
+        level++;
+    }
+    while((level > THERMAL_LEVEL_NORMAL) && (temp_mc < law->enter_mc[level - 1] - law->hysteresis_mc))
+    {
+        level--;
+    }
+    return level;
+}
+
+/*!
+    \brief      get the temperatures that end a level
+    \param[in]  law: control law configuration
+    \param[in]  level: current level (thermal_level_enum)
+    \param[out] low_mc: leave downwards below this, THERMAL_TEMP_NONE at NORMAL
+    \param[out] high_mc: leave upwards at or above this, THERMAL_TEMP_NONE at CRITICAL
+    \retval     none
+*/
+void thermal_law_window(const thermal_law_struct *law, uint8_t level, int32_t *low_mc, int32_t *high_mc)
+{
+    *low_mc = (level > THERMAL_LEVEL_NORMAL) ? (law->enter_mc[level - 1] - law->hysteresis_mc) : THERMAL_TEMP_NONE;
+    *high_mc = (level < THERMAL_LEVEL_NUM - 1) ? law->enter_mc[level] : THERMAL_TEMP_NONE;
+}
+
+/*!
+    \brief      convert an LPDTS count to temperature
+    \param[in]  calib: calibration and measurement setup
+    \param[in]  count: LPDTS_DATA counter value, reference clocks over spt sensor clocks
+    \param[out] none
+    \retval     temperature in milli-degrees
+    \note       Same relation as lpdts_temperature_get with PCLK reference:
+                f = 2 * ref_hz * spt / count, T = T0 + (f - f0) / ramp.
+*/
+int32_t thermal_calib_temp(const thermal_calib_struct *calib, uint32_t count)
+{
+    int64_t freq;
+
+    if((count == 0U) || (calib->ramp_hz == 0U))
+    {
+        return THERMAL_TEMP_NONE;
+    }
+    freq = (int64_t)((2ULL * calib->ref_hz * calib->spt) / count);
+    return (int32_t)((int64_t)calib->t0_c * 1000 + ((freq - (int64_t)calib->t0_hz) * 1000) / (int64_t)calib->ramp_hz);
+}
+
+/*!
+    \brief      convert a temperature to the LPDTS count measured at it
+    \param[in]  calib: calibration and measurement setup
+    \param[in]  temp_mc: temperature in milli-degrees
+    \param[out] none
+    \retval     LPDTS count, saturated to 16 bits
+    \note       The count falls as the temperature rises.
+*/
+uint32_t thermal_calib_count(const thermal_calib_struct *calib, int32_t temp_mc)
+{
+    int64_t freq;
+    uint64_t count;
+
+    freq = (int64_t)calib->t0_hz + (((int64_t)temp_mc - (int64_t)calib->t0_c * 1000) * (int64_t)calib->ramp_hz) / 1000;
+    if(freq <= 0)
+    {
+        return 0xFFFFU;
+    }
+    count = (2ULL * calib->ref_hz * calib->spt) / (uint64_t)freq;
+    return (count > 0xFFFFU) ? 0xFFFFU : (uint32_t)count;
+}
+
+/*!
+    \brief      advance the thermal model
+    \param[in]  model: model state and parameters
+    \param[in]  power_mw: dissipation during the step
+    \param[in]  dt_ms: step length, small against tau_ms
+    \param[out] model: temperature updated
+    \retval     none
+    \note       dT/dt = (ambient + rth * P - T) / tau, explicit Euler step.
+*/
+void thermal_model_step(thermal_model_struct *model, uint32_t power_mw, uint32_t dt_ms)
+{
+    int64_t target;
+
+    if(model->tau_ms == 0U)
+    {
+        return;
+    }
+    target = (int64_t)model->ambient_mc + (int64_t)model->rth_mc_per_mw * power_mw;
+    model->temp_mc += (int32_t)(((target - model->temp_mc) * (int64_t)dt_ms) / (int64_t)model->tau_ms);
+}
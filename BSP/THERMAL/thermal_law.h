@@ -0,0 +1,73 @@
+/*!
+    \file       thermal_law.h
+    \brief      header file for thermal governor control law and thermal model
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Throttle levels with entry temperatures and hysteresis
+    - Level decision and threshold window for interrupt-driven monitoring
+    - LPDTS count to temperature conversion from the factory calibration
+    - First-order thermal model for host simulation of the control law
+    - No device headers; the host selftest checks the law, the calibration
+      and the law closed around the model
+*/
+
+#ifndef __THERMAL_LAW_H
+#define __THERMAL_LAW_H
+#include <stdint.h>
+
+/*!
+    \brief throttle levels, ordered from unthrottled to most throttled
+*/
+typedef enum
+{
+    THERMAL_LEVEL_NORMAL = 0,                                               /*!< no throttling */
+    THERMAL_LEVEL_WARM,                                                     /*!< light throttling */
+    THERMAL_LEVEL_HOT,                                                      /*!< heavy throttling */
+    THERMAL_LEVEL_CRITICAL,                                                 /*!< slowest clock, minimum duty */
+    THERMAL_LEVEL_NUM
+} thermal_level_enum;
+
+#define THERMAL_TEMP_NONE           INT32_MIN                               /*!< no threshold in this direction */
+
+/*!
+    \brief control law configuration, temperatures in milli-degrees Celsius
+*/
+typedef struct
+{
+    int32_t enter_mc[THERMAL_LEVEL_NUM - 1];                                /*!< temperature entering WARM, HOT, CRITICAL */
+    int32_t hysteresis_mc;                                                  /*!< drop below enter - hysteresis to leave a level */
+} thermal_law_struct;
+
+/*!
+    \brief LPDTS factory calibration and measurement setup
+*/
+typedef struct
+{
+    int32_t t0_c;                                                           /*!< calibration temperature T0 */
+    uint32_t t0_hz;                                                         /*!< sensor frequency at T0 */
+    uint32_t ramp_hz;                                                       /*!< sensor frequency change per degree */
+    uint32_t ref_hz;                                                        /*!< reference clock (PCLK) */
+    uint32_t spt;                                                           /*!< sampling time in sensor clocks */
+} thermal_calib_struct;
+
+/*!
+    \brief first-order thermal model of the die
+*/
+typedef struct
+{
+    int32_t temp_mc;                                                        /*!< die temperature */
+    int32_t ambient_mc;                                                     /*!< ambient temperature */
+    uint32_t rth_mc_per_mw;                                                 /*!< steady-state rise per mW of dissipation */
+    uint32_t tau_ms;                                                        /*!< thermal time constant */
+} thermal_model_struct;
+
+/* function declarations */
+uint8_t thermal_law_level(const thermal_law_struct *law, uint8_t level, int32_t temp_mc);              /*!< next level for a temperature */
+void thermal_law_window(const thermal_law_struct *law, uint8_t level, int32_t *low_mc, int32_t *high_mc); /*!< thresholds that end a level */
+int32_t thermal_calib_temp(const thermal_calib_struct *calib, uint32_t count);                        /*!< LPDTS count to milli-degrees */
+uint32_t thermal_calib_count(const thermal_calib_struct *calib, int32_t temp_mc);                     /*!< milli-degrees to LPDTS count */
+void thermal_model_step(thermal_model_struct *model, uint32_t power_mw, uint32_t dt_ms);             /*!< advance the model */
+#endif /* __THERMAL_LAW_H */
@@ -14,11 +14,16 @@
     - Conditional compilation support for OS and non-OS environments
     - High-resolution 64-bit timer counting for performance monitoring
     - Automatic DMA reception completion detection and flag management
+    - Reception-complete handlers deferred to task context in the RTOS build
+    - Monotonic microsecond timebase on 32-bit TIMER1 for idle and load metering
+    - One-shot timebase alarm on TIMER1 channel 0 to wake the core at a deadline
 */
 
 #include "gd32h7xx_libopt.h"
 #include "./TIMER/timer.h"
 #include "./USART/usart.h"
+#include "./CLOCK/clock.h"
+#include "./RTOS/rtos.h"
 
 /*!
     \brief      configure TIMER5 for USART timeout detection
@@ -142,6 +147,128 @@ void timer_general16_config(uint16_t psc, uint16_t period)
     timer_enable(TIMER16);
 }
 
+/*!
+    \brief      prescaler register value for the monotonic timebase
+    \param[in]  none
+    \param[out] none
+    \retval     prescaler register value
+*/
+static uint16_t timer_monotonic_psc(void)
+{
+    uint32_t div;
+
+    div = clock_freq_get(CLOCK_TIMER_APB1) / TIMER_MONOTONIC_HZ;
+    return (uint16_t)((div > 0U) ? (div - 1U) : 0U);
+}
+
+/*!
+    \brief      start TIMER1 as a free-running microsecond counter
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Unlike the DWT cycle counter, the count does not depend on the CPU
+                clock and keeps running while the core sleeps. It stops in
+                deep-sleep, where timer_monotonic_set restores it from the RTC.
+*/
+void timer_monotonic_config(void)
+{
+    timer_parameter_struct timer_initpara;
+
+    /* enable TIMER1 clock */
+    rcu_periph_clock_enable(RCU_TIMER1);
+
+    /* reset TIMER1 */
+    timer_deinit(TIMER_MONOTONIC);
+
+    /* configure TIMER1 parameters */
+    timer_struct_para_init(&timer_initpara);
+    timer_initpara.prescaler         = timer_monotonic_psc();
+    timer_initpara.period            = 0xFFFFFFFFU;
+    timer_initpara.clockdivision     = TIMER_CKDIV_DIV1;
+    timer_initpara.repetitioncounter = 0;
+    timer_init(TIMER_MONOTONIC, &timer_initpara);
+    timer_counter_value_config(TIMER_MONOTONIC, 0);
+    timer_enable(TIMER_MONOTONIC);
+
+    /* channel 0 compare interrupt for timer_monotonic_alarm_set */
+    nvic_irq_enable(TIMER1_IRQn, 4, 0);
+}
+
+/*!
+    \brief      read the microsecond timebase
+    \param[in]  none
+    \param[out] none
+    \retval     microseconds since timer_monotonic_config, modulo 2^32
+*/
+uint32_t timer_monotonic_us(void)
+{
+    return TIMER_CNT(TIMER_MONOTONIC);
+}
+
+/*!
+    \brief      set the microsecond timebase
+    \param[in]  us: new count
+    \param[out] none
+    \retval     none
+*/
+void timer_monotonic_set(uint32_t us)
+{
+    TIMER_CNT(TIMER_MONOTONIC) = us;
+}
+
+/*!
+    \brief      re-derive the timebase prescaler from the current APB1 timer clock
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The 32-bit counter only overflows every 71 minutes, so the new
+                prescaler is loaded at once with an update event, which also
+                clears the counter; the count is carried over by hand.
+*/
+void timer_monotonic_clock_update(void)
+{
+    uint32_t primask, count;
+
+    if((TIMER_CTL0(TIMER_MONOTONIC) & TIMER_CTL0_CEN) == 0U)
+    {
+        return;
+    }
+    primask = __get_PRIMASK();
+    __disable_irq();
+    count = TIMER_CNT(TIMER_MONOTONIC);
+    timer_prescaler_config(TIMER_MONOTONIC, timer_monotonic_psc(), TIMER_PSC_RELOAD_NOW);
+    TIMER_CNT(TIMER_MONOTONIC) = count;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      raise the TIMER1 interrupt when the timebase reaches a count
+    \param[in]  at_us: timer_monotonic_us value to wake at, less than 2^31 us ahead
+    \param[out] none
+    \retval     none
+    \note       One shot, the handler disables the interrupt again. This is the
+                deadline interrupt the sleep state of BSP/IDLE relies on; a count
+                already reached pends the interrupt at once. A clock change
+                keeps the alarm, timer_monotonic_clock_update restores the count.
+*/
+void timer_monotonic_alarm_set(uint32_t at_us)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    timer_interrupt_disable(TIMER_MONOTONIC, TIMER_INT_CH0);
+    TIMER_CH0CV(TIMER_MONOTONIC) = at_us;
+    timer_interrupt_flag_clear(TIMER_MONOTONIC, TIMER_INT_FLAG_CH0);
+    timer_interrupt_enable(TIMER_MONOTONIC, TIMER_INT_CH0);
+    /* the compare value is set before the count is read, so a match between the two still raises the flag */
+    if((int32_t)(TIMER_CNT(TIMER_MONOTONIC) - at_us) >= 0)
+    {
+        timer_event_software_generate(TIMER_MONOTONIC, TIMER_EVENT_SRC_CH0G);
+    }
+    __set_PRIMASK(primask);
+}
+
 #if SYSTEM_SUPPORT_OS
 /*!
     \brief      configure TIMER50 for FreeRTOS runtime statistics
@@ -227,10 +354,16 @@ void TIMER5_DAC_UDR_IRQHandler(void)
                     g_bsp_usart_recv_buff[g_bsp_usart_recv_length] = '\0';    /* add string terminator */ 
                 }
                 g_bsp_usart_recv_complete_flag = 1;                          /* reception complete */   
+                #if SYSTEM_SUPPORT_OS
+                    rtos_rx_complete_isr(RTOS_RX_BSP_USART);                 /* run the handler in task context */
+                #endif
             }
         #else
             g_recv_buff[g_bsp_usart_recv_length] = '\0';                      /* add string terminator */
             g_recv_complete_flag = 1;                                         /* reception complete */
+            #if SYSTEM_SUPPORT_OS
+                rtos_rx_complete_isr(RTOS_RX_BSP_USART);                      /* run the handler in task context */
+            #endif
         #endif
     }
 }
@@ -259,6 +392,9 @@ void TIMER6_IRQHandler(void)
                 g_usart_terminal_recv_buff[g_usart_terminal_recv_length] = '\0';    /* add string terminator */ 
             }
             g_usart_terminal_recv_complete_flag = 1;                               /* reception complete */   
+            #if SYSTEM_SUPPORT_OS
+                rtos_rx_complete_isr(RTOS_RX_TERMINAL);                            /* run the handler in task context */
+            #endif
         }
     }
 }
@@ -288,6 +424,9 @@ void TIMER15_IRQHandler(void)
                 g_uart4_recv_buff[g_uart4_recv_length] = '\0';              /* add string terminator */ 
             }
             g_uart4_recv_complete_flag = 1;                                 /* reception complete */   
+            #if SYSTEM_SUPPORT_OS
+                rtos_rx_complete_isr(RTOS_RX_UART4);                        /* run the handler in task context */
+            #endif
         }
     }
 }
@@ -308,3 +447,20 @@ void TIMER16_IRQHandler(void)
         FWDGT_CTL = FWDGT_KEY_RELOAD;
     }
 }
+
+/*!
+    \brief      TIMER1 interrupt handler for the timebase alarm
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Waking the core is all the alarm does; the main loop checks
+                its own deadlines.
+*/
+void TIMER1_IRQHandler(void)
+{
+    if(timer_interrupt_flag_get(TIMER_MONOTONIC, TIMER_INT_FLAG_CH0) == SET)
+    {
+        timer_interrupt_flag_clear(TIMER_MONOTONIC, TIMER_INT_FLAG_CH0);
+        timer_interrupt_disable(TIMER_MONOTONIC, TIMER_INT_CH0);
+    }
+}
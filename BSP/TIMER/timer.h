@@ -11,15 +11,26 @@
     - FreeRTOS runtime statistics timer function declarations
     - Single pulse mode timer setup for timeout applications
     - High-precision timing interfaces for performance monitoring
+    - Free-running microsecond timebase that keeps counting across clock changes
+    - One-shot timebase alarm to wake the core at a deadline
 */
 
 #ifndef __TIMER_H
 #define __TIMER_H
 #include <stdint.h>
 
+/* monotonic microsecond timebase, 32-bit counter wraps after about 71 minutes */
+#define TIMER_MONOTONIC             TIMER1                                      /*!< 32-bit timer on APB1 */
+#define TIMER_MONOTONIC_HZ          1000000U                                    /*!< counting frequency */
+
 /* function declarations */
 void timer_base5_config(uint16_t psc, uint32_t period);                         /*!< configure TIMER5 for BSP USART timeout detection */
 void timer_base6_config(uint16_t psc, uint32_t period);                         /*!< configure TIMER6 for terminal USART timeout detection */
 void timer_general15_config(uint16_t psc, uint16_t period);                     /*!< configure TIMER15 for UART4 timeout detection */
 void timer_general16_config(uint16_t psc, uint16_t period);                     /*!< configure TIMER16 for automatic watchdog feeding */
+void timer_monotonic_config(void);                                              /*!< start the microsecond timebase */
+uint32_t timer_monotonic_us(void);                                              /*!< current microsecond count */
+void timer_monotonic_set(uint32_t us);                                          /*!< set the count, e.g. after deep-sleep */
+void timer_monotonic_clock_update(void);                                        /*!< re-derive the prescaler after a clock change */
+void timer_monotonic_alarm_set(uint32_t at_us);                                 /*!< one-shot interrupt at a timebase count */
 #endif /* __TIMER_H */
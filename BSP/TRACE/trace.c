@@ -0,0 +1,111 @@
+/*!
+    \file       trace.c
+    \brief      ITM/SWO event trace
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Routing the ITM through the TPIU to the SWO pin in NRZ (UART) mode
+    - Local timestamps, sync packets and optional DWT exception trace, all
+      generated by hardware without CPU cost
+    - Optional DWT periodic PC sampling (TRACE_PC_SAMPLING)
+    - Text output on stimulus port 0 for rare messages
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./TRACE/trace.h"
+#include "./SYSTEM/system.h"
+
+#define TRACE_ITM_UNLOCK            0xC5ACCE55U                             /* ITM lock access key */
+#define TRACE_TPI_NRZ               2U                                      /* TPIU selected pin protocol: SWO NRZ */
+#define TRACE_TPI_FORMATTER_OFF     0x100U                                  /* FFCR: continuous formatting off, TrigIn on */
+#define TRACE_DWT_SYNCTAP_24        (1UL << DWT_CTRL_SYNCTAP_Pos)           /* sync packet every 2^24 cycles */
+#define TRACE_DWT_PC_SAMPLE         (DWT_CTRL_PCSAMPLENA_Msk | DWT_CTRL_CYCTAP_Msk | \
+                                     (TRACE_PC_SAMPLE_PRESET << DWT_CTRL_POSTPRESET_Pos))   /* tap at CYCCNT bit 10 */
+
+volatile uint32_t g_trace_dropped = 0;                                      /* events dropped on a full ITM FIFO */
+static uint32_t s_trace_swo_hz = 0;                                         /* configured SWO baud rate */
+
+/*!
+    \brief      route the ITM to the SWO pin and enable the stimulus ports
+    \param[in]  swo_hz: SWO baud rate, TRACE_SWO_HZ by default
+    \param[out] none
+    \retval     none
+    \note       Call after system_dwt_init. The baud rate divides the core
+                clock, so call again after a DVFS change. Timestamps count
+                core cycles and wrap nowhere: the decoder sums the deltas.
+                PC samples are 5 bytes each: at the default preset and 600 MHz
+                they need about 1.8 Mbaud, raise swo_hz for other events.
+*/
+void trace_init(uint32_t swo_hz)
+{
+    rcu_periph_clock_enable(TRACE_SWO_GPIO_RCU);
+    gpio_af_set(TRACE_SWO_GPIO_PORT, TRACE_SWO_AF, TRACE_SWO_PIN);
+    gpio_mode_set(TRACE_SWO_GPIO_PORT, GPIO_MODE_AF, GPIO_PUPD_NONE, TRACE_SWO_PIN);
+    gpio_output_options_set(TRACE_SWO_GPIO_PORT, GPIO_OTYPE_PP, GPIO_OSPEED_100_220MHZ, TRACE_SWO_PIN);
+
+    DEM_CR |= (unsigned int)DEM_CR_TRCENA;
+    DBGMCU_CR = (DBGMCU_CR & ~(unsigned int)DBG_CTL0_TRACE_MODE) | (unsigned int)(TRACE_MODE_ASYNC | DBG_CTL0_TRACECLKEN);
+
+    TPI->CSPSR = 1U;                                                        /* port width 1 bit */
+    TPI->SPPR = TRACE_TPI_NRZ;
+    TPI->ACPR = (SystemCoreClock / swo_hz) - 1U;
+    TPI->FFCR = TRACE_TPI_FORMATTER_OFF;
+
+    ITM->LAR = TRACE_ITM_UNLOCK;
+    ITM->TCR = 0U;                                                          /* disable while reconfiguring */
+    while(ITM->TCR & ITM_TCR_BUSY_Msk)
+    {
+    }
+    ITM->TPR = 0U;                                                          /* ports writable from unprivileged code */
+    ITM->TER = TRACE_PORTS_MASK;
+    ITM->TCR = (1UL << ITM_TCR_TraceBusID_Pos) | ITM_TCR_DWTENA_Msk | ITM_TCR_SYNCENA_Msk | \
+               ITM_TCR_TSENA_Msk | ITM_TCR_ITMENA_Msk;
+
+    DWT->CTRL = (DWT->CTRL & ~DWT_CTRL_SYNCTAP_Msk) | TRACE_DWT_SYNCTAP_24;
+#if TRACE_EXCEPTIONS
+    DWT->CTRL |= DWT_CTRL_EXCTRCENA_Msk;
+#endif
+#if TRACE_PC_SAMPLING
+    /* the sample counter reloads from POSTINIT first, CYCCNT must be running */
+    DWT->CTRL = (DWT->CTRL & ~(DWT_CTRL_POSTPRESET_Msk | DWT_CTRL_POSTINIT_Msk)) | (TRACE_PC_SAMPLE_PRESET << DWT_CTRL_POSTINIT_Pos);
+    DWT->CTRL |= TRACE_DWT_PC_SAMPLE | DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    s_trace_swo_hz = swo_hz;
+}
+
+/*!
+    \brief      write text to the text port
+    \param[in]  text: zero-terminated string
+    \param[out] none
+    \retval     none
+    \note       Waits for FIFO space, unlike the event macros: for start-up
+                banners and rare messages, not for hot paths.
+*/
+void trace_text(const char *text)
+{
+    if(!(ITM->TCR & ITM_TCR_ITMENA_Msk) || !(ITM->TER & (1UL << TRACE_PORT_TEXT)))
+    {
+        return;
+    }
+    while(*text)
+    {
+        while(ITM->PORT[TRACE_PORT_TEXT].u32 == 0UL)
+        {
+        }
+        ITM->PORT[TRACE_PORT_TEXT].u8 = (uint8_t)*text++;
+    }
+}
+
+/*!
+    \brief      copy statistics
+    \param[in]  none
+    \param[out] stats: baud rate and dropped events
+    \retval     none
+*/
+void trace_stats_get(trace_stats_struct *stats)
+{
+    stats->swo_hz = s_trace_swo_hz;
+    stats->dropped = g_trace_dropped;
+}
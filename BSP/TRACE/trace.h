@@ -0,0 +1,89 @@
+/*!
+    \file       trace.h
+    \brief      header file for ITM/SWO event trace
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - SWO pin, baud rate and stimulus port assignment
+    - Event macros (ISR enter/exit, scheduler switch, markers, values) that
+      cost one FIFO check and one store each
+    - Optional periodic PC sampling, the profile of TOOLS/pgo_layout.py
+    - Trace statistics
+*/
+
+#ifndef __TRACE_H
+#define __TRACE_H
+#include <stdint.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief trace configuration macros
+*/
+#define TRACE_ENABLE                1                                       /*!< 0: every TRACE_x macro compiles to nothing */
+#define TRACE_SWO_HZ                2000000U                                /*!< default SWO baud rate, must match the capture tool */
+#define TRACE_EXCEPTIONS            1                                       /*!< 1: DWT emits exception entry/exit packets, no code in the handlers */
+#ifndef TRACE_PC_SAMPLING
+#define TRACE_PC_SAMPLING           0                                       /*!< 1: DWT emits a PC sample every TRACE_PC_SAMPLE_CYCLES, set by the Profile build type */
+#endif /* TRACE_PC_SAMPLING */
+#define TRACE_PC_SAMPLE_PRESET      15U                                     /*!< sample every (preset + 1) * 1024 cycles: 36.6 k samples/s at 600 MHz */
+#define TRACE_PC_SAMPLE_CYCLES      ((TRACE_PC_SAMPLE_PRESET + 1U) * 1024U) /*!< cycles between two PC samples */
+#define TRACE_SWO_GPIO_RCU          RCU_GPIOB                               /*!< SWO pin port clock */
+#define TRACE_SWO_GPIO_PORT         GPIOB                                   /*!< SWO pin port */
+#define TRACE_SWO_PIN               GPIO_PIN_3                              /*!< TRACESWO pin */
+#define TRACE_SWO_AF                GPIO_AF_0                               /*!< TRACESWO alternate function */
+
+/* stimulus ports, decoded by TOOLS/swo_decode.py */
+#define TRACE_PORT_TEXT             0U                                      /*!< text, 1 byte per character */
+#define TRACE_PORT_ISR_ENTER        1U                                      /*!< 1 byte: exception number */
+#define TRACE_PORT_ISR_EXIT         2U                                      /*!< 1 byte: exception number */
+#define TRACE_PORT_SWITCH           3U                                      /*!< 2 bytes: previous task << 8 | next task */
+#define TRACE_PORT_MARK             4U                                      /*!< 4 bytes: marker id << 16 | 16-bit argument */
+#define TRACE_PORT_VALUE            5U                                      /*!< 4 bytes: raw value */
+#define TRACE_PORTS_MASK            0x3FU                                   /*!< ports enabled by trace_init */
+
+/*!
+    \brief trace statistics
+*/
+typedef struct
+{
+    uint32_t swo_hz;                                                        /*!< configured SWO baud rate */
+    uint32_t dropped;                                                       /*!< events dropped on a full ITM FIFO */
+} trace_stats_struct;
+
+extern volatile uint32_t g_trace_dropped;                                   /*!< events dropped on a full ITM FIFO */
+
+#if TRACE_ENABLE
+/* one stimulus write: a port reads 1 when its FIFO slot is free, a busy FIFO drops the event instead of stalling */
+#define TRACE_EMIT(port, width, value)                                                          \
+    do                                                                                          \
+    {                                                                                           \
+        if(ITM->PORT[port].u32 != 0UL)                                                          \
+        {                                                                                       \
+            ITM->PORT[port].width = (value);                                                    \
+        }                                                                                       \
+        else                                                                                    \
+        {                                                                                       \
+            g_trace_dropped++;                                                                  \
+        }                                                                                       \
+    } while(0)
+
+#define TRACE_ISR_ENTER()           TRACE_EMIT(TRACE_PORT_ISR_ENTER, u8, (uint8_t)__get_IPSR())                 /*!< first line of a handler */
+#define TRACE_ISR_EXIT()            TRACE_EMIT(TRACE_PORT_ISR_EXIT, u8, (uint8_t)__get_IPSR())                  /*!< last line of a handler */
+#define TRACE_SWITCH(prev, next)    TRACE_EMIT(TRACE_PORT_SWITCH, u16, (uint16_t)(((prev) << 8) | ((next) & 0xFFU)))  /*!< scheduler switched tasks */
+#define TRACE_MARK(id, arg)         TRACE_EMIT(TRACE_PORT_MARK, u32, ((uint32_t)(id) << 16) | ((uint32_t)(arg) & 0xFFFFU)) /*!< user marker */
+#define TRACE_VALUE(value)          TRACE_EMIT(TRACE_PORT_VALUE, u32, (uint32_t)(value))                        /*!< user value */
+#else
+#define TRACE_ISR_ENTER()
+#define TRACE_ISR_EXIT()
+#define TRACE_SWITCH(prev, next)
+#define TRACE_MARK(id, arg)
+#define TRACE_VALUE(value)
+#endif /* TRACE_ENABLE */
+
+/* function declarations */
+void trace_init(uint32_t swo_hz);                                                       /*!< route ITM to SWO and enable the ports */
+void trace_text(const char *text);                                                      /*!< write text to the text port, blocking */
+void trace_stats_get(trace_stats_struct *stats);                                        /*!< copy statistics */
+#endif /* __TRACE_H */
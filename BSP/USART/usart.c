@@ -12,12 +12,19 @@
     - Interrupt handling for USART communication
     - Support for multiple USART instances (USART0, USART1, UART4)
     - Terminal and module communication interfaces
+    - Idle constraints that keep the core out of deep-sleep, where the
+      USART kernel clocks, the receive DMA and the idle-line timeout timers
+      stop, while reception is enabled
 */
 
 #include "gd32h7xx_libopt.h"
 #include "./USART/usart.h"
 #include "./DELAY/delay.h"
 #include "TIMER/timer.h"
+#include "./CLOCK/clock.h"
+#include "./PINCFG/pincfg.h"
+#include "./IDLE/idle.h"
+#include "./ECC/ecc.h"
 
 /* support printf function, usemicrolib is unnecessary */
 #if (__ARMCC_VERSION > 6000000)
@@ -98,9 +105,61 @@ PUTCHAR_PROTOTYPE
     return ch;
 }
 
-uint8_t 	g_bsp_usart_recv_buff[BSP_USART_RECEIVE_LENGTH+1];                /* receive buffer */
+/*!
+    \brief      set the USART baud divider from the cached kernel clock
+    \param[in]  usart_periph: USARTx(x=0,1,2,5), UARTx(x=3,4,6,7)
+    \param[in]  uclk: USART kernel clock frequency
+    \param[in]  baud_rate: USART baud rate
+    \param[out] none
+    \retval     none
+    \note       Same divider as usart_baudrate_set, without decoding the RCU
+                registers again for every port.
+*/
+static void usart_baudrate_config(uint32_t usart_periph, uint32_t uclk, uint32_t baud_rate)
+{
+    uint32_t udiv;
+
+    if(USART_CTL0(usart_periph) & USART_CTL0_OVSMOD)
+    {
+        /* oversampling by 8 */
+        udiv = ((2U * uclk) + baud_rate / 2U) / baud_rate;
+        USART_BAUD(usart_periph) = (USART_BAUD_FRADIV | USART_BAUD_INTDIV) & ((udiv & 0x0000FFF0U) | ((udiv >> 1U) & 0x00000007U));
+    }
+    else
+    {
+        /* oversampling by 16 */
+        udiv = (uclk + baud_rate / 2U) / baud_rate;
+        USART_BAUD(usart_periph) = (USART_BAUD_FRADIV | USART_BAUD_INTDIV) & udiv;
+    }
+}
+
+/*!
+    \brief      keep the core out of deep-sleep while a USART receives
+    \param[in]  constraint: idle constraint of the USART
+    \param[out] none
+    \retval     none
+    \note       Deep-sleep stops the kernel clock, the receive DMA and the
+                idle-line timeout timer, so bytes arriving then are lost. The
+                init functions may run again, so the constraint is taken out of
+                the list before it is added.
+*/
+static void usart_idle_hold(idle_constraint_struct *constraint)
+{
+    constraint->max_latency_us = 0U;
+    idle_constraint_unregister(constraint);
+    idle_constraint_register(constraint);
+}
+
+ECC_DMA_BUFFER uint8_t 	g_bsp_usart_recv_buff[BSP_USART_RECEIVE_LENGTH+1];                /* receive buffer */
 uint16_t 	g_bsp_usart_recv_length = 0;									    /* received data length */
 uint8_t	    g_bsp_usart_recv_complete_flag = 0; 					            /* receive complete flag */
+static idle_constraint_struct s_usart_idle_constraint = {0, NULL};          /* sleep only, reception is always on */
+
+typedef char usart_pins_check[PINCFG_VALID(BSP_USART_PINS) ? 1 : -1];
+#if PINCFG_OWN(1)
+static const pincfg_port_struct s_usart_pins[2] = {PINCFG_PORT(BSP_USART_PINS, BSP_USART_TX_PORT, BSP_USART_TX_RCU),
+                                                   PINCFG_PORT(BSP_USART_PINS, BSP_USART_RX_PORT, BSP_USART_RX_RCU)};
+#endif /* PINCFG_OWN(1) */
 
 /*!
     \brief      configure USART receive DMA
@@ -142,25 +201,15 @@ static void usart_rx_dma_config(void)
 void usart_init(uint32_t baud_rate)
 {
     /* enable clocks */
-    rcu_periph_clock_enable(BSP_USART_TX_RCU);
-    rcu_periph_clock_enable(BSP_USART_RX_RCU);
     rcu_periph_clock_enable(BSP_USART_RCU);
 
-    /* configure GPIO alternate function */
-    gpio_af_set(BSP_USART_TX_PORT, BSP_USART_AF, BSP_USART_TX_PIN);	
-    gpio_af_set(BSP_USART_RX_PORT, BSP_USART_AF, BSP_USART_RX_PIN);	
-
-    /* configure GPIO mode */
-    gpio_mode_set(BSP_USART_TX_PORT, GPIO_MODE_AF, GPIO_PUPD_PULLUP, BSP_USART_TX_PIN);
-    gpio_mode_set(BSP_USART_RX_PORT, GPIO_MODE_AF, GPIO_PUPD_PULLUP, BSP_USART_RX_PIN);
-
-    /* configure GPIO output options */
-    gpio_output_options_set(BSP_USART_TX_PORT, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, BSP_USART_TX_PIN);
-    gpio_output_options_set(BSP_USART_RX_PORT, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, BSP_USART_RX_PIN);
+#if PINCFG_OWN(1)
+    pincfg_apply(s_usart_pins, 2U);                                     /* TX and RX port, may be the same */
+#endif /* PINCFG_OWN(1) */
 
     /* configure USART parameters */
     usart_deinit(BSP_USART);                                            
-    usart_baudrate_set(BSP_USART, baud_rate);                           
+    usart_baudrate_config(BSP_USART, clock_freq_get(CLOCK_USART0), baud_rate);                           
     usart_parity_config(BSP_USART, USART_PM_NONE);                      
     usart_word_length_set(BSP_USART, USART_WL_8BIT);                    
     usart_stop_bit_set(BSP_USART, USART_STB_1BIT);     			        
@@ -188,6 +237,7 @@ void usart_init(uint32_t baud_rate)
 
     timer_base5_config(300, 1000);                                     
     timer_disable(TIMER5);
+    usart_idle_hold(&s_usart_idle_constraint);
 }
 
 /*!
@@ -273,11 +323,17 @@ void BSP_USART_IRQHandler(void)
 }
 
 /* Terminal USART variables */
-uint8_t 	g_usart_terminal_recv_buff[USART_TERMINAL_RECEIVE_LENGTH + 1];          
+ECC_DMA_BUFFER uint8_t 	g_usart_terminal_recv_buff[USART_TERMINAL_RECEIVE_LENGTH + 1];          
 uint16_t 	g_usart_terminal_recv_length = 0;									    
 uint8_t	    g_usart_terminal_recv_complete_flag = 0; 					            
 
 uint8_t 	gUsartTerminalSendBuff[USART_TERMINAL_SEND_LENGTH + 1];                     
+static idle_constraint_struct s_usart_terminal_idle_constraint = {0, NULL}; /* sleep only, reception is always on */
+
+typedef char usart_terminal_pins_check[PINCFG_VALID(USART_TERMINAL_PINS) ? 1 : -1];
+#if PINCFG_OWN(PINCFG_BOARD_USART_TERMINAL)
+static const pincfg_port_struct s_usart_terminal_pins = PINCFG_PORT(USART_TERMINAL_PINS, GPIOD, RCU_GPIOD);
+#endif /* PINCFG_OWN(PINCFG_BOARD_USART_TERMINAL) */
 
 /*!
     \brief      configure terminal USART receive DMA
@@ -343,20 +399,14 @@ static void usart_terminal_tx_dma_config(void)
 */
 void usart_terminal_init(uint32_t baud_rate)
 {
-    rcu_periph_clock_enable(RCU_GPIOD);
     rcu_periph_clock_enable(RCU_USART1);
     
-    gpio_af_set(GPIOD, GPIO_AF_7, GPIO_PIN_5);	
-    gpio_af_set(GPIOD, GPIO_AF_7, GPIO_PIN_6);	
-
-    gpio_mode_set(GPIOD, GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_PIN_5);
-    gpio_mode_set(GPIOD, GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_PIN_6);
-
-    gpio_output_options_set(GPIOD, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, GPIO_PIN_5);
-    gpio_output_options_set(GPIOD, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, GPIO_PIN_6);
+#if PINCFG_OWN(PINCFG_BOARD_USART_TERMINAL)
+    pincfg_apply(&s_usart_terminal_pins, 1U);
+#endif /* PINCFG_OWN(PINCFG_BOARD_USART_TERMINAL) */
 
     usart_deinit(USART1);                                            
-    usart_baudrate_set(USART1, baud_rate);                           
+    usart_baudrate_config(USART1, clock_freq_get(CLOCK_USART1), baud_rate);                           
     usart_parity_config(USART1, USART_PM_NONE);                      
     usart_word_length_set(USART1, USART_WL_8BIT);                    
     usart_stop_bit_set(USART1, USART_STB_1BIT);     			     
@@ -382,6 +432,7 @@ void usart_terminal_init(uint32_t baud_rate)
     
     timer_base6_config(300, 1000);                                     
     timer_disable(TIMER6);
+    usart_idle_hold(&s_usart_terminal_idle_constraint);
 }
 
 /*!
@@ -445,11 +496,17 @@ void USART1_IRQHandler(void)
 }
 
 /* Module communication UART variables */
-uint8_t 	g_uart4_recv_buff[UART4_RECEIVE_LENGTH + 1];                    
+ECC_DMA_BUFFER uint8_t 	g_uart4_recv_buff[UART4_RECEIVE_LENGTH + 1];                    
 uint16_t 	g_uart4_recv_length = 0;									    
 uint8_t	    g_uart4_recv_complete_flag = 0; 					            
 
 uint8_t 	gUart4SendBuff[UART4_SEND_LENGTH + 1];                              
+static idle_constraint_struct s_uart4_idle_constraint = {0, NULL};          /* sleep only, reception is always on */
+
+typedef char uart4_pins_check[PINCFG_VALID(UART4_PINS) ? 1 : -1];
+#if PINCFG_OWN(PINCFG_BOARD_UART4)
+static const pincfg_port_struct s_uart4_pins[2] = {PINCFG_PORT(UART4_PINS, GPIOB, RCU_GPIOB), PINCFG_PORT(UART4_PINS, GPIOC, RCU_GPIOC)};
+#endif /* PINCFG_OWN(PINCFG_BOARD_UART4) */
 
 /*!
     \brief      configure UART4 receive DMA
@@ -515,21 +572,14 @@ static void uart4_tx_dma_config(void)
 */
 void uart4_init(uint32_t baud_rate)
 {
-    rcu_periph_clock_enable(RCU_GPIOB);
-    rcu_periph_clock_enable(RCU_GPIOC);
     rcu_periph_clock_enable(RCU_UART4);
     
-    gpio_af_set(GPIOB, GPIO_AF_14, GPIO_PIN_5);	
-    gpio_af_set(GPIOC, GPIO_AF_8, GPIO_PIN_12);	
-
-    gpio_mode_set(GPIOC, GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_PIN_12);
-    gpio_mode_set(GPIOB, GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_PIN_5);
-
-    gpio_output_options_set(GPIOC, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, GPIO_PIN_12);
-    gpio_output_options_set(GPIOB, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, GPIO_PIN_5);
+#if PINCFG_OWN(PINCFG_BOARD_UART4)
+    pincfg_apply(s_uart4_pins, 2U);
+#endif /* PINCFG_OWN(PINCFG_BOARD_UART4) */
 
     usart_deinit(UART4);                                            
-    usart_baudrate_set(UART4, baud_rate);                           
+    usart_baudrate_config(UART4, clock_freq_get(CLOCK_APB1), baud_rate);                           
     usart_parity_config(UART4, USART_PM_NONE);                      
     usart_word_length_set(UART4, USART_WL_8BIT);                    
     usart_stop_bit_set(UART4, USART_STB_1BIT);     			        
@@ -555,6 +605,7 @@ void uart4_init(uint32_t baud_rate)
     
     timer_general15_config(300, 1000);                                     
     timer_disable(TIMER15);
+    usart_idle_hold(&s_uart4_idle_constraint);
 }
 
 /*!
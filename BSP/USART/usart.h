@@ -77,6 +77,11 @@
 #define BSP_USART_TX_PIN            GPIO_PIN_9                              /*!< USART TX pin */
 #define BSP_USART_RX_PIN            GPIO_PIN_10                             /*!< USART RX pin */
 
+/* USART0 pins as PINCFG table rows, applied by pincfg_init or usart_init */
+#define BSP_USART_PINS(PIN, x) \
+    PIN(x, BSP_USART_TX_PORT, PINCFG_PIN(BSP_USART_TX_PIN), GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, BSP_USART_AF) \
+    PIN(x, BSP_USART_RX_PORT, PINCFG_PIN(BSP_USART_RX_PIN), GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, BSP_USART_AF)
+
 #define BSP_USART                   USART0                                  /*!< USART0 peripheral */
 #define BSP_USART_IRQ               USART0_IRQn                             /*!< USART0 interrupt */
 #define BSP_USART_IRQHandler        USART0_IRQHandler                       /*!< USART0 interrupt handler */
@@ -109,6 +114,11 @@ extern uint8_t  g_bsp_usart_recv_complete_flag;                             /*!<
 #define  USART_TERMINAL_RD_ADDRESS               (USART1 + 0x24)             /*!< USART1 receive data register address */
 #define  USART_TERMINAL_TD_ADDRESS               (USART1 + 0x28)             /*!< USART1 transmit data register address */
 
+/* USART1 pins as PINCFG table rows: PD5 TX, PD6 RX */
+#define USART_TERMINAL_PINS(PIN, x) \
+    PIN(x, GPIOD, 5U, GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, GPIO_AF_7) \
+    PIN(x, GPIOD, 6U, GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, GPIO_AF_7)
+
 #define USART_TERMINAL_RECEIVE_LENGTH    1024                                /*!< USART1 terminal receive buffer length */
 #define USART_TERMINAL_SEND_LENGTH       1024                                /*!< USART1 terminal send buffer length */
 
@@ -125,6 +135,11 @@ extern uint8_t  gUsartTerminalSendBuff[USART_TERMINAL_SEND_LENGTH + 1];     /*!<
 #define  UART4_RD_ADDRESS               (UART4 + 0x24)                       /*!< UART4 receive data register address */
 #define  UART4_TD_ADDRESS               (UART4 + 0x28)                       /*!< UART4 transmit data register address */
 
+/* UART4 pins as PINCFG table rows: PC12 TX, PB5 RX */
+#define UART4_PINS(PIN, x) \
+    PIN(x, GPIOC, 12U, GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, GPIO_AF_8) \
+    PIN(x, GPIOB,  5U, GPIO_MODE_AF, GPIO_PUPD_PULLUP, GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ, GPIO_AF_14)
+
 #define UART4_RECEIVE_LENGTH    1024                                         /*!< UART4 receive buffer length */
 #define UART4_SEND_LENGTH       1024                                         /*!< UART4 send buffer length */
 
@@ -0,0 +1,712 @@
+/*!
+    \file       wallclock.c
+    \brief      RTC-backed wall clock service with reference discipline and timestamps
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - RTC start-up on IRC32K with shadow registers bypassed and tick reading
+    - Fast Unix time from the monotonic timebase, no RTC access in the hot path
+    - Frequency and phase discipline against PPS or PTP reference samples
+    - RTC smooth calibration and coarse prescaler retune from the same samples
+    - RTC timestamp unit events converted to Unix time and queued
+*/
+
+#include "gd32h7xx_libopt.h"
+#include "./WALLCLOCK/wallclock.h"
+#include "./TIMER/timer.h"
+
+#define WALLCLOCK_DAY_S             86400U                                  /* seconds per day */
+#define WALLCLOCK_REBASE_US         0x40000000U                             /* rebase the monotonic delta before it can wrap */
+#define WALLCLOCK_HRFC_SHIFT        20U                                     /* smooth calibration window, 2^20 RTC clocks */
+#define WALLCLOCK_HRFC_PLUS         512                                     /* clocks added by RTC_HRFC_FREQI */
+
+static uint64_t s_wallclock_base_us = 0;                                    /* Unix time at s_wallclock_base_mono */
+static uint32_t s_wallclock_base_mono = 0;                                  /* timer_monotonic_us at the base */
+static int32_t s_wallclock_freq_ppb = 0;                                    /* monotonic rate correction */
+
+static uint8_t s_wallclock_ref_valid = 0;                                   /* 1: s_wallclock_ref_* hold a sample */
+static uint64_t s_wallclock_ref_us = 0;                                     /* last reference time */
+static uint32_t s_wallclock_ref_mono = 0;                                   /* monotonic time of the last reference */
+static uint64_t s_wallclock_cal_us = 0;                                     /* reference time at the calibration start */
+static uint32_t s_wallclock_cal_ticks = 0;                                  /* RTC ticks at the calibration start */
+
+static uint32_t s_wallclock_tps = WALLCLOCK_RTC_HZ;                         /* RTC ticks per second, FACTOR_S + 1 */
+static uint32_t s_wallclock_rtc_hz = WALLCLOCK_RTC_HZ;                      /* RTC clock, (FACTOR_A + 1) * (FACTOR_S + 1) */
+
+static uint64_t s_wallclock_ts_queue[WALLCLOCK_TS_DEPTH];                  /* timestamp queue */
+static volatile uint32_t s_wallclock_ts_head = 0;                           /* next entry written by the interrupt */
+static volatile uint32_t s_wallclock_ts_tail = 0;                           /* next entry read by wallclock_timestamp_get */
+static wallclock_timestamp_fn s_wallclock_ts_callback = NULL;               /* timestamp callback */
+static void *s_wallclock_ts_arg = NULL;                                     /* timestamp callback argument */
+
+static wallclock_stats_struct s_wallclock_stats;                            /* discipline statistics */
+
+/*!
+    \brief      convert a 2-digit BCD value
+    \param[in]  bcd: BCD value
+    \param[out] none
+    \retval     binary value
+*/
+static uint32_t wallclock_bcd(uint32_t bcd)
+{
+    return (bcd >> 4) * 10U + (bcd & 0x0FU);
+}
+
+/*!
+    \brief      days since 1970-01-01 of a Gregorian date
+    \param[in]  year: year, 1970 or later
+    \param[in]  month: 1..12
+    \param[in]  day: 1..31
+    \param[out] none
+    \retval     days
+*/
+static uint32_t wallclock_days(uint32_t year, uint32_t month, uint32_t day)
+{
+    uint32_t era, yoe, doy, doe;
+
+    year -= (month <= 2U) ? 1U : 0U;
+    era = year / 400U;
+    yoe = year - era * 400U;
+    doy = (153U * ((month > 2U) ? (month - 3U) : (month + 9U)) + 2U) / 5U + day - 1U;
+    doe = yoe * 365U + yoe / 4U - yoe / 100U + doy;
+    return era * 146097U + doe - 719468U;
+}
+
+/*!
+    \brief      seconds of day from an RTC_TIME or RTC_TTS value
+    \param[in]  time: register value
+    \param[out] none
+    \retval     seconds since midnight
+*/
+static uint32_t wallclock_time_s(uint32_t time)
+{
+    uint32_t hour;
+
+    hour = wallclock_bcd((time & (RTC_TIME_HRT | RTC_TIME_HRU)) >> 16);
+    if(RTC_CTL & RTC_CTL_CS)
+    {
+        hour = (hour % 12U) + ((time & RTC_TIME_PM) ? 12U : 0U);
+    }
+    return (hour * 60U + wallclock_bcd((time & (RTC_TIME_MNT | RTC_TIME_MNU)) >> 8)) * 60U + \
+           wallclock_bcd(time & (RTC_TIME_SCT | RTC_TIME_SCU));
+}
+
+/*!
+    \brief      Unix time of RTC calendar registers
+    \param[in]  date: RTC_DATE layout (year, month, day)
+    \param[in]  time: RTC_TIME layout
+    \param[in]  ss: sub second counter, counting down from FACTOR_S
+    \param[out] none
+    \retval     Unix time in microseconds, RTC offset not applied
+*/
+static uint64_t wallclock_rtc_unix(uint32_t date, uint32_t time, uint32_t ss)
+{
+    uint32_t days;
+
+    days = wallclock_days(2000U + wallclock_bcd((date & (RTC_DATE_YRT | RTC_DATE_YRU)) >> 16),
+                          wallclock_bcd((date & (RTC_DATE_MONT | RTC_DATE_MONU)) >> 8),
+                          wallclock_bcd(date & (RTC_DATE_DAYT | RTC_DATE_DAYU)));
+    return ((uint64_t)days * WALLCLOCK_DAY_S + wallclock_time_s(time)) * 1000000U + \
+           ((uint64_t)(s_wallclock_tps - 1U - ss) * 1000000U) / s_wallclock_tps;
+}
+
+/*!
+    \brief      read the RTC calendar as Unix time
+    \param[in]  none
+    \param[out] none
+    \retval     Unix time in microseconds, RTC offset not applied
+    \note       Shadow registers are bypassed, so RTC_SS is read again after the
+                calendar to make sure all registers belong to the same second.
+*/
+static uint64_t wallclock_rtc_read(void)
+{
+    uint32_t ss, time, date;
+
+    do
+    {
+        ss = RTC_SS & RTC_SS_SSC;
+        time = RTC_TIME;
+        date = RTC_DATE;
+    } while(ss != (RTC_SS & RTC_SS_SSC));
+    return wallclock_rtc_unix(date, time, ss);
+}
+
+/*!
+    \brief      read the RTC prescalers into the tick conversion
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void wallclock_rtc_psc_load(void)
+{
+    uint32_t psc = RTC_PSC;
+
+    s_wallclock_tps = (psc & RTC_PSC_FACTOR_S) + 1U;
+    s_wallclock_rtc_hz = (((psc & RTC_PSC_FACTOR_A) >> 16) + 1U) * s_wallclock_tps;
+}
+
+/*!
+    \brief      write the RTC calendar
+    \param[in]  unix_s: Unix time in seconds, 2000..2099
+    \param[in]  factor_s: synchronous prescaler to program
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note       The calendar restarts at the start of unix_s when init mode exits.
+*/
+static ErrStatus wallclock_rtc_write(uint64_t unix_s, uint32_t factor_s)
+{
+    rtc_parameter_struct rtc_initpara;
+    wallclock_date_struct date;
+
+    wallclock_to_date(unix_s * 1000000U, &date);
+    rtc_initpara.factor_asyn = (uint16_t)((RTC_PSC & RTC_PSC_FACTOR_A) >> 16);
+    rtc_initpara.factor_syn = (uint16_t)factor_s;
+    rtc_initpara.year = (uint8_t)((((date.year % 100U) / 10U) << 4) | (date.year % 10U));
+    rtc_initpara.month = (uint8_t)(((date.month / 10U) << 4) | (date.month % 10U));
+    rtc_initpara.date = (uint8_t)(((date.day / 10U) << 4) | (date.day % 10U));
+    rtc_initpara.day_of_week = date.weekday;
+    rtc_initpara.hour = (uint8_t)(((date.hour / 10U) << 4) | (date.hour % 10U));
+    rtc_initpara.minute = (uint8_t)(((date.minute / 10U) << 4) | (date.minute % 10U));
+    rtc_initpara.second = (uint8_t)(((date.second / 10U) << 4) | (date.second % 10U));
+    rtc_initpara.am_pm = RTC_AM;
+    rtc_initpara.display_format = RTC_24HOUR;
+    if(rtc_init(&rtc_initpara) != SUCCESS)
+    {
+        return ERROR;
+    }
+    wallclock_rtc_psc_load();
+    return SUCCESS;
+}
+
+/*!
+    \brief      store wall clock minus RTC time in the backup domain
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Call with interrupts disabled.
+*/
+static void wallclock_rtc_offset_update(void)
+{
+    uint64_t rtc;
+    uint32_t mono;
+
+    rtc = wallclock_rtc_read();
+    mono = timer_monotonic_us();
+    WALLCLOCK_RTC_OFFSET = (uint32_t)(int32_t)(int64_t)(wallclock_at(mono) - rtc);
+}
+
+/*!
+    \brief      program the RTC smooth calibration for a rate correction
+    \param[in]  correction_ppb: wanted frequency change, positive speeds the RTC up
+    \param[out] none
+    \retval     ErrStatus: SUCCESS, or ERROR if outside -487 .. +488 ppm
+*/
+static ErrStatus wallclock_rtc_smooth_set(int32_t correction_ppb)
+{
+    int64_t clocks;
+    uint32_t plus = RTC_CALIBRATION_PLUS_RESET;
+    ErrStatus status = SUCCESS;
+
+    /* clocks to add per 2^20: FREQI adds 512, each CMSK count removes one */
+    clocks = ((int64_t)correction_ppb << WALLCLOCK_HRFC_SHIFT) / 1000000000;
+    if(clocks > 0)
+    {
+        plus = RTC_CALIBRATION_PLUS_SET;
+        clocks = WALLCLOCK_HRFC_PLUS - clocks;
+    }
+    else
+    {
+        clocks = -clocks;
+    }
+    if(clocks < 0)
+    {
+        clocks = 0;
+        status = ERROR;
+    }
+    else if(clocks > (int64_t)RTC_HRFC_CMSK)
+    {
+        clocks = RTC_HRFC_CMSK;
+        status = ERROR;
+    }
+    rtc_smooth_calibration_config(RTC_CALIBRATION_WINDOW_32S, plus, (uint32_t)clocks);
+    return status;
+}
+
+/*!
+    \brief      current RTC smooth calibration as a rate correction
+    \param[in]  none
+    \param[out] none
+    \retval     frequency change in ppb, positive speeds the RTC up
+*/
+static int32_t wallclock_rtc_smooth_get(void)
+{
+    int64_t clocks;
+
+    clocks = -(int64_t)(RTC_HRFC & RTC_HRFC_CMSK);
+    if(RTC_HRFC & RTC_HRFC_FREQI)
+    {
+        clocks += WALLCLOCK_HRFC_PLUS;
+    }
+    return (int32_t)((clocks * 1000000000) >> WALLCLOCK_HRFC_SHIFT);
+}
+
+/*!
+    \brief      calibrate the RTC rate against the reference
+    \param[in]  ref_us: reference time now
+    \param[out] none
+    \retval     none
+    \note       Errors within the smooth calibration range are trimmed by
+                RTC_HRFC. An IRC32K clock can be off by far more, in which case
+                FACTOR_S is retuned to the measured frequency first and the
+                calendar is rewritten from the wall clock. Call with interrupts
+                disabled.
+*/
+static void wallclock_rtc_calibrate(uint64_t ref_us)
+{
+    uint32_t ticks, rtc_us, true_us, factor_s;
+    int64_t error_ppb, intrinsic_ppb;
+    int32_t correction;
+
+    ticks = wallclock_rtc_ticks();
+    true_us = (uint32_t)(ref_us - s_wallclock_cal_us);
+    rtc_us = wallclock_rtc_elapsed_us(s_wallclock_cal_ticks, ticks);
+    s_wallclock_cal_us = ref_us;
+    s_wallclock_cal_ticks = ticks;
+
+    /* error_ppb > 0: the RTC runs fast with the current correction */
+    error_ppb = (((int64_t)rtc_us - (int64_t)true_us) * 1000000000) / true_us;
+    s_wallclock_stats.rtc_ppb = (int32_t)error_ppb;
+    correction = wallclock_rtc_smooth_get() - (int32_t)error_ppb;
+
+    if(wallclock_rtc_smooth_set(correction) != SUCCESS)
+    {
+        /* ticks per second actually counted without smooth calibration */
+        intrinsic_ppb = error_ppb - wallclock_rtc_smooth_get();
+        factor_s = (uint32_t)((int64_t)s_wallclock_tps + ((int64_t)s_wallclock_tps * intrinsic_ppb + 500000000) / 1000000000) - 1U;
+        rtc_smooth_calibration_config(RTC_CALIBRATION_WINDOW_32S, RTC_CALIBRATION_PLUS_RESET, 0);
+        if((factor_s > 0U) && (factor_s <= RTC_PSC_FACTOR_S))
+        {
+            wallclock_rtc_write(wallclock_at(timer_monotonic_us()) / 1000000U, factor_s);
+        }
+        s_wallclock_cal_ticks = wallclock_rtc_ticks();
+    }
+    wallclock_rtc_offset_update();
+    s_wallclock_stats.rtc_calibrations++;
+    s_wallclock_stats.rtc_factor_s = s_wallclock_tps - 1U;
+    s_wallclock_stats.rtc_hrfc = RTC_HRFC;
+}
+
+/*!
+    \brief      start the RTC if it is stopped and bypass its shadow registers
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       A running RTC is kept with its clock source and prescalers; a
+                stopped one is started on IRC32K at 2025-01-01 00:00:00.
+*/
+void wallclock_rtc_init(void)
+{
+    rtc_parameter_struct rtc_initpara;
+
+    rcu_periph_clock_enable(RCU_PMU);
+    pmu_backup_write_enable();
+
+    if((RCU_BDCTL & RCU_BDCTL_RTCEN) == 0U)
+    {
+        rcu_osci_on(RCU_IRC32K);
+        while(SUCCESS != rcu_osci_stab_wait(RCU_IRC32K))
+        {
+        }
+        rcu_rtc_clock_config(RCU_RTCSRC_IRC32K);
+        rcu_periph_clock_enable(RCU_RTC);
+        rtc_register_sync_wait();
+
+        rtc_initpara.factor_asyn = 0;
+        rtc_initpara.factor_syn = WALLCLOCK_RTC_HZ - 1U;
+        rtc_initpara.year = 0x25;
+        rtc_initpara.month = RTC_JAN;
+        rtc_initpara.date = 0x01;
+        rtc_initpara.day_of_week = RTC_WEDNESDAY;
+        rtc_initpara.hour = 0;
+        rtc_initpara.minute = 0;
+        rtc_initpara.second = 0;
+        rtc_initpara.am_pm = RTC_AM;
+        rtc_initpara.display_format = RTC_24HOUR;
+        rtc_init(&rtc_initpara);
+        WALLCLOCK_RTC_OFFSET = 0;
+    }
+    rtc_register_sync_wait();
+    rtc_bypass_shadow_enable();
+    wallclock_rtc_psc_load();
+}
+
+/*!
+    \brief      get the RTC clock frequency
+    \param[in]  none
+    \param[out] none
+    \retval     RTC clock in Hz as implied by the prescalers
+*/
+uint32_t wallclock_rtc_hz(void)
+{
+    return s_wallclock_rtc_hz;
+}
+
+/*!
+    \brief      read the RTC as ticks since midnight
+    \param[in]  none
+    \param[out] none
+    \retval     ticks, one per synchronous prescaler count
+*/
+uint32_t wallclock_rtc_ticks(void)
+{
+    uint32_t ss, time;
+
+    do
+    {
+        ss = RTC_SS & RTC_SS_SSC;
+        time = RTC_TIME;
+    } while(ss != (RTC_SS & RTC_SS_SSC));
+    return wallclock_time_s(time) * s_wallclock_tps + (s_wallclock_tps - 1U - ss);
+}
+
+/*!
+    \brief      microseconds between two RTC tick readings
+    \param[in]  from: earlier wallclock_rtc_ticks value
+    \param[in]  to: later wallclock_rtc_ticks value
+    \param[out] none
+    \retval     elapsed microseconds, assuming less than one day passed
+*/
+uint32_t wallclock_rtc_elapsed_us(uint32_t from, uint32_t to)
+{
+    uint32_t ticks;
+
+    ticks = (to >= from) ? (to - from) : (to + (WALLCLOCK_DAY_S * s_wallclock_tps - from));
+    return (uint32_t)(((uint64_t)ticks * 1000000U) / s_wallclock_tps);
+}
+
+/*!
+    \brief      load the wall clock from the RTC
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Call after timer_monotonic_config. This is the only RTC calendar
+                read on the normal path; wallclock_now runs from the monotonic
+                timer afterwards.
+*/
+void wallclock_init(void)
+{
+    uint32_t primask;
+
+    wallclock_rtc_init();
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    s_wallclock_base_us = wallclock_rtc_read() + (int64_t)(int32_t)WALLCLOCK_RTC_OFFSET;
+    s_wallclock_base_mono = timer_monotonic_us();
+    s_wallclock_freq_ppb = 0;
+    s_wallclock_ref_valid = 0;
+    __set_PRIMASK(primask);
+
+    s_wallclock_stats.references = 0;
+    s_wallclock_stats.last_offset_us = 0;
+    s_wallclock_stats.freq_ppb = 0;
+    s_wallclock_stats.rtc_ppb = 0;
+    s_wallclock_stats.rtc_calibrations = 0;
+    s_wallclock_stats.rtc_factor_s = s_wallclock_tps - 1U;
+    s_wallclock_stats.rtc_hrfc = RTC_HRFC;
+    s_wallclock_stats.timestamps = 0;
+    s_wallclock_stats.timestamp_overflows = 0;
+}
+
+/*!
+    \brief      get the wall clock at a monotonic timestamp
+    \param[in]  mono_us: timer_monotonic_us value less than 17 minutes from now
+    \param[out] none
+    \retval     Unix time in microseconds
+*/
+uint64_t wallclock_at(uint32_t mono_us)
+{
+    int32_t delta;
+
+    delta = (int32_t)(mono_us - s_wallclock_base_mono);
+    return s_wallclock_base_us + (int64_t)delta + ((int64_t)delta * s_wallclock_freq_ppb) / 1000000000;
+}
+
+/*!
+    \brief      get the wall clock
+    \param[in]  none
+    \param[out] none
+    \retval     Unix time in microseconds
+    \note       One timer read and a multiply; the base moves forward every
+                17 minutes so the 32-bit monotonic delta never wraps.
+*/
+uint64_t wallclock_now(void)
+{
+    uint64_t now;
+    uint32_t primask, mono;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    mono = timer_monotonic_us();
+    now = wallclock_at(mono);
+    if((mono - s_wallclock_base_mono) >= WALLCLOCK_REBASE_US)
+    {
+        s_wallclock_base_us = now;
+        s_wallclock_base_mono = mono;
+    }
+    __set_PRIMASK(primask);
+    return now;
+}
+
+/*!
+    \brief      set the wall clock and the RTC
+    \param[in]  unix_us: Unix time in microseconds, years 2000..2099
+    \param[out] none
+    \retval     none
+    \note       The RTC calendar keeps whole seconds; the fraction is kept as the
+                RTC offset in the backup domain. The reference discipline restarts.
+*/
+void wallclock_set(uint64_t unix_us)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    s_wallclock_base_us = unix_us;
+    s_wallclock_base_mono = timer_monotonic_us();
+    s_wallclock_ref_valid = 0;
+    wallclock_rtc_write(unix_us / 1000000U, s_wallclock_tps - 1U);
+    wallclock_rtc_offset_update();
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      convert Unix time to calendar fields
+    \param[in]  unix_us: Unix time in microseconds
+    \param[out] date: calendar date and time
+    \retval     none
+*/
+void wallclock_to_date(uint64_t unix_us, wallclock_date_struct *date)
+{
+    uint32_t days, secs, z, era, doe, yoe, doy, mp;
+
+    days = (uint32_t)(unix_us / (1000000ULL * WALLCLOCK_DAY_S));
+    secs = (uint32_t)((unix_us / 1000000U) % WALLCLOCK_DAY_S);
+    date->microsecond = (uint32_t)(unix_us % 1000000U);
+    date->hour = (uint8_t)(secs / 3600U);
+    date->minute = (uint8_t)((secs / 60U) % 60U);
+    date->second = (uint8_t)(secs % 60U);
+    date->weekday = (uint8_t)(((days + 3U) % 7U) + 1U);                     /* 1970-01-01 was a Thursday */
+
+    z = days + 719468U;
+    era = z / 146097U;
+    doe = z - era * 146097U;
+    yoe = (doe - doe / 1460U + doe / 36524U - doe / 146096U) / 365U;
+    doy = doe - (365U * yoe + yoe / 4U - yoe / 100U);
+    mp = (5U * doy + 2U) / 153U;
+    date->day = (uint8_t)(doy - (153U * mp + 2U) / 5U + 1U);
+    date->month = (uint8_t)((mp < 10U) ? (mp + 3U) : (mp - 9U));
+    date->year = (uint16_t)(yoe + era * 400U + ((date->month <= 2U) ? 1U : 0U));
+}
+
+/*!
+    \brief      convert calendar fields to Unix time
+    \param[in]  date: calendar date and time, weekday ignored
+    \param[out] none
+    \retval     Unix time in microseconds
+*/
+uint64_t wallclock_from_date(const wallclock_date_struct *date)
+{
+    uint64_t secs;
+
+    secs = (uint64_t)wallclock_days(date->year, date->month, date->day) * WALLCLOCK_DAY_S + \
+           ((uint32_t)date->hour * 60U + date->minute) * 60U + date->second;
+    return secs * 1000000U + date->microsecond;
+}
+
+/*!
+    \brief      discipline the wall clock against a reference sample
+    \param[in]  ref_us: reference Unix time, e.g. the second of a PPS edge or a PTP sync
+    \param[in]  mono_us: timer_monotonic_us captured at the reference instant
+    \param[out] none
+    \retval     none
+    \note       The first sample sets the clock. Later samples measure the rate
+                of the monotonic timebase over the sample interval and filter it
+                into the rate correction, then step the phase to the reference.
+                Every WALLCLOCK_CAL_MIN_US the RTC rate is calibrated as well and
+                the RTC offset refreshed, so the RTC restarts the wall clock
+                accurately after a reset.
+*/
+void wallclock_reference(uint64_t ref_us, uint32_t mono_us)
+{
+    int64_t interval_ref, offset;
+    uint32_t interval_mono, primask;
+    int32_t measured;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    interval_ref = (int64_t)(ref_us - s_wallclock_ref_us);
+    interval_mono = mono_us - s_wallclock_ref_mono;
+
+    if(!s_wallclock_ref_valid || (interval_ref <= 0) || (interval_ref > (int64_t)WALLCLOCK_REF_MAX_US) || (interval_mono == 0U))
+    {
+        /* (re)start: take the reference phase, restart the calibration interval */
+        s_wallclock_base_us = ref_us;
+        s_wallclock_base_mono = mono_us;
+        s_wallclock_ref_valid = 1;
+        s_wallclock_cal_us = ref_us;
+        s_wallclock_cal_ticks = wallclock_rtc_ticks();
+        wallclock_rtc_write(wallclock_at(timer_monotonic_us()) / 1000000U, s_wallclock_tps - 1U);
+        wallclock_rtc_offset_update();
+        s_wallclock_stats.last_offset_us = 0;
+    }
+    else
+    {
+        offset = (int64_t)(ref_us - wallclock_at(mono_us));
+        measured = (int32_t)(((interval_ref - (int64_t)interval_mono) * 1000000000) / interval_mono);
+        s_wallclock_freq_ppb += (measured - s_wallclock_freq_ppb) / (1 << WALLCLOCK_FREQ_SHIFT);
+        s_wallclock_base_us = ref_us;
+        s_wallclock_base_mono = mono_us;
+        s_wallclock_stats.last_offset_us = (int32_t)offset;
+
+        if((ref_us - s_wallclock_cal_us) >= WALLCLOCK_CAL_MIN_US)
+        {
+            wallclock_rtc_calibrate(ref_us + (timer_monotonic_us() - mono_us));
+        }
+    }
+    s_wallclock_ref_us = ref_us;
+    s_wallclock_ref_mono = mono_us;
+    s_wallclock_stats.references++;
+    s_wallclock_stats.freq_ppb = s_wallclock_freq_ppb;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      timestamp edges on the RTC_TS pin
+    \param[in]  edge: RTC_TIMESTAMP_RISING_EDGE or RTC_TIMESTAMP_FALLING_EDGE
+    \param[in]  callback: called with the event time from the interrupt, may be NULL
+    \param[in]  arg: callback argument
+    \param[out] none
+    \retval     none
+    \note       The RTC latches calendar and sub second in hardware, so the
+                resolution is one RTC tick whatever the interrupt latency.
+*/
+void wallclock_timestamp_enable(uint32_t edge, wallclock_timestamp_fn callback, void *arg)
+{
+    s_wallclock_ts_callback = callback;
+    s_wallclock_ts_arg = arg;
+    s_wallclock_ts_head = 0;
+    s_wallclock_ts_tail = 0;
+
+    rtc_flag_clear(RTC_FLAG_TS | RTC_FLAG_TSOVR);
+    exti_init(WALLCLOCK_TS_EXTI, EXTI_INTERRUPT, EXTI_TRIG_RISING);
+    exti_interrupt_flag_clear(WALLCLOCK_TS_EXTI);
+    rtc_interrupt_enable(RTC_INT_TIMESTAMP);
+    rtc_timestamp_enable(edge);
+    nvic_irq_enable(TAMPER_STAMP_LXTAL_IRQn, 3, 0);
+}
+
+/*!
+    \brief      stop timestamping
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void wallclock_timestamp_disable(void)
+{
+    rtc_timestamp_disable();
+    rtc_interrupt_disable(RTC_INT_TIMESTAMP);
+    rtc_flag_clear(RTC_FLAG_TS | RTC_FLAG_TSOVR);
+    exti_interrupt_flag_clear(WALLCLOCK_TS_EXTI);
+    s_wallclock_ts_callback = NULL;
+}
+
+/*!
+    \brief      pop the oldest queued timestamp
+    \param[in]  none
+    \param[out] unix_us: event time in Unix microseconds
+    \retval     1 if a timestamp was returned, 0 if the queue is empty
+*/
+uint8_t wallclock_timestamp_get(uint64_t *unix_us)
+{
+    uint32_t tail = s_wallclock_ts_tail;
+
+    if(tail == s_wallclock_ts_head)
+    {
+        return 0;
+    }
+    *unix_us = s_wallclock_ts_queue[tail & (WALLCLOCK_TS_DEPTH - 1U)];
+    s_wallclock_ts_tail = tail + 1U;
+    return 1;
+}
+
+/*!
+    \brief      copy the discipline statistics
+    \param[in]  none
+    \param[out] stats: statistics
+    \retval     none
+*/
+void wallclock_stats_get(wallclock_stats_struct *stats)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = s_wallclock_stats;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief      RTC tamper and timestamp interrupt handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The timestamp registers hold no year; it is taken from the
+                calendar, one year back if the event month is later than now.
+*/
+void TAMPER_STAMP_LXTAL_IRQHandler(void)
+{
+    uint32_t tts, dts, ssts, date, year;
+    uint64_t unix_us;
+
+    if(RESET != rtc_flag_get(RTC_FLAG_TS))
+    {
+        tts = RTC_TTS;
+        dts = RTC_DTS;
+        ssts = RTC_SSTS & RTC_SSTS_SSC;
+        date = RTC_DATE;
+        rtc_flag_clear(RTC_FLAG_TS);
+        if(RESET != rtc_flag_get(RTC_FLAG_TSOVR))
+        {
+            rtc_flag_clear(RTC_FLAG_TSOVR);
+            s_wallclock_stats.timestamp_overflows++;
+        }
+
+        year = date & (RTC_DATE_YRT | RTC_DATE_YRU);
+        if((dts & (RTC_DATE_MONT | RTC_DATE_MONU)) > (date & (RTC_DATE_MONT | RTC_DATE_MONU)))
+        {
+            year = wallclock_bcd(year >> 16) + 99U;
+            year = ((((year % 100U) / 10U) << 20) | ((year % 10U) << 16));
+        }
+        unix_us = wallclock_rtc_unix(year | (dts & (RTC_DATE_MONT | RTC_DATE_MONU | RTC_DATE_DAYT | RTC_DATE_DAYU)), tts, ssts) + \
+                  (int64_t)(int32_t)WALLCLOCK_RTC_OFFSET;
+
+        if((s_wallclock_ts_head - s_wallclock_ts_tail) < WALLCLOCK_TS_DEPTH)
+        {
+            s_wallclock_ts_queue[s_wallclock_ts_head & (WALLCLOCK_TS_DEPTH - 1U)] = unix_us;
+            s_wallclock_ts_head++;
+        }
+        else
+        {
+            s_wallclock_stats.timestamp_overflows++;
+        }
+        s_wallclock_stats.timestamps++;
+        if(s_wallclock_ts_callback != NULL)
+        {
+            s_wallclock_ts_callback(unix_us, s_wallclock_ts_arg);
+        }
+    }
+    exti_interrupt_flag_clear(WALLCLOCK_TS_EXTI);
+}
@@ -0,0 +1,83 @@
+/*!
+    \file       wallclock.h
+    \brief      header file for RTC-backed wall clock service
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Unix time in microseconds from the RTC fused with the monotonic timebase
+    - Calendar conversion between Unix time and date/time fields
+    - Reference (PPS or PTP) discipline of frequency, phase and RTC calibration
+    - Event timestamps from the RTC timestamp unit
+    - Shared RTC start-up and tick reading used by the idle manager
+*/
+
+#ifndef __WALLCLOCK_H
+#define __WALLCLOCK_H
+#include <stdint.h>
+#include <stddef.h>
+#include "gd32h7xx_libopt.h"
+
+/*!
+    \brief wall clock configuration macros
+*/
+#define WALLCLOCK_RTC_HZ            32000U                                  /*!< IRC32K nominal frequency, RTC clock when started here */
+#define WALLCLOCK_TS_EXTI           EXTI_18                                 /*!< EXTI line of the RTC tamper and timestamp event */
+#define WALLCLOCK_TS_DEPTH          8U                                      /*!< queued timestamps, power of two */
+#define WALLCLOCK_CAL_MIN_US        64000000U                               /*!< shortest RTC calibration interval, two 32 s windows */
+#define WALLCLOCK_REF_MAX_US        3600000000U                             /*!< longer reference gaps restart the discipline */
+#define WALLCLOCK_FREQ_SHIFT        3U                                      /*!< frequency filter weight 1/8 */
+#define WALLCLOCK_RTC_OFFSET        RTC_BKP3                                /*!< wall clock minus RTC time in us, kept across reset */
+
+/*!
+    \brief calendar date and time
+*/
+typedef struct
+{
+    uint16_t year;                                                          /*!< 2000..2099 */
+    uint8_t month;                                                          /*!< 1..12 */
+    uint8_t day;                                                            /*!< 1..31 */
+    uint8_t weekday;                                                        /*!< 1 = Monday .. 7 = Sunday */
+    uint8_t hour;                                                           /*!< 0..23 */
+    uint8_t minute;                                                         /*!< 0..59 */
+    uint8_t second;                                                         /*!< 0..59 */
+    uint32_t microsecond;                                                   /*!< 0..999999 */
+} wallclock_date_struct;
+
+/*! timestamp callback, called from the RTC timestamp interrupt */
+typedef void (*wallclock_timestamp_fn)(uint64_t unix_us, void *arg);
+
+/*!
+    \brief wall clock discipline statistics
+*/
+typedef struct
+{
+    uint32_t references;                                                    /*!< reference samples accepted */
+    int32_t last_offset_us;                                                 /*!< reference minus wall clock at the last sample */
+    int32_t freq_ppb;                                                       /*!< monotonic timebase rate correction */
+    int32_t rtc_ppb;                                                        /*!< RTC error measured at the last calibration */
+    uint32_t rtc_calibrations;                                              /*!< RTC calibrations applied */
+    uint32_t rtc_factor_s;                                                  /*!< RTC synchronous prescaler in use */
+    uint32_t rtc_hrfc;                                                      /*!< RTC_HRFC smooth calibration in use */
+    uint32_t timestamps;                                                    /*!< timestamp events captured */
+    uint32_t timestamp_overflows;                                           /*!< events lost in the RTC or the queue */
+} wallclock_stats_struct;
+
+/* function declarations */
+void wallclock_rtc_init(void);                                                          /*!< start the RTC if stopped, bypass shadows */
+uint32_t wallclock_rtc_hz(void);                                                        /*!< RTC clock frequency from the prescalers */
+uint32_t wallclock_rtc_ticks(void);                                                     /*!< RTC ticks since midnight */
+uint32_t wallclock_rtc_elapsed_us(uint32_t from, uint32_t to);                          /*!< microseconds between two tick readings */
+void wallclock_init(void);                                                              /*!< load the wall clock from the RTC */
+uint64_t wallclock_now(void);                                                           /*!< Unix time in microseconds */
+uint64_t wallclock_at(uint32_t mono_us);                                                /*!< Unix time at a monotonic timestamp */
+void wallclock_set(uint64_t unix_us);                                                   /*!< set wall clock and RTC */
+void wallclock_to_date(uint64_t unix_us, wallclock_date_struct *date);                  /*!< Unix time to calendar */
+uint64_t wallclock_from_date(const wallclock_date_struct *date);                        /*!< calendar to Unix time */
+void wallclock_reference(uint64_t ref_us, uint32_t mono_us);                            /*!< discipline against a reference sample */
+void wallclock_timestamp_enable(uint32_t edge, wallclock_timestamp_fn callback, void *arg); /*!< timestamp RTC_TS edges */
+void wallclock_timestamp_disable(void);                                                 /*!< stop timestamping */
+uint8_t wallclock_timestamp_get(uint64_t *unix_us);                                     /*!< pop the oldest timestamp */
+void wallclock_stats_get(wallclock_stats_struct *stats);                                /*!< copy discipline statistics */
+#endif /* __WALLCLOCK_H */
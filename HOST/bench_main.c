@@ -0,0 +1,30 @@
+/*!
+    \file       bench_main.c
+    \brief      host runner of the BSP/BENCH cases
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Running the benchmark cases that build without device headers on Linux,
+      timed with clock_gettime, to smoke-test the harness and the cases
+
+    Usage:
+    - make -C HOST bench
+    - HOST/build/bspbench [filter] > run.log; python TOOLS/bench_diff.py base.log run.log
+*/
+
+#include <stdio.h>
+#include "./BENCH/bench.h"
+
+/*!
+    \brief      main function
+    \param[in]  argc: argument count
+    \param[in]  argv: optional case name filter
+    \param[out] none
+    \retval     0 if at least one case ran
+*/
+int main(int argc, char *argv[])
+{
+    return (bench_run_all((argc > 1) ? argv[1] : NULL) > 0U) ? 0 : 1;
+}
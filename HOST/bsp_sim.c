@@ -0,0 +1,1203 @@
+/*!
+    \file       bsp_sim.c
+    \brief      selftests of the BSP on the host peripheral models
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Deep-sleep reachable once dvfs_init ran, as in the boot order of both
+      build types
+    - USART0 DMA reception closed by the idle line and the TIMER5 timeout,
+      with the idle constraint that keeps reception out of deep-sleep
+    - Terminal transmission by DMA through USART1
+    - Slice-by-8 software CRC against its check values and a bitwise CRC
+    - CRC unit (CPU and DMA feeding) against the slice-by-8 software CRC
+    - HWSEM locks: recursion refused, a thread's lock refused in an ISR, and
+      the CRC unit released by its DMA interrupt waking lock_wait
+    - SHA-256 and HMAC-SHA-256 sessions against FIPS 180-4 and RFC 4231 vectors
+    - AES-GCM packets (CPU and DMA payload, queued) against the NIST GCM vectors
+    - AES streaming: DMA only for cache-line aligned output in whole lines,
+      and aes_final ending the session on every return
+    - CTR-DRBG known-answer test on the CAU model, CPU and DMA feeding
+    - Clock tree of BSP/CLOCK against rcu_clock_freq_get, integer and
+      fractional PLLs, every clock source and the timer multiplier rule
+    - Thermal governor law: band edges, hysteresis, threshold windows, LPDTS
+      calibration both ways and the law closed around the thermal model
+    - Sensor hub scheduler: batching by slack, phase kept early and late,
+      missed periods, and the exact read rate in the bus simulation
+    - TIMER1 microsecond timebase, its alarm and SysTick delay_us against
+      virtual time
+    - DVFS notifier check: operating points the USART divider or the
+      microsecond timebase cannot follow are refused before any clock change
+    - Flash sector erase, word program and the locked controller
+    - Pin tables merged by PINCFG against the per-pin firmware library calls,
+      and the board table built from the driver pin macros
+
+    Usage:
+    - make -C HOST check
+    - HOST/build/bspsim --selftest
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "gd32h7xx_libopt.h"
+#include "./USART/usart.h"
+#include "./TIMER/timer.h"
+#include "./DELAY/delay.h"
+#include "./CRC/crc.h"
+#include "./CRC/crc_sw.h"
+#include "./LOCK/lock.h"
+#include "./HASH/hash.h"
+#include "./AES/aes.h"
+#include "./RNG/rng.h"
+#include "./PINCFG/pincfg.h"
+#include "./I2C/i2c.h"
+#include "./DVFS/dvfs.h"
+#include "./IDLE/idle.h"
+#include "./CLOCK/clock.h"
+#include "./THERMAL/thermal_law.h"
+#include "./SENSORHUB/sensorhub_sched.h"
+#include "sim.h"
+
+#define BSP_SIM_FLASH_SECTOR        0x08010000U                             /* sector used by the flash test */
+#define BSP_SIM_GPIO_FILL           0xA5A5A5A5U                             /* register content the pin tables must keep */
+
+/* pins on three ports, AFSEL0 and AFSEL1, every mode, pull, driver and speed */
+#define BSP_SIM_PINS(PIN, x) \
+    PIN(x, GPIOA,  9U, GPIO_MODE_AF,     GPIO_PUPD_PULLUP,   GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ,      GPIO_AF_7) \
+    PIN(x, GPIOA, 10U, GPIO_MODE_AF,     GPIO_PUPD_PULLUP,   GPIO_OTYPE_OD, GPIO_OSPEED_60MHZ,      GPIO_AF_7) \
+    PIN(x, GPIOA,  0U, GPIO_MODE_ANALOG, GPIO_PUPD_NONE,     GPIO_OTYPE_PP, GPIO_OSPEED_12MHZ,      GPIO_AF_0) \
+    PIN(x, GPIOB,  5U, GPIO_MODE_AF,     GPIO_PUPD_NONE,     GPIO_OTYPE_PP, GPIO_OSPEED_100_220MHZ, GPIO_AF_14) \
+    PIN(x, GPIOB, 15U, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLDOWN, GPIO_OTYPE_PP, GPIO_OSPEED_85MHZ,      GPIO_AF_0) \
+    PIN(x, GPIOK,  3U, GPIO_MODE_INPUT,  GPIO_PUPD_PULLUP,   GPIO_OTYPE_PP, GPIO_OSPEED_12MHZ,      GPIO_AF_0)
+#define BSP_SIM_PINS_TWICE(PIN, x) \
+    PIN(x, GPIOC,  1U, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE,     GPIO_OTYPE_PP, GPIO_OSPEED_12MHZ,      GPIO_AF_0) \
+    PIN(x, GPIOC,  1U, GPIO_MODE_INPUT,  GPIO_PUPD_NONE,     GPIO_OTYPE_PP, GPIO_OSPEED_12MHZ,      GPIO_AF_0)
+#define BSP_SIM_PINS_NO_PORT(PIN, x) \
+    PIN(x, GPIO_BASE + 0x2000U, 1U, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, GPIO_OTYPE_PP, GPIO_OSPEED_12MHZ, GPIO_AF_0)
+#define BSP_SIM_PINS_RANGE(PIN, x) \
+    PIN(x, GPIOC, 16U, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE,     GPIO_OTYPE_PP, GPIO_OSPEED_12MHZ,      GPIO_AF_0)
+/* per-pin configuration as the drivers do it */
+#define BSP_SIM_PIN_CALLS(x, port, pin, mode, pull, otype, speed, af) \
+    if((mode) == GPIO_MODE_AF) { gpio_af_set(port, af, BIT(pin)); } \
+    gpio_mode_set(port, mode, pull, BIT(pin)); \
+    gpio_output_options_set(port, otype, speed, BIT(pin));
+
+/* RCU_PLLx and RCU_PLLADDCTL fields from divider values */
+#define BSP_SIM_PLL(psc, n, p, r)   ((psc) | (((n) - 1U) << 6) | (((p) - 1U) << 16) | (((r) - 1U) << 24))
+#define BSP_SIM_PLLQ(q0, q1, q2)    (((q0) - 1U) | (((q1) - 1U) << 8) | (((q2) - 1U) << 16))
+#define BSP_SIM_PLL_ALL_EN          0xFF800000U                             /* P, Q and R outputs of PLL0..2 */
+
+/*!
+    \brief RCU registers of one clock tree case, in clock_regs_struct order
+*/
+typedef struct
+{
+    const char *name;
+    uint32_t cfg0, cfg1, addctl1, pllall;
+    uint32_t pll[3], pllfra[3], plladdctl;
+} bsp_sim_clock_case_struct;
+
+static const bsp_sim_clock_case_struct s_bsp_sim_clock_cases[] =
+{
+    {"irc64mdiv, plls unconfigured", RCU_CKSYSSRC_IRC64MDIV, RCU_PERSRC_IRC64MDIV, RCU_IRC64M_DIV1, RCU_PLLSRC_HXTAL,
+     {0U, 0U, 0U}, {0U, 0U, 0U}, BSP_SIM_PLL_ALL_EN},
+    {"pll0p 600 mhz from hxtal", RCU_CKSYSSRC_PLL0P | RCU_AHB_CKSYS_DIV2 | RCU_APB1_CKAHB_DIV2 | RCU_APB2_CKAHB_DIV2 |
+     RCU_APB3_CKAHB_DIV2 | RCU_APB4_CKAHB_DIV2, RCU_PERSRC_HXTAL | (RCU_USARTSRC_AHB << 18) | (RCU_USARTSRC_LXTAL << 20) |
+     (RCU_USARTSRC_IRC64MDIV << 22), RCU_IRC64M_DIV1, RCU_PLLSRC_HXTAL,
+     {BSP_SIM_PLL(5U, 120U, 1U, 2U), BSP_SIM_PLL(5U, 52U, 2U, 2U), BSP_SIM_PLL(25U, 200U, 2U, 4U)}, {0U, 0U, 0U},
+     BSP_SIM_PLL_ALL_EN | BSP_SIM_PLLQ(4U, 1U, 8U)},
+    {"fractional plls from irc64mdiv", RCU_CKSYSSRC_PLL0P | RCU_APB1_CKAHB_DIV8 | RCU_APB2_CKAHB_DIV16,
+     RCU_PERSRC_IRC64MDIV | RCU_TIMER_PSC_MUL4 | RCU_USARTSRC_IRC64MDIV, RCU_IRC64M_DIV2, RCU_PLLSRC_IRC64MDIV,
+     {BSP_SIM_PLL(4U, 60U, 2U, 4U), BSP_SIM_PLL(4U, 60U, 2U, 4U), BSP_SIM_PLL(8U, 99U, 3U, 5U)},
+     {RCU_PLL0FRA_PLL0FRAEN | 1U, RCU_PLL1FRA_PLL1FRAEN | 4096U, RCU_PLL2FRA_PLL2FRAEN | 8191U}, BSP_SIM_PLL_ALL_EN | BSP_SIM_PLLQ(3U, 6U, 7U)},
+    {"lpirc4m, q outputs off", RCU_CKSYSSRC_LPIRC4M | RCU_AHB_CKSYS_DIV4, RCU_PERSRC_LPIRC4M | RCU_USARTSRC_LXTAL,
+     RCU_IRC64M_DIV8, RCU_PLLSRC_LPIRC4M,
+     {BSP_SIM_PLL(1U, 100U, 2U, 2U), BSP_SIM_PLL(2U, 150U, 1U, 3U), BSP_SIM_PLL(1U, 50U, 2U, 1U)}, {0U, 0U, 0U},
+     RCU_PLLADDCTL_PLL0PEN | RCU_PLLADDCTL_PLL0REN | RCU_PLLADDCTL_PLL1PEN | RCU_PLLADDCTL_PLL2REN},
+};
+
+typedef char bsp_sim_pins_check[PINCFG_VALID(BSP_SIM_PINS) ? 1 : -1];
+static const pincfg_port_struct s_bsp_sim_pins[PINCFG_PORT_NUM] = {PINCFG_PORTS(BSP_SIM_PINS)};
+static const pincfg_port_struct s_bsp_sim_board[PINCFG_PORT_NUM] = {PINCFG_PORTS(PINCFG_BOARD_TABLE)};
+
+static uint32_t s_bsp_sim_failed = 0;
+static uint8_t s_bsp_sim_crc_buff[3000];                                    /* static: DMA addresses are 32-bit */
+static volatile uint8_t s_bsp_sim_lock_isr = 0;                             /* 1 if the DMA callback was refused LOCK_SEM_USER */
+
+/*!
+    \brief      print one check result
+    \param[in]  name: check name
+    \param[in]  ok: 1 if passed
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_check(const char *name, uint8_t ok)
+{
+    printf("%s %s\n", ok ? "PASS" : "FAIL", name);
+    if(!ok)
+    {
+        s_bsp_sim_failed++;
+    }
+}
+
+/*!
+    \brief      idle: deep-sleep is selected once dvfs_init knows the boot operating point
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Runs first: usart_init keeps the core out of deep-sleep from
+                bsp_sim_usart_rx on. idle_init is left out, the RTC is not
+                modelled.
+*/
+static void bsp_sim_idle(void)
+{
+    uint8_t unknown;
+
+    unknown = idle_select(IDLE_LOWPOWER_MAX_US);
+    dvfs_init();
+    bsp_sim_check("idle deep-sleep needs the boot operating point", (unknown == IDLE_STATE_SLEEP) &&
+                  (dvfs_opp_get() == DVFS_OPP_600M));
+    bsp_sim_check("idle deep-sleep reachable after dvfs_init",
+                  (idle_select(IDLE_LOWPOWER_MAX_US) == IDLE_STATE_DEEPSLEEP) &&
+                  (idle_select(g_idle_state_table[IDLE_STATE_DEEPSLEEP].min_residency_us - 1U) == IDLE_STATE_SLEEP));
+}
+
+/*!
+    \brief      USART0: bytes on the line end up in g_bsp_usart_recv_buff
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_usart_rx(void)
+{
+    static const char frame[] = "AT+SIM=1\r\n";
+    uint64_t start;
+    uint32_t limit;
+
+    limit = idle_latency_limit();
+    usart_init(115200U);
+    usart_init(115200U);                                                    /* again: the idle constraint is listed once */
+    bsp_sim_check("usart0 reception keeps the core out of deep-sleep", (limit == IDLE_FOREVER) &&
+                  (idle_latency_limit() == 0U) && (idle_select(IDLE_LOWPOWER_MAX_US) == IDLE_STATE_SLEEP));
+    g_bsp_usart_recv_complete_flag = 0;
+    start = sim_time_us();
+    sim_usart_inject(USART0, frame, sizeof(frame) - 1U);
+    sim_run_until(&g_bsp_usart_recv_complete_flag, 100000U);
+    bsp_sim_check("usart0 dma rx complete", g_bsp_usart_recv_complete_flag == 1U);
+    bsp_sim_check("usart0 dma rx data", (g_bsp_usart_recv_length == sizeof(frame) - 1U) &&
+                  (0 == memcmp(g_bsp_usart_recv_buff, frame, sizeof(frame) - 1U)));
+    /* 10 frames at 115200 baud, one idle frame, then TIMER5: 301 * 1001 / 64 MHz */
+    printf("     rx to complete flag: %llu us\n", (unsigned long long)(sim_time_us() - start));
+
+    usart_rx_dma_receive_reset();
+    g_bsp_usart_recv_complete_flag = 0;
+    sim_usart_inject(USART0, "OK", 2U);
+    sim_run_until(&g_bsp_usart_recv_complete_flag, 100000U);
+    bsp_sim_check("usart0 dma rx after reset", (g_bsp_usart_recv_length == 2U) && (0 == memcmp(g_bsp_usart_recv_buff, "OK", 2U)));
+}
+
+/*!
+    \brief      USART1: usart_terminal_print_fmt reaches the line
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_usart_tx(void)
+{
+    char line[64];
+    uint32_t n;
+
+    usart_terminal_init(115200U);
+    usart_terminal_print_fmt("bspsim %d\r\n", 42);
+    sim_run_us(2000U);
+    n = sim_usart_capture(USART1, line, sizeof(line) - 1U);
+    line[n] = '\0';
+    bsp_sim_check("usart1 dma tx", 0 == strcmp(line, "bspsim 42\r\n"));
+
+    usart_terminal_print_fmt("%s", "second\n");
+    sim_run_us(2000U);
+    n = sim_usart_capture(USART1, line, sizeof(line) - 1U);
+    line[n] = '\0';
+    bsp_sim_check("usart1 dma tx back to back", 0 == strcmp(line, "second\n"));
+}
+
+/*!
+    \brief      bit-at-a-time CRC of the Rocksoft model
+    \param[in]  preset: CRC description
+    \param[in]  data: input bytes
+    \param[in]  length: number of bytes
+    \param[out] none
+    \retval     CRC value
+*/
+static uint32_t bsp_sim_crc_bitwise(const crc_preset_struct *preset, const uint8_t *data, uint32_t length)
+{
+    uint32_t top = 1UL << (preset->width - 1U);
+    uint32_t mask = top | (top - 1U);
+    uint32_t reg = preset->init & mask;
+    uint32_t i, b;
+    uint8_t byte;
+
+    for(i = 0U; i < length; i++)
+    {
+        byte = preset->reflect ? (uint8_t)crc_sw_reflect(data[i], 8U) : data[i];
+        for(b = 0U; b < 8U; b++)
+        {
+            reg = ((reg & top) ^ ((byte & (0x80U >> b)) ? top : 0U)) ? ((reg << 1) ^ preset->poly) : (reg << 1);
+            reg &= mask;
+        }
+    }
+    reg = preset->reflect ? crc_sw_reflect(reg, preset->width) : reg;
+    return (reg ^ preset->xorout) & mask;
+}
+
+/*!
+    \brief      slice-by-8 software CRC: check values, bitwise reference, split updates
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_crc_sw(void)
+{
+    static const crc_preset_struct *const presets[4] = {&g_crc_preset_crc32, &g_crc_preset_crc32c,
+                                                        &g_crc_preset_crc16_ccitt, &g_crc_preset_crc8};
+    static const uint32_t checks[4] = {0xCBF43926U, 0xE3069283U, 0x29B1U, 0xF4U};
+    static crc_sw_table_struct table;
+    uint8_t data[80];
+    char name[48];
+    uint32_t i, length, start, split, reg;
+    uint8_t ok;
+
+    for(i = 0U; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i * 37U + 11U);
+    }
+    for(i = 0U; i < 4U; i++)
+    {
+        crc_sw_table_init(&table, presets[i]);
+        reg = crc_sw_update(&table, crc_sw_start(&table), (const uint8_t *)"123456789", 9U);
+        snprintf(name, sizeof(name), "crc_sw preset %u check value", (unsigned)i);
+        bsp_sim_check(name, (crc_sw_final(&table, reg) == checks[i]) && (presets[i]->check == checks[i]));
+
+        /* every length and start alignment around the 8-byte step, whole and split in two */
+        ok = 1U;
+        for(start = 0U; start < 8U; start++)
+        {
+            for(length = 0U; length + start <= sizeof(data); length++)
+            {
+                split = length / 3U;
+                reg = crc_sw_update(&table, crc_sw_start(&table), data + start, split);
+                reg = crc_sw_update(&table, reg, data + start + split, length - split);
+                ok = ok && (crc_sw_final(&table, reg) == bsp_sim_crc_bitwise(presets[i], data + start, length));
+            }
+        }
+        snprintf(name, sizeof(name), "crc_sw preset %u against bitwise", (unsigned)i);
+        bsp_sim_check(name, ok);
+    }
+    bsp_sim_check("crc_sw reflect", (crc_sw_reflect(0x1U, 8U) == 0x80U) && (crc_sw_reflect(0x1021U, 16U) == 0x8408U) &&
+                  (crc_sw_reflect(0x04C11DB7U, 32U) == 0xEDB88320U));
+}
+
+/*!
+    \brief      CRC unit against the software CRC
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_crc(void)
+{
+    static const crc_preset_struct *const presets[4] = {&g_crc_preset_crc32, &g_crc_preset_crc32c,
+                                                        &g_crc_preset_crc16_ccitt, &g_crc_preset_crc8};
+    static const uint32_t lengths[3] = {9U, 201U, sizeof(s_bsp_sim_crc_buff)};   /* CPU, CPU, DMA */
+    char name[48];
+    crc_context_struct ctx;
+    uint32_t hw, sw, i, j;
+
+    for(i = 0U; i < sizeof(s_bsp_sim_crc_buff); i++)
+    {
+        s_bsp_sim_crc_buff[i] = (uint8_t)(i * 7U + 3U);
+    }
+    memcpy(s_bsp_sim_crc_buff, "123456789", 9U);
+    crc_engine_init();
+
+    crc_start(&ctx, &g_crc_preset_crc32, CRC_BACKEND_HW);
+    crc_update(&ctx, s_bsp_sim_crc_buff, 9U, NULL, NULL);
+    crc_final(&ctx, &hw);
+    bsp_sim_check("crc32 check value", hw == 0xCBF43926U);
+
+    for(i = 0U; i < 4U; i++)
+    {
+        for(j = 0U; j < 3U; j++)
+        {
+            crc_start(&ctx, presets[i], CRC_BACKEND_HW);
+            crc_update(&ctx, s_bsp_sim_crc_buff + 1, lengths[j] - 1U, NULL, NULL);   /* unaligned start */
+            crc_final(&ctx, &hw);
+            crc_start(&ctx, presets[i], CRC_BACKEND_SW);
+            crc_update(&ctx, s_bsp_sim_crc_buff + 1, lengths[j] - 1U, NULL, NULL);
+            crc_final(&ctx, &sw);
+            snprintf(name, sizeof(name), "crc preset %u, %u bytes, hw 0x%08X", (unsigned)i,
+                     (unsigned)(lengths[j] - 1U), (unsigned)hw);
+            bsp_sim_check(name, hw == sw);
+        }
+    }
+}
+
+/*!
+    \brief      CRC DMA completion, tries the lock the thread holds
+    \param[in]  ctx: CRC session
+    \param[in]  arg: unused
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_lock_callback(crc_context_struct *ctx, void *arg)
+{
+    (void)ctx;
+    (void)arg;
+    s_bsp_sim_lock_isr = (ERROR == lock_try(LOCK_SEM_USER)) ? 1U : 0U;
+}
+
+/*!
+    \brief      HWSEM lock semantics across thread mode and an interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The CRC DMA interrupt is the ISR: its callback tries the lock
+                the thread holds, and the handler releases LOCK_SEM_CRC, taken
+                by crc_update in thread mode.
+*/
+static void bsp_sim_lock(void)
+{
+    lock_stats_struct user[2], unit[2];
+    crc_context_struct ctx, other;
+    uint32_t crc;
+    uint8_t ok;
+
+    lock_stats_get(LOCK_SEM_USER, &user[0]);
+    lock_stats_get(LOCK_SEM_CRC, &unit[0]);
+    ok = (SUCCESS == lock_try(LOCK_SEM_USER)) && (ERROR == lock_try(LOCK_SEM_USER));
+    lock_stats_get(LOCK_SEM_USER, &user[1]);
+    bsp_sim_check("lock try by the holder is refused as recursion",
+                  ok && (user[1].acquired == user[0].acquired + 1U) && (user[1].recursion == user[0].recursion + 1U));
+
+    s_bsp_sim_lock_isr = 0U;
+    crc_start(&ctx, &g_crc_preset_crc32, CRC_BACKEND_HW);
+    crc_start(&other, &g_crc_preset_crc32, CRC_BACKEND_HW);
+    ok = (SUCCESS == crc_update(&ctx, s_bsp_sim_crc_buff, sizeof(s_bsp_sim_crc_buff), bsp_sim_lock_callback, NULL)) &&
+         (ctx.state == CRC_STATE_BUSY);
+    ok = ok && (ERROR == crc_update(&other, s_bsp_sim_crc_buff, 9U, NULL, NULL));
+    ok = ok && (SUCCESS == lock_wait(LOCK_SEM_CRC, LOCK_FOREVER)) && (ctx.state == CRC_STATE_READY);
+    lock_release(LOCK_SEM_CRC);
+    lock_stats_get(LOCK_SEM_USER, &user[1]);
+    lock_stats_get(LOCK_SEM_CRC, &unit[1]);
+    bsp_sim_check("lock held in thread mode is refused in an isr",
+                  (s_bsp_sim_lock_isr == 1U) && (user[1].failed == user[0].failed + 1U));
+    bsp_sim_check("lock released by the dma isr wakes lock_wait",
+                  ok && (unit[1].contended == unit[0].contended + 1U) && (SUCCESS == crc_final(&ctx, &crc)));
+
+    lock_release(LOCK_SEM_USER);
+    ok = (SUCCESS == lock_try(LOCK_SEM_USER));
+    lock_release(LOCK_SEM_USER);
+    crc_final(&other, &crc);
+    bsp_sim_check("lock free again after release", ok);
+}
+
+/*!
+    \brief      compare bytes with a hex string
+    \param[in]  data: bytes
+    \param[in]  hex: expected value, two lowercase digits per byte
+    \param[out] none
+    \retval     1 if equal
+*/
+static uint8_t bsp_sim_hex_equal(const uint8_t *data, const char *hex)
+{
+    char digits[3];
+    uint32_t i;
+
+    for(i = 0U; hex[2U * i] != '\0'; i++)
+    {
+        snprintf(digits, sizeof(digits), "%02x", data[i]);
+        if(0 != memcmp(digits, &hex[2U * i], 2U))
+        {
+            return 0U;
+        }
+    }
+    return 1U;
+}
+
+/*!
+    \brief      convert a hex string to bytes
+    \param[in]  hex: two digits per byte
+    \param[out] data: bytes
+    \retval     number of bytes
+*/
+static uint32_t bsp_sim_hex_get(const char *hex, uint8_t *data)
+{
+    uint32_t i;
+    unsigned int byte;
+
+    for(i = 0U; (hex[2U * i] != '\0') && (1 == sscanf(&hex[2U * i], "%2x", &byte)); i++)
+    {
+        data[i] = (uint8_t)byte;
+    }
+    return i;
+}
+
+/*!
+    \brief      hash one message in pieces of at most split bytes
+    \param[in]  key: HMAC key, NULL for plain SHA-256
+    \param[in]  key_length: key length
+    \param[in]  data: message
+    \param[in]  length: message length
+    \param[in]  split: piece size
+    \param[out] digest: 32-byte result
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+static ErrStatus bsp_sim_hash_run(const uint8_t *key, uint32_t key_length, const uint8_t *data, uint32_t length,
+                                  uint32_t split, uint8_t digest[SHA256_DIGEST_SIZE])
+{
+    hash_context_struct ctx;
+    uint32_t take;
+
+    if(ERROR == ((key == NULL) ? hash_sha256_init(&ctx, HASH_BACKEND_SW) :
+                                 hash_hmac_sha256_init(&ctx, HASH_BACKEND_SW, key, key_length)))
+    {
+        return ERROR;
+    }
+    while(length > 0U)
+    {
+        take = (length > split) ? split : length;
+        if(ERROR == hash_update(&ctx, data, take, NULL, NULL))
+        {
+            return ERROR;
+        }
+        data += take;
+        length -= take;
+    }
+    return hash_final(&ctx, digest);
+}
+
+/*!
+    \brief      SHA-256 and HMAC-SHA-256, whole and split messages
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The host has no HAU model, sessions run on the software
+                backend; the session, split and HMAC code is shared with HAU.
+*/
+static void bsp_sim_hash(void)
+{
+    static const char abc56[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    static const char jefe[] = "what do ya want for nothing?";
+    static const char large_key[] = "Test Using Larger Than Block-Size Key - Hash Key First";
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    uint8_t key[131];
+    ErrStatus ret;
+
+    ret = bsp_sim_hash_run(NULL, 0U, (const uint8_t *)"abc", 3U, 3U, digest);
+    bsp_sim_check("sha256 abc", (ret == SUCCESS) &&
+                  bsp_sim_hex_equal(digest, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+    ret = bsp_sim_hash_run(NULL, 0U, (const uint8_t *)abc56, 56U, 5U, digest);
+    bsp_sim_check("sha256 448 bits, split by 5", (ret == SUCCESS) &&
+                  bsp_sim_hex_equal(digest, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+    memset(s_bsp_sim_crc_buff, 'a', sizeof(s_bsp_sim_crc_buff));
+    {
+        hash_context_struct ctx;
+        uint32_t i;
+
+        hash_sha256_init(&ctx, HASH_BACKEND_SW);
+        for(i = 0U; i < 1000U; i++)
+        {
+            hash_update(&ctx, s_bsp_sim_crc_buff, (i & 1U) ? 997U : 1003U, NULL, NULL);
+        }
+        ret = hash_final(&ctx, digest);
+    }
+    bsp_sim_check("sha256 one million a, split", (ret == SUCCESS) &&
+                  bsp_sim_hex_equal(digest, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+
+    memset(key, 0x0B, 20U);
+    ret = bsp_sim_hash_run(key, 20U, (const uint8_t *)"Hi There", 8U, 8U, digest);
+    bsp_sim_check("hmac rfc 4231 case 1", (ret == SUCCESS) &&
+                  bsp_sim_hex_equal(digest, "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7"));
+    ret = bsp_sim_hash_run((const uint8_t *)"Jefe", 4U, (const uint8_t *)jefe, 28U, 1U, digest);
+    bsp_sim_check("hmac rfc 4231 case 2, byte by byte", (ret == SUCCESS) &&
+                  bsp_sim_hex_equal(digest, "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+    memset(key, 0xAA, sizeof(key));
+    ret = bsp_sim_hash_run(key, sizeof(key), (const uint8_t *)large_key, 54U, 7U, digest);
+    bsp_sim_check("hmac rfc 4231 case 6, 131-byte key", (ret == SUCCESS) &&
+                  bsp_sim_hex_equal(digest, "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54"));
+}
+
+/*!
+    \brief      AES-GCM encryption, decryption and tag check on the CAU model
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Test cases 1-4, 8 and 13-16 of the GCM specification: 128, 192 and
+                256-bit keys, empty and partial last blocks, a 64-byte payload that
+                goes through DMA, and two packets queued back to back.
+*/
+static void bsp_sim_gcm(void)
+{
+#define BSP_SIM_GCM_K128    "feffe9928665731c6d6a8f9467308308"
+#define BSP_SIM_GCM_IV      "cafebabefacedbaddecaf888"
+#define BSP_SIM_GCM_AAD     "feedfacedeadbeeffeedfacedeadbeefabaddad2"
+#define BSP_SIM_GCM_P60     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72" \
+                            "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"
+#define BSP_SIM_GCM_Z96     "000000000000000000000000"
+#define BSP_SIM_GCM_Z128    "00000000000000000000000000000000"
+    static const struct
+    {
+        const char *name;
+        const char *key;
+        const char *iv;
+        const char *aad;
+        const char *plain;
+        const char *cipher;
+        const char *tag;
+    } vectors[] =
+    {
+        {"1", BSP_SIM_GCM_Z128, BSP_SIM_GCM_Z96, "", "", "", "58e2fccefa7e3061367f1d57a4e7455a"},
+        {"2", BSP_SIM_GCM_Z128, BSP_SIM_GCM_Z96, "", BSP_SIM_GCM_Z128, "0388dace60b6a392f328c2b971b2fe78",
+         "ab6e47d42cec13bdf53a67b21257bddf"},
+        {"3", BSP_SIM_GCM_K128, BSP_SIM_GCM_IV, "", BSP_SIM_GCM_P60 "1aafd255",
+         "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+         "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985", "4d5c2af327cd64a62cf35abd2ba6fab4"},
+        {"4", BSP_SIM_GCM_K128, BSP_SIM_GCM_IV, BSP_SIM_GCM_AAD, BSP_SIM_GCM_P60,
+         "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+         "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091", "5bc94fbc3221a5db94fae95ae7121a47"},
+        {"8", BSP_SIM_GCM_Z128 "0000000000000000", BSP_SIM_GCM_Z96, "", BSP_SIM_GCM_Z128,
+         "98e7247c07f0fe411c267e4384b0f600", "2ff58d80033927ab8ef4d4587514f0fb"},
+        {"13", BSP_SIM_GCM_Z128 BSP_SIM_GCM_Z128, BSP_SIM_GCM_Z96, "", "", "", "530f8afbc74536b9a963b4f1c4cb738b"},
+        {"14", BSP_SIM_GCM_Z128 BSP_SIM_GCM_Z128, BSP_SIM_GCM_Z96, "", BSP_SIM_GCM_Z128,
+         "cea7403d4d606b6e074ec5d3baf39d18", "d0d1c8a799996bf0265b98b5d48ab919"},
+        {"15", BSP_SIM_GCM_K128 BSP_SIM_GCM_K128, BSP_SIM_GCM_IV, "", BSP_SIM_GCM_P60 "1aafd255",
+         "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+         "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662898015ad", "b094dac5d93471bdec1a502270e3cc6c"},
+        {"16", BSP_SIM_GCM_K128 BSP_SIM_GCM_K128, BSP_SIM_GCM_IV, BSP_SIM_GCM_AAD, BSP_SIM_GCM_P60,
+         "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+         "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662", "76fc6ece0f4e1768cddf8853bb2d551b"},
+    };
+    /* static: DMA addresses are 32-bit */
+    __ALIGNED(32) static uint32_t plain[16], cipher[16], out[2][16];
+    static aes_gcm_packet_struct pkts[2];
+    uint8_t key[32], iv[AES_GCM_IV_SIZE], aad[20], tag[AES_GCM_TAG_SIZE];
+    aes_gcm_key_struct gcm_key;
+    uint32_t i, key_length, length, aad_length;
+    char name[48];
+    uint8_t ok;
+
+    aes_engine_init();
+    for(i = 0U; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+    {
+        key_length = bsp_sim_hex_get(vectors[i].key, key);
+        bsp_sim_hex_get(vectors[i].iv, iv);
+        aad_length = bsp_sim_hex_get(vectors[i].aad, aad);
+        length = bsp_sim_hex_get(vectors[i].plain, (uint8_t *)plain);
+        bsp_sim_hex_get(vectors[i].cipher, (uint8_t *)cipher);
+        bsp_sim_hex_get(vectors[i].tag, tag);
+        aes_gcm_key_init(&gcm_key, key, key_length * 8U);
+
+        memset(&pkts[0], 0, sizeof(pkts[0]));
+        pkts[0].key        = &gcm_key;
+        pkts[0].alg_dir    = CAU_ENCRYPT;
+        pkts[0].iv         = iv;
+        pkts[0].aad        = aad;
+        pkts[0].aad_length = aad_length;
+        pkts[0].input      = (const uint8_t *)plain;
+        pkts[0].length     = length;
+        pkts[0].output     = (uint8_t *)out[0];
+        ok = (SUCCESS == aes_gcm_submit(&pkts[0])) && (SUCCESS == aes_gcm_wait(&pkts[0])) &&
+             (0 == memcmp(out[0], cipher, length)) && (SUCCESS == aes_gcm_tag_check(&pkts[0], tag));
+        snprintf(name, sizeof(name), "gcm case %s encrypt", vectors[i].name);
+        bsp_sim_check(name, ok);
+
+        pkts[0].alg_dir    = CAU_DECRYPT;
+        pkts[0].input      = (const uint8_t *)cipher;
+        ok = (SUCCESS == aes_gcm_submit(&pkts[0])) && (SUCCESS == aes_gcm_wait(&pkts[0])) &&
+             (0 == memcmp(out[0], plain, length)) && (SUCCESS == aes_gcm_tag_check(&pkts[0], tag));
+        tag[AES_GCM_TAG_SIZE - 1U] ^= 0x01U;
+        ok = ok && (ERROR == aes_gcm_tag_check(&pkts[0], tag));
+        snprintf(name, sizeof(name), "gcm case %s decrypt, bad tag rejected", vectors[i].name);
+        bsp_sim_check(name, ok);
+    }
+
+    /* case 3 through DMA with case 4 queued behind it */
+    aes_gcm_key_init(&gcm_key, key, bsp_sim_hex_get(BSP_SIM_GCM_K128, key) * 8U);
+    bsp_sim_hex_get(BSP_SIM_GCM_P60 "1aafd255", (uint8_t *)plain);
+    for(i = 0U; i < 2U; i++)
+    {
+        memset(&pkts[i], 0, sizeof(pkts[i]));
+        pkts[i].key        = &gcm_key;
+        pkts[i].alg_dir    = CAU_ENCRYPT;
+        pkts[i].iv         = iv;
+        pkts[i].aad        = aad;
+        pkts[i].aad_length = (i == 0U) ? 0U : sizeof(aad);
+        pkts[i].input      = (const uint8_t *)plain;
+        pkts[i].length     = (i == 0U) ? 64U : 60U;
+        pkts[i].output     = (uint8_t *)out[i];
+    }
+    bsp_sim_hex_get(BSP_SIM_GCM_IV, iv);
+    bsp_sim_hex_get(BSP_SIM_GCM_AAD, aad);
+    ok = (SUCCESS == aes_gcm_submit(&pkts[0])) && (SUCCESS == aes_gcm_submit(&pkts[1])) &&
+         (SUCCESS == aes_gcm_wait(&pkts[1])) && (SUCCESS == aes_gcm_wait(&pkts[0]));
+    bsp_sim_hex_get(vectors[3].tag, tag);
+    ok = ok && (SUCCESS == aes_gcm_tag_check(&pkts[1], tag));
+    bsp_sim_hex_get(vectors[2].tag, tag);
+    ok = ok && (SUCCESS == aes_gcm_tag_check(&pkts[0], tag));
+    bsp_sim_hex_get(vectors[2].cipher, (uint8_t *)cipher);
+    ok = ok && (0 == memcmp(out[0], cipher, 64U)) && (0 == memcmp(out[1], cipher, 60U));
+    bsp_sim_check("gcm cases 3 and 4 queued", ok);
+#undef BSP_SIM_GCM_K128
+#undef BSP_SIM_GCM_IV
+#undef BSP_SIM_GCM_AAD
+#undef BSP_SIM_GCM_P60
+#undef BSP_SIM_GCM_Z96
+#undef BSP_SIM_GCM_Z128
+}
+
+/*!
+    \brief      AES streaming: DMA only for whole cache lines, aes_final always ends the session
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The DMA path leaves the session busy after aes_update returns,
+                the CPU path ready. ECB encrypts equal blocks alike, so all
+                paths must give the same output.
+*/
+static void bsp_sim_aes(void)
+{
+    static const uint8_t key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    __ALIGNED(32) static uint8_t input[96], output[3][128];                 /* static: DMA addresses are 32-bit */
+    aes_context_struct ecb, ctr;
+    uint8_t tail[2][8];
+    uint32_t length;
+    uint8_t dma, ok;
+
+    aes_engine_init();
+    memset(input, 0x5A, sizeof(input));
+    aes_init(&ecb, CAU_MODE_AES_ECB, CAU_ENCRYPT, key, 128U, NULL);
+    ok = (SUCCESS == aes_update(&ecb, input, 64U, output[0], NULL, NULL));
+    dma = (ecb.state == AES_STATE_BUSY) ? 1U : 0U;
+    ok = ok && (SUCCESS == aes_wait(&ecb));
+    bsp_sim_check("aes dma for an aligned 64-byte bulk", ok && dma);
+
+    ok = (SUCCESS == aes_update(&ecb, input, 64U, output[1] + 16U, NULL, NULL)) && (ecb.state == AES_STATE_READY);
+    ok = ok && (SUCCESS == aes_update(&ecb, input, 80U, output[2], NULL, NULL)) && (ecb.state == AES_STATE_READY);
+    ok = ok && (0 == memcmp(output[0], output[1] + 16U, 64U)) && (0 == memcmp(output[0], output[2], 64U)) &&
+         (0 == memcmp(output[0], output[2] + 64U, 16U));
+    bsp_sim_check("aes cpu for a misaligned output or a partial line", ok);
+
+    /* the CTR tail waits for the ECB transfer instead of failing */
+    aes_init(&ctr, CAU_MODE_AES_CTR, CAU_ENCRYPT, key, 128U, key);
+    aes_update(&ctr, input, 5U, output[1], NULL, NULL);
+    ok = (SUCCESS == aes_final(&ctr, tail[0], &length)) && (length == 5U);
+    aes_init(&ctr, CAU_MODE_AES_CTR, CAU_ENCRYPT, key, 128U, key);
+    aes_update(&ctr, input, 5U, output[1], NULL, NULL);
+    ok = ok && (SUCCESS == aes_update(&ecb, input, 96U, output[0], NULL, NULL)) && (ecb.state == AES_STATE_BUSY);
+    ok = ok && (SUCCESS == aes_final(&ctr, tail[1], &length)) && (length == 5U) && (0 == memcmp(tail[0], tail[1], 5U));
+    ok = ok && (ctr.state == AES_STATE_IDLE) && (SUCCESS == aes_wait(&ecb));
+    bsp_sim_check("aes ctr tail waits for another session's dma", ok);
+
+    aes_update(&ecb, input, 5U, output[0], NULL, NULL);
+    ok = (ERROR == aes_final(&ecb, tail[0], &length)) && (length == 0U) && (ecb.state == AES_STATE_IDLE);
+    bsp_sim_check("aes final ends the session on error", ok);
+}
+
+/*!
+    \brief      CTR-DRBG known answer, the self-test of rng_init through the public API
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Entropy 00 01 .. 2f, no personalization, the second of two 64-byte
+                requests is checked. An aligned output goes through DMA, an odd
+                address through CPU feeding; both must give the known answer.
+*/
+static void bsp_sim_drbg(void)
+{
+    static const char expected[] = "04562ad35e8ecafaafda16981cdaa147606beea62801342af13c8b5535f72f94"
+                                   "95b74317c762f0adab7abe710797612176b61b0e208398113cf9c170157bc75f";
+    __ALIGNED(32) static uint32_t output[17];                               /* static: DMA addresses are 32-bit */
+    uint8_t entropy[RNG_DRBG_SEED_SIZE];
+    rng_drbg_struct drbg;
+    uint32_t i, offset;
+    uint8_t ok;
+
+    for(i = 0U; i < RNG_DRBG_SEED_SIZE; i++)
+    {
+        entropy[i] = (uint8_t)i;
+    }
+    aes_engine_init();
+    for(offset = 0U; offset < 2U; offset++)
+    {
+        ok = (SUCCESS == rng_drbg_instantiate(&drbg, entropy, NULL, 0U)) &&
+             (SUCCESS == rng_drbg_generate(&drbg, (uint8_t *)output + offset, 64U)) &&
+             (SUCCESS == rng_drbg_generate(&drbg, (uint8_t *)output + offset, 64U)) &&
+             bsp_sim_hex_equal((uint8_t *)output + offset, expected);
+        bsp_sim_check((offset == 0U) ? "drbg known answer, dma" : "drbg known answer, cpu", ok);
+    }
+    drbg.reseed_counter = 0U;
+    bsp_sim_check("drbg refuses an unseeded state", ERROR == rng_drbg_generate(&drbg, (uint8_t *)output, 16U));
+}
+
+/*!
+    \brief      load the RCU registers of a clock tree case
+    \param[in]  c: register values
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_clock_load(const bsp_sim_clock_case_struct *c)
+{
+    RCU_CFG0 = c->cfg0 & ~RCU_CFG0_SCS;
+    rcu_system_clock_source_config(c->cfg0 & RCU_CFG0_SCS);               /* through the model, which sets SCSS */
+    RCU_CFG1 = c->cfg1;
+    RCU_ADDCTL1 = c->addctl1;
+    RCU_PLLALL = c->pllall;
+    RCU_PLL0 = c->pll[0];
+    RCU_PLL1 = c->pll[1];
+    RCU_PLL2 = c->pll[2];
+    RCU_PLL0FRA = c->pllfra[0];
+    RCU_PLL1FRA = c->pllfra[1];
+    RCU_PLL2FRA = c->pllfra[2];
+    RCU_PLLADDCTL = c->plladdctl;
+    clock_tree_invalidate();
+}
+
+/*!
+    \brief      clock tree against rcu_clock_freq_get
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       rcu_clock_freq_get computes PLLs in single precision, which is
+                only exact for integer multipliers. With a fractional one both
+                must agree to 1 ppm, and the exact values are checked by hand.
+                It also applies the PLL0 fraction to a PLL whose own latch is
+                off while CK_SYS runs from PLL0P; the tree reads each latch, so
+                that case is only checked by hand.
+*/
+static void bsp_sim_clock(void)
+{
+    bsp_sim_clock_case_struct saved = {"saved", 0U, 0U, 0U, 0U, {0U, 0U, 0U}, {0U, 0U, 0U}, 0U};
+    uint32_t c, id, tree, firmware, slack;
+    uint8_t ok;
+    char name[64];
+
+    saved.cfg0 = RCU_CFG0;
+    saved.cfg1 = RCU_CFG1;
+    saved.addctl1 = RCU_ADDCTL1;
+    saved.pllall = RCU_PLLALL;
+    saved.pll[0] = RCU_PLL0;
+    saved.pll[1] = RCU_PLL1;
+    saved.pll[2] = RCU_PLL2;
+    saved.pllfra[0] = RCU_PLL0FRA;
+    saved.pllfra[1] = RCU_PLL1FRA;
+    saved.pllfra[2] = RCU_PLL2FRA;
+    saved.plladdctl = RCU_PLLADDCTL;
+
+    for(c = 0U; c < sizeof(s_bsp_sim_clock_cases) / sizeof(s_bsp_sim_clock_cases[0]); c++)
+    {
+        bsp_sim_clock_load(&s_bsp_sim_clock_cases[c]);
+        ok = 1U;
+        for(id = CLOCK_SYS; id <= CLOCK_LPIRC4M; id++)
+        {
+            tree = clock_freq_get((clock_id_enum)id);
+            firmware = rcu_clock_freq_get((rcu_clock_freq_enum)id);
+            slack = (s_bsp_sim_clock_cases[c].pllfra[0] | s_bsp_sim_clock_cases[c].pllfra[1] |
+                     s_bsp_sim_clock_cases[c].pllfra[2]) ? tree / 1000000U : 0U;
+            if((tree > firmware + slack) || (firmware > tree + slack))
+            {
+                printf("     clock %u: tree %u, rcu_clock_freq_get %u\n", (unsigned)id, (unsigned)tree, (unsigned)firmware);
+                ok = 0U;
+            }
+        }
+        snprintf(name, sizeof(name), "clock tree %s", s_bsp_sim_clock_cases[c].name);
+        bsp_sim_check(name, ok);
+    }
+
+    /* 32 MHz / 4 * (60 + 1/8192) / 2, 8191/8192 on PLL2, x4 timer rule on /8 and /16 */
+    bsp_sim_clock_load(&s_bsp_sim_clock_cases[2]);
+    bsp_sim_check("clock tree fractional pll0 exact", (clock_freq_get(CLOCK_PLL0P) == 240000488U) &&
+                  (clock_freq_get(CLOCK_PLL0R) == 120000244U) && (clock_freq_get(CLOCK_PLL0Q) == 160000325U));
+    bsp_sim_check("clock tree fractional pll1 exact", clock_freq_get(CLOCK_PLL1Q) == 80666666U);
+    bsp_sim_check("clock tree fractional pll2 exact", clock_freq_get(CLOCK_PLL2P) == 133333170U);
+    bsp_sim_check("clock tree timer x4 rule", (clock_freq_get(CLOCK_TIMER_APB1) == 120000244U) &&
+                  (clock_freq_get(CLOCK_TIMER_APB2) == 60000120U));
+    RCU_PLL1FRA = 4096U;
+    clock_tree_invalidate();
+    bsp_sim_check("clock tree fraction without latch ignored", clock_freq_get(CLOCK_PLL1P) == 240000000U);
+    bsp_sim_clock_load(&s_bsp_sim_clock_cases[1]);
+    bsp_sim_check("clock tree timer x2 rule", (clock_freq_get(CLOCK_TIMER_APB1) == 300000000U) &&
+                  (clock_freq_get(CLOCK_USART2) == LXTAL_VALUE));
+
+    bsp_sim_clock_load(&saved);
+}
+
+/*!
+    \brief      thermal control law, calibration and thermal model
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The threshold checks mirror thermal_window_set: a count one past
+                the programmed threshold must convert to a temperature that
+                leaves the level, or the interrupt would not change it.
+*/
+static void bsp_sim_thermal(void)
+{
+    static const thermal_law_struct law = {{85000, 95000, 105000}, 5000};
+    static const thermal_calib_struct calib = {30, 1200000U, 4000U, 150000000U, 15U};
+    static const uint32_t power_mw[THERMAL_LEVEL_NUM] = {1600U, 1200U, 800U, 400U};
+    thermal_model_struct model = {25000, 25000, 60U, 2000U};
+    int32_t low_mc, high_mc, temp_mc, max_mc = 0;
+    uint32_t count, last = 0xFFFFFFFFU, step, changes = 0U;
+    uint8_t level, next, ok;
+
+    bsp_sim_check("thermal law band edges",
+                  (thermal_law_level(&law, THERMAL_LEVEL_NORMAL, 84999) == THERMAL_LEVEL_NORMAL) &&
+                  (thermal_law_level(&law, THERMAL_LEVEL_NORMAL, 85000) == THERMAL_LEVEL_WARM) &&
+                  (thermal_law_level(&law, THERMAL_LEVEL_WARM, 95000) == THERMAL_LEVEL_HOT) &&
+                  (thermal_law_level(&law, THERMAL_LEVEL_NORMAL, 105000) == THERMAL_LEVEL_CRITICAL) &&
+                  (thermal_law_level(&law, THERMAL_LEVEL_NUM, 0) == THERMAL_LEVEL_NORMAL));
+    bsp_sim_check("thermal law hysteresis",
+                  (thermal_law_level(&law, THERMAL_LEVEL_WARM, 80000) == THERMAL_LEVEL_WARM) &&
+                  (thermal_law_level(&law, THERMAL_LEVEL_WARM, 79999) == THERMAL_LEVEL_NORMAL) &&
+                  (thermal_law_level(&law, THERMAL_LEVEL_CRITICAL, 100000) == THERMAL_LEVEL_CRITICAL) &&
+                  (thermal_law_level(&law, THERMAL_LEVEL_CRITICAL, 99999) == THERMAL_LEVEL_HOT) &&
+                  (thermal_law_level(&law, THERMAL_LEVEL_HOT, 89999) == THERMAL_LEVEL_WARM));
+
+    ok = 1U;
+    for(level = THERMAL_LEVEL_NORMAL; level < THERMAL_LEVEL_NUM; level++)
+    {
+        thermal_law_window(&law, level, &low_mc, &high_mc);
+        ok &= (uint8_t)((low_mc == THERMAL_TEMP_NONE) == (level == THERMAL_LEVEL_NORMAL));
+        ok &= (uint8_t)((high_mc == THERMAL_TEMP_NONE) == (level == THERMAL_LEVEL_CRITICAL));
+        if(high_mc != THERMAL_TEMP_NONE)
+        {
+            ok &= (uint8_t)(thermal_law_level(&law, level, high_mc - 1) == level);
+            ok &= (uint8_t)(thermal_law_level(&law, level, high_mc) > level);
+            ok &= (uint8_t)(thermal_law_level(&law, level, thermal_calib_temp(&calib, thermal_calib_count(&calib, high_mc) - 1U)) > level);
+        }
+        if(low_mc != THERMAL_TEMP_NONE)
+        {
+            ok &= (uint8_t)(thermal_law_level(&law, level, low_mc) == level);
+            ok &= (uint8_t)(thermal_law_level(&law, level, low_mc - 1) < level);
+            ok &= (uint8_t)(thermal_law_level(&law, level, thermal_calib_temp(&calib, thermal_calib_count(&calib, low_mc) + 1U)) < level);
+        }
+    }
+    bsp_sim_check("thermal law windows and thresholds", ok);
+
+    /* one count is about 0.08 degrees at this calibration */
+    ok = (thermal_calib_temp(&calib, 0U) == THERMAL_TEMP_NONE);
+    for(temp_mc = -40000; temp_mc <= 125000; temp_mc += 500)
+    {
+        count = thermal_calib_count(&calib, temp_mc);
+        ok &= (uint8_t)((count < last) && (thermal_calib_temp(&calib, count) >= temp_mc - 200) &&
+                        (thermal_calib_temp(&calib, count) <= temp_mc + 200));
+        last = count;
+    }
+    bsp_sim_check("thermal calibration round trip", ok && (thermal_calib_count(&calib, 30000) == 3750U));
+
+    /* 1.6 W would settle at 121 C unthrottled; the law must hold the die below CRITICAL */
+    level = THERMAL_LEVEL_NORMAL;
+    for(step = 0U; step < 6000U; step++)
+    {
+        thermal_model_step(&model, power_mw[level], 10U);
+        next = thermal_law_level(&law, level, model.temp_mc);
+        changes += (next != level) ? 1U : 0U;
+        level = next;
+        max_mc = (model.temp_mc > max_mc) ? model.temp_mc : max_mc;
+    }
+    printf("     thermal model: max %d mC, %u level changes in 60 s\n", (int)max_mc, (unsigned)changes);
+    bsp_sim_check("thermal law holds the model below critical", (max_mc < 105000) && (level >= THERMAL_LEVEL_WARM) &&
+                  (changes >= 2U) && (changes <= 60U));
+}
+
+/*!
+    \brief      sensor hub batch selection and the bus simulation
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_sensorhub(void)
+{
+    static const sensorhub_read_struct reads[4] =
+    {
+        {0U, 0x68U, 0x3BU, 14U, 1000U, 0U},
+        {0U, 0x1EU, 0x03U, 6U, 1000U, 200U},
+        {0U, 0x77U, 0xF7U, 6U, 4000U, 0U},
+        {1U, 0x40U, 0x00U, 2U, 1000U, 0U},
+    };
+    static const sensorhub_read_struct paced[2][2] =
+    {
+        {{0U, 0x68U, 0x3BU, 6U, 1000U, 0U}, {0U, 0x1EU, 0x03U, 6U, 1250U, 0U}},
+        {{0U, 0x68U, 0x3BU, 6U, 1000U, 300U}, {0U, 0x1EU, 0x03U, 6U, 1250U, 300U}},
+    };
+    sensorhub_sched_struct sched;
+    sensorhub_sim_struct sim;
+    uint8_t ids[4];
+    uint32_t batches_no_slack;
+    uint8_t n;
+
+    sensorhub_sched_init(&sched, 4U, 0U);
+    n = sensorhub_sched_batch(&sched, reads, 4U, 0U, 0U, ids, 4U);
+    bsp_sim_check("sensorhub batch takes the due reads of its bus", (n == 3U) && (ids[0] == 0U) && (ids[2] == 2U) &&
+                  (sched.next_us[0] == 1000U) && (sched.next_us[3] == 0U));
+    bsp_sim_check("sensorhub batch empty before the due time", (sensorhub_sched_batch(&sched, reads, 4U, 0U, 800U, ids, 4U) == 0U) &&
+                  (sensorhub_sched_due(&sched, reads, 4U, 0U, 800U) == 200U) &&
+                  (sensorhub_sched_due(&sched, reads, 4U, SENSORHUB_BUS_ANY, 800U) == 0U));
+
+    /* due at 1000 and 1150: the second joins by its slack and keeps its phase */
+    sched.next_us[1] = 1150U;
+    n = sensorhub_sched_batch(&sched, reads, 4U, 0U, 1000U, ids, 4U);
+    bsp_sim_check("sensorhub slack joins early, phase kept", (n == 2U) && (ids[1] == 1U) && (sched.next_us[1] == 2150U));
+
+    /* read 0 due at 2000 runs at 4500: late 2500, 3000 and 4000 skipped, next on the old phase */
+    n = sensorhub_sched_batch(&sched, reads, 4U, 0U, 4500U, ids, 4U);
+    bsp_sim_check("sensorhub late read keeps its phase", (n == 3U) && (sched.next_us[0] == 5000U) &&
+                  (sched.next_us[1] == 5150U) && (sched.late_max_us == 2500U) && (sched.missed == 4U));
+
+    /* one second on a 400 kHz bus: slack trades wakeups, never the read rate */
+    sensorhub_sched_simulate(reads, 3U, 400000U, 20U, 1000000U, &sim);
+    bsp_sim_check("sensorhub simulation rate exact", (sim.reads == 2250U) && (sim.batches == 1000U) && (sim.missed == 0U));
+    sensorhub_sched_simulate(paced[0], 2U, 400000U, 20U, 1000000U, &sim);
+    batches_no_slack = sim.batches;
+    bsp_sim_check("sensorhub simulation without slack", (sim.reads == 1800U) && (sim.batches == 1600U));
+    sensorhub_sched_simulate(paced[1], 2U, 400000U, 20U, 1000000U, &sim);
+    printf("     sensorhub: %u batches without slack, %u with 300 us, load %u permille\n", (unsigned)batches_no_slack,
+           (unsigned)sim.batches, (unsigned)sim.load_permille);
+    bsp_sim_check("sensorhub slack shares wakeups at the same rate", (sim.reads == 1800U) && (sim.batches < batches_no_slack) &&
+                  (sim.missed == 0U));
+}
+
+/*!
+    \brief      TIMER1 timebase and SysTick delay against virtual time
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_time(void)
+{
+    uint32_t t0, t1, i;
+    uint64_t v0, v1;
+
+    timer_monotonic_config();
+    t0 = timer_monotonic_us();
+    sim_run_us(1000U);
+    t1 = timer_monotonic_us();
+    bsp_sim_check("timer monotonic 1000 us", (t1 - t0 >= 1000U) && (t1 - t0 <= 1001U));
+
+    /* the handler disabling the channel interrupt marks the wakeup */
+    t0 = timer_monotonic_us();
+    timer_monotonic_alarm_set(t0 + 300U);
+    for(i = 0U; (i < 100U) && (TIMER_DMAINTEN(TIMER_MONOTONIC) & TIMER_DMAINTEN_CH0IE); i++)
+    {
+        __WFI();
+    }
+    t1 = timer_monotonic_us();
+    bsp_sim_check("timer alarm wakes at 300 us", (i > 0U) && (t1 - t0 >= 300U) && (t1 - t0 <= 301U) &&
+                  !(TIMER_DMAINTEN(TIMER_MONOTONIC) & TIMER_DMAINTEN_CH0IE));
+    timer_monotonic_alarm_set(t1 - 1U);
+    bsp_sim_check("timer alarm in the past fires at once", !(TIMER_DMAINTEN(TIMER_MONOTONIC) & TIMER_DMAINTEN_CH0IE));
+
+    delay_init();
+    v0 = sim_time_us();
+    delay_us(500U);
+    v1 = sim_time_us();
+    bsp_sim_check("delay_us 500", (v1 - v0 >= 500U) && (v1 - v0 <= 502U));
+}
+
+/*!
+    \brief      DVFS check phase: refused points leave clocks and peripherals untouched
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       The models run at SIM_PERIPH_HZ whatever SystemCoreClock says, so
+                the old point is picked by setting SystemCoreClock before dvfs_init.
+*/
+static void bsp_sim_dvfs(void)
+{
+    dvfs_stats_struct stats;
+    uint32_t baud, ctl0;
+
+    ctl0 = USART_CTL0(BSP_USART);
+    baud = USART_BAUD(BSP_USART);
+    usart_disable(BSP_USART);
+
+    /* 600 MHz to HXTAL: the 64 MHz timer clock would become 2.67 MHz, no whole 1 MHz prescaler */
+    dvfs_init();
+    bsp_sim_check("dvfs hxtal refused by the timebase", (dvfs_opp_set(DVFS_OPP_HXTAL) == ERROR) &&
+                  (dvfs_opp_get() == DVFS_OPP_600M) && ((TIMER_PSC(TIMER_MONOTONIC) & TIMER_PSC_PSC) == 63U));
+
+    /* 200 MHz to HXTAL: the timer clock would be 8 MHz, but 921600 baud needs a divider of 8.7 */
+    SystemCoreClock = 200000000U;
+    dvfs_init();
+    USART_BAUD(BSP_USART) = 69U;                                            /* 921600 baud at 64 MHz */
+    usart_enable(BSP_USART);
+    bsp_sim_check("dvfs hxtal refused by the USART0 divider", (dvfs_opp_set(DVFS_OPP_HXTAL) == ERROR) &&
+                  (dvfs_opp_get() == DVFS_OPP_200M) && (USART_BAUD(BSP_USART) == 69U) &&
+                  (USART_CTL0(BSP_USART) & USART_CTL0_UEN));
+    dvfs_stats_get(&stats);
+    bsp_sim_check("dvfs refusal counted, no transition", (stats.rejected == 1U) && (stats.transitions == 0U));
+    bsp_sim_check("dvfs policy and thermal floor above hxtal", DVFS_OPP_SLOWEST < DVFS_OPP_HXTAL);
+
+    SystemCoreClock = SIM_CORE_HZ;
+    usart_disable(BSP_USART);
+    USART_BAUD(BSP_USART) = baud;
+    if(ctl0 & USART_CTL0_UEN)
+    {
+        usart_enable(BSP_USART);
+    }
+}
+
+/*!
+    \brief      flash erase and program through the firmware library
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_flash(void)
+{
+    fmc_state_enum state;
+
+    fmc_unlock();
+    state = fmc_sector_erase(BSP_SIM_FLASH_SECTOR);
+    bsp_sim_check("fmc sector erase", (state == FMC_READY) && (REG32(BSP_SIM_FLASH_SECTOR + 0xFFCU) == 0xFFFFFFFFU));
+    state = fmc_word_program(BSP_SIM_FLASH_SECTOR, 0x12345678U);
+    bsp_sim_check("fmc word program", (state == FMC_READY) && (REG32(BSP_SIM_FLASH_SECTOR) == 0x12345678U));
+    fmc_word_program(BSP_SIM_FLASH_SECTOR, 0xFFFF00FFU);
+    bsp_sim_check("fmc program clears bits only", REG32(BSP_SIM_FLASH_SECTOR) == 0x12340078U);
+    fmc_flag_clear(FMC_FLAG_END);
+    fmc_lock();
+
+    state = fmc_word_program(BSP_SIM_FLASH_SECTOR + 4U, 0U);
+    bsp_sim_check("fmc locked program rejected", (state == FMC_PGSERR) && (REG32(BSP_SIM_FLASH_SECTOR + 4U) == 0xFFFFFFFFU));
+    fmc_flag_clear(FMC_FLAG_PGSERR);
+    bsp_sim_check("fmc error flag cleared", fmc_flag_get(FMC_FLAG_PGSERR) == RESET);
+}
+
+/*!
+    \brief      fill the configuration registers of every port
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_gpio_fill(void)
+{
+    uint32_t i, r;
+    static const uint8_t offset[] = {0x00U, 0x04U, 0x08U, 0x0CU, 0x20U, 0x24U};
+
+    for(i = 0U; i < PINCFG_PORT_NUM; i++)
+    {
+        for(r = 0U; r < sizeof(offset); r++)
+        {
+            REG32(s_bsp_sim_pins[i].port + offset[r]) = BSP_SIM_GPIO_FILL;
+        }
+    }
+}
+
+/*!
+    \brief      merged pin table: same registers as the per-pin calls, fewer accesses
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bsp_sim_pincfg(void)
+{
+    static uint32_t calls[PINCFG_PORT_NUM][0x28U / 4U];
+    sim_stats_struct before, after;
+    uint64_t call_accesses;
+    uint32_t i, writes;
+    uint8_t same = 1U;
+
+    bsp_sim_check("pincfg pin twice rejected", !PINCFG_VALID(BSP_SIM_PINS_TWICE));
+    bsp_sim_check("pincfg unknown port rejected", !PINCFG_VALID(BSP_SIM_PINS_NO_PORT));
+    bsp_sim_check("pincfg pin 16 rejected", !PINCFG_VALID(BSP_SIM_PINS_RANGE));
+    bsp_sim_check("pincfg pin number of GPIO_PIN_x", (PINCFG_PIN(GPIO_PIN_0) == 0U) && (PINCFG_PIN(GPIO_PIN_9) == 9U) &&
+                                                     (PINCFG_PIN(GPIO_PIN_15) == 15U));
+    bsp_sim_check("pincfg mask of no or two pins rejected", (PINCFG_PIN(0U) == 16U) &&
+                                                            (PINCFG_PIN(GPIO_PIN_9 | GPIO_PIN_10) == 16U));
+    bsp_sim_check("pincfg board USART0 from its macros", (s_bsp_sim_board[0].pins == (BSP_USART_TX_PIN | BSP_USART_RX_PIN)) &&
+                                                         (s_bsp_sim_board[0].reg[PINCFG_AFSEL1].value == 0x00000770U));
+    bsp_sim_check("pincfg board I2C0 from its macros", s_bsp_sim_board[1].pins == (I2C_MASTER_SCL_PIN | I2C_MASTER_SDA_PIN));
+    same = 1U;
+    for(i = 2U; i < PINCFG_PORT_NUM; i++)
+    {
+        same &= (s_bsp_sim_board[i].pins == 0U) ? 1U : 0U;
+    }
+    bsp_sim_check("pincfg board without disabled peripherals", same);
+    same = 1U;
+    bsp_sim_check("pincfg merged GPIOA CTL", (s_bsp_sim_pins[0].reg[PINCFG_CTL].mask == 0x003C0003U) &&
+                                             (s_bsp_sim_pins[0].reg[PINCFG_CTL].value == 0x00280003U));
+    bsp_sim_check("pincfg merged GPIOB AFSEL", (s_bsp_sim_pins[1].reg[PINCFG_AFSEL0].value == 0x00E00000U) &&
+                                               (s_bsp_sim_pins[1].reg[PINCFG_AFSEL1].mask == 0U));
+
+    bsp_sim_gpio_fill();
+    sim_stats_get(&before);
+    BSP_SIM_PINS(BSP_SIM_PIN_CALLS, 0U)
+    sim_stats_get(&after);
+    call_accesses = after.accesses - before.accesses;
+    for(i = 0U; i < PINCFG_PORT_NUM; i++)
+    {
+        memcpy(calls[i], (const void *)(uintptr_t)s_bsp_sim_pins[i].port, sizeof(calls[i]));
+    }
+
+    bsp_sim_gpio_fill();
+    sim_stats_get(&before);
+    writes = pincfg_apply(s_bsp_sim_pins, PINCFG_PORT_NUM);
+    sim_stats_get(&after);
+    for(i = 0U; i < PINCFG_PORT_NUM; i++)
+    {
+        same &= (0 == memcmp(calls[i], (const void *)(uintptr_t)s_bsp_sim_pins[i].port, sizeof(calls[i])));
+    }
+    bsp_sim_check("pincfg registers as per-pin calls", same);
+    bsp_sim_check("pincfg one write per register", writes == 5U + 5U + 4U);  /* A and B: 5, K: no AFSEL */
+    bsp_sim_check("pincfg fewer accesses", after.accesses - before.accesses < call_accesses);
+    printf("pincfg: %u writes, %llu accesses, per-pin calls %llu accesses\n", (unsigned)writes,
+           (unsigned long long)(after.accesses - before.accesses), (unsigned long long)call_accesses);
+}
+
+/*!
+    \brief      main function
+    \param[in]  argc: argument count
+    \param[in]  argv: --selftest runs every check
+    \param[out] none
+    \retval     0 if every check passed
+*/
+int main(int argc, char *argv[])
+{
+    sim_stats_struct stats;
+
+    if((argc != 2) || (0 != strcmp(argv[1], "--selftest")))
+    {
+        printf("usage: %s --selftest\n", argv[0]);
+        return 2;
+    }
+    sim_init();
+    nvic_priority_group_set(NVIC_PRIGROUP_PRE4_SUB0);
+    lock_init();                                                            /* before any engine init, as in main */
+    bsp_sim_idle();
+    bsp_sim_usart_rx();
+    bsp_sim_usart_tx();
+    bsp_sim_crc_sw();
+    bsp_sim_crc();
+    bsp_sim_lock();
+    bsp_sim_hash();
+    bsp_sim_gcm();
+    bsp_sim_aes();
+    bsp_sim_drbg();
+    bsp_sim_clock();
+    bsp_sim_thermal();
+    bsp_sim_sensorhub();
+    bsp_sim_time();
+    bsp_sim_dvfs();
+    bsp_sim_flash();
+    bsp_sim_pincfg();
+
+    sim_stats_get(&stats);
+    printf("virtual time %llu us, %llu accesses (%llu to registers), %llu events, %llu interrupts, %llu wfi\n",
+           (unsigned long long)(stats.cycles / (SIM_CORE_HZ / 1000000U)), (unsigned long long)stats.accesses,
+           (unsigned long long)stats.register_accesses, (unsigned long long)stats.events,
+           (unsigned long long)stats.irqs, (unsigned long long)stats.wfi);
+    printf("%s: %u failed\n", s_bsp_sim_failed ? "FAIL" : "PASS", (unsigned)s_bsp_sim_failed);
+    return s_bsp_sim_failed ? 1 : 0;
+}
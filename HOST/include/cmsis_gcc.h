@@ -0,0 +1,171 @@
+/*!
+    \file       cmsis_gcc.h
+    \brief      CMSIS compiler layer of the host build
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - The CMSIS compiler macros for a host GCC, picked up by CORE/cmsis_compiler.h
+    - Core register intrinsics (PRIMASK, BASEPRI, IPSR) routed to the simulated
+      core in HOST/sim, so critical sections and handlers behave as on target
+    - WFI/WFE as a skip to the next simulated event
+    - Data processing intrinsics (REV, RBIT, CLZ, saturation) in plain C and
+      LDREX/STREX that always succeed, the host runs a single thread
+*/
+
+#ifndef __CMSIS_GCC_H
+#define __CMSIS_GCC_H
+#include <stdint.h>
+
+/* CMSIS compiler specific defines */
+#ifndef   __ASM
+  #define __ASM                                  __asm
+#endif
+#ifndef   __INLINE
+  #define __INLINE                               inline
+#endif
+#ifndef   __STATIC_INLINE
+  #define __STATIC_INLINE                        static inline
+#endif
+#ifndef   __STATIC_FORCEINLINE
+  #define __STATIC_FORCEINLINE                   __attribute__((always_inline)) static inline
+#endif
+#ifndef   __NO_RETURN
+  #define __NO_RETURN                            __attribute__((__noreturn__))
+#endif
+#ifndef   __USED
+  #define __USED                                 __attribute__((used))
+#endif
+#ifndef   __WEAK
+  #define __WEAK                                 __attribute__((weak))
+#endif
+#ifndef   __PACKED
+  #define __PACKED                               __attribute__((packed, aligned(1)))
+#endif
+#ifndef   __PACKED_STRUCT
+  #define __PACKED_STRUCT                        struct __attribute__((packed, aligned(1)))
+#endif
+#ifndef   __PACKED_UNION
+  #define __PACKED_UNION                         union __attribute__((packed, aligned(1)))
+#endif
+#ifndef   __UNALIGNED_UINT16_WRITE
+  __PACKED_STRUCT T_UINT16_WRITE { uint16_t v; };
+  #define __UNALIGNED_UINT16_WRITE(addr, val)    (void)((((struct T_UINT16_WRITE *)(void *)(addr))->v) = (val))
+#endif
+#ifndef   __UNALIGNED_UINT16_READ
+  __PACKED_STRUCT T_UINT16_READ { uint16_t v; };
+  #define __UNALIGNED_UINT16_READ(addr)          (((const struct T_UINT16_READ *)(const void *)(addr))->v)
+#endif
+#ifndef   __UNALIGNED_UINT32_WRITE
+  __PACKED_STRUCT T_UINT32_WRITE { uint32_t v; };
+  #define __UNALIGNED_UINT32_WRITE(addr, val)    (void)((((struct T_UINT32_WRITE *)(void *)(addr))->v) = (val))
+#endif
+#ifndef   __UNALIGNED_UINT32_READ
+  __PACKED_STRUCT T_UINT32_READ { uint32_t v; };
+  #define __UNALIGNED_UINT32_READ(addr)          (((const struct T_UINT32_READ *)(const void *)(addr))->v)
+#endif
+#ifndef   __ALIGNED
+  #define __ALIGNED(x)                           __attribute__((aligned(x)))
+#endif
+#ifndef   __RESTRICT
+  #define __RESTRICT                             __restrict
+#endif
+#ifndef   __COMPILER_BARRIER
+  #define __COMPILER_BARRIER()                   __ASM volatile("":::"memory")
+#endif
+
+/* simulated core, HOST/sim/sim.c */
+uint32_t sim_primask_get(void);
+void sim_primask_set(uint32_t primask);
+uint32_t sim_basepri_get(void);
+void sim_basepri_set(uint32_t basepri);
+uint32_t sim_ipsr_get(void);
+void sim_wfi(void);
+
+/* core register access */
+__STATIC_FORCEINLINE void __enable_irq(void)                { sim_primask_set(0U); }
+__STATIC_FORCEINLINE void __disable_irq(void)               { sim_primask_set(1U); }
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void)           { return sim_primask_get(); }
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t priMask)   { sim_primask_set(priMask & 1U); }
+__STATIC_FORCEINLINE uint32_t __get_BASEPRI(void)           { return sim_basepri_get(); }
+__STATIC_FORCEINLINE void __set_BASEPRI(uint32_t basePri)   { sim_basepri_set(basePri & 0xFFU); }
+__STATIC_FORCEINLINE void __set_BASEPRI_MAX(uint32_t basePri)
+{
+    uint32_t current = sim_basepri_get();
+
+    if((basePri != 0U) && ((current == 0U) || (basePri < current)))
+    {
+        sim_basepri_set(basePri & 0xFFU);
+    }
+}
+__STATIC_FORCEINLINE void __enable_fault_irq(void)          { }
+__STATIC_FORCEINLINE void __disable_fault_irq(void)         { }
+__STATIC_FORCEINLINE uint32_t __get_FAULTMASK(void)         { return 0U; }
+__STATIC_FORCEINLINE void __set_FAULTMASK(uint32_t faultMask) { (void)faultMask; }
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void)              { return sim_ipsr_get(); }
+__STATIC_FORCEINLINE uint32_t __get_xPSR(void)              { return sim_ipsr_get(); }
+__STATIC_FORCEINLINE uint32_t __get_APSR(void)              { return 0U; }
+__STATIC_FORCEINLINE uint32_t __get_CONTROL(void)           { return 0U; }
+__STATIC_FORCEINLINE void __set_CONTROL(uint32_t control)   { (void)control; }
+__STATIC_FORCEINLINE uint32_t __get_MSP(void)               { return 0U; }
+__STATIC_FORCEINLINE void __set_MSP(uint32_t topOfMainStack) { (void)topOfMainStack; }
+__STATIC_FORCEINLINE uint32_t __get_PSP(void)               { return 0U; }
+__STATIC_FORCEINLINE void __set_PSP(uint32_t topOfProcStack) { (void)topOfProcStack; }
+__STATIC_FORCEINLINE uint32_t __get_FPSCR(void)             { return 0U; }
+__STATIC_FORCEINLINE void __set_FPSCR(uint32_t fpscr)       { (void)fpscr; }
+
+/* hints and barriers: the simulated bus is strongly ordered */
+#define __NOP()                     __ASM volatile("nop")
+#define __WFI()                     sim_wfi()
+#define __WFE()                     sim_wfi()
+#define __SEV()                     __COMPILER_BARRIER()
+#define __ISB()                     __COMPILER_BARRIER()
+#define __DSB()                     __COMPILER_BARRIER()
+#define __DMB()                     __COMPILER_BARRIER()
+#define __BKPT(value)               __builtin_trap()
+
+/* data processing */
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value)         { return __builtin_bswap32(value); }
+__STATIC_FORCEINLINE uint32_t __REV16(uint32_t value)       { return ((value & 0xFF00FF00U) >> 8) | ((value & 0x00FF00FFU) << 8); }
+__STATIC_FORCEINLINE int16_t __REVSH(int16_t value)         { return (int16_t)__builtin_bswap16((uint16_t)value); }
+__STATIC_FORCEINLINE uint32_t __ROR(uint32_t op1, uint32_t op2)
+{
+    op2 %= 32U;
+    return (op2 == 0U) ? op1 : ((op1 >> op2) | (op1 << (32U - op2)));
+}
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t value)
+{
+    uint32_t result = 0U;
+    uint32_t i;
+
+    for(i = 0U; i < 32U; i++)
+    {
+        result = (result << 1) | ((value >> i) & 1U);
+    }
+    return result;
+}
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t value)          { return (value == 0U) ? 32U : (uint8_t)__builtin_clz(value); }
+__STATIC_FORCEINLINE int32_t __SSAT(int32_t val, uint32_t sat)
+{
+    const int32_t max = (int32_t)((1U << (sat - 1U)) - 1U);
+    const int32_t min = -1 - max;
+
+    return (val > max) ? max : ((val < min) ? min : val);
+}
+__STATIC_FORCEINLINE uint32_t __USAT(int32_t val, uint32_t sat)
+{
+    const uint32_t max = (1U << sat) - 1U;
+
+    return (val < 0) ? 0U : (((uint32_t)val > max) ? max : (uint32_t)val);
+}
+
+/* exclusive access: one thread, so every store-exclusive succeeds */
+__STATIC_FORCEINLINE uint8_t __LDREXB(volatile uint8_t *addr)   { return *addr; }
+__STATIC_FORCEINLINE uint16_t __LDREXH(volatile uint16_t *addr) { return *addr; }
+__STATIC_FORCEINLINE uint32_t __LDREXW(volatile uint32_t *addr) { return *addr; }
+__STATIC_FORCEINLINE uint32_t __STREXB(uint8_t value, volatile uint8_t *addr)   { *addr = value; return 0U; }
+__STATIC_FORCEINLINE uint32_t __STREXH(uint16_t value, volatile uint16_t *addr) { *addr = value; return 0U; }
+__STATIC_FORCEINLINE uint32_t __STREXW(uint32_t value, volatile uint32_t *addr) { *addr = value; return 0U; }
+__STATIC_FORCEINLINE void __CLREX(void)                     { }
+#endif /* __CMSIS_GCC_H */
@@ -0,0 +1,1023 @@
+/*!
+    \file       sim.c
+    \brief      virtual clock, interrupt controller and register bus of the host build
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - Mapping the flash, peripheral and private peripheral bus windows at their
+      target addresses, so the register macros of the firmware library work
+    - The bus hook: every volatile access of the instrumented BSP and firmware
+      code advances the virtual clock and reaches the model owning the address
+    - NVIC (enable, pending, priorities, PRIMASK, BASEPRI, preemption), SysTick
+      and the DWT cycle counter
+    - Running virtual time from the test program
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "gd32h7xx.h"
+#include "sim.h"
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE         0x100000
+#endif
+
+#define SIM_SCS_BASE                0xE000E000U                             /* system control space */
+#define SIM_DWT_BASE                0xE0001000U
+#define SIM_NVIC_ISER               0x100U                                  /* SCS offsets */
+#define SIM_NVIC_ICER               0x180U
+#define SIM_NVIC_ISPR               0x200U
+#define SIM_NVIC_ICPR               0x280U
+#define SIM_NVIC_IABR               0x300U
+#define SIM_NVIC_IP                 0x400U
+#define SIM_NVIC_WORDS              ((SIM_IRQ_NUM + 31U) / 32U)
+#define SIM_EXC_NUM                 (SIM_IRQ_NUM + 16U)                     /* exception numbers: IRQn + 16 */
+#define SIM_THREAD_PRIORITY         0x100U                                  /* below every exception */
+
+typedef void (*sim_handler_func)(void);
+
+/*!
+    \brief write completed by the next access
+    \note  The bus hook runs before the store, so a register write reaches its
+           model when the next access (or the end of the handler) shows that
+           the store is done.
+*/
+typedef struct
+{
+    sim_model_struct *model;
+    uint32_t addr;
+    uint32_t size;
+    uint32_t old;
+} sim_pending_struct;
+
+static sim_model_struct *s_sim_models = NULL;
+static sim_model_struct *s_sim_last = NULL;                                 /* last model hit, most accesses repeat */
+static uint64_t s_sim_cycles = 0;
+static uint64_t s_sim_next_event = SIM_NEVER;                               /* earliest next_event of all models */
+static sim_pending_struct s_sim_pending;
+static sim_stats_struct s_sim_stats;
+static uint8_t s_sim_ready = 0;
+
+/* core state */
+static uint8_t s_sim_enabled[SIM_EXC_NUM];
+static uint8_t s_sim_pend[SIM_EXC_NUM];
+static uint8_t s_sim_level[SIM_EXC_NUM];                                    /* level-sensitive line driven by a model */
+static uint8_t s_sim_active[SIM_EXC_NUM];
+static uint32_t s_sim_primask = 0;
+static uint32_t s_sim_basepri = 0;
+static uint32_t s_sim_exec_exc = 0;                                         /* running exception number, 0 in thread mode */
+static uint32_t s_sim_exec_priority = SIM_THREAD_PRIORITY;
+static uint8_t s_sim_irq_any = 0;                                           /* some line is pending */
+
+/* SysTick and DWT */
+static uint64_t s_sim_systick_origin = 0;                                   /* cycle at which VAL was LOAD */
+static uint64_t s_sim_systick_wraps = 0;                                    /* wraps seen by the last CTRL read */
+static uint64_t s_sim_dwt_origin = 0;
+
+sim_handler_func sim_vector_get(uint32_t exception);                        /* sim_vectors.c */
+
+uint32_t SystemCoreClock = SIM_CORE_HZ;                                     /* USER/system_gd32h7xx.c is not part of the host build */
+
+/*!
+    \brief      map one fixed window
+    \param[in]  base: target address
+    \param[in]  size: window size
+    \param[in]  fill: initial byte value
+    \param[out] none
+    \retval     none
+*/
+static void sim_map(uint32_t base, uint32_t size, uint8_t fill)
+{
+    void *p = mmap((void *)(uintptr_t)base, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | MAP_NORESERVE, -1, 0);
+
+    if(p != (void *)(uintptr_t)base)
+    {
+        fprintf(stderr, "sim: cannot map 0x%08X, build with -no-pie\n", (unsigned)base);
+        exit(2);
+    }
+    if(fill != 0U)
+    {
+        memset(p, fill, size);
+    }
+}
+
+/*!
+    \brief      find the model owning an address
+    \param[in]  addr: bus address
+    \param[out] none
+    \retval     model, NULL for plain memory
+*/
+static sim_model_struct *sim_model_find(uint32_t addr)
+{
+    sim_model_struct *m;
+
+    if((s_sim_last != NULL) && (addr - s_sim_last->base < s_sim_last->size))
+    {
+        return s_sim_last;
+    }
+    for(m = s_sim_models; m != NULL; m = m->next)
+    {
+        if(addr - m->base < m->size)
+        {
+            s_sim_last = m;
+            return m;
+        }
+    }
+    return NULL;
+}
+
+/*!
+    \brief      load a little-endian value of 1 to 4 bytes
+    \param[in]  addr: bus address
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     value
+*/
+static uint32_t sim_load(uint32_t addr, uint32_t size)
+{
+    switch(size)
+    {
+        case 1: return SIM_REG8(addr);
+        case 2: return SIM_REG16(addr);
+        default: return SIM_REG32(addr);
+    }
+}
+
+/*!
+    \brief      store a value of 1 to 4 bytes
+    \param[in]  addr: bus address
+    \param[in]  size: bytes
+    \param[in]  value: value
+    \param[out] none
+    \retval     none
+*/
+static void sim_store(uint32_t addr, uint32_t size, uint32_t value)
+{
+    switch(size)
+    {
+        case 1: SIM_REG8(addr) = (uint8_t)value; break;
+        case 2: SIM_REG16(addr) = (uint16_t)value; break;
+        default: SIM_REG32(addr) = value; break;
+    }
+}
+
+/*!
+    \brief      hand the pending CPU write to its model
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void sim_write_complete(void)
+{
+    sim_pending_struct w = s_sim_pending;
+
+    if(w.model != NULL)
+    {
+        s_sim_pending.model = NULL;
+        w.model->write(w.model, w.addr - w.model->base, w.size, w.old);
+    }
+}
+
+/*!
+    \brief      recompute the earliest scheduled event
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void sim_next_event_update(void)
+{
+    sim_model_struct *m;
+
+    s_sim_next_event = SIM_NEVER;
+    for(m = s_sim_models; m != NULL; m = m->next)
+    {
+        if(m->next_event < s_sim_next_event)
+        {
+            s_sim_next_event = m->next_event;
+        }
+    }
+}
+
+/*!
+    \brief      priority of an exception
+    \param[in]  exception: exception number
+    \param[out] none
+    \retval     priority byte as stored in NVIC_IPR or SHPR, 0 for faults
+*/
+static uint32_t sim_priority(uint32_t exception)
+{
+    if(exception >= 16U)
+    {
+        return SIM_REG8(SIM_SCS_BASE + SIM_NVIC_IP + exception - 16U) & 0xF0U;
+    }
+    if(exception >= 4U)
+    {
+        return SIM_REG8(SIM_SCS_BASE + 0xD18U + exception - 4U) & 0xF0U;    /* SCB->SHPR */
+    }
+    return 0U;
+}
+
+/*!
+    \brief      run every pending interrupt that may preempt the running code
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Handlers run nested on the host stack. A level-sensitive line
+                that is still high after its handler pends again.
+*/
+static void sim_irq_dispatch(void)
+{
+    uint32_t e, best, best_priority, priority, saved_exc, saved_priority, mask;
+    sim_handler_func handler;
+
+    while(s_sim_irq_any && !s_sim_primask)
+    {
+        best = 0U;
+        best_priority = SIM_THREAD_PRIORITY;
+        mask = (s_sim_basepri != 0U) ? (s_sim_basepri & 0xF0U) : SIM_THREAD_PRIORITY;
+        s_sim_irq_any = 0;
+        for(e = 2U; e < SIM_EXC_NUM; e++)
+        {
+            if(!s_sim_pend[e])
+            {
+                continue;
+            }
+            s_sim_irq_any = 1;
+            priority = sim_priority(e);
+            if(s_sim_enabled[e] && !s_sim_active[e] && (priority < best_priority))
+            {
+                best = e;
+                best_priority = priority;
+            }
+        }
+        if((best == 0U) || (best_priority >= s_sim_exec_priority) || (best_priority >= mask))
+        {
+            return;
+        }
+
+        s_sim_pend[best] = 0;
+        s_sim_active[best] = 1;
+        saved_exc = s_sim_exec_exc;
+        saved_priority = s_sim_exec_priority;
+        s_sim_exec_exc = best;
+        s_sim_exec_priority = best_priority;
+        s_sim_stats.irqs++;
+        s_sim_cycles += 12U;                                                /* exception entry */
+
+        handler = sim_vector_get(best);
+        if(handler != NULL)
+        {
+            handler();
+            sim_write_complete();
+        }
+        else
+        {
+            fprintf(stderr, "sim: no handler for exception %u\n", (unsigned)best);
+            s_sim_enabled[best] = 0;
+        }
+
+        s_sim_cycles += 10U;                                                /* exception return */
+        s_sim_exec_exc = saved_exc;
+        s_sim_exec_priority = saved_priority;
+        s_sim_active[best] = 0;
+        if(s_sim_level[best])
+        {
+            s_sim_pend[best] = 1;
+        }
+        s_sim_irq_any = 1;
+    }
+}
+
+/*!
+    \brief      advance the clock to a cycle, running events and interrupts on the way
+    \param[in]  target: virtual cycle
+    \param[out] none
+    \retval     none
+*/
+static void sim_advance_to(uint64_t target)
+{
+    sim_model_struct *m, *first;
+
+    while(s_sim_next_event <= target)
+    {
+        first = NULL;
+        for(m = s_sim_models; m != NULL; m = m->next)
+        {
+            if((m->next_event <= target) && ((first == NULL) || (m->next_event < first->next_event)))
+            {
+                first = m;
+            }
+        }
+        if(first == NULL)
+        {
+            break;
+        }
+        if(first->next_event > s_sim_cycles)
+        {
+            s_sim_cycles = first->next_event;
+        }
+        first->next_event = SIM_NEVER;
+        first->event(first, s_sim_cycles);
+        s_sim_stats.events++;
+        sim_next_event_update();
+        sim_irq_dispatch();
+    }
+    if(s_sim_cycles < target)
+    {
+        s_sim_cycles = target;
+    }
+    sim_irq_dispatch();
+}
+
+/*!
+    \brief      bus hook of one volatile access
+    \param[in]  addr: accessed address
+    \param[in]  size: bytes
+    \param[in]  write: 1 for a store
+    \param[out] none
+    \retval     none
+*/
+static void sim_access(uintptr_t addr, uint32_t size, uint8_t write)
+{
+    sim_model_struct *m = NULL;
+
+    if(!s_sim_ready)
+    {
+        return;
+    }
+    sim_write_complete();
+    s_sim_stats.accesses++;
+    sim_advance_to(s_sim_cycles + SIM_ACCESS_CYCLES);
+
+    if((addr >> 32) == 0U)
+    {
+        m = sim_model_find((uint32_t)addr);
+    }
+    if(m == NULL)
+    {
+        return;
+    }
+    s_sim_stats.register_accesses++;
+    m->accesses++;
+    if(write)
+    {
+        if(m->write != NULL)
+        {
+            s_sim_pending.model = m;
+            s_sim_pending.addr = (uint32_t)addr;
+            s_sim_pending.size = size;
+            s_sim_pending.old = sim_load((uint32_t)addr, size);
+        }
+    }
+    else if(m->read != NULL)
+    {
+        m->read(m, (uint32_t)addr - m->base, size);
+    }
+}
+
+/* hooks called by code built with -fsanitize=thread --param tsan-distinguish-volatile=1 */
+void __tsan_volatile_read1(void *addr)  { sim_access((uintptr_t)addr, 1U, 0U); }
+void __tsan_volatile_read2(void *addr)  { sim_access((uintptr_t)addr, 2U, 0U); }
+void __tsan_volatile_read4(void *addr)  { sim_access((uintptr_t)addr, 4U, 0U); }
+void __tsan_volatile_read8(void *addr)  { sim_access((uintptr_t)addr, 4U, 0U); }
+void __tsan_volatile_read16(void *addr) { sim_access((uintptr_t)addr, 4U, 0U); }
+void __tsan_volatile_write1(void *addr) { sim_access((uintptr_t)addr, 1U, 1U); }
+void __tsan_volatile_write2(void *addr) { sim_access((uintptr_t)addr, 2U, 1U); }
+void __tsan_volatile_write4(void *addr) { sim_access((uintptr_t)addr, 4U, 1U); }
+void __tsan_volatile_write8(void *addr) { sim_access((uintptr_t)addr, 4U, 1U); }
+void __tsan_volatile_write16(void *addr) { sim_access((uintptr_t)addr, 4U, 1U); }
+void __tsan_unaligned_volatile_read2(void *addr)  { sim_access((uintptr_t)addr, 2U, 0U); }
+void __tsan_unaligned_volatile_read4(void *addr)  { sim_access((uintptr_t)addr, 4U, 0U); }
+void __tsan_unaligned_volatile_read8(void *addr)  { sim_access((uintptr_t)addr, 4U, 0U); }
+void __tsan_unaligned_volatile_write2(void *addr) { sim_access((uintptr_t)addr, 2U, 1U); }
+void __tsan_unaligned_volatile_write4(void *addr) { sim_access((uintptr_t)addr, 4U, 1U); }
+void __tsan_unaligned_volatile_write8(void *addr) { sim_access((uintptr_t)addr, 4U, 1U); }
+
+/*!
+    \brief      number of SysTick wraps up to a cycle
+    \param[in]  now: virtual cycle
+    \param[out] none
+    \retval     times the counter reached 0
+*/
+static uint64_t sim_systick_wraps(uint64_t now)
+{
+    uint64_t period = (uint64_t)(SysTick->LOAD & 0xFFFFFFU) + 1U;
+    uint64_t div = (SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk) ? 1U : 8U;
+
+    return ((now - s_sim_systick_origin) / div + 1U) / period;
+}
+
+/*!
+    \brief      schedule the next SysTick interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void sim_systick_schedule(void)
+{
+    uint64_t period = (uint64_t)(SysTick->LOAD & 0xFFFFFFU) + 1U;
+    uint64_t div = (SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk) ? 1U : 8U;
+    uint64_t next = sim_systick_wraps(s_sim_cycles) + 1U;
+
+    if((SysTick->CTRL & (SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk)) == (SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk))
+    {
+        sim_schedule(&g_sim_core, s_sim_systick_origin + (next * period - 1U) * div);
+    }
+    else
+    {
+        sim_schedule(&g_sim_core, SIM_NEVER);
+    }
+}
+
+/*!
+    \brief      core model reset: NVIC, SysTick and SCB reset values
+    \param[in]  model: core model
+    \param[out] none
+    \retval     none
+*/
+static void sim_core_reset(sim_model_struct *model)
+{
+    memset((void *)(uintptr_t)model->base, 0, model->size);
+    memset(s_sim_enabled, 0, sizeof(s_sim_enabled));
+    memset(s_sim_pend, 0, sizeof(s_sim_pend));
+    memset(s_sim_level, 0, sizeof(s_sim_level));
+    memset(s_sim_active, 0, sizeof(s_sim_active));
+    s_sim_enabled[SysTick_IRQn + 16] = 1;                                   /* system exceptions are always enabled */
+    s_sim_enabled[PendSV_IRQn + 16] = 1;
+    s_sim_enabled[SVCall_IRQn + 16] = 1;
+    SIM_REG32(&SCB->CPUID) = 0x411FC272U;                                   /* Cortex-M7 r1p2 */
+    SCB->AIRCR = 0xFA050000U;
+    s_sim_systick_origin = 0;
+    s_sim_systick_wraps = 0;
+    s_sim_primask = 0;
+    s_sim_basepri = 0;
+    s_sim_exec_exc = 0;
+    s_sim_exec_priority = SIM_THREAD_PRIORITY;
+    s_sim_irq_any = 0;
+    model->next_event = SIM_NEVER;
+}
+
+/*!
+    \brief      core model read: SysTick counter and COUNTFLAG
+    \param[in]  model: core model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     none
+*/
+static void sim_core_read(sim_model_struct *model, uint32_t offset, uint32_t size)
+{
+    uint64_t period, div, ticks, wraps;
+
+    (void)model;
+    (void)size;
+    if((offset < 0x10U) || (offset > 0x18U) || !(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk))
+    {
+        return;
+    }
+    period = (uint64_t)(SysTick->LOAD & 0xFFFFFFU) + 1U;
+    div = (SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk) ? 1U : 8U;
+    ticks = (s_sim_cycles - s_sim_systick_origin) / div;
+    SysTick->VAL = (uint32_t)(period - 1U - (ticks % period));
+    if(offset == 0x10U)
+    {
+        wraps = sim_systick_wraps(s_sim_cycles);
+        if(wraps != s_sim_systick_wraps)
+        {
+            SysTick->CTRL |= SysTick_CTRL_COUNTFLAG_Msk;                    /* cleared again on the next write or read */
+            s_sim_systick_wraps = wraps;
+        }
+        else
+        {
+            SysTick->CTRL &= ~SysTick_CTRL_COUNTFLAG_Msk;
+        }
+    }
+}
+
+/*!
+    \brief      core model write: NVIC set/clear registers and SysTick
+    \param[in]  model: core model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[in]  old: previous register content
+    \param[out] none
+    \retval     none
+*/
+static void sim_core_write(sim_model_struct *model, uint32_t offset, uint32_t size, uint32_t old)
+{
+    uint32_t reg, value, word, bit, e;
+
+    (void)size;
+    reg = offset & ~3U;
+    value = SIM_REG32(model->base + reg);
+    if((reg >= SIM_NVIC_ISER) && (reg < SIM_NVIC_IABR))
+    {
+        word = (reg & 0x7FU) / 4U;
+        if(word >= SIM_NVIC_WORDS)
+        {
+            return;
+        }
+        for(bit = 0; bit < 32U; bit++)
+        {
+            e = word * 32U + bit + 16U;
+            if(!(value & (1UL << bit)) || (e >= SIM_EXC_NUM))
+            {
+                continue;
+            }
+            switch(reg & ~0x7FU)
+            {
+                case SIM_NVIC_ISER: s_sim_enabled[e] = 1; break;
+                case SIM_NVIC_ICER: s_sim_enabled[e] = 0; break;
+                case SIM_NVIC_ISPR: s_sim_pend[e] = 1; s_sim_irq_any = 1; break;
+                default:            s_sim_pend[e] = 0; break;
+            }
+        }
+        /* set and clear registers read back the state */
+        for(bit = 0, value = 0; bit < 32U; bit++)
+        {
+            e = word * 32U + bit + 16U;
+            if((e < SIM_EXC_NUM) && (((reg < SIM_NVIC_ISPR) ? s_sim_enabled[e] : s_sim_pend[e]) != 0U))
+            {
+                value |= 1UL << bit;
+            }
+        }
+        SIM_REG32(model->base + SIM_NVIC_ISER + word * 4U) = (reg < SIM_NVIC_ISPR) ? value : SIM_REG32(model->base + SIM_NVIC_ISER + word * 4U);
+        SIM_REG32(model->base + SIM_NVIC_ICER + word * 4U) = SIM_REG32(model->base + SIM_NVIC_ISER + word * 4U);
+        if(reg >= SIM_NVIC_ISPR)
+        {
+            SIM_REG32(model->base + SIM_NVIC_ISPR + word * 4U) = value;
+            SIM_REG32(model->base + SIM_NVIC_ICPR + word * 4U) = value;
+        }
+        return;
+    }
+
+    switch(reg)
+    {
+        case 0x10U:                                                         /* SysTick CTRL */
+            if((value & SysTick_CTRL_ENABLE_Msk) && !(old & SysTick_CTRL_ENABLE_Msk))
+            {
+                s_sim_systick_origin = s_sim_cycles;
+                s_sim_systick_wraps = 0;
+            }
+            sim_systick_schedule();
+            break;
+        case 0x14U:                                                         /* SysTick LOAD */
+            sim_systick_schedule();
+            break;
+        case 0x18U:                                                         /* SysTick VAL: any write clears it, reload on the next tick */
+            SysTick->VAL = 0U;
+            s_sim_systick_origin = s_sim_cycles - (uint64_t)(SysTick->LOAD & 0xFFFFFFU) * ((SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk) ? 1U : 8U);
+            s_sim_systick_wraps = sim_systick_wraps(s_sim_cycles);
+            sim_systick_schedule();
+            break;
+        case 0xD04U:                                                        /* SCB ICSR: PendSV and SysTick set/clear */
+            if(value & SCB_ICSR_PENDSVSET_Msk)  { s_sim_pend[PendSV_IRQn + 16] = 1; s_sim_irq_any = 1; }
+            if(value & SCB_ICSR_PENDSVCLR_Msk)  { s_sim_pend[PendSV_IRQn + 16] = 0; }
+            if(value & SCB_ICSR_PENDSTSET_Msk)  { s_sim_pend[SysTick_IRQn + 16] = 1; s_sim_irq_any = 1; }
+            if(value & SCB_ICSR_PENDSTCLR_Msk)  { s_sim_pend[SysTick_IRQn + 16] = 0; }
+            SCB->ICSR = s_sim_exec_exc;
+            break;
+        case 0xD0CU:                                                        /* SCB AIRCR: keep PRIGROUP, read back the key */
+            SCB->AIRCR = 0xFA050000U | (value & SCB_AIRCR_PRIGROUP_Msk);
+            break;
+        case 0xF00U:                                                        /* NVIC STIR */
+            e = (value & 0x1FFU) + 16U;
+            if(e < SIM_EXC_NUM)
+            {
+                s_sim_pend[e] = 1;
+                s_sim_irq_any = 1;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/*!
+    \brief      SysTick interrupt event
+    \param[in]  model: core model
+    \param[in]  now: virtual cycle
+    \param[out] none
+    \retval     none
+*/
+static void sim_core_event(sim_model_struct *model, uint64_t now)
+{
+    (void)model;
+    (void)now;
+    s_sim_pend[SysTick_IRQn + 16] = 1;
+    s_sim_irq_any = 1;
+    sim_systick_schedule();
+}
+
+sim_model_struct g_sim_core = {"core", SIM_SCS_BASE, 0x1000U, sim_core_reset, sim_core_read, sim_core_write, sim_core_event, SIM_NEVER, NULL, 0, NULL};
+
+/*!
+    \brief      DWT read: CYCCNT follows the virtual clock
+    \param[in]  model: DWT model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     none
+*/
+static void sim_dwt_read(sim_model_struct *model, uint32_t offset, uint32_t size)
+{
+    (void)size;
+    if(offset == 0x004U)
+    {
+        SIM_REG32(model->base + 0x004U) = (uint32_t)(s_sim_cycles - s_sim_dwt_origin);
+    }
+}
+
+/*!
+    \brief      DWT write: a CYCCNT write sets the count
+    \param[in]  model: DWT model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[in]  old: previous register content
+    \param[out] none
+    \retval     none
+*/
+static void sim_dwt_write(sim_model_struct *model, uint32_t offset, uint32_t size, uint32_t old)
+{
+    (void)size;
+    (void)old;
+    if(offset == 0x004U)
+    {
+        s_sim_dwt_origin = s_sim_cycles - SIM_REG32(model->base + 0x004U);
+    }
+}
+
+/*!
+    \brief      DWT reset
+    \param[in]  model: DWT model
+    \param[out] none
+    \retval     none
+*/
+static void sim_dwt_reset(sim_model_struct *model)
+{
+    memset((void *)(uintptr_t)model->base, 0, model->size);
+    SIM_REG32(model->base) = 0x40000000U;                                   /* DWT_CTRL.NUMCOMP = 4 */
+    s_sim_dwt_origin = 0;
+}
+
+static sim_model_struct s_sim_dwt = {"dwt", SIM_DWT_BASE, 0x1000U, sim_dwt_reset, sim_dwt_read, sim_dwt_write, NULL, SIM_NEVER, NULL, 0, NULL};
+
+/*!
+    \brief      add a model to the bus
+    \param[in]  model: model with its window, handlers and state
+    \param[out] none
+    \retval     none
+*/
+void sim_model_register(sim_model_struct *model)
+{
+    model->next = s_sim_models;
+    s_sim_models = model;
+}
+
+/*!
+    \brief      map the windows, register and reset every model
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Call first in main, before any BSP function.
+*/
+void sim_init(void)
+{
+    sim_map(SIM_FLASH_BASE, SIM_FLASH_SIZE, 0xFFU);
+    sim_map(SIM_PERIPH_BASE, SIM_PERIPH_SIZE, 0U);
+    sim_map(SIM_PPB_BASE, SIM_PPB_SIZE, 0U);
+    sim_model_register(&g_sim_core);
+    sim_model_register(&s_sim_dwt);
+    sim_models_register();
+    sim_reset();
+    s_sim_ready = 1;
+}
+
+/*!
+    \brief      reset the clock, the statistics and every model
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void sim_reset(void)
+{
+    sim_model_struct *m;
+
+    s_sim_pending.model = NULL;
+    s_sim_cycles = 0;
+    memset(&s_sim_stats, 0, sizeof(s_sim_stats));
+    for(m = s_sim_models; m != NULL; m = m->next)
+    {
+        m->next_event = SIM_NEVER;
+        m->accesses = 0;
+        if(m->reset != NULL)
+        {
+            m->reset(m);
+        }
+    }
+    sim_next_event_update();
+}
+
+/*!
+    \brief      reset the model at a register window, for the RCU reset bits
+    \param[in]  base: first register of the model
+    \param[out] none
+    \retval     none
+*/
+void sim_model_reset(uint32_t base)
+{
+    sim_model_struct *m;
+
+    for(m = s_sim_models; m != NULL; m = m->next)
+    {
+        if((m->base == base) && (m->reset != NULL))
+        {
+            m->next_event = SIM_NEVER;
+            m->reset(m);
+        }
+    }
+    sim_next_event_update();
+}
+
+/*!
+    \brief      set the next event of a model
+    \param[in]  model: model
+    \param[in]  when: virtual cycle, SIM_NEVER to cancel
+    \param[out] none
+    \retval     none
+*/
+void sim_schedule(sim_model_struct *model, uint64_t when)
+{
+    model->next_event = when;
+    if(when < s_sim_next_event)
+    {
+        s_sim_next_event = when;
+    }
+    else
+    {
+        sim_next_event_update();
+    }
+}
+
+/*!
+    \brief      virtual core cycles since sim_reset
+    \param[in]  none
+    \param[out] none
+    \retval     cycles
+*/
+uint64_t sim_cycles(void)
+{
+    return s_sim_cycles;
+}
+
+/*!
+    \brief      virtual time since sim_reset
+    \param[in]  none
+    \param[out] none
+    \retval     microseconds
+*/
+uint64_t sim_time_us(void)
+{
+    return s_sim_cycles / (SIM_CORE_HZ / 1000000U);
+}
+
+/*!
+    \brief      convert kernel clock ticks to core cycles
+    \param[in]  periph_ticks: ticks of SIM_PERIPH_HZ
+    \param[out] none
+    \retval     core cycles, rounded up
+*/
+uint64_t sim_periph_cycles(uint64_t periph_ticks)
+{
+    return (uint64_t)(((unsigned __int128)periph_ticks * SIM_CORE_HZ + SIM_PERIPH_HZ - 1U) / SIM_PERIPH_HZ);
+}
+
+/*!
+    \brief      convert core cycles to elapsed kernel clock ticks
+    \param[in]  cycles: core cycles
+    \param[out] none
+    \retval     whole ticks of SIM_PERIPH_HZ
+*/
+uint64_t sim_periph_ticks(uint64_t cycles)
+{
+    return (uint64_t)(((unsigned __int128)cycles * SIM_PERIPH_HZ) / SIM_CORE_HZ);
+}
+
+/*!
+    \brief      let virtual time pass with the CPU idle
+    \param[in]  us: microseconds
+    \param[out] none
+    \retval     none
+    \note       Events and interrupt handlers run at their time; handlers that
+                wait on hardware advance the clock further.
+*/
+void sim_run_us(uint32_t us)
+{
+    sim_write_complete();
+    sim_advance_to(s_sim_cycles + (uint64_t)us * (SIM_CORE_HZ / 1000000U));
+}
+
+/*!
+    \brief      let virtual time pass until a flag is set
+    \param[in]  flag: flag set by a handler
+    \param[in]  timeout_us: longest wait
+    \param[out] none
+    \retval     none
+*/
+void sim_run_until(volatile uint8_t *flag, uint32_t timeout_us)
+{
+    uint64_t end = s_sim_cycles + (uint64_t)timeout_us * (SIM_CORE_HZ / 1000000U);
+
+    sim_write_complete();
+    while(!*flag && (s_sim_cycles < end))
+    {
+        sim_advance_to(((s_sim_next_event < end) && (s_sim_next_event > s_sim_cycles)) ? s_sim_next_event : ((s_sim_next_event <= s_sim_cycles) ? s_sim_cycles + 1U : end));
+    }
+}
+
+/*!
+    \brief      WFI/WFE: skip to the next event
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void sim_wfi(void)
+{
+    sim_write_complete();
+    s_sim_stats.wfi++;
+    if(s_sim_next_event != SIM_NEVER)
+    {
+        sim_advance_to((s_sim_next_event > s_sim_cycles) ? s_sim_next_event : s_sim_cycles + 1U);
+    }
+}
+
+/*!
+    \brief      copy statistics
+    \param[in]  none
+    \param[out] stats: cycles, accesses, events and interrupts
+    \retval     none
+*/
+void sim_stats_get(sim_stats_struct *stats)
+{
+    *stats = s_sim_stats;
+    stats->cycles = s_sim_cycles;
+}
+
+/*!
+    \brief      drive a level-sensitive interrupt line
+    \param[in]  irqn: IRQn_Type value
+    \param[in]  level: 1 while the peripheral requests
+    \param[out] none
+    \retval     none
+    \note       A high line pends the interrupt, and pends it again after the
+                handler returns until the handler clears the source.
+*/
+void sim_irq_set(int32_t irqn, uint8_t level)
+{
+    uint32_t e = (uint32_t)(irqn + 16);
+
+    if(e >= SIM_EXC_NUM)
+    {
+        return;
+    }
+    s_sim_level[e] = level;
+    if(level && !s_sim_active[e])
+    {
+        s_sim_pend[e] = 1;
+        s_sim_irq_any = 1;
+    }
+    else if(!level && !s_sim_active[e])
+    {
+        s_sim_pend[e] = 0;
+    }
+}
+
+/*!
+    \brief      pend an interrupt once
+    \param[in]  irqn: IRQn_Type value
+    \param[out] none
+    \retval     none
+*/
+void sim_irq_pulse(int32_t irqn)
+{
+    uint32_t e = (uint32_t)(irqn + 16);
+
+    if(e < SIM_EXC_NUM)
+    {
+        s_sim_pend[e] = 1;
+        s_sim_irq_any = 1;
+    }
+}
+
+/*!
+    \brief      PRIMASK read
+    \param[in]  none
+    \param[out] none
+    \retval     PRIMASK
+*/
+uint32_t sim_primask_get(void)
+{
+    return s_sim_primask;
+}
+
+/*!
+    \brief      PRIMASK write, unmasking runs the pending interrupts
+    \param[in]  primask: 1 to mask
+    \param[out] none
+    \retval     none
+*/
+void sim_primask_set(uint32_t primask)
+{
+    s_sim_primask = primask & 1U;
+    if(!s_sim_primask && s_sim_ready)
+    {
+        sim_write_complete();
+        sim_irq_dispatch();
+    }
+}
+
+/*!
+    \brief      BASEPRI read
+    \param[in]  none
+    \param[out] none
+    \retval     BASEPRI
+*/
+uint32_t sim_basepri_get(void)
+{
+    return s_sim_basepri;
+}
+
+/*!
+    \brief      BASEPRI write
+    \param[in]  basepri: priority mask, 0 for none
+    \param[out] none
+    \retval     none
+*/
+void sim_basepri_set(uint32_t basepri)
+{
+    s_sim_basepri = basepri;
+    if(s_sim_ready)
+    {
+        sim_write_complete();
+        sim_irq_dispatch();
+    }
+}
+
+/*!
+    \brief      IPSR read
+    \param[in]  none
+    \param[out] none
+    \retval     running exception number, 0 in thread mode
+*/
+uint32_t sim_ipsr_get(void)
+{
+    return s_sim_exec_exc;
+}
+
+/*!
+    \brief      CPU bus access from a model (DMA), with the target model's handlers
+    \param[in]  addr: bus address
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     value
+*/
+uint32_t sim_bus_read(uint32_t addr, uint32_t size)
+{
+    sim_model_struct *m = sim_model_find(addr);
+
+    if((m != NULL) && (m->read != NULL))
+    {
+        m->read(m, addr - m->base, size);
+    }
+    return sim_load(addr, size);
+}
+
+/*!
+    \brief      bus write from a model (DMA), with the target model's handlers
+    \param[in]  addr: bus address
+    \param[in]  size: bytes
+    \param[in]  value: value
+    \param[out] none
+    \retval     none
+*/
+void sim_bus_write(uint32_t addr, uint32_t size, uint32_t value)
+{
+    sim_model_struct *m = sim_model_find(addr);
+    uint32_t old = 0;
+
+    if(m != NULL)
+    {
+        old = sim_load(addr, size);
+    }
+    sim_store(addr, size, value);
+    if((m != NULL) && (m->write != NULL))
+    {
+        m->write(m, addr - m->base, size, old);
+    }
+}
@@ -0,0 +1,125 @@
+/*!
+    \file       sim.h
+    \brief      header file for the host-side peripheral simulation
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Virtual clock, interrupt controller and register bus of the host build
+    - Model interface for the simulated peripherals (register window, read and
+      write handlers, scheduled events)
+    - DMA request lines shared between the USART, CAU and DMA models
+    - Test API: run virtual time, inject and capture USART bytes, statistics
+*/
+
+#ifndef __SIM_H
+#define __SIM_H
+#include <stdint.h>
+
+/*!
+    \brief simulation configuration macros
+*/
+#define SIM_CORE_HZ                 600000000U                              /*!< virtual core clock, DWT_CYCCNT rate */
+#define SIM_PERIPH_HZ               64000000U                               /*!< kernel clock of every model: the RCU reset state runs all buses from IRC64M */
+#define SIM_ACCESS_CYCLES           2U                                      /*!< core cycles charged per volatile access */
+#define SIM_IRQ_NUM                 224U                                    /*!< NVIC lines, covers every IRQn of gd32h7xx.h */
+#define SIM_NEVER                   UINT64_MAX                              /*!< next_event value of an idle model */
+
+#define SIM_FLASH_BASE              0x08000000U                             /*!< internal flash window */
+#define SIM_FLASH_SIZE              0x003C0000U                             /*!< 3840 KB */
+#define SIM_PERIPH_BASE             0x40000000U                             /*!< APB, AHB and FMC register window */
+#define SIM_PERIPH_SIZE             0x20000000U
+#define SIM_PPB_BASE                0xE0000000U                             /*!< Cortex-M7 private peripheral bus */
+#define SIM_PPB_SIZE                0x00100000U
+
+/*!
+    \brief peripheral model: a register window with access handlers
+    \note  Registers live in the mapped window, so the firmware library and the
+           BSP access them unchanged. A handler runs before the CPU reads a
+           register (to refresh it) and after the CPU wrote one (to act on it,
+           with the previous content in old).
+*/
+typedef struct sim_model
+{
+    const char *name;                                                       /*!< for statistics */
+    uint32_t base;                                                          /*!< first register */
+    uint32_t size;                                                          /*!< window size in bytes */
+    void (*reset)(struct sim_model *model);                                 /*!< write reset values, clear the state */
+    void (*read)(struct sim_model *model, uint32_t offset, uint32_t size);  /*!< refresh before a read, may be NULL */
+    void (*write)(struct sim_model *model, uint32_t offset, uint32_t size, uint32_t old); /*!< act on a write, may be NULL */
+    void (*event)(struct sim_model *model, uint64_t now);                   /*!< scheduled event, may be NULL */
+    uint64_t next_event;                                                    /*!< cycle of the next event, SIM_NEVER if none */
+    void *state;                                                            /*!< model private state */
+    uint32_t accesses;                                                      /*!< CPU register accesses */
+    struct sim_model *next;
+} sim_model_struct;
+
+/*!
+    \brief simulation statistics
+*/
+typedef struct
+{
+    uint64_t cycles;                                                        /*!< virtual core cycles */
+    uint64_t accesses;                                                      /*!< volatile accesses seen by the bus hook */
+    uint64_t register_accesses;                                             /*!< of those, accesses to a model window */
+    uint64_t events;                                                        /*!< model events run */
+    uint64_t irqs;                                                          /*!< interrupt handlers dispatched */
+    uint64_t wfi;                                                           /*!< WFI/WFE skipped to the next event */
+} sim_stats_struct;
+
+/* register access from the models, never hooked */
+#define SIM_REG32(addr)             (*(uint32_t *)(uintptr_t)(addr))
+#define SIM_REG16(addr)             (*(uint16_t *)(uintptr_t)(addr))
+#define SIM_REG8(addr)              (*(uint8_t *)(uintptr_t)(addr))
+
+/* core */
+void sim_init(void);                                                                    /*!< map the windows and reset every model */
+void sim_reset(void);                                                                   /*!< reset models, NVIC and clock */
+void sim_model_register(sim_model_struct *model);                                       /*!< add a model to the bus */
+void sim_model_reset(uint32_t base);                                                    /*!< reset the model at a register window */
+void sim_schedule(sim_model_struct *model, uint64_t when);                              /*!< set the next event of a model */
+uint64_t sim_cycles(void);                                                              /*!< virtual core cycles */
+uint64_t sim_time_us(void);                                                             /*!< virtual time */
+uint64_t sim_periph_cycles(uint64_t periph_ticks);                                      /*!< kernel clock ticks in core cycles */
+uint64_t sim_periph_ticks(uint64_t cycles);                                             /*!< core cycles in kernel clock ticks */
+void sim_run_us(uint32_t us);                                                           /*!< advance time, running events and interrupts */
+void sim_run_until(volatile uint8_t *flag, uint32_t timeout_us);                        /*!< advance time until a flag is set */
+void sim_wfi(void);                                                                     /*!< skip to the next event or interrupt */
+void sim_stats_get(sim_stats_struct *stats);                                            /*!< copy statistics */
+uint32_t sim_bus_read(uint32_t addr, uint32_t size);                                    /*!< model-initiated read, e.g. by DMA */
+void sim_bus_write(uint32_t addr, uint32_t size, uint32_t value);                       /*!< model-initiated write */
+void sim_models_register(void);                                                         /*!< add the peripheral models, see sim_rcu.c */
+void sim_usart_register(void);                                                          /*!< add the USART models and their DMA requests */
+void sim_cau_register(void);                                                            /*!< add the CAU model and its DMA requests */
+
+/* interrupts */
+void sim_irq_set(int32_t irqn, uint8_t level);                                          /*!< drive an interrupt line, level sensitive */
+void sim_irq_pulse(int32_t irqn);                                                       /*!< pend an interrupt once */
+uint32_t sim_primask_get(void);                                                         /*!< core registers, see HOST/include/cmsis_gcc.h */
+void sim_primask_set(uint32_t primask);
+uint32_t sim_basepri_get(void);
+void sim_basepri_set(uint32_t basepri);
+uint32_t sim_ipsr_get(void);
+
+/* DMA request lines */
+typedef uint8_t (*sim_dma_request_func)(void *arg);                                     /*!< 1 while the peripheral requests */
+void sim_dma_request_register(uint32_t request, sim_dma_request_func active, void *arg); /*!< connect a DMAMUX request id */
+void sim_dma_kick(uint32_t request);                                                    /*!< the request went active */
+
+/* USART test API */
+void sim_usart_inject(uint32_t usart_periph, const void *data, uint32_t length);       /*!< bytes arriving on RX, at the line rate */
+uint32_t sim_usart_capture(uint32_t usart_periph, void *data, uint32_t size);           /*!< take the bytes sent on TX */
+
+/* model declarations */
+extern sim_model_struct g_sim_core;
+extern sim_model_struct g_sim_rcu;
+extern sim_model_struct g_sim_fmc;
+extern sim_model_struct g_sim_flash;
+extern sim_model_struct g_sim_crc;
+extern sim_model_struct g_sim_cau;
+extern sim_model_struct g_sim_hwsem;
+extern sim_model_struct g_sim_dma[2];
+extern sim_model_struct g_sim_usart[3];
+extern sim_model_struct g_sim_timer[6];
+#endif /* __SIM_H */
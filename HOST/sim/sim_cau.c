@@ -0,0 +1,627 @@
+/*!
+    \file       sim_cau.c
+    \brief      CAU model of the host build
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - AES-ECB, CBC, CTR and GCM with 128, 192 and 256-bit keys, one block
+      processed as soon as four words are in the IN FIFO and the OUT FIFO has
+      room; DES and TDES are not modelled
+    - IV registers updated block by block (CBC chaining value, CTR counter) so
+      cau_context_save and cau_context_restore carry the chaining state
+    - GCM prepare, AAD, payload and tag phases, NBPILB padding of the last
+      encrypted block, GHASH state kept in the context switch registers
+    - 8-word IN and OUT FIFOs, data swapping, FIFO flush, status flags and the
+      DMA requests (DMAIEN, DMAOEN)
+*/
+
+#include <string.h>
+#include "gd32h7xx.h"
+#include "gd32h7xx_cau.h"
+#include "gd32h7xx_dma.h"
+#include "sim.h"
+
+#define SIM_CAU_FIFO                8U                                      /* words per FIFO */
+#define SIM_CAU_KEY_OFFSET          0x20U                                   /* KEY0H */
+#define SIM_CAU_IV_OFFSET           0x40U                                   /* IV0H */
+#define SIM_CAU_GHASH_OFFSET        0x50U                                   /* GCMCCMCTXS0-3: GHASH accumulator */
+#define SIM_CAU_SUBKEY_OFFSET       0x70U                                   /* GCMCTXS0-3: hash subkey H */
+#define SIM_CAU_J0_OFFSET           0x80U                                   /* GCMCTXS4-7: pre-counter block J0 */
+
+/*!
+    \brief CAU model state
+*/
+typedef struct
+{
+    uint32_t in[SIM_CAU_FIFO];
+    uint32_t in_count;
+    uint32_t out[SIM_CAU_FIFO];
+    uint32_t out_count;
+    uint8_t sbox[256];                                                      /* built at reset */
+    uint8_t inv_sbox[256];
+} sim_cau_state_struct;
+
+static sim_cau_state_struct s_sim_cau;
+
+/*!
+    \brief      multiply by x in GF(2^8)
+    \param[in]  a: field element
+    \param[out] none
+    \retval     product
+*/
+static uint8_t sim_cau_xtime(uint8_t a)
+{
+    return (uint8_t)((a << 1) ^ ((a & 0x80U) ? 0x1BU : 0x00U));
+}
+
+/*!
+    \brief      multiply in GF(2^8)
+    \param[in]  a: field element
+    \param[in]  b: field element
+    \param[out] none
+    \retval     product
+*/
+static uint8_t sim_cau_mul(uint8_t a, uint8_t b)
+{
+    uint8_t r = 0U;
+
+    while(b != 0U)
+    {
+        r ^= (b & 1U) ? a : 0U;
+        a = sim_cau_xtime(a);
+        b >>= 1;
+    }
+    return r;
+}
+
+/*!
+    \brief      build the S-box from the field inverse and the affine map
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void sim_cau_sbox_build(void)
+{
+    uint32_t x, i;
+    uint8_t inv, s;
+
+    for(x = 0U; x < 256U; x++)
+    {
+        inv = (x == 0U) ? 0U : (uint8_t)x;
+        for(i = 0U; (x != 0U) && (i < 253U); i++)                           /* x^254 */
+        {
+            inv = sim_cau_mul(inv, (uint8_t)x);
+        }
+        s = inv ^ 0x63U;
+        for(i = 1U; i < 5U; i++)
+        {
+            s ^= (uint8_t)((inv << i) | (inv >> (8U - i)));
+        }
+        s_sim_cau.sbox[x] = s;
+        s_sim_cau.inv_sbox[s] = (uint8_t)x;
+    }
+}
+
+/*!
+    \brief      AES key expansion
+    \param[in]  key: key bytes
+    \param[in]  nk: key length in words, 4, 6 or 8
+    \param[out] rk: round keys, 16 * (nk + 7) bytes
+    \retval     none
+*/
+static void sim_cau_expand(const uint8_t *key, uint32_t nk, uint8_t *rk)
+{
+    uint32_t i, j;
+    uint8_t t[4], u, rcon = 1U;
+
+    memcpy(rk, key, 4U * nk);
+    for(i = nk; i < 4U * (nk + 7U); i++)
+    {
+        memcpy(t, &rk[4U * (i - 1U)], 4U);
+        if((i % nk) == 0U)
+        {
+            u = t[0];
+            t[0] = s_sim_cau.sbox[t[1]] ^ rcon;
+            t[1] = s_sim_cau.sbox[t[2]];
+            t[2] = s_sim_cau.sbox[t[3]];
+            t[3] = s_sim_cau.sbox[u];
+            rcon = sim_cau_xtime(rcon);
+        }
+        else if((nk > 6U) && ((i % nk) == 4U))
+        {
+            for(j = 0U; j < 4U; j++)
+            {
+                t[j] = s_sim_cau.sbox[t[j]];
+            }
+        }
+        for(j = 0U; j < 4U; j++)
+        {
+            rk[4U * i + j] = rk[4U * (i - nk) + j] ^ t[j];
+        }
+    }
+}
+
+/*!
+    \brief      encrypt or decrypt one block with the key registers
+    \param[in]  in: 16 bytes
+    \param[in]  decrypt: 1 for the inverse cipher
+    \param[out] out: 16 bytes, may equal in
+    \retval     none
+*/
+static void sim_cau_aes(const uint8_t *in, uint8_t decrypt, uint8_t *out)
+{
+    static const uint8_t nk_of[4] = {4U, 6U, 8U, 8U};
+    uint8_t key[32], rk[240], s[16], t[16], a[4];
+    uint32_t nk = nk_of[(CAU_CTL & CAU_CTL_KEYM) >> 8];
+    uint32_t nr = nk + 6U;
+    uint32_t round, r, c, i;
+
+    for(i = 0U; i < nk; i++)                                                /* key right-aligned in KEY0H..KEY3L */
+    {
+        r = SIM_REG32(CAU + SIM_CAU_KEY_OFFSET + 4U * (8U - nk + i));
+        key[4U * i] = (uint8_t)(r >> 24);
+        key[4U * i + 1U] = (uint8_t)(r >> 16);
+        key[4U * i + 2U] = (uint8_t)(r >> 8);
+        key[4U * i + 3U] = (uint8_t)r;
+    }
+    sim_cau_expand(key, nk, rk);
+
+    for(i = 0U; i < 16U; i++)
+    {
+        s[i] = in[i] ^ rk[(decrypt ? 16U * nr : 0U) + i];
+    }
+    for(round = 1U; round <= nr; round++)
+    {
+        for(r = 0U; r < 4U; r++)                                            /* (inverse) ShiftRows and SubBytes */
+        {
+            for(c = 0U; c < 4U; c++)
+            {
+                if(decrypt)
+                {
+                    t[r + 4U * ((c + r) % 4U)] = s_sim_cau.inv_sbox[s[r + 4U * c]];
+                }
+                else
+                {
+                    t[r + 4U * c] = s_sim_cau.sbox[s[r + 4U * ((c + r) % 4U)]];
+                }
+            }
+        }
+        for(i = 0U; decrypt && (i < 16U); i++)                              /* inverse cipher: key before InvMixColumns */
+        {
+            t[i] ^= rk[16U * (nr - round) + i];
+        }
+        if(round != nr)                                                     /* (inverse) MixColumns */
+        {
+            for(c = 0U; c < 4U; c++)
+            {
+                memcpy(a, &t[4U * c], 4U);
+                for(r = 0U; r < 4U; r++)
+                {
+                    t[4U * c + r] = decrypt ?
+                        (uint8_t)(sim_cau_mul(a[r], 14U) ^ sim_cau_mul(a[(r + 1U) % 4U], 11U) ^
+                                  sim_cau_mul(a[(r + 2U) % 4U], 13U) ^ sim_cau_mul(a[(r + 3U) % 4U], 9U)) :
+                        (uint8_t)(sim_cau_xtime(a[r]) ^ sim_cau_xtime(a[(r + 1U) % 4U]) ^ a[(r + 1U) % 4U] ^
+                                  a[(r + 2U) % 4U] ^ a[(r + 3U) % 4U]);
+                }
+            }
+        }
+        for(i = 0U; !decrypt && (i < 16U); i++)
+        {
+            t[i] ^= rk[16U * round + i];
+        }
+        memcpy(s, t, 16U);
+    }
+    memcpy(out, s, 16U);
+}
+
+/*!
+    \brief      multiply in GF(2^128) with the GCM bit order
+    \param[in]  x: factor, replaced by the product
+    \param[in]  h: hash subkey
+    \param[out] none
+    \retval     none
+*/
+static void sim_cau_gmul(uint8_t *x, const uint8_t *h)
+{
+    uint8_t z[16] = {0}, v[16];
+    uint32_t i, j;
+    uint8_t lsb;
+
+    memcpy(v, h, 16U);
+    for(i = 0U; i < 128U; i++)
+    {
+        if((x[i / 8U] >> (7U - i % 8U)) & 1U)
+        {
+            for(j = 0U; j < 16U; j++)
+            {
+                z[j] ^= v[j];
+            }
+        }
+        lsb = v[15] & 1U;
+        for(j = 15U; j > 0U; j--)
+        {
+            v[j] = (uint8_t)((v[j] >> 1) | (v[j - 1U] << 7));
+        }
+        v[0] = (uint8_t)((v[0] >> 1) ^ (lsb ? 0xE1U : 0x00U));
+    }
+    memcpy(x, z, 16U);
+}
+
+/*!
+    \brief      read four big-endian registers as a block
+    \param[in]  offset: first register
+    \param[out] block: 16 bytes
+    \retval     none
+*/
+static void sim_cau_reg_get(uint32_t offset, uint8_t *block)
+{
+    uint32_t i, w;
+
+    for(i = 0U; i < 4U; i++)
+    {
+        w = SIM_REG32(CAU + offset + 4U * i);
+        block[4U * i] = (uint8_t)(w >> 24);
+        block[4U * i + 1U] = (uint8_t)(w >> 16);
+        block[4U * i + 2U] = (uint8_t)(w >> 8);
+        block[4U * i + 3U] = (uint8_t)w;
+    }
+}
+
+/*!
+    \brief      write a block to four big-endian registers
+    \param[in]  offset: first register
+    \param[in]  block: 16 bytes
+    \param[out] none
+    \retval     none
+*/
+static void sim_cau_reg_set(uint32_t offset, const uint8_t *block)
+{
+    uint32_t i;
+
+    for(i = 0U; i < 4U; i++)
+    {
+        SIM_REG32(CAU + offset + 4U * i) = ((uint32_t)block[4U * i] << 24) | ((uint32_t)block[4U * i + 1U] << 16) |
+                                           ((uint32_t)block[4U * i + 2U] << 8) | (uint32_t)block[4U * i + 3U];
+    }
+}
+
+/*!
+    \brief      data swapping between a FIFO word and the big-endian block word
+    \param[in]  w: word
+    \param[out] none
+    \retval     swapped word, the swap is its own inverse
+*/
+static uint32_t sim_cau_swap(uint32_t w)
+{
+    uint32_t r = 0U;
+    uint32_t i;
+
+    switch(CAU_CTL & CAU_CTL_DATAM)
+    {
+        case CAU_SWAPPING_16BIT:
+            return (w << 16) | (w >> 16);
+        case CAU_SWAPPING_8BIT:
+            return ((w & 0xFFU) << 24) | ((w & 0xFF00U) << 8) | ((w >> 8) & 0xFF00U) | (w >> 24);
+        case CAU_SWAPPING_1BIT:
+            for(i = 0U; i < 32U; i++)
+            {
+                r |= ((w >> i) & 1U) << (31U - i);
+            }
+            return r;
+        default:
+            return w;
+    }
+}
+
+/*!
+    \brief      increment the 32-bit counter in IV1L
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void sim_cau_counter_next(void)
+{
+    CAU_IV1L = CAU_IV1L + 1U;
+}
+
+/*!
+    \brief      GCM prepare phase: hash subkey, pre-counter block, clear GHASH
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       IV1L holds the counter of the first payload block, J0 is one less.
+*/
+static void sim_cau_gcm_prepare(void)
+{
+    uint8_t block[16] = {0};
+
+    sim_cau_aes(block, 0U, block);
+    sim_cau_reg_set(SIM_CAU_SUBKEY_OFFSET, block);
+    memset(block, 0, sizeof(block));
+    sim_cau_reg_set(SIM_CAU_GHASH_OFFSET, block);
+    sim_cau_reg_get(SIM_CAU_IV_OFFSET, block);
+    sim_cau_reg_set(SIM_CAU_J0_OFFSET, block);
+    SIM_REG32(CAU + SIM_CAU_J0_OFFSET + 12U) -= 1U;
+    CAU_CTL &= ~CAU_CTL_CAUEN;                                              /* prepare phase done */
+}
+
+/*!
+    \brief      fold a block into the GHASH accumulator
+    \param[in]  block: 16 bytes
+    \param[out] none
+    \retval     none
+*/
+static void sim_cau_ghash(const uint8_t *block)
+{
+    uint8_t x[16], h[16];
+    uint32_t i;
+
+    sim_cau_reg_get(SIM_CAU_GHASH_OFFSET, x);
+    sim_cau_reg_get(SIM_CAU_SUBKEY_OFFSET, h);
+    for(i = 0U; i < 16U; i++)
+    {
+        x[i] ^= block[i];
+    }
+    sim_cau_gmul(x, h);
+    sim_cau_reg_set(SIM_CAU_GHASH_OFFSET, x);
+}
+
+/*!
+    \brief      process one block in the configured mode
+    \param[in]  in: 16 bytes
+    \param[out] out: 16 bytes
+    \retval     1 if the block produces output
+*/
+static uint8_t sim_cau_block(const uint8_t *in, uint8_t *out)
+{
+    uint32_t ctl = CAU_CTL;
+    uint8_t decrypt = (ctl & CAU_CTL_CAUDIR) ? 1U : 0U;
+    uint8_t iv[16], hashed[16];
+    uint32_t i, pad;
+
+    switch(ctl & CAU_CTL_ALGM)
+    {
+        case CAU_MODE_AES_ECB:
+            sim_cau_aes(in, decrypt, out);
+            return 1U;
+        case CAU_MODE_AES_CBC:
+            sim_cau_reg_get(SIM_CAU_IV_OFFSET, iv);
+            if(decrypt)
+            {
+                sim_cau_reg_set(SIM_CAU_IV_OFFSET, in);
+                sim_cau_aes(in, 1U, out);
+                for(i = 0U; i < 16U; i++)
+                {
+                    out[i] ^= iv[i];
+                }
+            }
+            else
+            {
+                for(i = 0U; i < 16U; i++)
+                {
+                    iv[i] ^= in[i];
+                }
+                sim_cau_aes(iv, 0U, out);
+                sim_cau_reg_set(SIM_CAU_IV_OFFSET, out);
+            }
+            return 1U;
+        case CAU_MODE_AES_CTR:
+            sim_cau_reg_get(SIM_CAU_IV_OFFSET, iv);
+            sim_cau_aes(iv, 0U, iv);
+            sim_cau_counter_next();
+            for(i = 0U; i < 16U; i++)
+            {
+                out[i] = in[i] ^ iv[i];
+            }
+            return 1U;
+        case CAU_MODE_AES_GCM:
+            switch(ctl & CAU_CTL_GCM_CCMPH)
+            {
+                case CAU_AAD_PHASE:
+                    sim_cau_ghash(in);
+                    return 0U;
+                case CAU_ENCRYPT_DECRYPT_PHASE:
+                    sim_cau_reg_get(SIM_CAU_IV_OFFSET, iv);
+                    sim_cau_aes(iv, 0U, iv);
+                    sim_cau_counter_next();
+                    for(i = 0U; i < 16U; i++)
+                    {
+                        out[i] = in[i] ^ iv[i];
+                    }
+                    memcpy(hashed, decrypt ? in : out, 16U);
+                    pad = decrypt ? 0U : ((ctl & CAU_CTL_NBPILB) >> 20);
+                    memset(&hashed[16U - pad], 0, pad);                     /* padding stays out of GHASH */
+                    sim_cau_ghash(hashed);
+                    return 1U;
+                case CAU_TAG_PHASE:
+                    sim_cau_ghash(in);
+                    sim_cau_reg_get(SIM_CAU_GHASH_OFFSET, hashed);
+                    sim_cau_reg_get(SIM_CAU_J0_OFFSET, iv);
+                    sim_cau_aes(iv, 0U, iv);
+                    for(i = 0U; i < 16U; i++)
+                    {
+                        out[i] = hashed[i] ^ iv[i];
+                    }
+                    return 1U;
+                default:
+                    return 0U;
+            }
+        default:                                                            /* key preparation is implicit */
+            return 0U;
+    }
+}
+
+/*!
+    \brief      DMA IN FIFO request: DMAIEN and room in the FIFO
+    \param[in]  arg: CAU model
+    \param[out] none
+    \retval     1 while requesting
+*/
+static uint8_t sim_cau_in_active(void *arg)
+{
+    (void)arg;
+    return (CAU_DMAEN & CAU_DMAEN_DMAIEN) && (s_sim_cau.in_count < SIM_CAU_FIFO);
+}
+
+/*!
+    \brief      DMA OUT FIFO request: DMAOEN and data in the FIFO
+    \param[in]  arg: CAU model
+    \param[out] none
+    \retval     1 while requesting
+*/
+static uint8_t sim_cau_out_active(void *arg)
+{
+    (void)arg;
+    return (CAU_DMAEN & CAU_DMAEN_DMAOEN) && (s_sim_cau.out_count != 0U);
+}
+
+/*!
+    \brief      process the blocks the FIFOs allow, then refresh the flags and requests
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void sim_cau_run(void)
+{
+    sim_cau_state_struct *s = &s_sim_cau;
+    uint8_t in[16], out[16];
+    uint32_t i, w;
+
+    while((CAU_CTL & CAU_CTL_CAUEN) && (s->in_count >= 4U) && (s->out_count + 4U <= SIM_CAU_FIFO))
+    {
+        for(i = 0U; i < 4U; i++)
+        {
+            w = sim_cau_swap(s->in[i]);
+            in[4U * i] = (uint8_t)(w >> 24);
+            in[4U * i + 1U] = (uint8_t)(w >> 16);
+            in[4U * i + 2U] = (uint8_t)(w >> 8);
+            in[4U * i + 3U] = (uint8_t)w;
+        }
+        s->in_count -= 4U;
+        memmove(s->in, s->in + 4, s->in_count * 4U);
+        if(sim_cau_block(in, out))
+        {
+            for(i = 0U; i < 4U; i++)
+            {
+                s->out[s->out_count++] = sim_cau_swap(((uint32_t)out[4U * i] << 24) | ((uint32_t)out[4U * i + 1U] << 16) |
+                                                      ((uint32_t)out[4U * i + 2U] << 8) | (uint32_t)out[4U * i + 3U]);
+            }
+        }
+    }
+
+    CAU_STAT0 = ((s->in_count == 0U) ? CAU_STAT0_IEM : 0U) | ((s->in_count < SIM_CAU_FIFO) ? CAU_STAT0_INF : 0U) |
+                ((s->out_count != 0U) ? CAU_STAT0_ONE : 0U) | ((s->out_count == SIM_CAU_FIFO) ? CAU_STAT0_OFU : 0U);
+    CAU_STAT1 = ((s->in_count < 4U) ? CAU_STAT1_ISTA : 0U) | ((s->out_count != 0U) ? CAU_STAT1_OSTA : 0U);
+    sim_dma_kick(DMA_REQUEST_CAU_OUT);
+    sim_dma_kick(DMA_REQUEST_CAU_IN);
+}
+
+/*!
+    \brief      CAU reset
+    \param[in]  m: CAU model
+    \param[out] none
+    \retval     none
+*/
+static void sim_cau_reset(sim_model_struct *m)
+{
+    memset((void *)(uintptr_t)m->base, 0, m->size);
+    s_sim_cau.in_count = 0U;
+    s_sim_cau.out_count = 0U;
+    if(s_sim_cau.sbox[0] == 0U)
+    {
+        sim_cau_sbox_build();
+    }
+    CAU_STAT0 = CAU_STAT0_IEM | CAU_STAT0_INF;
+    CAU_STAT1 = CAU_STAT1_ISTA;
+}
+
+/*!
+    \brief      DO read: pop the OUT FIFO
+    \param[in]  m: CAU model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     none
+*/
+static void sim_cau_read(sim_model_struct *m, uint32_t offset, uint32_t size)
+{
+    sim_cau_state_struct *s = m->state;
+
+    (void)size;
+    if(((offset & ~3U) != 0x0CU) || (s->out_count == 0U))
+    {
+        return;
+    }
+    CAU_DO = s->out[0];
+    memmove(s->out, s->out + 1, --s->out_count * 4U);
+    sim_cau_run();
+}
+
+/*!
+    \brief      act on a register write
+    \param[in]  m: CAU model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[in]  old: previous register content
+    \param[out] none
+    \retval     none
+*/
+static void sim_cau_write(sim_model_struct *m, uint32_t offset, uint32_t size, uint32_t old)
+{
+    sim_cau_state_struct *s = m->state;
+    uint32_t ctl = CAU_CTL;
+
+    (void)size;
+    switch(offset & ~3U)
+    {
+        case 0x00U:                                                         /* CTL: FFLUSH reads back 0, CAUEN starts the prepare phase */
+            if(ctl & CAU_CTL_FFLUSH)
+            {
+                CAU_CTL &= ~CAU_CTL_FFLUSH;
+                s->in_count = 0U;
+                s->out_count = 0U;
+            }
+            if((ctl & CAU_CTL_CAUEN) && !(old & CAU_CTL_CAUEN) && ((ctl & CAU_CTL_ALGM) == CAU_MODE_AES_GCM) &&
+               ((ctl & CAU_CTL_GCM_CCMPH) == CAU_PREPARE_PHASE))
+            {
+                sim_cau_gcm_prepare();
+            }
+            break;
+        case 0x04U:                                                         /* STAT0, DO and STAT1 are read-only */
+        case 0x0CU:
+        case 0x18U:
+            SIM_REG32(m->base + (offset & ~3U)) = old;
+            return;
+        case 0x08U:                                                         /* DI: a word into the IN FIFO */
+            if(s->in_count < SIM_CAU_FIFO)
+            {
+                s->in[s->in_count++] = CAU_DI;
+            }
+            break;
+        case 0x10U:                                                         /* DMAEN */
+            break;
+        default:
+            return;
+    }
+    sim_cau_run();
+}
+
+sim_model_struct g_sim_cau =
+{
+    "cau", CAU, 0x400U, sim_cau_reset, sim_cau_read, sim_cau_write, NULL, SIM_NEVER, &s_sim_cau, 0, NULL
+};
+
+/*!
+    \brief      register the CAU model and its DMA requests
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void sim_cau_register(void)
+{
+    sim_model_register(&g_sim_cau);
+    sim_dma_request_register(DMA_REQUEST_CAU_IN, sim_cau_in_active, &g_sim_cau);
+    sim_dma_request_register(DMA_REQUEST_CAU_OUT, sim_cau_out_active, &g_sim_cau);
+}
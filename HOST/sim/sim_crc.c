@@ -0,0 +1,164 @@
+/*!
+    \file       sim_crc.c
+    \brief      CRC model of the host build
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - The CRC calculation unit: 32, 16, 8 and 7-bit polynomials, input reversal
+      by byte, half-word and word, output reversal
+    - Byte, half-word and word writes to CRC_DATA, each processed at the
+      access width, as written by the CPU or by DMA
+*/
+
+#include <string.h>
+#include "gd32h7xx.h"
+#include "gd32h7xx_crc.h"
+#include "sim.h"
+
+/*!
+    \brief CRC model state
+*/
+typedef struct
+{
+    uint32_t reg;                                                           /* calculation register, CRC_DATA reads it */
+} sim_crc_state_struct;
+
+static sim_crc_state_struct s_sim_crc;
+
+/*!
+    \brief      polynomial size
+    \param[in]  none
+    \param[out] none
+    \retval     bits: 32, 16, 8 or 7
+*/
+static uint32_t sim_crc_width(void)
+{
+    static const uint8_t width[4] = {32U, 16U, 8U, 7U};
+
+    return width[(CRC_CTL & CRC_CTL_PS) >> 3];
+}
+
+/*!
+    \brief      reverse the bit order inside each unit of a value
+    \param[in]  value: input value
+    \param[in]  bits: value width
+    \param[in]  unit: reversal unit in bits
+    \param[out] none
+    \retval     reversed value
+*/
+static uint32_t sim_crc_reverse(uint32_t value, uint32_t bits, uint32_t unit)
+{
+    uint32_t result = 0U;
+    uint32_t i;
+
+    for(i = 0U; i < bits; i++)
+    {
+        if(value & (1UL << i))
+        {
+            result |= 1UL << ((i - i % unit) + (unit - 1U - i % unit));
+        }
+    }
+    return result;
+}
+
+/*!
+    \brief      refresh CRC_DATA from the calculation register
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void sim_crc_output(void)
+{
+    uint32_t width = sim_crc_width();
+
+    CRC_DATA = (CRC_CTL & CRC_CTL_REV_O) ? sim_crc_reverse(s_sim_crc.reg, width, width) : s_sim_crc.reg;
+}
+
+/*!
+    \brief      process one data write, most significant bit first
+    \param[in]  data: written value
+    \param[in]  bits: access width
+    \param[out] none
+    \retval     none
+*/
+static void sim_crc_process(uint32_t data, uint32_t bits)
+{
+    static const uint8_t unit[4] = {0U, 8U, 16U, 32U};
+    uint32_t width = sim_crc_width();
+    uint32_t mask = (width == 32U) ? 0xFFFFFFFFU : ((1UL << width) - 1U);
+    uint32_t poly = CRC_POLY & mask;
+    uint32_t rev = unit[(CRC_CTL & CRC_CTL_REV_I) >> 5];
+    uint32_t crc = s_sim_crc.reg;
+    uint32_t top;
+    int32_t i;
+
+    if(rev != 0U)
+    {
+        data = sim_crc_reverse(data, bits, (rev < bits) ? rev : bits);
+    }
+    for(i = (int32_t)bits - 1; i >= 0; i--)
+    {
+        top = (crc >> (width - 1U)) & 1U;
+        crc = (crc << 1) & mask;
+        if(top ^ ((data >> i) & 1U))
+        {
+            crc ^= poly;
+        }
+    }
+    s_sim_crc.reg = crc;
+}
+
+/*!
+    \brief      CRC reset
+    \param[in]  m: CRC model
+    \param[out] none
+    \retval     none
+*/
+static void sim_crc_reset(sim_model_struct *m)
+{
+    memset((void *)(uintptr_t)m->base, 0, m->size);
+    CRC_IDATA = 0xFFFFFFFFU;
+    CRC_POLY = 0x04C11DB7U;
+    s_sim_crc.reg = 0xFFFFFFFFU;
+    sim_crc_output();
+}
+
+/*!
+    \brief      act on a register write
+    \param[in]  m: CRC model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[in]  old: previous register content
+    \param[out] none
+    \retval     none
+*/
+static void sim_crc_write(sim_model_struct *m, uint32_t offset, uint32_t size, uint32_t old)
+{
+    uint32_t value;
+
+    (void)old;
+    switch(offset & ~3U)
+    {
+        case 0x00U:                                                         /* DATA: the written bytes are input */
+            value = (size == 4U) ? SIM_REG32(m->base) : (size == 2U) ? SIM_REG16(m->base + offset) : SIM_REG8(m->base + offset);
+            sim_crc_process(value, size * 8U);
+            break;
+        case 0x08U:                                                         /* CTL: RST loads IDATA and reads back 0 */
+            if(CRC_CTL & CRC_CTL_RST)
+            {
+                CRC_CTL &= ~CRC_CTL_RST;
+                s_sim_crc.reg = CRC_IDATA & ((sim_crc_width() == 32U) ? 0xFFFFFFFFU : ((1UL << sim_crc_width()) - 1U));
+            }
+            break;
+        default:
+            return;
+    }
+    sim_crc_output();
+}
+
+sim_model_struct g_sim_crc =
+{
+    "crc", CRC, 0x400U, sim_crc_reset, NULL, sim_crc_write, NULL, SIM_NEVER, &s_sim_crc, 0, NULL
+};
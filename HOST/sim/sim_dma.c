@@ -0,0 +1,398 @@
+/*!
+    \file       sim_dma.c
+    \brief      DMA and DMAMUX model of the host build
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - DMA0 and DMA1, eight channels each, with the request of every channel
+      taken from its DMAMUX multiplexer channel
+    - Peripheral-to-memory and memory-to-peripheral transfers paced by the
+      request lines of the peripheral models, one item per request
+    - Memory-to-memory transfers completing after a time proportional to the
+      item count
+    - Data widths, address increments, circular mode, CNT counting down as
+      items move, HTF/FTF flags and channel interrupts
+*/
+
+#include <string.h>
+#include "gd32h7xx.h"
+#include "gd32h7xx_dma.h"
+#include "sim.h"
+
+#define SIM_DMA_CHANNELS            8U
+#define SIM_DMA_REQUESTS            256U                                    /* DMAMUX request ids */
+#define SIM_DMA_ITEM_CYCLES         4U                                      /* memory-to-memory cycles per item */
+
+/*!
+    \brief channel state
+*/
+typedef struct
+{
+    uint32_t total;                                                         /* CNT when enabled, for HTF and circular reload */
+    uint32_t done;                                                          /* items moved */
+    uint32_t half;                                                          /* HTF already raised this round */
+    uint64_t m2m_at;                                                        /* memory-to-memory completion, SIM_NEVER if none */
+} sim_dma_channel_struct;
+
+/*!
+    \brief DMA model state
+*/
+typedef struct
+{
+    uint32_t periph;
+    uint32_t mux_offset;                                                    /* first DMAMUX channel: 0 for DMA0, 8 for DMA1 */
+    int32_t irqn[SIM_DMA_CHANNELS];
+    sim_dma_channel_struct ch[SIM_DMA_CHANNELS];
+} sim_dma_state_struct;
+
+/*!
+    \brief request line of a peripheral model
+*/
+typedef struct
+{
+    sim_dma_request_func active;
+    void *arg;
+} sim_dma_line_struct;
+
+static sim_dma_state_struct s_sim_dma[2] =
+{
+    {DMA0, 0U, {DMA0_Channel0_IRQn, DMA0_Channel1_IRQn, DMA0_Channel2_IRQn, DMA0_Channel3_IRQn,
+                DMA0_Channel4_IRQn, DMA0_Channel5_IRQn, DMA0_Channel6_IRQn, DMA0_Channel7_IRQn}, {{0}}},
+    {DMA1, 8U, {DMA1_Channel0_IRQn, DMA1_Channel1_IRQn, DMA1_Channel2_IRQn, DMA1_Channel3_IRQn,
+                DMA1_Channel4_IRQn, DMA1_Channel5_IRQn, DMA1_Channel6_IRQn, DMA1_Channel7_IRQn}, {{0}}},
+};
+static sim_dma_line_struct s_sim_dma_lines[SIM_DMA_REQUESTS];
+static uint8_t s_sim_dma_busy = 0;                                          /* servicing, a nested kick loops again */
+static uint8_t s_sim_dma_again = 0;
+
+/*!
+    \brief      interrupt flag register and shift of a channel
+    \param[in]  s: DMA state
+    \param[in]  ch: channel
+    \param[out] shift: bit position of the channel flags
+    \retval     INTF register address
+*/
+static uint32_t sim_dma_intf(const sim_dma_state_struct *s, uint32_t ch, uint32_t *shift)
+{
+    uint32_t c = ch & 3U;
+
+    *shift = c * 6U + ((c >> 1) & 1U) * 4U;
+    return s->periph + ((ch < 4U) ? 0x00U : 0x04U);
+}
+
+/*!
+    \brief      raise flags of a channel and update its interrupt line
+    \param[in]  s: DMA state
+    \param[in]  ch: channel
+    \param[in]  flags: DMA_FLAG_x, 0 to refresh the line only
+    \param[out] none
+    \retval     none
+*/
+static void sim_dma_flags(const sim_dma_state_struct *s, uint32_t ch, uint32_t flags)
+{
+    uint32_t shift, ctl, pending, enabled = 0;
+    uint32_t intf = sim_dma_intf(s, ch, &shift);
+
+    SIM_REG32(intf) |= flags << shift;
+    pending = SIM_REG32(intf) >> shift;
+    ctl = DMA_CHCTL(s->periph, ch);
+    enabled |= (ctl & DMA_CHXCTL_FTFIE) ? DMA_FLAG_FTF : 0U;
+    enabled |= (ctl & DMA_CHXCTL_HTFIE) ? DMA_FLAG_HTF : 0U;
+    enabled |= (ctl & DMA_CHXCTL_TAEIE) ? DMA_FLAG_TAE : 0U;
+    sim_irq_set(s->irqn[ch], (pending & enabled & 0x3DU) != 0U);
+}
+
+/*!
+    \brief      move one peripheral-width item
+    \param[in]  s: DMA state
+    \param[in]  ch: channel
+    \param[out] none
+    \retval     none
+    \note       CNT counts PWIDTH items. The peripheral side moves an item in
+                one access, the memory side in MWIDTH accesses when narrower.
+                For memory-to-memory the peripheral address is the source.
+*/
+static void sim_dma_item(sim_dma_state_struct *s, uint32_t ch)
+{
+    sim_dma_channel_struct *c = &s->ch[ch];
+    uint32_t ctl = DMA_CHCTL(s->periph, ch);
+    uint32_t pwidth = 1U << ((ctl & DMA_CHXCTL_PWIDTH) >> 11);
+    uint32_t mwidth = 1U << ((ctl & DMA_CHXCTL_MWIDTH) >> 13);
+    uint32_t paddr = DMA_CHPADDR(s->periph, ch) + ((ctl & DMA_CHXCTL_PNAGA) ? c->done * pwidth : 0U);
+    uint32_t maddr = DMA_CHM0ADDR(s->periph, ch) + ((ctl & DMA_CHXCTL_MNAGA) ? c->done * pwidth : 0U);
+    uint32_t mstep = (ctl & DMA_CHXCTL_MNAGA) ? 1U : 0U;
+    uint32_t width = (mwidth < pwidth) ? mwidth : pwidth;
+    uint32_t value, part, i;
+
+    if((ctl & DMA_CHXCTL_TM) == DMA_MEMORY_TO_PERIPH)
+    {
+        for(i = 0, value = 0; i < pwidth; i += width)
+        {
+            value |= sim_bus_read(maddr + i * mstep, width) << (8U * i);
+        }
+        sim_bus_write(paddr, pwidth, value);
+    }
+    else
+    {
+        value = sim_bus_read(paddr, pwidth);
+        for(i = 0; i < pwidth; i += width)
+        {
+            part = (width == 4U) ? value : ((value >> (8U * i)) & ((1UL << (8U * width)) - 1U));
+            sim_bus_write(maddr + i * mstep, width, part);
+        }
+    }
+
+    c->done++;
+    DMA_CHCNT(s->periph, ch) = c->total - c->done;
+    if(!c->half && (c->done >= c->total / 2U))
+    {
+        c->half = 1;
+        sim_dma_flags(s, ch, DMA_FLAG_HTF);
+    }
+    if(c->done >= c->total)
+    {
+        if(ctl & DMA_CHXCTL_CMEN)
+        {
+            c->done = 0;
+            c->half = 0;
+            DMA_CHCNT(s->periph, ch) = c->total;
+        }
+        else
+        {
+            DMA_CHCTL(s->periph, ch) &= ~DMA_CHXCTL_CHEN;
+        }
+        sim_dma_flags(s, ch, DMA_FLAG_FTF);
+    }
+}
+
+/*!
+    \brief      serve every enabled channel whose request is active
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void sim_dma_service(void)
+{
+    sim_dma_state_struct *s;
+    sim_dma_line_struct *line;
+    uint32_t d, ch, request;
+
+    if(s_sim_dma_busy)
+    {
+        s_sim_dma_again = 1;
+        return;
+    }
+    s_sim_dma_busy = 1;
+    do
+    {
+        s_sim_dma_again = 0;
+        for(d = 0; d < 2U; d++)
+        {
+            s = &s_sim_dma[d];
+            for(ch = 0; ch < SIM_DMA_CHANNELS; ch++)
+            {
+                request = DMAMUX_RM_CHXCFG(s->mux_offset + ch) & DMAMUX_RM_CHXCFG_MUXID;
+                line = &s_sim_dma_lines[request];
+                if((request == DMA_REQUEST_M2M) || (line->active == NULL))
+                {
+                    continue;
+                }
+                while((DMA_CHCTL(s->periph, ch) & DMA_CHXCTL_CHEN) && (s->ch[ch].done < s->ch[ch].total) &&
+                      line->active(line->arg))
+                {
+                    sim_dma_item(s, ch);
+                }
+            }
+        }
+    } while(s_sim_dma_again);
+    s_sim_dma_busy = 0;
+}
+
+/*!
+    \brief      connect the request line of a peripheral model
+    \param[in]  request: DMA_REQUEST_x id
+    \param[in]  active: returns 1 while the peripheral requests
+    \param[in]  arg: argument of active
+    \param[out] none
+    \retval     none
+*/
+void sim_dma_request_register(uint32_t request, sim_dma_request_func active, void *arg)
+{
+    if(request < SIM_DMA_REQUESTS)
+    {
+        s_sim_dma_lines[request].active = active;
+        s_sim_dma_lines[request].arg = arg;
+    }
+}
+
+/*!
+    \brief      a peripheral request may have gone active
+    \param[in]  request: DMA_REQUEST_x id
+    \param[out] none
+    \retval     none
+*/
+void sim_dma_kick(uint32_t request)
+{
+    (void)request;
+    sim_dma_service();
+}
+
+/*!
+    \brief      reschedule the memory-to-memory completions
+    \param[in]  m: DMA model
+    \param[out] none
+    \retval     none
+*/
+static void sim_dma_schedule(sim_model_struct *m)
+{
+    sim_dma_state_struct *s = m->state;
+    uint64_t next = SIM_NEVER;
+    uint32_t ch;
+
+    for(ch = 0; ch < SIM_DMA_CHANNELS; ch++)
+    {
+        next = (s->ch[ch].m2m_at < next) ? s->ch[ch].m2m_at : next;
+    }
+    sim_schedule(m, next);
+}
+
+/*!
+    \brief      DMA reset
+    \param[in]  m: DMA model
+    \param[out] none
+    \retval     none
+*/
+static void sim_dma_reset(sim_model_struct *m)
+{
+    sim_dma_state_struct *s = m->state;
+    uint32_t ch;
+
+    memset((void *)(uintptr_t)m->base, 0, m->size);
+    memset(s->ch, 0, sizeof(s->ch));
+    for(ch = 0; ch < SIM_DMA_CHANNELS; ch++)
+    {
+        s->ch[ch].m2m_at = SIM_NEVER;
+        sim_irq_set(s->irqn[ch], 0);
+    }
+}
+
+/*!
+    \brief      act on a register write
+    \param[in]  m: DMA model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[in]  old: previous register content
+    \param[out] none
+    \retval     none
+*/
+static void sim_dma_write(sim_model_struct *m, uint32_t offset, uint32_t size, uint32_t old)
+{
+    sim_dma_state_struct *s = m->state;
+    uint32_t reg = offset & ~3U;
+    uint32_t value = SIM_REG32(m->base + reg);
+    uint32_t ch, ctl, request;
+    sim_dma_channel_struct *c;
+
+    (void)size;
+    if(reg < 0x08U)                                                         /* INTF is read-only */
+    {
+        SIM_REG32(m->base + reg) = old;
+        return;
+    }
+    if(reg < 0x10U)                                                         /* INTC: write 1 to clear */
+    {
+        SIM_REG32(m->base + reg - 0x08U) &= ~value;
+        SIM_REG32(m->base + reg) = 0U;
+        for(ch = (reg == 0x08U) ? 0U : 4U; ch < ((reg == 0x08U) ? 4U : 8U); ch++)
+        {
+            sim_dma_flags(s, ch, 0U);
+        }
+        return;
+    }
+    if(reg >= 0x10U + 0x18U * SIM_DMA_CHANNELS)
+    {
+        return;
+    }
+    ch = (reg - 0x10U) / 0x18U;
+    c = &s->ch[ch];
+    switch((reg - 0x10U) % 0x18U)
+    {
+        case 0x00U:                                                         /* CTL */
+            ctl = value;
+            sim_dma_flags(s, ch, 0U);
+            if((ctl & DMA_CHXCTL_CHEN) && !(old & DMA_CHXCTL_CHEN))
+            {
+                c->total = DMA_CHCNT(s->periph, ch) & 0xFFFFU;
+                c->done = 0;
+                c->half = 0;
+                if(c->total == 0U)
+                {
+                    DMA_CHCTL(s->periph, ch) &= ~DMA_CHXCTL_CHEN;
+                    break;
+                }
+                request = DMAMUX_RM_CHXCFG(s->mux_offset + ch) & DMAMUX_RM_CHXCFG_MUXID;
+                if(request == DMA_REQUEST_M2M)
+                {
+                    c->m2m_at = sim_cycles() + (uint64_t)c->total * SIM_DMA_ITEM_CYCLES;
+                    sim_dma_schedule(m);
+                }
+                else
+                {
+                    sim_dma_service();
+                }
+            }
+            else if(!(ctl & DMA_CHXCTL_CHEN) && (old & DMA_CHXCTL_CHEN))
+            {
+                c->m2m_at = SIM_NEVER;
+                sim_dma_schedule(m);
+            }
+            break;
+        case 0x04U:                                                         /* CNT: writable while disabled */
+            if(DMA_CHCTL(s->periph, ch) & DMA_CHXCTL_CHEN)
+            {
+                DMA_CHCNT(s->periph, ch) = old;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/*!
+    \brief      memory-to-memory completion: move every item at once
+    \param[in]  m: DMA model
+    \param[in]  now: virtual cycle
+    \param[out] none
+    \retval     none
+*/
+static void sim_dma_event(sim_model_struct *m, uint64_t now)
+{
+    sim_dma_state_struct *s = m->state;
+    uint32_t ch;
+
+    for(ch = 0; ch < SIM_DMA_CHANNELS; ch++)
+    {
+        if(s->ch[ch].m2m_at > now)
+        {
+            continue;
+        }
+        s->ch[ch].m2m_at = SIM_NEVER;
+        while((DMA_CHCTL(s->periph, ch) & DMA_CHXCTL_CHEN) && (s->ch[ch].done < s->ch[ch].total))
+        {
+            sim_dma_item(s, ch);
+            if(s->ch[ch].done == 0U)
+            {
+                break;                                                      /* circular memory-to-memory: one round per event */
+            }
+        }
+    }
+    sim_dma_schedule(m);
+}
+
+sim_model_struct g_sim_dma[2] =
+{
+    {"dma0", DMA0, 0x400U, sim_dma_reset, NULL, sim_dma_write, sim_dma_event, SIM_NEVER, &s_sim_dma[0], 0, NULL},
+    {"dma1", DMA1, 0x400U, sim_dma_reset, NULL, sim_dma_write, sim_dma_event, SIM_NEVER, &s_sim_dma[1], 0, NULL},
+};
@@ -0,0 +1,236 @@
+/*!
+    \file       sim_fmc.c
+    \brief      flash memory controller model of the host build
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - FMC_CTL unlock sequence and lock, erase and program commands, busy time
+      and end of operation flag, error flags cleared by writing 1
+    - The flash array: programming only clears bits, a write outside a program
+      operation is discarded and flags PGSERR, sector and mass erase fill 0xFF
+    - The FMC interrupt line
+*/
+
+#include <string.h>
+#include "gd32h7xx.h"
+#include "gd32h7xx_fmc.h"
+#include "sim.h"
+
+#define SIM_FMC_SECTOR_SIZE         0x1000U                                 /* erase granularity */
+#define SIM_FMC_PROGRAM_US          16U                                     /* busy time of a word program */
+#define SIM_FMC_SECTOR_ERASE_US     100U                                    /* busy time of a sector erase */
+#define SIM_FMC_MASS_ERASE_US       2000U                                   /* busy time of a mass erase */
+#define SIM_FMC_ERROR_FLAGS         (FMC_STAT_WPERR | FMC_STAT_PGSERR | FMC_STAT_RPERR | FMC_STAT_RSERR | \
+                                     FMC_STAT_ECCCOR | FMC_STAT_ECCDET | FMC_STAT_OBMERR)
+
+/*!
+    \brief FMC model state
+*/
+typedef struct
+{
+    uint8_t key_stage;                                                      /* 1 after UNLOCK_KEY0 */
+    uint32_t erase_addr;                                                    /* first byte of the pending erase */
+    uint32_t erase_size;                                                    /* 0 for a program operation */
+} sim_fmc_state_struct;
+
+static sim_fmc_state_struct s_sim_fmc;
+
+/*!
+    \brief      update the interrupt line
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void sim_fmc_irq_update(void)
+{
+    uint32_t pending = FMC_STAT & (FMC_STAT_ENDF | SIM_FMC_ERROR_FLAGS);
+
+    /* every status bit has its enable bit at the same position in FMC_CTL */
+    sim_irq_set(FMC_IRQn, (pending & FMC_CTL & ~FMC_STAT_OBMERR) != 0U);
+}
+
+/*!
+    \brief      start a busy period
+    \param[in]  us: busy time
+    \param[out] none
+    \retval     none
+*/
+static void sim_fmc_busy(uint32_t us)
+{
+    FMC_STAT |= FMC_STAT_BUSY;
+    sim_schedule(&g_sim_fmc, sim_cycles() + (uint64_t)us * (SIM_CORE_HZ / 1000000U));
+}
+
+/*!
+    \brief      FMC reset
+    \param[in]  m: FMC model
+    \param[out] none
+    \retval     none
+*/
+static void sim_fmc_reset(sim_model_struct *m)
+{
+    memset((void *)(uintptr_t)m->base, 0, m->size);
+    FMC_CTL = FMC_CTL_LK;
+    FMC_PID0 = 0x48373539U;                                                 /* "H759" */
+    FMC_PID1 = 0x00000001U;
+    memset(&s_sim_fmc, 0, sizeof(s_sim_fmc));
+    sim_fmc_irq_update();
+}
+
+/*!
+    \brief      act on a register write
+    \param[in]  m: FMC model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[in]  old: previous register content
+    \param[out] none
+    \retval     none
+*/
+static void sim_fmc_write(sim_model_struct *m, uint32_t offset, uint32_t size, uint32_t old)
+{
+    uint32_t value = SIM_REG32(m->base + (offset & ~3U));
+
+    (void)size;
+    switch(offset & ~3U)
+    {
+        case 0x04U:                                                         /* KEY: two-word unlock sequence */
+            if(value == UNLOCK_KEY0)
+            {
+                s_sim_fmc.key_stage = 1U;
+            }
+            else
+            {
+                if((s_sim_fmc.key_stage == 1U) && (value == UNLOCK_KEY1))
+                {
+                    FMC_CTL &= ~FMC_CTL_LK;
+                }
+                s_sim_fmc.key_stage = 0U;
+            }
+            FMC_KEY = 0U;
+            break;
+        case 0x0CU:                                                         /* CTL: locked except for LK, START starts an erase */
+            if(old & FMC_CTL_LK)
+            {
+                FMC_CTL = old;
+                break;
+            }
+            if((value & FMC_CTL_START) && !(old & FMC_CTL_START))
+            {
+                if(FMC_STAT & FMC_STAT_BUSY)
+                {
+                    FMC_STAT |= FMC_STAT_PGSERR;
+                    FMC_CTL &= ~FMC_CTL_START;
+                }
+                else if(value & FMC_CTL_MER)
+                {
+                    s_sim_fmc.erase_addr = SIM_FLASH_BASE;
+                    s_sim_fmc.erase_size = SIM_FLASH_SIZE;
+                    sim_fmc_busy(SIM_FMC_MASS_ERASE_US);
+                }
+                else if((value & FMC_CTL_SER) && (FMC_ADDR - SIM_FLASH_BASE < SIM_FLASH_SIZE))
+                {
+                    s_sim_fmc.erase_addr = FMC_ADDR & ~(SIM_FMC_SECTOR_SIZE - 1U);
+                    s_sim_fmc.erase_size = SIM_FMC_SECTOR_SIZE;
+                    sim_fmc_busy(SIM_FMC_SECTOR_ERASE_US);
+                }
+                else
+                {
+                    FMC_STAT |= FMC_STAT_PGSERR;
+                    FMC_CTL &= ~FMC_CTL_START;
+                }
+            }
+            break;
+        case 0x10U:                                                         /* STAT: write 1 to clear, BUSY is read only */
+            FMC_STAT = old & ~(value & (FMC_STAT_ENDF | SIM_FMC_ERROR_FLAGS));
+            break;
+        default:
+            break;
+    }
+    sim_fmc_irq_update();
+}
+
+/*!
+    \brief      end of operation
+    \param[in]  m: FMC model
+    \param[in]  now: virtual cycle
+    \param[out] none
+    \retval     none
+*/
+static void sim_fmc_event(sim_model_struct *m, uint64_t now)
+{
+    (void)now;
+    if(s_sim_fmc.erase_size != 0U)
+    {
+        memset((void *)(uintptr_t)s_sim_fmc.erase_addr, 0xFF, s_sim_fmc.erase_size);
+        s_sim_fmc.erase_size = 0U;
+        FMC_CTL &= ~FMC_CTL_START;
+    }
+    FMC_STAT = (FMC_STAT & ~FMC_STAT_BUSY) | FMC_STAT_ENDF;
+    sim_schedule(m, SIM_NEVER);
+    sim_fmc_irq_update();
+}
+
+/*!
+    \brief      store into the flash array without the bus hook
+    \param[in]  addr: address
+    \param[in]  size: bytes
+    \param[in]  value: value
+    \param[out] none
+    \retval     none
+*/
+static void sim_flash_store(uint32_t addr, uint32_t size, uint32_t value)
+{
+    if(size == 4U)
+    {
+        SIM_REG32(addr) = value;
+    }
+    else if(size == 2U)
+    {
+        SIM_REG16(addr) = (uint16_t)value;
+    }
+    else
+    {
+        SIM_REG8(addr) = (uint8_t)value;
+    }
+}
+
+/*!
+    \brief      program the flash array
+    \param[in]  m: flash model
+    \param[in]  offset: byte offset in the flash
+    \param[in]  size: bytes
+    \param[in]  old: previous content
+    \param[out] none
+    \retval     none
+    \note       Bits only go from 1 to 0. Outside a program operation the CPU
+                store is undone, as the array ignores it on the target.
+*/
+static void sim_flash_write(sim_model_struct *m, uint32_t offset, uint32_t size, uint32_t old)
+{
+    uint32_t addr = m->base + offset;
+    uint32_t value = (size == 4U) ? SIM_REG32(addr) : (size == 2U) ? SIM_REG16(addr) : SIM_REG8(addr);
+
+    if(!(FMC_CTL & FMC_CTL_PG) || (FMC_STAT & FMC_STAT_BUSY))
+    {
+        sim_flash_store(addr, size, old);
+        FMC_STAT |= FMC_STAT_PGSERR;
+    }
+    else
+    {
+        sim_flash_store(addr, size, old & value);
+        sim_fmc_busy(SIM_FMC_PROGRAM_US);
+    }
+    sim_fmc_irq_update();
+}
+
+sim_model_struct g_sim_fmc =
+{
+    "fmc", FMC, 0x400U, sim_fmc_reset, NULL, sim_fmc_write, sim_fmc_event, SIM_NEVER, &s_sim_fmc, 0, NULL
+};
+
+sim_model_struct g_sim_flash =
+{
+    "flash", SIM_FLASH_BASE, SIM_FLASH_SIZE, NULL, NULL, sim_flash_write, NULL, SIM_NEVER, NULL, 0, NULL
+};
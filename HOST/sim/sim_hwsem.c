@@ -0,0 +1,132 @@
+/*!
+    \file       sim_hwsem.c
+    \brief      hardware semaphore model of the host build
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - 32 semaphores locked by writing HWSEM_CTLx with LK and the master and
+      process id, a lock request by another owner is discarded
+    - Release by writing the owner's ids without LK, lock by reading HWSEM_RLKx
+    - Release status and interrupt flags, cleared through HWSEM_INTC, and the
+      HWSEM interrupt line
+*/
+
+#include <string.h>
+#include "gd32h7xx.h"
+#include "gd32h7xx_hwsem.h"
+#include "sim.h"
+
+#define SIM_HWSEM_OWNER             (HWSEM_CTL_MID | HWSEM_CTL_PID)        /* ids compared for a release or a relock */
+
+/*!
+    \brief      update the interrupt flags and line
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void sim_hwsem_irq_update(void)
+{
+    HWSEM_INTF = HWSEM_STAT & HWSEM_INTEN;
+    sim_irq_set(HWSEM_IRQn, HWSEM_INTF != 0U);
+}
+
+/*!
+    \brief      HWSEM reset
+    \param[in]  m: HWSEM model
+    \param[out] none
+    \retval     none
+*/
+static void sim_hwsem_reset(sim_model_struct *m)
+{
+    memset((void *)(uintptr_t)m->base, 0, m->size);
+    sim_hwsem_irq_update();
+}
+
+/*!
+    \brief      lock a free semaphore on a read of its read lock register
+    \param[in]  m: HWSEM model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     none
+*/
+static void sim_hwsem_read(sim_model_struct *m, uint32_t offset, uint32_t size)
+{
+    uint32_t sem = (offset & 0x7FU) >> 2;
+
+    (void)m;
+    (void)size;
+    if((offset >= 0x80U) && (offset < 0x100U))
+    {
+        if(0U == (HWSEM_CTL(sem) & HWSEM_LOCK))
+        {
+            HWSEM_CTL(sem) = HWSEM_LOCK | CTL_MID(HWSEM_MASTER_ID);
+        }
+        HWSEM_RLK(sem) = HWSEM_CTL(sem);
+    }
+}
+
+/*!
+    \brief      act on a register write
+    \param[in]  m: HWSEM model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[in]  old: previous register content
+    \param[out] none
+    \retval     none
+*/
+static void sim_hwsem_write(sim_model_struct *m, uint32_t offset, uint32_t size, uint32_t old)
+{
+    uint32_t value = SIM_REG32(m->base + (offset & ~3U));
+    uint32_t sem = (offset & 0x7FU) >> 2;
+
+    (void)size;
+    if(offset < 0x80U)
+    {
+        if(0U == (old & HWSEM_LOCK))
+        {
+            /* free: a write with LK locks it, any other write leaves it free */
+            HWSEM_CTL(sem) = (value & HWSEM_LOCK) ? value : 0U;
+        }
+        else if((value & SIM_HWSEM_OWNER) != (old & SIM_HWSEM_OWNER))
+        {
+            HWSEM_CTL(sem) = old;
+        }
+        else if(0U == (value & HWSEM_LOCK))
+        {
+            HWSEM_CTL(sem) = 0U;
+            HWSEM_STAT |= 1UL << sem;
+        }
+        else
+        {
+            HWSEM_CTL(sem) = old;
+        }
+    }
+    else if(offset < 0x100U)
+    {
+        HWSEM_RLK(sem) = old;                                               /* read only */
+    }
+    else
+    {
+        switch(offset & ~3U)
+        {
+            case 0x104U:                                                    /* INTC: write 1 to clear, reads 0 */
+                HWSEM_STAT &= ~value;
+                HWSEM_INTC = 0U;
+                break;
+            case 0x108U:                                                    /* STAT is read only, INTF follows it */
+                HWSEM_STAT = old;
+                break;
+            default:
+                break;
+        }
+    }
+    sim_hwsem_irq_update();
+}
+
+sim_model_struct g_sim_hwsem =
+{
+    "hwsem", HWSEM, 0x400U, sim_hwsem_reset, sim_hwsem_read, sim_hwsem_write, NULL, SIM_NEVER, NULL, 0, NULL
+};
@@ -0,0 +1,146 @@
+/*!
+    \file       sim_rcu.c
+    \brief      reset and clock unit model of the host build
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - RCU reset state: every bus clocked from IRC64M
+    - Oscillators and PLLs that stabilize as soon as they are enabled, system
+      clock switch status following the switch
+    - Peripheral reset bits that reset the matching model
+    - Registration of every peripheral model of the host build
+*/
+
+#include <string.h>
+#include "gd32h7xx.h"
+#include "gd32h7xx_rcu.h"
+#include "gd32h7xx_usart.h"
+#include "gd32h7xx_timer.h"
+#include "gd32h7xx_dma.h"
+#include "gd32h7xx_crc.h"
+#include "gd32h7xx_cau.h"
+#include "sim.h"
+
+/*!
+    \brief peripheral reset bit and the model it resets
+*/
+typedef struct
+{
+    uint32_t reset;                                                         /*!< rcu_periph_reset_enum value */
+    uint32_t base;                                                          /*!< register window of the model */
+} sim_rcu_reset_struct;
+
+static const sim_rcu_reset_struct s_sim_rcu_resets[] =
+{
+    {RCU_DMA0RST, DMA0},
+    {RCU_DMA1RST, DMA1},
+    {RCU_CRCRST, CRC},
+    {RCU_CAURST, CAU},
+    {RCU_TIMER1RST, TIMER1},
+    {RCU_TIMER5RST, TIMER5},
+    {RCU_TIMER6RST, TIMER6},
+    {RCU_TIMER50RST, TIMER50},
+    {RCU_USART1RST, USART1},
+    {RCU_UART4RST, UART4},
+    {RCU_USART0RST, USART0},
+    {RCU_TIMER15RST, TIMER15},
+    {RCU_TIMER16RST, TIMER16},
+};
+
+/*!
+    \brief      RCU reset
+    \param[in]  m: RCU model
+    \param[out] none
+    \retval     none
+*/
+static void sim_rcu_reset(sim_model_struct *m)
+{
+    memset((void *)(uintptr_t)m->base, 0, m->size);
+    RCU_CTL = RCU_CTL_IRC64MEN | RCU_CTL_IRC64MSTB;
+}
+
+/*!
+    \brief      act on a register write
+    \param[in]  m: RCU model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[in]  old: previous register content
+    \param[out] none
+    \retval     none
+*/
+static void sim_rcu_write(sim_model_struct *m, uint32_t offset, uint32_t size, uint32_t old)
+{
+    uint32_t value = SIM_REG32(m->base + (offset & ~3U));
+    uint32_t rising;
+    uint32_t i;
+
+    (void)size;
+    switch(offset & ~3U)
+    {
+        case 0x00U:                                                         /* CTL: each STB bit follows its EN bit */
+            value &= ~(RCU_CTL_HXTALSTB | RCU_CTL_PLL0STB | RCU_CTL_PLL1STB | RCU_CTL_PLL2STB | RCU_CTL_IRC64MSTB);
+            value |= (value & (RCU_CTL_HXTALEN | RCU_CTL_PLL0EN | RCU_CTL_PLL1EN | RCU_CTL_PLL2EN | RCU_CTL_IRC64MEN)) << 1;
+            RCU_CTL = value;
+            break;
+        case 0x08U:                                                         /* CFG0: the switch completes at once */
+            RCU_CFG0 = (value & ~RCU_CFG0_SCSS) | ((value & RCU_CFG0_SCS) << 2);
+            break;
+        case 0x70U:                                                         /* BDCTL */
+            RCU_BDCTL = (value & ~RCU_BDCTL_LXTALSTB) | ((value & RCU_BDCTL_LXTALEN) << 1);
+            break;
+        case 0x10U:                                                         /* AHB1RST to APB4RST */
+        case 0x14U:
+        case 0x18U:
+        case 0x1CU:
+        case 0x20U:
+        case 0x24U:
+        case 0x28U:
+        case 0x2CU:
+            rising = value & ~old;
+            for(i = 0U; i < sizeof(s_sim_rcu_resets) / sizeof(s_sim_rcu_resets[0]); i++)
+            {
+                if((((s_sim_rcu_resets[i].reset >> 6) == (offset & ~3U))) && (rising & BIT(RCU_BIT_POS(s_sim_rcu_resets[i].reset))))
+                {
+                    sim_model_reset(s_sim_rcu_resets[i].base);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+sim_model_struct g_sim_rcu =
+{
+    "rcu", RCU, 0x400U, sim_rcu_reset, NULL, sim_rcu_write, NULL, SIM_NEVER, NULL, 0, NULL
+};
+
+/*!
+    \brief      add every peripheral model to the bus
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note       Called by sim_init, after the core and DWT models.
+*/
+void sim_models_register(void)
+{
+    uint32_t i;
+
+    sim_model_register(&g_sim_flash);
+    sim_model_register(&g_sim_rcu);
+    sim_model_register(&g_sim_fmc);
+    sim_model_register(&g_sim_crc);
+    sim_model_register(&g_sim_hwsem);
+    for(i = 0U; i < 2U; i++)
+    {
+        sim_model_register(&g_sim_dma[i]);
+    }
+    for(i = 0U; i < 6U; i++)
+    {
+        sim_model_register(&g_sim_timer[i]);
+    }
+    sim_usart_register();
+    sim_cau_register();
+}
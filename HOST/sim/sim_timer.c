@@ -0,0 +1,281 @@
+/*!
+    \file       sim_timer.c
+    \brief      timer model of the host build
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - The up-counting time base of TIMER1, TIMER5, TIMER6, TIMER15, TIMER16 and
+      TIMER50: CNT computed from the virtual clock, buffered prescaler, auto
+      reload, update event and flag, single pulse mode
+    - The update interrupt, raised at the exact overflow time
+    - The channel 0 compare flag and interrupt, raised when the count reaches
+      CH0CV, and its software event
+*/
+
+#include <string.h>
+#include "gd32h7xx.h"
+#include "gd32h7xx_timer.h"
+#include "sim.h"
+
+/*!
+    \brief timer model state
+*/
+typedef struct
+{
+    uint32_t periph;
+    int32_t irqn;
+    uint32_t psc;                                                           /* prescaler in use, PSC is loaded on an update */
+    uint32_t base_count;                                                    /* CNT at origin */
+    uint64_t origin;                                                        /* cycle of the last count change by software or overflow */
+    uint64_t compare_at;                                                    /* cycle of the next channel 0 match */
+} sim_timer_state_struct;
+
+static sim_timer_state_struct s_sim_timer[6] =
+{
+    {TIMER1, TIMER1_IRQn, 0, 0, 0, SIM_NEVER},
+    {TIMER5, TIMER5_DAC_UDR_IRQn, 0, 0, 0, SIM_NEVER},
+    {TIMER6, TIMER6_IRQn, 0, 0, 0, SIM_NEVER},
+    {TIMER15, TIMER15_IRQn, 0, 0, 0, SIM_NEVER},
+    {TIMER16, TIMER16_IRQn, 0, 0, 0, SIM_NEVER},
+    {TIMER50, TIMER50_IRQn, 0, 0, 0, SIM_NEVER},
+};
+
+/*!
+    \brief      counter value now
+    \param[in]  s: timer state
+    \param[out] none
+    \retval     CNT
+*/
+static uint32_t sim_timer_count(const sim_timer_state_struct *s)
+{
+    uint64_t ticks;
+
+    if(!(TIMER_CTL0(s->periph) & TIMER_CTL0_CEN))
+    {
+        return s->base_count;
+    }
+    ticks = sim_periph_ticks(sim_cycles() - s->origin) / ((uint64_t)s->psc + 1U);
+    return (uint32_t)(s->base_count + ticks);
+}
+
+/*!
+    \brief      schedule the channel 0 match ahead of the current count
+    \param[in]  s: timer state
+    \param[out] none
+    \retval     none
+    \note       Called when the count or CH0CV changes. A value the counter
+                already reached only matches again after an overflow.
+*/
+static void sim_timer_compare_arm(sim_timer_state_struct *s)
+{
+    uint32_t cv = TIMER_CH0CV(s->periph);
+
+    if(!(TIMER_CTL0(s->periph) & TIMER_CTL0_CEN) || (cv <= sim_timer_count(s)) || (cv > TIMER_CAR(s->periph)))
+    {
+        s->compare_at = SIM_NEVER;
+        return;
+    }
+    s->compare_at = s->origin + sim_periph_cycles(((uint64_t)cv - s->base_count) * ((uint64_t)s->psc + 1U));
+}
+
+/*!
+    \brief      cycle of the next overflow
+    \param[in]  s: timer state
+    \param[out] none
+    \retval     virtual cycle, SIM_NEVER when stopped
+*/
+static uint64_t sim_timer_overflow_at(const sim_timer_state_struct *s)
+{
+    uint32_t car = TIMER_CAR(s->periph);
+    uint64_t ticks;
+
+    if(!(TIMER_CTL0(s->periph) & TIMER_CTL0_CEN) || (s->base_count > car))
+    {
+        return SIM_NEVER;
+    }
+    ticks = ((uint64_t)car - s->base_count + 1U) * ((uint64_t)s->psc + 1U);
+    return s->origin + sim_periph_cycles(ticks);
+}
+
+/*!
+    \brief      restart counting from a value at the current time
+    \param[in]  s: timer state
+    \param[in]  count: CNT from now on
+    \param[out] none
+    \retval     none
+*/
+static void sim_timer_rebase(sim_timer_state_struct *s, uint32_t count)
+{
+    s->base_count = count;
+    s->origin = sim_cycles();
+    TIMER_CNT(s->periph) = count;
+    sim_timer_compare_arm(s);
+}
+
+/*!
+    \brief      update the interrupt line and schedule the next overflow or match
+    \param[in]  m: timer model
+    \param[out] none
+    \retval     none
+*/
+static void sim_timer_update(sim_model_struct *m)
+{
+    sim_timer_state_struct *s = m->state;
+    uint32_t pending = TIMER_DMAINTEN(s->periph) & TIMER_INTF(s->periph);
+    uint64_t at = sim_timer_overflow_at(s);
+
+    sim_irq_set(s->irqn, (pending & (TIMER_INTF_UPIF | TIMER_INTF_CH0IF)) != 0U);
+    sim_schedule(m, (s->compare_at < at) ? s->compare_at : at);
+}
+
+/*!
+    \brief      update event: reload the prescaler, clear the counter, raise UPIF
+    \param[in]  s: timer state
+    \param[in]  flag: 1 to set UPIF
+    \param[out] none
+    \retval     none
+*/
+static void sim_timer_update_event(sim_timer_state_struct *s, uint8_t flag)
+{
+    s->psc = TIMER_PSC(s->periph) & 0xFFFFU;
+    sim_timer_rebase(s, 0U);
+    if(flag)
+    {
+        TIMER_INTF(s->periph) |= TIMER_INTF_UPIF;
+    }
+}
+
+/*!
+    \brief      timer reset
+    \param[in]  m: timer model
+    \param[out] none
+    \retval     none
+*/
+static void sim_timer_reset(sim_model_struct *m)
+{
+    sim_timer_state_struct *s = m->state;
+
+    memset((void *)(uintptr_t)m->base, 0, m->size);
+    TIMER_CAR(s->periph) = (s->periph == TIMER1 || s->periph == TIMER50) ? 0xFFFFFFFFU : 0xFFFFU;
+    s->psc = 0;
+    s->base_count = 0;
+    s->origin = 0;
+    s->compare_at = SIM_NEVER;
+    sim_timer_update(m);
+}
+
+/*!
+    \brief      CNT read follows the clock
+    \param[in]  m: timer model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     none
+*/
+static void sim_timer_read(sim_model_struct *m, uint32_t offset, uint32_t size)
+{
+    sim_timer_state_struct *s = m->state;
+
+    (void)size;
+    if(offset == 0x24U)
+    {
+        TIMER_CNT(s->periph) = sim_timer_count(s);
+    }
+}
+
+/*!
+    \brief      act on a register write
+    \param[in]  m: timer model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[in]  old: previous register content
+    \param[out] none
+    \retval     none
+*/
+static void sim_timer_write(sim_model_struct *m, uint32_t offset, uint32_t size, uint32_t old)
+{
+    sim_timer_state_struct *s = m->state;
+    uint32_t value = SIM_REG32(m->base + (offset & ~3U));
+
+    (void)size;
+    switch(offset & ~3U)
+    {
+        case 0x00U:                                                         /* CTL0: start and stop */
+            if((value ^ old) & TIMER_CTL0_CEN)
+            {
+                /* stopping freezes the count, starting counts from it */
+                TIMER_CTL0(s->periph) = old;
+                s->base_count = sim_timer_count(s);
+                TIMER_CTL0(s->periph) = value;
+                sim_timer_rebase(s, s->base_count);
+            }
+            break;
+        case 0x10U:                                                         /* INTF: write 0 to clear */
+            TIMER_INTF(s->periph) = old & value;
+            break;
+        case 0x14U:                                                         /* SWEVG */
+            if(value & TIMER_SWEVG_UPG)
+            {
+                sim_timer_update_event(s, !(TIMER_CTL0(s->periph) & TIMER_CTL0_UPS));
+            }
+            if(value & TIMER_SWEVG_CH0G)
+            {
+                TIMER_INTF(s->periph) |= TIMER_INTF_CH0IF;
+            }
+            TIMER_SWEVG(s->periph) = 0U;
+            break;
+        case 0x24U:                                                         /* CNT */
+            sim_timer_rebase(s, value);
+            break;
+        case 0x34U:                                                         /* CH0CV */
+            sim_timer_compare_arm(s);
+            break;
+        default:
+            break;
+    }
+    sim_timer_update(m);
+}
+
+/*!
+    \brief      channel 0 match or overflow
+    \param[in]  m: timer model
+    \param[in]  now: virtual cycle
+    \param[out] none
+    \retval     none
+*/
+static void sim_timer_event(sim_model_struct *m, uint64_t now)
+{
+    sim_timer_state_struct *s = m->state;
+
+    if(now >= s->compare_at)
+    {
+        TIMER_INTF(s->periph) |= TIMER_INTF_CH0IF;
+        s->compare_at = SIM_NEVER;
+    }
+    if(now >= sim_timer_overflow_at(s))
+    {
+        sim_timer_update_event(s, !(TIMER_CTL0(s->periph) & TIMER_CTL0_UPDIS));
+        if(TIMER_CTL0(s->periph) & TIMER_CTL0_SPM)
+        {
+            TIMER_CTL0(s->periph) &= ~TIMER_CTL0_CEN;
+            s->compare_at = SIM_NEVER;
+        }
+    }
+    sim_timer_update(m);
+}
+
+#define SIM_TIMER_MODEL(index, name, periph)                                                    \
+    {name, periph, 0x400U, sim_timer_reset, sim_timer_read, sim_timer_write, sim_timer_event,   \
+     SIM_NEVER, &s_sim_timer[index], 0, NULL}
+
+sim_model_struct g_sim_timer[6] =
+{
+    SIM_TIMER_MODEL(0, "timer1", TIMER1),
+    SIM_TIMER_MODEL(1, "timer5", TIMER5),
+    SIM_TIMER_MODEL(2, "timer6", TIMER6),
+    SIM_TIMER_MODEL(3, "timer15", TIMER15),
+    SIM_TIMER_MODEL(4, "timer16", TIMER16),
+    SIM_TIMER_MODEL(5, "timer50", TIMER50),
+};
@@ -0,0 +1,462 @@
+/*!
+    \file       sim_usart.c
+    \brief      USART model of the host build
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - USART0, USART1 and UART4 with 8-byte transmit and receive FIFOs, frame
+      timing from the baud rate register, idle line detection and overrun
+    - Status flags, interrupt line and DMA requests (DENR, DENT)
+    - A virtual line per port: bytes injected by the test arrive at the line
+      rate, transmitted bytes are captured for the test to read
+*/
+
+#include <string.h>
+#include "gd32h7xx.h"
+#include "gd32h7xx_usart.h"
+#include "gd32h7xx_dma.h"
+#include "sim.h"
+
+#define SIM_USART_FIFO              8U                                      /* FIFO depth with FEN, 1 without */
+#define SIM_USART_LINE              4096U                                   /* injected and captured bytes per port */
+#define SIM_USART_FRAME_BITS        10U                                     /* start, 8 data, stop */
+
+/*!
+    \brief USART model state
+*/
+typedef struct
+{
+    uint32_t periph;
+    int32_t irqn;
+    uint32_t rx_request;                                                    /* DMAMUX request ids */
+    uint32_t tx_request;
+    uint8_t rx_fifo[SIM_USART_FIFO];
+    uint8_t rx_count;
+    uint8_t tx_fifo[SIM_USART_FIFO];
+    uint8_t tx_count;
+    uint8_t tx_shifting;                                                    /* a byte is in the shift register */
+    uint8_t idle_armed;                                                     /* a byte arrived since the last IDLE */
+    uint8_t line[SIM_USART_LINE];                                           /* injected bytes not yet received */
+    uint32_t line_head;
+    uint32_t line_count;
+    uint8_t capture[SIM_USART_LINE];                                        /* transmitted bytes not yet taken */
+    uint32_t capture_count;
+    uint64_t rx_at;                                                         /* next byte arrives */
+    uint64_t tx_at;                                                         /* shift register empties */
+    uint64_t idle_at;                                                       /* line idle for one frame */
+} sim_usart_state_struct;
+
+static sim_usart_state_struct s_sim_usart[3];
+
+/*!
+    \brief      FIFO depth in the current mode
+    \param[in]  s: model state
+    \param[out] none
+    \retval     bytes
+*/
+static uint8_t sim_usart_depth(const sim_usart_state_struct *s)
+{
+    return (USART_FCS(s->periph) & USART_FCS_FEN) ? SIM_USART_FIFO : 1U;
+}
+
+/*!
+    \brief      frame time from the baud rate register
+    \param[in]  s: model state
+    \param[out] none
+    \retval     core cycles per character
+*/
+static uint64_t sim_usart_frame(const sim_usart_state_struct *s)
+{
+    uint32_t baud = USART_BAUD(s->periph) & 0xFFFFU;
+    uint32_t bit;
+
+    if(USART_CTL0(s->periph) & USART_CTL0_OVSMOD)
+    {
+        bit = ((baud & 0xFFF0U) | ((baud & 0x7U) << 1)) / 2U;
+    }
+    else
+    {
+        bit = baud;
+    }
+    if(bit == 0U)
+    {
+        bit = 16U;
+    }
+    return sim_periph_cycles((uint64_t)bit * SIM_USART_FRAME_BITS);
+}
+
+/*!
+    \brief      recompute the status flags, the interrupt line and the next event
+    \param[in]  m: USART model
+    \param[out] none
+    \retval     none
+*/
+static void sim_usart_update(sim_model_struct *m)
+{
+    sim_usart_state_struct *s = m->state;
+    uint32_t p = s->periph;
+    uint32_t ctl0 = USART_CTL0(p);
+    uint32_t stat = USART_STAT(p) & (USART_STAT_ORERR | USART_STAT_IDLEF | USART_STAT_TC);
+    uint32_t fcs = USART_FCS(p) & ~(USART_FCS_TFT | USART_FCS_TFE | USART_FCS_TFF | USART_FCS_RFE | USART_FCS_RFF);
+    uint8_t depth = sim_usart_depth(s);
+    static const uint8_t thresholds[8] = {1, 2, 4, 6, 7, 8, 8, 8};
+    uint64_t next;
+    uint8_t level;
+
+    stat |= (s->rx_count != 0U) ? USART_STAT_RBNE : 0U;
+    stat |= (s->tx_count < depth) ? USART_STAT_TBE : 0U;
+    stat |= (s->tx_shifting || (s->line_count != 0U)) ? USART_STAT_BSY : 0U;
+    stat |= ((ctl0 & (USART_CTL0_UEN | USART_CTL0_TEN)) == (USART_CTL0_UEN | USART_CTL0_TEN)) ? USART_STAT_TEA : 0U;
+    stat |= ((ctl0 & (USART_CTL0_UEN | USART_CTL0_REN)) == (USART_CTL0_UEN | USART_CTL0_REN)) ? USART_STAT_REA : 0U;
+    USART_STAT(p) = stat;
+
+    fcs |= (s->tx_count == 0U) ? USART_FCS_TFE : 0U;
+    fcs |= (s->tx_count >= depth) ? USART_FCS_TFF : 0U;
+    fcs |= (s->rx_count == 0U) ? USART_FCS_RFE : 0U;
+    fcs |= (s->rx_count >= depth) ? USART_FCS_RFF : 0U;
+    if((fcs & USART_FCS_FEN) && (s->tx_count >= thresholds[(fcs & USART_FCS_TFTCFG) >> 19]))
+    {
+        fcs |= USART_FCS_TFT;
+    }
+    USART_FCS(p) = fcs;
+
+    level = ((ctl0 & USART_CTL0_IDLEIE) && (stat & USART_STAT_IDLEF)) ||
+            ((ctl0 & USART_CTL0_RBNEIE) && (stat & (USART_STAT_RBNE | USART_STAT_ORERR))) ||
+            ((ctl0 & USART_CTL0_TCIE) && (stat & USART_STAT_TC)) ||
+            ((ctl0 & USART_CTL0_TBEIE) && (stat & USART_STAT_TBE));
+    sim_irq_set(s->irqn, level);
+
+    next = s->rx_at;
+    next = (s->tx_at < next) ? s->tx_at : next;
+    next = (s->idle_at < next) ? s->idle_at : next;
+    if(next != m->next_event)
+    {
+        sim_schedule(m, next);
+    }
+}
+
+/*!
+    \brief      move the next byte from the FIFO to the shift register
+    \param[in]  s: model state
+    \param[out] none
+    \retval     none
+*/
+static void sim_usart_tx_start(sim_usart_state_struct *s)
+{
+    if(s->tx_shifting || (s->tx_count == 0U))
+    {
+        return;
+    }
+    s->tx_shifting = 1;
+    s->tx_at = sim_cycles() + sim_usart_frame(s);
+}
+
+/*!
+    \brief      DMA receive request: DENR and data in the FIFO
+    \param[in]  arg: USART model
+    \param[out] none
+    \retval     1 while requesting
+*/
+static uint8_t sim_usart_rx_active(void *arg)
+{
+    sim_usart_state_struct *s = ((sim_model_struct *)arg)->state;
+
+    return (USART_CTL2(s->periph) & USART_CTL2_DENR) && (s->rx_count != 0U);
+}
+
+/*!
+    \brief      DMA transmit request: DENT, TEN and room in the FIFO
+    \param[in]  arg: USART model
+    \param[out] none
+    \retval     1 while requesting
+*/
+static uint8_t sim_usart_tx_active(void *arg)
+{
+    sim_usart_state_struct *s = ((sim_model_struct *)arg)->state;
+
+    return (USART_CTL2(s->periph) & USART_CTL2_DENT) && (USART_CTL0(s->periph) & USART_CTL0_TEN) &&
+           (s->tx_count < sim_usart_depth(s));
+}
+
+/*!
+    \brief      USART reset: registers and line
+    \param[in]  m: USART model
+    \param[out] none
+    \retval     none
+*/
+static void sim_usart_reset(sim_model_struct *m)
+{
+    sim_usart_state_struct *s = m->state;
+    uint32_t periph = s->periph;
+    int32_t irqn = s->irqn;
+    uint32_t rx_request = s->rx_request, tx_request = s->tx_request;
+
+    memset((void *)(uintptr_t)m->base, 0, m->size);
+    memset(s, 0, sizeof(*s));
+    s->periph = periph;
+    s->irqn = irqn;
+    s->rx_request = rx_request;
+    s->tx_request = tx_request;
+    s->rx_at = s->tx_at = s->idle_at = SIM_NEVER;
+    USART_STAT(periph) = USART_STAT_TC | USART_STAT_TBE;
+    sim_usart_update(m);
+}
+
+/*!
+    \brief      RDATA read pops the receive FIFO
+    \param[in]  m: USART model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[out] none
+    \retval     none
+*/
+static void sim_usart_read(sim_model_struct *m, uint32_t offset, uint32_t size)
+{
+    sim_usart_state_struct *s = m->state;
+
+    (void)size;
+    if((offset != 0x24U) || (s->rx_count == 0U))
+    {
+        return;
+    }
+    USART_RDATA(s->periph) = s->rx_fifo[0];
+    memmove(s->rx_fifo, s->rx_fifo + 1, --s->rx_count);
+    sim_usart_update(m);
+}
+
+/*!
+    \brief      act on a register write
+    \param[in]  m: USART model
+    \param[in]  offset: register offset
+    \param[in]  size: bytes
+    \param[in]  old: previous register content
+    \param[out] none
+    \retval     none
+*/
+static void sim_usart_write(sim_model_struct *m, uint32_t offset, uint32_t size, uint32_t old)
+{
+    sim_usart_state_struct *s = m->state;
+    uint32_t p = s->periph;
+    uint32_t value = SIM_REG32(m->base + (offset & ~3U));
+
+    (void)size;
+    switch(offset & ~3U)
+    {
+        case 0x1CU:                                                         /* STAT is read-only */
+            USART_STAT(p) = old;
+            break;
+        case 0x20U:                                                         /* INTC: write 1 to clear */
+            USART_STAT(p) &= ~(value & (USART_INTC_OREC | USART_INTC_IDLEC | USART_INTC_TCC));
+            USART_INTC(p) = 0U;
+            break;
+        case 0x28U:                                                         /* TDATA */
+            if(((USART_CTL0(p) & (USART_CTL0_UEN | USART_CTL0_TEN)) == (USART_CTL0_UEN | USART_CTL0_TEN)) &&
+               (s->tx_count < sim_usart_depth(s)))
+            {
+                s->tx_fifo[s->tx_count++] = (uint8_t)value;
+                USART_STAT(p) &= ~USART_STAT_TC;
+                sim_usart_tx_start(s);
+            }
+            break;
+        default:
+            break;
+    }
+    sim_usart_update(m);
+    sim_dma_kick(s->rx_request);
+    sim_dma_kick(s->tx_request);
+}
+
+/*!
+    \brief      line events: byte received, byte sent, idle line
+    \param[in]  m: USART model
+    \param[in]  now: virtual cycle
+    \param[out] none
+    \retval     none
+*/
+static void sim_usart_event(sim_model_struct *m, uint64_t now)
+{
+    sim_usart_state_struct *s = m->state;
+    uint32_t p = s->periph;
+    uint64_t frame = sim_usart_frame(s);
+
+    if(s->rx_at <= now)
+    {
+        s->rx_at = SIM_NEVER;
+        if((USART_CTL0(p) & (USART_CTL0_UEN | USART_CTL0_REN)) == (USART_CTL0_UEN | USART_CTL0_REN))
+        {
+            if(s->rx_count < sim_usart_depth(s))
+            {
+                s->rx_fifo[s->rx_count++] = s->line[s->line_head];
+            }
+            else
+            {
+                USART_STAT(p) |= USART_STAT_ORERR;
+            }
+            s->idle_armed = 1;
+            s->idle_at = now + frame;
+        }
+        s->line_head = (s->line_head + 1U) % SIM_USART_LINE;
+        s->line_count--;
+        if(s->line_count != 0U)
+        {
+            s->rx_at = now + frame;
+            s->idle_at = SIM_NEVER;
+        }
+    }
+    if(s->idle_at <= now)
+    {
+        s->idle_at = SIM_NEVER;
+        if(s->idle_armed)
+        {
+            s->idle_armed = 0;
+            USART_STAT(p) |= USART_STAT_IDLEF;
+        }
+    }
+    if(s->tx_at <= now)
+    {
+        s->tx_at = SIM_NEVER;
+        s->tx_shifting = 0;
+        if(s->capture_count < SIM_USART_LINE)
+        {
+            s->capture[s->capture_count++] = s->tx_fifo[0];
+        }
+        memmove(s->tx_fifo, s->tx_fifo + 1, --s->tx_count);
+        if(s->tx_count != 0U)
+        {
+            sim_usart_tx_start(s);
+        }
+        else
+        {
+            USART_STAT(p) |= USART_STAT_TC;
+        }
+    }
+    sim_usart_update(m);
+    sim_dma_kick(s->rx_request);
+    sim_dma_kick(s->tx_request);
+}
+
+#define SIM_USART_MODEL(index, name, periph)                                                    \
+    {name, periph, 0x400U, sim_usart_reset, sim_usart_read, sim_usart_write, sim_usart_event,   \
+     SIM_NEVER, &s_sim_usart[index], 0, NULL}
+
+sim_model_struct g_sim_usart[3] =
+{
+    SIM_USART_MODEL(0, "usart0", USART0),
+    SIM_USART_MODEL(1, "usart1", USART1),
+    SIM_USART_MODEL(2, "uart4", UART4),
+};
+
+/*!
+    \brief      register the USART models and their DMA requests
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void sim_usart_register(void)
+{
+    static const struct
+    {
+        uint32_t periph;
+        int32_t irqn;
+        uint32_t rx_request;
+        uint32_t tx_request;
+    } ports[3] =
+    {
+        {USART0, USART0_IRQn, DMA_REQUEST_USART0_RX, DMA_REQUEST_USART0_TX},
+        {USART1, USART1_IRQn, DMA_REQUEST_USART1_RX, DMA_REQUEST_USART1_TX},
+        {UART4, UART4_IRQn, DMA_REQUEST_UART4_RX, DMA_REQUEST_UART4_TX},
+    };
+    uint32_t i;
+
+    for(i = 0; i < 3U; i++)
+    {
+        s_sim_usart[i].periph = ports[i].periph;
+        s_sim_usart[i].irqn = ports[i].irqn;
+        s_sim_usart[i].rx_request = ports[i].rx_request;
+        s_sim_usart[i].tx_request = ports[i].tx_request;
+        sim_model_register(&g_sim_usart[i]);
+        sim_dma_request_register(ports[i].rx_request, sim_usart_rx_active, &g_sim_usart[i]);
+        sim_dma_request_register(ports[i].tx_request, sim_usart_tx_active, &g_sim_usart[i]);
+    }
+}
+
+/*!
+    \brief      model of a USART base address
+    \param[in]  usart_periph: USART0, USART1 or UART4
+    \param[out] none
+    \retval     model, NULL if the port is not modelled
+*/
+static sim_model_struct *sim_usart_find(uint32_t usart_periph)
+{
+    uint32_t i;
+
+    for(i = 0; i < 3U; i++)
+    {
+        if(g_sim_usart[i].base == usart_periph)
+        {
+            return &g_sim_usart[i];
+        }
+    }
+    return NULL;
+}
+
+/*!
+    \brief      queue bytes on the RX line of a port
+    \param[in]  usart_periph: USART0, USART1 or UART4
+    \param[in]  data: bytes
+    \param[in]  length: number of bytes, extra bytes beyond the line buffer are dropped
+    \param[out] none
+    \retval     none
+    \note       The bytes arrive back to back at the configured baud rate,
+                starting one frame from now; run virtual time to receive them.
+*/
+void sim_usart_inject(uint32_t usart_periph, const void *data, uint32_t length)
+{
+    sim_model_struct *m = sim_usart_find(usart_periph);
+    sim_usart_state_struct *s;
+    const uint8_t *bytes = data;
+
+    if(m == NULL)
+    {
+        return;
+    }
+    s = m->state;
+    while((length-- != 0U) && (s->line_count < SIM_USART_LINE))
+    {
+        s->line[(s->line_head + s->line_count) % SIM_USART_LINE] = *bytes++;
+        s->line_count++;
+    }
+    if((s->rx_at == SIM_NEVER) && (s->line_count != 0U))
+    {
+        s->rx_at = sim_cycles() + sim_usart_frame(s);
+        s->idle_at = SIM_NEVER;
+    }
+    sim_usart_update(m);
+}
+
+/*!
+    \brief      take the bytes transmitted by a port
+    \param[in]  usart_periph: USART0, USART1 or UART4
+    \param[in]  size: room in data
+    \param[out] data: transmitted bytes, oldest first
+    \retval     number of bytes copied
+*/
+uint32_t sim_usart_capture(uint32_t usart_periph, void *data, uint32_t size)
+{
+    sim_model_struct *m = sim_usart_find(usart_periph);
+    sim_usart_state_struct *s;
+    uint32_t n;
+
+    if(m == NULL)
+    {
+        return 0U;
+    }
+    s = m->state;
+    n = (s->capture_count < size) ? s->capture_count : size;
+    memcpy(data, s->capture, n);
+    memmove(s->capture, s->capture + n, s->capture_count - n);
+    s->capture_count -= n;
+    return n;
+}
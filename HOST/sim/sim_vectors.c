@@ -0,0 +1,381 @@
+/*!
+    \file       sim_vectors.c
+    \brief      vector table of the host build
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This file provides functions for:
+    - The handler of every exception number, taken from the vector table in
+      CORE/startup_gd32h7xx.s. Handlers are weak references, so only those
+      the BSP defines are linked and the others dispatch nothing.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void (*sim_handler_func)(void);
+
+void NMI_Handler(void) __attribute__((weak));
+void HardFault_Handler(void) __attribute__((weak));
+void MemManage_Handler(void) __attribute__((weak));
+void BusFault_Handler(void) __attribute__((weak));
+void UsageFault_Handler(void) __attribute__((weak));
+void SVC_Handler(void) __attribute__((weak));
+void DebugMon_Handler(void) __attribute__((weak));
+void PendSV_Handler(void) __attribute__((weak));
+void SysTick_Handler(void) __attribute__((weak));
+void WWDGT_IRQHandler(void) __attribute__((weak));
+void AVD_LVD_OVD_IRQHandler(void) __attribute__((weak));
+void TAMPER_STAMP_LXTAL_IRQHandler(void) __attribute__((weak));
+void RTC_WKUP_IRQHandler(void) __attribute__((weak));
+void FMC_IRQHandler(void) __attribute__((weak));
+void RCU_IRQHandler(void) __attribute__((weak));
+void EXTI0_IRQHandler(void) __attribute__((weak));
+void EXTI1_IRQHandler(void) __attribute__((weak));
+void EXTI2_IRQHandler(void) __attribute__((weak));
+void EXTI3_IRQHandler(void) __attribute__((weak));
+void EXTI4_IRQHandler(void) __attribute__((weak));
+void DMA0_Channel0_IRQHandler(void) __attribute__((weak));
+void DMA0_Channel1_IRQHandler(void) __attribute__((weak));
+void DMA0_Channel2_IRQHandler(void) __attribute__((weak));
+void DMA0_Channel3_IRQHandler(void) __attribute__((weak));
+void DMA0_Channel4_IRQHandler(void) __attribute__((weak));
+void DMA0_Channel5_IRQHandler(void) __attribute__((weak));
+void DMA0_Channel6_IRQHandler(void) __attribute__((weak));
+void ADC0_1_IRQHandler(void) __attribute__((weak));
+void EXTI5_9_IRQHandler(void) __attribute__((weak));
+void TIMER0_BRK_IRQHandler(void) __attribute__((weak));
+void TIMER0_UP_IRQHandler(void) __attribute__((weak));
+void TIMER0_TRG_CMT_IRQHandler(void) __attribute__((weak));
+void TIMER0_Channel_IRQHandler(void) __attribute__((weak));
+void TIMER1_IRQHandler(void) __attribute__((weak));
+void TIMER2_IRQHandler(void) __attribute__((weak));
+void TIMER3_IRQHandler(void) __attribute__((weak));
+void I2C0_EV_IRQHandler(void) __attribute__((weak));
+void I2C0_ER_IRQHandler(void) __attribute__((weak));
+void I2C1_EV_IRQHandler(void) __attribute__((weak));
+void I2C1_ER_IRQHandler(void) __attribute__((weak));
+void SPI0_IRQHandler(void) __attribute__((weak));
+void SPI1_IRQHandler(void) __attribute__((weak));
+void USART0_IRQHandler(void) __attribute__((weak));
+void USART1_IRQHandler(void) __attribute__((weak));
+void USART2_IRQHandler(void) __attribute__((weak));
+void EXTI10_15_IRQHandler(void) __attribute__((weak));
+void RTC_Alarm_IRQHandler(void) __attribute__((weak));
+void TIMER7_BRK_IRQHandler(void) __attribute__((weak));
+void TIMER7_UP_IRQHandler(void) __attribute__((weak));
+void TIMER7_TRG_CMT_IRQHandler(void) __attribute__((weak));
+void TIMER7_Channel_IRQHandler(void) __attribute__((weak));
+void DMA0_Channel7_IRQHandler(void) __attribute__((weak));
+void EXMC_IRQHandler(void) __attribute__((weak));
+void SDIO0_IRQHandler(void) __attribute__((weak));
+void TIMER4_IRQHandler(void) __attribute__((weak));
+void SPI2_IRQHandler(void) __attribute__((weak));
+void UART3_IRQHandler(void) __attribute__((weak));
+void UART4_IRQHandler(void) __attribute__((weak));
+void TIMER5_DAC_UDR_IRQHandler(void) __attribute__((weak));
+void TIMER6_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel0_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel1_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel2_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel3_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel4_IRQHandler(void) __attribute__((weak));
+void ENET0_IRQHandler(void) __attribute__((weak));
+void ENET0_WKUP_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel5_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel6_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel7_IRQHandler(void) __attribute__((weak));
+void USART5_IRQHandler(void) __attribute__((weak));
+void I2C2_EV_IRQHandler(void) __attribute__((weak));
+void I2C2_ER_IRQHandler(void) __attribute__((weak));
+void USBHS0_EP1_OUT_IRQHandler(void) __attribute__((weak));
+void USBHS0_EP1_IN_IRQHandler(void) __attribute__((weak));
+void USBHS0_WKUP_IRQHandler(void) __attribute__((weak));
+void USBHS0_IRQHandler(void) __attribute__((weak));
+void DCI_IRQHandler(void) __attribute__((weak));
+void CAU_IRQHandler(void) __attribute__((weak));
+void HAU_TRNG_IRQHandler(void) __attribute__((weak));
+void FPU_IRQHandler(void) __attribute__((weak));
+void UART6_IRQHandler(void) __attribute__((weak));
+void UART7_IRQHandler(void) __attribute__((weak));
+void SPI3_IRQHandler(void) __attribute__((weak));
+void SPI4_IRQHandler(void) __attribute__((weak));
+void SPI5_IRQHandler(void) __attribute__((weak));
+void SAI0_IRQHandler(void) __attribute__((weak));
+void TLI_IRQHandler(void) __attribute__((weak));
+void TLI_ER_IRQHandler(void) __attribute__((weak));
+void IPA_IRQHandler(void) __attribute__((weak));
+void SAI1_IRQHandler(void) __attribute__((weak));
+void OSPI0_IRQHandler(void) __attribute__((weak));
+void I2C3_EV_IRQHandler(void) __attribute__((weak));
+void I2C3_ER_IRQHandler(void) __attribute__((weak));
+void RSPDIF_IRQHandler(void) __attribute__((weak));
+void DMAMUX_OVR_IRQHandler(void) __attribute__((weak));
+void HPDF_INT0_IRQHandler(void) __attribute__((weak));
+void HPDF_INT1_IRQHandler(void) __attribute__((weak));
+void HPDF_INT2_IRQHandler(void) __attribute__((weak));
+void HPDF_INT3_IRQHandler(void) __attribute__((weak));
+void SAI2_IRQHandler(void) __attribute__((weak));
+void TIMER14_IRQHandler(void) __attribute__((weak));
+void TIMER15_IRQHandler(void) __attribute__((weak));
+void TIMER16_IRQHandler(void) __attribute__((weak));
+void MDIO_IRQHandler(void) __attribute__((weak));
+void MDMA_IRQHandler(void) __attribute__((weak));
+void SDIO1_IRQHandler(void) __attribute__((weak));
+void HWSEM_IRQHandler(void) __attribute__((weak));
+void ADC2_IRQHandler(void) __attribute__((weak));
+void CMP0_1_IRQHandler(void) __attribute__((weak));
+void CTC_IRQHandler(void) __attribute__((weak));
+void RAMECCMU_IRQHandler(void) __attribute__((weak));
+void OSPI1_IRQHandler(void) __attribute__((weak));
+void RTDEC0_IRQHandler(void) __attribute__((weak));
+void RTDEC1_IRQHandler(void) __attribute__((weak));
+void FAC_IRQHandler(void) __attribute__((weak));
+void TMU_IRQHandler(void) __attribute__((weak));
+void TIMER22_IRQHandler(void) __attribute__((weak));
+void TIMER23_IRQHandler(void) __attribute__((weak));
+void TIMER30_IRQHandler(void) __attribute__((weak));
+void TIMER31_IRQHandler(void) __attribute__((weak));
+void TIMER40_IRQHandler(void) __attribute__((weak));
+void TIMER41_IRQHandler(void) __attribute__((weak));
+void TIMER42_IRQHandler(void) __attribute__((weak));
+void TIMER43_IRQHandler(void) __attribute__((weak));
+void TIMER44_IRQHandler(void) __attribute__((weak));
+void TIMER50_IRQHandler(void) __attribute__((weak));
+void TIMER51_IRQHandler(void) __attribute__((weak));
+void USBHS1_EP1_OUT_IRQHandler(void) __attribute__((weak));
+void USBHS1_EP1_IN_IRQHandler(void) __attribute__((weak));
+void USBHS1_WKUP_IRQHandler(void) __attribute__((weak));
+void USBHS1_IRQHandler(void) __attribute__((weak));
+void ENET1_IRQHandler(void) __attribute__((weak));
+void ENET1_WKUP_IRQHandler(void) __attribute__((weak));
+void CAN0_WKUP_IRQHandler(void) __attribute__((weak));
+void CAN0_Message_IRQHandler(void) __attribute__((weak));
+void CAN0_Busoff_IRQHandler(void) __attribute__((weak));
+void CAN0_Error_IRQHandler(void) __attribute__((weak));
+void CAN0_FastError_IRQHandler(void) __attribute__((weak));
+void CAN0_TEC_IRQHandler(void) __attribute__((weak));
+void CAN0_REC_IRQHandler(void) __attribute__((weak));
+void CAN1_WKUP_IRQHandler(void) __attribute__((weak));
+void CAN1_Message_IRQHandler(void) __attribute__((weak));
+void CAN1_Busoff_IRQHandler(void) __attribute__((weak));
+void CAN1_Error_IRQHandler(void) __attribute__((weak));
+void CAN1_FastError_IRQHandler(void) __attribute__((weak));
+void CAN1_TEC_IRQHandler(void) __attribute__((weak));
+void CAN1_REC_IRQHandler(void) __attribute__((weak));
+void CAN2_WKUP_IRQHandler(void) __attribute__((weak));
+void CAN2_Message_IRQHandler(void) __attribute__((weak));
+void CAN2_Busoff_IRQHandler(void) __attribute__((weak));
+void CAN2_Error_IRQHandler(void) __attribute__((weak));
+void CAN2_FastError_IRQHandler(void) __attribute__((weak));
+void CAN2_TEC_IRQHandler(void) __attribute__((weak));
+void CAN2_REC_IRQHandler(void) __attribute__((weak));
+void EFUSE_IRQHandler(void) __attribute__((weak));
+void I2C0_WKUP_IRQHandler(void) __attribute__((weak));
+void I2C1_WKUP_IRQHandler(void) __attribute__((weak));
+void I2C2_WKUP_IRQHandler(void) __attribute__((weak));
+void I2C3_WKUP_IRQHandler(void) __attribute__((weak));
+void LPDTS_IRQHandler(void) __attribute__((weak));
+void LPDTS_WKUP_IRQHandler(void) __attribute__((weak));
+void TIMER0_DEC_IRQHandler(void) __attribute__((weak));
+void TIMER7_DEC_IRQHandler(void) __attribute__((weak));
+void TIMER1_DEC_IRQHandler(void) __attribute__((weak));
+void TIMER2_DEC_IRQHandler(void) __attribute__((weak));
+void TIMER3_DEC_IRQHandler(void) __attribute__((weak));
+void TIMER4_DEC_IRQHandler(void) __attribute__((weak));
+void TIMER22_DEC_IRQHandler(void) __attribute__((weak));
+void TIMER23_DEC_IRQHandler(void) __attribute__((weak));
+void TIMER30_DEC_IRQHandler(void) __attribute__((weak));
+void TIMER31_DEC_IRQHandler(void) __attribute__((weak));
+
+static sim_handler_func const s_sim_vectors[] =
+{
+    [2] = NMI_Handler,
+    [3] = HardFault_Handler,
+    [4] = MemManage_Handler,
+    [5] = BusFault_Handler,
+    [6] = UsageFault_Handler,
+    [11] = SVC_Handler,
+    [12] = DebugMon_Handler,
+    [14] = PendSV_Handler,
+    [15] = SysTick_Handler,
+    [16] = WWDGT_IRQHandler,
+    [17] = AVD_LVD_OVD_IRQHandler,
+    [18] = TAMPER_STAMP_LXTAL_IRQHandler,
+    [19] = RTC_WKUP_IRQHandler,
+    [20] = FMC_IRQHandler,
+    [21] = RCU_IRQHandler,
+    [22] = EXTI0_IRQHandler,
+    [23] = EXTI1_IRQHandler,
+    [24] = EXTI2_IRQHandler,
+    [25] = EXTI3_IRQHandler,
+    [26] = EXTI4_IRQHandler,
+    [27] = DMA0_Channel0_IRQHandler,
+    [28] = DMA0_Channel1_IRQHandler,
+    [29] = DMA0_Channel2_IRQHandler,
+    [30] = DMA0_Channel3_IRQHandler,
+    [31] = DMA0_Channel4_IRQHandler,
+    [32] = DMA0_Channel5_IRQHandler,
+    [33] = DMA0_Channel6_IRQHandler,
+    [34] = ADC0_1_IRQHandler,
+    [39] = EXTI5_9_IRQHandler,
+    [40] = TIMER0_BRK_IRQHandler,
+    [41] = TIMER0_UP_IRQHandler,
+    [42] = TIMER0_TRG_CMT_IRQHandler,
+    [43] = TIMER0_Channel_IRQHandler,
+    [44] = TIMER1_IRQHandler,
+    [45] = TIMER2_IRQHandler,
+    [46] = TIMER3_IRQHandler,
+    [47] = I2C0_EV_IRQHandler,
+    [48] = I2C0_ER_IRQHandler,
+    [49] = I2C1_EV_IRQHandler,
+    [50] = I2C1_ER_IRQHandler,
+    [51] = SPI0_IRQHandler,
+    [52] = SPI1_IRQHandler,
+    [53] = USART0_IRQHandler,
+    [54] = USART1_IRQHandler,
+    [55] = USART2_IRQHandler,
+    [56] = EXTI10_15_IRQHandler,
+    [57] = RTC_Alarm_IRQHandler,
+    [59] = TIMER7_BRK_IRQHandler,
+    [60] = TIMER7_UP_IRQHandler,
+    [61] = TIMER7_TRG_CMT_IRQHandler,
+    [62] = TIMER7_Channel_IRQHandler,
+    [63] = DMA0_Channel7_IRQHandler,
+    [64] = EXMC_IRQHandler,
+    [65] = SDIO0_IRQHandler,
+    [66] = TIMER4_IRQHandler,
+    [67] = SPI2_IRQHandler,
+    [68] = UART3_IRQHandler,
+    [69] = UART4_IRQHandler,
+    [70] = TIMER5_DAC_UDR_IRQHandler,
+    [71] = TIMER6_IRQHandler,
+    [72] = DMA1_Channel0_IRQHandler,
+    [73] = DMA1_Channel1_IRQHandler,
+    [74] = DMA1_Channel2_IRQHandler,
+    [75] = DMA1_Channel3_IRQHandler,
+    [76] = DMA1_Channel4_IRQHandler,
+    [77] = ENET0_IRQHandler,
+    [78] = ENET0_WKUP_IRQHandler,
+    [84] = DMA1_Channel5_IRQHandler,
+    [85] = DMA1_Channel6_IRQHandler,
+    [86] = DMA1_Channel7_IRQHandler,
+    [87] = USART5_IRQHandler,
+    [88] = I2C2_EV_IRQHandler,
+    [89] = I2C2_ER_IRQHandler,
+    [90] = USBHS0_EP1_OUT_IRQHandler,
+    [91] = USBHS0_EP1_IN_IRQHandler,
+    [92] = USBHS0_WKUP_IRQHandler,
+    [93] = USBHS0_IRQHandler,
+    [94] = DCI_IRQHandler,
+    [95] = CAU_IRQHandler,
+    [96] = HAU_TRNG_IRQHandler,
+    [97] = FPU_IRQHandler,
+    [98] = UART6_IRQHandler,
+    [99] = UART7_IRQHandler,
+    [100] = SPI3_IRQHandler,
+    [101] = SPI4_IRQHandler,
+    [102] = SPI5_IRQHandler,
+    [103] = SAI0_IRQHandler,
+    [104] = TLI_IRQHandler,
+    [105] = TLI_ER_IRQHandler,
+    [106] = IPA_IRQHandler,
+    [107] = SAI1_IRQHandler,
+    [108] = OSPI0_IRQHandler,
+    [111] = I2C3_EV_IRQHandler,
+    [112] = I2C3_ER_IRQHandler,
+    [113] = RSPDIF_IRQHandler,
+    [118] = DMAMUX_OVR_IRQHandler,
+    [126] = HPDF_INT0_IRQHandler,
+    [127] = HPDF_INT1_IRQHandler,
+    [128] = HPDF_INT2_IRQHandler,
+    [129] = HPDF_INT3_IRQHandler,
+    [130] = SAI2_IRQHandler,
+    [132] = TIMER14_IRQHandler,
+    [133] = TIMER15_IRQHandler,
+    [134] = TIMER16_IRQHandler,
+    [136] = MDIO_IRQHandler,
+    [138] = MDMA_IRQHandler,
+    [140] = SDIO1_IRQHandler,
+    [141] = HWSEM_IRQHandler,
+    [143] = ADC2_IRQHandler,
+    [153] = CMP0_1_IRQHandler,
+    [160] = CTC_IRQHandler,
+    [161] = RAMECCMU_IRQHandler,
+    [166] = OSPI1_IRQHandler,
+    [167] = RTDEC0_IRQHandler,
+    [168] = RTDEC1_IRQHandler,
+    [169] = FAC_IRQHandler,
+    [170] = TMU_IRQHandler,
+    [177] = TIMER22_IRQHandler,
+    [178] = TIMER23_IRQHandler,
+    [179] = TIMER30_IRQHandler,
+    [180] = TIMER31_IRQHandler,
+    [181] = TIMER40_IRQHandler,
+    [182] = TIMER41_IRQHandler,
+    [183] = TIMER42_IRQHandler,
+    [184] = TIMER43_IRQHandler,
+    [185] = TIMER44_IRQHandler,
+    [186] = TIMER50_IRQHandler,
+    [187] = TIMER51_IRQHandler,
+    [188] = USBHS1_EP1_OUT_IRQHandler,
+    [189] = USBHS1_EP1_IN_IRQHandler,
+    [190] = USBHS1_WKUP_IRQHandler,
+    [191] = USBHS1_IRQHandler,
+    [192] = ENET1_IRQHandler,
+    [193] = ENET1_WKUP_IRQHandler,
+    [195] = CAN0_WKUP_IRQHandler,
+    [196] = CAN0_Message_IRQHandler,
+    [197] = CAN0_Busoff_IRQHandler,
+    [198] = CAN0_Error_IRQHandler,
+    [199] = CAN0_FastError_IRQHandler,
+    [200] = CAN0_TEC_IRQHandler,
+    [201] = CAN0_REC_IRQHandler,
+    [202] = CAN1_WKUP_IRQHandler,
+    [203] = CAN1_Message_IRQHandler,
+    [204] = CAN1_Busoff_IRQHandler,
+    [205] = CAN1_Error_IRQHandler,
+    [206] = CAN1_FastError_IRQHandler,
+    [207] = CAN1_TEC_IRQHandler,
+    [208] = CAN1_REC_IRQHandler,
+    [209] = CAN2_WKUP_IRQHandler,
+    [210] = CAN2_Message_IRQHandler,
+    [211] = CAN2_Busoff_IRQHandler,
+    [212] = CAN2_Error_IRQHandler,
+    [213] = CAN2_FastError_IRQHandler,
+    [214] = CAN2_TEC_IRQHandler,
+    [215] = CAN2_REC_IRQHandler,
+    [216] = EFUSE_IRQHandler,
+    [217] = I2C0_WKUP_IRQHandler,
+    [218] = I2C1_WKUP_IRQHandler,
+    [219] = I2C2_WKUP_IRQHandler,
+    [220] = I2C3_WKUP_IRQHandler,
+    [221] = LPDTS_IRQHandler,
+    [222] = LPDTS_WKUP_IRQHandler,
+    [223] = TIMER0_DEC_IRQHandler,
+    [224] = TIMER7_DEC_IRQHandler,
+    [225] = TIMER1_DEC_IRQHandler,
+    [226] = TIMER2_DEC_IRQHandler,
+    [227] = TIMER3_DEC_IRQHandler,
+    [228] = TIMER4_DEC_IRQHandler,
+    [229] = TIMER22_DEC_IRQHandler,
+    [230] = TIMER23_DEC_IRQHandler,
+    [231] = TIMER30_DEC_IRQHandler,
+    [232] = TIMER31_DEC_IRQHandler,
+};
+
+/*!
+    \brief      handler of an exception
+    \param[in]  exception: exception number, IRQn + 16
+    \param[out] none
+    \retval     handler, NULL if none is linked
+*/
+sim_handler_func sim_vector_get(uint32_t exception)
+{
+    if(exception >= sizeof(s_sim_vectors) / sizeof(s_sim_vectors[0]))
+    {
+        return NULL;
+    }
+    return s_sim_vectors[exception];
+}
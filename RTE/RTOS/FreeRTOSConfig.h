@@ -0,0 +1,107 @@
+/*!
+    \file       FreeRTOSConfig.h
+    \brief      FreeRTOS kernel configuration for the RTOS build type
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This header file provides:
+    - Static allocation only: no heap, every kernel object lives in .bss
+    - Tickless idle routed to BSP/RTOS, which picks sleep or deep-sleep
+      through BSP/IDLE
+    - Run-time statistics on TIMER50 (BSP/TIMER)
+    - Interrupt priority split for NVIC_PRIGROUP_PRE4_SUB0: priorities 0-3
+      are never masked by the kernel and must not call the FreeRTOS API
+
+    Config file of the ARM::RTOS&FreeRTOS:Config&FreeRTOS component, used when
+    the project is built with the RTOS build type (SYSTEM_SUPPORT_OS=1).
+*/
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__ARMCC_VERSION) || defined(__GNUC__)
+#include <stdint.h>
+extern uint32_t SystemCoreClock;
+extern void ConfigureTimeForRunTimeStats(void);
+extern uint64_t GetTimeForRunTimeCount(void);
+extern void rtos_suppress_ticks(uint32_t expected_ticks);
+extern void rtos_sleep_pre(void);
+extern void rtos_sleep_post(void);
+#endif
+
+/* scheduler */
+#define configUSE_PREEMPTION                        1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION     1
+#define configCPU_CLOCK_HZ                          (SystemCoreClock)
+#define configTICK_RATE_HZ                          1000
+#define configMAX_PRIORITIES                        8
+#define configMINIMAL_STACK_SIZE                    256
+#define configMAX_TASK_NAME_LEN                     16
+#define configUSE_16_BIT_TICKS                      0
+#define configIDLE_SHOULD_YIELD                     1
+#define configUSE_TASK_NOTIFICATIONS                1
+#define configUSE_MUTEXES                           1
+#define configUSE_RECURSIVE_MUTEXES                 1
+#define configUSE_COUNTING_SEMAPHORES               1
+#define configQUEUE_REGISTRY_SIZE                   8
+#define configUSE_TIME_SLICING                      1
+
+/* memory: static allocation only */
+#define configSUPPORT_STATIC_ALLOCATION             1
+#define configSUPPORT_DYNAMIC_ALLOCATION            0
+#define configTOTAL_HEAP_SIZE                       0
+
+/* hooks */
+#define configUSE_IDLE_HOOK                         0
+#define configUSE_TICK_HOOK                         0
+#define configCHECK_FOR_STACK_OVERFLOW              2
+#define configUSE_MALLOC_FAILED_HOOK                0
+
+/* tickless idle: below two ticks the idle task just executes WFI */
+#define configUSE_TICKLESS_IDLE                     1
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP       2
+#define portSUPPRESS_TICKS_AND_SLEEP(x)             rtos_suppress_ticks(x)
+#define configPRE_SLEEP_PROCESSING(x)               rtos_sleep_pre()
+#define configPOST_SLEEP_PROCESSING(x)              rtos_sleep_post()
+
+/* run-time statistics on TIMER50 */
+#define configGENERATE_RUN_TIME_STATS               1
+#define configRUN_TIME_COUNTER_TYPE                 uint64_t
+#define configUSE_TRACE_FACILITY                    1
+#define configUSE_STATS_FORMATTING_FUNCTIONS        1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    ConfigureTimeForRunTimeStats()
+#define portGET_RUN_TIME_COUNTER_VALUE()            GetTimeForRunTimeCount()
+
+/* software timers: the daemon task also runs the deferred interrupt work */
+#define configUSE_TIMERS                            1
+#define configTIMER_TASK_PRIORITY                   (configMAX_PRIORITIES - 1)
+#define configTIMER_QUEUE_LENGTH                    16
+#define configTIMER_TASK_STACK_DEPTH                512
+
+/* API functions */
+#define INCLUDE_vTaskPrioritySet                    1
+#define INCLUDE_uxTaskPriorityGet                   1
+#define INCLUDE_vTaskDelete                         0
+#define INCLUDE_vTaskSuspend                        1
+#define INCLUDE_vTaskDelayUntil                     1
+#define INCLUDE_vTaskDelay                          1
+#define INCLUDE_xTaskGetSchedulerState              1
+#define INCLUDE_xTaskGetCurrentTaskHandle           1
+#define INCLUDE_uxTaskGetStackHighWaterMark         1
+#define INCLUDE_xTimerPendFunctionCall              1
+
+/* interrupt priorities, 4 priority bits */
+#define configPRIO_BITS                             4
+#define configLIBRARY_LOWEST_INTERRUPT_PRIORITY     15
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY 4
+#define configKERNEL_INTERRUPT_PRIORITY             (configLIBRARY_LOWEST_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY        (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+
+#define configASSERT(x)                             if((x) == 0) { __asm volatile("cpsid i"); for(;;); }
+
+/* kernel exception handlers; SysTick_Handler stays in BSP/DELAY and forwards the tick */
+#define vPortSVCHandler                             SVC_Handler
+#define xPortPendSVHandler                          PendSV_Handler
+
+#endif /* FREERTOS_CONFIG_H */
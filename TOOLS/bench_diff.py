@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+    \file       bench_diff.py
+    \brief      compare two BSP/BENCH runs and flag performance regressions
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This script provides:
+    - Parsing of the "@bench" lines in a terminal log (other text is ignored,
+      so a raw serial capture can be used as is)
+    - Per case and cache variant comparison of the medians, with the noise of
+      both runs (MAD) widening the allowed change
+    - Exit code 1 when a case got slower than the threshold or disappeared
+    - Self-test on synthetic logs (--selftest)
+
+    usage:
+        python TOOLS/bench_diff.py baseline.log candidate.log
+        python TOOLS/bench_diff.py baseline.log candidate.log --threshold 3 --csv
+        python TOOLS/bench_diff.py --selftest
+"""
+
+import argparse
+import sys
+
+
+def parse(lines):
+    """return ({"hz", "samples", "overhead"}, {(case, cache): {field: value}})"""
+    header = {}
+    results = {}
+    for line in lines:
+        start = line.find("@bench ")
+        if start < 0:
+            continue
+        words = line[start:].split()
+        fields = dict(w.split("=", 1) for w in words[1:] if "=" in w)
+        if words[1] == "begin":
+            header = {k: int(v) for k, v in fields.items()}
+        elif "case" in fields and "cache" in fields:
+            key = (fields.pop("case"), fields.pop("cache"))
+            results[key] = {k: int(v) for k, v in fields.items()}
+    return header, results
+
+
+def compare(base, cand, threshold):
+    """return rows (case, cache, base median, candidate median, change %, verdict)"""
+    rows = []
+    for key in sorted(set(base) | set(cand)):
+        if key not in cand:
+            rows.append((key[0], key[1], base[key]["median"], None, None, "missing"))
+            continue
+        if key not in base:
+            rows.append((key[0], key[1], None, cand[key]["median"], None, "new"))
+            continue
+        b, c = base[key], cand[key]
+        change = 100.0 * (c["median"] - b["median"]) / max(b["median"], 1)
+        # a change inside three combined MADs is noise, whatever its percentage
+        noise = 3 * (b.get("mad", 0) + c.get("mad", 0))
+        if abs(c["median"] - b["median"]) <= noise or abs(change) < threshold:
+            verdict = "same"
+        else:
+            verdict = "slower" if change > 0 else "faster"
+        rows.append((key[0], key[1], b["median"], c["median"], change, verdict))
+    return rows
+
+
+def report(rows, csv):
+    if csv:
+        out = ["case,cache,base,candidate,change_pct,verdict"]
+        for case, cache, b, c, change, verdict in rows:
+            out.append("%s,%s,%s,%s,%s,%s" % (case, cache, "" if b is None else b, "" if c is None else c,
+                                              "" if change is None else "%.2f" % change, verdict))
+        return out
+    out = ["%-24s %-5s %12s %12s %8s  %s" % ("case", "cache", "base", "candidate", "change", "verdict")]
+    for case, cache, b, c, change, verdict in rows:
+        out.append("%-24s %-5s %12s %12s %8s  %s" % (case, cache, "-" if b is None else b, "-" if c is None else c,
+                                                     "-" if change is None else "%+.1f%%" % change, verdict))
+    return out
+
+
+def regressions(rows):
+    return [r for r in rows if r[5] in ("slower", "missing")]
+
+
+def sample_log(scale, noise, drop=None):
+    lines = ["boot banner", "@bench begin hz=600000000 samples=31 overhead=12"]
+    for name, median in (("memcpy_4k", 2100), ("crc32_sw_1k", 3300), ("sha256_1k", 41000)):
+        if name == drop:
+            continue
+        for cache, extra in (("warm", 0), ("cold", 900)):
+            m = int((median + extra) * scale.get(name, 1.0))
+            lines.append("\x1b[0m@bench case=%s cache=%s median=%d mean=%d min=%d max=%d mad=%d kept=30\r"
+                         % (name, cache, m, m, m - noise, m + noise, noise))
+    lines.append("@bench end cases=3")
+    return lines
+
+
+def selftest():
+    """diff synthetic runs and check the verdicts"""
+    header, base = parse(sample_log({}, 4))
+    _, same = parse(sample_log({"sha256_1k": 1.01}, 4))
+    _, slow = parse(sample_log({"crc32_sw_1k": 1.2}, 4))
+    _, noisy = parse(sample_log({"memcpy_4k": 1.1}, 200))
+    _, fast = parse(sample_log({"sha256_1k": 0.8}, 4, drop="memcpy_4k"))
+    checks = [
+        ("header", header == {"hz": 600000000, "samples": 31, "overhead": 12}),
+        ("parse", len(base) == 6 and base[("crc32_sw_1k", "cold")]["median"] == 4200),
+        ("prefix ignored", base[("memcpy_4k", "warm")]["kept"] == 30),
+        ("below threshold", not regressions(compare(base, same, 5.0))),
+        ("slower", [r[:2] for r in regressions(compare(base, slow, 5.0))]
+         == [("crc32_sw_1k", "cold"), ("crc32_sw_1k", "warm")]),
+        ("noise", not regressions(compare(base, noisy, 5.0))),
+        ("faster", all(r[5] == "faster" for r in compare(base, fast, 5.0) if r[0] == "sha256_1k")),
+        ("missing", len(regressions(compare(base, fast, 5.0))) == 2),
+        ("csv", report(compare(base, slow, 5.0), True)[1].startswith("crc32_sw_1k,cold,4200,5040,20.00,slower")),
+    ]
+    failed = 0
+    for name, ok in checks:
+        print("%s %s" % ("PASS" if ok else "FAIL", name))
+        failed += 0 if ok else 1
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compare two BSP/BENCH logs")
+    parser.add_argument("baseline", nargs="?", help="log of the reference run")
+    parser.add_argument("candidate", nargs="?", help="log of the run to check")
+    parser.add_argument("--threshold", type=float, default=5.0, help="median change in percent that counts")
+    parser.add_argument("--csv", action="store_true", help="print the comparison as CSV")
+    parser.add_argument("--selftest", action="store_true", help="run the self-test")
+    args = parser.parse_args()
+
+    if args.selftest:
+        sys.exit(1 if selftest() else 0)
+    if not args.baseline or not args.candidate:
+        parser.error("baseline and candidate logs are required")
+
+    with open(args.baseline, errors="replace") as f:
+        base_header, base = parse(f)
+    with open(args.candidate, errors="replace") as f:
+        cand_header, cand = parse(f)
+    if base_header.get("hz") != cand_header.get("hz"):
+        print("warning: counter rates differ (%s, %s), medians are not comparable"
+              % (base_header.get("hz"), cand_header.get("hz")), file=sys.stderr)
+    rows = compare(base, cand, args.threshold)
+    print("\n".join(report(rows, args.csv)))
+    bad = regressions(rows)
+    if bad:
+        print("%d regressions above %.1f%%" % (len(bad), args.threshold), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
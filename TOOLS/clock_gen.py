@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+"""
+    \file       clock_gen.py
+    \brief      PLL solver and clock configuration header generator
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This script provides:
+    - Exhaustive search of PLLxPSC, PLLxN and P/Q/R dividers for wanted outputs
+    - Checks of the PLL input range (1-16 MHz) and VCO range (wide or narrow)
+    - Generation of BSP/CLOCK/clock_config.h with divider constants and
+      preprocessor range checks, so a hand-edited value fails the build
+    - Self-test against the known-good vendor configurations (--selftest)
+
+    usage:
+        python TOOLS/clock_gen.py --hxtal 25000000 --pll1 p=130M,r=260M --pll2 r=48M
+        python TOOLS/clock_gen.py --selftest
+"""
+
+import argparse
+import os
+import sys
+
+PSC_MIN, PSC_MAX = 1, 63
+N_MIN, N_MAX = 9, 512
+DIV_MIN, DIV_MAX = 1, 128
+
+# PLL input ranges: (low, high, RCU_PLLxRNG suffix)
+INPUT_RANGES = [
+    (1000000, 2000000, "1M_2M"),
+    (2000000, 4000000, "2M_4M"),
+    (4000000, 8000000, "4M_8M"),
+    (8000000, 16000000, "8M_16M"),
+]
+
+# VCO ranges: (low, high, RCU_PLLxVCO suffix), wide range preferred
+VCO_RANGES = [
+    (192000000, 836000000, "192M_836M"),
+    (150000000, 420000000, "150M_420M"),
+]
+
+OUTPUTS = ("p", "q", "r")
+DEFAULT_DIV = 2                                     # divider of an output nobody asked for
+
+
+class SolveError(Exception):
+    pass
+
+
+def parse_freq(text):
+    """parse 130M, 48000000, 32.768k into Hz"""
+    scale = {"k": 1000, "m": 1000000}
+    text = text.strip().lower()
+    if text and text[-1] in scale:
+        return int(round(float(text[:-1]) * scale[text[-1]]))
+    return int(text)
+
+
+def parse_outputs(text):
+    """parse p=130M,r=260M into {'p': 130000000, 'r': 260000000}"""
+    wanted = {}
+    for item in text.split(","):
+        name, _, value = item.partition("=")
+        name = name.strip().lower()
+        if name not in OUTPUTS or not value:
+            raise SolveError("bad output '%s', expected p=, q= or r=" % item)
+        wanted[name] = parse_freq(value)
+    return wanted
+
+
+def input_range(freq):
+    for low, high, name in INPUT_RANGES:
+        if low <= freq <= high:
+            return name
+    return None
+
+
+def vco_range(freq):
+    for low, high, name in VCO_RANGES:
+        if low <= freq <= high:
+            return name
+    return None
+
+
+def check(hxtal, psc, n, divs):
+    """check a PLL setting against the register and range limits"""
+    if not (PSC_MIN <= psc <= PSC_MAX and N_MIN <= n <= N_MAX):
+        return False
+    if not all(DIV_MIN <= d <= DIV_MAX for d in divs):
+        return False
+    fin = hxtal // psc
+    return input_range(fin) is not None and vco_range(fin * n) is not None
+
+
+def solve(hxtal, wanted, tolerance_ppm=0):
+    """
+    find PSC, N and dividers for the wanted outputs
+
+    The smallest total error wins; among equal errors the highest PLL input
+    (lowest jitter), then the lowest VCO (lowest power). Raises SolveError if
+    any output is further than tolerance_ppm from its target.
+    """
+    if not wanted:
+        raise SolveError("no output requested")
+    best = None
+    for psc in range(PSC_MIN, PSC_MAX + 1):
+        if hxtal % psc:
+            continue
+        fin = hxtal // psc
+        rng = input_range(fin)
+        if rng is None:
+            continue
+        for n in range(N_MIN, N_MAX + 1):
+            vco = fin * n
+            vrng = vco_range(vco)
+            if vrng is None:
+                continue
+            divs = {}
+            error = 0
+            for name, target in wanted.items():
+                div = max(DIV_MIN, min(DIV_MAX, int(round(vco / target))))
+                divs[name] = div
+                error += abs(vco // div - target)
+            key = (error, -fin, vco)
+            if best is None or key < best[0]:
+                best = (key, psc, n, fin, vco, rng, vrng, divs)
+    if best is None:
+        raise SolveError("no PLL setting reaches the wanted outputs from %d Hz" % hxtal)
+    (error, _, _), psc, n, fin, vco, rng, vrng, divs = best
+    for name, target in wanted.items():
+        if abs(vco // divs[name] - target) * 1000000 > target * tolerance_ppm:
+            raise SolveError("%s=%d Hz not reachable within %d ppm (best %d Hz)" % (
+                name.upper(), target, tolerance_ppm, vco // divs[name]))
+    result = {"psc": psc, "n": n, "fin": fin, "vco": vco, "rng": rng, "vrng": vrng, "error": error}
+    for name in OUTPUTS:
+        result[name] = divs.get(name, DEFAULT_DIV)
+        result[name + "_hz"] = vco // result[name] if name in wanted else 0
+    return result
+
+
+def emit_header(hxtal, plls, command):
+    lines = [
+        "/*!",
+        "    \\file       clock_config.h",
+        "    \\brief      PLL divider constants generated by TOOLS/clock_gen.py",
+        "    \\version    1.0",
+        "    \\date       2025-07-23",
+        "    \\author     Ze-Hou",
+        "",
+        "    Generated by: %s" % command,
+        "    Do not edit by hand, run the generator again. The range checks at the",
+        "    end of this file stop the build if a value is changed by hand.",
+        "*/",
+        "",
+        "#ifndef __CLOCK_CONFIG_H",
+        "#define __CLOCK_CONFIG_H",
+        "",
+        "#define CLOCK_CONFIG_HXTAL          %dU" % hxtal,
+    ]
+    for index in sorted(plls):
+        s = plls[index]
+        p = "CLOCK_PLL%d" % index
+        outs = ", ".join("%s %g MHz" % (name.upper(), s[name + "_hz"] / 1e6) for name in OUTPUTS if s[name + "_hz"])
+        lines += [
+            "",
+            "/* PLL%d: %g MHz / %d * %d = VCO %g MHz; %s */" % (index, hxtal / 1e6, s["psc"], s["n"], s["vco"] / 1e6, outs),
+            "#define %-27s %dU" % (p + "_PSC", s["psc"]),
+            "#define %-27s %dU" % (p + "_N", s["n"]),
+            "#define %-27s %dU" % (p + "_P", s["p"]),
+            "#define %-27s %dU" % (p + "_Q", s["q"]),
+            "#define %-27s %dU" % (p + "_R", s["r"]),
+            "#define %-27s RCU_PLL%dRNG_%s" % (p + "_RNG", index, s["rng"]),
+            "#define %-27s RCU_PLL%dVCO_%s" % (p + "_VCO", index, s["vrng"]),
+            "#define %-27s %dU" % (p + "_VCO_MIN", [r for r in VCO_RANGES if r[2] == s["vrng"]][0][0]),
+            "#define %-27s %dU" % (p + "_VCO_MAX", [r for r in VCO_RANGES if r[2] == s["vrng"]][0][1]),
+        ]
+        for name in OUTPUTS:
+            if s[name + "_hz"]:
+                lines.append("#define %-27s %dU" % ("%s%s_HZ" % (p, name.upper()), s[name + "_hz"]))
+    lines += ["", "/* range checks */"]
+    for index in sorted(plls):
+        p = "CLOCK_PLL%d" % index
+        lines += [
+            "#if (%s_PSC < %dU) || (%s_PSC > %dU) || (%s_N < %dU) || (%s_N > %dU)" % (p, PSC_MIN, p, PSC_MAX, p, N_MIN, p, N_MAX),
+            "#error \"PLL%d PSC or N out of range\"" % index,
+            "#endif",
+            "#if ((CLOCK_CONFIG_HXTAL / %s_PSC) < 1000000U) || ((CLOCK_CONFIG_HXTAL / %s_PSC) > 16000000U)" % (p, p),
+            "#error \"PLL%d input out of range\"" % index,
+            "#endif",
+            "#if ((CLOCK_CONFIG_HXTAL / %s_PSC * %s_N) < %s_VCO_MIN) || ((CLOCK_CONFIG_HXTAL / %s_PSC * %s_N) > %s_VCO_MAX)" % (p, p, p, p, p, p),
+            "#error \"PLL%d VCO out of range\"" % index,
+            "#endif",
+        ]
+        for name in OUTPUTS:
+            d = "%s_%s" % (p, name.upper())
+            lines += [
+                "#if (%s < %dU) || (%s > %dU)" % (d, DIV_MIN, d, DIV_MAX),
+                "#error \"PLL%d %s divider out of range\"" % (index, name.upper()),
+                "#endif",
+            ]
+    lines += ["", "#endif /* __CLOCK_CONFIG_H */", ""]
+    return "\n".join(lines)
+
+
+def selftest():
+    """check the solver against the hand-computed vendor configurations"""
+    cases = [
+        # (hxtal, wanted, vendor setting (psc, n, p, q, r) the solution must not be worse than)
+        (25000000, {"p": 600000000}, (5, 120, 1, 2, 2)),
+        (25000000, {"p": 480000000}, (5, 96, 1, 2, 2)),
+        (25000000, {"p": 200000000}, (5, 40, 1, 2, 2)),
+        (25000000, {"p": 130000000, "q": 260000000, "r": 260000000}, (5, 104, 4, 2, 2)),
+        (25000000, {"r": 48000000}, (25, 288, 2, 2, 6)),
+        (8000000, {"p": 400000000, "q": 200000000}, None),
+    ]
+    failed = 0
+    for hxtal, wanted, vendor in cases:
+        s = solve(hxtal, wanted)
+        ok = s["error"] == 0 and check(hxtal, s["psc"], s["n"], (s["p"], s["q"], s["r"]))
+        ok = ok and all(s[name + "_hz"] == hz for name, hz in wanted.items())
+        if vendor is not None:
+            ok = ok and check(hxtal, vendor[0], vendor[1], vendor[2:])
+            ok = ok and s["fin"] >= hxtal // vendor[0]
+        print("%s hxtal %d %s -> psc %d n %d p %d q %d r %d vco %d" % (
+            "PASS" if ok else "FAIL", hxtal, wanted, s["psc"], s["n"], s["p"], s["q"], s["r"], s["vco"]))
+        failed += 0 if ok else 1
+    for hxtal, wanted in ((25000000, {"p": 1000000000}), (25000000, {"p": 123456789}), (500000, {"p": 400000000})):
+        try:
+            solve(hxtal, wanted)
+            print("FAIL hxtal %d %s accepted" % (hxtal, wanted))
+            failed += 1
+        except SolveError:
+            print("PASS hxtal %d %s rejected" % (hxtal, wanted))
+    if check(25000000, 1, 40, (1, 2, 2)):
+        print("FAIL 25 MHz PLL input accepted")
+        failed += 1
+    else:
+        print("PASS 25 MHz PLL input rejected")
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description="solve GD32H7 PLL dividers and generate clock_config.h")
+    parser.add_argument("--hxtal", default="25M", help="HXTAL frequency, must match HXTAL_VALUE")
+    parser.add_argument("--pll0", help="wanted PLL0 outputs, e.g. p=600M")
+    parser.add_argument("--pll1", help="wanted PLL1 outputs, e.g. p=130M,r=260M")
+    parser.add_argument("--pll2", help="wanted PLL2 outputs, e.g. r=48M")
+    parser.add_argument("--output", default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                                         "..", "BSP", "CLOCK", "clock_config.h"))
+    parser.add_argument("--tolerance", type=int, default=0, help="allowed output error in ppm")
+    parser.add_argument("--selftest", action="store_true", help="run the solver self-test")
+    args = parser.parse_args()
+
+    if args.selftest:
+        sys.exit(1 if selftest() else 0)
+
+    hxtal = parse_freq(args.hxtal)
+    plls = {}
+    try:
+        for index, spec in enumerate((args.pll0, args.pll1, args.pll2)):
+            if spec:
+                plls[index] = solve(hxtal, parse_outputs(spec), args.tolerance)
+    except SolveError as err:
+        sys.exit("error: %s" % err)
+    if not plls:
+        sys.exit("error: no PLL requested")
+
+    command = "clock_gen.py " + " ".join(a for a in sys.argv[1:] if not a.startswith("--output"))
+    with open(args.output, "w", newline="\n") as f:
+        f.write(emit_header(hxtal, plls, command))
+    for index, s in sorted(plls.items()):
+        print("PLL%d: psc %d n %d p %d q %d r %d, vco %d Hz, error %d Hz" % (
+            index, s["psc"], s["n"], s["p"], s["q"], s["r"], s["vco"], s["error"]))
+
+
+if __name__ == "__main__":
+    main()
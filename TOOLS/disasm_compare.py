@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+"""
+    \file       disasm_compare.py
+    \brief      instruction-level comparison of function pairs in a disassembly
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This script provides:
+    - Parsing of "objdump -d" (host build) and "fromelf -c" (Arm Compiler
+      image) listings into functions and instructions, alignment padding and
+      comments dropped, branch targets made relative to the function
+    - Comparison of every <name>_c / <name>_cpp pair: identical code, fewer or
+      more instructions (literal pool words included)
+    - Exit code 1 when a _cpp function is larger than its _c twin, or when a
+      pair is incomplete
+    - Self-test on synthetic listings (--selftest)
+
+    usage:
+        objdump -d --no-show-raw-insn build/reg/bench_reg_cases.o | python TOOLS/disasm_compare.py
+        fromelf -c Objects/Project_Template.axf | python TOOLS/disasm_compare.py --prefix bench_reg_
+        python TOOLS/disasm_compare.py --selftest
+"""
+
+import argparse
+import re
+import sys
+
+OBJDUMP_FUNC = re.compile(r"^([0-9a-fA-F]+) <([^>]+)>:\s*$")
+OBJDUMP_INSN = re.compile(r"^\s+([0-9a-fA-F]+):\s+(.*)$")
+FROMELF_FUNC = re.compile(r"^    ([A-Za-z_][A-Za-z0-9_]*)\s*$")
+FROMELF_INSN = re.compile(r"^\s+0x([0-9a-fA-F]+):\s+(.*)$")
+HEX = re.compile(r"^(?:0x)?([0-9a-fA-F]+)$")
+
+
+def normalize(text, start, end):
+    """drop comments and symbol hints, write targets inside the function as offsets"""
+    text = re.sub(r"\s+(?:[#@;] .*|@.*)$", "", text)
+    text = re.sub(r"\s*<[^>]*>", "", text)
+    words = []
+    for word in re.split(r"(\s+|,)", text.strip()):
+        m = HEX.match(word)
+        if m and len(word) >= 3:
+            value = int(m.group(1), 16)
+            if start <= value < end:
+                word = "L+%x" % (value - start)
+        words.append(word)
+    return re.sub(r"\s+", " ", "".join(words))
+
+
+def fromelf_insn(rest):
+    """mnemonic and operands of a fromelf line: encoding, ascii, then the instruction"""
+    words = rest.split()
+    i = 0
+    while i < len(words) and re.match(r"^[0-9a-f]{4,8}$", words[i]):
+        i += 1
+    return " ".join(words[i + 1:])                                    # skip the ascii column
+
+
+def parse(lines):
+    """return {function: [instruction]}"""
+    raw = {}
+    order = []
+    current = None
+    fromelf = False
+    for line in lines:
+        line = line.rstrip("\r\n")
+        m = OBJDUMP_FUNC.match(line)
+        if m:
+            current = m.group(2)
+            raw[current] = []
+            order.append(current)
+            continue
+        m = FROMELF_INSN.match(line)
+        if m and current is not None and fromelf:
+            raw[current].append((int(m.group(1), 16), fromelf_insn(m.group(2))))
+            continue
+        m = FROMELF_FUNC.match(line)
+        if m and not line.strip().startswith("$"):
+            current = m.group(1)
+            fromelf = True
+            raw[current] = []
+            order.append(current)
+            continue
+        m = OBJDUMP_INSN.match(line)
+        if m and current is not None:
+            raw[current].append((int(m.group(1), 16), m.group(2)))
+    functions = {}
+    for name in order:
+        insns = [(a, t) for a, t in raw[name] if t and not re.match(r"^(?:data16 |cs )*nop", t)]
+        if not insns:
+            continue
+        start, end = insns[0][0], insns[-1][0] + 16
+        functions[name] = [normalize(t, start, end) for _, t in insns]
+    return functions
+
+
+def compare(functions, prefix):
+    """rows (name, c instructions, cpp instructions, verdict) for every pair under prefix"""
+    rows = []
+    names = set()
+    for name in functions:
+        if name.startswith(prefix) and (name.endswith("_c") or name.endswith("_cpp")):
+            names.add(name[:-2] if name.endswith("_c") else name[:-4])
+    for base in sorted(names):
+        c, cpp = functions.get(base + "_c"), functions.get(base + "_cpp")
+        if c is None or cpp is None:
+            rows.append((base, None if c is None else len(c), None if cpp is None else len(cpp), "incomplete"))
+        elif c == cpp:
+            rows.append((base, len(c), len(cpp), "identical"))
+        else:
+            rows.append((base, len(c), len(cpp), "larger" if len(cpp) > len(c) else
+                         "smaller" if len(cpp) < len(c) else "same size"))
+    return rows
+
+
+def failures(rows):
+    return [r for r in rows if r[3] in ("larger", "incomplete")]
+
+
+def report(rows):
+    out = ["%-32s %6s %6s  %s" % ("pair", "c", "cpp", "verdict")]
+    for name, c, cpp, verdict in rows:
+        out.append("%-32s %6s %6s  %s" % (name, "-" if c is None else c, "-" if cpp is None else cpp, verdict))
+    return out
+
+
+OBJDUMP_SAMPLE = """
+0000000000000000 <bench_reg_gpio_set_c>:
+   0:	movl   $0x2000,0x58021c18
+   b:	ret
+   c:	nopl   0x0(%rax)
+
+0000000000000010 <bench_reg_gpio_set_cpp>:
+  10:	movl   $0x2000,0x58021c18
+  1b:	ret
+  1c:	nopl   0x0(%rax)
+
+0000000000000180 <bench_reg_usart_put_c>:
+ 180:	mov    0x4000781c,%eax
+ 187:	test   $0x80,%al
+ 189:	je     180 <bench_reg_usart_put_c>
+ 18f:	mov    %edi,0x40007828
+ 196:	ret
+
+00000000000001a0 <bench_reg_usart_put_cpp>:
+ 1a0:	mov    0x4000781c,%eax
+ 1a7:	test   $0x80,%al
+ 1a9:	je     1a0 <bench_reg_usart_put_cpp>
+ 1af:	mov    %edi,0x40007828
+ 1b6:	ret
+ 1b7:	nopw   0x0(%rax,%rax,1)
+
+00000000000001c0 <bench_reg_dma_config_c>:
+ 1c0:	mov    0x400204b8,%eax
+ 1c7:	ret
+
+00000000000001d0 <bench_reg_dma_config_cpp>:
+ 1d0:	mov    0x400204b8,%eax
+ 1d7:	and    $0xfffc813f,%eax
+ 1dc:	ret
+""".splitlines()
+
+FROMELF_SAMPLE = """
+    .text.bench_reg_gpio_set_c
+    $t
+    bench_reg_gpio_set_c
+        0x080001a0:    f44f5000    O..P    MOV      r0,#0x2000
+        0x080001a4:    4901        .I      LDR      r1,[pc,#4] ; [0x80001ac] = 0x58021c18
+        0x080001a6:    6008        .`      STR      r0,[r1,#0]
+        0x080001a8:    4770        pG      BX       lr
+    $d
+        0x080001ac:    58021c18    ...X    DCD    1476533272
+    .text.bench_reg_gpio_set_cpp
+    $t
+    bench_reg_gpio_set_cpp
+        0x080001b0:    f44f5000    O..P    MOV      r0,#0x2000
+        0x080001b4:    4901        .I      LDR      r1,[pc,#4] ; [0x80001bc] = 0x58021c18
+        0x080001b6:    6008        .`      STR      r0,[r1,#0]
+        0x080001b8:    4770        pG      BX       lr
+    $d
+        0x080001bc:    58021c18    ...X    DCD    1476533272
+    bench_reg_orphan_cpp
+        0x080001c0:    4770        pG      BX       lr
+""".splitlines()
+
+
+def selftest():
+    """compare the synthetic objdump and fromelf listings"""
+    host = compare(parse(OBJDUMP_SAMPLE), "bench_reg_")
+    target = compare(parse(FROMELF_SAMPLE), "bench_reg_")
+    functions = parse(FROMELF_SAMPLE)
+    checks = [
+        ("objdump pairs", [r[0] for r in host] == ["bench_reg_dma_config", "bench_reg_gpio_set", "bench_reg_usart_put"]),
+        ("padding dropped", host[1] == ("bench_reg_gpio_set", 2, 2, "identical")),
+        ("relative branch", host[2][3] == "identical"),
+        ("larger", host[0][3] == "larger" and len(failures(host)) == 1),
+        ("fromelf", target[0] == ("bench_reg_gpio_set", 5, 5, "identical")),
+        ("fromelf instruction", functions["bench_reg_gpio_set_c"][1] == "LDR r1,[pc,#4]"),
+        ("incomplete", target[1] == ("bench_reg_orphan", None, 1, "incomplete")),
+        ("report", report(host)[1].startswith("bench_reg_dma_config")),
+    ]
+    failed = 0
+    for name, ok in checks:
+        print("%s %s" % ("PASS" if ok else "FAIL", name))
+        failed += 0 if ok else 1
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compare <name>_c and <name>_cpp functions of a disassembly")
+    parser.add_argument("listing", nargs="?", help="objdump -d or fromelf -c output, stdin when omitted")
+    parser.add_argument("--prefix", default="bench_reg_", help="compare only functions with this prefix")
+    parser.add_argument("--selftest", action="store_true", help="run the self-test")
+    args = parser.parse_args()
+
+    if args.selftest:
+        sys.exit(1 if selftest() else 0)
+    if args.listing:
+        with open(args.listing, errors="replace") as f:
+            functions = parse(f)
+    else:
+        functions = parse(sys.stdin)
+    rows = compare(functions, args.prefix)
+    print("\n".join(report(rows)))
+    if not rows:
+        sys.exit("no %s*_c / _cpp functions in the listing" % args.prefix)
+    bad = failures(rows)
+    if bad:
+        print("%d pairs where the C++ code is larger or missing" % len(bad), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+"""
+    \file       fault_decode.py
+    \brief      post-mortem decoder for crash dumps printed by BSP/FAULT
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This script provides:
+    - Extraction of the "FAULT ..." lines from a console log (file or stdin)
+    - Decoding of CFSR (MemManage, BusFault, UsageFault bits), HFSR and
+      EXC_RETURN into readable causes, with the fault address when valid
+    - Symbolisation of PC, LR and likely return addresses in the stack
+      snapshot, from an armlink map (--map) or an ELF through nm (--elf)
+    - Time of the fault since the cycle counter was started
+    - Self-test with a synthetic map and dump (--selftest)
+
+    usage:
+        python TOOLS/fault_decode.py console.log --map Objects/Project_Template.map
+        python TOOLS/fault_decode.py console.log --elf Objects/Project_Template.axf --nm arm-none-eabi-nm
+        python TOOLS/fault_decode.py --selftest
+"""
+
+import argparse
+import bisect
+import re
+import subprocess
+import sys
+
+MMFSR_BITS = [
+    (0, "IACCVIOL", "instruction fetch from a no-execute or protected region"),
+    (1, "DACCVIOL", "data access violation"),
+    (3, "MUNSTKERR", "MemManage fault on exception return unstacking"),
+    (4, "MSTKERR", "MemManage fault on exception entry stacking"),
+    (5, "MLSPERR", "MemManage fault during lazy FP state preservation"),
+]
+BFSR_BITS = [
+    (8, "IBUSERR", "bus error on instruction fetch"),
+    (9, "PRECISERR", "precise data bus error"),
+    (10, "IMPRECISERR", "imprecise data bus error, PC is after the access"),
+    (11, "UNSTKERR", "bus fault on exception return unstacking"),
+    (12, "STKERR", "bus fault on exception entry stacking, stack overflow likely"),
+    (13, "LSPERR", "bus fault during lazy FP state preservation"),
+]
+UFSR_BITS = [
+    (16, "UNDEFINSTR", "undefined instruction"),
+    (17, "INVSTATE", "invalid EPSR state, branch to an even address"),
+    (18, "INVPC", "invalid EXC_RETURN on exception return"),
+    (19, "NOCP", "coprocessor access while disabled, FPU off"),
+    (24, "UNALIGNED", "unaligned access with alignment trap enabled"),
+    (25, "DIVBYZERO", "integer division by zero"),
+]
+MMARVALID, BFARVALID = 7, 15
+HFSR_BITS = [
+    (1, "VECTTBL", "bus fault on a vector table read"),
+    (30, "FORCED", "configurable fault escalated to HardFault"),
+    (31, "DEBUGEVT", "debug event while the debugger was off"),
+]
+
+MAP_SYMBOL = re.compile(r"^\s+(\S+)\s+0x([0-9a-fA-F]+)\s+(Thumb Code|ARM Code|Data)\s+(\d+)")
+NM_SYMBOL = re.compile(r"^([0-9a-fA-F]+)\s+([0-9a-fA-F]+)\s+([tTwW])\s+(\S+)")
+FAULT_FIELD = re.compile(r"(\w+)=([0-9A-Za-z_]+)")
+FAULT_STACK = re.compile(r"FAULT stack ([0-9a-fA-F]{8}):((?:\s+[0-9a-fA-F]{8})+)")
+
+
+class Symbols:
+    """sorted code symbols with sizes, looked up by address"""
+
+    def __init__(self, entries):
+        self.entries = sorted(e for e in entries if e[1] > 0)
+        self.starts = [e[0] for e in self.entries]
+
+    def lookup(self, addr):
+        addr &= ~1
+        i = bisect.bisect_right(self.starts, addr) - 1
+        if i >= 0:
+            start, size, name = self.entries[i]
+            if addr < start + size:
+                return name, addr - start
+        return None
+
+    def describe(self, addr):
+        hit = self.lookup(addr)
+        return "%s+0x%x" % hit if hit else "?"
+
+
+def load_map(lines):
+    """code symbols from the Image Symbol Table of an armlink map"""
+    entries = []
+    for line in lines:
+        m = MAP_SYMBOL.match(line)
+        if m and m.group(3) != "Data":
+            entries.append((int(m.group(2), 16) & ~1, int(m.group(4)), m.group(1)))
+    return Symbols(entries)
+
+
+def load_nm(lines):
+    """code symbols from "nm -nS" output"""
+    entries = []
+    for line in lines:
+        m = NM_SYMBOL.match(line)
+        if m:
+            entries.append((int(m.group(1), 16) & ~1, int(m.group(2), 16), m.group(4)))
+    return Symbols(entries)
+
+
+def parse_dump(lines):
+    """fields and stack snapshot of the last dump in a log, None if there is none"""
+    dump = None
+    for line in lines:
+        pos = line.find("FAULT ")
+        if pos < 0:
+            continue
+        line = line[pos:].strip()
+        if line.startswith("FAULT type="):
+            dump = {"fields": {}, "stack": [], "sp": None, "complete": False}
+        if dump is None:
+            continue
+        m = FAULT_STACK.match(line)
+        if m:
+            if dump["sp"] is None:
+                dump["sp"] = int(m.group(1), 16)
+            dump["stack"] += [int(w, 16) for w in m.group(2).split()]
+        elif line == "FAULT end":
+            dump["complete"] = True
+        else:
+            for key, value in FAULT_FIELD.findall(line):
+                dump["fields"][key] = value
+    return dump
+
+
+def bits(value, table):
+    return [(name, text) for bit, name, text in table if value & (1 << bit)]
+
+
+def decode(dump, symbols):
+    """readable report lines"""
+    f = dump["fields"]
+    reg = lambda name: int(f.get(name, "0"), 16)
+    out = []
+    cfsr, hfsr, exc = reg("cfsr"), reg("hfsr"), reg("exc_return")
+    out.append("fault:      %s%s" % (f.get("type", "?"), "" if dump["complete"] else " (dump truncated)"))
+    if "core_hz" in f and int(f["core_hz"]) > 0:
+        out.append("time:       %.6f s after the cycle counter started (wraps every %.1f s)" % (
+            reg("cyccnt") / float(f["core_hz"]), 2 ** 32 / float(f["core_hz"])))
+    out.append("pc:         %08X  %s" % (reg("pc"), symbols.describe(reg("pc")) if symbols else ""))
+    out.append("lr:         %08X  %s" % (reg("lr"), symbols.describe(reg("lr")) if symbols else ""))
+    out.append("exc_return: %08X  %s mode, %s, %s frame" % (
+        exc, "thread" if exc & 0x8 else "handler", "psp" if exc & 0x4 else "msp",
+        "basic" if exc & 0x10 else "FPU"))
+    if reg("sp") == 0:
+        out.append("sp:         frame unreadable, stack pointer outside RAM (overflow?)")
+    causes = bits(cfsr, MMFSR_BITS) + bits(cfsr, BFSR_BITS) + bits(cfsr, UFSR_BITS) + bits(hfsr, HFSR_BITS)
+    for name, text in causes:
+        out.append("cause:      %-11s %s" % (name, text))
+    if cfsr & (1 << MMARVALID):
+        out.append("address:    %08X  (MMFAR)" % reg("mmfar"))
+    if cfsr & (1 << BFARVALID):
+        out.append("address:    %08X  (BFAR)" % reg("bfar"))
+    if symbols and dump["stack"]:
+        out.append("call stack (return addresses found on the stack, oldest last):")
+        for i, word in enumerate(dump["stack"]):
+            # a return address is odd (Thumb) and points inside a function, not at its entry
+            hit = symbols.lookup(word) if word & 1 else None
+            if hit and hit[1] > 0:
+                out.append("  [sp+0x%03x] %08X  %s+0x%x" % (i * 4, word, hit[0], hit[1]))
+    return out
+
+
+SELFTEST_MAP = """
+    Image Symbol Table
+
+    Global Symbols
+
+    Symbol Name                              Value     Ov Type        Size  Object(Section)
+
+    main                                     0x08000401   Thumb Code    96  main.o(.text.main)
+    sensor_poll                              0x08000461   Thumb Code    48  sensor.o(.text.sensor_poll)
+    sensor_read                              0x08000491   Thumb Code    32  sensor.o(.text.sensor_read)
+    SystemCoreClock                          0x24020000   Data           4  system.o(.data)
+"""
+
+SELFTEST_LOG = """
+boot
+[ERROR] previous boot ended in BusFault at pc 0x0800049A
+FAULT type=BusFault exc_return=FFFFFFF9
+FAULT r0=00000000 r1=00000001 r2=00000002 r3=00000003
+FAULT r12=0000000C lr=08000475 pc=0800049A xpsr=21000000 sp=2407FFE0
+FAULT cfsr=00008200 hfsr=00000000 mmfar=E000EDF4 bfar=60000000 afsr=00000000
+FAULT cyccnt=11E1A300 core_hz=600000000
+FAULT stack 2407FFE0: 00000010 08000475 00000000 08000401 0800043D 00000000 DEADBEEF 24020000
+FAULT stack 24080000: 08000000
+FAULT end
+"""
+
+
+def selftest():
+    """decode a synthetic BusFault dump against a synthetic map"""
+    symbols = load_map(SELFTEST_MAP.splitlines())
+    dump = parse_dump(SELFTEST_LOG.splitlines())
+    report = decode(dump, symbols) if dump else []
+    text = "\n".join(report)
+    checks = [
+        ("symbols loaded", len(symbols.entries) == 3),
+        ("dump complete", dump is not None and dump["complete"]),
+        ("stack words", dump is not None and len(dump["stack"]) == 9 and dump["sp"] == 0x2407FFE0),
+        ("pc symbol", "sensor_read+0xa" in text),
+        ("lr symbol", "lr:         08000475  sensor_poll+0x14" in text),
+        ("cause", "PRECISERR" in text and "BFAR" in text and "60000000" in text),
+        ("no MMFAR", "MMFAR" not in text),
+        ("exc_return", "thread mode, msp, basic frame" in text),
+        ("time", "0.500000 s" in text),
+        ("call stack", "main+0x3c" in text and "[sp+0x004] 08000475" in text),
+        ("entry not a return", "[sp+0x00c]" not in text),
+        ("data ignored", "[sp+0x01c]" not in text),
+        ("nm format", load_nm(["08000461 00000030 T sensor_poll"]).describe(0x08000475) == "sensor_poll+0x14"),
+        ("no dump", parse_dump(["hello", "world"]) is None),
+    ]
+    failed = 0
+    for name, ok in checks:
+        print("%s %s" % ("PASS" if ok else "FAIL", name))
+        failed += 0 if ok else 1
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description="decode a BSP/FAULT crash dump from a console log")
+    parser.add_argument("log", nargs="?", help="console log, stdin when omitted")
+    parser.add_argument("--map", help="armlink map file with the Image Symbol Table")
+    parser.add_argument("--elf", help="ELF image, symbols read through --nm")
+    parser.add_argument("--nm", default="arm-none-eabi-nm", help="nm used for --elf")
+    parser.add_argument("--selftest", action="store_true", help="run the decoder self-test")
+    args = parser.parse_args()
+
+    if args.selftest:
+        sys.exit(1 if selftest() else 0)
+
+    symbols = None
+    if args.map:
+        with open(args.map, errors="replace") as f:
+            symbols = load_map(f)
+    elif args.elf:
+        nm = subprocess.run([args.nm, "-nS", args.elf], capture_output=True, text=True, check=True)
+        symbols = load_nm(nm.stdout.splitlines())
+
+    if args.log:
+        with open(args.log, errors="replace") as f:
+            dump = parse_dump(f)
+    else:
+        dump = parse_dump(sys.stdin)
+    if dump is None:
+        print("no FAULT dump found")
+        sys.exit(1)
+    print("\n".join(decode(dump, symbols)))
+
+
+if __name__ == "__main__":
+    main()
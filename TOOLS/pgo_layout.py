@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+"""
+    \file       pgo_layout.py
+    \brief      profile-guided code layout of the Release build types
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This script provides:
+    - Function address ranges from the "Image Symbol Table" of an armlink map
+    - A flat profile: the DWT PC samples of a Profile run (raw SWO capture,
+      decoded with swo_decode.py) counted per function
+    - The hot set: the functions covering --coverage of the samples, hottest
+      first, written as the ER_HOT region between the @hot markers of
+      USER/Project_Template_release.sct
+    - Self-test on a synthetic map and capture (--selftest)
+
+    usage:
+        python TOOLS/pgo_layout.py capture.bin Objects/Project_Template.map
+        python TOOLS/pgo_layout.py capture.bin Objects/Project_Template.map --write USER/Project_Template_release.sct
+        python TOOLS/pgo_layout.py --selftest
+
+    Build the Profile type, capture the SWO pin while it runs the benchmarks,
+    rewrite the scatter file from that capture and the map of the same build,
+    then build Release or ReleaseBench. The layout only moves whole sections,
+    so function names stay valid from one build to the next.
+"""
+
+import argparse
+import bisect
+import os
+import re
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import swo_decode  # noqa: E402
+
+# "    name    0x08001235   Thumb Code   212  object.o(section)" in the symbol table
+SYMBOL_RE = re.compile(r"^\s+(\S+)\s+0x([0-9a-fA-F]+)\s+(?:Thumb|ARM) Code\s+(\d+)\s+(\S+?)\((\S+)\)\s*$")
+HOT_BEGIN = "; @hot begin"
+HOT_END = "; @hot end"
+
+
+def parse_map(lines):
+    """return code symbols [(start, end, name, object, section)] sorted by address"""
+    symbols = {}
+    for line in lines:
+        m = SYMBOL_RE.match(line)
+        if not m or int(m.group(3)) == 0:
+            continue
+        start = int(m.group(2), 16) & ~1
+        symbols[start] = (start, start + int(m.group(3)), m.group(1), m.group(4), m.group(5))
+    return [symbols[k] for k in sorted(symbols)]
+
+
+def profile(pcs, symbols):
+    """return ({function: samples}, samples outside every function)"""
+    starts = [s[0] for s in symbols]
+    counts = {}
+    unknown = 0
+    for pc in pcs:
+        i = bisect.bisect_right(starts, pc) - 1
+        if i >= 0 and pc < symbols[i][1]:
+            counts[symbols[i]] = counts.get(symbols[i], 0) + 1
+        else:
+            unknown += 1
+    return counts, unknown
+
+
+def hot_set(counts, coverage, limit):
+    """hottest functions until coverage (0..1) of the attributed samples is reached"""
+    total = sum(counts.values())
+    hot, taken = [], 0
+    for symbol, count in sorted(counts.items(), key=lambda kv: (-kv[1], kv[0][0])):
+        if taken >= coverage * total or len(hot) >= limit:
+            break
+        hot.append((symbol, count))
+        taken += count
+    return hot
+
+
+def selector(symbol):
+    """scatter selector of the section holding a function"""
+    _, _, _, obj, section = symbol
+    if section.startswith(".text."):
+        return "*(%s)" % section                                  # -ffunction-sections: unique, survives LTO
+    return "%s (%s)" % (obj, section)                             # library member or shared section
+
+
+def region(hot, total):
+    lines = ["  ER_HOT +0 ALIGN 32 {              ; %d hot functions, %d samples" % (len(hot), total)]
+    seen = set()
+    for symbol, count in hot:
+        sel = selector(symbol)
+        if sel in seen:
+            continue
+        seen.add(sel)
+        lines.append("   %-40s ; %5.1f%% %s" % (sel, 100.0 * count / max(total, 1), symbol[2]))
+    lines.append("  }")
+    return lines
+
+
+def rewrite(scatter, lines):
+    """replace the lines between the @hot markers"""
+    out, inside, found = [], False, 0
+    for line in scatter:
+        text = line.rstrip("\r\n")
+        if text.strip() == HOT_BEGIN:
+            out.append(text)
+            out.extend(lines)
+            inside, found = True, found + 1
+            continue
+        if text.strip() == HOT_END:
+            inside, found = False, found + 1
+        if not inside:
+            out.append(text)
+    if found != 2:
+        raise ValueError("scatter file has no %s / %s markers" % (HOT_BEGIN, HOT_END))
+    return out
+
+
+def pcs_of(data):
+    d = swo_decode.Decoder().feed(data)
+    d.flush()
+    return [v for _, kind, v in d.events if kind == "pc"], d
+
+
+def sample_map():
+    return [
+        "Image Symbol Table",
+        "    Local Symbols",
+        "    bench_cases_memcpy_4k                    0x08000401   Thumb Code    16  bench_cases.o(.text.bench_cases_memcpy_4k)",
+        "    bench_cases_sha256_1k                    0x08000411   Thumb Code    60  bench_cases.o(.text.bench_cases_sha256_1k)",
+        "    s_bench_cases_src                        0x24020000   Data        4096  bench_cases.o(.bss.s_bench_cases_src)",
+        "    Global Symbols",
+        "    __aeabi_memcpy                           0x08000201   Thumb Code   132  rt_memcpy_v6.o(.text)",
+        "    sha256_update                            0x08000501   Thumb Code   120  sha256.o(.text.sha256_update)",
+        "    sha256_transform                         0x08000579   Thumb Code  1800  sha256.o(.text.sha256_transform)",
+        "    main                                     0x08000c81   Thumb Code    96  main.o(.text.main)",
+        "    Reset_Handler                            0x08000189   Thumb Code     8  startup_gd32h7xx.o(RESET)",
+        "    sha256_final                             0x08000d01   Thumb Code     0  sha256.o(.text.sha256_final)",
+    ]
+
+
+def sample_capture():
+    """70 samples in sha256_transform, 20 in memcpy, 6 in sha256_update, 3 in main, 1 outside, 2 asleep"""
+    pcs = [0x08000600] * 70 + [0x08000230] * 20 + [0x08000520] * 6 + [0x08000c90] * 3 + [0x08100000]
+    return bytes(5) + b"\x80" + b"".join(swo_decode.enc_pc(pc) + swo_decode.enc_lts(16384) for pc in pcs) \
+        + swo_decode.enc_pc(None) + swo_decode.enc_pc(None) + swo_decode.enc_lts(16384)
+
+
+def selftest():
+    """profile the synthetic capture and check the hot region"""
+    symbols = parse_map(sample_map())
+    pcs, d = pcs_of(sample_capture())
+    counts, unknown = profile(pcs, symbols)
+    named = {s[2]: c for s, c in counts.items()}
+    hot = hot_set(counts, 0.95, 64)
+    with open(os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "USER", "Project_Template_release.sct")) as f:
+        scatter = rewrite(f, region(hot, sum(counts.values())))
+    text = "\n".join(scatter)
+    checks = [
+        ("map", len(symbols) == 7 and symbols[0][2] == "Reset_Handler" and symbols[0][0] == 0x08000188),
+        ("capture", d.errors == 0 and len(pcs) == 100),
+        ("profile", named == {"sha256_transform": 70, "__aeabi_memcpy": 20, "sha256_update": 6, "main": 3}),
+        ("outside", unknown == 1),
+        ("coverage", [s[2] for s, _ in hot] == ["sha256_transform", "__aeabi_memcpy", "sha256_update"]),
+        ("limit", len(hot_set(counts, 1.0, 2)) == 2 and len(hot_set(counts, 0.9, 64)) == 2),
+        ("selectors", selector(hot[0][0]) == "*(.text.sha256_transform)"
+         and selector(hot[1][0]) == "rt_memcpy_v6.o (.text)"),
+        ("region", text.index("  " + HOT_BEGIN) < text.index("  ER_HOT +0 ALIGN 32") < text.index("  " + HOT_END)
+         < text.index("  RW_NOINIT")),
+        ("rewrite twice", rewrite(scatter, []) == rewrite(rewrite(scatter, []), [])),
+    ]
+    failed = 0
+    for name, ok in checks:
+        print("%s %s" % ("PASS" if ok else "FAIL", name))
+        failed += 0 if ok else 1
+    try:
+        rewrite(["no markers"], [])
+        print("FAIL missing markers")
+        failed += 1
+    except ValueError:
+        print("PASS missing markers")
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description="hot function layout from a PC sampling capture")
+    parser.add_argument("capture", nargs="?", help="raw SWO bytes of a Profile run")
+    parser.add_argument("map", nargs="?", help="armlink map file of the same build")
+    parser.add_argument("--coverage", type=float, default=90.0, help="percent of the samples the hot set covers")
+    parser.add_argument("--limit", type=int, default=64, help="most functions in the hot set")
+    parser.add_argument("--write", metavar="SCT", help="rewrite the ER_HOT region of this scatter file")
+    parser.add_argument("--selftest", action="store_true", help="run the self-test")
+    args = parser.parse_args()
+
+    if args.selftest:
+        sys.exit(1 if selftest() else 0)
+    if not args.capture or not args.map:
+        parser.error("capture and map are required")
+
+    with open(args.capture, "rb") as f:
+        pcs, d = pcs_of(f.read())
+    with open(args.map, errors="replace") as f:
+        symbols = parse_map(f)
+    counts, unknown = profile(pcs, symbols)
+    total = sum(counts.values())
+    if not total:
+        sys.exit("no PC samples inside known functions: build with TRACE_PC_SAMPLING and use the map of that build")
+    hot = hot_set(counts, args.coverage / 100.0, args.limit)
+    for symbol, count in hot:
+        print("%6d %5.1f%%  %-32s %s" % (count, 100.0 * count / total, symbol[2], selector(symbol)))
+    print("%d samples, %d outside the map, %d malformed packets" % (len(pcs), unknown, d.errors), file=sys.stderr)
+    if args.write:
+        with open(args.write) as f:
+            lines = rewrite(f, region(hot, total))
+        with open(args.write, "w") as f:
+            f.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main()
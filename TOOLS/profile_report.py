@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""
+    \file       profile_report.py
+    \brief      size and speed comparison of build profiles
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This script provides:
+    - Image sizes (code, RO data, RW data, ZI data, flash total) from the
+      "ELF Image Totals" of each profile's armlink map
+    - Benchmark medians of each profile's BSP/BENCH log (bench_diff.py parser)
+      with the speedup over the first profile
+    - Self-test on synthetic maps and logs (--selftest)
+
+    usage:
+        python TOOLS/profile_report.py --profile Bench bench.map bench.log --profile ReleaseBench release.map release.log
+        python TOOLS/profile_report.py --profile Bench bench.map bench.log --profile ReleaseBench release.map release.log --csv
+        python TOOLS/profile_report.py --selftest
+
+    Give the map and the "@bench" terminal log of the Bench and ReleaseBench
+    build types: both run the same cases, so the rows line up.
+"""
+
+import argparse
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import bench_diff  # noqa: E402
+
+SIZE_FIELDS = ("code", "ro", "rw", "zi", "flash")
+
+
+def parse_sizes(lines):
+    """return {code, ro, rw, zi, flash} in bytes from the image totals of a map"""
+    totals = None
+    for line in lines:
+        words = line.split()
+        # Code (inc. data) RO-Data RW-Data ZI-Data Debug, then the row name
+        if len(words) >= 8 and words[6:9] == ["ELF", "Image", "Totals"] and all(w.isdigit() for w in words[:6]):
+            totals = [int(w) for w in words[:6]]
+    if totals is None:
+        raise ValueError("no ELF Image Totals, link with --info totals")
+    code, _, ro, rw, zi, _ = totals
+    return {"code": code, "ro": ro, "rw": rw, "zi": zi, "flash": code + ro + rw}
+
+
+def compare(profiles):
+    """profiles [(name, sizes, results)] -> (size rows, speed rows) against the first profile"""
+    base_sizes, base_results = profiles[0][1], profiles[0][2]
+    size_rows = []
+    for name, sizes, _ in profiles:
+        size_rows.append((name, [sizes[k] for k in SIZE_FIELDS],
+                          100.0 * (sizes["flash"] - base_sizes["flash"]) / max(base_sizes["flash"], 1)))
+    speed_rows = []
+    for key in sorted(base_results):
+        medians = [results.get(key, {}).get("median") for _, _, results in profiles]
+        b = base_results[key]["median"]
+        speed_rows.append((key[0], key[1], medians, [None if m is None or m == 0 else b / m for m in medians]))
+    return size_rows, speed_rows
+
+
+def report(profiles, csv):
+    size_rows, speed_rows = compare(profiles)
+    names = [p[0] for p in profiles]
+    out = []
+    if csv:
+        out.append("profile," + ",".join(SIZE_FIELDS) + ",flash_change_pct")
+        for name, values, change in size_rows:
+            out.append("%s,%s,%.2f" % (name, ",".join(str(v) for v in values), change))
+        out.append("case,cache," + ",".join("%s_median,%s_speedup" % (n, n) for n in names))
+        for case, cache, medians, speedups in speed_rows:
+            cells = ["%s,%s" % ("" if m is None else m, "" if s is None else "%.3f" % s)
+                     for m, s in zip(medians, speedups)]
+            out.append("%s,%s,%s" % (case, cache, ",".join(cells)))
+        return out
+    out.append("%-16s %9s %9s %9s %9s %9s %8s" % (("profile",) + SIZE_FIELDS + ("change",)))
+    for name, values, change in size_rows:
+        out.append("%-16s %9d %9d %9d %9d %9d %+7.1f%%" % ((name,) + tuple(values) + (change,)))
+    out.append("")
+    out.append("%-24s %-5s" % ("case", "cache") + "".join(" %16s" % n for n in names))
+    for case, cache, medians, speedups in speed_rows:
+        cells = "".join(" %16s" % ("-" if m is None else "%d x%.2f" % (m, s)) for m, s in zip(medians, speedups))
+        out.append("%-24s %-5s%s" % (case, cache, cells))
+    return out
+
+
+def sample_map(code, ro, rw, zi):
+    return [
+        "==============================================================================",
+        "    Code (inc. data)   RO Data    RW Data    ZI Data      Debug   Library Name",
+        "      2046        112          0          0          0       1234   c_w.l",
+        "    Code (inc. data)   RO Data    RW Data    ZI Data      Debug   ",
+        "%10d %10d %10d %10d %10d %10d   Grand Totals" % (code, 1320, ro, rw, zi, 572563),
+        "%10d %10d %10d %10d %10d %10d   ELF Image Totals" % (code, 1320, ro, rw, zi, 572563),
+        "%10d %10d %10d %10d %10d %10d   ROM Totals" % (code, 1320, ro, rw, 0, 0),
+        "    Total RO  Size (Code + RO Data)                %d (  20.00kB)" % (code + ro),
+    ]
+
+
+def selftest():
+    """compare synthetic Bench and ReleaseBench profiles"""
+    bench = ("Bench", parse_sizes(sample_map(18000, 2000, 400, 11000)), bench_diff.parse(bench_diff.sample_log({}, 4))[1])
+    release = ("ReleaseBench", parse_sizes(sample_map(15000, 2000, 400, 11000)),
+               bench_diff.parse(bench_diff.sample_log({"sha256_1k": 0.5}, 4, drop="memcpy_4k"))[1])
+    size_rows, speed_rows = compare([bench, release])
+    speed = {(r[0], r[1]): r for r in speed_rows}
+    text = "\n".join(report([bench, release], False))
+    csv = report([bench, release], True)
+    checks = [
+        ("sizes", bench[1] == {"code": 18000, "ro": 2000, "rw": 400, "zi": 11000, "flash": 20400}),
+        ("flash change", abs(size_rows[1][2] - 100.0 * -3000 / 20400) < 1e-9 and size_rows[0][2] == 0.0),
+        ("speedup", speed[("sha256_1k", "warm")][3] == [1.0, 2.0]),
+        ("missing case", speed[("memcpy_4k", "cold")][2] == [3000, None]
+         and [l for l in text.splitlines() if l.startswith("memcpy_4k")][0].endswith(" -")),
+        ("text", "ReleaseBench" in text and "x2.00" in text),
+        ("csv", csv[0] == "profile,code,ro,rw,zi,flash,flash_change_pct"
+         and csv[2].startswith("ReleaseBench,15000,2000,400,11000,17400,-14.71")),
+    ]
+    failed = 0
+    for name, ok in checks:
+        print("%s %s" % ("PASS" if ok else "FAIL", name))
+        failed += 0 if ok else 1
+    try:
+        parse_sizes(["no totals"])
+        print("FAIL no totals")
+        failed += 1
+    except ValueError:
+        print("PASS no totals")
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compare image size and benchmark speed of build profiles")
+    parser.add_argument("--profile", nargs=3, action="append", metavar=("NAME", "MAP", "LOG"),
+                        help="build type name, its map file and its @bench log, the first is the reference")
+    parser.add_argument("--csv", action="store_true", help="print CSV")
+    parser.add_argument("--selftest", action="store_true", help="run the self-test")
+    args = parser.parse_args()
+
+    if args.selftest:
+        sys.exit(1 if selftest() else 0)
+    if not args.profile or len(args.profile) < 2:
+        parser.error("at least two --profile NAME MAP LOG are required")
+
+    profiles = []
+    base_hz = None
+    for name, map_file, log_file in args.profile:
+        with open(map_file, errors="replace") as f:
+            sizes = parse_sizes(f)
+        with open(log_file, errors="replace") as f:
+            header, results = bench_diff.parse(f)
+        base_hz = header.get("hz") if not profiles else base_hz
+        if header.get("hz") != base_hz:
+            print("warning: %s counts at a different rate, speedups are not comparable" % name, file=sys.stderr)
+        profiles.append((name, sizes, results))
+    print("\n".join(report(profiles, args.csv)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+"""
+    \file       swo_decode.py
+    \brief      SWO/ITM capture decoder for the BSP/TRACE event trace
+    \version    1.0
+    \date       2025-07-23
+    \author     Ze-Hou
+
+    This script provides:
+    - ITM packet parsing of a raw SWO byte stream (sync, overflow, software
+      source, DWT exception trace and PC samples, local and global timestamps)
+    - Event timeline with absolute time from the summed local timestamps
+    - Per-exception statistics (count, total and longest time, nesting aware)
+      from TRACE_ISR_ENTER/EXIT or the hardware exception trace
+    - Self-test on a synthetic capture (--selftest), and --encode to write
+      that capture to a file for testing capture tooling
+
+    usage:
+        python TOOLS/swo_decode.py capture.bin --core-hz 600000000
+        python TOOLS/swo_decode.py capture.bin --core-hz 600000000 --csv > timeline.csv
+        python TOOLS/swo_decode.py --selftest
+"""
+
+import argparse
+import sys
+
+# stimulus ports, see BSP/TRACE/trace.h
+PORT_TEXT, PORT_ISR_ENTER, PORT_ISR_EXIT, PORT_SWITCH, PORT_MARK, PORT_VALUE = range(6)
+
+EXC_FUNCTIONS = {1: "enter", 2: "exit", 3: "return"}
+EXC_NAMES = {1: "Reset", 2: "NMI", 3: "HardFault", 4: "MemManage", 5: "BusFault", 6: "UsageFault",
+             11: "SVCall", 12: "DebugMon", 14: "PendSV", 15: "SysTick"}
+
+
+def exc_name(number):
+    if number in EXC_NAMES:
+        return EXC_NAMES[number]
+    return "IRQ%d" % (number - 16) if number >= 16 else "EXC%d" % number
+
+
+class Decoder:
+    """ITM packet parser producing (cycles, kind, data) events"""
+
+    def __init__(self):
+        self.cycles = 0
+        self.pending = []
+        self.events = []
+        self.errors = 0
+
+    def emit(self, kind, data):
+        self.pending.append((kind, data))
+
+    def stamp(self, delta):
+        # a local timestamp gives the time of the packets before it
+        self.cycles += delta
+        for kind, data in self.pending:
+            self.events.append((self.cycles, kind, data))
+        self.pending = []
+
+    def flush(self):
+        self.stamp(0)
+
+    def feed(self, data):
+        i, n = 0, len(data)
+        zeros = 0
+        while i < n:
+            b = data[i]
+            i += 1
+            if b == 0x00:
+                zeros += 1
+                continue
+            if b == 0x80 and zeros >= 5:
+                zeros = 0
+                self.emit("sync", None)
+                continue
+            zeros = 0
+            if b == 0x70:
+                self.emit("overflow", None)
+            elif b & 0x03:
+                size = {1: 1, 2: 2, 3: 4}[b & 0x03]
+                if i + size > n:
+                    self.errors += 1
+                    break
+                value = int.from_bytes(data[i:i + size], "little")
+                i += size
+                if b & 0x04:
+                    self.hardware(b >> 3, size, value)
+                else:
+                    self.software(b >> 3, size, value)
+            elif (b & 0x0F) == 0x00:
+                # local timestamp: format 1 (0b11TC0000 + continuation bytes) or format 2 (0b0TTT0000)
+                if b & 0x80:
+                    delta, shift = 0, 0
+                    while i < n:
+                        c = data[i]
+                        i += 1
+                        delta |= (c & 0x7F) << shift
+                        shift += 7
+                        if not c & 0x80:
+                            break
+                    self.stamp(delta)
+                else:
+                    self.stamp((b >> 4) & 0x07)
+            elif (b & 0xDF) == 0x94:
+                # global timestamp, not used for the timeline: skip its payload
+                while i < n and data[i] & 0x80:
+                    i += 1
+                i += 1
+            elif (b & 0x0B) == 0x08:
+                # extension packet
+                if b & 0x80:
+                    while i < n and data[i] & 0x80:
+                        i += 1
+                    i += 1
+            else:
+                self.errors += 1
+        return self
+
+    def software(self, port, size, value):
+        if port == PORT_TEXT:
+            self.emit("text", value.to_bytes(size, "little").decode("latin-1"))
+        elif port == PORT_ISR_ENTER:
+            self.emit("enter", value & 0xFF)
+        elif port == PORT_ISR_EXIT:
+            self.emit("exit", value & 0xFF)
+        elif port == PORT_SWITCH:
+            self.emit("switch", ((value >> 8) & 0xFF, value & 0xFF))
+        elif port == PORT_MARK:
+            self.emit("mark", (value >> 16, value & 0xFFFF))
+        elif port == PORT_VALUE:
+            self.emit("value", value)
+        else:
+            self.emit("port%d" % port, value)
+
+    def hardware(self, ident, size, value):
+        if ident == 1 and size == 2:
+            # DWT exception trace: number in bits 0-8, function in bits 12-13
+            function = EXC_FUNCTIONS.get((value >> 12) & 0x3)
+            if function in ("enter", "exit"):
+                self.emit("hw_" + function, value & 0x1FF)
+            elif function == "return":
+                self.emit("hw_return", value & 0x1FF)
+        elif ident == 2:
+            # DWT periodic PC sample, 1 byte when the core was asleep
+            self.emit("pc" if size == 4 else "pc_sleep", value if size == 4 else None)
+        else:
+            self.emit("hw%d" % ident, value)
+
+
+def timeline(events):
+    """merge text bytes into lines, keep everything else"""
+    out, text, text_time = [], "", 0
+    for cycles, kind, data in events:
+        if kind == "text":
+            if not text:
+                text_time = cycles
+            text += data
+            if text.endswith("\n"):
+                out.append((text_time, "text", text.rstrip("\r\n")))
+                text = ""
+            continue
+        out.append((cycles, kind, data))
+    if text:
+        out.append((text_time, "text", text))
+    return out
+
+
+def isr_stats(events):
+    """count, total and longest run time per exception, nested handlers subtracted"""
+    stats = {}
+    stack = []
+    for cycles, kind, data in events:
+        if kind in ("enter", "hw_enter"):
+            if stack:
+                stack[-1][2] += cycles - stack[-1][3]
+            stack.append([data, cycles, 0, cycles])
+        elif kind in ("exit", "hw_exit") and stack and stack[-1][0] == data:
+            number, _, run, resumed = stack.pop()
+            run += cycles - resumed
+            s = stats.setdefault(number, [0, 0, 0])
+            s[0] += 1
+            s[1] += run
+            s[2] = max(s[2], run)
+            if stack:
+                stack[-1][3] = cycles
+        elif kind == "overflow":
+            stack = []
+    return stats
+
+
+def describe(kind, data):
+    if kind in ("enter", "exit", "hw_enter", "hw_exit", "hw_return"):
+        return "%-9s %s" % (kind, exc_name(data))
+    if kind == "switch":
+        return "switch    task %d -> task %d" % data
+    if kind == "mark":
+        return "mark      id %d arg %d" % data
+    if kind == "value":
+        return "value     0x%08X (%d)" % (data, data)
+    if kind == "pc":
+        return "pc        0x%08X" % data
+    if kind == "text":
+        return "text      %s" % data
+    return "%-9s %s" % (kind, "" if data is None else data)
+
+
+def report(events, core_hz, csv):
+    lines = []
+    if csv:
+        lines.append("cycles,time_us,event")
+    for cycles, kind, data in timeline(events):
+        if csv:
+            lines.append("%d,%.3f,%s" % (cycles, cycles * 1e6 / core_hz, describe(kind, data).replace(",", ";")))
+        else:
+            lines.append("%14.3f us  %s" % (cycles * 1e6 / core_hz, describe(kind, data)))
+    if not csv:
+        for number, (count, total, longest) in sorted(isr_stats(events).items()):
+            lines.append("isr %-10s count %6d  total %10.3f us  max %8.3f us" % (
+                exc_name(number), count, total * 1e6 / core_hz, longest * 1e6 / core_hz))
+    return lines
+
+
+# packet encoders, for the self-test and --encode
+def enc_sw(port, size, value):
+    return bytes([(port << 3) | {1: 1, 2: 2, 4: 3}[size]]) + value.to_bytes(size, "little")
+
+
+def enc_exc(number, function):
+    return bytes([0x0E]) + (number | (function << 12)).to_bytes(2, "little")
+
+
+def enc_pc(pc):
+    return bytes([0x17]) + pc.to_bytes(4, "little") if pc is not None else bytes([0x15, 0x00])
+
+
+def enc_lts(delta):
+    if 0 < delta < 7:
+        return bytes([delta << 4])
+    out = [0xC0]
+    while True:
+        b = delta & 0x7F
+        delta >>= 7
+        out.append(b | (0x80 if delta else 0))
+        if not delta:
+            return bytes(out)
+
+
+def sample_capture():
+    """boot text, a marker, IRQ25 preempted by SysTick, a task switch, an overflow, a value"""
+    return b"".join([
+        bytes(5) + b"\x80",
+        b"".join(enc_sw(PORT_TEXT, 1, c) for c in b"boot\n"), enc_lts(100),
+        enc_sw(PORT_MARK, 4, (7 << 16) | 42), enc_lts(1000),
+        enc_exc(41, 1), enc_lts(600),
+        enc_exc(15, 1), enc_lts(300),
+        enc_exc(15, 2), enc_lts(3),
+        enc_exc(41, 2), enc_lts(597),
+        enc_sw(PORT_SWITCH, 2, (1 << 8) | 2), enc_lts(4),
+        bytes([0x70]),
+        bytes([0x94, 0x81, 0x01]),
+        enc_sw(PORT_ISR_ENTER, 1, 41), enc_lts(200),
+        enc_sw(PORT_ISR_EXIT, 1, 41), enc_lts(1200),
+        enc_sw(PORT_VALUE, 4, 0xDEADBEEF),
+    ])
+
+
+def selftest():
+    """decode the synthetic capture and check times and statistics"""
+    d = Decoder().feed(sample_capture())
+    d.flush()
+    ev = d.events
+    kinds = [k for _, k, _ in ev]
+    stats = isr_stats(ev)
+    text = "\n".join(report(ev, 600000000, False))
+    checks = [
+        ("no parse errors", d.errors == 0),
+        ("sync", kinds[0] == "sync"),
+        ("text line", "text      boot" in text),
+        ("marker time", (1100, "mark", (7, 42)) in ev),
+        ("exception trace", (1700, "hw_enter", 41) in ev and (2600, "hw_exit", 41) in ev),
+        ("nesting", stats[41][1] == 300 + 597 + 1200 and stats[15][1] == 3),
+        ("counts", stats[41][0] == 2 and stats[15][0] == 1),
+        ("switch", (2604, "switch", (1, 2)) in ev),
+        ("overflow", "overflow" in kinds),
+        ("global timestamp skipped", (2804, "enter", 41) in ev and (4004, "exit", 41) in ev),
+        ("value", ev[-1] == (4004, "value", 0xDEADBEEF)),
+        ("csv", report(ev, 600000000, True)[0] == "cycles,time_us,event"),
+        ("truncated packet", Decoder().feed(bytes([0x23, 0x01])).errors == 1),
+        ("pc sample", Decoder().feed(enc_pc(0x08001234) + enc_pc(None)).pending == [("pc", 0x08001234), ("pc_sleep", None)]),
+    ]
+    failed = 0
+    for name, ok in checks:
+        print("%s %s" % ("PASS" if ok else "FAIL", name))
+        failed += 0 if ok else 1
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description="decode a raw SWO capture of the BSP/TRACE events")
+    parser.add_argument("capture", nargs="?", help="raw SWO bytes, stdin when omitted")
+    parser.add_argument("--core-hz", type=int, default=600000000, help="core clock the timestamps count")
+    parser.add_argument("--csv", action="store_true", help="print the timeline as CSV")
+    parser.add_argument("--encode", metavar="FILE", help="write the self-test capture to FILE")
+    parser.add_argument("--selftest", action="store_true", help="run the decoder self-test")
+    args = parser.parse_args()
+
+    if args.selftest:
+        sys.exit(1 if selftest() else 0)
+    if args.encode:
+        with open(args.encode, "wb") as f:
+            f.write(sample_capture())
+        return
+
+    if args.capture:
+        with open(args.capture, "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+    d = Decoder().feed(data)
+    d.flush()
+    print("\n".join(report(d.events, args.core_hz, args.csv)))
+    if d.errors:
+        print("%d malformed packets" % d.errors, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
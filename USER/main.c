@@ -6,25 +6,134 @@
 #include "./DELAY/delay.h"
 #include "./TIMER/timer.h"
 #include "./USART/usart.h"
+#include "./FAULT/fault.h"
+#include "./ECC/ecc.h"
+#include "./LOCK/lock.h"
+#include "./RTOS/rtos.h"
+#include "./BENCH/bench.h"
+#include "./TRACE/trace.h"
+#include "./PINCFG/pincfg.h"
+#include "./DVFS/dvfs.h"
+#include "./IDLE/idle.h"
+#include "./WALLCLOCK/wallclock.h"
+#include "./THERMAL/thermal.h"
+#include "./I2C/i2c.h"
+#include "./SENSORHUB/sensorhub.h"
 
 // Standard library header files
 #include <stdint.h>
 
+#define MAIN_HELLO_PERIOD_US        5000000U                                /* greeting on the BSP USART */
+#define MAIN_DVFS_PERIOD_US         100000U                                 /* load window of the DVFS policy */
+#define MAIN_I2C_HZ                 400000U                                 /* sensor hub bus speed */
+
+/*!
+    \brief      check a periodic deadline of the main loop
+    \param[in]  now: timer_monotonic_us value
+    \param[in]  deadline: next due time, advanced by period when due
+    \param[in]  period: microseconds between runs
+    \param[out] none
+    \retval     1 when due
+*/
+static uint8_t main_due(uint32_t now, uint32_t *deadline, uint32_t period)
+{
+    if((int32_t)(now - *deadline) < 0)
+    {
+        return 0U;
+    }
+    *deadline += period;
+    if((int32_t)(now - *deadline) >= 0)
+    {
+        *deadline = now + period;                                       /* late by a whole period, drop the missed runs */
+    }
+    return 1U;
+}
+
+/*!
+    \brief      earlier of two deadlines
+    \param[in]  a: deadline
+    \param[in]  b: deadline
+    \param[out] none
+    \retval     the one due first
+*/
+static uint32_t main_first(uint32_t a, uint32_t b)
+{
+    return ((int32_t)(a - b) < 0) ? a : b;
+}
+
+#if SYSTEM_SUPPORT_OS
+/* main task of the RTOS build type */
+static void main_task(void *arg)
+{
+    (void)arg;
+    while(1)
+    {
+        printf("Hello World!\r\n");
+        delay_ms(5000);
+    }
+}
+#endif /* SYSTEM_SUPPORT_OS */
+
 int main() {
+    uint32_t now, sleep_us, due_us, hello_at, dvfs_at;
+
+    fault_init();                                                       /* look for a crash record before anything runs */
     SystemCoreClockUpdate();                                            /* update system clock */
     nvic_priority_group_set( NVIC_PRIGROUP_PRE4_SUB0);
     mpu_memory_protection();
     system_fwdgt_init();
     system_cache_enable();
     system_dwt_init();
+    pincfg_init();                                                      /* every pin of PINCFG_BOARD_TABLE in one pass */
 
     delay_init();                                                       /* initialize delay function */
     timer_general16_config(30000, 20000);                   /* configure TIMER16 for automatic watchdog feeding */
     usart_init(921600);                                      /* initialize USART */
+    timer_monotonic_config();                                           /* microsecond timebase and its alarm */
+    lock_init();                                                        /* semaphores of CAU, HAU, CRC and the DRBG, before any engine init */
+    fault_report();                                                     /* print the crash of the previous boot */
+    ecc_init();                                                         /* RAM ECC monitors, reports an ECC reset of the previous boot */
+#if TRACE_PC_SAMPLING
+    trace_init(TRACE_SWO_HZ);                                           /* Profile build type: PC samples for TOOLS/pgo_layout.py */
+#endif /* TRACE_PC_SAMPLING */
+#if BENCH_ENABLE
+    usart_terminal_init(921600);                                        /* benchmark results go to the terminal USART */
+    bench_run_all(NULL);
+#endif /* BENCH_ENABLE */
+    dvfs_init();                                                        /* boot operating point, restored after deep-sleep */
+    idle_init();                                                        /* RTC wakeup for deep-sleep */
+#if SYSTEM_SUPPORT_OS
+    rtos_start(main_task);                                              /* does not return, no DVFS policy in this build type */
+#endif
+    wallclock_init();                                                   /* timestamps of the thermal log */
+    thermal_init();                                                     /* LPDTS threshold interrupts */
+    i2c_master_init(MAIN_I2C_HZ);
+    sensorhub_init(MAIN_I2C_HZ);                                        /* sensors are added with sensorhub_register */
 
+    hello_at = timer_monotonic_us();
+    dvfs_at = hello_at + MAIN_DVFS_PERIOD_US;
     while(1)
     {
-        printf("Hello World!\r\n");
-        delay_ms(5000);
+        now = timer_monotonic_us();
+        if(main_due(now, &hello_at, MAIN_HELLO_PERIOD_US))
+        {
+            printf("Hello World!\r\n");
+        }
+        if(main_due(now, &dvfs_at, MAIN_DVFS_PERIOD_US))
+        {
+            dvfs_policy_update();                                       /* picks the operating point from the idle share */
+        }
+        thermal_process();                                              /* level decided by the LPDTS interrupt, which also ends the sleep */
+        sensorhub_process();                                            /* batches of due reads, completed by the I2C interrupt */
+        ecc_scrub_step();                                               /* one chunk per wakeup at most, does not shorten the sleep */
+
+        /* deepest idle state that fits the time to the next deadline, the time asleep is the DVFS idle share */
+        now = timer_monotonic_us();
+        sleep_us = main_first(hello_at, dvfs_at) - now;
+        sleep_us = ((int32_t)sleep_us > 0) ? sleep_us : 0U;
+        due_us = sensorhub_next_due_us();                               /* 0xFFFFFFFF without sensors */
+        sleep_us = (due_us < sleep_us) ? due_us : sleep_us;
+        timer_monotonic_alarm_set(now + sleep_us);                      /* wakes sleep; deep-sleep stops TIMER1 and wakes on the RTC */
+        idle_enter(sleep_us);
     }
 }